@@ -3,19 +3,101 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <future>  // For std::future (asynchronous submission)
 #include <cstdint> // For uint64_t, uint8_t
+#include <map>
+#include <chrono>  // For telemetry intervals
+#include "vpu_data_structures.h" // For ActualPerformanceRecord
+#include "hal/sparse.h"          // For HAL::CsrView (pre-encoded sparse inputs)
+#include "hal/buffer_stats.h"    // For HAL::BufferStats
+#include "hal/device.h"          // For HAL::Device (accelerators, remote VPUs)
+#include "runtime/trace.h"       // For Runtime::LogLevel
+#include "runtime/metrics.h"     // For Runtime::MetricsSnapshot
 
 namespace VPU {
 
 // Forward declaration of the main implementation class to hide details.
 class VPUCore;
 
+// One typed operand of a task: a dense, row-major tensor of up to MAX_RANK dimensions.
+struct TaskOperand {
+    static const size_t MAX_RANK = 3;
+
+    void* data = nullptr; // Inputs are only read
+    HAL::ElementType dtype = HAL::ElementType::FLOAT32;
+    size_t rank = 0;
+    uint64_t shape[MAX_RANK] = {0, 0, 0};
+    // In elements, per dimension. All zero means packed (row-major, contiguous); the built-in
+    // kernels accept only packed operands.
+    int64_t strides[MAX_RANK] = {0, 0, 0};
+
+    uint64_t elements() const {
+        uint64_t count = rank ? 1 : 0;
+        for (size_t d = 0; d < rank; ++d) count *= shape[d];
+        return count;
+    }
+    size_t size_bytes() const { return static_cast<size_t>(elements()) * HAL::element_size(dtype); }
+    bool packed() const {
+        int64_t expected = 1;
+        for (size_t d = rank; d-- > 0;) {
+            if (strides[d] != 0 && strides[d] != expected) return false;
+            expected *= static_cast<int64_t>(shape[d]);
+        }
+        return true;
+    }
+
+    static TaskOperand vector(const void* data, HAL::ElementType dtype, uint64_t length) {
+        TaskOperand operand;
+        operand.data = const_cast<void*>(data);
+        operand.dtype = dtype;
+        operand.rank = 1;
+        operand.shape[0] = length;
+        return operand;
+    }
+    static TaskOperand matrix(const void* data, HAL::ElementType dtype, uint64_t rows, uint64_t cols) {
+        TaskOperand operand = vector(data, dtype, rows);
+        operand.rank = 2;
+        operand.shape[1] = cols;
+        return operand;
+    }
+};
+
+// File-backed input and output for tasks too large to hold in memory. The VPU maps both files
+// and runs the task chunk by chunk (see core/TaskStream.h), so resident memory stays near a few
+// chunks however large the files are. Streamed data is the op's default element type (f32 for
+// SAXPY and GEMM, f64 for CONVOLUTION), raw and in host byte order:
+//  - SAXPY: the input holds x; the output holds y and is updated in place (a new file starts at 0).
+//  - GEMM: the input holds A row-major, M x K; the output receives C (M x N). B stays in
+//    memory behind data_in_b, with N and K in extended_params.
+//  - CONVOLUTION: the input holds the signal; the output receives as many samples of
+//    signal * conv_filter.
+// num_elements (M for GEMM) caps how much of the input is read; 0 reads to the end of the file.
+// VPU_TaskGraph orders tasks by their memory buffers only: order streamed tasks that share a
+// file with add_dependency.
+struct TaskStream {
+    std::string input_path;
+    uint64_t input_offset = 0; // Bytes to skip at the start of the input (e.g. a header)
+    std::string output_path;   // Created, or resized to fit the result
+    size_t chunk_bytes = 0;    // Input bytes per chunk; 0 uses a quarter of the last-level cache
+
+    bool active() const { return !input_path.empty(); }
+};
+
 // Represents a computational task and its data payload.
 // This is the primary structure used by a developer to submit work.
+//
+// A task is described either by 'op' and 'operands' (typed: the VPU then knows every buffer's
+// element type and shape) or by the legacy task_type string and untyped buffers. Pillar 1 completes
+// whichever half is missing (see core/TaskDescriptor.h), so both forms reach the same kernels.
 struct VPU_Task {
     uint64_t task_id;      // Unique identifier for the task
     std::string task_type; // e.g., "CONVOLUTION", "GEMM", "SAXPY", or a more generic "USER_DEFINED_KERNEL"
 
+    TaskOp op = TaskOp::UNKNOWN;
+    // In the op's order: SAXPY {x, y}; GEMM {A (MxK), B (KxN), C (MxN)};
+    // CONVOLUTION {signal, filter taps, output}; FFT {input, output}. All share one dtype.
+    std::vector<TaskOperand> operands;
+
     enum class KernelType {
         FUNCTION_POINTER,
         WASM_BINARY
@@ -42,12 +124,80 @@ struct VPU_Task {
     size_t num_elements; // Relevant for array/vector operations, context for data_in/out pointers
     size_t data_in_a_size_bytes; // Size of data_in_a in bytes
     size_t data_in_b_size_bytes; // Size of data_in_b in bytes
+    // Optional size of data_out in bytes. Only VPU_TaskGraph uses it, to order tasks whose
+    // buffers overlap; 0 means other tasks conflict with this one only at data_out itself.
+    size_t data_out_size_bytes;
+
+    // Scalar operand for BLAS-style kernels (e.g., 'a' in SAXPY: y = a*x + y).
+    float alpha;
 
+    // Additional integer parameters for kernels that need more than a flat element count,
+    // e.g., "M", "N", "K" for GEMM.
+    std::map<std::string, int> extended_params;
+
+    // Optional pre-encoded CSR form of input A for GEMM (A is sparse_a.rows x sparse_a.cols).
+    // When set, the VPU runs the sparse SpMM path directly and skips dense->CSR conversion;
+    // data_in_a may then be null. The arrays it points to must outlive the task.
+    HAL::CsrView sparse_a;
+
+    // Filter taps for CONVOLUTION (double, like the signal in data_in_a): data_out receives the
+    // first num_elements samples of data_in_a * conv_filter. The taps must outlive the task.
+    HAL::Span<const double> conv_filter;
+
+    // Largest error the caller accepts in any output, relative to the magnitude of the inputs'
+    // products: |alpha| * max|x| for SAXPY, K * max|A| * max|B| for GEMM. A positive bound lets
+    // Pillar 3 also plan f32 SAXPY and GEMM in BF16 (~2^-8), FP16 (~2^-11) or INT8 (~1/254;
+    // twice these for GEMM) when the profiled range fits the type. 0 keeps full precision.
+    double accuracy_bound = 0.0;
+
+    // Set to stream the task's data from and to files instead of data_in_a and data_out, which
+    // are then ignored. Streamed tasks take no operands.
+    TaskStream stream;
+
+    // Optional caller-maintained version of the input data. Non-zero values key the VPU's
+    // profile/plan cache instead of a content fingerprint: bump it whenever the buffers change.
+    uint64_t data_version = 0;
 
     // Default constructor to initialize members
     VPU_Task() : task_id(0), kernel_type(KernelType::FUNCTION_POINTER), kernel_size(0),
                  data_in_a(nullptr), data_in_b(nullptr), data_out(nullptr), num_elements(0),
-                 data_in_a_size_bytes(0), data_in_b_size_bytes(0) {}
+                 data_in_a_size_bytes(0), data_in_b_size_bytes(0), data_out_size_bytes(0), alpha(1.0f) {}
+};
+
+// A DAG of tasks run together by VPU_Environment::execute_graph. Dependencies come from
+// the buffers the tasks declare, in the order tasks are added: a task reading data_in_a,
+// data_in_b or conv_filter runs after every earlier task writing an overlapping data_out, and a
+// task writing data_out runs after every earlier task reading or writing an overlapping buffer.
+// For a typed task every operand but the last is read and the last is written (its data_*
+// pointers are ignored). Tasks with no path between them may run in parallel.
+class VPU_TaskGraph {
+public:
+    using NodeId = size_t;
+
+    // The graph stores a pointer: the task and its buffers must outlive execute_graph().
+    NodeId add_task(VPU_Task& task);
+    // Orders two tasks the buffers do not relate. 'before' must have been added first;
+    // throws std::runtime_error otherwise (which also keeps the graph acyclic).
+    void add_dependency(NodeId before, NodeId after);
+
+    size_t size() const { return tasks_.size(); }
+    VPU_Task& task(NodeId node) const { return *tasks_.at(node); }
+    // Every task 'node' waits for, ascending.
+    const std::vector<NodeId>& dependencies(NodeId node) const { return dependencies_.at(node); }
+    // The subset of dependencies() whose output 'node' reads (producer -> consumer edges).
+    const std::vector<NodeId>& data_sources(NodeId node) const { return data_sources_.at(node); }
+
+private:
+    std::vector<VPU_Task*> tasks_;
+    std::vector<std::vector<NodeId>> dependencies_;
+    std::vector<std::vector<NodeId>> data_sources_;
+};
+
+// How hard FFTW searches for a fast plan the first time a transform size is seen.
+enum class FFTPlanningMode {
+    ESTIMATE, // Heuristic planning (default); no start-up cost
+    MEASURE,  // Benchmarks candidate plans; slower first transform, faster steady state
+    PATIENT   // Wider search than MEASURE; pair with a wisdom file so the search is paid once
 };
 
 // Represents the VPU runtime environment.
@@ -58,19 +208,103 @@ public:
     ~VPU_Environment();
 
     // The primary function to execute a task.
-    // Note: Task is now passed by value or const reference if it's complex,
-    // to avoid issues if the VPU processes it asynchronously.
-    // For now, mutable reference is fine as processing is synchronous.
+    // Runs the full cognitive cycle synchronously on the caller's thread.
     void execute(VPU_Task& task);
 
+    // Queues a task for execution on the VPU's worker pool and returns immediately.
+    // The task and its data buffers must stay alive until the returned future is ready.
+    // Blocks only if the submission queue is full (backpressure).
+    std::future<ActualPerformanceRecord> submit_async(VPU_Task& task);
+
+    // Queues 'count' contiguous tasks; one future per task, in the same order.
+    std::vector<std::future<ActualPerformanceRecord>> submit_batch(VPU_Task* tasks, size_t count);
+    std::vector<std::future<ActualPerformanceRecord>> submit_batch(std::vector<VPU_Task>& tasks);
+
+    // Runs every task of 'graph' through the full cognitive cycle, independent tasks in parallel
+    // on a work-stealing pool, and blocks until all are done. Returns one record per node.
+    // If a task throws, is rejected or gets no plan, the tasks depending on it are skipped (empty
+    // records); the first exception is rethrown once the rest of the graph has finished.
+    std::vector<ActualPerformanceRecord> execute_graph(VPU_TaskGraph& graph);
+
+    // Pipelined mode runs each pillar as a concurrent stage with its own queue and workers.
+    // Futures complete as soon as execution (Pillar 4) finishes; learning (Pillar 5) and
+    // plan recording (Pillar 6) are applied in the background.
+    void set_pipelined_mode(bool enable);
+
+    // Blocks until all asynchronously submitted tasks, including their background learning, are done.
+    void wait_idle();
+
+    // Selects the FFTW planning mode for transform sizes not planned yet. If 'wisdom_file'
+    // is given, FFTW wisdom is loaded from it now and saved back when the environment shuts down.
+    void configure_fft_planning(FFTPlanningMode mode, const std::string& wisdom_file = "");
+
+    // Chooses how much of each input Pillar 2 reads when profiling (see ProfilingPolicy).
+    // By default the Orchestrator picks a policy per task type from what its cost model needs;
+    // set_profiling_policy() applies one policy to every task until reset_profiling_policy().
+    void set_profiling_policy(const ProfilingPolicy& policy);
+    void reset_profiling_policy();
+
+    // Repeat tasks (same task_type, input size and fingerprint or data_version) reuse their
+    // profile and, while beliefs are unchanged, their candidate plans. 0 disables the cache.
+    void set_plan_cache_capacity(size_t capacity);
+
+    // Makes a compute device available to the Orchestrator. Its per-operation beliefs
+    // ("<op>@<substrate>") are seeded from the host's costs scaled by the device's priors and
+    // refined by Pillar 5 as plans run there. Returns the device's ID.
+    HAL::DeviceId add_device(std::shared_ptr<HAL::Device> device);
+    // Offloads to a VPU service at host:port (see HAL::make_remote_device). Plans use it while it is reachable.
+    HAL::DeviceId add_remote_device(const std::string& substrate, const std::string& host, int port);
+
+    // Polls the IoT framework's sensors at host:port every 'interval' in the background; profiles
+    // then carry the latest readings (nominal values for sensors silent for longer than 'max_age').
+    void enable_iot_telemetry(const std::string& host, int port,
+                              std::chrono::milliseconds interval = std::chrono::milliseconds(500),
+                              std::chrono::milliseconds max_age = std::chrono::seconds(5));
+    void disable_iot_telemetry(); // Stops polling; profiles get nominal readings
+
+    // Warm-starts from the beliefs saved at 'path' if they were learned on this host type
+    // (same CPU model, SIMD ISA and core count), then saves the beliefs back there every
+    // 'checkpoint_interval' and at shutdown. Paths ending in ".json" use JSON, others the
+    // compact binary format; HostFingerprint::profile_path() names one file per host type.
+    // Setting $VPU_BELIEFS_FILE does the same at construction. An empty path stops it.
+    void enable_belief_persistence(const std::string& path,
+                                   std::chrono::milliseconds checkpoint_interval = std::chrono::seconds(30));
+    bool save_beliefs(const std::string& path) const;
+    // Beliefs from another host type are refused unless 'any_host' is set.
+    bool load_beliefs(const std::string& path, bool any_host = false);
+
+    // Replaces the built-in cost priors with measurements of this host: times every registered
+    // kernel across a grid of sizes and sparsity levels on a background thread, then fits base
+    // costs and Hamming weight sensitivities from the timings and publishes them as one belief
+    // version. Tasks keep running meanwhile. Setting $VPU_CALIBRATE_COSTS does the same at
+    // construction (after any warm start, so calibrated costs win over saved ones).
+    std::shared_future<CalibrationReport> calibrate_cost_model(const CalibrationOptions& options = CalibrationOptions());
+
+    // Logging and tracing are process-wide (see runtime/trace.h). Per-task messages are DEBUG
+    // and TRACE, so the default INFO level prints only setup and warnings.
+    void set_log_level(Runtime::LogLevel level);
+    // Records submit/analyze/plan/execute/learn spans per task until write_trace(), which
+    // drains them into a Chrome trace JSON file (chrome://tracing, ui.perfetto.dev).
+    void start_tracing();
+    bool write_trace(const std::string& path, bool stop = true);
+
+    // Counts from every task this environment has run: per-stage latency histograms (Pillar 1
+    // through Pillar 6), plan choices, explorations, JIT cache and fusion hits, and per-operation
+    // latency prediction errors. Always recorded; reading them does not pause tasks.
+    Runtime::MetricsSnapshot metrics() const;
+    // Serves metrics() in the Prometheus text format at http://host:port/metrics from a
+    // background thread (port 0 picks a free port). Returns the bound port, or -1.
+    int serve_metrics(int port, const std::string& host = "0.0.0.0");
+    void stop_serving_metrics();
+
     // Dumps the VPU's current internal beliefs for inspection.
     void print_beliefs();
 
     // Method to get access to VPUCore for testing purposes
     VPUCore* get_core_for_testing();
 
-    // Method to get the last performance record for testing
-    const ActualPerformanceRecord& get_last_performance_record() const;
+    // Method to get (a copy of) the last performance record for testing
+    ActualPerformanceRecord get_last_performance_record() const;
 
 private:
     std::unique_ptr<VPUCore> core;
@@ -0,0 +1,481 @@
+// vpu_bench: performance suite for the VPU.
+//
+// Measures kernel throughput (SAXPY, GEMM and FFT across sizes, every registered variant), the
+// Cortex's profiling overhead, planning overhead per candidate plan, whole-task latency
+// percentiles through VPU_Environment::execute, and throughput scaling with client threads and
+// asynchronous batches. Results are written as JSON in Google Benchmark's layout ("context" and
+// "benchmarks" with real_time / cpu_time / items_per_second), so its tools/compare.py can diff runs.
+//
+// Usage: vpu_bench [--out=FILE] [--filter=SUBSTRING] [--min-time=SECONDS]
+//                  [--baseline=FILE [--max-regression=FRACTION]]
+// With --baseline, benchmarks whose real_time grew by more than max-regression (default 0.10)
+// over the baseline file's are listed on stderr and the exit code is 1.
+
+#include "vpu.h"
+#include "vpu_core.h"
+#include "core/Pillar2_Cortex.h"
+#include "core/Pillar3_Orchestrator.h"
+#include "hal/hal.h"            // For HAL::KernelLibrary
+#include "hal/cpu_features.h"   // For the host context
+#include "hal/fft_plan_cache.h" // For FFTPlanCache
+#include "runtime/trace.h"      // For Runtime::set_log_level
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    double min_time_s = 0.2; // Timed run length per benchmark, after one warm-up iteration
+    std::string filter;      // Only benchmarks whose name contains this
+    std::string out_path;    // JSON destination; stdout if empty
+    std::string baseline_path;
+    double max_regression = 0.10;
+};
+
+struct BenchResult {
+    std::string name;
+    size_t iterations = 0;
+    double real_ns = 0.0; // Per iteration
+    double cpu_ns = 0.0;  // Per iteration, all threads of the process
+    double items_per_iteration = 0.0;
+    double bytes_per_iteration = 0.0;
+    std::map<std::string, double> counters; // Extra fields (percentiles, thread counts, ...)
+};
+
+double process_cpu_ns() {
+    return static_cast<double>(std::clock()) * 1e9 / CLOCKS_PER_SEC;
+}
+
+// Runs each benchmark for at least min_time: the iteration count grows until a timed batch is long
+// enough, as Google Benchmark does, and the last batch is reported.
+class Runner {
+public:
+    explicit Runner(BenchOptions options) : options_(std::move(options)) {}
+
+    bool selected(const std::string& name) const {
+        return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+    }
+
+    // 'body' is one iteration. With 'percentiles', every iteration of the reported batch is timed
+    // on its own and p50/p90/p99 are added to the result.
+    BenchResult* run(const std::string& name, const std::function<void()>& body,
+                     double items = 0.0, double bytes = 0.0, bool percentiles = false) {
+        if (!selected(name)) return nullptr;
+        body(); // Warm-up: caches, FFT plans, JIT kernels, first beliefs
+
+        std::vector<double> samples;
+        size_t iterations = 1;
+        double real_ns = 0.0, cpu_ns = 0.0;
+        for (;;) {
+            samples.clear();
+            const double cpu_start = process_cpu_ns();
+            const Clock::time_point start = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                if (percentiles) {
+                    const Clock::time_point iteration_start = Clock::now();
+                    body();
+                    samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - iteration_start).count());
+                } else {
+                    body();
+                }
+            }
+            real_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            cpu_ns = process_cpu_ns() - cpu_start;
+            const double min_ns = options_.min_time_s * 1e9;
+            if (real_ns >= min_ns || iterations >= 1000000000) break;
+            // Aim 40% past the minimum so the next batch is usually the last, growing at most 10x.
+            const double estimate = real_ns > 0.0 ? iterations * 1.4 * min_ns / real_ns : iterations * 10.0;
+            iterations = static_cast<size_t>(std::min(std::max(estimate, iterations + 1.0), iterations * 10.0));
+        }
+
+        BenchResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.real_ns = real_ns / iterations;
+        result.cpu_ns = cpu_ns / iterations;
+        result.items_per_iteration = items;
+        result.bytes_per_iteration = bytes;
+        if (percentiles && !samples.empty()) {
+            std::sort(samples.begin(), samples.end());
+            for (const auto& p : {std::make_pair("p50_ns", 0.50), std::make_pair("p90_ns", 0.90), std::make_pair("p99_ns", 0.99)}) {
+                const size_t rank = static_cast<size_t>(std::ceil(p.second * samples.size()));
+                result.counters[p.first] = samples[std::max<size_t>(rank, 1) - 1];
+            }
+        }
+        results_.push_back(result);
+        std::cerr << result.name << ": " << result.real_ns << " ns/iter (" << iterations << " iterations)" << std::endl;
+        return &results_.back();
+    }
+
+    const std::vector<BenchResult>& results() const { return results_; }
+
+private:
+    BenchOptions options_;
+    std::vector<BenchResult> results_;
+};
+
+template <typename T>
+std::vector<T> random_values(size_t count, std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    std::vector<T> values(count);
+    for (T& v : values) v = static_cast<T>(value(rng));
+    return values;
+}
+
+// --- Kernel throughput ---
+
+void bench_kernels(Runner& runner, VPU::VPUCore& core, std::mt19937_64& rng) {
+    const VPU::HAL::KernelLibrary& library = *core.get_kernel_library_for_testing();
+    const VPU::HAL::OperationRegistry& registry = VPU::HAL::OperationRegistry::instance();
+
+    for (const char* op : {"SAXPY_STANDARD", "SAXPY_AVX2", "SAXPY_AVX512", "SAXPY_NEON"}) {
+        const VPU::HAL::GenericKernel* kernel = library.find(registry.find(op));
+        if (!kernel) continue; // Not built or not supported on this host
+        for (size_t n : {size_t(4096), size_t(65536), size_t(1) << 20}) {
+            std::vector<float> x = random_values<float>(n, rng), y = random_values<float>(n, rng);
+            VPU::VPU_Task task;
+            task.task_type = "SAXPY";
+            task.alpha = 1e-3f;
+            task.data_in_a = x.data();
+            task.data_in_a_size_bytes = n * sizeof(float);
+            task.data_out = y.data();
+            task.num_elements = n;
+            runner.run(std::string("kernel/") + op + "/" + std::to_string(n), [&]() { (*kernel)(task); },
+                       static_cast<double>(n), 3.0 * n * sizeof(float)); // Read x and y, write y
+        }
+    }
+
+    for (const char* op : {"GEMM_NAIVE", "GEMM_FLUX_ADAPTIVE", "GEMM_BLOCKED", "GEMM_BLOCKED_MT",
+                           "GEMM_AVX2", "GEMM_AVX512", "GEMM_NEON"}) {
+        const VPU::HAL::GenericKernel* kernel = library.find(registry.find(op));
+        if (!kernel) continue;
+        for (size_t n : {size_t(64), size_t(128), size_t(256)}) {
+            std::vector<float> a = random_values<float>(n * n, rng), b = random_values<float>(n * n, rng), c(n * n);
+            VPU::VPU_Task task;
+            task.task_type = "GEMM";
+            task.data_in_a = a.data();
+            task.data_in_a_size_bytes = a.size() * sizeof(float);
+            task.data_in_b = b.data();
+            task.data_in_b_size_bytes = b.size() * sizeof(float);
+            task.data_out = c.data();
+            task.num_elements = c.size();
+            task.extended_params = {{"M", static_cast<int>(n)}, {"N", static_cast<int>(n)}, {"K", static_cast<int>(n)}};
+            runner.run(std::string("kernel/") + op + "/" + std::to_string(n), [&]() { (*kernel)(task); },
+                       2.0 * n * n * n, 3.0 * n * n * sizeof(float)); // Items are flops
+        }
+    }
+
+    for (size_t n : {size_t(1024), size_t(16384), size_t(262144)}) {
+        double* in = static_cast<double*>(fftw_malloc(n * sizeof(double)));
+        fftw_complex* out = static_cast<fftw_complex*>(fftw_malloc((n / 2 + 1) * sizeof(fftw_complex)));
+        const std::vector<double> signal = random_values<double>(n, rng);
+        std::copy(signal.begin(), signal.end(), in);
+        fftw_plan plan = VPU::HAL::FFTPlanCache::instance().get_r2c_plan(static_cast<int>(n), in, out);
+        if (plan) {
+            runner.run("kernel/FFT_R2C/" + std::to_string(n), [&]() { fftw_execute_dft_r2c(plan, in, out); },
+                       static_cast<double>(n), n * sizeof(double) + (n / 2 + 1) * sizeof(fftw_complex));
+        }
+        fftw_free(in);
+        fftw_free(out);
+    }
+}
+
+// --- Pillar 2 and 3 overheads ---
+
+struct SampleTask {
+    std::string label;
+    std::vector<float> fa, fb, fc;
+    std::vector<double> da, dout, taps;
+    VPU::VPU_Task task;
+};
+
+// One task of each type the planner knows, sized like a typical request.
+std::vector<SampleTask> sample_tasks(std::mt19937_64& rng) {
+    std::vector<SampleTask> tasks(3);
+
+    SampleTask& saxpy = tasks[0];
+    saxpy.label = "SAXPY/65536";
+    saxpy.fa = random_values<float>(65536, rng);
+    saxpy.fc = random_values<float>(65536, rng);
+    saxpy.task.task_type = "SAXPY";
+    saxpy.task.alpha = 1e-3f;
+    saxpy.task.data_in_a = saxpy.fa.data();
+    saxpy.task.data_in_a_size_bytes = saxpy.fa.size() * sizeof(float);
+    saxpy.task.data_out = saxpy.fc.data();
+    saxpy.task.num_elements = saxpy.fa.size();
+
+    SampleTask& gemm = tasks[1];
+    const int n = 128;
+    gemm.label = "GEMM/128";
+    gemm.fa = random_values<float>(n * n, rng);
+    gemm.fb = random_values<float>(n * n, rng);
+    gemm.fc.assign(n * n, 0.0f);
+    gemm.task.task_type = "GEMM";
+    gemm.task.data_in_a = gemm.fa.data();
+    gemm.task.data_in_a_size_bytes = gemm.fa.size() * sizeof(float);
+    gemm.task.data_in_b = gemm.fb.data();
+    gemm.task.data_in_b_size_bytes = gemm.fb.size() * sizeof(float);
+    gemm.task.data_out = gemm.fc.data();
+    gemm.task.num_elements = gemm.fc.size();
+    gemm.task.extended_params = {{"M", n}, {"N", n}, {"K", n}};
+
+    SampleTask& conv = tasks[2];
+    conv.label = "CONVOLUTION/65536x32";
+    conv.da = random_values<double>(65536, rng);
+    conv.taps = random_values<double>(32, rng);
+    conv.dout.assign(conv.da.size(), 0.0);
+    conv.task.task_type = "CONVOLUTION";
+    conv.task.data_in_a = conv.da.data();
+    conv.task.data_in_a_size_bytes = conv.da.size() * sizeof(double);
+    conv.task.data_out = conv.dout.data();
+    conv.task.num_elements = conv.da.size();
+    conv.task.conv_filter = VPU::HAL::Span<const double>(conv.taps);
+
+    for (SampleTask& t : tasks) {
+        t.task.kernel.function_pointer = [](const void*, const void*, void*, size_t) {};
+    }
+    return tasks;
+}
+
+void bench_pillars(Runner& runner, VPU::VPUCore& core, std::vector<SampleTask>& tasks) {
+    VPU::Cortex& cortex = *core.get_cortex_for_testing();
+    VPU::Orchestrator& orchestrator = *core.get_orchestrator_for_testing();
+    for (SampleTask& t : tasks) {
+        // Profiling at the fidelity the Orchestrator asks for this task type.
+        const VPU::ProfilingPolicy policy = orchestrator.profiling_policy_for(t.task.task_type);
+        runner.run("cortex/analyze/" + t.label, [&]() { cortex.analyze(t.task, policy); },
+                   static_cast<double>(t.task.num_elements), static_cast<double>(t.task.data_in_a_size_bytes));
+
+        const VPU::EnrichedExecutionContext context = cortex.analyze(t.task, policy);
+        size_t candidates = 0;
+        BenchResult* planning = runner.run("orchestrator/plan/" + t.label, [&]() {
+            candidates = orchestrator.determine_optimal_path(context).size();
+        });
+        if (planning && candidates > 0) {
+            planning->counters["candidates"] = static_cast<double>(candidates);
+            planning->counters["ns_per_candidate"] = planning->real_ns / candidates;
+        }
+    }
+}
+
+// --- Whole tasks through the public API ---
+
+void bench_execute(Runner& runner, VPU::VPU_Environment& environment, std::vector<SampleTask>& tasks) {
+    for (SampleTask& t : tasks) {
+        runner.run("execute/" + t.label, [&]() { environment.execute(t.task); },
+                   1.0, 0.0, /*percentiles=*/true);
+    }
+}
+
+// Tasks per second as more client threads call execute() at once, and through submit_batch().
+void bench_scaling(Runner& runner, VPU::VPU_Environment& environment, std::mt19937_64& rng) {
+    const size_t elements = 65536;
+    const size_t tasks_per_thread = 16;
+    const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < hardware_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(hardware_threads);
+
+    for (unsigned threads : thread_counts) {
+        // Each client thread has its own buffers and task.
+        std::vector<std::vector<float>> xs(threads), ys(threads);
+        std::vector<VPU::VPU_Task> client_tasks(threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            xs[i] = random_values<float>(elements, rng);
+            ys[i] = random_values<float>(elements, rng);
+            VPU::VPU_Task& task = client_tasks[i];
+            task.task_type = "SAXPY";
+            task.alpha = 1e-3f;
+            task.data_in_a = xs[i].data();
+            task.data_in_a_size_bytes = elements * sizeof(float);
+            task.data_out = ys[i].data();
+            task.num_elements = elements;
+            task.kernel.function_pointer = [](const void*, const void*, void*, size_t) {};
+        }
+        BenchResult* result = runner.run("scaling/execute/threads:" + std::to_string(threads), [&]() {
+            std::vector<std::thread> clients;
+            for (unsigned i = 0; i < threads; ++i) {
+                clients.emplace_back([&, i]() {
+                    for (size_t k = 0; k < tasks_per_thread; ++k) environment.execute(client_tasks[i]);
+                });
+            }
+            for (std::thread& client : clients) client.join();
+        }, static_cast<double>(threads * tasks_per_thread));
+        if (result) result->counters["threads"] = threads;
+    }
+
+    for (size_t batch : {size_t(16), size_t(128)}) {
+        std::vector<std::vector<float>> xs(batch), ys(batch);
+        std::vector<VPU::VPU_Task> batch_tasks(batch);
+        for (size_t i = 0; i < batch; ++i) {
+            xs[i] = random_values<float>(elements, rng);
+            ys[i] = random_values<float>(elements, rng);
+            VPU::VPU_Task& task = batch_tasks[i];
+            task.task_type = "SAXPY";
+            task.alpha = 1e-3f;
+            task.data_in_a = xs[i].data();
+            task.data_in_a_size_bytes = elements * sizeof(float);
+            task.data_out = ys[i].data();
+            task.num_elements = elements;
+            task.kernel.function_pointer = [](const void*, const void*, void*, size_t) {};
+        }
+        for (bool pipelined : {false, true}) {
+            environment.set_pipelined_mode(pipelined);
+            BenchResult* result = runner.run(std::string("scaling/submit_batch/") + (pipelined ? "pipelined/" : "") +
+                                             "batch:" + std::to_string(batch), [&]() {
+                for (auto& future : environment.submit_batch(batch_tasks)) future.get();
+                environment.wait_idle();
+            }, static_cast<double>(batch));
+            if (result) result->counters["batch"] = static_cast<double>(batch);
+        }
+        environment.set_pipelined_mode(false);
+    }
+}
+
+// --- Output ---
+
+nlohmann::json to_json(const std::vector<BenchResult>& results) {
+    const VPU::HAL::CacheSizes& caches = VPU::HAL::cpu_cache_sizes();
+    const std::time_t now = std::time(nullptr);
+    char date[64];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    nlohmann::json json;
+    json["context"] = {
+        {"date", date},
+        {"executable", "vpu_bench"},
+        {"num_cpus", std::thread::hardware_concurrency()},
+        {"simd_isa", VPU::HAL::simd_isa_name(VPU::HAL::best_simd_isa())},
+        {"caches", nlohmann::json::array({
+            {{"type", "Data"}, {"level", 1}, {"size", caches.l1d_bytes}},
+            {{"type", "Unified"}, {"level", 2}, {"size", caches.l2_bytes}},
+            {{"type", "Unified"}, {"level", 3}, {"size", caches.l3_bytes}}})},
+#ifdef NDEBUG
+        {"library_build_type", "release"},
+#else
+        {"library_build_type", "debug"},
+#endif
+    };
+    json["benchmarks"] = nlohmann::json::array();
+    for (const BenchResult& result : results) {
+        nlohmann::json entry = {
+            {"name", result.name},
+            {"run_name", result.name},
+            {"run_type", "iteration"},
+            {"iterations", result.iterations},
+            {"real_time", result.real_ns},
+            {"cpu_time", result.cpu_ns},
+            {"time_unit", "ns"},
+        };
+        if (result.items_per_iteration > 0.0) entry["items_per_second"] = result.items_per_iteration * 1e9 / result.real_ns;
+        if (result.bytes_per_iteration > 0.0) entry["bytes_per_second"] = result.bytes_per_iteration * 1e9 / result.real_ns;
+        for (const auto& counter : result.counters) entry[counter.first] = counter.second;
+        json["benchmarks"].push_back(entry);
+    }
+    return json;
+}
+
+// Benchmarks present in both runs whose real_time grew by more than 'max_regression'.
+int report_regressions(const nlohmann::json& current, const std::string& baseline_path, double max_regression) {
+    std::ifstream file(baseline_path);
+    if (!file) {
+        std::cerr << "vpu_bench: cannot read baseline '" << baseline_path << "'" << std::endl;
+        return 2;
+    }
+    const nlohmann::json baseline_json = nlohmann::json::parse(file);
+    std::map<std::string, double> baseline;
+    for (const auto& entry : baseline_json.at("benchmarks")) {
+        baseline[entry.at("name").get<std::string>()] = entry.at("real_time").get<double>();
+    }
+    int regressions = 0;
+    for (const auto& entry : current.at("benchmarks")) {
+        const auto it = baseline.find(entry.at("name").get<std::string>());
+        if (it == baseline.end() || it->second <= 0.0) continue;
+        const double change = entry.at("real_time").get<double>() / it->second - 1.0;
+        if (change > max_regression) {
+            std::cerr << "REGRESSION " << it->first << ": " << it->second << " -> " << entry.at("real_time").get<double>()
+                      << " ns (" << std::showpos << change * 100.0 << std::noshowpos << "%)" << std::endl;
+            ++regressions;
+        }
+    }
+    std::cerr << "vpu_bench: " << regressions << " regression(s) beyond " << max_regression * 100.0 << "%" << std::endl;
+    return regressions > 0 ? 1 : 0;
+}
+
+bool parse_arguments(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value_of = [&arg](const std::string& flag, std::string& value) {
+            if (arg.compare(0, flag.size(), flag) != 0) return false;
+            value = arg.substr(flag.size());
+            return true;
+        };
+        std::string value;
+        if (value_of("--out=", value)) {
+            options.out_path = value;
+        } else if (value_of("--filter=", value)) {
+            options.filter = value;
+        } else if (value_of("--min-time=", value)) {
+            options.min_time_s = std::stod(value);
+        } else if (value_of("--baseline=", value)) {
+            options.baseline_path = value;
+        } else if (value_of("--max-regression=", value)) {
+            options.max_regression = std::stod(value);
+        } else {
+            std::cerr << "Usage: vpu_bench [--out=FILE] [--filter=SUBSTRING] [--min-time=SECONDS]"
+                         " [--baseline=FILE [--max-regression=FRACTION]]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parse_arguments(argc, argv, options)) return 2;
+
+    // stdout carries the JSON (when no --out is given); VPU setup messages would interleave with it.
+    VPU::Runtime::set_log_level(VPU::Runtime::LogLevel::WARN);
+
+    Runner runner(options);
+    std::mt19937_64 rng(0xBE7C);
+    {
+        VPU::VPU_Environment environment;
+        VPU::VPUCore& core = *environment.get_core_for_testing();
+        std::vector<SampleTask> tasks = sample_tasks(rng);
+        bench_kernels(runner, core, rng);
+        bench_pillars(runner, core, tasks);
+        bench_execute(runner, environment, tasks);
+        bench_scaling(runner, environment, rng);
+    }
+
+    const nlohmann::json json = to_json(runner.results());
+    if (options.out_path.empty()) {
+        std::cout << json.dump(2) << std::endl;
+    } else {
+        std::ofstream out(options.out_path);
+        out << json.dump(2) << std::endl;
+        if (!out) {
+            std::cerr << "vpu_bench: cannot write '" << options.out_path << "'" << std::endl;
+            return 2;
+        }
+    }
+    return options.baseline_path.empty() ? 0 : report_regressions(json, options.baseline_path, options.max_regression);
+}
@@ -0,0 +1,47 @@
+#include "IoTClient.h"
+#include "runtime/trace.h" // For VPU_LOG_*
+
+IoTClient::IoTClient(const std::string& server_address, int server_port)
+    : httpClient(server_address, server_port),
+      server_address_(server_address),
+      server_port_(server_port) {
+    httpClient.set_keep_alive(true);
+}
+
+nlohmann::json IoTClient::listDevices() {
+    return parseResponse(httpClient.Get("/devices"));
+}
+
+nlohmann::json IoTClient::getDeviceStatus(const std::string& device_id) {
+    return parseResponse(httpClient.Get("/devices/" + device_id + "/status"));
+}
+
+nlohmann::json IoTClient::sendDeviceCommand(
+    const std::string& device_id,
+    const std::string& command,
+    const nlohmann::json& params) {
+    nlohmann::json body = {{"command", command}, {"params", params}};
+    return parseResponse(httpClient.Post("/devices/" + device_id + "/command", body.dump(), "application/json"));
+}
+
+nlohmann::json IoTClient::parseResponse(const httplib::Result& res) {
+    if (!res) {
+        if (log_failures_) {
+            VPU_LOG_WARN("[IoTClient] Request to " << server_address_ << ":" << server_port_ << " failed (no response).");
+        }
+        return nlohmann::json();
+    }
+    if (res->status != 200) {
+        if (log_failures_) {
+            VPU_LOG_WARN("[IoTClient] Request failed with HTTP status " << res->status << ".");
+        }
+        return nlohmann::json();
+    }
+    // Do not throw on malformed payloads; callers treat an empty json as "no data".
+    nlohmann::json parsed = nlohmann::json::parse(res->body, nullptr, false);
+    if (parsed.is_discarded()) {
+        VPU_LOG_WARN("[IoTClient] Failed to parse JSON response.");
+        return nlohmann::json();
+    }
+    return parsed;
+}
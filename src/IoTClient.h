@@ -13,8 +13,12 @@
 
 class IoTClient {
 public:
+    // Requests reuse one keep-alive connection.
     IoTClient(const std::string& server_address, int server_port);
 
+    // Failed requests are logged as warnings unless disabled (e.g. by a poller that reports outages itself).
+    void set_log_failures(bool enable) { log_failures_ = enable; }
+
     // Fetches all registered devices from the IoT framework
     // Returns a JSON object representing the list of devices, or an empty JSON if error.
     nlohmann::json listDevices();
@@ -39,6 +43,7 @@ private:
     httplib::Client httpClient;
     std::string server_address_;
     int server_port_;
+    bool log_failures_ = true;
 
     // Helper to parse JSON response
     nlohmann::json parseResponse(const httplib::Result& res);
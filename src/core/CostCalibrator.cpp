@@ -0,0 +1,301 @@
+#include "core/CostCalibrator.h"
+#include "core/SizeModel.h"   // For problem_shape, work_units
+#include "vpu.h"              // For VPU_Task
+#include "hal/convolution.h"  // For the overlap-save layout of the FFT stages
+#include "hal/hal_utils.h"    // For calculate_data_hamming_weight
+#include "runtime/trace.h"    // For VPU_LOG_*
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+
+namespace VPU {
+
+namespace {
+
+// Buffers and task for one grid point. The task points into the vectors, so a Workload is never copied.
+struct Workload {
+    std::vector<float> fa, fb, fc;
+    std::vector<double> da, dout, taps;
+    VPU_Task task;
+    const void* first_input = nullptr; // What Pillar 2 would profile (data_in_a)
+    size_t first_input_bytes = 0;
+};
+
+enum class WorkloadKind { NONE, SAXPY, GEMM, CONV_DIRECT, FFT_FORWARD, ELEMENT_WISE_MULTIPLY, FFT_INVERSE };
+
+WorkloadKind workload_kind(const std::string& op) {
+    if (op.compare(0, 6, "SAXPY_") == 0) return WorkloadKind::SAXPY;
+    if (op.compare(0, 5, "GEMM_") == 0) return WorkloadKind::GEMM;
+    if (op == "CONV_DIRECT") return WorkloadKind::CONV_DIRECT;
+    // The FFT kernels run as the overlap-save stages of the CONVOLUTION plan, so they are timed that way.
+    if (op == "FFT_FORWARD") return WorkloadKind::FFT_FORWARD;
+    if (op == "ELEMENT_WISE_MULTIPLY") return WorkloadKind::ELEMENT_WISE_MULTIPLY;
+    if (op == "FFT_INVERSE") return WorkloadKind::FFT_INVERSE;
+    return WorkloadKind::NONE;
+}
+
+// Values in [-1, 1) with 'sparsity' of them exactly zero.
+template <typename T>
+void fill(std::vector<T>& values, size_t count, double sparsity, std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    values.resize(count);
+    for (T& v : values) {
+        v = coin(rng) < sparsity ? T(0) : static_cast<T>(value(rng));
+    }
+}
+
+void build_workload(WorkloadKind kind, size_t size, double sparsity, const CalibrationOptions& options,
+                    std::mt19937_64& rng, Workload& w) {
+    VPU_Task& task = w.task;
+    switch (kind) {
+        case WorkloadKind::SAXPY:
+            fill(w.fa, size, sparsity, rng);
+            fill(w.fc, size, 0.0, rng);
+            task.task_type = "SAXPY";
+            task.alpha = 0.5f;
+            task.data_in_a = w.fa.data();
+            task.data_out = w.fc.data();
+            task.num_elements = size;
+            w.first_input_bytes = size * sizeof(float);
+            break;
+        case WorkloadKind::GEMM:
+            fill(w.fa, size * size, sparsity, rng);
+            fill(w.fb, size * size, 0.0, rng);
+            w.fc.assign(size * size, 0.0f);
+            task.task_type = "GEMM";
+            task.data_in_a = w.fa.data();
+            task.data_in_b = w.fb.data();
+            task.data_out = w.fc.data();
+            task.num_elements = size * size;
+            task.extended_params["M"] = task.extended_params["N"] = task.extended_params["K"] = static_cast<int>(size);
+            w.first_input_bytes = size * size * sizeof(float);
+            break;
+        case WorkloadKind::CONV_DIRECT:
+        case WorkloadKind::FFT_FORWARD:
+        case WorkloadKind::ELEMENT_WISE_MULTIPLY:
+        case WorkloadKind::FFT_INVERSE: {
+            fill(w.taps, options.conv_taps, 0.0, rng);
+            const HAL::OverlapSaveLayout layout = HAL::plan_overlap_save(size, options.conv_taps);
+            task.task_type = "CONVOLUTION";
+            task.num_elements = size;
+            task.conv_filter = HAL::Span<const double>(w.taps);
+            if (kind == WorkloadKind::CONV_DIRECT || kind == WorkloadKind::FFT_FORWARD) {
+                fill(w.da, size, sparsity, rng); // The signal
+            } else {
+                fill(w.da, layout.spectra_doubles(), sparsity, rng); // Block spectra
+            }
+            w.dout.assign(kind == WorkloadKind::CONV_DIRECT || kind == WorkloadKind::FFT_INVERSE ? size : layout.spectra_doubles(), 0.0);
+            task.data_in_a = w.da.data();
+            task.data_out = w.dout.data();
+            task.data_out_size_bytes = w.dout.size() * sizeof(double);
+            w.first_input_bytes = w.da.size() * sizeof(double);
+            break;
+        }
+        case WorkloadKind::NONE:
+            break;
+    }
+    task.data_in_a_size_bytes = w.first_input_bytes;
+    w.first_input = task.data_in_a;
+}
+
+// Least-squares fit of y = a + b * x; b is clamped at 0 (costs do not fall as the input gains set bits).
+std::pair<double, double> fit_line(const std::vector<double>& x, const std::vector<double>& y) {
+    const double n = static_cast<double>(x.size());
+    double sx = 0.0, sy = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        sx += x[i];
+        sy += y[i];
+    }
+    const double mean_x = sx / n, mean_y = sy / n;
+    double sxx = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        sxx += (x[i] - mean_x) * (x[i] - mean_x);
+        sxy += (x[i] - mean_x) * (y[i] - mean_y);
+    }
+    const double slope = sxx > 0.0 ? std::max(0.0, sxy / sxx) : 0.0;
+    return {mean_y - slope * mean_x, slope};
+}
+
+// Fits 'model' per cache regime by least squares through the origin (cost = per_unit * work), then
+// leaves in 'costs' what the size term does not explain, for the base cost and Hamming weight fit.
+// Regimes the grid did not reach take the coefficient of the nearest regime it did.
+void fit_size_model(const std::vector<const CalibrationSample*>& samples, std::vector<double>& costs, SizeModel& model) {
+    double cost_work[CACHE_REGIME_COUNT] = {0.0, 0.0, 0.0, 0.0}, work_work[CACHE_REGIME_COUNT] = {0.0, 0.0, 0.0, 0.0};
+    std::vector<double> work(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        work[i] = work_units(model.complexity, samples[i]->shape, 1.0 - samples[i]->sparsity);
+        cost_work[samples[i]->shape.cache_regime] += costs[i] * work[i];
+        work_work[samples[i]->shape.cache_regime] += work[i] * work[i];
+    }
+    int fitted[CACHE_REGIME_COUNT];
+    for (int regime = 0; regime < CACHE_REGIME_COUNT; ++regime) {
+        fitted[regime] = work_work[regime] > 0.0 ? regime : -1;
+        if (fitted[regime] >= 0) model.per_unit[regime] = std::max(0.0, cost_work[regime] / work_work[regime]);
+    }
+    for (int regime = 0; regime < CACHE_REGIME_COUNT; ++regime) {
+        if (fitted[regime] >= 0) continue;
+        for (int distance = 1; distance < CACHE_REGIME_COUNT; ++distance) {
+            const int lower = regime - distance, upper = regime + distance;
+            const int source = lower >= 0 && fitted[lower] == lower ? lower
+                             : upper < CACHE_REGIME_COUNT && fitted[upper] == upper ? upper : -1;
+            if (source >= 0) {
+                model.per_unit[regime] = model.per_unit[source];
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < samples.size(); ++i) {
+        costs[i] -= model.per_unit[samples[i]->shape.cache_regime] * work[i];
+    }
+}
+
+} // namespace
+
+CostCalibrator::CostCalibrator(std::shared_ptr<HardwareProfileStore> store, KernelSet kernels, CalibrationOptions options)
+    : store_(std::move(store)), kernels_(std::move(kernels)), options_(std::move(options)),
+      result_(promise_.get_future().share()) {
+    thread_ = std::thread(&CostCalibrator::run, this);
+}
+
+CostCalibrator::~CostCalibrator() {
+    cancelled_.store(true, std::memory_order_relaxed);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::vector<CalibrationSample> CostCalibrator::measure(const KernelSet& kernels, const CalibrationOptions& options,
+                                                       const std::atomic<bool>* cancelled) {
+    const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
+    std::mt19937_64 rng(options.seed);
+    std::vector<CalibrationSample> samples;
+    for (const auto& entry : kernels) {
+        const std::string& name = registry.name(entry.first);
+        const WorkloadKind kind = workload_kind(name);
+        if (kind == WorkloadKind::NONE || !entry.second) {
+            VPU_LOG_DEBUG("[Calibration] No workload for '" << name << "'; keeping its prior.");
+            continue;
+        }
+        const std::vector<size_t>& sizes = kind == WorkloadKind::GEMM ? options.matrix_sizes : options.vector_sizes;
+        for (size_t size : sizes) {
+            for (double sparsity : options.sparsities) {
+                if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+                    return samples;
+                }
+                Workload w;
+                build_workload(kind, size, sparsity, options, rng, w);
+                CalibrationSample sample;
+                sample.op = entry.first;
+                sample.size = size;
+                sample.sparsity = sparsity;
+                sample.hamming_weight = HAL::calculate_data_hamming_weight(w.first_input, w.first_input_bytes);
+                sample.shape = problem_shape(w.task);
+                sample.latency_ns = std::numeric_limits<double>::max();
+
+                bool ran = true;
+                const size_t runs = std::max<size_t>(options.repetitions, 1) + 1;
+                for (size_t run = 0; run < runs && ran; ++run) { // Run 0 warms caches and plans
+                    const auto start = std::chrono::steady_clock::now();
+                    const HAL::KernelFluxReport report = entry.second(w.task);
+                    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+                    ran = report.cycle_cost != 0;
+                    if (run > 0) {
+                        sample.latency_ns = std::min(sample.latency_ns, elapsed.count());
+                        sample.observed_flux = static_cast<double>(report.cycle_cost + report.hw_in_cost + report.hw_out_cost);
+                    }
+                }
+                if (!ran) {
+                    VPU_LOG_WARN("[Calibration] '" << name << "' failed at size " << size << "; skipping it.");
+                    break;
+                }
+                samples.push_back(sample);
+            }
+        }
+    }
+    return samples;
+}
+
+size_t CostCalibrator::fit(const std::vector<CalibrationSample>& samples, HardwareProfile& profile, double* flux_per_ns) {
+    // One scale for the whole host keeps the fitted costs in the units Pillar 5 observes.
+    double total_flux = 0.0, total_ns = 0.0;
+    std::map<HAL::OpId, std::vector<const CalibrationSample*>> by_op;
+    for (const CalibrationSample& sample : samples) {
+        total_flux += sample.observed_flux;
+        total_ns += sample.latency_ns;
+        by_op[sample.op].push_back(&sample);
+    }
+    const double scale = total_ns > 0.0 ? total_flux / total_ns : 0.0;
+    if (flux_per_ns) {
+        *flux_per_ns = scale;
+    }
+    if (scale <= 0.0) {
+        return 0;
+    }
+
+    const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
+    size_t written = 0;
+    for (const auto& entry : by_op) {
+        const HAL::OpId op = entry.first;
+        std::vector<double> hamming_weights, costs;
+        for (const CalibrationSample* sample : entry.second) {
+            hamming_weights.push_back(static_cast<double>(sample->hamming_weight));
+            costs.push_back(sample->latency_ns * scale);
+        }
+        if (SizeModel* size_model = profile.size_models.find(op)) {
+            fit_size_model(entry.second, costs, *size_model);
+            ++written;
+        }
+        const auto line = fit_line(hamming_weights, costs); // (base, lambda_hw)
+        double mean = 0.0;
+        for (double cost : costs) mean += cost;
+        mean /= static_cast<double>(costs.size());
+
+        // Pillar 5 keeps costs at or above 1.
+        if (double* transform = profile.transform_costs.find(op)) {
+            *transform = std::max(1.0, mean);
+            ++written;
+        }
+        if (double* base = profile.base_operational_costs.find(op)) {
+            double* lambda_hw = profile.flux_sensitivities.find(registry.hw_sensitivity_id(op));
+            if (lambda_hw && line.first >= 1.0) {
+                *base = line.first;
+                *lambda_hw = line.second;
+                written += 2;
+            } else {
+                *base = std::max(1.0, mean);
+                ++written;
+            }
+        }
+        VPU_LOG_DEBUG("[Calibration] '" << registry.name(op) << "': mean " << mean << " flux over "
+                      << costs.size() << " point(s), " << line.second << " flux per set bit.");
+    }
+    return written;
+}
+
+void CostCalibrator::run() {
+    Runtime::TraceSpan span("calibrate");
+    CalibrationReport report;
+    const auto start = std::chrono::steady_clock::now();
+    report.samples = measure(kernels_, options_, &cancelled_);
+    if (cancelled_.load(std::memory_order_relaxed)) {
+        VPU_LOG_INFO("[Calibration] Cancelled after " << report.samples.size() << " measurement(s); beliefs unchanged.");
+        promise_.set_value(std::move(report));
+        return;
+    }
+    // Fitted against the staging copy under the writer lock, so concurrent learning is not lost.
+    report.belief_version = store_->update([&](HardwareProfile& beliefs) {
+        report.calibrated_beliefs = fit(report.samples, beliefs, &report.flux_per_ns);
+    });
+    report.completed = true;
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    VPU_LOG_INFO("[Calibration] Fitted " << report.calibrated_beliefs << " belief(s) from " << report.samples.size()
+                 << " measurement(s) in " << elapsed.count() << " ms (" << report.flux_per_ns
+                 << " flux/ns); published as belief version " << report.belief_version << ".");
+    promise_.set_value(std::move(report));
+}
+
+} // namespace VPU
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "vpu_data_structures.h" // For CalibrationOptions, CalibrationReport
+#include "core/HardwareProfile.h"
+#include "hal/hal.h" // For HAL::GenericKernel
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace VPU {
+
+// Replaces the built-in cost priors with measurements of this host.
+// Times every kernel it is given across CalibrationOptions' sizes and sparsity levels, then fits
+// each operation's belief from the wall-clock times, converted to flux units by one host-wide
+// scale (observed flux per ns over all samples), so the costs Pillar 3 compares are ranked by
+// how fast each kernel really is here:
+// - Size models: flux per unit of work in each cache regime the grid reaches, by least squares
+//   through the origin; the costs below are fitted to what the size term leaves unexplained.
+// - Base operational costs: base + lambda_hw * hamming_weight by least squares, when the
+//   operation has a "<op>_lambda_hw_combined" sensitivity; otherwise the mean cost.
+// - Transform costs: the mean cost.
+// Operations with no belief to fit (e.g. fused kernels) are measured but left alone.
+class CostCalibrator {
+public:
+    using KernelSet = std::vector<std::pair<HAL::OpId, HAL::GenericKernel>>;
+
+    // Starts measuring on a background thread; the fit is published to 'store' as one belief version.
+    CostCalibrator(std::shared_ptr<HardwareProfileStore> store, KernelSet kernels, CalibrationOptions options);
+    ~CostCalibrator(); // Cancels between measurements and joins the thread
+
+    CostCalibrator(const CostCalibrator&) = delete;
+    CostCalibrator& operator=(const CostCalibrator&) = delete;
+
+    // Ready once the beliefs are published (or the run was cancelled: report.completed is false).
+    std::shared_future<CalibrationReport> result() const { return result_; }
+
+    // Times 'kernels' over the options' grid. Kernels this calibrator has no workload for are skipped.
+    // Stops early (returning what it has) once 'cancelled' is set.
+    static std::vector<CalibrationSample> measure(const KernelSet& kernels, const CalibrationOptions& options,
+                                                  const std::atomic<bool>* cancelled = nullptr);
+    // Fits 'samples' onto 'profile' (see the class comment). Returns the number of beliefs written.
+    static size_t fit(const std::vector<CalibrationSample>& samples, HardwareProfile& profile, double* flux_per_ns = nullptr);
+
+private:
+    void run();
+
+    std::shared_ptr<HardwareProfileStore> store_;
+    const KernelSet kernels_;
+    const CalibrationOptions options_;
+
+    std::atomic<bool> cancelled_{false};
+    std::promise<CalibrationReport> promise_;
+    std::shared_future<CalibrationReport> result_;
+    std::thread thread_; // Started last
+};
+
+} // namespace VPU
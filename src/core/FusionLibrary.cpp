@@ -0,0 +1,129 @@
+#include "core/FusionLibrary.h"
+#include "vpu.h"                // For VPU_Task
+#include "hal/buffer_stats.h" // For HAL::hamming_weight_reusing
+#include "hal/hal_utils.h"    // For calculate_data_hamming_weight
+#include "hal/sparse.h"       // For the fused sparse GEMM kernels
+#include "hal/convolution.h"  // For the fused overlap-save stages
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <cmath>              // For std::log2
+
+namespace VPU {
+
+namespace {
+
+using SkipZeroGemmFn = bool (*)(HAL::Span<const float>, HAL::Span<const float>, HAL::Span<float>, int, int, int, uint64_t*);
+
+bool fused_skip_zeros_csr(HAL::Span<const float> A, HAL::Span<const float> B, HAL::Span<float> C, int M, int N, int K, uint64_t* stored) {
+    return HAL::cpu_gemm_skip_zeros(A, B, C, M, N, K, stored);
+}
+
+bool fused_skip_zeros_bsr(HAL::Span<const float> A, HAL::Span<const float> B, HAL::Span<float> C, int M, int N, int K, uint64_t* stored) {
+    return HAL::cpu_gemm_skip_zero_blocks(A, B, C, M, N, K, HAL::BSR_BLOCK_SIZE, HAL::BSR_BLOCK_SIZE, stored);
+}
+
+// Dense A -> sparse encoding -> SpMM, as one kernel. Against the unfused pair, the report
+// drops the encoding's round trip: its write (hw_out of the conversion) and its re-read
+// (the stored values' share of SpMM's hw_in).
+HAL::GenericKernel make_fused_sparse_gemm(const std::string& name, SkipZeroGemmFn fn) {
+    return [name, fn](VPU_Task& task) -> HAL::KernelFluxReport {
+        if (!task.data_in_a || !task.data_in_b || !task.data_out ||
+            !task.extended_params.count("M") || !task.extended_params.count("N") || !task.extended_params.count("K")) {
+            VPU_LOG_WARN(name << ": Invalid data pointers or missing M, N, K dimensions.");
+            return {0, 0, 0};
+        }
+        const int M = task.extended_params["M"];
+        const int N = task.extended_params["N"];
+        const int K = task.extended_params["K"];
+        HAL::Span<const float> A = HAL::as_span<float>(task.data_in_a, static_cast<size_t>(M) * K);
+        HAL::Span<const float> B = HAL::as_span<float>(task.data_in_b, static_cast<size_t>(K) * N);
+        HAL::Span<float> C = HAL::as_mutable_span<float>(task.data_out, static_cast<size_t>(M) * N);
+
+        HAL::KernelFluxReport report;
+        report.hw_in_cost = HAL::hamming_weight_reusing(A.data(), A.size_bytes());
+        report.hw_in_cost += HAL::calculate_data_hamming_weight(B.data(), B.size_bytes());
+        uint64_t stored_values = 0;
+        if (!fn(A, B, C, M, N, K, &stored_values)) {
+            return {0, 0, 0};
+        }
+        report.hw_out_cost = HAL::calculate_data_hamming_weight(C.data(), C.size_bytes());
+        // The scan of A, plus one multiply-add per stored value per column (as in SpMM)
+        report.cycle_cost = static_cast<uint64_t>(M) * K + stored_values * static_cast<uint64_t>(N) * 2;
+        return report;
+    };
+}
+
+// FFT_FORWARD -> ELEMENT_WISE_MULTIPLY for CONVOLUTION: each block is multiplied by the filter's
+// spectrum while it is still in cache, so the block spectra are written once and never re-read.
+HAL::KernelFluxReport fused_fft_forward_multiply(VPU_Task& task) {
+    if (!task.data_in_a || !task.data_out || task.num_elements == 0 || task.conv_filter.empty()) {
+        VPU_LOG_WARN("FUSED_FFT_FORWARD_ELEMENT_WISE_MULTIPLY: Invalid data pointers, zero elements or no filter taps.");
+        return {0, 0, 0};
+    }
+    const HAL::OverlapSaveLayout layout = HAL::plan_overlap_save(task.num_elements, task.conv_filter.size());
+    HAL::Span<const double> x = HAL::as_span<double>(task.data_in_a, task.num_elements);
+    HAL::Span<double> products = HAL::as_mutable_span<double>(task.data_out, layout.spectra_doubles());
+
+    HAL::KernelFluxReport report;
+    report.hw_in_cost = HAL::hamming_weight_reusing(x.data(), x.size_bytes());
+    if (!HAL::overlap_save_forward_multiply(x, task.conv_filter, layout, products)) {
+        return {0, 0, 0};
+    }
+    report.hw_out_cost = HAL::calculate_data_hamming_weight(products.data(), products.size_bytes());
+    // The block transforms and the filter's, plus 6 flops per complex product (as unfused)
+    const double transform = layout.fft_length * std::log2(layout.fft_length) * 5;
+    report.cycle_cost = static_cast<uint64_t>((layout.blocks + 1) * transform) +
+                        static_cast<uint64_t>(layout.blocks) * (layout.fft_length / 2 + 1) * 6;
+    return report;
+}
+
+FusionRule make_rule(const std::string& first, const std::string& second, HAL::GenericKernel kernel, double cost_prior) {
+    FusionRule rule;
+    rule.first = first;
+    rule.second = second;
+    rule.fused_name = fused_operation_name(first, second);
+    rule.first_id = HAL::intern_op(first);
+    rule.second_id = HAL::intern_op(second);
+    rule.fused_id = HAL::intern_op(rule.fused_name);
+    rule.kernel = std::move(kernel);
+    rule.cost_prior = cost_prior;
+    return rule;
+}
+
+std::vector<FusionRule> build_fusion_rules() {
+    std::vector<FusionRule> rules;
+    // Sparse GEMM: the conversion is a full pass over A whose output SpMM immediately re-reads.
+    rules.push_back(make_rule("DENSE_TO_CSR", "SPMM_CSR",
+                              make_fused_sparse_gemm("FUSED_DENSE_TO_CSR_SPMM_CSR", &fused_skip_zeros_csr), 0.7));
+    rules.push_back(make_rule("DENSE_TO_BSR", "SPMM_BSR",
+                              make_fused_sparse_gemm("FUSED_DENSE_TO_BSR_SPMM_BSR", &fused_skip_zeros_bsr), 0.7));
+    // FFT convolution: the forward transform's block spectra feed the multiply directly.
+    rules.push_back(make_rule("FFT_FORWARD", "ELEMENT_WISE_MULTIPLY", &fused_fft_forward_multiply, 0.8));
+    return rules;
+}
+
+} // namespace
+
+std::string fused_operation_name(const std::string& first, const std::string& second) {
+    return "FUSED_" + first + "_" + second;
+}
+
+const std::vector<FusionRule>& fusion_rules() {
+    static const std::vector<FusionRule> rules = build_fusion_rules(); // Thread-safe one-time initialization
+    return rules;
+}
+
+const FusionRule* find_fusion_rule(const std::string& first, const std::string& second) {
+    for (const FusionRule& rule : fusion_rules()) {
+        if (rule.first == first && rule.second == second) return &rule;
+    }
+    return nullptr;
+}
+
+const FusionRule* find_fusion_rule(HAL::OpId fused_id) {
+    for (const FusionRule& rule : fusion_rules()) {
+        if (rule.fused_id == fused_id) return &rule;
+    }
+    return nullptr;
+}
+
+} // namespace VPU
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "hal/hal.h" // For HAL::GenericKernel, HAL::OpId
+#include <string>
+#include <vector>
+
+namespace VPU {
+
+// An adjacent pair of plan steps that the HAL can run as one single-pass kernel, keeping the
+// intermediate in cache instead of writing it out and reading it back. Pillar 6 registers
+// 'kernel' once the pair is frequent; Pillar 3 then proposes plans that use the fused step,
+// and Pillar 5 learns its cost like any other operation.
+struct FusionRule {
+    std::string first;
+    std::string second;
+    std::string fused_name; // fused_operation_name(first, second)
+    HAL::OpId first_id = HAL::INVALID_OP_ID;
+    HAL::OpId second_id = HAL::INVALID_OP_ID;
+    HAL::OpId fused_id = HAL::INVALID_OP_ID;
+    HAL::GenericKernel kernel;
+    double cost_prior = 0.8; // Initial belief: fused cost as a fraction of first + second
+};
+
+// "FUSED_<first>_<second>"
+std::string fused_operation_name(const std::string& first, const std::string& second);
+
+// Every pair the HAL has a fused implementation for (OpIds interned once).
+const std::vector<FusionRule>& fusion_rules();
+// nullptr if the pair has no fused implementation.
+const FusionRule* find_fusion_rule(const std::string& first, const std::string& second);
+const FusionRule* find_fusion_rule(HAL::OpId fused_id);
+
+} // namespace VPU
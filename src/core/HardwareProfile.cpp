@@ -0,0 +1,167 @@
+#include "core/HardwareProfile.h"
+#include <array>
+#include <atomic> // For std::atomic_load / std::atomic_store on shared_ptr
+#include <cmath>  // For std::pow
+#include <stdexcept>
+
+namespace VPU {
+
+double& CostTable::operator[](HAL::OpId id) {
+    if (id == HAL::INVALID_OP_ID) {
+        throw std::invalid_argument("CostTable: invalid operation ID.");
+    }
+    if (id >= values_.size()) {
+        values_.resize(static_cast<size_t>(id) + 1, 0.0);
+        present_.resize(static_cast<size_t>(id) + 1, 0);
+    }
+    if (!present_[id]) {
+        present_[id] = 1;
+        ++size_;
+    }
+    return values_[id];
+}
+
+double& CostTable::at(const std::string& key) {
+    double* value = find(HAL::OperationRegistry::instance().find(key));
+    if (!value) {
+        throw std::out_of_range("CostTable: no value for key '" + key + "'.");
+    }
+    return *value;
+}
+
+const double& CostTable::at(const std::string& key) const {
+    const double* value = find(HAL::OperationRegistry::instance().find(key));
+    if (!value) {
+        throw std::out_of_range("CostTable: no value for key '" + key + "'.");
+    }
+    return *value;
+}
+
+void LatencyStats::add(double latency_ns) {
+    ++samples;
+    const double delta = latency_ns - mean_ns;
+    mean_ns += delta / static_cast<double>(samples);
+    m2 += delta * (latency_ns - mean_ns);
+}
+
+void LatencyStats::merge(const LatencyStats& batch, double ewma_weight) {
+    if (batch.samples == 0) {
+        return;
+    }
+    const double n_a = static_cast<double>(samples);
+    const double n_b = static_cast<double>(batch.samples);
+    const double n = n_a + n_b;
+    const double delta = batch.mean_ns - mean_ns;
+    // With no history the EWMA starts at the batch mean.
+    ewma_ns = samples == 0 ? batch.mean_ns
+                           : ewma_ns + (1.0 - std::pow(1.0 - ewma_weight, n_b)) * (batch.mean_ns - ewma_ns);
+    mean_ns += delta * n_b / n;
+    m2 += batch.m2 + delta * delta * n_a * n_b / n;
+    samples += batch.samples;
+}
+
+LatencyStats& LatencyTable::operator[](HAL::OpId id) {
+    if (id == HAL::INVALID_OP_ID) {
+        throw std::invalid_argument("LatencyTable: invalid operation ID.");
+    }
+    if (id >= stats_.size()) {
+        stats_.resize(static_cast<size_t>(id) + 1);
+    }
+    return stats_[id];
+}
+
+size_t LatencyTable::size() const {
+    size_t observed = 0;
+    for (const LatencyStats& stats : stats_) {
+        observed += stats.samples != 0 ? 1 : 0;
+    }
+    return observed;
+}
+
+SizeModel SizeModel::uniform(Complexity complexity, double per_unit) {
+    SizeModel model;
+    model.complexity = complexity;
+    for (double& coefficient : model.per_unit) {
+        coefficient = per_unit;
+    }
+    return model;
+}
+
+SizeModel& SizeModelTable::operator[](HAL::OpId id) {
+    if (id == HAL::INVALID_OP_ID) {
+        throw std::invalid_argument("SizeModelTable: invalid operation ID.");
+    }
+    if (id >= models_.size()) {
+        models_.resize(static_cast<size_t>(id) + 1);
+    }
+    return models_[id];
+}
+
+size_t SizeModelTable::size() const {
+    size_t modelled = 0;
+    for (const SizeModel& model : models_) {
+        modelled += model.complexity != Complexity::NONE ? 1 : 0;
+    }
+    return modelled;
+}
+
+namespace {
+std::atomic<uint64_t> g_next_store_id{1};
+
+// A thread's most recently read snapshot of one store. The slot pins that version until the
+// thread reads a newer one or reuses the slot for another store.
+struct CachedSnapshot {
+    uint64_t store_id = 0;
+    HardwareProfileSnapshot snapshot;
+};
+const size_t SNAPSHOT_CACHE_SLOTS = 4; // Stores a thread reads in turn (e.g. several VPU instances)
+} // namespace
+
+HardwareProfileStore::HardwareProfileStore(HardwareProfile initial)
+: id_(g_next_store_id.fetch_add(1, std::memory_order_relaxed)), version_(1) {
+    initial.version = 1;
+    current_ = std::make_shared<const HardwareProfile>(std::move(initial));
+}
+
+HardwareProfileSnapshot HardwareProfileStore::snapshot() const {
+    thread_local std::array<CachedSnapshot, SNAPSHOT_CACHE_SLOTS> cache;
+    thread_local size_t next_slot = 0;
+    const uint64_t published = version();
+    CachedSnapshot* slot = nullptr;
+    for (CachedSnapshot& cached : cache) {
+        if (cached.store_id == id_) {
+            slot = &cached;
+            break;
+        }
+    }
+    if (!slot) {
+        slot = &cache[next_slot++ % SNAPSHOT_CACHE_SLOTS];
+        slot->store_id = id_;
+        slot->snapshot = nullptr;
+    }
+    // version_ is stored after current_, so the reload is at least as new as 'published'.
+    if (!slot->snapshot || slot->snapshot->version != published) {
+        slot->snapshot = std::atomic_load(&current_);
+    }
+    return slot->snapshot;
+}
+
+uint64_t HardwareProfileStore::publish() {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    if (!staging_) {
+        return snapshot()->version;
+    }
+    // Only writers replace current_, and they hold writer_mutex_, so this read is stable.
+    staging_->version = version() + 1;
+    const uint64_t new_version = staging_->version;
+    std::atomic_store(&current_, HardwareProfileSnapshot(std::move(staging_)));
+    version_.store(new_version, std::memory_order_release);
+    return new_version;
+}
+
+bool HardwareProfileStore::has_unpublished_changes() const {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    return staging_ != nullptr;
+}
+
+} // namespace VPU
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <utility> // For std::forward
+#include <vector>
+#include "hal/op_registry.h"
+#include "vpu_data_structures.h" // For CacheRegime
+
+namespace VPU {
+
+// A belief table indexed by interned OpId (dense array + presence mask).
+// Pillar 3 prices plans through the OpId overloads; the string overloads keep the
+// familiar map-style interface for configuration, learning and tests.
+class CostTable {
+public:
+    // --- By name (interns on write, looks up on read) ---
+    size_t count(const std::string& key) const { return count(HAL::OperationRegistry::instance().find(key)); }
+    double& operator[](const std::string& key) { return (*this)[HAL::intern_op(key)]; }
+    // Throw std::out_of_range if the key has no value.
+    double& at(const std::string& key);
+    const double& at(const std::string& key) const;
+
+    // --- By ID (planning fast path) ---
+    size_t count(HAL::OpId id) const { return find(id) ? 1 : 0; }
+    double& operator[](HAL::OpId id);
+    // nullptr if the table has no value for 'id'.
+    const double* find(HAL::OpId id) const {
+        return (id < present_.size() && present_[id]) ? &values_[id] : nullptr;
+    }
+    double* find(HAL::OpId id) {
+        return (id < present_.size() && present_[id]) ? &values_[id] : nullptr;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Visits (name, value) for every entry, in ID order.
+    template <typename Visitor>
+    void for_each(Visitor&& visitor) const {
+        const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
+        for (size_t id = 0; id < present_.size(); ++id) {
+            if (present_[id]) {
+                visitor(registry.name(static_cast<HAL::OpId>(id)), values_[id]);
+            }
+        }
+    }
+
+private:
+    std::vector<double> values_;
+    std::vector<uint8_t> present_;
+    size_t size_ = 0;
+};
+
+// Running statistics of one operation's observed wall-clock latency.
+struct LatencyStats {
+    uint64_t samples = 0;
+    double mean_ns = 0.0; // Welford running mean
+    double m2 = 0.0;      // Welford sum of squared deviations from the mean
+    double ewma_ns = 0.0; // Recency-weighted mean; what Pillar 3 predicts with
+
+    // One Welford step (ewma_ns is left to merge()).
+    void add(double latency_ns);
+    // Folds in a batch gathered with add(): Chan's parallel combination for mean and variance;
+    // the EWMA moves as if the batch's samples arrived one by one, each at the batch mean.
+    void merge(const LatencyStats& batch, double ewma_weight);
+    double variance_ns2() const { return samples > 1 ? m2 / static_cast<double>(samples - 1) : 0.0; }
+};
+
+// Latency statistics indexed by interned OpId, like CostTable.
+class LatencyTable {
+public:
+    // nullptr if the operation has never been observed.
+    const LatencyStats* find(HAL::OpId id) const {
+        return (id < stats_.size() && stats_[id].samples != 0) ? &stats_[id] : nullptr;
+    }
+    const LatencyStats* find(const std::string& key) const { return find(HAL::OperationRegistry::instance().find(key)); }
+    LatencyStats& operator[](HAL::OpId id);
+
+    size_t size() const; // Observed operations
+    bool empty() const { return size() == 0; }
+
+    // Visits (name, stats) for every observed operation, in ID order.
+    template <typename Visitor>
+    void for_each(Visitor&& visitor) const {
+        const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
+        for (size_t id = 0; id < stats_.size(); ++id) {
+            if (stats_[id].samples != 0) {
+                visitor(registry.name(static_cast<HAL::OpId>(id)), stats_[id]);
+            }
+        }
+    }
+
+private:
+    std::vector<LatencyStats> stats_;
+};
+
+// How an operation's work grows with the problem's dimensions (see work_units() in core/SizeModel.h).
+// Ordered by growth, so the larger of two is the one that dominates a fused pair.
+enum class Complexity : uint8_t {
+    NONE = 0,   // No size model
+    LINEAR,     // elements
+    N_LOG_N,    // FFT work
+    N_TAPS,     // elements * filter taps (direct convolution)
+    SPARSE_MNK, // m * n * k * density of A (SpMM)
+    MNK         // m * n * k (dense GEMM)
+};
+
+// An operation's size-dependent cost: flux per unit of work, learned separately for each cache
+// regime, so the cost per unit can step up where the working set outgrows a cache level.
+struct SizeModel {
+    Complexity complexity = Complexity::NONE;
+    double per_unit[CACHE_REGIME_COUNT] = {0.0, 0.0, 0.0, 0.0};
+
+    // The same coefficient in every regime (a prior before anything is observed).
+    static SizeModel uniform(Complexity complexity, double per_unit);
+    double cost(CacheRegime regime, double work_units) const { return per_unit[regime] * work_units; }
+};
+
+// Size models indexed by interned OpId, like CostTable. Operations without one are priced
+// by their base and transform costs alone.
+class SizeModelTable {
+public:
+    // nullptr if the operation has no size model.
+    const SizeModel* find(HAL::OpId id) const {
+        return (id < models_.size() && models_[id].complexity != Complexity::NONE) ? &models_[id] : nullptr;
+    }
+    SizeModel* find(HAL::OpId id) {
+        return (id < models_.size() && models_[id].complexity != Complexity::NONE) ? &models_[id] : nullptr;
+    }
+    const SizeModel* find(const std::string& key) const { return find(HAL::OperationRegistry::instance().find(key)); }
+    SizeModel& operator[](HAL::OpId id);
+    SizeModel& operator[](const std::string& key) { return (*this)[HAL::intern_op(key)]; }
+
+    size_t size() const; // Operations with a size model
+    bool empty() const { return size() == 0; }
+
+    // Visits (name, model) for every operation with a size model, in ID order.
+    template <typename Visitor>
+    void for_each(Visitor&& visitor) const {
+        const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
+        for (size_t id = 0; id < models_.size(); ++id) {
+            if (models_[id].complexity != Complexity::NONE) {
+                visitor(registry.name(static_cast<HAL::OpId>(id)), models_[id]);
+            }
+        }
+    }
+
+private:
+    std::vector<SizeModel> models_;
+};
+
+// Represents the hardware's known performance characteristics (the "beliefs").
+// This is the core model that Pillar 5 will update.
+struct HardwareProfile {
+    // Defines the base cost for an operation, primarily predicting cycle_cost.
+    // e.g., "CONV_DIRECT" -> 100.0 (arbitrary flux units, representing estimated cycles)
+    // This cost is for the operation itself, assuming neutral or average data impact.
+    CostTable base_operational_costs;
+
+    // Defines the cost of changing data representation or setup costs.
+    // e.g., "FFT_FORWARD" (if considered a transform), "JIT_COMPILE_SAXPY"
+    // Key: string (e.g., "TRANSFORM_TIME_TO_FREQ")
+    CostTable transform_costs;
+
+    // Defines how sensitive an operation is to different data characteristics (flux per unit of metric).
+    // These are the "lambdas" that Pillar 5 learns and updates.
+    // Examples:
+    // - "OPERATION_NAME_lambda_Sparsity" -> how cost changes with data sparsity.
+    // - "OPERATION_NAME_lambda_AmplitudeFlux" -> how cost changes with amplitude flux.
+    // - "OPERATION_NAME_lambda_hw_combined" -> new, for Hamming Weight sensitivity.
+    CostTable flux_sensitivities;
+
+    // Observed wall-clock latency per operation (keyed like the costs: "<op>@<substrate>" off
+    // the host). Pillar 5 merges it from per-thread batches; Pillar 3 turns it into
+    // ExecutionPlan::predicted_latency_ns.
+    LatencyTable latency;
+
+    // How each operation's cost grows with the problem size (keyed like the costs). Pillar 3 adds
+    // the cost of the task's work to the step's base or transform cost; Pillar 5 learns the
+    // coefficients of the cache regime the task ran in.
+    SizeModelTable size_models;
+
+    // Belief version this profile was published as. Stamped by HardwareProfileStore::publish().
+    uint64_t version = 0;
+};
+
+// An immutable, published version of the beliefs. Holding one keeps that version alive.
+using HardwareProfileSnapshot = std::shared_ptr<const HardwareProfile>;
+
+// Read-copy-update container for the VPU's beliefs.
+// - Readers (Pillar 3 planning) take a snapshot without locking and see one consistent version.
+// - Writers (Pillar 5 learning, Pillar 6 fusion) mutate a private staging copy; nothing they
+//   do is visible until publish() atomically swaps the staging copy in as the next version.
+class HardwareProfileStore {
+public:
+    explicit HardwareProfileStore(HardwareProfile initial = HardwareProfile{});
+
+    // The current published version. Each thread keeps the snapshot it last read and reloads it
+    // only when version() has moved on, so a steady-state read takes no lock of any kind (it does
+    // copy the shared_ptr: hold the result rather than calling this per lookup).
+    HardwareProfileSnapshot snapshot() const;
+    // One atomic load; no lock and no reference counting.
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    // Applies 'mutator(HardwareProfile&)' to the staging copy (created from the latest
+    // published version on first use). Writers are serialized; readers are never blocked.
+    template <typename Mutator>
+    void stage(Mutator&& mutator) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        if (!staging_) {
+            staging_ = std::make_unique<HardwareProfile>(*snapshot());
+        }
+        mutator(*staging_);
+    }
+
+    // Publishes staged changes as a new version. Returns the current version (unchanged if nothing was staged).
+    uint64_t publish();
+
+    // Convenience for one-off writes: stage and publish immediately.
+    template <typename Mutator>
+    uint64_t update(Mutator&& mutator) {
+        stage(std::forward<Mutator>(mutator));
+        return publish();
+    }
+
+    bool has_unpublished_changes() const;
+
+private:
+    const uint64_t id_; // Keys the per-thread snapshot caches; never reused
+    HardwareProfileSnapshot current_; // Accessed only through std::atomic_load/std::atomic_store
+    std::atomic<uint64_t> version_;   // current_->version, stored after current_
+    mutable std::mutex writer_mutex_;
+    std::unique_ptr<HardwareProfile> staging_; // Guarded by writer_mutex_
+};
+
+} // namespace VPU
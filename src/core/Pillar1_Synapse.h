@@ -1,6 +1,6 @@
 #pragma once
 
-#include "api/vpu.h" // For VPU_Task definition
+#include "vpu.h" // For VPU_Task definition
 #include <memory>    // For std::shared_ptr or std::unique_ptr if needed later
 
 // Forward declarations if other pillars are needed for detailed processing
@@ -19,7 +19,8 @@ public:
     // and forwards it for deeper analysis and execution.
     // Returns a status or result code (e.g., 0 for success, error code otherwise).
     // The exact return type can be elaborated later. For now, void or bool.
-    bool submit_task(const VPU_Task& task);
+    // A typed task's legacy fields are filled from its operands here (see describe_task).
+    bool submit_task(VPU_Task& task);
 
 private:
     // Internal state or helper methods if any.
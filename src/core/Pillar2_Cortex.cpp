@@ -2,27 +2,217 @@
 #include <vector>
 #include <cmath>        // For std::sqrt, std::log2, std::abs
 #include <numeric>      // For std::accumulate (if needed elsewhere)
-#include <iostream>     // For std::cerr
 #include <algorithm>    // For std::fill (if needed elsewhere)
 #include <cstdint>      // For uint8_t, uint64_t
+#include <cstring>      // For std::memcpy
+#include <limits>       // For std::numeric_limits
+#include <random>       // For reservoir sampling
 
 // The actual fftw3.h is already included in Pillar2_Cortex.h
 // No need for simulated FFTW functions or typedefs here.
 
 #include "nlohmann/json.hpp" // For JSON parsing (used conceptually for IoT data)
+#include "hal/fft_plan_cache.h" // For cached FFTW plans
+#include "core/SizeModel.h"     // For problem_shape
+#include "core/TaskDescriptor.h" // For resolved_op, input_element_type
+#include "hal/dtype.h"          // For HAL::visit_element_type, HAL::to_double
+#include "runtime/trace.h" // For VPU_LOG_*
 
 namespace VPU { // Changed namespace
 
+namespace {
+
+    // Samples are contiguous runs of elements, so neighbour differences (amplitude flux) stay
+    // meaningful and each run is scanned with the vectorized statistics kernels.
+    constexpr size_t SAMPLE_BLOCK_ELEMENTS = 256;
+
+    bool is_sampling(ProfileSampling sampling) {
+        return sampling == ProfileSampling::STRIDED || sampling == ProfileSampling::RESERVOIR;
+    }
+
+    const char* sampling_name(ProfileSampling sampling) {
+        switch (sampling) {
+            case ProfileSampling::FULL: return "FULL";
+            case ProfileSampling::STRIDED: return "STRIDED";
+            case ProfileSampling::RESERVOIR: return "RESERVOIR";
+            case ProfileSampling::STREAMING: return "STREAMING";
+        }
+        return "UNKNOWN";
+    }
+
+    size_t floor_pow2(size_t n) {
+        size_t p = 1;
+        while (p <= n / 2) p *= 2;
+        return p;
+    }
+
+    // Samples in the spectrum's window: the whole input when profiling in full without a cap,
+    // otherwise the first power-of-two samples within fft_window (or sample_budget).
+    size_t spectral_window_for(size_t num_elements, const ProfilingPolicy& policy, bool partial) {
+        if (!policy.spectral || num_elements < 2) return 0;
+        if (policy.fft_window == 0 && !partial) return num_elements;
+        const size_t cap = policy.fft_window ? policy.fft_window : policy.sample_budget;
+        return num_elements <= cap ? num_elements : floor_pow2(std::max<size_t>(cap, 2));
+    }
+
+    // First element of each sampled block, ascending. Covers every block if the budget allows.
+    std::vector<size_t> sample_block_starts(size_t num_elements, const ProfilingPolicy& policy) {
+        const size_t blocks = (num_elements + SAMPLE_BLOCK_ELEMENTS - 1) / SAMPLE_BLOCK_ELEMENTS;
+        const size_t wanted = std::max<size_t>(1, policy.sample_budget / SAMPLE_BLOCK_ELEMENTS);
+        std::vector<size_t> chosen;
+        if (wanted >= blocks) {
+            chosen.resize(blocks);
+            std::iota(chosen.begin(), chosen.end(), size_t(0));
+        } else if (policy.sampling == ProfileSampling::RESERVOIR) {
+            // Algorithm R over block indices; the fixed seed makes repeated profiles agree.
+            std::mt19937_64 rng(policy.seed);
+            chosen.resize(wanted);
+            std::iota(chosen.begin(), chosen.end(), size_t(0));
+            for (size_t b = wanted; b < blocks; ++b) {
+                const size_t j = std::uniform_int_distribution<size_t>(0, b)(rng);
+                if (j < wanted) chosen[j] = b;
+            }
+            std::sort(chosen.begin(), chosen.end());
+        } else {
+            chosen.reserve(wanted);
+            for (size_t i = 0; i < wanted; ++i) chosen.push_back(i * blocks / wanted);
+        }
+        for (size_t& b : chosen) b *= SAMPLE_BLOCK_ELEMENTS;
+        return chosen;
+    }
+
+    // Frequency flux (spectral centroid) and entropy flux (normalized spectral entropy) of the
+    // first 'num_elements' samples.
+    void compute_spectral_flux(const double* data, int num_elements, OmniProfile& p) {
+        fftw_complex* out_complex = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * (num_elements / 2 + 1));
+        // Cast const away from data for fftw_plan_dft_r2c_1d, this is a common practice with FFTW
+        // if the input array is not modified by the library (which is true for r2c transforms).
+        // Cached plans are created on scratch buffers, so the task's input is never written.
+        fftw_plan plan_r2c = out_complex ? HAL::FFTPlanCache::instance().get_r2c_plan(num_elements, const_cast<double*>(data), out_complex)
+                                         : NULL;
+
+        if (plan_r2c == NULL || out_complex == NULL) {
+            VPU_LOG_WARN("Warning: FFTW3 plan or memory allocation failed in profileOmni internal method.");
+            if (out_complex) fftw_free(out_complex);
+            return; // Leave frequency/entropy flux unset
+        }
+
+        fftw_execute_dft_r2c(plan_r2c, const_cast<double*>(data), out_complex);
+        p.spectral_window = static_cast<size_t>(num_elements);
+
+        // Calculate magnitude spectrum
+        std::vector<double> magnitude_spectrum(num_elements / 2 + 1);
+        double total_magnitude = 0.0;
+        for (size_t i = 0; i < (size_t)(num_elements / 2 + 1); ++i) {
+            magnitude_spectrum[i] = std::sqrt(out_complex[i][0] * out_complex[i][0] + out_complex[i][1] * out_complex[i][1]);
+            total_magnitude += magnitude_spectrum[i];
+        }
+
+        // Calculate Frequency Flux (Spectral Centroid)
+        // Assumes a sampling rate; for simplicity, normalized frequencies 0 to 0.5 (Nyquist)
+        double weighted_sum_freq = 0.0;
+        if (total_magnitude > 1e-9) { // Avoid division by zero
+            for (size_t i = 0; i < magnitude_spectrum.size(); ++i) {
+                // Normalized frequency for bin i: (i / (num_elements/2)) * 0.5 = i / num_elements
+                // For r2c DFT, there are (N/2 + 1) complex outputs.
+                // The frequencies range from 0 up to Nyquist.
+                // If N is the number of real input points, the k-th output bin corresponds to frequency k/N (for k=0,...,N/2).
+                double normalized_freq = static_cast<double>(i) / num_elements;
+                weighted_sum_freq += normalized_freq * magnitude_spectrum[i];
+            }
+            p.frequency_flux = weighted_sum_freq / total_magnitude;
+        } else {
+            p.frequency_flux = 0.0;
+        }
+
+        // Calculate Entropy Flux (Spectral Entropy)
+        double entropy = 0.0;
+        if (total_magnitude > 1e-9) {
+            std::vector<double> normalized_spectrum(magnitude_spectrum.size());
+            for (size_t i = 0; i < magnitude_spectrum.size(); ++i) {
+                normalized_spectrum[i] = magnitude_spectrum[i] / total_magnitude;
+            }
+
+            for (double val : normalized_spectrum) {
+                if (val > 1e-9) { // Avoid log(0)
+                    entropy -= val * std::log2(val);
+                }
+            }
+            // Normalize entropy by log2(number of bins) to get a value between 0 and 1
+            if (magnitude_spectrum.size() > 1) {
+                 p.entropy_flux = entropy / std::log2(static_cast<double>(magnitude_spectrum.size()));
+            } else {
+                 p.entropy_flux = 0.0; // Single bin, entropy is 0
+            }
+
+        } else {
+            p.entropy_flux = 0.0;
+        }
+
+        fftw_free(out_complex);
+    }
+
+    // Adds |next - previous| to the amplitude flux sums unless either value is NaN or infinite.
+    inline void add_difference(double previous, double next, double& sum_abs_diff, size_t& diffs) {
+        const double diff = std::abs(next - previous);
+        if (std::isfinite(diff)) {
+            sum_abs_diff += diff;
+            ++diffs;
+        }
+    }
+
+    // Amplitude flux (mean absolute difference between neighbours, within each sampled block when
+    // sampling) and the spectrum of the first window samples, reading the values as T.
+    template <typename T>
+    OmniProfile profile_values(const T* data, size_t n, const ProfilingPolicy& policy) {
+        OmniProfile p;
+        const bool sampled = is_sampling(policy.sampling);
+        double sum_abs_diff = 0.0;
+        size_t diffs = 0;
+        if (sampled) {
+            for (size_t start : sample_block_starts(n, policy)) {
+                const size_t end = std::min(n, start + SAMPLE_BLOCK_ELEMENTS);
+                for (size_t i = start; i + 1 < end; ++i) {
+                    add_difference(HAL::to_double(data[i]), HAL::to_double(data[i+1]), sum_abs_diff, diffs);
+                }
+                p.profiled_elements += end - start;
+            }
+        } else {
+            for (size_t i = 0; i + 1 < n; ++i) {
+                add_difference(HAL::to_double(data[i]), HAL::to_double(data[i+1]), sum_abs_diff, diffs);
+            }
+            p.profiled_elements = n;
+        }
+        p.amplitude_flux = diffs > 0 ? sum_abs_diff / diffs : 0.0; // 0 for a single element
+
+        // Need at least 2 elements for FFT; a capped window keeps large inputs cheap.
+        const size_t window = spectral_window_for(n, policy, sampled);
+        if (window >= 2) {
+            // FFTW transforms doubles: other types are widened into a copy of the window.
+            std::vector<double> widened;
+            const double* samples = reinterpret_cast<const double*>(data);
+            if (!std::is_same<T, double>::value) {
+                widened.resize(window);
+                for (size_t i = 0; i < window; ++i) widened[i] = HAL::to_double(data[i]);
+                samples = widened.data();
+            }
+            compute_spectral_flux(samples, static_cast<int>(window), p);
+        }
+        return p;
+    }
+
+} // namespace
+
     Cortex::Cortex() { // Renamed class
         // Initialize IoTClient with placeholder values
         try {
             iot_client_ = std::make_unique<IoTClient>("localhost", 12345);
-            std::cout << "[Pillar 2] Cortex: IoTClient initialized conceptually for localhost:12345." << std::endl;
+            VPU_LOG_INFO("[Pillar 2] Cortex: IoTClient initialized conceptually for localhost:12345.");
         } catch (const std::exception& e) {
-            std::cerr << "[Pillar 2] Cortex: Failed to initialize IoTClient: " << e.what() << std::endl;
+            VPU_LOG_WARN("[Pillar 2] Cortex: Failed to initialize IoTClient: " << e.what());
             iot_client_ = nullptr; // Ensure it's null if construction fails
         }
-        std::cout << "[Pillar 2] Cortex initialized." << std::endl;
+        VPU_LOG_INFO("[Pillar 2] Cortex initialized.");
     }
 
     Cortex::~Cortex() { // Renamed class
@@ -30,252 +220,326 @@ namespace VPU { // Changed namespace
     }
 
     void Cortex::set_next_iot_profile_override(const DataProfile& override_profile) {
+        std::lock_guard<std::mutex> lock(iot_override_mutex_);
         next_iot_override_ = std::make_unique<DataProfile>(override_profile);
-        std::cout << "[Pillar 2] Cortex: Test override for IoT data set for next analyze call." << std::endl;
+        VPU_LOG_INFO("[Pillar 2] Cortex: Test override for IoT data set for next analyze call.");
+    }
+
+    void Cortex::set_telemetry_poller(std::shared_ptr<TelemetryPoller> poller, std::chrono::milliseconds max_age) {
+        std::shared_ptr<const TelemetryBinding> binding;
+        if (poller) {
+            binding = std::make_shared<const TelemetryBinding>(TelemetryBinding{std::move(poller), max_age});
+        }
+        std::atomic_store(&telemetry_, binding);
+        VPU_LOG_INFO("[Pillar 2] Cortex: IoT telemetry " << (binding ? "poller attached." : "poller detached; using nominal readings."));
+    }
+
+    uint64_t Cortex::telemetry_generation() const {
+        std::shared_ptr<const TelemetryBinding> telemetry = std::atomic_load(&telemetry_);
+        return telemetry ? telemetry->poller->snapshot()->polls + 1 : 0;
+    }
+
+    bool Cortex::has_pending_iot_override() const {
+        std::lock_guard<std::mutex> lock(iot_override_mutex_);
+        return next_iot_override_ != nullptr;
     }
 
     // Public method to analyze task data
-    EnrichedExecutionContext Cortex::analyze(const VPU_Task& task) {
-        std::cout << "[Pillar 2] Cortex: Analyzing task '" << task.task_type << "'..." << std::endl;
-
-        OmniProfile omni_profile;
-        if (task.data_in_a && task.num_elements > 0) {
-            // Assuming task.data_in_a is const double* and task.num_elements is int for profileOmni.
-            // This cast is potentially unsafe if task.data_in_a is not actually pointing to doubles.
-            // A real system would need robust type checking or a safer way to pass data.
-            const double* data_ptr = static_cast<const double*>(task.data_in_a);
-            omni_profile = profileOmni(data_ptr, static_cast<int>(task.num_elements));
-        } else {
-            std::cerr << "Warning: Cortex::analyze called with null data or zero elements for profiling." << std::endl;
-            // omni_profile will be default (all zeros)
+    EnrichedExecutionContext Cortex::analyze(const VPU_Task& task, const ProfilingPolicy& policy) {
+        VPU_LOG_DEBUG("[Pillar 2] Cortex: Analyzing task '" << task_label(task) << "'...");
+
+        // Values are read as the task's element type: its operands' dtype, or its op's default
+        // (doubles for spectral/convolution tasks, floats for the BLAS-style kernels).
+        const TaskOp op = resolved_op(task);
+        const HAL::ElementType element_type = input_element_type(task);
+        const size_t element_bytes = HAL::element_size(element_type);
+
+        size_t profile_elements = task.data_in_a ? task.num_elements : 0;
+        // Never read past the caller's buffer when its size is known.
+        if (task.data_in_a_size_bytes > 0) {
+            profile_elements = std::min(profile_elements, task.data_in_a_size_bytes / element_bytes);
+        }
+
+        // Small inputs are cheap to profile exactly, whatever the policy.
+        ProfileSampling sampling = policy.sampling;
+        if (profile_elements <= policy.exact_below_elements ||
+            (sampling == ProfileSampling::STREAMING && task.data_in_a_size_bytes == 0)) {
+            sampling = ProfileSampling::FULL;
         }
 
         auto data_profile_ptr = std::make_shared<DataProfile>();
-        data_profile_ptr->amplitude_flux = omni_profile.amplitude_flux;
-        data_profile_ptr->frequency_flux = omni_profile.frequency_flux;
-        data_profile_ptr->entropy_flux = omni_profile.entropy_flux;
-
-        std::cout << "  -> OmniProfile generated: AF=" << data_profile_ptr->amplitude_flux
-                  << ", FF=" << data_profile_ptr->frequency_flux
-                  << ", EF=" << data_profile_ptr->entropy_flux << std::endl;
-
-        // Calculate Hamming Weight profile
-        if (task.data_in_a && task.data_in_a_size_bytes > 0) { // Use data_in_a_size_bytes
-            const void* hw_data_ptr = task.data_in_a;
-            size_t hw_num_bytes = task.data_in_a_size_bytes;
-            Cortex::calculate_hamming_weight_for_profile(hw_data_ptr, hw_num_bytes, *data_profile_ptr);
-
-            std::cout << "  -> HW Profile generated (from data_in_a): HW=" << data_profile_ptr->hamming_weight
-                      << ", Sparsity=" << data_profile_ptr->sparsity_ratio << std::endl;
+        if (sampling == ProfileSampling::STREAMING) {
+            // One pass over the input in fixed-size chunks covers both the omnimorphic and bit profiles.
+            StreamingProfiler profiler(policy, element_type);
+            const uint8_t* bytes = static_cast<const uint8_t*>(task.data_in_a);
+            const size_t chunk_bytes = std::max<size_t>(1, policy.stream_chunk_elements) * element_bytes;
+            for (size_t offset = 0; offset < task.data_in_a_size_bytes; offset += chunk_bytes) {
+                profiler.update(bytes + offset, std::min(chunk_bytes, task.data_in_a_size_bytes - offset));
+            }
+            *data_profile_ptr = profiler.profile();
+            VPU_LOG_DEBUG("  -> OmniProfile generated (STREAMING): AF=" << data_profile_ptr->amplitude_flux
+                      << ", FF=" << data_profile_ptr->frequency_flux
+                      << ", EF=" << data_profile_ptr->entropy_flux);
+            VPU_LOG_DEBUG("  -> HW Profile generated (STREAMING): HW=" << data_profile_ptr->hamming_weight
+                      << ", Sparsity=" << data_profile_ptr->sparsity_ratio);
         } else {
-            // Set default Hamming weight and sparsity (already done by DataProfile constructor, but explicit for clarity)
-            data_profile_ptr->hamming_weight = 0;
-            data_profile_ptr->sparsity_ratio = 1.0;
-            std::cout << "  -> HW Profile not generated due to null data or zero elements (defaults set)." << std::endl;
+            OmniProfile omni_profile;
+            if (profile_elements > 0) {
+                ProfilingPolicy effective = policy;
+                effective.sampling = sampling;
+                omni_profile = profileOmni(task.data_in_a, element_type, profile_elements, effective);
+            } else {
+                VPU_LOG_WARN("Warning: Cortex::analyze called with null data or zero elements for profiling.");
+                // omni_profile will be default (all zeros)
+            }
+
+            data_profile_ptr->amplitude_flux = omni_profile.amplitude_flux;
+            data_profile_ptr->frequency_flux = omni_profile.frequency_flux;
+            data_profile_ptr->entropy_flux = omni_profile.entropy_flux;
+            data_profile_ptr->sampling = sampling;
+            data_profile_ptr->profiled_elements = omni_profile.profiled_elements;
+            data_profile_ptr->spectral_window = omni_profile.spectral_window;
+
+            VPU_LOG_DEBUG("  -> OmniProfile generated (" << sampling_name(sampling) << ", " << omni_profile.profiled_elements
+                      << " of " << profile_elements << " elements): AF=" << data_profile_ptr->amplitude_flux
+                      << ", FF=" << data_profile_ptr->frequency_flux
+                      << ", EF=" << data_profile_ptr->entropy_flux);
+
+            // Calculate Hamming Weight profile
+            if (task.data_in_a && task.data_in_a_size_bytes > 0) { // Use data_in_a_size_bytes
+                const void* hw_data_ptr = task.data_in_a;
+                size_t hw_num_bytes = task.data_in_a_size_bytes;
+                if (is_sampling(sampling)) {
+                    Cortex::calculate_hamming_weight_sampled(hw_data_ptr, hw_num_bytes, *data_profile_ptr, element_type, policy);
+                } else {
+                    Cortex::calculate_hamming_weight_for_profile(hw_data_ptr, hw_num_bytes, *data_profile_ptr, element_type);
+                }
+
+                VPU_LOG_DEBUG("  -> HW Profile generated (from data_in_a): HW=" << data_profile_ptr->hamming_weight
+                          << ", Sparsity=" << data_profile_ptr->sparsity_ratio
+                          << ", Zeros=" << data_profile_ptr->input_stats.zero_elements << "/" << data_profile_ptr->input_stats.elements
+                          << ", Range=[" << data_profile_ptr->input_stats.min_value << ", " << data_profile_ptr->input_stats.max_value << "]");
+            } else if (!task.sparse_a.empty() && task.sparse_a.rows > 0 && task.sparse_a.cols > 0) {
+                // Pre-encoded CSR input: only the non-zeros carry set bits, so the Hamming weight of the
+                // values equals that of the dense matrix; sparsity is measured against the dense size.
+                Cortex::calculate_hamming_weight_for_profile(task.sparse_a.values, task.sparse_a.nnz() * sizeof(float), *data_profile_ptr,
+                                                             HAL::ElementType::FLOAT32);
+                const double dense_bits = static_cast<double>(task.sparse_a.rows) * task.sparse_a.cols * sizeof(float) * 8;
+                data_profile_ptr->sparsity_ratio = 1.0 - static_cast<double>(data_profile_ptr->hamming_weight) / dense_bits;
+                VPU_LOG_DEBUG("  -> HW Profile generated (from pre-encoded CSR, nnz=" << task.sparse_a.nnz() << "): HW="
+                          << data_profile_ptr->hamming_weight << ", Sparsity=" << data_profile_ptr->sparsity_ratio);
+            } else {
+                // Set default Hamming weight and sparsity (already done by DataProfile constructor, but explicit for clarity)
+                data_profile_ptr->hamming_weight = 0;
+                data_profile_ptr->sparsity_ratio = 1.0;
+                VPU_LOG_DEBUG("  -> HW Profile not generated due to null data or zero elements (defaults set).");
+            }
         }
 
         // --- Populate DataProfile with IoT Sensor Data (Conceptual/Dummy) ---
-        if (next_iot_override_) {
-            std::cout << "  -> Using TEST OVERRIDE for IoT data." << std::endl;
-            data_profile_ptr->power_draw_watts = next_iot_override_->power_draw_watts;
-            data_profile_ptr->temperature_celsius = next_iot_override_->temperature_celsius;
-            data_profile_ptr->network_latency_ms = next_iot_override_->network_latency_ms;
-            data_profile_ptr->network_bandwidth_mbps = next_iot_override_->network_bandwidth_mbps;
-            data_profile_ptr->io_throughput_mbps = next_iot_override_->io_throughput_mbps;
-            data_profile_ptr->data_quality_score = next_iot_override_->data_quality_score;
-            next_iot_override_.reset(); // Clear override after use
+        std::unique_ptr<DataProfile> iot_override;
+        {
+            std::lock_guard<std::mutex> lock(iot_override_mutex_);
+            iot_override = std::move(next_iot_override_); // Clear override after use
+        }
+        if (iot_override) {
+            VPU_LOG_DEBUG("  -> Using TEST OVERRIDE for IoT data.");
+            data_profile_ptr->power_draw_watts = iot_override->power_draw_watts;
+            data_profile_ptr->temperature_celsius = iot_override->temperature_celsius;
+            data_profile_ptr->network_latency_ms = iot_override->network_latency_ms;
+            data_profile_ptr->network_bandwidth_mbps = iot_override->network_bandwidth_mbps;
+            data_profile_ptr->io_throughput_mbps = iot_override->io_throughput_mbps;
+            data_profile_ptr->data_quality_score = iot_override->data_quality_score;
+        } else if (std::shared_ptr<const TelemetryBinding> telemetry = std::atomic_load(&telemetry_)) {
+            // Latest background poll; no request on the task's path.
+            telemetry->poller->apply(*data_profile_ptr, telemetry->max_age);
+            VPU_LOG_DEBUG("  -> IoT Data (telemetry, poll " << telemetry->poller->snapshot()->polls << "): Power="
+                          << data_profile_ptr->power_draw_watts << "W, Temp=" << data_profile_ptr->temperature_celsius << "C"
+                          << ", DataQuality=" << data_profile_ptr->data_quality_score);
         } else if (iot_client_) {
-            std::cout << "  -> Fetching IoT data (conceptually)..." << std::endl;
-            try {
-                // Conceptual calls (commented out to avoid runtime errors without actual IoT server)
-                // nlohmann::json power_data = iot_client_->getDeviceStatus("power_sensor_001");
-                // nlohmann::json thermal_data = iot_client_->getDeviceStatus("thermal_sensor_001");
-                // nlohmann::json network_data = iot_client_->getDeviceStatus("network_monitor_001");
-                // nlohmann::json storage_data = iot_client_->getDeviceStatus("storage_monitor_001");
-                // nlohmann::json quality_data = iot_client_->getDeviceStatus("data_quality_sensor_001");
-
-                // Using dummy data for now
-                data_profile_ptr->power_draw_watts = 75.5; // Example value
-                // if (!power_data.empty() && power_data.contains("current_watts")) {
-                //     data_profile_ptr->power_draw_watts = power_data["current_watts"].get<double>();
-                // }
-
-                data_profile_ptr->temperature_celsius = 65.2; // Example value
-                // if (!thermal_data.empty() && thermal_data.contains("current_temp_c")) {
-                //     data_profile_ptr->temperature_celsius = thermal_data["current_temp_c"].get<double>();
-                // }
-
-                data_profile_ptr->network_latency_ms = 15.3; // Example value
-                // if (!network_data.empty() && network_data.contains("latency_ms")) {
-                //     data_profile_ptr->network_latency_ms = network_data["latency_ms"].get<double>();
-                // }
-
-                data_profile_ptr->network_bandwidth_mbps = 980.0; // Example value
-                // if (!network_data.empty() && network_data.contains("bandwidth_mbps")) {
-                //     data_profile_ptr->network_bandwidth_mbps = network_data["bandwidth_mbps"].get<double>();
-                // }
-
-                data_profile_ptr->io_throughput_mbps = 250.0; // Example value
-                // if(!storage_data.empty() && storage_data.contains("throughput_mbps")) {
-                //    data_profile_ptr->io_throughput_mbps = storage_data["throughput_mbps"].get<double>();
-                // }
-
-                data_profile_ptr->data_quality_score = 0.95; // Example value
-                // if(!quality_data.empty() && quality_data.contains("score")) {
-                //    data_profile_ptr->data_quality_score = quality_data["score"].get<double>();
-                // }
-
-                std::cout << "  -> IoT Data (Dummy): Power=" << data_profile_ptr->power_draw_watts << "W"
+            // No telemetry poller: every sensor reads its nominal value.
+            data_profile_ptr->power_draw_watts = TelemetryPoller::nominal_value(TelemetrySnapshot::POWER);
+            data_profile_ptr->temperature_celsius = TelemetryPoller::nominal_value(TelemetrySnapshot::TEMPERATURE);
+            data_profile_ptr->network_latency_ms = TelemetryPoller::nominal_value(TelemetrySnapshot::NET_LATENCY);
+            data_profile_ptr->network_bandwidth_mbps = TelemetryPoller::nominal_value(TelemetrySnapshot::NET_BANDWIDTH);
+            data_profile_ptr->io_throughput_mbps = TelemetryPoller::nominal_value(TelemetrySnapshot::IO_THROUGHPUT);
+            data_profile_ptr->data_quality_score = TelemetryPoller::nominal_value(TelemetrySnapshot::DATA_QUALITY);
+            VPU_LOG_DEBUG("  -> IoT Data (Dummy): Power=" << data_profile_ptr->power_draw_watts << "W"
                           << ", Temp=" << data_profile_ptr->temperature_celsius << "C"
                           << ", NetLatency=" << data_profile_ptr->network_latency_ms << "ms"
                           << ", NetBw=" << data_profile_ptr->network_bandwidth_mbps << "Mbps"
                           << ", IoThroughput=" << data_profile_ptr->io_throughput_mbps << "Mbps"
-                          << ", DataQuality=" << data_profile_ptr->data_quality_score << std::endl;
-
-            } catch (const std::exception& e) {
-                std::cerr << "  -> Error fetching/processing IoT data: " << e.what() << std::endl;
-                // Keep default values in DataProfile if IoT fetch fails
-            }
+                          << ", DataQuality=" << data_profile_ptr->data_quality_score);
         } else {
-            std::cout << "  -> IoTClient not available, skipping IoT data fetch." << std::endl;
+            VPU_LOG_DEBUG("  -> IoTClient not available, skipping IoT data fetch.");
         }
         // --- End of IoT Sensor Data Population ---
 
-        return {data_profile_ptr, task.task_type};
+        EnrichedExecutionContext context;
+        context.profile = data_profile_ptr;
+        context.task_type = task_label(task);
+        context.sparse_a_pre_encoded = !task.sparse_a.empty();
+        context.shape = problem_shape(task); // Pillar 3 prices the work, not just the data's character
+        context.op = op;
+        context.element_type = element_type;
+        context.accuracy_bound = task.accuracy_bound;
+        return context;
     }
 
     // Definition for the static helper function to calculate Hamming Weight and Sparsity
-    void Cortex::calculate_hamming_weight_for_profile(const void* data, size_t num_bytes, DataProfile& profile)
+    void Cortex::calculate_hamming_weight_for_profile(const void* data, size_t num_bytes, DataProfile& profile,
+                                                      HAL::ElementType type)
     {
         if (!data || num_bytes == 0) {
+            profile.input_stats = HAL::BufferStats();
             profile.hamming_weight = 0;
             profile.sparsity_ratio = 1.0; // No bits set means fully sparse
             return;
         }
 
-        uint64_t total_hw = 0;
-        const uint8_t* byte_data = static_cast<const uint8_t*>(data);
-
-        for (size_t i = 0; i < num_bytes; ++i) {
-        #if defined(__GNUC__) || defined(__clang__)
-            total_hw += __builtin_popcount(byte_data[i]);
-        #elif defined(_MSC_VER)
-            // __popcnt intrinsic in MSVC typically takes unsigned int.
-            // For a single byte, we can cast or use a small loop.
-            unsigned char byte = byte_data[i];
-            total_hw += __popcnt(static_cast<unsigned int>(byte)); // Cast byte to unsigned int
-        #else
-            // Fallback for other compilers
-            unsigned char byte = byte_data[i];
-            for(int bit = 0; bit < 8; ++bit) {
-                if((byte >> bit) & 1) total_hw++;
-            }
-        #endif
-        }
+        // One fused pass: popcount for the flux model, plus zero count and min/max of the values.
+        profile.input_stats = HAL::compute_buffer_stats(data, num_bytes, type);
+        const uint64_t total_hw = profile.input_stats.hamming_weight;
         profile.hamming_weight = total_hw;
 
         uint64_t total_bits = num_bytes * 8;
         profile.sparsity_ratio = (total_bits > 0) ? (1.0 - (static_cast<double>(total_hw) / total_bits)) : 1.0;
     }
 
-    // Private method for actual profiling logic
-    OmniProfile Cortex::profileOmni(const double* data, int num_elements) { // Renamed class
-        OmniProfile p;
-
-        // Basic check for data presence and minimum elements for amplitude flux
-        if (!data || num_elements == 0) {
-            std::cerr << "Warning: Null data or zero elements provided to profileOmni internal method." << std::endl;
-            return p; // Return default profile
+    void Cortex::calculate_hamming_weight_sampled(const void* data, size_t num_bytes, DataProfile& profile,
+                                                  HAL::ElementType type, const ProfilingPolicy& policy)
+    {
+        const size_t elem = HAL::element_size(type);
+        const size_t elements = num_bytes / elem;
+        if (!data || elements == 0) {
+            Cortex::calculate_hamming_weight_for_profile(data, num_bytes, profile, type);
+            return;
         }
 
-        // --- Amplitude Flux Calculation (Example) ---
-        // This is a placeholder; actual calculation might be more complex.
-        double sum_abs_diff = 0.0;
-        if (num_elements > 1) {
-            for (int i = 0; i < num_elements - 1; ++i) {
-                sum_abs_diff += std::abs(data[i+1] - data[i]);
-            }
-            p.amplitude_flux = sum_abs_diff / (num_elements - 1);
-        } else {
-            p.amplitude_flux = 0.0; // Or handle as appropriate for a single element
+        // Gather the sampled blocks so the vectorized scan runs once over a contiguous buffer.
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        std::vector<uint8_t> sample;
+        sample.reserve(std::min(elements, policy.sample_budget + SAMPLE_BLOCK_ELEMENTS) * elem);
+        for (size_t start : sample_block_starts(elements, policy)) {
+            const size_t count = std::min(SAMPLE_BLOCK_ELEMENTS, elements - start);
+            sample.insert(sample.end(), bytes + start * elem, bytes + (start + count) * elem);
         }
+        const HAL::BufferStats sampled = HAL::compute_buffer_stats(sample.data(), sample.size(), type);
+
+        // Scale to the whole buffer. data stays null: these are estimates, so kernels must not
+        // reuse them in place of their own exact scans.
+        HAL::BufferStats stats;
+        stats.bytes = num_bytes;
+        stats.type = type;
+        stats.elements = elements;
+        const double byte_scale = static_cast<double>(num_bytes) / sample.size();
+        const double element_scale = static_cast<double>(elements) / sampled.elements;
+        stats.hamming_weight = static_cast<uint64_t>(std::llround(sampled.hamming_weight * byte_scale));
+        stats.zero_elements = static_cast<uint64_t>(std::llround(sampled.zero_elements * element_scale));
+        stats.min_value = sampled.min_value; // Of the sample only
+        stats.max_value = sampled.max_value;
+
+        profile.input_stats = stats;
+        profile.hamming_weight = stats.hamming_weight;
+        profile.sparsity_ratio = 1.0 - static_cast<double>(sampled.hamming_weight) / (sample.size() * 8.0);
+    }
 
-        // --- Frequency Flux & Entropy Flux Calculation ---
-        if (num_elements >= 2) { // Need at least 2 elements for FFT
-            fftw_complex* out_complex = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * (num_elements / 2 + 1));
-            // Cast const away from data for fftw_plan_dft_r2c_1d, this is a common practice with FFTW
-            // if the input array is not modified by the library (which is true for r2c transforms).
-            fftw_plan plan_r2c = fftw_plan_dft_r2c_1d(num_elements, const_cast<double*>(data), out_complex, FFTW_ESTIMATE);
-
-            if (plan_r2c == NULL || out_complex == NULL) {
-                std::cerr << "Warning: FFTW3 plan or memory allocation failed in profileOmni internal method." << std::endl;
-                if (out_complex) fftw_free(out_complex);
-                // According to FFTW docs, it's safe to call fftw_destroy_plan(NULL)
-                fftw_destroy_plan(plan_r2c);
-                return p; // Return profile without frequency/entropy flux
-            }
+    // Private method for actual profiling logic
+    OmniProfile Cortex::profileOmni(const void* data, HAL::ElementType type, size_t num_elements, const ProfilingPolicy& policy) {
+        // Basic check for data presence and minimum elements for amplitude flux
+        if (!data || num_elements == 0) {
+            VPU_LOG_WARN("Warning: Null data or zero elements provided to profileOmni internal method.");
+            return OmniProfile(); // Return default profile
+        }
+        return HAL::visit_element_type(type, [&](auto tag) {
+            using T = decltype(tag);
+            return profile_values(static_cast<const T*>(data), num_elements, policy);
+        });
+    }
 
-            fftw_execute(plan_r2c);
+    StreamingProfiler::StreamingProfiler(const ProfilingPolicy& policy, HAL::ElementType type)
+        : policy_(policy), type_(type),
+          window_capacity_(spectral_window_for(std::numeric_limits<size_t>::max(), policy, /*partial=*/true)),
+          element_bytes_(HAL::element_size(type)) {
+        stats_.type = type;
+        window_.reserve(window_capacity_);
+    }
 
-            // Calculate magnitude spectrum
-            std::vector<double> magnitude_spectrum(num_elements / 2 + 1);
-            double total_magnitude = 0.0;
-            for (size_t i = 0; i < (size_t)(num_elements / 2 + 1); ++i) {
-                magnitude_spectrum[i] = std::sqrt(out_complex[i][0] * out_complex[i][0] + out_complex[i][1] * out_complex[i][1]);
-                total_magnitude += magnitude_spectrum[i];
-            }
+    void StreamingProfiler::update(const void* chunk, size_t bytes) {
+        if (!chunk || bytes == 0) return;
+        const uint8_t* p = static_cast<const uint8_t*>(chunk);
+        bytes_seen_ += bytes;
+        if (!carry_.empty()) { // Complete the value split across the previous chunk boundary
+            const size_t take = std::min(bytes, element_bytes_ - carry_.size());
+            carry_.insert(carry_.end(), p, p + take);
+            p += take;
+            bytes -= take;
+            if (carry_.size() < element_bytes_) return;
+            fold(carry_.data(), carry_.size());
+            carry_.clear();
+        }
+        const size_t whole = bytes - bytes % element_bytes_;
+        fold(p, whole);
+        carry_.assign(p + whole, p + bytes);
+    }
 
-            // Calculate Frequency Flux (Spectral Centroid)
-            // Assumes a sampling rate; for simplicity, normalized frequencies 0 to 0.5 (Nyquist)
-            double weighted_sum_freq = 0.0;
-            if (total_magnitude > 1e-9) { // Avoid division by zero
-                for (size_t i = 0; i < magnitude_spectrum.size(); ++i) {
-                    // Normalized frequency for bin i: (i / (num_elements/2)) * 0.5 = i / num_elements
-                    // For r2c DFT, there are (N/2 + 1) complex outputs.
-                    // The frequencies range from 0 up to Nyquist.
-                    // If N is the number of real input points, the k-th output bin corresponds to frequency k/N (for k=0,...,N/2).
-                    double normalized_freq = static_cast<double>(i) / num_elements;
-                    weighted_sum_freq += normalized_freq * magnitude_spectrum[i];
-                }
-                p.frequency_flux = weighted_sum_freq / total_magnitude;
-            } else {
-                p.frequency_flux = 0.0;
-            }
+    void StreamingProfiler::fold(const uint8_t* data, size_t bytes) {
+        if (bytes == 0) return;
+        const HAL::BufferStats chunk = HAL::compute_buffer_stats(data, bytes, type_);
+        stats_.hamming_weight += chunk.hamming_weight;
+        stats_.elements += chunk.elements;
+        stats_.zero_elements += chunk.zero_elements;
+        stats_.min_value = has_range_ ? std::min(stats_.min_value, chunk.min_value) : chunk.min_value;
+        stats_.max_value = has_range_ ? std::max(stats_.max_value, chunk.max_value) : chunk.max_value;
+        has_range_ = true;
+
+        HAL::visit_element_type(type_, [&](auto tag) { fold_values<decltype(tag)>(data, bytes / sizeof(tag)); });
+    }
 
-            // Calculate Entropy Flux (Spectral Entropy)
-            double entropy = 0.0;
-            if (total_magnitude > 1e-9) {
-                std::vector<double> normalized_spectrum(magnitude_spectrum.size());
-                for (size_t i = 0; i < magnitude_spectrum.size(); ++i) {
-                    normalized_spectrum[i] = magnitude_spectrum[i] / total_magnitude;
-                }
+    template <typename T>
+    void StreamingProfiler::fold_values(const uint8_t* data, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            T element;
+            std::memcpy(&element, data + i * sizeof(T), sizeof(T));
+            const double v = HAL::to_double(element);
+            if (values_ > 0) add_difference(last_value_, v, sum_abs_diff_, diffs_);
+            last_value_ = v;
+            ++values_;
+            if (window_.size() < window_capacity_) window_.push_back(v);
+        }
+    }
 
-                for (double val : normalized_spectrum) {
-                    if (val > 1e-9) { // Avoid log(0)
-                        entropy -= val * std::log2(val);
-                    }
-                }
-                // Normalize entropy by log2(number of bins) to get a value between 0 and 1
-                if (magnitude_spectrum.size() > 1) {
-                     p.entropy_flux = entropy / std::log2(static_cast<double>(magnitude_spectrum.size()));
-                } else {
-                     p.entropy_flux = 0.0; // Single bin, entropy is 0
-                }
+    DataProfile StreamingProfiler::profile() const {
+        DataProfile profile;
+        profile.sampling = ProfileSampling::STREAMING;
+        profile.profiled_elements = values_;
+        profile.amplitude_flux = diffs_ > 0 ? sum_abs_diff_ / diffs_ : 0.0;
+
+        if (policy_.spectral && window_.size() >= 2) {
+            OmniProfile spectral;
+            compute_spectral_flux(window_.data(), static_cast<int>(window_.size()), spectral);
+            profile.frequency_flux = spectral.frequency_flux;
+            profile.entropy_flux = spectral.entropy_flux;
+            profile.spectral_window = spectral.spectral_window;
+        }
 
-            } else {
-                p.entropy_flux = 0.0;
+        // Bytes of a trailing partial element still count towards the bit statistics.
+        HAL::BufferStats stats = stats_;
+        if (!carry_.empty()) {
+            const HAL::BufferStats tail = HAL::compute_buffer_stats(carry_.data(), carry_.size(), type_);
+            stats.hamming_weight += tail.hamming_weight;
+            stats.elements += tail.elements;
+            stats.zero_elements += tail.zero_elements;
+            if (tail.elements > 0) {
+                stats.min_value = has_range_ ? std::min(stats.min_value, tail.min_value) : tail.min_value;
+                stats.max_value = has_range_ ? std::max(stats.max_value, tail.max_value) : tail.max_value;
             }
-
-            fftw_destroy_plan(plan_r2c);
-            fftw_free(out_complex);
-        } else {
-            // Handle cases with less than 2 elements if FFT cannot be performed
-            p.frequency_flux = 0.0;
-            p.entropy_flux = 0.0;
         }
-        // --- End of Frequency Flux & Entropy Flux Calculation ---
-
-        return p;
+        stats.bytes = bytes_seen_;
+        profile.input_stats = stats;
+        profile.hamming_weight = stats.hamming_weight;
+        profile.sparsity_ratio = bytes_seen_ > 0 ? 1.0 - static_cast<double>(stats.hamming_weight) / (bytes_seen_ * 8.0) : 1.0;
+        return profile;
     }
 
 } // namespace VPU
@@ -10,7 +10,9 @@
 #include "vpu_data_structures.h" // For EnrichedExecutionContext, DataProfile
 #include "vpu.h"                 // For VPU_Task (Corrected from "api/vpu.h")
 #include <memory>                // For std::make_shared
+#include <mutex>                 // For std::mutex
 #include "IoTClient.h"           // For IoTClient integration
+#include "core/TelemetryPoller.h" // For background IoT sensor readings
 
 namespace VPU { // Changed namespace to VPU
 
@@ -21,6 +23,42 @@ namespace VPU { // Changed namespace to VPU
         double entropy_flux = 0.0;
         double temporal_coherence = 0.0;
         // Add other relevant metrics as needed
+        size_t profiled_elements = 0; // Elements the amplitude flux was computed over
+        size_t spectral_window = 0;   // Samples the spectrum was computed over (0 if skipped)
+    };
+
+    // Builds a DataProfile from input that arrives (or is read) in chunks, in one pass with a
+    // bounded working set. Amplitude flux and bit statistics cover every byte; the spectrum covers
+    // the first policy-window samples. Values are read as 'type', like Cortex::analyze reads a
+    // task's input. IoT fields are left at defaults.
+    class StreamingProfiler {
+    public:
+        explicit StreamingProfiler(const ProfilingPolicy& policy = ProfilingPolicy(),
+                                   HAL::ElementType type = HAL::ElementType::FLOAT64);
+
+        // Folds in the next chunk; chunks need not be element-aligned.
+        void update(const void* chunk, size_t bytes);
+        // The profile of everything folded in so far.
+        DataProfile profile() const;
+        size_t bytes_seen() const { return bytes_seen_; }
+
+    private:
+        void fold(const uint8_t* data, size_t bytes); // 'bytes' is a multiple of the element size
+        template <typename T> void fold_values(const uint8_t* data, size_t count);
+
+        ProfilingPolicy policy_;
+        HAL::ElementType type_;
+        size_t window_capacity_ = 0;
+        std::vector<double> window_;  // First samples, for the spectrum
+        size_t element_bytes_;
+        std::vector<uint8_t> carry_;  // Bytes of an element split across chunks
+        HAL::BufferStats stats_;      // Merged bit statistics (data is null: there is no single buffer)
+        bool has_range_ = false;
+        double sum_abs_diff_ = 0.0;
+        size_t diffs_ = 0; // Finite neighbour differences in sum_abs_diff_
+        size_t values_ = 0;
+        double last_value_ = 0.0;
+        size_t bytes_seen_ = 0;
     };
 
     class Cortex { // Renamed class to Cortex
@@ -28,24 +66,45 @@ namespace VPU { // Changed namespace to VPU
         Cortex();
         ~Cortex();
 
-        // Analyzes the data from VPU_Task and returns EnrichedExecutionContext
-        EnrichedExecutionContext analyze(const VPU_Task& task);
+        // Analyzes the data from VPU_Task and returns EnrichedExecutionContext.
+        // 'policy' trades profile fidelity for profiling cost (exact full-input profile by default).
+        EnrichedExecutionContext analyze(const VPU_Task& task, const ProfilingPolicy& policy = ProfilingPolicy());
 
         // Test helper to override IoT data for the next analyze call
         void set_next_iot_profile_override(const DataProfile& override_profile);
+        bool has_pending_iot_override() const; // A cached profile would skip the override
+
+        // Profiles take their IoT fields from 'poller' (nullptr: nominal readings). Readings older
+        // than 'max_age' count as missing. Safe to call while other threads analyze.
+        void set_telemetry_poller(std::shared_ptr<TelemetryPoller> poller,
+                                  std::chrono::milliseconds max_age = std::chrono::seconds(5));
+        // Changes with every telemetry poll (0 without a poller); profiles cached across a change are outdated.
+        uint64_t telemetry_generation() const;
 
     private:
-        // Profiles the omnimorphic characteristics of a given data stream
-        OmniProfile profileOmni(const double* data, int num_elements);
+        // Profiles the omnimorphic characteristics of 'num_elements' values of 'type' at 'data'
+        OmniProfile profileOmni(const void* data, HAL::ElementType type, size_t num_elements,
+                                const ProfilingPolicy& policy = ProfilingPolicy());
 
         // Calculates Hamming Weight and Sparsity for a given data buffer
-        static void calculate_hamming_weight_for_profile(const void* data, size_t num_bytes, DataProfile& profile);
+        static void calculate_hamming_weight_for_profile(const void* data, size_t num_bytes, DataProfile& profile,
+                                                         HAL::ElementType type = HAL::ElementType::BYTES);
+        // As above, from evenly spaced or random blocks of elements; counts are scaled to the whole buffer.
+        static void calculate_hamming_weight_sampled(const void* data, size_t num_bytes, DataProfile& profile,
+                                                     HAL::ElementType type, const ProfilingPolicy& policy);
 
         // IoT Client for fetching external sensor data
         std::unique_ptr<IoTClient> iot_client_;
 
         // Member to store the override profile
         std::unique_ptr<DataProfile> next_iot_override_;
+        mutable std::mutex iot_override_mutex_; // analyze() may run concurrently on worker threads
+
+        struct TelemetryBinding {
+            std::shared_ptr<TelemetryPoller> poller;
+            std::chrono::milliseconds max_age;
+        };
+        std::shared_ptr<const TelemetryBinding> telemetry_; // Accessed only through std::atomic_load/std::atomic_store
         // Helper methods, if any, can be declared here.
     };
 
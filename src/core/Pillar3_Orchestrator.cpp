@@ -1,43 +1,285 @@
 #include "core/Pillar3_Orchestrator.h"
+#include "core/FusionLibrary.h" // For fused-step plan variants
+#include "core/SizeModel.h"     // For work_units
+#include "core/TaskDescriptor.h" // For task_op_from_name, default_element_type
+#include "hal/cpu_features.h"
+#include "hal/quantize.h"     // For quantization_error, quantization_fits
+#include "runtime/trace.h" // For VPU_LOG_*
 #include <algorithm>
+#include <array>
+#include <cmath> // For std::fabs
 #include <stdexcept>
-#include <iostream>
 
 namespace VPU {
 
-Orchestrator::Orchestrator(std::shared_ptr<HardwareProfile> hw_profile) : hw_profile_(hw_profile), use_llm_for_paths_(false) {
+Orchestrator::Orchestrator(std::shared_ptr<HardwareProfileStore> hw_profile, std::shared_ptr<const HAL::DeviceTable> devices)
+    : hw_profile_(hw_profile), devices_(std::move(devices)), use_llm_for_paths_(false) {
     if (!hw_profile_) {
         throw std::runtime_error("Orchestrator's HardwareProfile cannot be null.");
     }
 }
 
+namespace {
+
+// Belief keys and operations that simulate_flux_cost() treats specially, interned once.
+struct PlanningKeys {
+    HAL::OpId conv_direct = HAL::intern_op("CONV_DIRECT");
+    HAL::OpId gemm_naive = HAL::intern_op("GEMM_NAIVE");
+    HAL::OpId gemm_flux_adaptive = HAL::intern_op("GEMM_FLUX_ADAPTIVE");
+    HAL::OpId saxpy_standard = HAL::intern_op("SAXPY_STANDARD");
+    HAL::OpId execute_jit_saxpy = HAL::intern_op("EXECUTE_JIT_SAXPY");
+    HAL::OpId jit_compile_saxpy = HAL::intern_op("JIT_COMPILE_SAXPY");
+    HAL::OpId jit_kernel_cache_hit = HAL::intern_op("JIT_KERNEL_CACHE_HIT");
+    HAL::OpId saxpy_avx2 = HAL::intern_op("SAXPY_AVX2");
+    HAL::OpId saxpy_avx512 = HAL::intern_op("SAXPY_AVX512");
+    HAL::OpId saxpy_neon = HAL::intern_op("SAXPY_NEON");
+    HAL::OpId gemm_avx2 = HAL::intern_op("GEMM_AVX2");
+    HAL::OpId gemm_avx512 = HAL::intern_op("GEMM_AVX512");
+    HAL::OpId gemm_neon = HAL::intern_op("GEMM_NEON");
+    HAL::OpId gemm_blocked = HAL::intern_op("GEMM_BLOCKED");
+    HAL::OpId gemm_blocked_mt = HAL::intern_op("GEMM_BLOCKED_MT");
+    HAL::OpId dense_to_csr = HAL::intern_op("DENSE_TO_CSR");
+    HAL::OpId spmm_csr = HAL::intern_op("SPMM_CSR");
+    HAL::OpId spmm_bsr = HAL::intern_op("SPMM_BSR");
+    HAL::OpId saxpy_bf16 = HAL::intern_op("SAXPY_BF16");
+    HAL::OpId saxpy_fp16 = HAL::intern_op("SAXPY_FP16");
+    HAL::OpId saxpy_int8 = HAL::intern_op("SAXPY_INT8");
+    HAL::OpId gemm_bf16 = HAL::intern_op("GEMM_BF16");
+    HAL::OpId gemm_fp16 = HAL::intern_op("GEMM_FP16");
+    HAL::OpId gemm_int8 = HAL::intern_op("GEMM_INT8");
+    HAL::OpId lambda_conv_amp = HAL::intern_op("lambda_Conv_Amp");
+    HAL::OpId lambda_conv_freq = HAL::intern_op("lambda_Conv_Freq");
+    HAL::OpId lambda_sparsity = HAL::intern_op("lambda_Sparsity");
+    HAL::OpId lambda_saxpy_generic = HAL::intern_op("lambda_SAXPY_generic");
+    HAL::OpId lambda_spmm_density = HAL::intern_op("lambda_SpMM_density");
+
+    // Fused ops (see FusionLibrary) are priced with the data-dependent model of their final component.
+    std::vector<std::pair<HAL::OpId, HAL::OpId>> fused_to_final = [] {
+        std::vector<std::pair<HAL::OpId, HAL::OpId>> pairs;
+        for (const FusionRule& rule : fusion_rules()) pairs.emplace_back(rule.fused_id, rule.second_id);
+        return pairs;
+    }();
+    HAL::OpId dynamic_model_op(HAL::OpId op) const {
+        for (const auto& pair : fused_to_final) {
+            if (pair.first == op) return pair.second;
+        }
+        return op;
+    }
+
+    // SIMD and reduced-precision variants share the data-dependent sensitivities of their scalar counterparts.
+    bool is_saxpy_kernel(HAL::OpId op) const {
+        return op == saxpy_standard || op == saxpy_avx2 || op == saxpy_avx512 || op == saxpy_neon ||
+               op == saxpy_bf16 || op == saxpy_fp16 || op == saxpy_int8;
+    }
+    bool is_gemm_kernel(HAL::OpId op) const {
+        return op == gemm_naive || op == gemm_flux_adaptive || op == gemm_avx2 || op == gemm_avx512 || op == gemm_neon ||
+               op == gemm_blocked || op == gemm_blocked_mt || op == gemm_bf16 || op == gemm_fp16 || op == gemm_int8;
+    }
+};
+
+const PlanningKeys& planning_keys() {
+    static const PlanningKeys keys; // Thread-safe one-time initialization
+    return keys;
+}
+
+// Error a plan quantized to 'type' adds, in VPU_Task::accuracy_bound's units: SAXPY rounds x
+// once; GEMM rounds both A and B, so each product may be off by 2u + u^2.
+double reduced_precision_error(TaskOp op, HAL::ElementType type) {
+    const double u = HAL::quantization_error(type);
+    return op == TaskOp::GEMM ? 2.0 * u + u * u : u;
+}
+
+// Reduced precision is proposed only within the task's accuracy bound and when the profiled
+// range of the input fits the type. That range may come from a sample of the first operand only,
+// so the QUANTIZE step checks the full operands again and keeps full precision if they do not fit.
+bool reduced_precision_allowed(TaskOp op, HAL::ElementType type, const EnrichedExecutionContext& context) {
+    if (!(context.accuracy_bound > 0.0) || context.sparse_a_pre_encoded || !context.profile ||
+        context.profile->input_stats.elements == 0) {
+        return false;
+    }
+    const HAL::BufferStats& range = context.profile->input_stats;
+    const double max_magnitude = std::max(std::fabs(range.min_value), std::fabs(range.max_value));
+    return HAL::quantization_fits(type, max_magnitude) && reduced_precision_error(op, type) <= context.accuracy_bound;
+}
+
+// A candidate strategy and the element types its kernels accept (a mask of 1 << HAL::ElementType).
+// Reduced-precision strategies also name the type they quantize the operands to.
+struct CandidateTemplate {
+    ExecutionPlan plan;
+    uint32_t element_types;
+    HAL::ElementType quantized_to = HAL::ElementType::FLOAT32; // FLOAT32: runs at the task's own precision
+};
+using CandidateTemplates = std::array<std::vector<CandidateTemplate>, static_cast<size_t>(TaskOp::COUNT)>;
+
+constexpr uint32_t element_mask(HAL::ElementType type) { return 1u << static_cast<uint32_t>(type); }
+constexpr uint32_t F32 = element_mask(HAL::ElementType::FLOAT32);
+constexpr uint32_t F64 = element_mask(HAL::ElementType::FLOAT64);
+
+// The candidate strategies for each op, with operation IDs resolved once. The scalar kernels
+// are templates instantiated per element type; the vectorized, JIT and sparse ones are f32 only.
+CandidateTemplates build_candidate_templates() {
+    CandidateTemplates templates;
+    auto& convolution = templates[static_cast<size_t>(TaskOp::CONVOLUTION)];
+    auto& gemm = templates[static_cast<size_t>(TaskOp::GEMM)];
+    auto& saxpy = templates[static_cast<size_t>(TaskOp::SAXPY)];
+    convolution = {
+        {{"Time Domain (Direct)", 0.0, {
+            {"CONV_DIRECT", "input", "output"}
+        }}, F64},
+        {{"Frequency Domain (FFT)", 0.0, {
+            {"FFT_FORWARD", "input", "temp_freq"},
+            {"ELEMENT_WISE_MULTIPLY", "temp_freq", "temp_result"},
+            {"FFT_INVERSE", "temp_result", "output"}
+        }}, F64}
+    };
+    gemm = {
+        {{"Naive GEMM", 0.0, {
+            {"GEMM_NAIVE", "input", "output"}
+        }}, F32 | F64},
+        {{"Flux-Adaptive GEMM", 0.0, {
+            {"GEMM_FLUX_ADAPTIVE", "input", "output"}
+        }}, F32},
+        {{"Blocked GEMM", 0.0, {
+            {"GEMM_BLOCKED", "input", "output"}
+        }}, F32},
+        {{"Blocked GEMM (Multithreaded)", 0.0, {
+            {"GEMM_BLOCKED_MT", "input", "output"}
+        }}, F32},
+        {{"Sparse CSR GEMM", 0.0, {
+            {"DENSE_TO_CSR", "input", "input_csr"},
+            {"SPMM_CSR", "input_csr", "output"}
+        }}, F32},
+        {{"Sparse BSR GEMM", 0.0, {
+            {"DENSE_TO_BSR", "input", "input_bsr"},
+            {"SPMM_BSR", "input_bsr", "output"}
+        }}, F32}
+    };
+    saxpy = {
+        {{"Standard SAXPY", 0.0, {
+            {"SAXPY_STANDARD", "input", "output"}
+        }}, F32 | F64},
+        {{"JIT Compiled SAXPY", 0.0, {
+            {"JIT_COMPILE_SAXPY", "input_metadata", "compiled_kernel_id"}, // Conceptual step
+            {"EXECUTE_JIT_SAXPY", "input", "output"}                        // Conceptual step
+        }}, F32}
+    };
+    // Vectorized variants are only proposed where the HAL registered them (see VPUCore::initialize_hal).
+    const struct { HAL::SimdIsa isa; const char* label; const char* suffix; } simd_variants[] = {
+        {HAL::SimdIsa::AVX2, "AVX2", "AVX2"},
+        {HAL::SimdIsa::AVX512, "AVX-512", "AVX512"},
+        {HAL::SimdIsa::NEON, "NEON", "NEON"},
+    };
+    for (const auto& variant : simd_variants) {
+        if (!HAL::cpu_supports(variant.isa)) continue;
+        saxpy.push_back({{std::string("Vectorized SAXPY (") + variant.label + ")", 0.0, {
+            {std::string("SAXPY_") + variant.suffix, "input", "output"}
+        }}, F32});
+        gemm.push_back({{std::string("Vectorized GEMM (") + variant.label + ")", 0.0, {
+            {std::string("GEMM_") + variant.suffix, "input", "output"}
+        }}, F32});
+    }
+    // Reduced-precision variants quantize the f32 operands, then multiply in the narrow type and
+    // dequantize as results are stored, so the output stays f32 (see reduced_precision_allowed).
+    const struct { HAL::ElementType type; const char* label; } precisions[] = {
+        {HAL::ElementType::BFLOAT16, "BF16"},
+        {HAL::ElementType::FLOAT16, "FP16"},
+        {HAL::ElementType::INT8, "INT8"},
+    };
+    for (const auto& precision : precisions) {
+        const std::string label = precision.label;
+        saxpy.push_back({{"Reduced-Precision SAXPY (" + label + ")", 0.0, {
+            {"QUANTIZE_" + label, "input", "input_" + label},
+            {"SAXPY_" + label, "input_" + label, "output"}
+        }}, F32, precision.type});
+        gemm.push_back({{"Reduced-Precision GEMM (" + label + ")", 0.0, {
+            {"QUANTIZE_" + label, "input", "input_" + label},
+            {"GEMM_" + label, "input_" + label, "output"}
+        }}, F32, precision.type});
+    }
+    // TODO: Could add a "JIT Generation" path here for other ops.
+    for (auto& op_templates : templates) {
+        for (auto& candidate : op_templates) {
+            for (auto& step : candidate.plan.steps) {
+                step.op_id = HAL::intern_op(step.operation_name);
+            }
+        }
+    }
+    return templates;
+}
+
+} // namespace
+
 // Main entry point for this pillar
 std::vector<ExecutionPlan> Orchestrator::determine_optimal_path(const EnrichedExecutionContext& context) { // Changed return type
-    std::cout << "[Pillar 3] Orchestrator: Determining candidate paths for task '" << context.task_type << "'..." << std::endl;
+    VPU_LOG_DEBUG("[Pillar 3] Orchestrator: Determining candidate paths for task '" << context.task_type << "'...");
+
+    // Candidates (including fused variants) and their prices come from the same belief version,
+    // so the ranking is reproducible.
+    HardwareProfileSnapshot beliefs = hw_profile_->snapshot();
+    const HAL::DeviceTable::Snapshot devices = devices_ ? devices_->snapshot() : nullptr;
+    // A context the Cortex did not build (op unset) describes a legacy task of its task_type.
+    const TaskOp op = context.op != TaskOp::UNKNOWN ? context.op : task_op_from_name(context.task_type);
+    const HAL::ElementType element_type = context.op != TaskOp::UNKNOWN ? context.element_type : default_element_type(op);
 
     std::vector<ExecutionPlan> candidates;
     if (use_llm_for_paths_) {
-        std::cout << "[Pillar 3] Orchestrator: Using LLM for path generation." << std::endl;
+        VPU_LOG_DEBUG("[Pillar 3] Orchestrator: Using LLM for path generation.");
         candidates = generate_paths_with_llm(context);
         // Fallback or combine with traditional method if LLM returns no paths or if desired
         if (candidates.empty()) {
-            std::cout << "[Pillar 3] Orchestrator: LLM returned no paths, falling back to traditional method." << std::endl;
-            candidates = generate_candidate_paths(context.task_type);
+            VPU_LOG_DEBUG("[Pillar 3] Orchestrator: LLM returned no paths, falling back to traditional method.");
+            candidates = generate_candidate_paths(op, element_type, context, *beliefs, devices);
         }
     } else {
         // 1. Generate all possible ways to solve the problem
-        candidates = generate_candidate_paths(context.task_type);
+        candidates = generate_candidate_paths(op, element_type, context, *beliefs, devices);
     }
 
     if (candidates.empty()) {
-        throw std::runtime_error("No candidate paths found for task: " + context.task_type);
+        throw std::runtime_error("No candidate paths found for task: " + context.task_type + " (" +
+                                 HAL::element_type_name(element_type) + ")");
+    }
+
+    // Steps from templates arrive with their OpIds resolved; intern any others (e.g., LLM-proposed ops).
+    for (auto& plan : candidates) {
+        for (auto& step : plan.steps) {
+            if (step.op_id == HAL::INVALID_OP_ID) {
+                step.op_id = HAL::intern_op(step.operation_name);
+            }
+        }
+    }
+
+    // A caller-encoded CSR operand is always served by SpMM, and needs no conversion step.
+    if (context.sparse_a_pre_encoded) {
+        const PlanningKeys& keys = planning_keys();
+        std::vector<ExecutionPlan> sparse_plans;
+        for (auto& plan : candidates) {
+            bool uses_csr = false;
+            for (const auto& step : plan.steps) uses_csr |= (step.op_id == keys.spmm_csr);
+            if (!uses_csr) continue;
+            plan.steps.erase(std::remove_if(plan.steps.begin(), plan.steps.end(),
+                                            [&](const ExecutionStep& step) { return step.op_id == keys.dense_to_csr; }),
+                             plan.steps.end());
+            plan.chosen_path_name += " (Pre-encoded)";
+            sparse_plans.push_back(std::move(plan));
+        }
+        if (!sparse_plans.empty()) {
+            candidates = std::move(sparse_plans);
+        }
     }
 
     // 2. Simulate the cost for each path based on the data profile
-    std::cout << "[Pillar 3] Orchestrator: Simulating costs for " << candidates.size() << " candidate path(s)..." << std::endl;
+    VPU_LOG_DEBUG("[Pillar 3] Orchestrator: Simulating costs for " << candidates.size() << " candidate path(s) against belief version "
+              << beliefs->version << "...");
+    const double density = input_density(context.shape, *context.profile);
     for (auto& plan : candidates) {
-        plan.predicted_holistic_flux = simulate_flux_cost(plan, *context.profile);
-        std::cout << "  -> Path '" << plan.chosen_path_name << "' - Predicted Flux: " << plan.predicted_holistic_flux << std::endl;
+        assign_work_units(plan, context.shape, density, *beliefs);
+        plan.predicted_holistic_flux = simulate_flux_cost(plan, *context.profile, *beliefs, context.jit_kernel_cached,
+                                                          context.payload_bytes, devices, context.shape.cache_regime, density);
+        plan.predicted_latency_ns = predict_latency_ns(plan, *beliefs);
+        plan.belief_version = beliefs->version;
+        VPU_LOG_DEBUG("  -> Path '" << plan.chosen_path_name << "' - Predicted Flux: " << plan.predicted_holistic_flux
+                  << ", Predicted Latency (ns): " << plan.predicted_latency_ns);
     }
 
     // 3. Sort candidates by predicted_holistic_flux (ascending)
@@ -45,90 +287,212 @@ std::vector<ExecutionPlan> Orchestrator::determine_optimal_path(const EnrichedEx
         return a.predicted_holistic_flux < b.predicted_holistic_flux;
     });
 
-    std::cout << "[Pillar 3] Orchestrator: Returning " << candidates.size() << " candidate path(s) sorted by predicted flux." << std::endl;
+    VPU_LOG_DEBUG("[Pillar 3] Orchestrator: Returning " << candidates.size() << " candidate path(s) sorted by predicted flux.");
     if (!candidates.empty()) {
-        std::cout << "  -> Top candidate: '" << candidates.front().chosen_path_name << "' with flux " << candidates.front().predicted_holistic_flux << std::endl;
+        VPU_LOG_DEBUG("  -> Top candidate: '" << candidates.front().chosen_path_name << "' with flux " << candidates.front().predicted_holistic_flux);
     }
     return candidates;
 }
 
+ProfilingPolicy Orchestrator::profiling_policy_for(TaskOp op) const {
+    ProfilingPolicy policy; // Exact
+    switch (op) {
+        case TaskOp::SAXPY:
+            // Priced from amplitude flux and Hamming weight: a strided sample estimates both, and
+            // nothing reads the spectrum.
+            policy.sampling = ProfileSampling::STRIDED;
+            policy.spectral = false;
+            break;
+        case TaskOp::GEMM:
+            // Priced from sparsity and Hamming weight only.
+            policy.sampling = ProfileSampling::STRIDED;
+            policy.spectral = false;
+            break;
+        case TaskOp::CONVOLUTION:
+            // The direct/FFT choice weighs amplitude and frequency flux; a 64K-sample window
+            // resolves the spectral centroid well enough to pick a path.
+            policy.sampling = ProfileSampling::STRIDED;
+            policy.fft_window = 65536;
+            break;
+        default:
+            break;
+    }
+    return policy;
+}
+
+ProfilingPolicy Orchestrator::profiling_policy_for(const std::string& task_type) const {
+    return profiling_policy_for(task_op_from_name(task_type));
+}
 
-// A factory that creates potential strategies based on task type
-std::vector<ExecutionPlan> Orchestrator::generate_candidate_paths(const std::string& task_type) {
-    std::vector<ExecutionPlan> paths;
-    if (task_type == "CONVOLUTION") {
-        paths.push_back({"Time Domain (Direct)", 0.0, {
-            {"CONV_DIRECT", "input", "output"}
-        }});
-        paths.push_back({"Frequency Domain (FFT)", 0.0, {
-            {"FFT_FORWARD", "input", "temp_freq"},
-            {"ELEMENT_WISE_MULTIPLY", "temp_freq", "temp_result"},
-            {"FFT_INVERSE", "temp_result", "output"}
-        }});
-    } else if (task_type == "GEMM") {
-        paths.push_back({"Naive GEMM", 0.0, {
-            {"GEMM_NAIVE", "input", "output"}
-        }});
-        paths.push_back({"Flux-Adaptive GEMM", 0.0, {
-            {"GEMM_FLUX_ADAPTIVE", "input", "output"}
-        }});
-    } else if (task_type == "SAXPY") {
-        paths.push_back({"Standard SAXPY", 0.0, {
-            {"SAXPY_STANDARD", "input", "output"}
-        }});
-        paths.push_back({"JIT Compiled SAXPY", 0.0, {
-            {"JIT_COMPILE_SAXPY", "input_metadata", "compiled_kernel_id"}, // Conceptual step
-            {"EXECUTE_JIT_SAXPY", "input", "output"}                        // Conceptual step
-        }});
+// A factory that creates potential strategies based on the op and its element type
+std::vector<ExecutionPlan> Orchestrator::generate_candidate_paths(TaskOp op, HAL::ElementType element_type,
+                                                                  const EnrichedExecutionContext& context,
+                                                                  const HardwareProfile& beliefs,
+                                                                  const HAL::DeviceTable::Snapshot& devices) {
+    static const CandidateTemplates templates = build_candidate_templates();
+    if (op == TaskOp::UNKNOWN || op == TaskOp::COUNT) {
+        return {};
+    }
+    std::vector<ExecutionPlan> candidates;
+    for (const CandidateTemplate& candidate : templates[static_cast<size_t>(op)]) {
+        if (!(candidate.element_types & element_mask(element_type))) continue;
+        if (HAL::is_quantized_type(candidate.quantized_to) && !reduced_precision_allowed(op, candidate.quantized_to, context)) {
+            continue;
+        }
+        candidates.push_back(candidate.plan);
+    }
+
+    // Pillar 6 seeds a base cost for every fused kernel it registers, so a believed cost means
+    // the Cerebellum can dispatch the fused step. Each plan gets one variant with every fusable pair fused.
+    const size_t template_count = candidates.size();
+    for (size_t p = 0; p < template_count; ++p) {
+        ExecutionPlan fused_plan = candidates[p];
+        bool fused_any = false;
+        for (const FusionRule& rule : fusion_rules()) {
+            if (!beliefs.base_operational_costs.find(rule.fused_id)) continue;
+            for (size_t i = 0; i + 1 < fused_plan.steps.size(); ++i) {
+                if (fused_plan.steps[i].op_id == rule.first_id && fused_plan.steps[i + 1].op_id == rule.second_id) {
+                    fused_plan.steps[i] = {rule.fused_name, fused_plan.steps[i].input_buffer_id,
+                                           fused_plan.steps[i + 1].output_buffer_id, rule.fused_id};
+                    fused_plan.steps.erase(fused_plan.steps.begin() + i + 1);
+                    fused_any = true;
+                }
+            }
+        }
+        if (fused_any) {
+            fused_plan.chosen_path_name += " (Fused)";
+            candidates.push_back(std::move(fused_plan));
+        }
+    }
+
+    // Offloaded variants: a plan moves to a device only as a whole, and only once the device's
+    // costs for all of its steps are believed (seeded when the device was added).
+    if (devices && element_type == default_element_type(op)) {
+        const size_t host_plan_count = candidates.size();
+        for (const HAL::DeviceTable::Entry& entry : *devices) {
+            if (entry.id == HAL::HOST_DEVICE || !entry.device->available()) continue;
+            for (size_t p = 0; p < host_plan_count; ++p) {
+                ExecutionPlan device_plan = candidates[p];
+                bool offloadable = !device_plan.steps.empty();
+                for (auto& step : device_plan.steps) {
+                    const HAL::OpId cost_id = entry.cost_id(step.op_id);
+                    if (cost_id == HAL::INVALID_OP_ID ||
+                        (!beliefs.base_operational_costs.find(cost_id) && !beliefs.transform_costs.find(cost_id))) {
+                        offloadable = false;
+                        break;
+                    }
+                    step.device = entry.id;
+                    step.cost_id = cost_id;
+                }
+                if (offloadable) {
+                    device_plan.chosen_path_name += " [" + entry.device->substrate() + "]";
+                    candidates.push_back(std::move(device_plan));
+                }
+            }
+        }
+    }
+    return candidates;
+}
+
+void Orchestrator::assign_work_units(ExecutionPlan& plan, const ProblemShape& shape, double density,
+                                     const HardwareProfile& beliefs) const {
+    for (auto& step : plan.steps) {
+        const HAL::OpId priced_op = (step.device != HAL::HOST_DEVICE && step.cost_id != HAL::INVALID_OP_ID) ? step.cost_id : step.op_id;
+        const SizeModel* model = beliefs.size_models.find(priced_op);
+        step.work_units = model ? work_units(model->complexity, shape, density) : 0.0;
     }
-    // TODO: Could add a "JIT Generation" path here for other ops.
-    return paths;
 }
 
 // The predictive core of the VPU.
-// Holistic_Flux = Σ(τ_transform) + τ_operation
-// τ_operation = Base_Op_Cost + f(ACW, λ)
-double Orchestrator::simulate_flux_cost(const ExecutionPlan& plan, const DataProfile& profile) {
+// Holistic_Flux = Σ(τ_transform + τ_size) + τ_operation
+// τ_operation = Base_Op_Cost + τ_size + f(ACW, λ)
+// τ_size = per_unit[cache regime] * work_units (the step's SizeModel, if it has one)
+// All lookups are by interned OpId: dense array reads, no string hashing or allocation.
+double Orchestrator::simulate_flux_cost(const ExecutionPlan& plan, const DataProfile& profile, const HardwareProfile& beliefs,
+                                        bool jit_kernel_cached, uint64_t payload_bytes, const HAL::DeviceTable::Snapshot& devices,
+                                        CacheRegime cache_regime, double density) {
+    const PlanningKeys& keys = planning_keys();
+    const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
     double total_flux = 0.0;
+    bool plan_uses_network = false;
+    bool plan_uses_heavy_io = false;
 
     // Sum of transform costs and the single final operation cost
     for(const auto& step : plan.steps) {
-        // Is this a transform step?
-        if (hw_profile_->transform_costs.count(step.operation_name)) {
-            total_flux += hw_profile_->transform_costs.at(step.operation_name);
+        const HAL::OpId op = step.op_id;
+        if (op == HAL::INVALID_OP_ID) {
+            continue; // Unknown to the registry, so there are no beliefs about it
+        }
+        const uint32_t caps = registry.capabilities(op);
+        plan_uses_network |= (caps & HAL::OP_CAP_USES_NETWORK) != 0;
+        plan_uses_heavy_io |= (caps & HAL::OP_CAP_USES_HEAVY_IO) != 0;
+
+        // Off the host, the step is priced from its device's beliefs, and each step stages the
+        // task's buffers to the device and back (transfer beliefs are per MiB moved).
+        HAL::OpId priced_op = op;
+        if (step.device != HAL::HOST_DEVICE && step.cost_id != HAL::INVALID_OP_ID) {
+            priced_op = step.cost_id;
+            if (devices && step.device < devices->size()) {
+                const HAL::DeviceTable::Entry& entry = (*devices)[step.device];
+                plan_uses_network |= entry.device->kind() == HAL::DeviceKind::REMOTE;
+                if (const double* per_mib = beliefs.transform_costs.find(entry.transfer_id)) {
+                    const double BYTES_PER_MIB = 1024.0 * 1024.0;
+                    total_flux += *per_mib * static_cast<double>(payload_bytes) / BYTES_PER_MIB;
+                }
+            }
+        }
+
+        // Is this a transform step? A compile whose kernel is already cached is only a lookup.
+        const HAL::OpId transform_op = (jit_kernel_cached && priced_op == keys.jit_compile_saxpy) ? keys.jit_kernel_cache_hit : priced_op;
+        if (const double* transform_cost = beliefs.transform_costs.find(transform_op)) {
+            total_flux += *transform_cost;
+        }
+        // Work that grows with the problem: N, N log N, N * taps or M * N * K units at this regime's rate.
+        if (step.work_units > 0.0) {
+            if (const SizeModel* size_model = beliefs.size_models.find(priced_op)) {
+                total_flux += size_model->cost(cache_regime, step.work_units);
+            }
         }
         // Is this a final computation step?
-        if(hw_profile_->base_operational_costs.count(step.operation_name)) {
-            double base_op_cost = hw_profile_->base_operational_costs.at(step.operation_name); // This is now primarily predicted_cycle_cost
+        if (const double* base_cost = beliefs.base_operational_costs.find(priced_op)) {
+            double base_op_cost = *base_cost; // This is now primarily predicted_cycle_cost
             double dynamic_cost_omni = 0.0; // Cost from existing omnimorphic metrics
             double dynamic_cost_hw = 0.0;   // Cost from Hamming Weight
 
+            const HAL::OpId model_op = keys.dynamic_model_op(op);
             // Calculate dynamic_cost_omni (existing logic based on amplitude, frequency, original sparsity interpretation)
-            if (step.operation_name == "CONV_DIRECT") {
-                if (hw_profile_->flux_sensitivities.count("lambda_Conv_Amp") &&
-                    hw_profile_->flux_sensitivities.count("lambda_Conv_Freq")) {
-                    dynamic_cost_omni = (profile.amplitude_flux * hw_profile_->flux_sensitivities.at("lambda_Conv_Amp")) +
-                                        (profile.frequency_flux * hw_profile_->flux_sensitivities.at("lambda_Conv_Freq"));
+            if (model_op == keys.conv_direct) {
+                const double* lambda_amp = beliefs.flux_sensitivities.find(keys.lambda_conv_amp);
+                const double* lambda_freq = beliefs.flux_sensitivities.find(keys.lambda_conv_freq);
+                if (lambda_amp && lambda_freq) {
+                    dynamic_cost_omni = (profile.amplitude_flux * *lambda_amp) +
+                                        (profile.frequency_flux * *lambda_freq);
                 }
-            } else if (step.operation_name == "GEMM_NAIVE" || step.operation_name == "GEMM_FLUX_ADAPTIVE") {
+            } else if (keys.is_gemm_kernel(model_op)) {
                 // Assuming lambda_Sparsity refers to the original sparsity metric (percent_zero or similar)
                 // and not the new bit-level sparsity_ratio from Hamming Weight.
                 // If lambda_Sparsity should use the new sparsity_ratio, this needs adjustment.
                 // For now, let's assume it uses profile.sparsity_ratio (which is 1 - HW_density).
                 // A key like "GEMM_NAIVE_lambda_Sparsity" might be more explicit.
-                if (hw_profile_->flux_sensitivities.count("lambda_Sparsity")) { // Generic sparsity sensitivity
+                if (const double* lambda_sparsity = beliefs.flux_sensitivities.find(keys.lambda_sparsity)) { // Generic sparsity sensitivity
                     // This interpretation might need refinement. If sparsity_ratio is bit-level (1.0 for all zeros),
                     // then (1.0 - profile.sparsity_ratio) is density.
                     // If lambda_Sparsity expects higher cost for denser data, then (1.0 - profile.sparsity_ratio) is correct.
-                    dynamic_cost_omni = (1.0 - profile.sparsity_ratio) * hw_profile_->flux_sensitivities.at("lambda_Sparsity");
+                    dynamic_cost_omni = (1.0 - profile.sparsity_ratio) * *lambda_sparsity;
                 }
-            } else if (step.operation_name == "SAXPY_STANDARD") {
-                if (hw_profile_->flux_sensitivities.count("lambda_SAXPY_generic")) { // Generic sensitivity for SAXPY
-                     dynamic_cost_omni = profile.amplitude_flux * hw_profile_->flux_sensitivities.at("lambda_SAXPY_generic");
+            } else if (model_op == keys.spmm_csr || model_op == keys.spmm_bsr) {
+                // SpMM work scales with the non-zeros: the element density, as the size models use it
+                // (sparsity_ratio is bit-level, so dense floats would look mostly empty).
+                if (const double* lambda_density = beliefs.flux_sensitivities.find(keys.lambda_spmm_density)) {
+                    dynamic_cost_omni = density * *lambda_density;
                 }
-            } else if (step.operation_name == "EXECUTE_JIT_SAXPY") {
-                if (hw_profile_->flux_sensitivities.count("lambda_SAXPY_generic")) {
-                    dynamic_cost_omni = profile.amplitude_flux * hw_profile_->flux_sensitivities.at("lambda_SAXPY_generic") * 0.5; // JIT might be less sensitive
+            } else if (keys.is_saxpy_kernel(model_op)) {
+                if (const double* lambda_saxpy = beliefs.flux_sensitivities.find(keys.lambda_saxpy_generic)) { // Generic sensitivity for SAXPY
+                     dynamic_cost_omni = profile.amplitude_flux * *lambda_saxpy;
+                }
+            } else if (model_op == keys.execute_jit_saxpy) {
+                if (const double* lambda_saxpy = beliefs.flux_sensitivities.find(keys.lambda_saxpy_generic)) {
+                    dynamic_cost_omni = profile.amplitude_flux * *lambda_saxpy * 0.5; // JIT might be less sensitive
                 }
             }
             // Note: ELEMENT_WISE_MULTIPLY currently has a base_operational_cost but no dynamic_cost_omni logic.
@@ -136,11 +500,11 @@ double Orchestrator::simulate_flux_cost(const ExecutionPlan& plan, const DataPro
             // Calculate dynamic_cost_hw (new Hamming Weight based cost)
             // profile.hamming_weight is from DataProfile (based on data_in_a)
             // profile.sparsity_ratio is also available (1.0 - HW_density)
-            std::string hw_sensitivity_key = step.operation_name + "_lambda_hw_combined";
-            if (hw_profile_->flux_sensitivities.count(hw_sensitivity_key)) {
+            // The "<op>_lambda_hw_combined" key ID is precomputed by the registry.
+            if (const double* lambda_hw = beliefs.flux_sensitivities.find(registry.hw_sensitivity_id(priced_op))) {
                 // This assumes the sensitivity value expects raw hamming_weight.
                 // Alternatively, it could be based on sparsity_ratio or (1.0 - sparsity_ratio).
-                dynamic_cost_hw = static_cast<double>(profile.hamming_weight) * hw_profile_->flux_sensitivities.at(hw_sensitivity_key);
+                dynamic_cost_hw = static_cast<double>(profile.hamming_weight) * *lambda_hw;
             }
 
             total_flux += (base_op_cost + dynamic_cost_omni + dynamic_cost_hw);
@@ -152,11 +516,6 @@ double Orchestrator::simulate_flux_cost(const ExecutionPlan& plan, const DataPro
             //           << ", HWCost: " << dynamic_cost_hw
             //           << ", StepFlux: " << (base_op_cost + dynamic_cost_omni + dynamic_cost_hw) << std::endl;
         }
-        // The following 'else if' blocks for SAXPY_STANDARD and EXECUTE_JIT_SAXPY are removed
-        // as their logic is now incorporated above within the main 'if(hw_profile_->base_operational_costs.count(step.operation_name))' block.
-        // This simplifies the structure to:
-        // 1. If transform_cost, add it.
-        // 2. Else if base_operational_cost, calculate base + specific dynamic_cost, then add.
     }
 
     // --- Apply IoT Sensor Data Adjustments ---
@@ -183,17 +542,9 @@ double Orchestrator::simulate_flux_cost(const ExecutionPlan& plan, const DataPro
     }
 
     // Example: Adjust for network latency (if plan involves network - simplistic check)
-    // A more robust check would inspect plan.steps for network-bound operations.
     const double NET_LATENCY_THRESHOLD_MS = 100.0;
     const double NET_LATENCY_MULTIPLIER = 1.2;
-    bool plan_uses_network = false; // Simple placeholder; a real check would analyze plan steps
-    for(const auto& step : plan.steps) {
-        // Conceptual: Check if step.operation_name implies network usage
-        if (step.operation_name.find("NETWORK_") != std::string::npos || step.operation_name.find("REMOTE_") != std::string::npos) {
-            plan_uses_network = true;
-            break;
-        }
-    }
+    // plan_uses_network was derived from the precomputed OP_CAP_USES_NETWORK flags above.
     if (plan_uses_network && profile.network_latency_ms > NET_LATENCY_THRESHOLD_MS) {
         cost_multiplier *= NET_LATENCY_MULTIPLIER;
         log_iot_adjustments += "NetLatency(" + std::to_string(profile.network_latency_ms) + "ms * " + std::to_string(NET_LATENCY_MULTIPLIER) + "); ";
@@ -203,13 +554,7 @@ double Orchestrator::simulate_flux_cost(const ExecutionPlan& plan, const DataPro
     // This is highly conceptual as specific I/O steps aren't well-defined yet.
     const double IO_THROUGHPUT_LOW_MBPS = 50.0; // If throughput is below this, penalize.
     const double IO_THROUGHPUT_MULTIPLIER = 1.15;
-    bool plan_uses_heavy_io = false; // Simple placeholder
-     for(const auto& step : plan.steps) {
-        if (step.operation_name.find("DISK_") != std::string::npos || step.operation_name.find("LOAD_") != std::string::npos) {
-            plan_uses_heavy_io = true;
-            break;
-        }
-    }
+    // plan_uses_heavy_io was derived from the precomputed OP_CAP_USES_HEAVY_IO flags above.
     if (plan_uses_heavy_io && profile.io_throughput_mbps < IO_THROUGHPUT_LOW_MBPS && profile.io_throughput_mbps > 0) { // avoid division by zero if 0 is possible
         cost_multiplier *= IO_THROUGHPUT_MULTIPLIER;
         log_iot_adjustments += "LowIO(" + std::to_string(profile.io_throughput_mbps) + "Mbps * " + std::to_string(IO_THROUGHPUT_MULTIPLIER) + "); ";
@@ -229,23 +574,35 @@ double Orchestrator::simulate_flux_cost(const ExecutionPlan& plan, const DataPro
     total_flux *= cost_multiplier;
 
     if (original_flux != total_flux) {
-        std::cout << "      [Pillar 3] Flux for plan '" << plan.chosen_path_name << "' adjusted by IoT factors: "
+        VPU_LOG_DEBUG("      [Pillar 3] Flux for plan '" << plan.chosen_path_name << "' adjusted by IoT factors: "
                   << original_flux << " -> " << total_flux
-                  << ". Adjustments: " << (log_iot_adjustments.empty() ? "None" : log_iot_adjustments)
-                  << std::endl;
+                  << ". Adjustments: " << (log_iot_adjustments.empty() ? "None" : log_iot_adjustments));
     }
     // --- End of IoT Sensor Data Adjustments ---
 
     return total_flux;
 }
 
+double Orchestrator::predict_latency_ns(const ExecutionPlan& plan, const HardwareProfile& beliefs) const {
+    double total_ns = 0.0;
+    for (const auto& step : plan.steps) {
+        const HAL::OpId priced_op = (step.device != HAL::HOST_DEVICE && step.cost_id != HAL::INVALID_OP_ID) ? step.cost_id : step.op_id;
+        const LatencyStats* stats = beliefs.latency.find(priced_op);
+        if (!stats) {
+            return 0.0; // A partial sum would make unobserved plans look cheap
+        }
+        total_ns += stats->ewma_ns;
+    }
+    return total_ns;
+}
+
 void Orchestrator::set_llm_path_generation(bool enable) {
     use_llm_for_paths_ = enable;
-    std::cout << "[Pillar 3] Orchestrator: LLM path generation " << (enable ? "enabled." : "disabled.") << std::endl;
+    VPU_LOG_INFO("[Pillar 3] Orchestrator: LLM path generation " << (enable ? "enabled." : "disabled."));
 }
 
 std::vector<ExecutionPlan> Orchestrator::generate_paths_with_llm(const EnrichedExecutionContext& context) {
-    std::cout << "[Pillar 3] Orchestrator: LLM path generation called with context for task type: " << context.task_type << std::endl;
+    VPU_LOG_DEBUG("[Pillar 3] Orchestrator: LLM path generation called with context for task type: " << context.task_type);
     // In a real scenario, this would involve formatting the context and profile,
     // sending it to an LLM, and parsing the response.
     // For now, returning an empty vector to signify conceptual implementation.
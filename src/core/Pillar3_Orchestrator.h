@@ -1,51 +1,59 @@
 #pragma once
 
 #include "vpu_data_structures.h"
+#include "core/HardwareProfile.h"
+#include "hal/device.h"
 #include <map>
 #include <string>
+#include <atomic>
 
 namespace VPU {
 
-// Represents the hardware's known performance characteristics (the "beliefs").
-// This is the core model that Pillar 5 will update.
-struct HardwareProfile {
-    // Defines the base cost for an operation, primarily predicting cycle_cost.
-    // e.g., "CONV_DIRECT" -> 100.0 (arbitrary flux units, representing estimated cycles)
-    // This cost is for the operation itself, assuming neutral or average data impact.
-    std::map<std::string, double> base_operational_costs;
-
-    // Defines the cost of changing data representation or setup costs.
-    // e.g., "FFT_FORWARD" (if considered a transform), "JIT_COMPILE_SAXPY"
-    // Key: string (e.g., "TRANSFORM_TIME_TO_FREQ")
-    std::map<std::string, double> transform_costs;
-
-    // Defines how sensitive an operation is to different data characteristics (flux per unit of metric).
-    // These are the "lambdas" that Pillar 5 learns and updates.
-    // Examples:
-    // - "OPERATION_NAME_lambda_Sparsity" -> how cost changes with data sparsity.
-    // - "OPERATION_NAME_lambda_AmplitudeFlux" -> how cost changes with amplitude flux.
-    // - "OPERATION_NAME_lambda_hw_combined" -> new, for Hamming Weight sensitivity.
-    std::map<std::string, double> flux_sensitivities;
-};
-
 class Orchestrator {
 public:
-    explicit Orchestrator(std::shared_ptr<HardwareProfile> hw_profile);
+    // With 'devices', plans are also proposed for every available device that can run all their steps.
+    explicit Orchestrator(std::shared_ptr<HardwareProfileStore> hw_profile,
+                          std::shared_ptr<const HAL::DeviceTable> devices = nullptr);
+    // Plans against one immutable belief snapshot; safe to call from many threads at once.
     std::vector<ExecutionPlan> determine_optimal_path(const EnrichedExecutionContext& context); // Changed return type
 
+    // How much profile fidelity planning a task of this op needs, from what its cost model
+    // reads. Unknown ops get the exact, full-input profile.
+    ProfilingPolicy profiling_policy_for(TaskOp op) const;
+    ProfilingPolicy profiling_policy_for(const std::string& task_type) const; // By task_type name
+
     // Method to enable/disable LLM usage
     void set_llm_path_generation(bool enable);
 
 private:
-    std::vector<ExecutionPlan> generate_candidate_paths(const std::string& task_type);
-    double simulate_flux_cost(const ExecutionPlan& plan, const DataProfile& profile);
+    // The op's templates whose kernels accept 'element_type' (reduced-precision ones only within the
+    // context's accuracy bound and profiled range), plus a fused variant of each plan that has a
+    // fusable pair with believed costs, plus a variant of each of those per available device that supports
+    // (and has beliefs for) every step. Devices run the op's default element type only.
+    std::vector<ExecutionPlan> generate_candidate_paths(TaskOp op, HAL::ElementType element_type,
+                                                        const EnrichedExecutionContext& context, const HardwareProfile& beliefs,
+                                                        const HAL::DeviceTable::Snapshot& devices);
+    // Sets each step's work_units from its size model and the problem's shape ('density': non-zero fraction of A).
+    void assign_work_units(ExecutionPlan& plan, const ProblemShape& shape, double density, const HardwareProfile& beliefs) const;
+    // 'jit_kernel_cached' prices JIT_COMPILE_SAXPY at the JIT_KERNEL_CACHE_HIT belief instead of a full compile.
+    // Device-targeted steps are priced from their "<op>@<substrate>" beliefs plus moving 'payload_bytes' there and back.
+    // Steps with work_units are charged their size model's rate for 'cache_regime'.
+    // SpMM steps scale with 'density', the non-zero fraction of A (see input_density()).
+    double simulate_flux_cost(const ExecutionPlan& plan, const DataProfile& profile, const HardwareProfile& beliefs,
+                              bool jit_kernel_cached = false, uint64_t payload_bytes = 0,
+                              const HAL::DeviceTable::Snapshot& devices = nullptr, CacheRegime cache_regime = CACHE_L1,
+                              double density = 1.0);
+    // Sum of the learned latencies (EWMA) of the plan's steps, keyed as they are priced; 0 if any
+    // step's operation has not been observed yet.
+    double predict_latency_ns(const ExecutionPlan& plan, const HardwareProfile& beliefs) const;
 
     // (Conceptual) Method to generate paths with LLM
     std::vector<ExecutionPlan> generate_paths_with_llm(const EnrichedExecutionContext& context);
 
-    std::shared_ptr<HardwareProfile> hw_profile_;
+    std::shared_ptr<HardwareProfileStore> hw_profile_;
+    std::shared_ptr<const HAL::DeviceTable> devices_; // May be null: host-only planning
     // Member variable to control LLM usage
-    bool use_llm_for_paths_;
+    std::atomic<bool> use_llm_for_paths_;
 };
 
 } // namespace VPU
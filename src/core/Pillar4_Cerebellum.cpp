@@ -1,66 +1,362 @@
 #include "core/Pillar4_Cerebellum.h"
 #include "hal/hal_utils.h" // For calculate_data_hamming_weight (will be used later)
+#include "hal/sparse.h"    // For the sparse GEMM meta-operations
+#include "hal/quantize.h"  // For the reduced-precision meta-operations
+#include "hal/buffer_stats.h" // For reusing the Cortex's scan of the task input
+#include "hal/scratch_arena.h" // For intermediate plan buffers
+#include "hal/convolution.h"   // For the overlap-save spectra size
+#include "core/TaskDescriptor.h" // For resolved_op
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <array>
 #include <chrono>
 #include <stdexcept> // Required for std::runtime_error
-#include <iostream>  // Required for std::cout
 #include <vector>    // Required for std::vector (will be used later)
 
 namespace VPU {
 
-Cerebellum::Cerebellum(std::shared_ptr<HAL::KernelLibrary> kernel_lib) : kernel_lib_(kernel_lib) {
-     if (!kernel_lib_) {
-        throw std::runtime_error("Cerebellum's KernelLibrary cannot be null.");
+namespace {
+
+// GEMM dimensions from extended_params. M and K default to the pre-encoded sparse operand's shape.
+bool gemm_dims(const VPU_Task& task, int& M, int& N, int& K) {
+    auto param = [&](const char* key, int fallback) {
+        auto it = task.extended_params.find(key);
+        return it != task.extended_params.end() ? it->second : fallback;
+    };
+    M = param("M", task.sparse_a.rows);
+    N = param("N", -1);
+    K = param("K", task.sparse_a.cols);
+    return M > 0 && N >= 0 && K > 0;
+}
+
+// Dense A -> CSR/BSR. The report charges one pass over A.
+HAL::KernelFluxReport convert_dense_a(const VPU_Task& task, HAL::CsrMatrix* csr, HAL::BsrMatrix* bsr, int block) {
+    int M, N, K;
+    if (!task.data_in_a || !gemm_dims(task, M, N, K)) {
+        VPU_LOG_ERROR("  -> [Cerebellum ERROR] Sparse conversion needs dense A and M, N, K dimensions.");
+        return {0, 0, 0};
     }
+    HAL::Span<const float> A = HAL::as_span<float>(task.data_in_a, static_cast<size_t>(M) * K);
+    HAL::KernelFluxReport report;
+    report.hw_in_cost = HAL::hamming_weight_reusing(A.data(), A.size_bytes());
+    if (csr) {
+        *csr = HAL::dense_to_csr(A, M, K);
+        VPU_LOG_DEBUG("  -> [Cerebellum] Encoded A as CSR: " << csr->nnz() << " of " << A.size() << " values are non-zero.");
+    } else {
+        *bsr = HAL::dense_to_bsr(A, M, K, block, block);
+        VPU_LOG_DEBUG("  -> [Cerebellum] Encoded A as BSR: " << bsr->num_blocks() << " non-zero " << block << "x" << block << " blocks.");
+    }
+    report.hw_out_cost = report.hw_in_cost; // The encoding holds exactly the non-zero bits of A
+    report.cycle_cost = static_cast<uint64_t>(M) * K;
+    return report;
 }
 
-// This function receives the final plan and executes it.
-ActualPerformanceRecord Cerebellum::execute(const ExecutionPlan& plan, VPU_Task& task) {
-    std::cout << "[Pillar 4] Cerebellum: Beginning execution of plan '" << plan.chosen_path_name << "'." << std::endl;
+// C = A * B on the sparse form of A: either a converted CSR/BSR, or the task's pre-encoded CSR.
+HAL::KernelFluxReport run_spmm(VPU_Task& task, const HAL::CsrView* csr, const HAL::BsrMatrix* bsr) {
+    int M, N, K;
+    if (!task.data_in_b || !task.data_out || !gemm_dims(task, M, N, K)) {
+        VPU_LOG_ERROR("  -> [Cerebellum ERROR] SpMM needs B, C and M, N, K dimensions.");
+        return {0, 0, 0};
+    }
+    HAL::Span<const float> B = HAL::as_span<float>(task.data_in_b, static_cast<size_t>(K) * N);
+    HAL::Span<float> C = HAL::as_mutable_span<float>(task.data_out, static_cast<size_t>(M) * N);
+    HAL::KernelFluxReport report;
+    report.hw_in_cost = HAL::calculate_data_hamming_weight(B.data(), B.size_bytes());
+    uint64_t stored_values = 0;
+    bool ok = false;
+    if (csr) {
+        report.hw_in_cost += HAL::calculate_data_hamming_weight(csr->values, csr->nnz() * sizeof(float));
+        stored_values = csr->nnz();
+        ok = HAL::cpu_spmm_csr(*csr, B, C, N);
+    } else if (bsr) {
+        report.hw_in_cost += HAL::calculate_data_hamming_weight(bsr->values.data(), bsr->values.size() * sizeof(float));
+        stored_values = bsr->values.size();
+        ok = HAL::cpu_spmm_bsr(*bsr, B, C, N);
+    }
+    if (!ok) return {0, 0, 0};
+    report.hw_out_cost = HAL::calculate_data_hamming_weight(C.data(), C.size_bytes());
+    report.cycle_cost = stored_values * static_cast<uint64_t>(N) * 2; // One multiply-add per stored value per column
+    return report;
+}
 
-    auto start_time = std::chrono::high_resolution_clock::now();
-    last_jit_compiled_kernel_ = nullptr; // This type is now std::function<KernelFluxReport()>
+// The reduced-precision meta-operations for one element type: QUANTIZE_<P> quantizes the task's
+// f32 operands, then SAXPY_<P> or GEMM_<P> runs on them and stores f32 results.
+struct QuantizedOps {
+    HAL::ElementType type;
+    HAL::OpId quantize;
+    HAL::OpId saxpy;
+    HAL::OpId gemm;
+};
+
+const QuantizedOps* find_quantized_ops(HAL::OpId op) {
+    static const std::array<QuantizedOps, 3> ops = {{
+        {HAL::ElementType::BFLOAT16, HAL::intern_op("QUANTIZE_BF16"), HAL::intern_op("SAXPY_BF16"), HAL::intern_op("GEMM_BF16")},
+        {HAL::ElementType::FLOAT16, HAL::intern_op("QUANTIZE_FP16"), HAL::intern_op("SAXPY_FP16"), HAL::intern_op("GEMM_FP16")},
+        {HAL::ElementType::INT8, HAL::intern_op("QUANTIZE_INT8"), HAL::intern_op("SAXPY_INT8"), HAL::intern_op("GEMM_INT8")},
+    }};
+    for (const QuantizedOps& entry : ops) {
+        if (op == entry.quantize || op == entry.saxpy || op == entry.gemm) return &entry;
+    }
+    return nullptr;
+}
 
-    std::map<std::string, void*> memory_buffers;
-    memory_buffers["input"] = const_cast<void*>(task.data_in_a);
-    memory_buffers["output"] = task.data_out;
+// f32 operands -> 'type': x for SAXPY, A and B for GEMM. Leaves both tensors empty (full
+// precision) unless every operand fits the type. The report charges one pass to find each
+// operand's range and one to round it; the output side is the narrower encoding.
+HAL::KernelFluxReport quantize_operands(const VPU_Task& task, HAL::ElementType type, HAL::QuantizedTensor& a,
+                                        HAL::QuantizedTensor& b) {
+    a = HAL::QuantizedTensor();
+    b = HAL::QuantizedTensor();
+    if (!task.data_in_a || input_element_type(task) != HAL::ElementType::FLOAT32) {
+        VPU_LOG_ERROR("  -> [Cerebellum ERROR] Quantization needs f32 inputs.");
+        return {0, 0, 0};
+    }
+    HAL::Span<const float> x;
+    HAL::Span<const float> y;
+    if (resolved_op(task) == TaskOp::GEMM) {
+        int M, N, K;
+        if (!task.data_in_b || !gemm_dims(task, M, N, K)) {
+            VPU_LOG_ERROR("  -> [Cerebellum ERROR] GEMM quantization needs B and M, N, K dimensions.");
+            return {0, 0, 0};
+        }
+        x = HAL::as_span<float>(task.data_in_a, static_cast<size_t>(M) * K);
+        y = HAL::as_span<float>(task.data_in_b, static_cast<size_t>(K) * N);
+    } else {
+        x = HAL::as_span<float>(task.data_in_a, task.num_elements);
+    }
 
-    std::vector<double> temp_buffer_1_double;
-    std::vector<double> temp_buffer_2_double;
-    // std::vector<float> temp_buffer_1_float; // Not used in current example path
-    // std::vector<float> temp_buffer_2_float; // Not used in current example path
+    HAL::KernelFluxReport report;
+    report.hw_in_cost = HAL::hamming_weight_reusing(x.data(), x.size_bytes());
+    report.hw_in_cost += HAL::calculate_data_hamming_weight(y.data(), y.size_bytes());
+    report.cycle_cost = (x.size() + y.size()) * 2;
+    if (!HAL::quantize(x, type, a) || (!y.empty() && !HAL::quantize(y, type, b))) {
+        a = HAL::QuantizedTensor();
+        b = HAL::QuantizedTensor();
+        VPU_LOG_DEBUG("  -> [Cerebellum] Operands do not fit " << HAL::element_type_name(type) << "; keeping full precision.");
+        report.hw_out_cost = report.hw_in_cost;
+        return report;
+    }
+    report.hw_out_cost = HAL::calculate_data_hamming_weight(a.storage.data(), a.size_bytes()) +
+                         HAL::calculate_data_hamming_weight(b.storage.data(), b.size_bytes());
+    VPU_LOG_DEBUG("  -> [Cerebellum] Quantized operands to " << HAL::element_type_name(type) << ": "
+                  << x.size_bytes() + y.size_bytes() << " -> " << a.size_bytes() + b.size_bytes() << " bytes.");
+    return report;
+}
 
-    if (task.task_type == "CONVOLUTION" && task.num_elements > 0) { // Example, not fully plumbed
-        temp_buffer_1_double.resize(task.num_elements);
-        temp_buffer_2_double.resize(task.num_elements);
-        memory_buffers["temp_freq"] = temp_buffer_1_double.data();
-        memory_buffers["temp_result"] = temp_buffer_2_double.data();
+// y = alpha * x + y (SAXPY) or C = A * B (GEMM) on the quantized operands.
+HAL::KernelFluxReport run_quantized(VPU_Task& task, bool gemm, const HAL::QuantizedTensor& a, const HAL::QuantizedTensor& b) {
+    if (!task.data_out) {
+        VPU_LOG_ERROR("  -> [Cerebellum ERROR] Reduced-precision kernel has no output buffer.");
+        return {0, 0, 0};
+    }
+    HAL::KernelFluxReport report;
+    report.hw_in_cost = HAL::calculate_data_hamming_weight(a.storage.data(), a.size_bytes()) +
+                        HAL::calculate_data_hamming_weight(b.storage.data(), b.size_bytes());
+    HAL::Span<float> out;
+    if (gemm) {
+        int M, N, K;
+        if (!gemm_dims(task, M, N, K)) return {0, 0, 0};
+        out = HAL::as_mutable_span<float>(task.data_out, static_cast<size_t>(M) * N);
+        if (!HAL::cpu_gemm_quantized(a, b, out, M, N, K)) return {0, 0, 0};
+        report.cycle_cost = static_cast<uint64_t>(M) * N * K * 2;
+    } else {
+        out = HAL::as_mutable_span<float>(task.data_out, task.num_elements);
+        report.hw_in_cost += HAL::calculate_data_hamming_weight(out.data(), out.size_bytes()); // Initial y
+        if (!HAL::cpu_saxpy_quantized(task.alpha, a, out)) return {0, 0, 0};
+        report.cycle_cost = static_cast<uint64_t>(task.num_elements) * 2;
     }
+    report.hw_out_cost = HAL::calculate_data_hamming_weight(out.data(), out.size_bytes());
+    return report;
+}
+
+// The buffers a plan's steps name. "input" and "output" are the task's own; any other id is an
+// intermediate taken from this thread's scratch arena on first use (none when 'scratch_bytes'
+// is 0) and released in bulk when the execution's ScratchScope ends.
+class PlanBuffers {
+public:
+    PlanBuffers(VPU_Task& task, HAL::ScratchScope& scratch, size_t scratch_bytes)
+        : scratch_(scratch), scratch_bytes_(scratch_bytes) {
+        named_.push_back({"input", const_cast<void*>(task.data_in_a)});
+        named_.push_back({"output", task.data_out});
+    }
+
+    void* get(const std::string& id) {
+        for (const auto& buffer : named_) {
+            if (buffer.first == id) return buffer.second;
+        }
+        void* data = (scratch_bytes_ > 0 && !id.empty()) ? scratch_.acquire(scratch_bytes_) : nullptr;
+        named_.push_back({id, data});
+        return data;
+    }
+
+private:
+    HAL::ScratchScope& scratch_;
+    size_t scratch_bytes_;
+    std::vector<std::pair<std::string, void*>> named_; // A handful of entries: linear lookup
+};
+
+// Points the task at one step's buffers while it runs, so kernels read the step's input
+// through data_in_a and write its output through data_out. Unbound ids leave the field as is.
+class StepBinding {
+public:
+    StepBinding(VPU_Task& task, void* input, void* output)
+        : task_(task), saved_in_(task.data_in_a), saved_out_(task.data_out) {
+        if (input) task_.data_in_a = input;
+        if (output) task_.data_out = output;
+    }
+    ~StepBinding() {
+        task_.data_in_a = saved_in_;
+        task_.data_out = saved_out_;
+    }
+    StepBinding(const StepBinding&) = delete;
+    StepBinding& operator=(const StepBinding&) = delete;
+
+private:
+    VPU_Task& task_;
+    const void* saved_in_;
+    void* saved_out_;
+};
+
+// Size of each intermediate buffer: a CONVOLUTION's spectra are one R2C spectrum per
+// overlap-save block (a single N/2+1-value spectrum without filter taps).
+size_t intermediate_buffer_bytes(const VPU_Task& task) {
+    if (resolved_op(task) == TaskOp::CONVOLUTION && task.num_elements > 0) {
+        if (!task.conv_filter.empty()) {
+            return HAL::plan_overlap_save(task.num_elements, task.conv_filter.size()).spectra_doubles() * sizeof(double);
+        }
+        return HAL::fft_spectrum_doubles(task.num_elements) * sizeof(double);
+    }
+    return 0; // Other plans keep their intermediates in typed objects (e.g. the sparse encodings)
+}
+
+} // namespace
+
+Cerebellum::Cerebellum(std::shared_ptr<HAL::KernelLibrary> kernel_lib, std::shared_ptr<const HAL::DeviceTable> devices)
+    : kernel_lib_(kernel_lib), devices_(std::move(devices)) {
+     if (!kernel_lib_) {
+        throw std::runtime_error("Cerebellum's KernelLibrary cannot be null.");
+    }
+}
+
+bool Cerebellum::run_on_device(const HAL::DeviceTable::Snapshot& devices, const ExecutionStep& step, HAL::OpId op,
+                               VPU_Task& task, HAL::KernelFluxReport& report) {
+    if (!devices || step.device >= devices->size()) {
+        VPU_LOG_ERROR("  -> [Cerebellum ERROR] Step targets unknown device " << step.device << "; running it on the host.");
+        return false;
+    }
+    HAL::Device& device = *(*devices)[step.device].device;
+    if (device.available() && device.run(op, task, report)) {
+        VPU_LOG_DEBUG("  -> [Cerebellum] Ran " << step.operation_name << " on device '" << device.substrate() << "'.");
+        return true;
+    }
+    VPU_LOG_DEBUG("  -> [Cerebellum] Device '" << device.substrate() << "' could not run " << step.operation_name
+              << "; falling back to the host.");
+    return false;
+}
+
+// This function receives the final plan and executes it.
+ActualPerformanceRecord Cerebellum::execute(const ExecutionPlan& plan, VPU_Task& task, const EnrichedExecutionContext* context) {
+    VPU_LOG_DEBUG("[Pillar 4] Cerebellum: Beginning execution of plan '" << plan.chosen_path_name << "'.");
+    const HAL::KnownBufferStats known_input(context && context->profile ? context->profile->input_stats : HAL::BufferStats());
+    const void* const perceived_input = task.data_in_a; // What 'context' describes
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    // Scoped to this execution so concurrent executions never share a compiled kernel.
+    std::function<HAL::KernelFluxReport()> last_jit_compiled_kernel_; // JIT kernel is nullary
+    // Sparse encodings of A produced by DENSE_TO_CSR / DENSE_TO_BSR for the following SpMM step.
+    HAL::CsrMatrix converted_csr;
+    HAL::BsrMatrix converted_bsr;
+    // Operands quantized by QUANTIZE_<P> for the following reduced-precision step (B for GEMM only).
+    HAL::QuantizedTensor quantized_a;
+    HAL::QuantizedTensor quantized_b;
+
+    const HAL::DeviceTable::Snapshot devices = devices_ ? devices_->snapshot() : nullptr;
+    HAL::ScratchScope scratch; // Every intermediate below is released when the execution ends
+    PlanBuffers buffers(task, scratch, intermediate_buffer_bytes(task));
 
     uint64_t total_cycle_cost = 0;
     uint64_t total_hw_in_cost = 0;
     uint64_t total_hw_out_cost = 0;
     HAL::KernelFluxReport report_from_kernel;
 
+    // Meta-operations handled by the Cerebellum itself rather than the KernelLibrary.
+    static const HAL::OpId JIT_COMPILE_SAXPY_ID = HAL::intern_op("JIT_COMPILE_SAXPY");
+    static const HAL::OpId EXECUTE_JIT_SAXPY_ID = HAL::intern_op("EXECUTE_JIT_SAXPY");
+    static const HAL::OpId DENSE_TO_CSR_ID = HAL::intern_op("DENSE_TO_CSR");
+    static const HAL::OpId DENSE_TO_BSR_ID = HAL::intern_op("DENSE_TO_BSR");
+    static const HAL::OpId SPMM_CSR_ID = HAL::intern_op("SPMM_CSR");
+    static const HAL::OpId SPMM_BSR_ID = HAL::intern_op("SPMM_BSR");
+    // Run reduced-precision steps at full precision when QUANTIZE_<P> found the operands out of range.
+    static const HAL::OpId SAXPY_STANDARD_ID = HAL::intern_op("SAXPY_STANDARD");
+    static const HAL::OpId GEMM_BLOCKED_ID = HAL::intern_op("GEMM_BLOCKED");
+
+    ActualPerformanceRecord result_record;
+    result_record.step_latencies.reserve(plan.steps.size());
+
     for (const auto& step : plan.steps) {
-        std::cout << "  -> Dispatching Step: " << step.operation_name << std::endl;
+        VPU_LOG_DEBUG("  -> Dispatching Step: " << step.operation_name);
+        const auto step_start = std::chrono::high_resolution_clock::now();
+        bool offloaded = false;
+        // Bind the step's buffers; intermediates are acquired the first time a step names them.
+        StepBinding binding(task, buffers.get(step.input_buffer_id), buffers.get(step.output_buffer_id));
         report_from_kernel = {0,0,0}; // Reset report for steps that don't generate one (e.g. JIT_COMPILE)
-
-        if (step.operation_name == "JIT_COMPILE_SAXPY") {
-            std::cout << "  -> [Cerebellum] Requesting JIT compilation for SAXPY..." << std::endl;
-            last_jit_compiled_kernel_ = jit_engine_.compile_saxpy_for_data(task);
+        // Plans from Pillar 3 carry resolved IDs; hand-built plans fall back to a name lookup.
+        const HAL::OpId op = step.op_id != HAL::INVALID_OP_ID ? step.op_id
+                                                               : HAL::OperationRegistry::instance().find(step.operation_name);
+
+        if (op == JIT_COMPILE_SAXPY_ID) {
+            VPU_LOG_DEBUG("  -> [Cerebellum] Requesting JIT compilation for SAXPY...");
+            // Reuse the specialization built at perceive while the step still reads that input.
+            const HAL::SaxpySpecialization* spec =
+                context && task.data_in_a == perceived_input ? context->saxpy_specialization.get() : nullptr;
+            last_jit_compiled_kernel_ = jit_engine_.compile_saxpy_for_data(task, spec);
             // JIT compilation step itself doesn't return a flux report in this context.
             // The cost of JIT compilation could be tracked separately if needed.
-        } else if (step.operation_name == "EXECUTE_JIT_SAXPY") {
+        } else if (op == EXECUTE_JIT_SAXPY_ID) {
             if (last_jit_compiled_kernel_) {
-                std::cout << "  -> [Cerebellum] Executing JIT-compiled SAXPY kernel..." << std::endl;
+                VPU_LOG_DEBUG("  -> [Cerebellum] Executing JIT-compiled SAXPY kernel...");
                 report_from_kernel = last_jit_compiled_kernel_(); // JIT kernel now returns a report
             } else {
-                std::cerr << "  -> [Cerebellum ERROR] EXECUTE_JIT_SAXPY called but no JIT kernel was compiled!" << std::endl;
+                VPU_LOG_ERROR("  -> [Cerebellum ERROR] EXECUTE_JIT_SAXPY called but no JIT kernel was compiled!");
                 throw std::runtime_error("EXECUTE_JIT_SAXPY called without a compiled JIT kernel.");
             }
-        } else if (kernel_lib_->count(step.operation_name)) {
-            auto kernel_func = kernel_lib_->at(step.operation_name); // Type is std::function<KernelFluxReport(VPU_Task& task)>
-            report_from_kernel = kernel_func(task); // Standard kernels now pass the task
+        } else if (op == DENSE_TO_CSR_ID) {
+            report_from_kernel = convert_dense_a(task, &converted_csr, nullptr, 0);
+        } else if (op == DENSE_TO_BSR_ID) {
+            report_from_kernel = convert_dense_a(task, nullptr, &converted_bsr, HAL::BSR_BLOCK_SIZE);
+        } else if (op == SPMM_CSR_ID) {
+            // Prefer the caller's pre-encoded operand; otherwise use this plan's conversion.
+            if (!task.sparse_a.empty()) {
+                if (!HAL::validate_csr(task.sparse_a)) {
+                    throw std::runtime_error("VPU_Task::sparse_a is not a valid CSR matrix.");
+                }
+                report_from_kernel = run_spmm(task, &task.sparse_a, nullptr);
+            } else if (!converted_csr.row_ptr.empty()) {
+                const HAL::CsrView csr_view = converted_csr.view();
+                report_from_kernel = run_spmm(task, &csr_view, nullptr);
+            } else {
+                throw std::runtime_error("SPMM_CSR called without a CSR operand.");
+            }
+        } else if (op == SPMM_BSR_ID) {
+            if (converted_bsr.block_row_ptr.empty()) {
+                throw std::runtime_error("SPMM_BSR called without a BSR operand.");
+            }
+            report_from_kernel = run_spmm(task, nullptr, &converted_bsr);
+        } else if (const QuantizedOps* quantized = find_quantized_ops(op)) {
+            const bool gemm = op == quantized->gemm;
+            if (op == quantized->quantize) {
+                report_from_kernel = quantize_operands(task, quantized->type, quantized_a, quantized_b);
+            } else if (!quantized_a.empty()) {
+                report_from_kernel = run_quantized(task, gemm, quantized_a, quantized_b);
+            } else if (const HAL::GenericKernel* full_precision = kernel_lib_->find(gemm ? GEMM_BLOCKED_ID : SAXPY_STANDARD_ID)) {
+                report_from_kernel = (*full_precision)(task);
+            } else {
+                throw std::runtime_error(step.operation_name + " has no quantized operands and no full-precision kernel.");
+            }
+        } else if (step.device != HAL::HOST_DEVICE && run_on_device(devices, step, op, task, report_from_kernel)) {
+            // Offloaded: the device staged the task's buffers and wrote data_out itself.
+            offloaded = true;
+        } else if (const HAL::GenericKernel* kernel_func = kernel_lib_->find(op)) { // std::function<KernelFluxReport(VPU_Task& task)>
+            report_from_kernel = (*kernel_func)(task); // Standard kernels now pass the task
         } else {
             throw std::runtime_error("Kernel not found in library: " + step.operation_name);
         }
@@ -68,38 +364,80 @@ ActualPerformanceRecord Cerebellum::execute(const ExecutionPlan& plan, VPU_Task&
         total_cycle_cost += report_from_kernel.cycle_cost;
         total_hw_in_cost += report_from_kernel.hw_in_cost;
         total_hw_out_cost += report_from_kernel.hw_out_cost;
+
+        // Timed under the belief key the step was priced with, so Pillar 5 learns per operation.
+        const std::chrono::duration<double, std::nano> step_ns = std::chrono::high_resolution_clock::now() - step_start;
+        const HAL::OpId priced_op = (offloaded && step.cost_id != HAL::INVALID_OP_ID) ? step.cost_id : op;
+        result_record.step_latencies.push_back({priced_op, step_ns.count()});
     }
 
     auto end_time = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double, std::nano> latency_ns_duration = end_time - start_time;
 
-    ActualPerformanceRecord result_record;
     result_record.observed_latency_ns = latency_ns_duration.count();
     result_record.observed_cycle_cost = total_cycle_cost;
     result_record.observed_hw_in_cost = total_hw_in_cost;
     result_record.observed_hw_out_cost = total_hw_out_cost;
     result_record.observed_holistic_flux = static_cast<double>(total_cycle_cost + total_hw_in_cost + total_hw_out_cost);
 
-    std::cout << "  ==> Execution Complete. Observed Latency (ns): " << result_record.observed_latency_ns << std::endl;
-    std::cout << "      Cycle Cost: " << result_record.observed_cycle_cost
+    VPU_LOG_DEBUG("  ==> Execution Complete. Observed Latency (ns): " << result_record.observed_latency_ns);
+    VPU_LOG_DEBUG("      Cycle Cost: " << result_record.observed_cycle_cost
               << ", HW IN Cost: " << result_record.observed_hw_in_cost
-              << ", HW OUT Cost: " << result_record.observed_hw_out_cost << std::endl;
-    std::cout << "      Holistic Flux: " << result_record.observed_holistic_flux << std::endl;
+              << ", HW OUT Cost: " << result_record.observed_hw_out_cost);
+    VPU_LOG_DEBUG("      Holistic Flux: " << result_record.observed_holistic_flux);
 
     return result_record;
 }
 
+ActualPerformanceRecord Cerebellum::execute_stream(const ExecutionPlan& plan, StreamSession& stream,
+                                                   const ChunkObserver& on_chunk) {
+    VPU_LOG_DEBUG("[Pillar 4] Cerebellum: Streaming plan '" << plan.chosen_path_name << "' over " << stream.chunks()
+              << " chunks (" << stream.rows() << " rows).");
+    const auto start_time = std::chrono::high_resolution_clock::now();
+    ActualPerformanceRecord total;
+    stream.prefetch(0);
+    for (size_t c = 0; c < stream.chunks(); ++c) {
+        stream.prefetch(c + 1); // Read ahead while this chunk computes
+        VPU_Task chunk = stream.chunk_task(c);
+        if (on_chunk) {
+            on_chunk(stream.fresh_input(c));
+        }
+        ActualPerformanceRecord record;
+        {
+            StreamSession::ChunkScope scope(stream, c);
+            record = execute(plan, chunk);
+        }
+
+        total.observed_cycle_cost += record.observed_cycle_cost;
+        total.observed_hw_in_cost += record.observed_hw_in_cost;
+        total.observed_hw_out_cost += record.observed_hw_out_cost;
+        if (total.step_latencies.empty()) {
+            total.step_latencies = record.step_latencies;
+        } else {
+            for (size_t i = 0; i < record.step_latencies.size() && i < total.step_latencies.size(); ++i) {
+                total.step_latencies[i].latency_ns += record.step_latencies[i].latency_ns;
+            }
+        }
+    }
+    const std::chrono::duration<double, std::nano> latency = std::chrono::high_resolution_clock::now() - start_time;
+    total.observed_latency_ns = latency.count();
+    total.observed_holistic_flux =
+        static_cast<double>(total.observed_cycle_cost + total.observed_hw_in_cost + total.observed_hw_out_cost);
+    VPU_LOG_DEBUG("  ==> Stream Complete. Observed Latency (ns): " << total.observed_latency_ns);
+    return total;
+}
+
 // FluxJITEngine Implementation
 FluxJITEngine::FluxJITEngine() : use_llm_for_jit_(false) {}
 
 void FluxJITEngine::set_llm_jit_generation(bool enable) {
     use_llm_for_jit_ = enable;
-    std::cout << "    -> [JIT Engine] LLM JIT generation " << (enable ? "enabled." : "disabled.") << std::endl;
+    VPU_LOG_INFO("    -> [JIT Engine] LLM JIT generation " << (enable ? "enabled." : "disabled."));
 }
 
 // Return type is now std::function<HAL::KernelFluxReport()>
 std::function<HAL::KernelFluxReport()> FluxJITEngine::generate_kernel_with_llm(const VPU_Task& task) {
-    std::cout << "    -> [JIT Engine] LLM JIT kernel generation called for task: " << task.task_type << std::endl;
+    VPU_LOG_DEBUG("    -> [JIT Engine] LLM JIT kernel generation called for task: " << task.task_type);
     // In a real scenario, this would involve:
     // 1. Formatting the task details (data profile, operation type, constraints) into a prompt.
     // 2. Sending the prompt to a code-generation LLM.
@@ -110,104 +448,97 @@ std::function<HAL::KernelFluxReport()> FluxJITEngine::generate_kernel_with_llm(c
     return nullptr;
 }
 
-// Conceptual JIT engine logic
+HAL::SaxpySpecialization FluxJITEngine::specialization_for(const VPU_Task& task, double x_zero_ratio) {
+    return HAL::specialize_saxpy(task.alpha, static_cast<const float*>(task.data_in_a), static_cast<const float*>(task.data_out),
+                                 task.num_elements, x_zero_ratio > SPARSE_KERNEL_THRESHOLD);
+}
+
+std::shared_ptr<const HAL::SaxpySpecialization> FluxJITEngine::specialize(const VPU_Task& task, double x_zero_ratio) const {
+    if (use_llm_for_jit_ || !task.data_in_a || !task.data_out || task.num_elements == 0) {
+        return nullptr;
+    }
+    return std::make_shared<const HAL::SaxpySpecialization>(specialization_for(task, x_zero_ratio));
+}
+
+bool FluxJITEngine::has_cached_saxpy_kernel(const HAL::SaxpySpecialization& spec) const {
+    return HAL::SaxpyKernelCache::instance().contains(spec);
+}
+
+bool FluxJITEngine::has_cached_saxpy_kernel(const VPU_Task& task, double x_zero_ratio) const {
+    const auto spec = specialize(task, x_zero_ratio);
+    return spec && has_cached_saxpy_kernel(*spec);
+}
+
 // Return type is now std::function<HAL::KernelFluxReport()>
-std::function<HAL::KernelFluxReport()> FluxJITEngine::compile_saxpy_for_data(VPU_Task& task) {
-    std::cout << "    -> [JIT Engine] SAXPY compilation request for task_type: " << task.task_type << std::endl;
+std::function<HAL::KernelFluxReport()> FluxJITEngine::compile_saxpy_for_data(VPU_Task& task,
+                                                                              const HAL::SaxpySpecialization* spec) {
+    VPU_LOG_DEBUG("    -> [JIT Engine] SAXPY compilation request for task_type: " << task.task_type);
 
     if (use_llm_for_jit_) {
-        std::cout << "    -> [JIT Engine] Attempting LLM-based JIT generation..." << std::endl;
+        VPU_LOG_DEBUG("    -> [JIT Engine] Attempting LLM-based JIT generation...");
         // llm_kernel is now std::function<HAL::KernelFluxReport()>
         std::function<HAL::KernelFluxReport()> llm_kernel = generate_kernel_with_llm(task);
         if (llm_kernel) { // Check if a valid function was returned
-            std::cout << "    -> [JIT Engine] LLM JIT generation successful (conceptually)." << std::endl;
+            VPU_LOG_DEBUG("    -> [JIT Engine] LLM JIT generation successful (conceptually).");
             return llm_kernel;
         } else {
-            std::cout << "    -> [JIT Engine] LLM JIT generation failed or not applicable/stubbed, falling back to traditional JIT." << std::endl;
+            VPU_LOG_DEBUG("    -> [JIT Engine] LLM JIT generation failed or not applicable/stubbed, falling back to traditional JIT.");
         }
     }
 
     const float* x_data = static_cast<const float*>(task.data_in_a);
-    float fixed_a = 1.0f; // Placeholder for SAXPY 'a' parameter from task if available
+    HAL::BufferStats x_stats = HAL::KnownBufferStats::current();
 
-    std::vector<float> x_vec_analysis; // For sparsity check
-    if (x_data && task.num_elements > 0) {
-       x_vec_analysis.assign(x_data, x_data + task.num_elements);
+    void* p_data_in_a = const_cast<void*>(task.data_in_a);
+    void* p_data_out = task.data_out;
+    size_t num_elements_captured = task.num_elements;
+    if (!p_data_in_a || !p_data_out || num_elements_captured == 0) {
+        VPU_LOG_WARN("JIT KERNEL (SAXPY): Invalid data pointers or zero elements.");
+        return []() -> HAL::KernelFluxReport { return {0, 0, 0}; }; // Zero flux report on error
     }
 
-    size_t zero_count = 0;
-    if (!x_vec_analysis.empty()) {
-        for (float val : x_vec_analysis) {
-            if (val == 0.0f) zero_count++;
+    // Specialize on alpha, length, alignment and (for sparse x) the non-zero pattern; an
+    // identical specialization reuses the kernel generated for an earlier task.
+    HAL::SaxpySpecialization own_spec;
+    if (!spec || spec->length != num_elements_captured) {
+        // Sparsity check: reuse the Cortex's fused scan of 'x' when it covers exactly this buffer,
+        // otherwise scan the task's input now.
+        HAL::Span<const float> x_analysis = HAL::as_span<float>(x_data, num_elements_captured);
+        if (!x_stats.describes(x_analysis.data(), x_analysis.size_bytes()) || x_stats.type != HAL::ElementType::FLOAT32) {
+            x_stats = HAL::compute_buffer_stats(x_analysis.data(), x_analysis.size_bytes(), HAL::ElementType::FLOAT32);
         }
+        VPU_LOG_DEBUG("    -> [JIT Engine] Data sparsity for input 'x': " << x_stats.zero_ratio());
+        own_spec = specialization_for(task, x_stats.zero_ratio()); // Fully sparse (1.0) if empty
+        spec = &own_spec;
     }
-    // Ensure num_elements is not zero to avoid division by zero if x_vec_analysis is empty due to num_elements being 0.
-    double sparsity_ratio = x_vec_analysis.empty() ? 1.0 : static_cast<double>(zero_count) / x_vec_analysis.size(); // Default to fully sparse if empty
-    std::cout << "    -> [JIT Engine] Data sparsity for input 'x': " << sparsity_ratio << std::endl;
-
-    void* p_data_in_a = const_cast<void*>(task.data_in_a);
-    void* p_data_out = task.data_out;
-    size_t num_elements_captured = task.num_elements;
+    HAL::SaxpyKernelCache& cache = HAL::SaxpyKernelCache::instance();
+    const bool cached = cache.contains(*spec);
+    std::shared_ptr<const HAL::CompiledSaxpyKernel> kernel = cache.get_or_compile(*spec);
+    VPU_LOG_DEBUG("    -> [JIT Engine] " << (cached ? "Kernel cache hit: '" : "Generated kernel '") << kernel->name() << "'.");
 
     // This lambda captures necessary variables and performs the SAXPY operation,
     // then calculates and returns the KernelFluxReport.
-    auto saxpy_execution_lambda =
-        [fixed_a, p_data_in_a, p_data_out, num_elements_captured](bool use_sparse_specialization) -> HAL::KernelFluxReport {
-
-        if (!p_data_in_a || !p_data_out || num_elements_captured == 0) {
-            std::cerr << "JIT KERNEL (SAXPY): Invalid data pointers or zero elements." << std::endl;
-            return {0, 0, 0}; // Return zero flux report on error
-        }
-
-        const float* x_ptr = static_cast<const float*>(p_data_in_a);
-        float* y_ptr = static_cast<float*>(p_data_out);
-
-        // Create std::vector copies to pass to existing HAL functions.
-        // This is for compatibility with HAL functions expecting vectors.
-        // A more optimized JIT might work directly with pointers or have specialized data structures.
-        std::vector<float> x_temp_vec(x_ptr, x_ptr + num_elements_captured);
-        std::vector<float> y_temp_vec(y_ptr, y_ptr + num_elements_captured); // y is input/output for SAXPY
+    return [kernel, p_data_in_a, p_data_out, num_elements_captured, x_stats]() -> HAL::KernelFluxReport {
+        // Operate on the task's buffers directly: y is updated in place.
+        HAL::Span<const float> x = HAL::as_span<float>(p_data_in_a, num_elements_captured);
+        HAL::Span<float> y = HAL::as_mutable_span<float>(p_data_out, num_elements_captured);
 
         HAL::KernelFluxReport report;
 
         // Calculate hw_in_cost: Hamming weight of input vector x and initial state of y
-        report.hw_in_cost = HAL::calculate_data_hamming_weight(x_temp_vec.data(), x_temp_vec.size() * sizeof(float));
-        report.hw_in_cost += HAL::calculate_data_hamming_weight(y_temp_vec.data(), y_temp_vec.size() * sizeof(float)); // y's initial state
-
-        // Execute the appropriate SAXPY kernel
-        if (use_sparse_specialization) {
-            HAL::cpu_saxpy_sparse_specialized(fixed_a, x_temp_vec, y_temp_vec);
-        } else {
-            HAL::cpu_saxpy_dense_specialized(fixed_a, x_temp_vec, y_temp_vec);
-        }
+        report.hw_in_cost = HAL::hamming_weight_reusing(x_stats, x.data(), x.size_bytes());
+        report.hw_in_cost += HAL::calculate_data_hamming_weight(y.data(), y.size_bytes()); // y's initial state
 
-        // Copy the result from the temporary y_temp_vec back to the original memory location p_data_out
-        for(size_t i = 0; i < num_elements_captured; ++i) {
-            y_ptr[i] = y_temp_vec[i];
-        }
+        kernel->run(x.data(), y.data());
 
         // Calculate hw_out_cost: Hamming weight of the output vector y (after computation)
-        report.hw_out_cost = HAL::calculate_data_hamming_weight(y_temp_vec.data(), y_temp_vec.size() * sizeof(float));
+        report.hw_out_cost = HAL::calculate_data_hamming_weight(y.data(), y.size_bytes());
 
-        // Estimate cycle_cost: For SAXPY, operations are num_elements * (1 multiply + 1 add)
-        report.cycle_cost = num_elements_captured * 2;
+        // Estimate cycle_cost: 1 multiply + 1 add per element the kernel visits (only the non-zeros if sparse)
+        report.cycle_cost = kernel->work_elements() * 2;
 
         return report;
     };
-
-    if (sparsity_ratio > 0.5) {
-        std::cout << "    -> [JIT Engine] Data is sparse. Providing 'SPARSE SAXPY' wrapper." << std::endl;
-        // Return a lambda that calls saxpy_execution_lambda with use_sparse_specialization = true
-        return [saxpy_execution_lambda]() -> HAL::KernelFluxReport {
-            return saxpy_execution_lambda(true);
-        };
-    } else {
-        std::cout << "    -> [JIT Engine] Data is dense. Providing 'DENSE SAXPY' wrapper." << std::endl;
-        // Return a lambda that calls saxpy_execution_lambda with use_sparse_specialization = false
-        return [saxpy_execution_lambda]() -> HAL::KernelFluxReport {
-            return saxpy_execution_lambda(false);
-        };
-    }
 }
 
 
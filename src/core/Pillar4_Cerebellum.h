@@ -2,26 +2,46 @@
 
 #include "vpu_data_structures.h"
 #include "hal/hal.h"
+#include "hal/saxpy_jit.h" // For the generated kernels and their cache
+#include "hal/device.h"    // For device-targeted steps
 #include "vpu.h" // Added: For VPU_Task definition
+#include "core/TaskStream.h" // For StreamSession
 #include <vector>
 #include <functional> // For std::function (HAL::GenericKernel)
 
 namespace VPU {
 
-// CONCEPTUAL JIT ENGINE
-// In a real system, this would be a complex class using LLVM.
-// Here, it's a conceptual placeholder demonstrating the "build a new tool" trade-off.
+// JIT ENGINE
+// Generates SAXPY kernels specialized on alpha, length, alignment and x's sparsity pattern
+// (HAL::CompiledSaxpyKernel), and keeps them in HAL::SaxpyKernelCache so each specialization
+// is only compiled once: the "build a new tool" trade-off is paid once per shape of data.
 class FluxJITEngine {
 public:
     FluxJITEngine(); // Added constructor
-    // This function decides if generating a custom kernel is worthwhile.
+    // Returns the kernel for this task's data, from the cache or freshly generated.
     // JIT kernels are fully specialized and capture their data, so they are nullary.
-    std::function<HAL::KernelFluxReport()> compile_saxpy_for_data(VPU_Task& task);
+    // 'spec' (optional) is specialize(task, ...) computed earlier; without it x is scanned again.
+    std::function<HAL::KernelFluxReport()> compile_saxpy_for_data(VPU_Task& task,
+                                                                   const HAL::SaxpySpecialization* spec = nullptr);
+
+    // The specialization compile_saxpy_for_data(task) would generate, given the zero ratio of
+    // x (e.g. from the task's DataProfile); null if it would not generate one (LLM generation,
+    // missing buffers). Scans x, so build it once per task and pass it on.
+    std::shared_ptr<const HAL::SaxpySpecialization> specialize(const VPU_Task& task, double x_zero_ratio) const;
+
+    // True if compile_saxpy_for_data would be a cache hit. Lets Pillar 3 price the compile step.
+    bool has_cached_saxpy_kernel(const HAL::SaxpySpecialization& spec) const;
+    bool has_cached_saxpy_kernel(const VPU_Task& task, double x_zero_ratio) const;
+
+    // x is treated as sparse (only its non-zeros are visited) above this zero ratio.
+    static constexpr double SPARSE_KERNEL_THRESHOLD = 0.5;
 
     // Method to enable/disable LLM usage for JIT
     void set_llm_jit_generation(bool enable);
 
 private:
+    static HAL::SaxpySpecialization specialization_for(const VPU_Task& task, double x_zero_ratio);
+
     // (Conceptual) Method to generate kernel with LLM
     // Also returns a nullary, fully specialized JIT kernel.
     std::function<HAL::KernelFluxReport()> generate_kernel_with_llm(const VPU_Task& task);
@@ -33,16 +53,42 @@ private:
 // The Cerebellum is the engine of action. It takes a plan and makes it reality.
 class Cerebellum {
 public:
-    explicit Cerebellum(std::shared_ptr<HAL::KernelLibrary> kernel_lib);
-    ActualPerformanceRecord execute(const ExecutionPlan& plan, VPU_Task& task);
+    // Steps targeted at a device run there when 'devices' has it and it is available;
+    // otherwise (or if the device fails) they run on the host.
+    explicit Cerebellum(std::shared_ptr<HAL::KernelLibrary> kernel_lib,
+                        std::shared_ptr<const HAL::DeviceTable> devices = nullptr);
+    // 'context' (optional) is what Pillar 2 found: kernels reuse its scan of the task input
+    // (published to them through HAL::KnownBufferStats) instead of reading the input again.
+    ActualPerformanceRecord execute(const ExecutionPlan& plan, VPU_Task& task, const EnrichedExecutionContext* context = nullptr);
+
+    // Runs 'plan' on every chunk of an open stream in order, prefetching chunk c + 1 while chunk
+    // c executes and releasing each chunk once it has run. 'on_chunk' (optional) sees the input
+    // each chunk adds before it runs. The record totals every chunk's costs and step latencies.
+    using ChunkObserver = std::function<void(HAL::Span<const uint8_t> fresh_input)>;
+    ActualPerformanceRecord execute_stream(const ExecutionPlan& plan, StreamSession& stream,
+                                           const ChunkObserver& on_chunk = nullptr);
+
+    std::shared_ptr<const HAL::SaxpySpecialization> specialize_jit_kernel(const VPU_Task& task, double x_zero_ratio) const {
+        return jit_engine_.specialize(task, x_zero_ratio);
+    }
+    bool has_cached_jit_kernel(const HAL::SaxpySpecialization& spec) const {
+        return jit_engine_.has_cached_saxpy_kernel(spec);
+    }
+    bool has_cached_jit_kernel(const VPU_Task& task, double x_zero_ratio) const {
+        return jit_engine_.has_cached_saxpy_kernel(task, x_zero_ratio);
+    }
 
     // Test helper to access JIT engine
     FluxJITEngine* get_jit_engine_for_testing() { return &jit_engine_; }
 
 private:
+    // True if the step ran on its device (filling 'report'); false means run it on the host.
+    bool run_on_device(const HAL::DeviceTable::Snapshot& devices, const ExecutionStep& step, HAL::OpId op,
+                       VPU_Task& task, HAL::KernelFluxReport& report);
+
     std::shared_ptr<HAL::KernelLibrary> kernel_lib_; // Stores std::function<KernelFluxReport(VPU_Task& task)>
+    std::shared_ptr<const HAL::DeviceTable> devices_; // May be null: everything runs on the host
     FluxJITEngine jit_engine_;
-    std::function<HAL::KernelFluxReport()> last_jit_compiled_kernel_; // JIT kernel is nullary
 };
 
 } // namespace VPU
@@ -1,13 +1,39 @@
 #include "core/Pillar5_Feedback.h"
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <algorithm> // For std::max
 #include <cmath>
 #include <iomanip>
-#include <iostream>
 #include <stdexcept> // Required for std::runtime_error
-#include <random>    // For std::random_device for seeding
+#include <unordered_map>
 
 namespace VPU {
 
-FeedbackLoop::FeedbackLoop(std::shared_ptr<HardwareProfile> hw_profile,
+namespace {
+
+std::atomic<uint64_t> g_next_loop_id{1}; // Never reused, so a new loop cannot inherit a destroyed one's batches
+
+// The context's interned key, or its name resolved through the registry for hand-built contexts.
+HAL::OpId resolve_key(HAL::OpId id, const std::string& name) {
+    if (id != HAL::INVALID_OP_ID || name.empty()) {
+        return id;
+    }
+    return HAL::OperationRegistry::instance().find(name);
+}
+
+} // namespace
+
+struct FeedbackLoop::LatencyBatch {
+    std::vector<LatencyStats> by_op; // Indexed by OpId; Welford sums only
+    size_t tasks = 0;
+};
+
+// Only the owning thread adds to 'batch'; the mutex is there for flushes from other threads.
+struct FeedbackLoop::ThreadLatencyBatch {
+    std::mutex mutex;
+    LatencyBatch batch;
+};
+
+FeedbackLoop::FeedbackLoop(std::shared_ptr<HardwareProfileStore> hw_profile,
                            double quark_threshold,
                            double learning_rate,
                            double learning_rate_base_cost,
@@ -16,44 +42,154 @@ FeedbackLoop::FeedbackLoop(std::shared_ptr<HardwareProfile> hw_profile,
   QUARK_THRESHOLD(quark_threshold),
   LEARNING_RATE(learning_rate),
   LEARNING_RATE_BASE_COST(learning_rate_base_cost),
-  exploration_rate_(exploration_rate),
-  distribution_(0.0, 1.0) // Initialize distribution
+  explorer_(PlanExplorer::Options{exploration_rate}),
+  publish_batch_size_(DEFAULT_PUBLISH_BATCH_SIZE),
+  loop_id_(g_next_loop_id.fetch_add(1, std::memory_order_relaxed)),
+  latency_batch_size_(DEFAULT_LATENCY_BATCH_SIZE)
 {
     if (!hw_profile_) {
         throw std::runtime_error("FeedbackLoop's HardwareProfile cannot be null.");
     }
-    // Seed the random number generator
-    random_generator_.seed(std::random_device{}());
-    std::cout << "[Pillar 5] FeedbackLoop initialized with exploration rate: " << exploration_rate_ * 100 << "%." << std::endl;
-    }
+    VPU_LOG_INFO("[Pillar 5] FeedbackLoop initialized with exploration rate: " << explorer_.options().budget * 100 << "%.");
 }
 
 // This is the core learning function.
+// Updates are staged on a private copy of the beliefs and published as a new version in batches,
+// so planners reading the current snapshot never observe a half-applied update.
 void FeedbackLoop::learn_from_feedback(const LearningContext& context, double predicted_flux, const ActualPerformanceRecord& record) {
-    std::cout << "[Pillar 5] Hippocampus: Analyzing feedback..." << std::endl;
-    std::cout << "  -> Predicted Flux: " << predicted_flux << ", Observed Flux: " << record.observed_holistic_flux << std::endl;
+    hw_profile_->stage([&](HardwareProfile& beliefs) { apply_feedback(beliefs, context, predicted_flux, record); });
+    if (++updates_since_publish_ >= publish_batch_size_) {
+        publish_pending_beliefs();
+    }
+}
+
+// Step latencies are summed per thread and merged every latency_batch_size_ tasks, so the
+// shared beliefs see one Welford/EWMA combine per operation per batch instead of one per task.
+void FeedbackLoop::record_step_latencies(const ActualPerformanceRecord& record) {
+    if (record.step_latencies.empty()) {
+        return;
+    }
+    ThreadLatencyBatch& owned = thread_latency_batch();
+    std::vector<LatencyBatch> full;
+    {
+        std::lock_guard<std::mutex> lock(owned.mutex);
+        LatencyBatch& batch = owned.batch;
+        for (const StepLatency& step : record.step_latencies) {
+            if (step.op == HAL::INVALID_OP_ID) continue;
+            if (step.op >= batch.by_op.size()) {
+                batch.by_op.resize(static_cast<size_t>(step.op) + 1);
+            }
+            batch.by_op[step.op].add(step.latency_ns);
+        }
+        if (++batch.tasks < latency_batch_size_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        full.push_back(std::move(batch));
+        batch = LatencyBatch();
+    }
+    merge_latency_batches(full);
+}
+
+FeedbackLoop::ThreadLatencyBatch& FeedbackLoop::thread_latency_batch() {
+    // By loop_id_, never reused, so a new loop cannot inherit a destroyed one's batch.
+    thread_local std::unordered_map<uint64_t, std::shared_ptr<ThreadLatencyBatch>> batches;
+    std::shared_ptr<ThreadLatencyBatch>& owned = batches[loop_id_];
+    if (!owned) {
+        owned = std::make_shared<ThreadLatencyBatch>();
+        std::lock_guard<std::mutex> lock(latency_batches_mutex_);
+        latency_batches_.push_back(owned);
+    }
+    return *owned;
+}
+
+uint64_t FeedbackLoop::publish_pending_beliefs() {
+    updates_since_publish_ = 0;
+    uint64_t version = hw_profile_->publish();
+    return version;
+}
+
+void FeedbackLoop::set_publish_batch_size(size_t batch_size) {
+    publish_batch_size_ = batch_size == 0 ? 1 : batch_size;
+}
+
+void FeedbackLoop::set_latency_batch_size(size_t batch_size) {
+    latency_batch_size_.store(batch_size == 0 ? 1 : batch_size, std::memory_order_relaxed);
+}
+
+uint64_t FeedbackLoop::flush_latency_statistics() {
+    std::vector<LatencyBatch> pending;
+    {
+        std::lock_guard<std::mutex> registry_lock(latency_batches_mutex_);
+        for (auto it = latency_batches_.begin(); it != latency_batches_.end();) {
+            {
+                std::lock_guard<std::mutex> lock((*it)->mutex);
+                if ((*it)->batch.tasks != 0) {
+                    pending.push_back(std::move((*it)->batch));
+                    (*it)->batch = LatencyBatch();
+                }
+            }
+            // Only the registry still holds the batch of a thread that has exited.
+            it = it->use_count() == 1 ? latency_batches_.erase(it) : it + 1;
+        }
+    }
+    merge_latency_batches(pending);
+    return hw_profile_->version();
+}
+
+void FeedbackLoop::merge_latency_batches(const std::vector<LatencyBatch>& batches) {
+    bool any_samples = false;
+    for (const LatencyBatch& batch : batches) {
+        for (const LatencyStats& stats : batch.by_op) any_samples |= stats.samples != 0;
+    }
+    if (!any_samples) {
+        return;
+    }
+    hw_profile_->stage([&](HardwareProfile& beliefs) {
+        for (const LatencyBatch& batch : batches) {
+            for (size_t id = 0; id < batch.by_op.size(); ++id) {
+                if (batch.by_op[id].samples == 0) continue;
+                LatencyStats& stats = beliefs.latency[static_cast<HAL::OpId>(id)];
+                stats.merge(batch.by_op[id], LATENCY_EWMA_WEIGHT);
+                VPU_LOG_TRACE("    -> Latency of '" << HAL::OperationRegistry::instance().name(static_cast<HAL::OpId>(id))
+                              << "': " << batch.by_op[id].samples << " sample(s), EWMA " << stats.ewma_ns << " ns over "
+                              << stats.samples << ".");
+            }
+            VPU_LOG_DEBUG("[Pillar 5] Hippocampus: Merged " << batch.tasks << " task(s) of step latencies.");
+        }
+    });
+    hw_profile_->publish();
+}
+
+void FeedbackLoop::apply_feedback(HardwareProfile& beliefs, const LearningContext& context, double predicted_flux, const ActualPerformanceRecord& record) {
+    VPU_LOG_DEBUG("[Pillar 5] Hippocampus: Analyzing feedback...");
+    VPU_LOG_DEBUG("  -> Predicted Flux: " << predicted_flux << ", Observed Flux: " << record.observed_holistic_flux);
+
+    const HAL::OpId transform_id = resolve_key(context.transform_id, context.transform_key);
+    const HAL::OpId operation_id = resolve_key(context.operation_id, context.operation_key);
+    const HAL::OpId main_operation_id = resolve_key(context.main_operation_id, context.main_operation_name);
+    const HAL::OpId hw_sensitivity_id = resolve_key(context.hw_sensitivity_id, context.hw_sensitivity_key);
 
     if (predicted_flux == 0 && record.observed_holistic_flux == 0) { // Both zero, no deviation
-        std::cout << "  ==> Result: Predicted and Observed flux are both zero. Beliefs are stable." << std::endl;
+        VPU_LOG_DEBUG("  ==> Result: Predicted and Observed flux are both zero. Beliefs are stable.");
         return;
     }
     if (predicted_flux == 0 && record.observed_holistic_flux != 0) { // Predicted zero, but there was a cost
-        std::cout << "  ==> Result: **FLUX QUARK DETECTED!** Predicted zero flux, but observed " << record.observed_holistic_flux << ". Updating beliefs." << std::endl;
+        VPU_LOG_DEBUG("  ==> Result: **FLUX QUARK DETECTED!** Predicted zero flux, but observed " << record.observed_holistic_flux << ". Updating beliefs.");
         // This case requires special handling as deviation would be infinite.
         // We'll directly adjust the belief based on the observed cost.
         // This heuristic assumes the 'operation_key' is the one to blame if 'transform_key' is empty.
-        if (!context.transform_key.empty() && hw_profile_->transform_costs.count(context.transform_key)) {
-             double& belief = hw_profile_->transform_costs.at(context.transform_key);
+        if (double* transform_belief = beliefs.transform_costs.find(transform_id)) {
+             double& belief = *transform_belief;
              double old_belief = belief;
              belief = record.observed_holistic_flux; // Set to observed
-             std::cout << "    -> Updating transform cost '" << context.transform_key << "' (predicted zero): " << old_belief << " -> " << belief << std::endl;
-        } else if (!context.operation_key.empty() && hw_profile_->flux_sensitivities.count(context.operation_key)) {
-            double& lambda_belief = hw_profile_->flux_sensitivities.at(context.operation_key);
+             VPU_LOG_DEBUG("    -> Updating transform cost '" << context.transform_key << "' (predicted zero): " << old_belief << " -> " << belief);
+        } else if (double* sensitivity = beliefs.flux_sensitivities.find(operation_id)) {
+            double& lambda_belief = *sensitivity;
             double old_belief = lambda_belief;
             // If lambda was zero or very small, and we got a non-zero cost, it needs a significant bump.
             // This is a simple heuristic; a more robust system might use a default starting value or a portion of the observed cost.
             lambda_belief = std::max(lambda_belief, 0.01) + (record.observed_holistic_flux * LEARNING_RATE);
-            std::cout << "    -> Updating sensitivity '" << context.operation_key << "' (predicted zero): " << old_belief << " -> " << lambda_belief << std::endl;
+            VPU_LOG_DEBUG("    -> Updating sensitivity '" << context.operation_key << "' (predicted zero): " << old_belief << " -> " << lambda_belief);
         }
         return;
     }
@@ -62,63 +198,85 @@ void FeedbackLoop::learn_from_feedback(const LearningContext& context, double pr
     double deviation = (record.observed_holistic_flux - predicted_flux) / predicted_flux;
 
     if (std::abs(deviation) < QUARK_THRESHOLD) {
-        std::cout << "  ==> Result: Deviation (" << std::fixed << std::setprecision(2) << deviation * 100 << "%) is within threshold. Beliefs are stable." << std::endl;
+        VPU_LOG_DEBUG("  ==> Result: Deviation (" << std::fixed << std::setprecision(2) << deviation * 100 << "%) is within threshold. Beliefs are stable.");
         return;
     }
 
     // --- FLUX QUARK DETECTED ---
-    std::cout << "  ==> Result: **FLUX QUARK DETECTED!** Deviation is " << std::fixed << std::setprecision(2) << deviation * 100 << "%. Updating beliefs." << std::endl;
+    VPU_LOG_DEBUG("  ==> Result: **FLUX QUARK DETECTED!** Deviation is " << std::fixed << std::setprecision(2) << deviation * 100 << "%. Updating beliefs.");
 
     bool belief_updated = false;
     // 1. Try to update transform cost first
-    if (!context.transform_key.empty() && hw_profile_->transform_costs.count(context.transform_key)) {
-        double& belief = hw_profile_->transform_costs.at(context.transform_key);
+    if (double* transform_belief = beliefs.transform_costs.find(transform_id)) {
+        double& belief = *transform_belief;
         double old_belief = belief;
         // Simple update: adjust by a portion of the deviation in flux
         // (observed_holistic_flux - predicted_flux) is the total error.
         // A simple heuristic: this transform is responsible for this amount of error.
         belief += (record.observed_holistic_flux - predicted_flux) * LEARNING_RATE;
         if (belief < 1.0) belief = 1.0; // Ensure cost doesn't go below a very small positive number
-        std::cout << "    -> Updating transform cost '" << context.transform_key << "': " << old_belief << " -> " << belief << std::endl;
+        VPU_LOG_DEBUG("    -> Updating transform cost '" << context.transform_key << "': " << old_belief << " -> " << belief);
         belief_updated = true;
     }
 
     // 2. If not a transform error, or in addition, update base operational cost
-    if (!context.main_operation_name.empty() && hw_profile_->base_operational_costs.count(context.main_operation_name)) {
-        double& belief = hw_profile_->base_operational_costs.at(context.main_operation_name);
+    if (double* base_belief = beliefs.base_operational_costs.find(main_operation_id)) {
+        double& belief = *base_belief;
         double old_belief = belief;
         // Adjust base cost. The 'deviation' is overall percentage error.
         // Apply this percentage error (scaled by learning rate) to the current belief for this op.
         belief += belief * deviation * LEARNING_RATE_BASE_COST;
         if (belief < 1.0) belief = 1.0; // Ensure cost doesn't go too low
-        std::cout << "    -> Updating base operational cost '" << context.main_operation_name << "': " << old_belief << " -> " << belief << std::endl;
+        VPU_LOG_DEBUG("    -> Updating base operational cost '" << context.main_operation_name << "': " << old_belief << " -> " << belief);
         belief_updated = true;
     }
 
     // 3. Update flux sensitivity (lambda)
-    if (!context.operation_key.empty() && hw_profile_->flux_sensitivities.count(context.operation_key)) {
-        double& lambda_belief = hw_profile_->flux_sensitivities.at(context.operation_key);
+    if (double* sensitivity = beliefs.flux_sensitivities.find(operation_id)) {
+        double& lambda_belief = *sensitivity;
         double old_belief = lambda_belief;
         // Apply a simple reinforcement learning rule based on overall deviation
         lambda_belief *= (1.0 + (deviation * LEARNING_RATE));
         if (lambda_belief < 0) lambda_belief = 0; // Sensitivity shouldn't be negative
-        std::cout << "    -> Updating sensitivity '" << context.operation_key << "': " << old_belief << " -> " << lambda_belief << std::endl;
+        VPU_LOG_DEBUG("    -> Updating sensitivity '" << context.operation_key << "': " << old_belief << " -> " << lambda_belief);
         belief_updated = true;
     }
 
-    if (!belief_updated) {
-        std::cout << "    -> No specific belief component (transform, base op cost, or sensitivity) could be targeted for update based on context." << std::endl;
+    // 4. Update Hamming Weight sensitivity of the main operation
+    if (double* hw_sensitivity = beliefs.flux_sensitivities.find(hw_sensitivity_id)) {
+        double& hw_lambda_belief = *hw_sensitivity;
+        double old_belief = hw_lambda_belief;
+        hw_lambda_belief *= (1.0 + (deviation * LEARNING_RATE));
+        if (hw_lambda_belief < 0) hw_lambda_belief = 0;
+        VPU_LOG_DEBUG("    -> Updating HW sensitivity '" << context.hw_sensitivity_key << "': " << old_belief << " -> " << hw_lambda_belief);
+        belief_updated = true;
     }
-}
 
-// Determines if the VPU should choose a suboptimal path for exploration
-bool FeedbackLoop::should_explore() {
-    double random_value = distribution_(random_generator_);
-    bool explore = random_value < exploration_rate_;
-    if (explore) {
-        std::cout << "[Pillar 5] FeedbackLoop: Decision to EXPLORE (Random value " << random_value << " < Exploration rate " << exploration_rate_ << ")" << std::endl;
+    // 5. Update the size models' coefficients for the task's cache regime (normalized LMS): the
+    // error is shared among the priced steps in proportion to their work, so the per-unit rates
+    // converge without the step size depending on how large the task was.
+    double work_norm = 0.0;
+    for (const SizeTerm& term : context.size_terms) {
+        if (beliefs.size_models.find(term.op)) work_norm += term.work_units * term.work_units;
+    }
+    if (work_norm > 0.0) {
+        const double error = record.observed_holistic_flux - predicted_flux;
+        for (const SizeTerm& term : context.size_terms) {
+            SizeModel* model = beliefs.size_models.find(term.op);
+            if (!model) continue;
+            double& per_unit = model->per_unit[context.cache_regime];
+            const double old_belief = per_unit;
+            per_unit = std::max(0.0, per_unit + LEARNING_RATE * error * term.work_units / work_norm);
+            VPU_LOG_DEBUG("    -> Updating size model of '" << HAL::OperationRegistry::instance().name(term.op)
+                          << "' (regime " << static_cast<int>(context.cache_regime) << ", " << term.work_units
+                          << " work units): " << old_belief << " -> " << per_unit << " per unit");
+        }
+        belief_updated = true;
+    }
+
+    if (!belief_updated) {
+        VPU_LOG_DEBUG("    -> No specific belief component (transform, base op cost, or sensitivity) could be targeted for update based on context.");
     }
-    return explore;
 }
 
 // Placeholder for apply_learning, if it were to be used.
@@ -126,9 +284,18 @@ bool FeedbackLoop::should_explore() {
 //     // Implementation would go here
 // }
 
+size_t FeedbackLoop::choose_plan(const EnrichedExecutionContext& context, const std::vector<ExecutionPlan>& candidates) {
+    return explorer_.choose(PlanExplorer::bucket_of(context), candidates);
+}
+
+void FeedbackLoop::record_plan_outcome(const EnrichedExecutionContext& context, const ExecutionPlan& plan,
+                                       const ActualPerformanceRecord& record) {
+    explorer_.record(PlanExplorer::bucket_of(context), plan, record.observed_latency_ns);
+}
+
 void FeedbackLoop::force_exploration_rate_for_testing(double rate) {
-    exploration_rate_ = rate;
-    std::cout << "[Pillar 5] FeedbackLoop: Exploration rate FORCED to " << exploration_rate_ * 100 << "% for testing." << std::endl;
+    explorer_.set_budget(rate);
+    VPU_LOG_INFO("[Pillar 5] FeedbackLoop: Exploration rate FORCED to " << rate * 100 << "% for testing.");
 }
 
 
@@ -1,24 +1,61 @@
 #pragma once
 
 #include "vpu_data_structures.h"
-#include "core/Pillar3_Orchestrator.h" // For HardwareProfile
-#include <random> // For std::mt19937 and std::uniform_real_distribution
+#include "core/HardwareProfile.h"
+#include "core/PlanExplorer.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 namespace VPU {
 
 // The FeedbackLoop completes the cognitive cycle by updating the VPU's beliefs.
 class FeedbackLoop {
 public:
-    FeedbackLoop(std::shared_ptr<HardwareProfile> hw_profile,
+    FeedbackLoop(std::shared_ptr<HardwareProfileStore> hw_profile,
                  double quark_threshold = 0.15,
                  double learning_rate = 0.1,
                  double learning_rate_base_cost = 0.05, // Added to match .cpp
-                 double exploration_rate = 0.1);     // New parameter for exploration
+                 double exploration_rate = 0.1);     // PlanExplorer's budget (see choose_plan)
 
+    // Stages belief updates; they become visible to planners when the batch is published.
+    // Step latencies are not learned here: pass the record to record_step_latencies() too.
     void learn_from_feedback(const LearningContext& context, double predicted_flux, const ActualPerformanceRecord& record);
 
-    // Determines if the VPU should choose a suboptimal path for exploration
-    bool should_explore();
+    // Adds the record's step latencies to the calling thread's latency batch, merging the batch
+    // into HardwareProfile::latency (staged and published) once it holds latency_batch_size tasks.
+    // Takes only the thread's own batch lock, which nothing but a flush contends, so callers
+    // should invoke it before taking any lock of their own.
+    void record_step_latencies(const ActualPerformanceRecord& record);
+
+    // Publishes all staged updates atomically as a new belief version. Returns the current version.
+    uint64_t publish_pending_beliefs();
+
+    // Number of learn_from_feedback() calls per automatic publish (default DEFAULT_PUBLISH_BATCH_SIZE).
+    void set_publish_batch_size(size_t batch_size);
+
+    static const size_t DEFAULT_PUBLISH_BATCH_SIZE = 32;
+
+    // Tasks a thread accumulates before merging its step latencies into HardwareProfile::latency
+    // (default DEFAULT_LATENCY_BATCH_SIZE).
+    void set_latency_batch_size(size_t batch_size);
+
+    static const size_t DEFAULT_LATENCY_BATCH_SIZE = 32;
+    // EWMA weight of one latency sample.
+    static constexpr double LATENCY_EWMA_WEIGHT = 0.1;
+
+    // Merges every thread's pending latency batch, including those of threads that have exited,
+    // and publishes if any held samples. Returns the current version.
+    uint64_t flush_latency_statistics();
+
+    // Index into 'candidates' (sorted best-first) of the plan to run for a task in 'context'.
+    // Explores via the PlanExplorer: at most exploration_rate of a window's decisions, and only
+    // plans whose expected regret is low.
+    size_t choose_plan(const EnrichedExecutionContext& context, const std::vector<ExecutionPlan>& candidates);
+    // Updates the explorer's statistics for the plan that ran.
+    void record_plan_outcome(const EnrichedExecutionContext& context, const ExecutionPlan& plan,
+                             const ActualPerformanceRecord& record);
+    PlanExplorer& explorer() { return explorer_; }
 
     // Test helper to force exploration rate for deterministic testing
     void force_exploration_rate_for_testing(double rate);
@@ -26,15 +63,34 @@ public:
 private:
     void apply_learning(double& belief, double observed, double predicted); // This seems unused, consider removing or implementing
 
-    std::shared_ptr<HardwareProfile> hw_profile_;
+    // Applies one feedback sample to the (staging) beliefs.
+    void apply_feedback(HardwareProfile& beliefs, const LearningContext& context, double predicted_flux, const ActualPerformanceRecord& record);
+    struct LatencyBatch;       // Step latencies not yet merged
+    struct ThreadLatencyBatch; // One thread's LatencyBatch and the lock a flush takes to read it
+    // The calling thread's batch for this loop, registered in latency_batches_ on first use.
+    ThreadLatencyBatch& thread_latency_batch();
+    // Stages 'batches' into HardwareProfile::latency and publishes. No-op if they hold no samples.
+    void merge_latency_batches(const std::vector<LatencyBatch>& batches);
+
+    std::shared_ptr<HardwareProfileStore> hw_profile_;
     const double QUARK_THRESHOLD; // e.g., 15% deviation
     const double LEARNING_RATE;
     const double LEARNING_RATE_BASE_COST; // Added to match .cpp
 
-    // Exploration members
-    double exploration_rate_;
-    std::mt19937 random_generator_;
-    std::uniform_real_distribution<double> distribution_;
+    // Exploration policy; its budget is the exploration rate
+    PlanExplorer explorer_;
+
+    // Belief publishing
+    size_t publish_batch_size_;
+    size_t updates_since_publish_ = 0;
+
+    // Latency learning
+    const uint64_t loop_id_; // Keys this loop's per-thread latency batches
+    std::atomic<size_t> latency_batch_size_;
+    // Every thread's batch. A thread's own reference goes when it exits; the batch stays here
+    // until the next flush merges it.
+    std::mutex latency_batches_mutex_;
+    std::vector<std::shared_ptr<ThreadLatencyBatch>> latency_batches_;
 };
 
 } // namespace VPU
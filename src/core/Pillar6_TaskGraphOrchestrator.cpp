@@ -1,11 +1,16 @@
 #include "core/Pillar6_TaskGraphOrchestrator.h"
-#include <iostream> // For logging
+#include "core/FusionLibrary.h" // For the fusable pairs and their kernels
+#include "core/SizeModel.h"     // For the fused size model prior
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <algorithm> // For std::min, std::copy
+#include <iterator> // For std::next
+#include <stdexcept> // For std::runtime_error
 
 namespace VPU {
 
 TaskGraphOrchestrator::TaskGraphOrchestrator(
     std::shared_ptr<HAL::KernelLibrary> kernel_lib,
-    std::shared_ptr<HardwareProfile> hw_profile,
+    std::shared_ptr<HardwareProfileStore> hw_profile,
     int fusion_candidate_threshold)
 : kernel_lib_(kernel_lib),
   hw_profile_(hw_profile),
@@ -16,119 +21,200 @@ TaskGraphOrchestrator::TaskGraphOrchestrator(
     if (!hw_profile_) {
         throw std::runtime_error("TaskGraphOrchestrator: HardwareProfile cannot be null.");
     }
-    std::cout << "[Pillar 6] TaskGraphOrchestrator initialized. Fusion threshold: "
-              << fusion_candidate_threshold_ << ", Analysis interval: " << analysis_interval_ << " tasks."
-              << std::endl;
+    VPU_LOG_INFO("[Pillar 6] TaskGraphOrchestrator initialized. Fusion threshold: "
+              << fusion_candidate_threshold_ << ", Analysis interval: " << analysis_interval_ << " tasks.");
+}
+
+TaskGraphOrchestrator::NGramKey TaskGraphOrchestrator::make_ngram_key(const HAL::OpId* ops, size_t length) {
+    NGramKey key = length;
+    for (size_t i = 0; i < length; ++i) {
+        key |= static_cast<NGramKey>(ops[i] & 0xFFFF) << (8 + 16 * i);
+    }
+    return key;
+}
+
+bool TaskGraphOrchestrator::is_fusable_step(HAL::OpId op, const HardwareProfile& beliefs) {
+    if (op == HAL::INVALID_OP_ID) {
+        return false;
+    }
+    const std::string& name = HAL::OperationRegistry::instance().name(op);
+    const bool meta = name.find("JIT_") != std::string::npos || name.find("EXECUTE_") != std::string::npos;
+    return !meta || beliefs.base_operational_costs.find(op) != nullptr;
+}
+
+std::vector<HAL::OpId> TaskGraphOrchestrator::plan_ops(const ExecutionPlan& plan) {
+    // Plans from Pillar 3 carry resolved IDs; hand-built plans are interned here.
+    std::vector<HAL::OpId> ops;
+    ops.reserve(plan.steps.size());
+    for (const auto& step : plan.steps) {
+        ops.push_back(step.op_id != HAL::INVALID_OP_ID ? step.op_id : HAL::intern_op(step.operation_name));
+    }
+    return ops;
+}
+
+void TaskGraphOrchestrator::count_ngrams(const std::vector<HAL::OpId>& ops, size_t boundary) {
+    // Count every run of 2..MAX_NGRAM fusable steps; a meta-operation or a repeated op breaks the run.
+    HardwareProfileSnapshot beliefs = hw_profile_->snapshot();
+    size_t run_start = 0;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        if (!is_fusable_step(ops[i], *beliefs)) {
+            run_start = i + 1;
+            continue;
+        }
+        if (i > run_start && ops[i] == ops[i - 1]) {
+            run_start = i;
+        }
+        for (size_t n = 2; n <= MAX_NGRAM && i + 1 >= run_start + n; ++n) {
+            const size_t start = i + 1 - n;
+            if (boundary != 0 && (start >= boundary || i < boundary)) {
+                continue;
+            }
+            const NGramKey key = make_ngram_key(&ops[start], n);
+            auto it = ngram_counts_.find(key);
+            if (it != ngram_counts_.end()) {
+                it->second += 1.0;
+            } else if (ngram_counts_.size() < MAX_TRACKED_NGRAMS) {
+                ngram_counts_.emplace(key, 1.0);
+            }
+        }
+    }
 }
 
 void TaskGraphOrchestrator::record_executed_plan(const ExecutionPlan& plan) {
-    plan_history_.push_back(plan);
     task_execution_counter_++;
-    std::cout << "[Pillar 6] Recorded executed plan: " << plan.chosen_path_name
-              << ". Total plans in history: " << plan_history_.size() << "." << std::endl;
+
+    const std::vector<HAL::OpId> ops = plan_ops(plan);
+    RecordedPlan& slot = history_[history_count_ % HISTORY_CAPACITY];
+    slot.length = static_cast<uint8_t>(std::min(ops.size(), MAX_RECORDED_STEPS));
+    std::copy(ops.begin(), ops.begin() + slot.length, slot.ops.begin());
+    history_count_++;
+
+    count_ngrams(ops, 0);
+    VPU_LOG_DEBUG("[Pillar 6] Recorded executed plan: " << plan.chosen_path_name
+              << ". Tracking " << ngram_counts_.size() << " operation sequence(s) over " << history_count_ << " plan(s).");
 
     // Trigger analysis periodically
     if (task_execution_counter_ % analysis_interval_ == 0) {
-        std::cout << "[Pillar 6] Task execution counter reached " << task_execution_counter_
-                  << ". Triggering pattern analysis and fusion." << std::endl;
+        VPU_LOG_DEBUG("[Pillar 6] Task execution counter reached " << task_execution_counter_
+                  << ". Triggering pattern analysis and fusion.");
         analyze_and_fuse_patterns();
     }
 }
 
-void TaskGraphOrchestrator::analyze_and_fuse_patterns() {
-    std::cout << "[Pillar 6] Analyzing plan history for fusion candidates..." << std::endl;
-    if (plan_history_.empty()) {
-        std::cout << "[Pillar 6] Plan history is empty. No patterns to analyze." << std::endl;
+void TaskGraphOrchestrator::record_task_graph_edge(const ExecutionPlan& producer, const ExecutionPlan& consumer) {
+    // Only the last and first MAX_NGRAM - 1 steps can take part in a sequence across the edge.
+    const std::vector<HAL::OpId> producer_ops = plan_ops(producer);
+    const std::vector<HAL::OpId> consumer_ops = plan_ops(consumer);
+    const size_t tail = std::min(producer_ops.size(), MAX_NGRAM - 1);
+    if (tail == 0 || consumer_ops.empty()) {
         return;
     }
+    std::vector<HAL::OpId> ops(producer_ops.end() - tail, producer_ops.end());
+    ops.insert(ops.end(), consumer_ops.begin(), consumer_ops.begin() + std::min(consumer_ops.size(), MAX_NGRAM - 1));
+    count_ngrams(ops, tail);
+    VPU_LOG_DEBUG("[Pillar 6] Recorded task graph edge: " << producer.chosen_path_name << " -> "
+              << consumer.chosen_path_name << ". Tracking " << ngram_counts_.size() << " operation sequence(s).");
+}
 
-    std::map<std::pair<std::string, std::string>, int> sequences = find_frequent_sequences();
-
-    if (sequences.empty()) {
-        std::cout << "[Pillar 6] No frequent sequences found for fusion." << std::endl;
+void TaskGraphOrchestrator::analyze_and_fuse_patterns() {
+    VPU_LOG_DEBUG("[Pillar 6] Analyzing operation sequences for fusion candidates...");
+    if (ngram_counts_.empty()) {
+        VPU_LOG_DEBUG("[Pillar 6] No operation sequences recorded. No patterns to analyze.");
         return;
     }
 
-    for (const auto& pair_entry : sequences) {
-        const auto& op_sequence = pair_entry.first;
-        int count = pair_entry.second;
-        std::cout << "[Pillar 6] Sequence <" << op_sequence.first << ", " << op_sequence.second
-                  << "> appeared " << count << " times." << std::endl;
-        if (count >= fusion_candidate_threshold_) {
-            std::cout << "[Pillar 6] Sequence <" << op_sequence.first << ", " << op_sequence.second
-                      << "> met fusion threshold (" << fusion_candidate_threshold_ << "). Attempting fusion." << std::endl;
-            create_fused_kernel(op_sequence.first, op_sequence.second);
+    const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
+    std::vector<std::pair<std::string, std::string>> to_fuse;
+    for (const auto& entry : ngram_counts_) {
+        if (entry.second < fusion_candidate_threshold_) {
+            continue;
         }
-    }
-}
-
-std::map<std::pair<std::string, std::string>, int> TaskGraphOrchestrator::find_frequent_sequences() {
-    std::map<std::pair<std::string, std::string>, int> sequence_counts;
-    if (plan_history_.size() < 2 && (plan_history_.empty() || plan_history_[0].steps.size() < 2)) { // Need enough history/steps for sequences
-         std::cout << "[Pillar 6] Not enough plan history or steps within plans to find sequences." << std::endl;
-        return sequence_counts;
-    }
-
-    for (const auto& plan : plan_history_) {
-        if (plan.steps.size() < 2) {
-            continue; // Need at least two steps for a sequence
+        const size_t length = ngram_length(entry.first);
+        std::string sequence;
+        for (size_t i = 0; i < length; ++i) {
+            sequence += (i ? ", " : "") + registry.name(ngram_op(entry.first, i));
         }
-        for (size_t i = 0; i < plan.steps.size() - 1; ++i) {
-            // We are interested in sequences of *operational* steps, not necessarily any step.
-            // This check assumes that steps that have a base_operational_cost are the ones we'd fuse.
-            // Or, more simply, just use the operation_name string if it's not a JIT/meta operation.
-            const std::string& op1_name = plan.steps[i].operation_name;
-            const std::string& op2_name = plan.steps[i+1].operation_name;
-
-            // Avoid fusing JIT compilation steps or other meta-operations for now.
-            // This is a simple heuristic. A more robust system might have flags on ExecutionStep.
-            if (op1_name.find("JIT_") != std::string::npos || op2_name.find("JIT_") != std::string::npos ||
-                op1_name.find("EXECUTE_") != std::string::npos || op2_name.find("EXECUTE_") != std::string::npos ) { // Avoid fusing JIT steps with their execution
-                // Or more generally, avoid fusing things that are not in base_operational_costs
-                 if (!hw_profile_->base_operational_costs.count(op1_name) || !hw_profile_->base_operational_costs.count(op2_name) ) {
-                    continue;
-                 }
+        VPU_LOG_DEBUG("[Pillar 6] Sequence <" << sequence << "> has count " << entry.second
+                  << " (threshold " << fusion_candidate_threshold_ << ").");
+        // Fused kernels are pairwise; longer sequences show where chains of fusions would pay off.
+        if (length == 2) {
+            const std::string& first = registry.name(ngram_op(entry.first, 0));
+            const std::string& second = registry.name(ngram_op(entry.first, 1));
+            const HAL::OpId fused_id = registry.find(fused_operation_name(first, second));
+            if (fused_id == HAL::INVALID_OP_ID || !kernel_lib_->count(fused_id)) {
+                to_fuse.emplace_back(first, second);
             }
+        }
+    }
+    for (const auto& pair : to_fuse) {
+        VPU_LOG_DEBUG("[Pillar 6] Sequence <" << pair.first << ", " << pair.second << "> met fusion threshold. Attempting fusion.");
+        create_fused_kernel(pair.first, pair.second);
+    }
 
-            // Also avoid fusing an operation with itself for this simple example
-            if (op1_name == op2_name) continue;
-
+    // Decay, so the counters describe recent traffic, and drop patterns that have faded.
+    for (auto it = ngram_counts_.begin(); it != ngram_counts_.end();) {
+        it->second *= COUNT_DECAY_PER_ANALYSIS;
+        it = it->second < PRUNE_BELOW_COUNT ? ngram_counts_.erase(it) : std::next(it);
+    }
+}
 
-            sequence_counts[{op1_name, op2_name}]++;
-        }
+double TaskGraphOrchestrator::ngram_count_for_testing(const std::vector<std::string>& op_names) const {
+    if (op_names.size() < 2 || op_names.size() > MAX_NGRAM) {
+        return 0.0;
+    }
+    std::vector<HAL::OpId> ops;
+    for (const auto& name : op_names) {
+        ops.push_back(HAL::OperationRegistry::instance().find(name));
+        if (ops.back() == HAL::INVALID_OP_ID) return 0.0;
     }
-    return sequence_counts;
+    auto it = ngram_counts_.find(make_ngram_key(ops.data(), ops.size()));
+    return it != ngram_counts_.end() ? it->second : 0.0;
 }
 
 void TaskGraphOrchestrator::create_fused_kernel(const std::string& op1_name, const std::string& op2_name) {
-    std::string new_kernel_name = "FUSED_" + op1_name + "_" + op2_name;
+    // Only pairs with a single-pass implementation are fused; anything else would just chain the two kernels.
+    const FusionRule* rule = find_fusion_rule(op1_name, op2_name);
+    if (!rule) {
+        VPU_LOG_DEBUG("[Pillar 6] No fused implementation for <" << op1_name << ", " << op2_name << ">. Skipping fusion.");
+        return;
+    }
+    const std::string& new_kernel_name = rule->fused_name;
 
     // Check if kernel already exists (e.g. from a previous fusion)
-    if (kernel_lib_->count(new_kernel_name)) {
-        std::cout << "[Pillar 6] Fused kernel '" << new_kernel_name << "' already exists. Skipping creation." << std::endl;
+    if (kernel_lib_->count(rule->fused_id)) {
+        VPU_LOG_DEBUG("[Pillar 6] Fused kernel '" << new_kernel_name << "' already exists. Skipping creation.");
         return;
     }
 
-    // Conceptual: Add placeholder for the new fused kernel to KernelLibrary
-    (*kernel_lib_)[new_kernel_name] = [new_kernel_name]() { // Capture new_kernel_name
-        std::cout << "Executing FUSED KERNEL: " << new_kernel_name << std::endl;
-        // Placeholder for actual fused operation logic
-    };
-    std::cout << "[Pillar 6] Conceptually added new fused kernel '" << new_kernel_name << "' to KernelLibrary." << std::endl;
-
-    // Conceptual: Add an estimated cost for this new kernel to HardwareProfile
-    double cost_op1 = hw_profile_->base_operational_costs.count(op1_name) ? hw_profile_->base_operational_costs.at(op1_name) : 100.0; // Default cost
-    double cost_op2 = hw_profile_->base_operational_costs.count(op2_name) ? hw_profile_->base_operational_costs.at(op2_name) : 100.0; // Default cost
-    double estimated_fused_cost = 0.8 * (cost_op1 + cost_op2); // Assume 20% efficiency gain from fusion
-
-    hw_profile_->base_operational_costs[new_kernel_name] = estimated_fused_cost;
-    std::cout << "[Pillar 6] Added estimated cost for '" << new_kernel_name << "' (" << estimated_fused_cost
-              << ") to HardwareProfile base_operational_costs." << std::endl;
-
-    // Potentially add a new sensitivity if the fused op has different characteristics
-    // For example, if op1 was sensitive to X and op2 to Y, new_fused_op might be sensitive to both or neither.
-    // hw_profile_->flux_sensitivities["lambda_FUSED_" + op1_name + "_" + op2_name] = some_estimated_sensitivity;
-    // For now, we keep it simple and only add to base_operational_costs.
+    (*kernel_lib_)[rule->fused_id] = rule->kernel;
+    VPU_LOG_INFO("[Pillar 6] Added fused kernel '" << new_kernel_name << "' to KernelLibrary.");
+
+    // Seed beliefs for the fused op (published as a new belief version). The cost prior is a
+    // starting point only: Pillar 5 learns the real cost once Pillar 3 schedules the fused plan.
+    double estimated_fused_cost = 0.0;
+    hw_profile_->update([&](HardwareProfile& beliefs) {
+        // A component may be a transform (e.g. DENSE_TO_CSR) or a base operation.
+        auto component_cost = [&beliefs](HAL::OpId op) {
+            if (const double* cost = beliefs.base_operational_costs.find(op)) return *cost;
+            if (const double* cost = beliefs.transform_costs.find(op)) return *cost;
+            return 100.0; // Default cost
+        };
+        estimated_fused_cost = rule->cost_prior * (component_cost(rule->first_id) + component_cost(rule->second_id));
+        beliefs.base_operational_costs[new_kernel_name] = estimated_fused_cost;
+        // The fused kernel reads what the second op read, minus the intermediate.
+        const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
+        if (const double* lambda_hw = beliefs.flux_sensitivities.find(registry.hw_sensitivity_id(rule->second_id))) {
+            beliefs.flux_sensitivities[registry.hw_sensitivity_id(rule->fused_id)] = *lambda_hw;
+        }
+        // Its work grows like the faster-growing component's.
+        const SizeModel fused_model = fused_size_model(beliefs.size_models.find(rule->first_id),
+                                                       beliefs.size_models.find(rule->second_id), rule->cost_prior);
+        if (fused_model.complexity != Complexity::NONE) {
+            beliefs.size_models[rule->fused_id] = fused_model;
+        }
+    });
+    VPU_LOG_INFO("[Pillar 6] Added estimated cost for '" << new_kernel_name << "' (" << estimated_fused_cost
+              << ") to HardwareProfile base_operational_costs.");
 }
 
 } // namespace VPU
@@ -2,40 +2,79 @@
 
 #include "vpu_data_structures.h"
 #include "hal/hal.h" // For HAL::KernelLibrary
-#include "core/Pillar3_Orchestrator.h" // For HardwareProfile (though defined in Pillar3_Orchestrator.h, it's a general structure)
+#include "core/HardwareProfile.h" // For HardwareProfileStore
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
-#include <map>
 #include <memory> // For std::shared_ptr
-#include <utility> // For std::pair
+#include <unordered_map>
 
 namespace VPU {
 
 class TaskGraphOrchestrator {
 public:
+    // Plans kept for inspection; older ones are overwritten.
+    static constexpr size_t HISTORY_CAPACITY = 256;
+    static constexpr size_t MAX_RECORDED_STEPS = 8; // Per history entry (n-grams still see every step)
+    // N-grams of 2..MAX_NGRAM consecutive operations are counted.
+    static constexpr size_t MAX_NGRAM = 3;
+    // Distinct n-grams tracked at once; new ones are ignored until decay prunes old ones.
+    static constexpr size_t MAX_TRACKED_NGRAMS = 1024;
+    // Every analysis multiplies all counts by this, so patterns that stop occurring fade out.
+    static constexpr double COUNT_DECAY_PER_ANALYSIS = 0.9;
+    static constexpr double PRUNE_BELOW_COUNT = 0.05;
+
     TaskGraphOrchestrator(std::shared_ptr<HAL::KernelLibrary> kernel_lib,
-                          std::shared_ptr<HardwareProfile> hw_profile,
+                          std::shared_ptr<HardwareProfileStore> hw_profile,
                           int fusion_candidate_threshold = 10);
 
+    // O(steps * MAX_NGRAM): updates the n-gram counters and the history ring.
     void record_executed_plan(const ExecutionPlan& plan);
+    // Counts the sequences that run from the end of 'producer' into the start of 'consumer',
+    // a task that reads the producer's output (see VPUCore::execute_graph).
+    void record_task_graph_edge(const ExecutionPlan& producer, const ExecutionPlan& consumer);
+    // O(MAX_TRACKED_NGRAMS): fuses frequent pairs, then decays and prunes the counters.
     void analyze_and_fuse_patterns();
 
+    size_t history_size() const { return history_count_ < HISTORY_CAPACITY ? history_count_ : HISTORY_CAPACITY; }
+    size_t tracked_ngram_count() const { return ngram_counts_.size(); }
+
     // Test helpers
     void set_fusion_candidate_threshold_for_testing(int threshold) { fusion_candidate_threshold_ = threshold; }
     void set_analysis_interval_for_testing(int interval) { analysis_interval_ = interval; }
     void reset_task_execution_counter_for_testing() { task_execution_counter_ = 0; }
+    // Current (decayed) count of an operation sequence, 0 if untracked.
+    double ngram_count_for_testing(const std::vector<std::string>& op_names) const;
 
 
 private:
-    // Finds frequent sequences of two operations
-    std::map<std::pair<std::string, std::string>, int> find_frequent_sequences();
+    // Up to MAX_NGRAM OpIds (each < OperationRegistry::MAX_OPERATIONS) and the length, packed into one word.
+    using NGramKey = uint64_t;
+    static NGramKey make_ngram_key(const HAL::OpId* ops, size_t length);
+    static size_t ngram_length(NGramKey key) { return static_cast<size_t>(key & 0xFF); }
+    static HAL::OpId ngram_op(NGramKey key, size_t i) { return static_cast<HAL::OpId>((key >> (8 + 16 * i)) & 0xFFFF); }
+
+    // Meta-operations (JIT compilation and execution with no believed cost) end a sequence.
+    static bool is_fusable_step(HAL::OpId op, const HardwareProfile& beliefs);
 
-    // Conceptually creates and registers a new fused kernel
+    static std::vector<HAL::OpId> plan_ops(const ExecutionPlan& plan);
+    // Counts the n-grams of 'ops'; with a non-zero 'boundary', only those spanning ops[boundary - 1] and ops[boundary].
+    void count_ngrams(const std::vector<HAL::OpId>& ops, size_t boundary);
+
+    // Registers the single-pass kernel for a pair (see FusionLibrary) and seeds its beliefs
     void create_fused_kernel(const std::string& op1_name, const std::string& op2_name);
 
-    std::vector<ExecutionPlan> plan_history_;
+    struct RecordedPlan {
+        std::array<HAL::OpId, MAX_RECORDED_STEPS> ops{};
+        uint8_t length = 0;
+    };
+
+    std::array<RecordedPlan, HISTORY_CAPACITY> history_; // Ring buffer
+    size_t history_count_ = 0; // Plans recorded so far; the next one goes to history_count_ % HISTORY_CAPACITY
+    std::unordered_map<NGramKey, double> ngram_counts_;
     std::shared_ptr<HAL::KernelLibrary> kernel_lib_;
-    std::shared_ptr<HardwareProfile> hw_profile_;
+    std::shared_ptr<HardwareProfileStore> hw_profile_;
     int fusion_candidate_threshold_;
     int task_execution_counter_ = 0; // To trigger analysis periodically
     int analysis_interval_ = 5;     // Analyze every 5 tasks, for example
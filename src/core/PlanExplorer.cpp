@@ -0,0 +1,108 @@
+#include "core/PlanExplorer.h"
+#include "hal/hal_utils.h" // For HAL::hash_combine, HAL::fingerprint_buffer
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <algorithm>
+#include <cmath>
+
+namespace VPU {
+
+PlanExplorer::PlanExplorer() : PlanExplorer(Options()) {}
+
+PlanExplorer::PlanExplorer(Options options, uint64_t seed)
+    : options_(options), rng_(seed), window_start_(std::chrono::steady_clock::now()) {}
+
+uint64_t PlanExplorer::bucket_of(const EnrichedExecutionContext& context) {
+    uint64_t size_bucket = 0;
+    for (uint64_t bytes = context.payload_bytes; bytes > 1; bytes >>= 1) ++size_bucket;
+    const double sparsity = context.profile ? context.profile->sparsity_ratio : 1.0;
+    const uint64_t sparsity_bucket = static_cast<uint64_t>(std::min(std::max(sparsity, 0.0), 1.0) * 4.0); // 0..4
+    uint64_t bucket = HAL::fingerprint_buffer(context.task_type.data(), context.task_type.size());
+    bucket = HAL::hash_combine(bucket, size_bucket);
+    return HAL::hash_combine(bucket, sparsity_bucket);
+}
+
+uint64_t PlanExplorer::arm_key(uint64_t bucket, const std::string& plan_name) {
+    return HAL::hash_combine(bucket, HAL::fingerprint_buffer(plan_name.data(), plan_name.size()));
+}
+
+const LatencyStats* PlanExplorer::arm(uint64_t bucket, const std::string& plan_name) const {
+    auto it = arms_.find(arm_key(bucket, plan_name));
+    return it != arms_.end() ? &it->second : nullptr;
+}
+
+bool PlanExplorer::budget_allows() {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - window_start_ >= options_.window) {
+        window_start_ = now;
+        window_decisions_ = 0;
+        window_explorations_ = 0;
+    }
+    ++window_decisions_;
+    return static_cast<double>(window_explorations_) < options_.budget * static_cast<double>(window_decisions_);
+}
+
+size_t PlanExplorer::choose(uint64_t bucket, const std::vector<ExecutionPlan>& candidates) {
+    if (!budget_allows() || candidates.size() < 2) {
+        return 0;
+    }
+
+    // Nanoseconds per predicted flux unit: from the best plan's arm if it has run here (regret is
+    // measured against it), else averaged over the arms that have; flux units if none has.
+    double scale_sum = 0.0;
+    size_t scaled_arms = 0;
+    std::vector<const LatencyStats*> stats(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        stats[i] = arm(bucket, candidates[i].chosen_path_name);
+    }
+    const bool anchored = stats[0] && candidates[0].predicted_holistic_flux > 0.0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (stats[i] && candidates[i].predicted_holistic_flux > 0.0 && (i == 0 || !anchored)) {
+            scale_sum += stats[i]->mean_ns / candidates[i].predicted_holistic_flux;
+            ++scaled_arms;
+        }
+    }
+    const double ns_per_flux = scaled_arms ? scale_sum / static_cast<double>(scaled_arms) : 1.0;
+
+    std::vector<double> mean(candidates.size());
+    size_t chosen = 0;
+    double lowest_draw = 0.0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        double sd = 0.0;
+        if (stats[i]) {
+            // One pseudo-observation of the prior variance keeps a single sample from looking certain.
+            const double n = static_cast<double>(stats[i]->samples);
+            mean[i] = stats[i]->mean_ns;
+            const double prior_sd = options_.prior_relative_sd * mean[i];
+            sd = std::sqrt((stats[i]->m2 + prior_sd * prior_sd) / (n * n));
+        } else {
+            mean[i] = scaled_arms ? candidates[i].predicted_holistic_flux * ns_per_flux : candidates[i].predicted_holistic_flux;
+            sd = options_.prior_relative_sd * std::abs(mean[i]);
+        }
+        const double draw = sd > 0.0 ? std::normal_distribution<double>(mean[i], sd)(rng_) : mean[i];
+        if (i == 0 || draw < lowest_draw) {
+            lowest_draw = draw;
+            chosen = i;
+        }
+    }
+    if (chosen == 0 || mean[0] <= 0.0) {
+        return 0;
+    }
+    const double expected_regret = (mean[chosen] - mean[0]) / mean[0];
+    if (expected_regret > options_.max_expected_regret) {
+        VPU_LOG_DEBUG("[Pillar 5] Explorer: Skipping '" << candidates[chosen].chosen_path_name << "' (expected regret "
+                      << expected_regret * 100 << "%).");
+        return 0;
+    }
+    ++window_explorations_;
+    ++explorations_;
+    return chosen;
+}
+
+void PlanExplorer::record(uint64_t bucket, const ExecutionPlan& plan, double observed_latency_ns) {
+    if (observed_latency_ns <= 0.0) {
+        return;
+    }
+    arms_[arm_key(bucket, plan.chosen_path_name)].add(observed_latency_ns);
+}
+
+} // namespace VPU
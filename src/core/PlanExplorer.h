@@ -0,0 +1,64 @@
+#pragma once
+
+#include "vpu_data_structures.h" // For ExecutionPlan, EnrichedExecutionContext
+#include "core/HardwareProfile.h" // For LatencyStats
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace VPU {
+
+// Thompson-sampling exploration over the candidate plans of Pillar 3.
+// Each (context bucket, plan) pair is an arm with running statistics of the plan's observed
+// latency there. An arm that has not run yet is estimated from its predicted flux, scaled by
+// what the bucket's observed arms cost per predicted flux unit, with a wide prior.
+// A decision draws one sample per arm and runs the lowest, but only when that plan's expected
+// cost is within max_expected_regret of Pillar 3's best plan and the window's budget allows;
+// otherwise the best plan runs.
+// Not thread-safe: VPUCore serializes it under its cognitive state lock.
+class PlanExplorer {
+public:
+    struct Options {
+        double budget = 0.1; // Share of a window's decisions that may explore (0 disables exploration)
+        std::chrono::milliseconds window{1000};
+        double max_expected_regret = 0.5; // Expected extra cost over candidates[0], relative to it
+        double prior_relative_sd = 0.5;   // Uncertainty of an estimate with little data, relative to it
+    };
+
+    PlanExplorer(); // Default options, random seed
+    explicit PlanExplorer(Options options, uint64_t seed = std::random_device{}());
+
+    // Task type, log2 of the payload size and quarter of the bit sparsity.
+    static uint64_t bucket_of(const EnrichedExecutionContext& context);
+
+    // Index into 'candidates' (sorted best-first) of the plan to run: 0 unless exploring.
+    size_t choose(uint64_t bucket, const std::vector<ExecutionPlan>& candidates);
+
+    // Feeds back what the plan that ran in 'bucket' took.
+    void record(uint64_t bucket, const ExecutionPlan& plan, double observed_latency_ns);
+
+    void set_budget(double budget) { options_.budget = budget; }
+    const Options& options() const { return options_; }
+
+    // nullptr if the plan has not run in the bucket.
+    const LatencyStats* arm(uint64_t bucket, const std::string& plan_name) const;
+    uint64_t explorations() const { return explorations_; } // Decisions that did not take candidates[0]
+
+private:
+    static uint64_t arm_key(uint64_t bucket, const std::string& plan_name);
+    bool budget_allows(); // Counts the decision against the current window
+
+    Options options_;
+    std::mt19937_64 rng_;
+    std::unordered_map<uint64_t, LatencyStats> arms_; // By arm_key()
+
+    std::chrono::steady_clock::time_point window_start_;
+    uint64_t window_decisions_ = 0;
+    uint64_t window_explorations_ = 0;
+    uint64_t explorations_ = 0;
+};
+
+} // namespace VPU
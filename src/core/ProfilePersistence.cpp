@@ -0,0 +1,353 @@
+#include "core/ProfilePersistence.h"
+#include "hal/cpu_features.h" // For the host's SIMD ISA
+#include "hal/hal_utils.h"    // For HAL::fingerprint_buffer
+#include "runtime/trace.h"    // For VPU_LOG_*
+#include <algorithm> // For std::max
+#include <cstdio>  // For std::rename, std::remove
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace VPU {
+
+namespace {
+
+const char BINARY_MAGIC[8] = {'V', 'P', 'U', 'H', 'W', 'P', 'F', '1'};
+const uint32_t FORMAT_VERSION = 2;
+const uint32_t MIN_FORMAT_VERSION = 1; // Version 1 files predate size models; they load as they are
+
+enum EntryTable : uint8_t { BASE_COST = 0, TRANSFORM_COST = 1, SENSITIVITY = 2, LATENCY = 3, SIZE_MODEL = 4, TABLE_COUNT };
+const char* const TABLE_NAMES[TABLE_COUNT] = {"base_operational_costs", "transform_costs", "flux_sensitivities", "latency",
+                                              "size_models"};
+// Indexed by Complexity.
+const char* const COMPLEXITY_NAMES[] = {"NONE", "LINEAR", "N_LOG_N", "N_TAPS", "SPARSE_MNK", "MNK"};
+const uint8_t COMPLEXITY_COUNT = static_cast<uint8_t>(Complexity::MNK) + 1;
+
+struct BinaryHeader {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t entry_count;
+    uint64_t host_hash;
+    uint64_t belief_version;
+    uint64_t names_bytes;
+};
+
+struct BinaryEntry {
+    uint32_t name_offset;
+    uint16_t name_length;
+    uint8_t table;
+    uint8_t reserved0;
+    uint32_t reserved1;
+    double values[4];
+};
+
+static_assert(sizeof(BinaryHeader) == 40 && sizeof(BinaryEntry) == 48, "Serialized layout must not depend on padding");
+
+CostTable& cost_table(HardwareProfile& profile, uint8_t table) {
+    return table == BASE_COST ? profile.base_operational_costs
+                              : table == TRANSFORM_COST ? profile.transform_costs : profile.flux_sensitivities;
+}
+
+// Visits (table, name, values[4], kind) for every belief in 'profile'. 'kind' is a size model's
+// Complexity (0 for other tables).
+template <typename Visitor>
+void for_each_entry(const HardwareProfile& profile, Visitor&& visitor) {
+    const CostTable* tables[] = {&profile.base_operational_costs, &profile.transform_costs, &profile.flux_sensitivities};
+    for (uint8_t table = BASE_COST; table <= SENSITIVITY; ++table) {
+        tables[table]->for_each([&](const std::string& name, double value) {
+            const double values[4] = {value, 0.0, 0.0, 0.0};
+            visitor(table, name, values, uint8_t(0));
+        });
+    }
+    profile.latency.for_each([&](const std::string& name, const LatencyStats& stats) {
+        const double values[4] = {static_cast<double>(stats.samples), stats.mean_ns, stats.m2, stats.ewma_ns};
+        visitor(static_cast<uint8_t>(LATENCY), name, values, uint8_t(0));
+    });
+    static_assert(CACHE_REGIME_COUNT == 4, "A size model's coefficients fill values[4]");
+    profile.size_models.for_each([&](const std::string& name, const SizeModel& model) {
+        visitor(static_cast<uint8_t>(SIZE_MODEL), name, model.per_unit, static_cast<uint8_t>(model.complexity));
+    });
+}
+
+void apply_entry(HardwareProfile& profile, uint8_t table, const std::string& name, const double* values, uint8_t kind) {
+    if (name.empty() || table >= TABLE_COUNT ||
+        (table == SIZE_MODEL && (kind == static_cast<uint8_t>(Complexity::NONE) || kind >= COMPLEXITY_COUNT))) {
+        throw std::runtime_error("Serialized profile has a malformed entry.");
+    }
+    if (table == SIZE_MODEL) {
+        SizeModel& model = profile.size_models[name];
+        model.complexity = static_cast<Complexity>(kind);
+        std::copy(values, values + CACHE_REGIME_COUNT, model.per_unit);
+    } else if (table == LATENCY) {
+        LatencyStats& stats = profile.latency[HAL::intern_op(name)];
+        stats.samples = static_cast<uint64_t>(values[0]);
+        stats.mean_ns = values[1];
+        stats.m2 = values[2];
+        stats.ewma_ns = values[3];
+    } else {
+        cost_table(profile, table)[name] = values[0];
+    }
+}
+
+std::string host_description(const HostFingerprint& host) {
+    return host.cpu_model + "|" + host.isa + "|" + std::to_string(host.cores);
+}
+
+bool ends_with(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string serialize_binary(const HardwareProfile& profile, const HostFingerprint& host) {
+    std::vector<BinaryEntry> entries;
+    std::string names;
+    for_each_entry(profile, [&](uint8_t table, const std::string& name, const double* values, uint8_t kind) {
+        BinaryEntry entry{};
+        entry.name_offset = static_cast<uint32_t>(names.size());
+        entry.name_length = static_cast<uint16_t>(name.size());
+        entry.table = table;
+        entry.reserved0 = kind;
+        std::memcpy(entry.values, values, sizeof(entry.values));
+        entries.push_back(entry);
+        names += name;
+    });
+    names.resize((names.size() + 7) & ~static_cast<size_t>(7), '\0');
+
+    BinaryHeader header{};
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.format_version = FORMAT_VERSION;
+    header.entry_count = static_cast<uint32_t>(entries.size());
+    header.host_hash = host.hash();
+    header.belief_version = profile.version;
+    header.names_bytes = names.size();
+
+    std::string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(BinaryEntry));
+    bytes += names;
+    return bytes;
+}
+
+void deserialize_binary(const std::string& bytes, HardwareProfile& profile, uint64_t& host_hash) {
+    BinaryHeader header;
+    if (bytes.size() < sizeof(header)) {
+        throw std::runtime_error("Serialized profile is truncated.");
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.format_version < MIN_FORMAT_VERSION || header.format_version > FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported serialized profile version " + std::to_string(header.format_version) + ".");
+    }
+    const size_t entries_bytes = static_cast<size_t>(header.entry_count) * sizeof(BinaryEntry);
+    if (bytes.size() != sizeof(header) + entries_bytes + header.names_bytes) {
+        throw std::runtime_error("Serialized profile is truncated.");
+    }
+    const char* names = bytes.data() + sizeof(header) + entries_bytes;
+    HardwareProfile loaded = profile; // Applied whole, so a bad entry leaves 'profile' untouched
+    for (uint32_t i = 0; i < header.entry_count; ++i) {
+        BinaryEntry entry;
+        std::memcpy(&entry, bytes.data() + sizeof(header) + i * sizeof(BinaryEntry), sizeof(entry));
+        if (static_cast<uint64_t>(entry.name_offset) + entry.name_length > header.names_bytes) {
+            throw std::runtime_error("Serialized profile has a malformed entry.");
+        }
+        apply_entry(loaded, entry.table, std::string(names + entry.name_offset, entry.name_length), entry.values, entry.reserved0);
+    }
+    host_hash = header.host_hash;
+    profile = std::move(loaded);
+}
+
+} // namespace
+
+HostFingerprint HostFingerprint::current() {
+    static const HostFingerprint host = [] {
+        HostFingerprint detected;
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            // x86 reports "model name"; AArch64 kernels report "CPU part" (and sometimes "Model").
+            if (line.compare(0, 10, "model name") == 0 || line.compare(0, 8, "CPU part") == 0 ||
+                line.compare(0, 5, "Model") == 0) {
+                const size_t colon = line.find(':');
+                const size_t start = colon != std::string::npos ? line.find_first_not_of(" \t", colon + 1) : std::string::npos;
+                if (start != std::string::npos) {
+                    detected.cpu_model = line.substr(start);
+                    break;
+                }
+            }
+        }
+        if (detected.cpu_model.empty()) detected.cpu_model = "unknown";
+        detected.isa = HAL::simd_isa_name(HAL::best_simd_isa());
+        detected.cores = std::thread::hardware_concurrency();
+        return detected;
+    }();
+    return host;
+}
+
+uint64_t HostFingerprint::hash() const {
+    const std::string description = host_description(*this);
+    return HAL::fingerprint_buffer(description.data(), description.size());
+}
+
+std::string HostFingerprint::profile_path(const std::string& directory) const {
+    std::ostringstream path;
+    path << directory;
+    if (!directory.empty() && directory.back() != '/') path << '/';
+    path << "hardware_profile_" << std::hex << hash() << ".bin";
+    return path.str();
+}
+
+nlohmann::json profile_to_json(const HardwareProfile& profile, const HostFingerprint& host) {
+    nlohmann::json json;
+    json["format"] = "vpu-hardware-profile";
+    json["format_version"] = FORMAT_VERSION;
+    json["host"] = {{"cpu_model", host.cpu_model}, {"isa", host.isa}, {"cores", host.cores}, {"hash", host.hash()}};
+    json["belief_version"] = profile.version;
+    for (uint8_t table = BASE_COST; table < TABLE_COUNT; ++table) {
+        json[TABLE_NAMES[table]] = nlohmann::json::object();
+    }
+    for_each_entry(profile, [&](uint8_t table, const std::string& name, const double* values, uint8_t kind) {
+        if (table == LATENCY) {
+            json[TABLE_NAMES[table]][name] = {{"samples", static_cast<uint64_t>(values[0])}, {"mean_ns", values[1]},
+                                              {"m2", values[2]}, {"ewma_ns", values[3]}};
+        } else if (table == SIZE_MODEL) {
+            json[TABLE_NAMES[table]][name] = {{"complexity", COMPLEXITY_NAMES[kind]},
+                                              {"per_unit", {values[0], values[1], values[2], values[3]}}};
+        } else {
+            json[TABLE_NAMES[table]][name] = values[0];
+        }
+    });
+    return json;
+}
+
+void profile_from_json(const nlohmann::json& json, HardwareProfile& profile, uint64_t* host_hash) {
+    if (!json.is_object() || json.value("format", "") != "vpu-hardware-profile") {
+        throw std::runtime_error("Not a serialized hardware profile.");
+    }
+    const uint32_t format_version = json.value("format_version", 0u);
+    if (format_version < MIN_FORMAT_VERSION || format_version > FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported serialized profile version.");
+    }
+    HardwareProfile loaded = profile;
+    try {
+        for (uint8_t table = BASE_COST; table < TABLE_COUNT; ++table) {
+            auto section = json.find(TABLE_NAMES[table]);
+            if (section == json.end()) continue;
+            for (auto it = section->begin(); it != section->end(); ++it) {
+                double values[4] = {0.0, 0.0, 0.0, 0.0};
+                uint8_t kind = 0;
+                if (table == SIZE_MODEL) {
+                    const std::string complexity = it->at("complexity").get<std::string>();
+                    while (kind < COMPLEXITY_COUNT && complexity != COMPLEXITY_NAMES[kind]) ++kind;
+                    const auto& per_unit = it->at("per_unit");
+                    for (size_t regime = 0; regime < CACHE_REGIME_COUNT; ++regime) {
+                        values[regime] = per_unit.at(regime).get<double>();
+                    }
+                } else if (table == LATENCY) {
+                    values[0] = static_cast<double>(it->at("samples").get<uint64_t>());
+                    values[1] = it->at("mean_ns").get<double>();
+                    values[2] = it->at("m2").get<double>();
+                    values[3] = it->at("ewma_ns").get<double>();
+                } else {
+                    values[0] = it->get<double>();
+                }
+                apply_entry(loaded, table, it.key(), values, kind);
+            }
+        }
+        if (host_hash) {
+            *host_hash = json.at("host").at("hash").get<uint64_t>();
+        }
+    } catch (const nlohmann::json::exception& e) {
+        throw std::runtime_error(std::string("Malformed serialized profile: ") + e.what());
+    }
+    profile = std::move(loaded);
+}
+
+bool save_profile(const std::string& path, const HardwareProfile& profile, const HostFingerprint& host) {
+    const std::string bytes = ends_with(path, ".json") ? profile_to_json(profile, host).dump(2) + "\n"
+                                                       : serialize_binary(profile, host);
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!out.good()) {
+            VPU_LOG_WARN("[VPUCore] Could not write beliefs to '" << temporary << "'.");
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        VPU_LOG_WARN("[VPUCore] Could not replace '" << path << "' with the new beliefs.");
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+ProfileLoadResult load_profile(const std::string& path, HardwareProfile& profile, bool any_host, const HostFingerprint& host) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return ProfileLoadResult::MISSING;
+    }
+    const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    HardwareProfile loaded = profile;
+    uint64_t host_hash = 0;
+    try {
+        if (bytes.size() >= sizeof(BINARY_MAGIC) && std::memcmp(bytes.data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0) {
+            deserialize_binary(bytes, loaded, host_hash);
+        } else {
+            profile_from_json(nlohmann::json::parse(bytes), loaded, &host_hash);
+        }
+    } catch (const std::exception& e) { // Includes nlohmann parse errors
+        VPU_LOG_WARN("[VPUCore] Ignoring beliefs in '" << path << "': " << e.what());
+        return ProfileLoadResult::INVALID;
+    }
+    if (!any_host && host_hash != host.hash()) {
+        VPU_LOG_INFO("[VPUCore] Beliefs in '" << path << "' were learned on another host type; not loading them.");
+        return ProfileLoadResult::OTHER_HOST;
+    }
+    profile = std::move(loaded);
+    return ProfileLoadResult::LOADED;
+}
+
+ProfileCheckpointer::ProfileCheckpointer(std::shared_ptr<const HardwareProfileStore> store, std::string path,
+                                         std::chrono::milliseconds interval)
+    : store_(std::move(store)), path_(std::move(path)), interval_(std::max(interval, std::chrono::milliseconds(1))) {
+    thread_ = std::thread(&ProfileCheckpointer::run, this);
+}
+
+ProfileCheckpointer::~ProfileCheckpointer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    stop_cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    checkpoint();
+}
+
+bool ProfileCheckpointer::checkpoint() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HardwareProfileSnapshot beliefs = store_->snapshot();
+    if (beliefs->version == saved_version_) {
+        return true;
+    }
+    if (!save_profile(path_, *beliefs)) {
+        return false;
+    }
+    saved_version_ = beliefs->version;
+    VPU_LOG_DEBUG("[VPUCore] Checkpointed belief version " << saved_version_ << " to '" << path_ << "'.");
+    return true;
+}
+
+void ProfileCheckpointer::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+        lock.unlock();
+        checkpoint();
+        lock.lock();
+    }
+}
+
+} // namespace VPU
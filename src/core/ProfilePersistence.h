@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core/HardwareProfile.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace VPU {
+
+// Identifies the machine learned beliefs are valid for: CPU model, widest SIMD ISA and core count.
+struct HostFingerprint {
+    std::string cpu_model;
+    std::string isa;
+    unsigned cores = 0;
+
+    static HostFingerprint current(); // Detected once
+    uint64_t hash() const;
+    // "<dir>/hardware_profile_<hash>.bin": one file per host type, so hosts can share a directory.
+    std::string profile_path(const std::string& directory) const;
+};
+
+// --- Serialized beliefs ---
+// Entries are stored by operation name (OpIds are per process). Loading a file onto a profile
+// overwrites only the entries it contains, so operations added since it was written keep
+// their built-in priors.
+//
+// Binary format: a fixed header, then fixed-width entries, then the names they point into,
+// native-endian and 8-byte aligned so the file can be read or mapped in place:
+//   header { char magic[8] = "VPUHWPF1"; uint32 format_version; uint32 entry_count;
+//            uint64 host_hash; uint64 belief_version; uint64 names_bytes; }
+//   entry  { uint32 name_offset; uint16 name_length; uint8 table; uint8 kind; uint32 reserved;
+//            double values[4]; } // Costs use values[0]; latency: samples, mean_ns, m2, ewma_ns;
+//                              // size models: per-unit cost by cache regime, 'kind' = Complexity
+// Version 2 added size models; version 1 files still load.
+// JSON mirrors it (plus the readable fingerprint) and is chosen for paths ending in ".json".
+
+nlohmann::json profile_to_json(const HardwareProfile& profile, const HostFingerprint& host);
+// Throws std::runtime_error if 'json' is not a serialized profile.
+void profile_from_json(const nlohmann::json& json, HardwareProfile& profile, uint64_t* host_hash = nullptr);
+
+// Writes to a temporary file and renames it over 'path', so readers never see a partial file.
+bool save_profile(const std::string& path, const HardwareProfile& profile,
+                  const HostFingerprint& host = HostFingerprint::current());
+
+enum class ProfileLoadResult { LOADED, MISSING, OTHER_HOST, INVALID };
+// Applies the file at 'path' (binary or JSON, detected from its contents) onto 'profile'.
+// A file written on a different host type is not applied unless 'any_host' is set.
+ProfileLoadResult load_profile(const std::string& path, HardwareProfile& profile, bool any_host = false,
+                               const HostFingerprint& host = HostFingerprint::current());
+
+// Saves the published beliefs of 'store' to 'path' every 'interval' when they have changed
+// (the first checkpoint always writes), and once more on destruction.
+class ProfileCheckpointer {
+public:
+    ProfileCheckpointer(std::shared_ptr<const HardwareProfileStore> store, std::string path,
+                        std::chrono::milliseconds interval);
+    ~ProfileCheckpointer(); // Final checkpoint, then joins the thread
+
+    ProfileCheckpointer(const ProfileCheckpointer&) = delete;
+    ProfileCheckpointer& operator=(const ProfileCheckpointer&) = delete;
+
+    // Saves now if the beliefs changed since the last checkpoint. Returns false on I/O error.
+    bool checkpoint();
+    const std::string& path() const { return path_; }
+
+private:
+    void run();
+
+    std::shared_ptr<const HardwareProfileStore> store_;
+    const std::string path_;
+    const std::chrono::milliseconds interval_;
+
+    std::mutex mutex_; // Serializes checkpoints; guards the members below
+    uint64_t saved_version_ = 0; // Published versions start at 1
+    std::condition_variable stop_cv_;
+    bool stop_ = false;
+    std::thread thread_; // Started last
+};
+
+} // namespace VPU
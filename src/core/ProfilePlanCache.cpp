@@ -0,0 +1,139 @@
+#include "core/ProfilePlanCache.h"
+#include "core/TaskDescriptor.h" // For resolved_op, input_element_type
+#include "hal/hal_utils.h" // For fingerprint_buffer, hash_combine
+#include <cstring>         // For std::memcpy
+#include <functional>      // For std::hash
+
+namespace VPU {
+
+ProfilePlanCache::ProfilePlanCache(size_t capacity) : capacity_(capacity) {}
+
+uint64_t ProfilePlanCache::make_key(const VPU_Task& task, const ProfilingPolicy& policy) {
+    // Built-in ops key by op and element type; user-defined tasks by their task_type name.
+    const TaskOp op = resolved_op(task);
+    uint64_t h = HAL::hash_combine(0, op != TaskOp::UNKNOWN ? static_cast<uint64_t>(op) : std::hash<std::string>{}(task.task_type));
+    h = HAL::hash_combine(h, static_cast<uint64_t>(input_element_type(task)));
+    uint64_t bound_bits; // The accuracy bound decides which precisions are planned
+    std::memcpy(&bound_bits, &task.accuracy_bound, sizeof(bound_bits));
+    h = HAL::hash_combine(h, bound_bits);
+    if (task.data_in_a && task.data_in_a_size_bytes > 0) {
+        h = HAL::hash_combine(h, task.data_in_a_size_bytes);
+        h = HAL::hash_combine(h, task.num_elements); // The Cortex profiles min(num_elements, size) values
+        h = HAL::hash_combine(h, task.data_version ? task.data_version
+                                                   : HAL::fingerprint_buffer(task.data_in_a, task.data_in_a_size_bytes));
+    } else if (!task.sparse_a.empty()) {
+        h = HAL::hash_combine(h, 1); // Distinguishes pre-encoded inputs (their plans differ)
+        h = HAL::hash_combine(h, static_cast<uint64_t>(task.sparse_a.rows));
+        h = HAL::hash_combine(h, static_cast<uint64_t>(task.sparse_a.cols));
+        h = HAL::hash_combine(h, task.data_version ? task.data_version
+                                                   : HAL::fingerprint_buffer(task.sparse_a.values, task.sparse_a.nnz() * sizeof(float)));
+    } else {
+        return 0;
+    }
+    // Plans are priced by the problem's dimensions as well as its data.
+    for (const auto& param : task.extended_params) {
+        h = HAL::hash_combine(h, std::hash<std::string>{}(param.first));
+        h = HAL::hash_combine(h, static_cast<uint64_t>(static_cast<int64_t>(param.second)));
+    }
+    h = HAL::hash_combine(h, task.conv_filter.size());
+    // The profile depends on how it was sampled.
+    h = HAL::hash_combine(h, static_cast<uint64_t>(policy.sampling));
+    h = HAL::hash_combine(h, policy.sample_budget);
+    h = HAL::hash_combine(h, policy.exact_below_elements);
+    h = HAL::hash_combine(h, policy.fft_window);
+    h = HAL::hash_combine(h, policy.spectral ? 1 : 0);
+    h = HAL::hash_combine(h, policy.seed);
+    return h ? h : 1; // 0 is reserved for "not cacheable"
+}
+
+std::shared_ptr<const DataProfile> ProfilePlanCache::find_profile(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (key == 0 || it == index_.end()) {
+        ++stats_.profile_misses;
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    ++stats_.profile_hits;
+    return it->second->profile;
+}
+
+bool ProfilePlanCache::find_plans(uint64_t key, uint64_t pricing_stamp, std::vector<ExecutionPlan>& plans) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (key == 0 || it == index_.end() || it->second->plans_pricing_stamp != pricing_stamp) {
+        ++stats_.plan_misses;
+        return false;
+    }
+    plans = it->second->plans;
+    ++stats_.plan_hits;
+    return true;
+}
+
+void ProfilePlanCache::store_profile(uint64_t key, std::shared_ptr<const DataProfile> profile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (key == 0 || !profile || capacity_ == 0) {
+        return;
+    }
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        it->second->profile = std::move(profile);
+        it->second->plans.clear();
+        it->second->plans_pricing_stamp = 0;
+        return;
+    }
+    Entry entry;
+    entry.key = key;
+    entry.profile = std::move(profile);
+    lru_.push_front(std::move(entry));
+    index_[key] = lru_.begin();
+    evict_to_capacity();
+}
+
+void ProfilePlanCache::store_plans(uint64_t key, uint64_t pricing_stamp, const std::vector<ExecutionPlan>& plans) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (key == 0 || it == index_.end()) {
+        return;
+    }
+    it->second->plans = plans;
+    it->second->plans_pricing_stamp = pricing_stamp;
+}
+
+void ProfilePlanCache::set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evict_to_capacity();
+}
+
+void ProfilePlanCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+}
+
+ProfilePlanCache::Stats ProfilePlanCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+size_t ProfilePlanCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+size_t ProfilePlanCache::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+void ProfilePlanCache::evict_to_capacity() {
+    while (lru_.size() > capacity_) {
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+} // namespace VPU
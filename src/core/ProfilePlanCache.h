@@ -0,0 +1,70 @@
+#pragma once
+
+#include "vpu.h"                 // For VPU_Task
+#include "vpu_data_structures.h" // For DataProfile, ExecutionPlan, ProfilingPolicy
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace VPU {
+
+// Memoizes Pillars 2 and 3 for repeat tasks: an LRU map from (task_type, input size, content
+// fingerprint or caller-supplied VPU_Task::data_version, profiling policy) to the DataProfile
+// and the sorted candidate plans. Profiles stay valid until evicted; plans are only returned
+// for the pricing stamp they were stored with (the belief version they were priced against,
+// mixed with any other pricing input such as the JIT kernel cache state). Thread-safe.
+class ProfilePlanCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    explicit ProfilePlanCache(size_t capacity = DEFAULT_CAPACITY);
+
+    // Cache key for 'task' profiled under 'policy'; 0 if the task has no input to key on.
+    static uint64_t make_key(const VPU_Task& task, const ProfilingPolicy& policy);
+
+    // nullptr on a miss. A hit refreshes the entry's LRU position.
+    std::shared_ptr<const DataProfile> find_profile(uint64_t key);
+    // True (and fills 'plans') only if plans stored with 'pricing_stamp' are cached.
+    bool find_plans(uint64_t key, uint64_t pricing_stamp, std::vector<ExecutionPlan>& plans);
+
+    void store_profile(uint64_t key, std::shared_ptr<const DataProfile> profile);
+    // Ignored unless the key's profile is cached (plans are only meaningful for that profile).
+    void store_plans(uint64_t key, uint64_t pricing_stamp, const std::vector<ExecutionPlan>& plans);
+
+    // Capacity 0 disables the cache. Shrinking evicts least recently used entries.
+    void set_capacity(size_t capacity);
+    void clear();
+
+    struct Stats {
+        uint64_t profile_hits = 0;
+        uint64_t profile_misses = 0;
+        uint64_t plan_hits = 0;
+        uint64_t plan_misses = 0; // Includes plans invalidated by a newer pricing stamp
+        uint64_t evictions = 0;
+    };
+    Stats stats() const;
+    size_t size() const;
+    size_t capacity() const;
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        std::shared_ptr<const DataProfile> profile;
+        std::vector<ExecutionPlan> plans;
+        uint64_t plans_pricing_stamp = 0; // 0: no plans cached
+    };
+
+    void evict_to_capacity(); // Requires mutex_
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    std::list<Entry> lru_; // Most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+    Stats stats_;
+};
+
+} // namespace VPU
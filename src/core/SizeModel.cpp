@@ -0,0 +1,107 @@
+#include "core/SizeModel.h"
+#include "vpu.h"               // For VPU_Task
+#include "core/TaskDescriptor.h" // For resolved_op, input_element_type
+#include "hal/convolution.h"   // For the overlap-save layout of FFT work
+#include "hal/cpu_features.h"  // For HAL::cpu_cache_sizes
+#include <algorithm>
+#include <cmath>
+
+namespace VPU {
+
+ProblemShape problem_shape(const VPU_Task& task) {
+    ProblemShape shape;
+    auto dim = [&task](const char* key, uint64_t fallback) -> uint64_t {
+        auto it = task.extended_params.find(key);
+        return it != task.extended_params.end() && it->second > 0 ? static_cast<uint64_t>(it->second) : fallback;
+    };
+    const TaskOp op = resolved_op(task);
+    if (op == TaskOp::GEMM) {
+        // A pre-encoded A is sized by its CSR form when the task leaves M or K out.
+        shape.m = dim("M", task.sparse_a.rows > 0 ? static_cast<uint64_t>(task.sparse_a.rows) : 0);
+        shape.n = dim("N", 0);
+        shape.k = dim("K", task.sparse_a.cols > 0 ? static_cast<uint64_t>(task.sparse_a.cols) : 0);
+        if (!task.sparse_a.empty()) {
+            shape.nonzeros = task.sparse_a.nnz();
+        }
+    }
+    shape.elements = task.num_elements != 0 ? task.num_elements : shape.m * shape.k;
+    shape.taps = task.conv_filter.size();
+
+    // Buffers the task reads and writes. Unsized GEMM buffers are sized from M, N, K, other
+    // unsized inputs from num_elements; an unsized output is assumed as large as data_in_a.
+    const uint64_t element_bytes = HAL::element_size(input_element_type(task));
+    uint64_t in_a = task.data_in_a_size_bytes, in_b = task.data_in_b_size_bytes, out = task.data_out_size_bytes;
+    if (op == TaskOp::GEMM) {
+        if (in_a == 0) in_a = shape.m * shape.k * element_bytes;
+        if (in_b == 0) in_b = shape.k * shape.n * element_bytes;
+        if (out == 0) out = shape.m * shape.n * element_bytes;
+    } else if (in_a == 0 && task.data_in_a) {
+        in_a = task.num_elements * element_bytes;
+    }
+    shape.working_set_bytes = in_a + in_b + (out != 0 ? out : in_a);
+    shape.cache_regime = cache_regime_for(shape.working_set_bytes);
+    return shape;
+}
+
+CacheRegime cache_regime_for(uint64_t working_set_bytes) {
+    const HAL::CacheSizes& caches = HAL::cpu_cache_sizes();
+    if (working_set_bytes <= caches.l1d_bytes) return CACHE_L1;
+    if (working_set_bytes <= caches.l2_bytes) return CACHE_L2;
+    if (working_set_bytes <= caches.l3_bytes) return CACHE_L3;
+    return CACHE_DRAM;
+}
+
+double input_density(const ProblemShape& shape, const DataProfile& profile) {
+    if (shape.nonzeros != 0 && shape.m != 0 && shape.k != 0) {
+        return std::min(1.0, static_cast<double>(shape.nonzeros) / (static_cast<double>(shape.m) * shape.k));
+    }
+    if (profile.input_stats.elements > 0) {
+        return 1.0 - profile.input_stats.zero_ratio();
+    }
+    return 1.0 - profile.sparsity_ratio;
+}
+
+double work_units(Complexity complexity, const ProblemShape& shape, double density) {
+    const double elements = static_cast<double>(shape.elements);
+    const double mnk = static_cast<double>(shape.m) * static_cast<double>(shape.n) * static_cast<double>(shape.k);
+    switch (complexity) {
+        case Complexity::NONE:
+            return 0.0;
+        case Complexity::LINEAR:
+            return elements;
+        case Complexity::N_LOG_N: {
+            if (shape.taps != 0) {
+                // Overlap-save: one transform of the padded block length per block.
+                const HAL::OverlapSaveLayout layout = HAL::plan_overlap_save(shape.elements, shape.taps);
+                if (!layout.valid()) return 0.0;
+                const double length = static_cast<double>(layout.fft_length);
+                return static_cast<double>(layout.blocks) * length * std::log2(length);
+            }
+            return elements > 1.0 ? elements * std::log2(elements) : 0.0;
+        }
+        case Complexity::N_TAPS:
+            return elements * static_cast<double>(shape.taps);
+        case Complexity::SPARSE_MNK:
+            return mnk * std::max(0.0, std::min(1.0, density));
+        case Complexity::MNK:
+            return mnk;
+    }
+    return 0.0;
+}
+
+SizeModel fused_size_model(const SizeModel* first, const SizeModel* second, double cost_prior) {
+    SizeModel fused;
+    for (const SizeModel* component : {first, second}) {
+        if (!component || component->complexity < fused.complexity) continue;
+        if (component->complexity > fused.complexity) {
+            fused = SizeModel{};
+            fused.complexity = component->complexity;
+        }
+        for (int regime = 0; regime < CACHE_REGIME_COUNT; ++regime) {
+            fused.per_unit[regime] += cost_prior * component->per_unit[regime];
+        }
+    }
+    return fused;
+}
+
+} // namespace VPU
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "vpu_data_structures.h" // For ProblemShape, DataProfile
+#include "core/HardwareProfile.h" // For SizeModel, Complexity
+#include <cstdint>
+
+namespace VPU {
+
+struct VPU_Task;
+
+// Size-aware pricing: a step costs its base (or transform) cost plus
+//   SizeModel::per_unit[cache regime] * work_units(complexity, shape)
+// so predictions follow the kernels' cycle costs (2N / lanes for SAXPY, 2MNK / lanes for GEMM,
+// 5 L log2 L per FFT block, ...) as the data grows, and crossovers such as direct vs. FFT
+// convolution fall where the learned coefficients put them.
+
+// The task's dimensions and working set, and the cache regime that working set falls in on this host.
+ProblemShape problem_shape(const VPU_Task& task);
+
+// The smallest cache level (HAL::cpu_cache_sizes()) that holds 'working_set_bytes'.
+CacheRegime cache_regime_for(uint64_t working_set_bytes);
+
+// Fraction of A's values that are non-zero: exact for a pre-encoded A, otherwise from the
+// profile's scan of the input (its bit-level sparsity when no element counts were kept).
+double input_density(const ProblemShape& shape, const DataProfile& profile);
+
+// Units of work an operation of 'complexity' does on 'shape'. 0 if the shape lacks the
+// dimensions the complexity needs (e.g. MNK for a task without M, N, K).
+double work_units(Complexity complexity, const ProblemShape& shape, double density);
+
+// Prior for a fused operation: the model of its faster-growing component (both summed when
+// they grow alike), scaled by the rule's cost prior. NONE if neither component has a model.
+SizeModel fused_size_model(const SizeModel* first, const SizeModel* second, double cost_prior);
+
+} // namespace VPU
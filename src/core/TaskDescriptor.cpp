@@ -0,0 +1,165 @@
+#include "core/TaskDescriptor.h"
+#include <limits>
+
+namespace VPU {
+
+const char* task_op_name(TaskOp op) {
+    switch (op) {
+        case TaskOp::SAXPY: return "SAXPY";
+        case TaskOp::GEMM: return "GEMM";
+        case TaskOp::CONVOLUTION: return "CONVOLUTION";
+        case TaskOp::FFT: return "FFT";
+        default: return "";
+    }
+}
+
+TaskOp task_op_from_name(const std::string& task_type) {
+    if (task_type == "SAXPY") return TaskOp::SAXPY;
+    if (task_type == "GEMM") return TaskOp::GEMM;
+    if (task_type == "CONVOLUTION") return TaskOp::CONVOLUTION;
+    if (task_type.compare(0, 3, "FFT") == 0) return TaskOp::FFT;
+    return TaskOp::UNKNOWN;
+}
+
+TaskOp resolved_op(const VPU_Task& task) {
+    return task.op != TaskOp::UNKNOWN ? task.op : task_op_from_name(task.task_type);
+}
+
+std::string task_label(const VPU_Task& task) {
+    return task.task_type.empty() ? std::string(task_op_name(task.op)) : task.task_type;
+}
+
+HAL::ElementType default_element_type(TaskOp op) {
+    return op == TaskOp::CONVOLUTION || op == TaskOp::FFT ? HAL::ElementType::FLOAT64 : HAL::ElementType::FLOAT32;
+}
+
+HAL::ElementType input_element_type(const VPU_Task& task) {
+    return task.operands.empty() ? default_element_type(resolved_op(task)) : task.operands.front().dtype;
+}
+
+namespace {
+
+size_t operand_count(TaskOp op) {
+    switch (op) {
+        case TaskOp::SAXPY: return 2;
+        case TaskOp::GEMM: return 3;
+        case TaskOp::CONVOLUTION: return 3;
+        case TaskOp::FFT: return 2;
+        default: return 0;
+    }
+}
+
+bool check_operands(const VPU_Task& task, TaskOp op, std::string& error) {
+    const std::vector<TaskOperand>& operands = task.operands;
+    if (operands.size() != operand_count(op)) {
+        error = std::string(task_op_name(op)) + " takes " + std::to_string(operand_count(op)) + " operands, got " +
+                std::to_string(operands.size());
+        return false;
+    }
+    for (size_t i = 0; i < operands.size(); ++i) {
+        const TaskOperand& operand = operands[i];
+        if (operand.rank == 0 || operand.rank > TaskOperand::MAX_RANK) {
+            error = "operand " + std::to_string(i) + " has rank " + std::to_string(operand.rank);
+            return false;
+        }
+        if (!operand.packed()) {
+            error = "operand " + std::to_string(i) + " is strided; kernels need packed row-major operands";
+            return false;
+        }
+        if (operand.dtype != operands.front().dtype) {
+            error = "operand " + std::to_string(i) + " is " + HAL::element_type_name(operand.dtype) + ", operand 0 is " +
+                    HAL::element_type_name(operands.front().dtype);
+            return false;
+        }
+    }
+    switch (op) {
+        case TaskOp::SAXPY:
+            if (operands[0].elements() != operands[1].elements()) {
+                error = "SAXPY x and y differ in length";
+                return false;
+            }
+            break;
+        case TaskOp::GEMM:
+            for (const TaskOperand& operand : operands) {
+                if (operand.rank != 2) {
+                    error = "GEMM operands must be matrices";
+                    return false;
+                }
+            }
+            if (operands[0].shape[1] != operands[1].shape[0] || operands[2].shape[0] != operands[0].shape[0] ||
+                operands[2].shape[1] != operands[1].shape[1]) {
+                error = "GEMM shapes do not chain (A is MxK, B is KxN, C is MxN)";
+                return false;
+            }
+            for (const TaskOperand& operand : operands) {
+                if (operand.shape[0] > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+                    operand.shape[1] > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+                    error = "GEMM dimensions exceed the kernels' int range";
+                    return false;
+                }
+            }
+            break;
+        case TaskOp::CONVOLUTION:
+            if (operands[2].elements() < operands[0].elements()) {
+                error = "CONVOLUTION output is shorter than the signal";
+                return false;
+            }
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+// The legacy fields the kernels and the rest of the pipeline read, from checked operands.
+void legacy_from_operands(VPU_Task& task, TaskOp op) {
+    const std::vector<TaskOperand>& operands = task.operands;
+    const TaskOperand& input = operands.front();
+    const TaskOperand& output = operands.back();
+    task.data_in_a = input.data;
+    task.data_in_a_size_bytes = input.size_bytes();
+    task.data_out = output.data;
+    task.data_out_size_bytes = output.size_bytes();
+    task.num_elements = static_cast<size_t>(input.elements());
+    switch (op) {
+        case TaskOp::GEMM:
+            task.data_in_b = operands[1].data;
+            task.data_in_b_size_bytes = operands[1].size_bytes();
+            task.extended_params["M"] = static_cast<int>(input.shape[0]);
+            task.extended_params["K"] = static_cast<int>(input.shape[1]);
+            task.extended_params["N"] = static_cast<int>(operands[1].shape[1]);
+            break;
+        case TaskOp::CONVOLUTION:
+            if (input.dtype == HAL::ElementType::FLOAT64) {
+                task.conv_filter = HAL::Span<const double>(static_cast<const double*>(operands[1].data),
+                                                           static_cast<size_t>(operands[1].elements()));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace
+
+bool describe_task(VPU_Task& task, std::string& error) {
+    if (task.op != TaskOp::UNKNOWN && !task.task_type.empty() && task_op_from_name(task.task_type) != task.op) {
+        error = "task_type '" + task.task_type + "' contradicts op " + task_op_name(task.op);
+        return false;
+    }
+    if (task.operands.empty()) {
+        return true; // Legacy buffers: their element type is the op's default
+    }
+    const TaskOp op = resolved_op(task);
+    if (op == TaskOp::UNKNOWN) {
+        error = "typed operands need a built-in op";
+        return false;
+    }
+    if (!check_operands(task, op, error)) {
+        return false;
+    }
+    legacy_from_operands(task, op);
+    return true;
+}
+
+} // namespace VPU
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "vpu.h" // For VPU_Task, TaskOperand, TaskOp
+#include <string>
+
+namespace VPU {
+
+// Typed task descriptors: every pillar reads a task's operation and element type from here
+// instead of comparing task_type strings or assuming what data_in_a points to.
+
+// The task's op, or the one its task_type names when op is unset.
+TaskOp resolved_op(const VPU_Task& task);
+
+// What an op's untyped (legacy) buffers hold: f32 for SAXPY and GEMM, f64 for CONVOLUTION and FFT.
+HAL::ElementType default_element_type(TaskOp op);
+
+// Element type of the task's inputs: its first operand's dtype, or the op's default.
+HAL::ElementType input_element_type(const VPU_Task& task);
+
+// The name the task goes by in logs and plan statistics: task_type, or else its op's name.
+std::string task_label(const VPU_Task& task);
+
+// Checks a task's descriptor at intake and, for typed tasks, fills the legacy fields the kernels
+// read (data pointers, sizes, num_elements, M/N/K, conv_filter) from the operands, which win.
+// Legacy tasks are left as they are, so callers may keep refilling and resubmitting them.
+// Returns false with 'error' set if op and task_type disagree or the operands cannot describe
+// the op (wrong count or rank, mismatched shapes, mixed dtypes, or strided layouts).
+bool describe_task(VPU_Task& task, std::string& error);
+
+} // namespace VPU
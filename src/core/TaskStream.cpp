@@ -0,0 +1,152 @@
+#include "core/TaskStream.h"
+#include "core/TaskDescriptor.h" // For resolved_op, default_element_type
+#include "hal/cpu_features.h"    // For HAL::cpu_cache_sizes
+#include <cstring>               // For std::memcpy
+#include <limits>
+
+namespace VPU {
+
+namespace {
+
+int extended_param(const VPU_Task& task, const char* key) {
+    auto it = task.extended_params.find(key);
+    return it != task.extended_params.end() ? it->second : 0;
+}
+
+// Input bytes per chunk when the task leaves it to the VPU: a quarter of the last-level cache,
+// so the chunk being computed and the one being prefetched fit there with their outputs.
+uint64_t default_chunk_bytes() {
+    const HAL::CacheSizes& caches = HAL::cpu_cache_sizes();
+    return std::max(caches.l3_bytes, caches.l2_bytes) / 4;
+}
+
+} // namespace
+
+bool check_stream(const VPU_Task& task, std::string& error) {
+    const TaskOp op = resolved_op(task);
+    if (op != TaskOp::SAXPY && op != TaskOp::GEMM && op != TaskOp::CONVOLUTION) {
+        error = "only SAXPY, GEMM and CONVOLUTION tasks can be streamed";
+        return false;
+    }
+    if (!task.operands.empty()) {
+        error = "streamed tasks read their data from files, not operands";
+        return false;
+    }
+    if (task.stream.output_path.empty() || task.stream.output_path == task.stream.input_path) {
+        error = "streamed tasks need an output file distinct from the input";
+        return false;
+    }
+    if (task.stream.input_offset % HAL::element_size(default_element_type(op)) != 0) {
+        error = "stream input_offset is not a whole number of elements";
+        return false;
+    }
+    if (op == TaskOp::GEMM &&
+        (!task.data_in_b || extended_param(task, "N") <= 0 || extended_param(task, "K") <= 0 || extended_param(task, "M") < 0)) {
+        error = "streamed GEMM needs B in data_in_b and positive N and K";
+        return false;
+    }
+    if (!task.sparse_a.empty()) {
+        error = std::string("streamed ") + task_op_name(op) + " reads its input from the file, so sparse_a must be empty";
+        return false;
+    }
+    if (op == TaskOp::CONVOLUTION && task.conv_filter.empty()) {
+        error = "streamed CONVOLUTION needs conv_filter taps";
+        return false;
+    }
+    return true;
+}
+
+bool StreamSession::open(const VPU_Task& task, std::string& error) {
+    const TaskOp op = resolved_op(task);
+    task_ = task;
+    task_.stream = TaskStream();
+    input_offset_ = task.stream.input_offset;
+    element_bytes_ = HAL::element_size(default_element_type(op));
+    const uint64_t K = op == TaskOp::GEMM ? static_cast<uint64_t>(extended_param(task, "K")) : 1;
+    const uint64_t N = op == TaskOp::GEMM ? static_cast<uint64_t>(extended_param(task, "N")) : 1;
+    in_row_bytes_ = K * element_bytes_;
+    out_row_bytes_ = N * element_bytes_;
+    overlap_rows_ = op == TaskOp::CONVOLUTION ? task.conv_filter.size() - 1 : 0;
+
+    if (!input_.open_read(task.stream.input_path)) {
+        error = "cannot map input '" + task.stream.input_path + "'";
+        return false;
+    }
+    const uint64_t available = input_.size() > input_offset_ ? input_.size() - input_offset_ : 0;
+    const uint64_t requested = op == TaskOp::GEMM ? static_cast<uint64_t>(extended_param(task, "M")) : task.num_elements;
+    if (requested == 0 && available % in_row_bytes_ != 0) {
+        error = "input '" + task.stream.input_path + "' does not hold whole rows of " + std::to_string(K) + " values";
+        return false;
+    }
+    rows_ = requested != 0 ? requested : available / in_row_bytes_;
+    if (rows_ == 0 || rows_ * in_row_bytes_ > available) {
+        error = "input '" + task.stream.input_path + "' holds " + std::to_string(available / in_row_bytes_) + " of the " +
+                std::to_string(rows_) + " rows to stream";
+        return false;
+    }
+
+    // Whole pages of input per chunk where a row fits in one, at least one row, and never
+    // shorter than a convolution's overlap (which every chunk recomputes).
+    const uint64_t page = HAL::MappedFile::page_size();
+    uint64_t chunk_bytes = task.stream.chunk_bytes != 0 ? task.stream.chunk_bytes : default_chunk_bytes();
+    if (chunk_bytes >= page) {
+        chunk_bytes = chunk_bytes / page * page;
+    }
+    chunk_rows_ = std::max<uint64_t>({1, chunk_bytes / in_row_bytes_, overlap_rows_});
+    if (op == TaskOp::GEMM) {
+        chunk_rows_ = std::min<uint64_t>(chunk_rows_, std::numeric_limits<int>::max());
+    }
+    chunks_ = static_cast<size_t>((rows_ + chunk_rows_ - 1) / chunk_rows_);
+
+    if (!output_.open_write(task.stream.output_path, rows_ * out_row_bytes_)) {
+        error = "cannot map output '" + task.stream.output_path + "'";
+        return false;
+    }
+    return true;
+}
+
+VPU_Task StreamSession::chunk_task(size_t c) const {
+    VPU_Task chunk = task_;
+    const uint64_t window = window_row(c);
+    const uint64_t rows = end_row(c) - window;
+    chunk.data_in_a = input_.data() + input_offset_ + window * in_row_bytes_;
+    chunk.data_in_a_size_bytes = static_cast<size_t>(rows * in_row_bytes_);
+    chunk.data_out = const_cast<uint8_t*>(output_.data()) + window * out_row_bytes_;
+    chunk.data_out_size_bytes = static_cast<size_t>(rows * out_row_bytes_);
+    if (resolved_op(task_) == TaskOp::GEMM) {
+        chunk.extended_params["M"] = static_cast<int>(rows);
+        chunk.num_elements = static_cast<size_t>(rows * (in_row_bytes_ / element_bytes_));
+    } else {
+        chunk.num_elements = static_cast<size_t>(rows);
+    }
+    return chunk;
+}
+
+HAL::Span<const uint8_t> StreamSession::fresh_input(size_t c) const {
+    return HAL::Span<const uint8_t>(input_.data() + input_offset_ + first_row(c) * in_row_bytes_,
+                                    static_cast<size_t>((end_row(c) - first_row(c)) * in_row_bytes_));
+}
+
+void StreamSession::prefetch(size_t c) const {
+    if (c >= chunks_) return;
+    input_.prefetch(input_offset_ + window_row(c) * in_row_bytes_, (end_row(c) - window_row(c)) * in_row_bytes_);
+    output_.prefetch(first_row(c) * out_row_bytes_, (end_row(c) - first_row(c)) * out_row_bytes_);
+}
+
+void StreamSession::begin(size_t c) {
+    const uint64_t window = window_row(c);
+    const uint8_t* warm_up = output_.data() + window * out_row_bytes_;
+    saved_outputs_.assign(warm_up, warm_up + (first_row(c) - window) * out_row_bytes_);
+}
+
+void StreamSession::end(size_t c) {
+    if (!saved_outputs_.empty()) {
+        std::memcpy(output_.mutable_data() + window_row(c) * out_row_bytes_, saved_outputs_.data(), saved_outputs_.size());
+    }
+    // A convolution chunk's last rows are the next chunk's overlap: that chunk releases them.
+    const uint64_t keep = c + 1 < chunks_ ? overlap_rows_ : 0;
+    input_.release(input_offset_ + window_row(c) * in_row_bytes_, (end_row(c) - keep - window_row(c)) * in_row_bytes_);
+    output_.release(first_row(c) * out_row_bytes_, (end_row(c) - first_row(c)) * out_row_bytes_);
+}
+
+} // namespace VPU
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "vpu.h"                // For VPU_Task, TaskStream
+#include "hal/mapped_file.h"    // For HAL::MappedFile
+#include "hal/span.h"
+#include <algorithm> // For std::min
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace VPU {
+
+// Streamed tasks (VPU_Task::stream): the input and output files are mapped, and the task runs as
+// a sequence of chunk tasks, ordinary in-memory tasks whose buffers point into the mappings. Each
+// chunk is prefetched while the one before it computes and released once it has run, so only a
+// few chunks are resident at a time.
+
+// Checks a streamed task at intake: a SAXPY, GEMM or CONVOLUTION with distinct input and output
+// paths, no operands or sparse_a, and the in-memory data its op still needs (B with N and K for
+// GEMM, filter taps for CONVOLUTION). Returns false with 'error' set otherwise. The files are
+// opened later, by StreamSession::open.
+bool check_stream(const VPU_Task& task, std::string& error);
+
+class StreamSession {
+public:
+    // Maps the task's files and lays out its chunks. Returns false with 'error' set if a file
+    // cannot be mapped or the input is empty, shorter than num_elements (M for GEMM), or (GEMM
+    // without M) not a whole number of K-value rows.
+    bool open(const VPU_Task& task, std::string& error);
+
+    size_t chunks() const { return chunks_; }
+    uint64_t rows() const { return rows_; } // Input elements streamed; rows of A for GEMM
+
+    // Chunk c as an in-memory task: the stream's task with data_in_a, data_out, their sizes and
+    // num_elements (M for GEMM) narrowed to the chunk. A convolution chunk starts taps - 1
+    // samples early, so its first outputs are only warm-up (see begin/end).
+    VPU_Task chunk_task(size_t c) const;
+    // The input chunk c adds to the stream, without the samples it shares with chunk c - 1.
+    HAL::Span<const uint8_t> fresh_input(size_t c) const;
+
+    // Asks for chunk c's input and output pages ahead of use.
+    void prefetch(size_t c) const;
+    // Bracket the run of chunk c. A convolution chunk's warm-up outputs overwrite the end of the
+    // previous chunk's, so begin saves those and end puts them back; end then releases the chunk.
+    // Prefer ChunkScope, which calls end even if the run throws.
+    void begin(size_t c);
+    void end(size_t c);
+
+    // Calls begin(c) on construction and end(c) on destruction.
+    class ChunkScope {
+    public:
+        ChunkScope(StreamSession& stream, size_t c) : stream_(stream), chunk_(c) { stream_.begin(chunk_); }
+        ~ChunkScope() { stream_.end(chunk_); }
+        ChunkScope(const ChunkScope&) = delete;
+        ChunkScope& operator=(const ChunkScope&) = delete;
+
+    private:
+        StreamSession& stream_;
+        size_t chunk_;
+    };
+
+private:
+    uint64_t first_row(size_t c) const { return static_cast<uint64_t>(c) * chunk_rows_; }
+    uint64_t end_row(size_t c) const { return std::min(rows_, first_row(c) + chunk_rows_); }
+    uint64_t window_row(size_t c) const { return first_row(c) - std::min<uint64_t>(first_row(c), overlap_rows_); }
+
+    VPU_Task task_; // With the stream cleared, so chunk tasks run in memory
+    HAL::MappedFile input_;
+    HAL::MappedFile output_;
+    uint64_t input_offset_ = 0;
+    size_t element_bytes_ = 0;
+    uint64_t in_row_bytes_ = 0;  // Input bytes per row: one element, or K for GEMM
+    uint64_t out_row_bytes_ = 0; // Output bytes per row: one element, or N for GEMM
+    uint64_t rows_ = 0;
+    uint64_t chunk_rows_ = 0;
+    uint64_t overlap_rows_ = 0;  // Filter taps - 1 for CONVOLUTION
+    size_t chunks_ = 0;
+    std::vector<uint8_t> saved_outputs_; // Outputs a convolution chunk's warm-up overwrites
+};
+
+} // namespace VPU
@@ -0,0 +1,134 @@
+#include "core/TelemetryPoller.h"
+#include "IoTClient.h"
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <algorithm> // For std::min
+#include <atomic>
+#include <map>
+
+namespace VPU {
+
+std::vector<TelemetryPoller::Source> TelemetryPoller::default_sources() {
+    return {{"power_sensor_001", "current_watts", TelemetrySnapshot::POWER},
+            {"thermal_sensor_001", "current_temp_c", TelemetrySnapshot::TEMPERATURE},
+            {"network_monitor_001", "latency_ms", TelemetrySnapshot::NET_LATENCY},
+            {"network_monitor_001", "bandwidth_mbps", TelemetrySnapshot::NET_BANDWIDTH},
+            {"storage_monitor_001", "throughput_mbps", TelemetrySnapshot::IO_THROUGHPUT},
+            {"data_quality_sensor_001", "score", TelemetrySnapshot::DATA_QUALITY}};
+}
+
+double TelemetryPoller::nominal_value(TelemetrySnapshot::Field field) {
+    // The readings Pillar 2 has always assumed without live sensors.
+    switch (field) {
+        case TelemetrySnapshot::POWER: return 75.5;
+        case TelemetrySnapshot::TEMPERATURE: return 65.2;
+        case TelemetrySnapshot::NET_LATENCY: return 15.3;
+        case TelemetrySnapshot::NET_BANDWIDTH: return 980.0;
+        case TelemetrySnapshot::IO_THROUGHPUT: return 250.0;
+        case TelemetrySnapshot::DATA_QUALITY: return 0.95;
+        case TelemetrySnapshot::FIELD_COUNT: break;
+    }
+    return 0.0;
+}
+
+uint64_t TelemetryPoller::now_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+TelemetryPoller::TelemetryPoller(Fetcher fetch, std::chrono::milliseconds interval, std::vector<Source> sources)
+    : fetch_(std::move(fetch)), interval_(std::max(interval, std::chrono::milliseconds(1))), sources_(std::move(sources)),
+      current_(std::make_shared<const TelemetrySnapshot>()) {
+    thread_ = std::thread(&TelemetryPoller::poll_loop, this);
+}
+
+TelemetryPoller::~TelemetryPoller() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        stop_ = true;
+    }
+    stop_cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::shared_ptr<const TelemetrySnapshot> TelemetryPoller::snapshot() const {
+    return std::atomic_load(&current_);
+}
+
+void TelemetryPoller::apply(DataProfile& profile, std::chrono::milliseconds max_age) const {
+    std::shared_ptr<const TelemetrySnapshot> readings = snapshot();
+    const uint64_t now = now_ns();
+    const uint64_t max_age_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(max_age).count());
+    auto value = [&](TelemetrySnapshot::Field field) {
+        return readings->fresh(field, now, max_age_ns) ? readings->values[field] : nominal_value(field);
+    };
+    profile.power_draw_watts = value(TelemetrySnapshot::POWER);
+    profile.temperature_celsius = value(TelemetrySnapshot::TEMPERATURE);
+    profile.network_latency_ms = value(TelemetrySnapshot::NET_LATENCY);
+    profile.network_bandwidth_mbps = value(TelemetrySnapshot::NET_BANDWIDTH);
+    profile.io_throughput_mbps = value(TelemetrySnapshot::IO_THROUGHPUT);
+    profile.data_quality_score = value(TelemetrySnapshot::DATA_QUALITY);
+}
+
+bool TelemetryPoller::poll_once() {
+    auto next = std::make_shared<TelemetrySnapshot>(*snapshot());
+    std::map<std::string, nlohmann::json> statuses; // One request per device
+    bool any_answered = false;
+    for (const Source& source : sources_) {
+        auto it = statuses.find(source.device_id);
+        if (it == statuses.end()) {
+            nlohmann::json status;
+            try {
+                status = fetch_(source.device_id);
+            } catch (const std::exception& e) {
+                VPU_LOG_DEBUG("[Telemetry] Fetching '" << source.device_id << "' failed: " << e.what());
+            }
+            it = statuses.emplace(source.device_id, std::move(status)).first;
+        }
+        const nlohmann::json& status = it->second;
+        auto reading = status.is_object() ? status.find(source.key) : status.end();
+        if (status.is_object() && reading != status.end() && reading->is_number()) {
+            next->values[source.field] = reading->get<double>();
+            next->updated_ns[source.field] = now_ns();
+            any_answered = true;
+        }
+    }
+    ++next->polls;
+    if (!any_answered) {
+        ++next->failed_polls;
+    }
+    std::atomic_store(&current_, std::shared_ptr<const TelemetrySnapshot>(std::move(next)));
+    return any_answered;
+}
+
+void TelemetryPoller::poll_loop() {
+    std::chrono::milliseconds wait = interval_;
+    bool reachable = true; // Log state changes only
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    while (!stop_) {
+        lock.unlock();
+        const bool answered = poll_once();
+        lock.lock();
+        if (answered != reachable) {
+            reachable = answered;
+            if (reachable) {
+                VPU_LOG_INFO("[Telemetry] IoT sensors are answering again.");
+            } else {
+                VPU_LOG_WARN("[Telemetry] No IoT sensor answered; using nominal readings and backing off.");
+            }
+        }
+        wait = answered ? interval_ : std::min(wait * 2, interval_ * 16);
+        stop_cv_.wait_for(lock, wait, [this] { return stop_; });
+    }
+}
+
+std::unique_ptr<TelemetryPoller> make_iot_telemetry_poller(const std::string& host, int port,
+                                                           std::chrono::milliseconds interval) {
+    auto client = std::make_shared<IoTClient>(host, port);
+    client->set_log_failures(false); // The poller reports reachability changes itself
+    return std::unique_ptr<TelemetryPoller>(new TelemetryPoller(
+        [client](const std::string& device_id) { return client->getDeviceStatus(device_id); }, interval));
+}
+
+} // namespace VPU
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "vpu_data_structures.h" // For DataProfile
+#include <nlohmann/json.hpp>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace VPU {
+
+// Latest IoT sensor readings. Each field carries the steady-clock time it was last read
+// (0: never), so readers can tell live values from stale ones. Published whole and immutable.
+struct TelemetrySnapshot {
+    enum Field { POWER, TEMPERATURE, NET_LATENCY, NET_BANDWIDTH, IO_THROUGHPUT, DATA_QUALITY, FIELD_COUNT };
+
+    std::array<double, FIELD_COUNT> values{};
+    std::array<uint64_t, FIELD_COUNT> updated_ns{};
+    uint64_t polls = 0;          // Completed polling rounds
+    uint64_t failed_polls = 0;   // Rounds in which no sensor answered
+
+    bool fresh(Field field, uint64_t now_ns, uint64_t max_age_ns) const {
+        return updated_ns[field] != 0 && now_ns - updated_ns[field] <= max_age_ns;
+    }
+};
+
+// Polls the IoT framework's sensors on a background thread and publishes the readings
+// read-copy-update, so Pillar 2 reads them with one atomic load instead of one HTTP round
+// trip per sensor per task. Unanswered rounds back off exponentially (up to 16x the interval).
+class TelemetryPoller {
+public:
+    // Returns the device's status JSON (GET /devices/<id>/status), or an empty json on failure.
+    using Fetcher = std::function<nlohmann::json(const std::string& device_id)>;
+    // One reading: 'key' of the device's status JSON goes into 'field'.
+    struct Source {
+        std::string device_id;
+        std::string key;
+        TelemetrySnapshot::Field field;
+    };
+    // The power, thermal, network, storage and data quality sensors of iot_framework/virtual_device_layer.py.
+    static std::vector<Source> default_sources();
+    // What Pillar 2 assumes for a sensor that has no fresh reading.
+    static double nominal_value(TelemetrySnapshot::Field field);
+
+    // Starts polling immediately. Sources of one device are read with a single request.
+    TelemetryPoller(Fetcher fetch, std::chrono::milliseconds interval, std::vector<Source> sources = default_sources());
+    ~TelemetryPoller(); // Stops and joins the polling thread
+
+    TelemetryPoller(const TelemetryPoller&) = delete;
+    TelemetryPoller& operator=(const TelemetryPoller&) = delete;
+
+    std::shared_ptr<const TelemetrySnapshot> snapshot() const;
+
+    // Copies the readings younger than 'max_age' into 'profile'; the others get nominal values.
+    void apply(DataProfile& profile, std::chrono::milliseconds max_age) const;
+
+    static uint64_t now_ns(); // The clock of TelemetrySnapshot::updated_ns
+
+private:
+    void poll_loop();
+    bool poll_once(); // False if no sensor answered
+
+    Fetcher fetch_;
+    std::chrono::milliseconds interval_;
+    std::vector<Source> sources_;
+
+    std::shared_ptr<const TelemetrySnapshot> current_; // Accessed only through std::atomic_load/std::atomic_store
+
+    std::mutex stop_mutex_;
+    std::condition_variable stop_cv_;
+    bool stop_ = false; // Guarded by stop_mutex_
+    std::thread thread_; // Started last, after everything it reads
+};
+
+// A poller over keep-alive HTTP requests to the IoT framework at host:port.
+std::unique_ptr<TelemetryPoller> make_iot_telemetry_poller(const std::string& host, int port,
+                                                           std::chrono::milliseconds interval);
+
+} // namespace VPU
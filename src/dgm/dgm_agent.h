@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 #include <optional> // For optional parent_id
+#include <cstddef>  // For size_t
+#include <cmath>    // For std::exp
 
 namespace DGM {
 
@@ -13,6 +15,23 @@ using AgentIdType = int; // Or std::string for UUIDs later
 const double LAMBDA_PARAM = 10.0;
 const double ALPHA_NAUGHT_PARAM = 0.5; // Performance midpoint
 
+// Parent selection weight: the sigmoid-scaled performance s_i times the novelty bonus
+// h_i = 1 / (1 + children), which decays as an agent is picked again and again.
+inline double selection_weight(double performance_score, int children_count) {
+    const double scaled_performance = 1.0 / (1.0 + std::exp(-LAMBDA_PARAM * (performance_score - ALPHA_NAUGHT_PARAM)));
+    const double novelty_bonus = 1.0 / (1.0 + static_cast<double>(children_count));
+    return scaled_performance * novelty_bonus;
+}
+
+// The VPU configuration an agent is benchmarked under (see BenchmarkHarness). This is what
+// self-modification changes, so the performance score measures a real difference between agents.
+struct AgentGenome {
+    bool pipelined = false;           // VPU_Environment::set_pipelined_mode
+    size_t batch_size = 1;            // Tasks per submit_batch() call; 1 runs each task with execute()
+    size_t plan_cache_capacity = 256; // VPU_Environment::set_plan_cache_capacity
+    bool sampled_profiling = false;   // STRIDED profiling for every task instead of the per-type default
+};
+
 struct Agent {
     AgentIdType agent_id;
     std::optional<AgentIdType> parent_id; // Parent's ID, std::nullopt for initial agent
@@ -21,6 +40,7 @@ struct Agent {
     std::string evaluation_log; // To store benchmark results or LLM feedback analysis
     int children_count;
     int creation_iteration;     // Iteration number when this agent was created
+    AgentGenome genome;         // Inherited from the parent, then mutated by self_modify
 
     // Constructor for easier initialization
     Agent(AgentIdType id,
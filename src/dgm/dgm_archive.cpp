@@ -1,58 +1,176 @@
 #include "dgm_archive.h"
+#include <algorithm> // For std::sort
 #include <string> // Required for std::to_string in error messages
 
 namespace DGM {
 
-AgentArchive::AgentArchive() {
-    // Constructor, if any specific initialization is needed
-}
+AgentArchive::AgentArchive(size_t resident_text_budget_bytes) : texts_(resident_text_budget_bytes) {}
 
 void AgentArchive::add_agent(const Agent& agent) {
-    if (agents_.count(agent.agent_id)) {
-        // Handle duplicate agent ID, e.g., throw error or log warning
-        // For now, let's overwrite, but this might need a strategy
-        // Or, better, ensure IDs are always unique before adding.
-        // Consider: throw std::runtime_error("Attempted to add agent with duplicate ID: " + std::to_string(agent.agent_id));
+    const auto existing = rows_.find(agent.agent_id);
+    size_t row;
+    if (existing != rows_.end()) {
+        // Same ID: the new agent replaces the stored one. IDs should be unique, so this is an update.
+        row = existing->second;
+    } else {
+        row = ids_.size();
+        rows_.emplace(agent.agent_id, row);
+        ids_.push_back(agent.agent_id);
+        parent_ids_.emplace_back();
+        scores_.push_back(0.0);
+        children_counts_.push_back(0);
+        creation_iterations_.push_back(0);
+        genomes_.emplace_back();
+        sources_.push_back(0);
+        logs_.push_back(0);
+        weights_.push_back(0.0);
     }
-    agents_[agent.agent_id] = agent;
+    parent_ids_[row] = agent.parent_id;
+    scores_[row] = agent.performance_score;
+    children_counts_[row] = agent.children_count;
+    creation_iterations_[row] = agent.creation_iteration;
+    genomes_[row] = agent.genome;
+    sources_[row] = texts_.put(agent.source_code_representation);
+    logs_[row] = texts_.put(agent.evaluation_log);
+    update_weight(row);
+}
+
+Agent AgentArchive::get_agent(AgentIdType agent_id) const {
+    const size_t row = row_of(agent_id);
+    Agent agent(ids_[row], parent_ids_[row], texts_.get(sources_[row]), creation_iterations_[row],
+                scores_[row], texts_.get(logs_[row]), children_counts_[row]);
+    agent.genome = genomes_[row];
+    return agent;
+}
+
+bool AgentArchive::has_agent(AgentIdType agent_id) const {
+    return rows_.count(agent_id) > 0;
+}
+
+std::vector<AgentIdType> AgentArchive::get_all_agent_ids() const {
+    std::vector<AgentIdType> ids = ids_;
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+size_t AgentArchive::get_population_size() const {
+    return ids_.size();
+}
+
+double AgentArchive::performance_score(AgentIdType agent_id) const {
+    return scores_[row_of(agent_id)];
+}
+
+int AgentArchive::children_count(AgentIdType agent_id) const {
+    return children_counts_[row_of(agent_id)];
 }
 
-Agent& AgentArchive::get_agent(AgentIdType agent_id) {
-    try {
-        return agents_.at(agent_id);
-    } catch (const std::out_of_range& oor) {
+const AgentGenome& AgentArchive::genome(AgentIdType agent_id) const {
+    return genomes_[row_of(agent_id)];
+}
+
+void AgentArchive::record_child(AgentIdType parent_id) {
+    const size_t row = row_of(parent_id);
+    children_counts_[row]++;
+    update_weight(row);
+}
+
+double AgentArchive::selection_weight(AgentIdType agent_id) const {
+    return weights_.weight(row_of(agent_id));
+}
+
+double AgentArchive::total_selection_weight() const {
+    return weights_.total();
+}
+
+AgentIdType AgentArchive::agent_at_weight(double point) const {
+    if (ids_.empty()) {
+        throw std::runtime_error("Cannot sample an agent from an empty archive.");
+    }
+    return ids_[weights_.find(point)];
+}
+
+AgentIdType AgentArchive::agent_at(size_t row) const {
+    if (row >= ids_.size()) {
+        throw std::runtime_error("Archive row " + std::to_string(row) + " out of range.");
+    }
+    return ids_[row];
+}
+
+size_t AgentArchive::row_of(AgentIdType agent_id) const {
+    const auto it = rows_.find(agent_id);
+    if (it == rows_.end()) {
         // Consider a more specific exception type for DGM
         throw std::runtime_error("Agent with ID " + std::to_string(agent_id) + " not found in archive.");
     }
+    return it->second;
+}
+
+void AgentArchive::update_weight(size_t row) {
+    weights_.set(row, DGM::selection_weight(scores_[row], children_counts_[row]));
 }
 
-const Agent& AgentArchive::get_agent(AgentIdType agent_id) const {
-    try {
-        return agents_.at(agent_id);
-    } catch (const std::out_of_range& oor) {
-        throw std::runtime_error("Agent with ID " + std::to_string(agent_id) + " not found in archive (const).");
+// --- WeightTree ---
+
+void AgentArchive::WeightTree::push_back(double weight) {
+    weights_.push_back(weight);
+    const size_t n = weights_.size();
+    if (tree_.empty()) {
+        tree_.push_back(0.0);
     }
+    // Node n covers rows (n - lowbit(n), n]: its own weight plus the nodes below it.
+    const size_t low = n & (~n + 1);
+    tree_.push_back(weight + prefix(n - 1) - prefix(n - low));
 }
 
-bool AgentArchive::has_agent(AgentIdType agent_id) const {
-    return agents_.count(agent_id) > 0;
+void AgentArchive::WeightTree::set(size_t row, double weight) {
+    const double delta = weight - weights_[row];
+    weights_[row] = weight;
+    if (++updates_since_rebuild_ >= weights_.size()) {
+        rebuild();
+        return;
+    }
+    for (size_t i = row + 1; i < tree_.size(); i += i & (~i + 1)) {
+        tree_[i] += delta;
+    }
 }
 
-std::vector<AgentIdType> AgentArchive::get_all_agent_ids() const {
-    std::vector<AgentIdType> ids;
-    ids.reserve(agents_.size());
-    for (const auto& pair : agents_) {
-        ids.push_back(pair.first);
+double AgentArchive::WeightTree::prefix(size_t rows) const {
+    double sum = 0.0;
+    for (size_t i = rows; i > 0; i -= i & (~i + 1)) {
+        sum += tree_[i];
     }
-    return ids;
+    return sum;
 }
 
-size_t AgentArchive::get_population_size() const {
-    return agents_.size();
+size_t AgentArchive::WeightTree::find(double point) const {
+    const size_t n = weights_.size();
+    size_t step = 1;
+    while (step * 2 <= n) {
+        step *= 2;
+    }
+    // Descend to the last row whose prefix sum does not exceed 'point'; the next row holds it.
+    size_t position = 0;
+    for (; step > 0; step /= 2) {
+        if (position + step <= n && tree_[position + step] <= point) {
+            position += step;
+            point -= tree_[position];
+        }
+    }
+    return position < n ? position : n - 1; // Rounding can put 'point' at the very end
 }
 
-const std::map<AgentIdType, Agent>& AgentArchive::get_agents_map() const {
-    return agents_;
+void AgentArchive::WeightTree::rebuild() {
+    const size_t n = weights_.size();
+    tree_.assign(n + 1, 0.0);
+    for (size_t i = 1; i <= n; ++i) {
+        tree_[i] += weights_[i - 1];
+        const size_t parent = i + (i & (~i + 1));
+        if (parent <= n) {
+            tree_[parent] += tree_[i];
+        }
+    }
+    updates_since_rebuild_ = 0;
 }
 
 } // namespace DGM
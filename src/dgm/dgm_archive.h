@@ -1,31 +1,84 @@
 #pragma once
 
 #include "dgm_agent.h" // Include the Agent definition
+#include "dgm_content_store.h"
 #include <string>
 #include <vector>
-#include <map>
+#include <optional>
+#include <unordered_map>
 #include <stdexcept> // For std::runtime_error
 
 namespace DGM {
 
+// The population, stored as flat columns (one row per agent, in insertion order) so that the
+// per-agent numbers selection reads stay compact. Source representations and evaluation logs
+// live in a deduplicating ContentStore that spills to disk. Each agent's selection_weight() is
+// kept in a Fenwick tree, updated as scores and children counts change, so weighted sampling
+// and the total weight cost O(log n) instead of a pass over the archive.
 class AgentArchive {
 public:
-    AgentArchive();
+    explicit AgentArchive(size_t resident_text_budget_bytes = ContentStore::DEFAULT_RESIDENT_BUDGET);
 
+    // Adds the agent, or replaces the stored one with the same ID.
     void add_agent(const Agent& agent);
-    Agent& get_agent(AgentIdType agent_id);
-    const Agent& get_agent(AgentIdType agent_id) const; // Const version
-    std::vector<AgentIdType> get_all_agent_ids() const;
+    // Assembled from the columns and the content store; throws std::runtime_error if absent.
+    Agent get_agent(AgentIdType agent_id) const;
+    std::vector<AgentIdType> get_all_agent_ids() const; // Ascending
     bool has_agent(AgentIdType agent_id) const;
     size_t get_population_size() const;
 
-    // Provide access to the underlying map for selection logic
-    const std::map<AgentIdType, Agent>& get_agents_map() const;
+    // Column reads; each throws std::runtime_error for an unknown ID.
+    double performance_score(AgentIdType agent_id) const;
+    int children_count(AgentIdType agent_id) const;
+    const AgentGenome& genome(AgentIdType agent_id) const;
 
+    // Counts a child of 'parent_id' (lowering its novelty bonus and so its selection weight).
+    void record_child(AgentIdType parent_id);
+
+    // Selection weights, for ParentSelector.
+    double selection_weight(AgentIdType agent_id) const;
+    double total_selection_weight() const;
+    // The agent whose span of the cumulative weights contains 'point' (0 <= point < total):
+    // drawing 'point' uniformly picks each agent with probability weight / total. O(log n).
+    AgentIdType agent_at_weight(double point) const;
+    AgentIdType agent_at(size_t row) const; // Rows are in insertion order
+
+    const ContentStore& text_store() const { return texts_; }
 
 private:
-    std::map<AgentIdType, Agent> agents_;
-    // May add more sophisticated storage or indexing later
+    // Prefix sums of per-row weights. Rebuilt exactly after as many point updates as it has rows,
+    // so rounding from incremental updates cannot accumulate.
+    class WeightTree {
+    public:
+        void push_back(double weight);
+        void set(size_t row, double weight);
+        double weight(size_t row) const { return weights_[row]; }
+        double total() const { return prefix(weights_.size()); }
+        size_t find(double point) const;
+
+    private:
+        double prefix(size_t rows) const; // Sum of the first 'rows' weights
+        void rebuild();
+
+        std::vector<double> weights_;
+        std::vector<double> tree_; // 1-based Fenwick tree; tree_[0] unused
+        size_t updates_since_rebuild_ = 0;
+    };
+
+    size_t row_of(AgentIdType agent_id) const; // Throws std::runtime_error if absent
+    void update_weight(size_t row);
+
+    std::unordered_map<AgentIdType, size_t> rows_;
+    std::vector<AgentIdType> ids_;
+    std::vector<std::optional<AgentIdType>> parent_ids_;
+    std::vector<double> scores_;
+    std::vector<int> children_counts_;
+    std::vector<int> creation_iterations_;
+    std::vector<AgentGenome> genomes_;
+    std::vector<ContentStore::Key> sources_;
+    std::vector<ContentStore::Key> logs_;
+    ContentStore texts_;
+    WeightTree weights_;
 };
 
 } // namespace DGM
@@ -0,0 +1,256 @@
+#include "dgm_benchmark.h"
+#include "vpu.h"        // For VPU_Environment, VPU_Task
+#include <algorithm>    // For std::sort, std::rotate, std::min
+#include <atomic>
+#include <cmath>        // For std::abs, std::ceil
+#include <exception>
+#include <future>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <utility>      // For std::move
+
+namespace DGM {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The VPU runs its own kernels for these task types; the function pointer is never called.
+void unused_kernel(const void*, const void*, void*, size_t) {}
+
+double elapsed_ns(Clock::time_point since) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - since).count();
+}
+
+// Inputs, reference outputs and one output buffer per task, so batched tasks can run in any order.
+struct Suite {
+    std::vector<float> saxpy_x, saxpy_y, saxpy_expected;
+    std::vector<float> gemm_a, gemm_b, gemm_expected;
+    std::vector<double> signal, taps, conv_expected;
+    std::vector<std::vector<float>> saxpy_out, gemm_out;
+    std::vector<std::vector<double>> conv_out;
+    std::vector<VPU::VPU_Task> tasks;
+
+    explicit Suite(const BenchmarkOptions& options);
+    // False (with the first mismatch in 'error') if any task's output differs from its reference.
+    bool outputs_match(std::string& error) const;
+};
+
+Suite::Suite(const BenchmarkOptions& options) {
+    std::mt19937 rng(0xD6B); // Same data for every agent
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    const float alpha = 1.5f;
+
+    saxpy_x.resize(options.saxpy_elements);
+    saxpy_y.resize(options.saxpy_elements);
+    saxpy_expected.resize(options.saxpy_elements);
+    for (size_t i = 0; i < options.saxpy_elements; ++i) {
+        saxpy_x[i] = value(rng);
+        saxpy_y[i] = value(rng);
+        saxpy_expected[i] = alpha * saxpy_x[i] + saxpy_y[i];
+    }
+
+    const size_t dim = options.gemm_dim;
+    gemm_a.resize(dim * dim);
+    gemm_b.resize(dim * dim);
+    for (float& v : gemm_a) v = value(rng);
+    for (float& v : gemm_b) v = value(rng);
+    gemm_expected.assign(dim * dim, 0.0f);
+    for (size_t i = 0; i < dim; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            double sum = 0.0;
+            for (size_t k = 0; k < dim; ++k) sum += static_cast<double>(gemm_a[i * dim + k]) * gemm_b[k * dim + j];
+            gemm_expected[i * dim + j] = static_cast<float>(sum);
+        }
+    }
+
+    signal.resize(options.conv_elements);
+    taps.resize(options.conv_taps);
+    for (double& v : signal) v = value(rng);
+    for (double& v : taps) v = value(rng);
+    conv_expected.assign(options.conv_elements, 0.0);
+    for (size_t i = 0; i < options.conv_elements; ++i) {
+        for (size_t j = 0; j < taps.size() && j <= i; ++j) conv_expected[i] += signal[i - j] * taps[j];
+    }
+
+    saxpy_out.assign(options.repetitions, saxpy_y); // SAXPY updates y in place
+    gemm_out.assign(options.repetitions, std::vector<float>(dim * dim, 0.0f));
+    conv_out.assign(options.repetitions, std::vector<double>(options.conv_elements, 0.0));
+
+    tasks.reserve(3 * options.repetitions);
+    for (size_t r = 0; r < options.repetitions; ++r) {
+        VPU::VPU_Task saxpy;
+        saxpy.task_type = "SAXPY";
+        saxpy.data_in_a = saxpy_x.data();
+        saxpy.data_in_a_size_bytes = saxpy_x.size() * sizeof(float);
+        saxpy.data_out = saxpy_out[r].data();
+        saxpy.num_elements = saxpy_x.size();
+        saxpy.alpha = alpha;
+        tasks.push_back(saxpy);
+
+        VPU::VPU_Task gemm;
+        gemm.task_type = "GEMM";
+        gemm.data_in_a = gemm_a.data();
+        gemm.data_in_a_size_bytes = gemm_a.size() * sizeof(float);
+        gemm.data_in_b = gemm_b.data();
+        gemm.data_in_b_size_bytes = gemm_b.size() * sizeof(float);
+        gemm.data_out = gemm_out[r].data();
+        gemm.num_elements = dim * dim;
+        gemm.extended_params = {{"M", static_cast<int>(dim)}, {"N", static_cast<int>(dim)}, {"K", static_cast<int>(dim)}};
+        tasks.push_back(gemm);
+
+        VPU::VPU_Task conv;
+        conv.task_type = "CONVOLUTION";
+        conv.data_in_a = signal.data();
+        conv.data_in_a_size_bytes = signal.size() * sizeof(double);
+        conv.data_out = conv_out[r].data();
+        conv.num_elements = signal.size();
+        conv.conv_filter = VPU::HAL::Span<const double>(taps);
+        tasks.push_back(conv);
+    }
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        tasks[i].task_id = i + 1;
+        tasks[i].kernel.function_pointer = unused_kernel;
+    }
+}
+
+bool Suite::outputs_match(std::string& error) const {
+    auto check = [&error](const char* kind, size_t repetition, double actual, double expected, double tolerance) {
+        if (std::abs(actual - expected) <= tolerance * (1.0 + std::abs(expected))) return true;
+        std::ostringstream message;
+        message << kind << " task " << repetition << " produced " << actual << " where " << expected << " was expected";
+        error = message.str();
+        return false;
+    };
+    for (size_t r = 0; r < saxpy_out.size(); ++r) {
+        for (size_t i = 0; i < saxpy_expected.size(); ++i) {
+            if (!check("SAXPY", r, saxpy_out[r][i], saxpy_expected[i], 1e-5)) return false;
+        }
+        for (size_t i = 0; i < gemm_expected.size(); ++i) {
+            if (!check("GEMM", r, gemm_out[r][i], gemm_expected[i], 1e-3)) return false;
+        }
+        for (size_t i = 0; i < conv_expected.size(); ++i) {
+            if (!check("CONVOLUTION", r, conv_out[r][i], conv_expected[i], 1e-6)) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::string describe(const AgentGenome& genome) {
+    std::ostringstream out;
+    out << "pipelined=" << genome.pipelined << " batch=" << genome.batch_size
+        << " plan_cache=" << genome.plan_cache_capacity << " sampled_profiling=" << genome.sampled_profiling;
+    return out.str();
+}
+
+BenchmarkHarness::BenchmarkHarness(BenchmarkOptions options) : options_(std::move(options)) {}
+
+BenchmarkResult BenchmarkHarness::run(const AgentGenome& genome) const {
+    BenchmarkResult result;
+    std::ostringstream log;
+    log << options_.name << " [" << describe(genome) << "]: ";
+    try {
+        Suite suite(options_); // Outlives the environment, which drains its tasks on destruction
+        VPU::VPU_Environment environment;
+        environment.set_pipelined_mode(genome.pipelined);
+        environment.set_plan_cache_capacity(genome.plan_cache_capacity);
+        if (genome.sampled_profiling) {
+            VPU::ProfilingPolicy sampled;
+            sampled.sampling = VPU::ProfileSampling::STRIDED;
+            environment.set_profiling_policy(sampled);
+        }
+
+        std::vector<double> latencies;
+        latencies.reserve(suite.tasks.size());
+        const size_t batch_size = std::max<size_t>(1, genome.batch_size);
+        const Clock::time_point start = Clock::now();
+        const Clock::time_point deadline = start + options_.timeout;
+        for (size_t first = 0; first < suite.tasks.size() && !result.timed_out; first += batch_size) {
+            const size_t count = std::min(batch_size, suite.tasks.size() - first);
+            const Clock::time_point submitted = Clock::now();
+            if (batch_size == 1) {
+                environment.execute(suite.tasks[first]);
+                latencies.push_back(elapsed_ns(submitted));
+            } else {
+                std::vector<std::future<VPU::ActualPerformanceRecord>> futures = environment.submit_batch(&suite.tasks[first], count);
+                for (auto& future : futures) {
+                    if (future.wait_until(deadline) != std::future_status::ready) result.timed_out = true;
+                    future.get(); // Waited for even when late: the task still uses the suite's buffers
+                    latencies.push_back(elapsed_ns(submitted));
+                }
+            }
+            result.tasks_completed += count;
+            if (Clock::now() > deadline) result.timed_out = true;
+        }
+        environment.wait_idle(); // Background learning is part of the cost of a pipelined run
+        result.total_ns = elapsed_ns(start);
+
+        std::sort(latencies.begin(), latencies.end());
+        if (!latencies.empty()) {
+            double sum = 0.0;
+            for (double latency : latencies) sum += latency;
+            result.mean_latency_ns = sum / latencies.size();
+            const size_t p95 = static_cast<size_t>(std::ceil(0.95 * latencies.size())) - 1;
+            result.p95_latency_ns = latencies[p95];
+        }
+        if (result.total_ns > 0.0) result.tasks_per_second = result.tasks_completed * 1e9 / result.total_ns;
+
+        std::string mismatch;
+        if (result.timed_out) {
+            log << "timed out after " << result.tasks_completed << " of " << suite.tasks.size() << " tasks";
+        } else if (!suite.outputs_match(mismatch)) {
+            log << "wrong output: " << mismatch;
+        } else {
+            result.passed = true;
+            log << result.tasks_completed << " tasks in " << result.total_ns / 1e6 << " ms ("
+                << result.tasks_per_second << " tasks/s, mean " << result.mean_latency_ns / 1e3
+                << " us, p95 " << result.p95_latency_ns / 1e3 << " us)";
+        }
+    } catch (const std::exception& e) {
+        result.passed = false;
+        log << "failed: " << e.what();
+    }
+    result.log = log.str();
+    return result;
+}
+
+std::vector<BenchmarkResult> BenchmarkHarness::run_all(const std::vector<AgentGenome>& genomes,
+                                                       const AgentGenome& reference) const {
+    // The reference runs first so it overlaps with as many of the other runs as possible.
+    std::vector<const AgentGenome*> jobs;
+    jobs.reserve(genomes.size() + 1);
+    jobs.push_back(&reference);
+    for (const AgentGenome& genome : genomes) jobs.push_back(&genome);
+
+    std::vector<BenchmarkResult> results(jobs.size());
+    std::atomic<size_t> next_job{0};
+    auto worker = [&]() {
+        for (size_t job = next_job.fetch_add(1); job < jobs.size(); job = next_job.fetch_add(1)) {
+            results[job] = run(*jobs[job]);
+        }
+    };
+    size_t workers = options_.max_parallel > 0 ? options_.max_parallel
+                                               : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, jobs.size());
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t i = 1; i < workers; ++i) threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads) thread.join();
+
+    std::rotate(results.begin(), results.begin() + 1, results.end()); // Reference last
+    return results;
+}
+
+double BenchmarkHarness::score(const BenchmarkResult& result, const BenchmarkResult& reference) {
+    if (!result.passed || result.tasks_completed == 0) return 0.0;
+    if (!reference.passed || reference.tasks_completed == 0) return 0.5; // No baseline to compare against
+    const double ns_per_task = result.total_ns / result.tasks_completed;
+    const double reference_ns_per_task = reference.total_ns / reference.tasks_completed;
+    return reference_ns_per_task / (reference_ns_per_task + ns_per_task);
+}
+
+} // namespace DGM
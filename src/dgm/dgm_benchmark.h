@@ -0,0 +1,62 @@
+#pragma once
+
+#include "dgm_agent.h"
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace DGM {
+
+// The workload every agent is measured on. Each run interleaves 'repetitions' SAXPY, dense GEMM
+// and CONVOLUTION tasks and checks every output against a reference.
+struct BenchmarkOptions {
+    std::string name = "default_benchmark";
+    size_t saxpy_elements = 1 << 16;
+    size_t gemm_dim = 64;          // M = N = K
+    size_t conv_elements = 1 << 13;
+    size_t conv_taps = 32;
+    size_t repetitions = 8;        // Tasks of each kind per run
+    std::chrono::milliseconds timeout{std::chrono::seconds(20)}; // Per agent
+    size_t max_parallel = 0;       // Agents benchmarked at once; 0 = hardware threads
+};
+
+struct BenchmarkResult {
+    bool passed = false;     // Every task ran before the timeout and produced the reference output
+    bool timed_out = false;
+    size_t tasks_completed = 0;
+    double total_ns = 0.0;   // Wall-clock time of the whole suite
+    double mean_latency_ns = 0.0;
+    double p95_latency_ns = 0.0;
+    double tasks_per_second = 0.0;
+    std::string log;         // Summary, or why the run failed
+};
+
+// The genome on one line, e.g. "pipelined=0 batch=8 plan_cache=256 sampled_profiling=0".
+std::string describe(const AgentGenome& genome);
+
+// Benchmarks agents through the public VPU API: one fresh VPU_Environment per run (its own
+// beliefs, caches and worker pool), configured from the agent's genome, timed with a steady clock.
+class BenchmarkHarness {
+public:
+    explicit BenchmarkHarness(BenchmarkOptions options = BenchmarkOptions());
+
+    // Runs the suite once. Never throws: exceptions and wrong outputs fail the result. The timeout
+    // is checked between tasks: a late run stops submitting and drains the tasks already in flight.
+    BenchmarkResult run(const AgentGenome& genome) const;
+
+    // Runs one suite per genome on up to max_parallel threads, plus a run of 'reference' alongside
+    // them, so each result can be scored against a baseline measured under the same load.
+    // Returns the genomes' results in order, followed by the reference's.
+    std::vector<BenchmarkResult> run_all(const std::vector<AgentGenome>& genomes, const AgentGenome& reference) const;
+
+    // Fitness in [0, 1]: 0.5 at the reference's time per task, towards 1 when faster, 0 if the run failed.
+    static double score(const BenchmarkResult& result, const BenchmarkResult& reference);
+
+    const BenchmarkOptions& options() const { return options_; }
+
+private:
+    BenchmarkOptions options_;
+};
+
+} // namespace DGM
@@ -0,0 +1,82 @@
+#include "dgm_content_store.h"
+#include <stdexcept> // For std::runtime_error
+
+namespace DGM {
+
+ContentStore::ContentStore(size_t resident_budget_bytes) : resident_budget_(resident_budget_bytes) {}
+
+ContentStore::~ContentStore() {
+    if (spill_file_) {
+        std::fclose(spill_file_);
+    }
+}
+
+ContentStore::Key ContentStore::hash(const std::string& content) {
+    uint64_t h = 1469598103934665603ULL; // FNV-1a
+    for (unsigned char c : content) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+ContentStore::Key ContentStore::put(const std::string& content) {
+    // Distinct strings with the same hash take the next free key (linear probing).
+    Key key = hash(content);
+    for (auto it = entries_.find(key); it != entries_.end(); it = entries_.find(++key)) {
+        if (it->second.length == content.size() && get(key) == content) {
+            return key;
+        }
+    }
+    Entry& entry = entries_[key];
+    entry.content = content;
+    entry.length = content.size();
+    resident_bytes_ += content.size();
+    resident_order_.push_back(key);
+    spill_to_budget();
+    return key;
+}
+
+std::string ContentStore::get(Key key) const {
+    const auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        throw std::runtime_error("ContentStore: no content with key " + std::to_string(key) + ".");
+    }
+    const Entry& entry = it->second;
+    if (!entry.spilled) {
+        return entry.content;
+    }
+    std::string content(entry.length, '\0');
+    if (std::fseek(spill_file_, static_cast<long>(entry.offset), SEEK_SET) != 0 ||
+        (entry.length > 0 && std::fread(&content[0], 1, entry.length, spill_file_) != entry.length)) {
+        throw std::runtime_error("ContentStore: failed to read spilled content with key " + std::to_string(key) + ".");
+    }
+    return content;
+}
+
+void ContentStore::spill_to_budget() {
+    while (resident_bytes_ > resident_budget_ && !resident_order_.empty()) {
+        if (!spill_file_) {
+            spill_file_ = std::tmpfile();
+            if (!spill_file_) {
+                return; // Nowhere to spill to: keep everything in memory
+            }
+        }
+        Entry& entry = entries_.at(resident_order_.front());
+        if (std::fseek(spill_file_, 0, SEEK_END) != 0) {
+            return;
+        }
+        const long offset = std::ftell(spill_file_);
+        if (offset < 0 || std::fwrite(entry.content.data(), 1, entry.content.size(), spill_file_) != entry.content.size()) {
+            return;
+        }
+        resident_order_.pop_front();
+        entry.spilled = true;
+        entry.offset = static_cast<uint64_t>(offset);
+        resident_bytes_ -= entry.content.size();
+        spilled_bytes_ += entry.content.size();
+        std::string().swap(entry.content); // Release the memory
+    }
+}
+
+} // namespace DGM
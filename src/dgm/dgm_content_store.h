@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>   // For std::FILE
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+namespace DGM {
+
+// Append-only, content-addressed storage for agents' source representations and evaluation logs.
+// A string is keyed by a hash of its bytes, so agents with the same source share one copy.
+// Once the strings held in memory exceed the resident budget, the oldest are spilled to an
+// anonymous temporary file and read back on demand. Not thread-safe.
+class ContentStore {
+public:
+    using Key = uint64_t;
+    static const size_t DEFAULT_RESIDENT_BUDGET = 16 << 20; // Bytes
+
+    explicit ContentStore(size_t resident_budget_bytes = DEFAULT_RESIDENT_BUDGET);
+    ~ContentStore(); // Closes (and so deletes) the spill file
+
+    ContentStore(const ContentStore&) = delete;
+    ContentStore& operator=(const ContentStore&) = delete;
+
+    // Stores 'content' unless an identical string is already stored; returns its key either way.
+    Key put(const std::string& content);
+    // Throws std::runtime_error for an unknown key or a failed read of the spill file.
+    std::string get(Key key) const;
+
+    size_t size() const { return entries_.size(); } // Distinct strings
+    size_t resident_bytes() const { return resident_bytes_; }
+    size_t spilled_bytes() const { return spilled_bytes_; }
+
+private:
+    struct Entry {
+        std::string content;  // Empty once spilled
+        bool spilled = false;
+        uint64_t offset = 0;  // In the spill file
+        uint64_t length = 0;
+    };
+
+    static Key hash(const std::string& content);
+    void spill_to_budget(); // Spills the oldest resident strings until within budget
+
+    const size_t resident_budget_;
+    std::unordered_map<Key, Entry> entries_;
+    std::deque<Key> resident_order_; // Spill candidates, oldest first
+    size_t resident_bytes_ = 0;
+    size_t spilled_bytes_ = 0;
+    std::FILE* spill_file_ = nullptr; // Created by the first spill
+};
+
+} // namespace DGM
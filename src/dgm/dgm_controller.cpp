@@ -3,6 +3,7 @@
 #include <stdexcept>    // For std::runtime_error
 #include <algorithm>    // For std::min
 #include <vector>       // Required for std::vector<AgentIdType>
+#include <utility>      // For std::move
 
 namespace DGM {
 
@@ -10,12 +11,12 @@ DGMController::DGMController(
     const std::string& initial_agent_source_placeholder,
     int max_iterations,
     int num_children_per_iteration,
-    const std::string& benchmark_placeholder)
+    BenchmarkOptions benchmark)
     : current_iteration_(0),
       max_iterations_(max_iterations),
       num_children_per_iteration_(num_children_per_iteration),
       next_agent_id_(0), // Start agent IDs from 0
-      benchmark_placeholder_(benchmark_placeholder) {
+      harness_(std::move(benchmark)) {
 
     if (max_iterations_ <= 0) {
         throw std::invalid_argument("Max iterations must be positive.");
@@ -35,7 +36,9 @@ DGMController::DGMController(
         current_iteration_       // creation_iteration
     );
 
-    DGMEvolution::evaluate(agent_0, benchmark_placeholder_); // Evaluate initial agent
+    std::vector<Agent> initial_agents = {agent_0};
+    DGMEvolution::evaluate(initial_agents, harness_, agent_0.genome); // Evaluate initial agent
+    agent_0 = initial_agents.front();
     archive_.add_agent(agent_0);
     std::cout << "DGMController: Initialized Agent 0. Performance: " << agent_0.performance_score
               << ", Source: " << agent_0.source_code_representation << std::endl;
@@ -48,11 +51,11 @@ AgentIdType DGMController::generate_new_agent_id() {
     return next_agent_id_++;
 }
 
-bool DGMController::is_agent_valid(const Agent& agent) const {
-    // Placeholder: In a real system, this would check if code compiles, runs without crashing, etc.
-    // For now, all conceptually "modified" agents are considered valid.
-    std::cout << "  DGMController: Validating Agent ID: " << agent.agent_id << " (Placeholder: always valid)" << std::endl;
-    return true;
+bool DGMController::is_agent_valid(const Agent& agent, const BenchmarkResult& result) const {
+    std::cout << "  DGMController: Validating Agent ID: " << agent.agent_id << " ("
+              << (result.passed ? "benchmark passed" : result.timed_out ? "benchmark timed out" : "benchmark failed")
+              << ")" << std::endl;
+    return result.passed;
 }
 
 const AgentArchive& DGMController::get_archive() const {
@@ -90,6 +93,7 @@ void DGMController::run_evolutionary_loop() {
         }
 
         int children_generated_this_iteration = 0;
+        std::vector<Agent> children;
         for (AgentIdType parent_id : selected_parent_ids) {
             // This loop will run parents_needed_for_children times if enough distinct parents were selected
             // and ParentSelector samples with replacement.
@@ -100,17 +104,24 @@ void DGMController::run_evolutionary_loop() {
                 break;
             }
 
-            Agent& parent_agent = archive_.get_agent(parent_id); // Get non-const reference to update children_count
+            const Agent parent_agent = archive_.get_agent(parent_id);
 
-            Agent child_agent = DGMEvolution::self_modify(parent_agent, generate_new_agent_id(), current_iteration_);
-            std::cout << "DGMController: Generated Child ID: " << child_agent.agent_id
+            children.push_back(DGMEvolution::self_modify(parent_agent, generate_new_agent_id(), current_iteration_));
+            std::cout << "DGMController: Generated Child ID: " << children.back().agent_id
                       << " from Parent ID: " << parent_agent.agent_id << std::endl;
 
-            parent_agent.children_count++; // Increment after successful retrieval and before potential errors in child processing
-
-            DGMEvolution::evaluate(child_agent, benchmark_placeholder_);
+            archive_.record_child(parent_id); // Counted before the child is evaluated, whether or not it turns out valid
+            children_generated_this_iteration++;
+        }
 
-            if (is_agent_valid(child_agent)) {
+        // The whole generation is benchmarked at once, so an iteration takes about as long as its slowest child.
+        std::vector<BenchmarkResult> results;
+        if (!children.empty()) {
+            results = DGMEvolution::evaluate(children, harness_, archive_.genome(0));
+        }
+        for (size_t i = 0; i < children.size(); ++i) {
+            const Agent& child_agent = children[i];
+            if (is_agent_valid(child_agent, results[i])) {
                 archive_.add_agent(child_agent);
                 std::cout << "DGMController: Child ID: " << child_agent.agent_id
                           << " is valid. Score: " << child_agent.performance_score
@@ -118,10 +129,9 @@ void DGMController::run_evolutionary_loop() {
             } else {
                 std::cout << "DGMController: Child ID: " << child_agent.agent_id
                           << " is invalid. Discarding." << std::endl;
-                // Note: parent_agent.children_count was already incremented. This is a philosophical point:
+                // Note: its parent's children_count was already incremented. This is a philosophical point:
                 // was a child "produced" even if invalid? Current logic says yes.
             }
-            children_generated_this_iteration++;
         }
          if (children_generated_this_iteration == 0 && archive_.get_population_size() > 0) {
              std::cout << "DGMController: No children generated this iteration (selected_parent_ids might have been empty or processed fully)." << std::endl;
@@ -4,6 +4,7 @@
 #include "dgm_archive.h"
 #include "dgm_selection.h"
 #include "dgm_evolution.h" // For DGMEvolution::self_modify and DGMEvolution::evaluate
+#include "dgm_benchmark.h" // For BenchmarkHarness
 #include <string>
 #include <vector>
 #include <memory> // For std::unique_ptr
@@ -15,8 +16,10 @@ public:
     DGMController(const std::string& initial_agent_source_placeholder,
                   int max_iterations,
                   int num_children_per_iteration = 1, // Default to 1 child for simplicity
-                  const std::string& benchmark_placeholder = "default_benchmark");
+                  BenchmarkOptions benchmark = BenchmarkOptions());
 
+    // Each iteration creates the generation's children one by one, then benchmarks them all in
+    // parallel (DGMEvolution::evaluate) against Agent 0's genome.
     void run_evolutionary_loop();
 
     // Helper to get archive for testing/inspection
@@ -30,10 +33,11 @@ private:
     int max_iterations_;
     int num_children_per_iteration_;
     AgentIdType next_agent_id_;
-    std::string benchmark_placeholder_;
+    BenchmarkHarness harness_;
 
     AgentIdType generate_new_agent_id();
-    bool is_agent_valid(const Agent& agent) const; // Placeholder
+    // An agent is valid if its benchmark ran to completion with correct outputs.
+    bool is_agent_valid(const Agent& agent, const BenchmarkResult& result) const;
 };
 
 } // namespace DGM
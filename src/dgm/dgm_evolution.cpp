@@ -1,12 +1,48 @@
 #include "dgm_evolution.h"
 #include <iostream>     // For std::cout logging
 #include <sstream>      // For std::ostringstream
-#include <random>       // For std::mt19937, std::uniform_real_distribution
-#include <string>       // For std::to_string
+#include <random>       // For std::mt19937, std::uniform_int_distribution
+#include <algorithm>    // For std::min, std::max
+#include <string>
 
 namespace DGM {
 namespace DGMEvolution {
 
+namespace {
+
+const size_t MAX_BATCH_SIZE = 64;
+const char* const GENOME_MARKER = "\n// genome: ";
+const size_t MAX_PLAN_CACHE_CAPACITY = 4096;
+
+// Changes one setting of 'genome' by one step: toggles a flag, or doubles or halves a size.
+AgentGenome mutate(const AgentGenome& genome, std::mt19937& rng) {
+    AgentGenome child = genome;
+    std::uniform_int_distribution<int> setting(0, 3);
+    std::bernoulli_distribution grow(0.5);
+    switch (setting(rng)) {
+        case 0:
+            child.pipelined = !child.pipelined;
+            break;
+        case 1:
+            child.batch_size = grow(rng) ? std::min(MAX_BATCH_SIZE, std::max<size_t>(1, child.batch_size) * 2)
+                                         : std::max<size_t>(1, child.batch_size / 2);
+            break;
+        case 2:
+            if (grow(rng)) {
+                child.plan_cache_capacity = child.plan_cache_capacity == 0 ? 16 : std::min(MAX_PLAN_CACHE_CAPACITY, child.plan_cache_capacity * 2);
+            } else {
+                child.plan_cache_capacity = child.plan_cache_capacity > 16 ? child.plan_cache_capacity / 2 : 0;
+            }
+            break;
+        default:
+            child.sampled_profiling = !child.sampled_profiling;
+            break;
+    }
+    return child;
+}
+
+} // namespace
+
 Agent self_modify(const Agent& parent_agent,
                   AgentIdType new_agent_id,
                   int current_iteration) {
@@ -15,13 +51,18 @@ Agent self_modify(const Agent& parent_agent,
               << " to create new Agent ID: " << new_agent_id
               << " in iteration " << current_iteration << std::endl;
 
-    // Placeholder: Create a new source code representation string
-    std::string new_source_repr = parent_agent.source_code_representation +
-                                  "_child_of_" + std::to_string(parent_agent.agent_id) +
-                                  "_iter_" + std::to_string(current_iteration);
+    static std::mt19937 rng(std::random_device{}()); // The controller creates children one at a time
+    const AgentGenome child_genome = mutate(parent_agent.genome, rng);
+
+    // Placeholder: the child's source is the lineage's root source plus its genome, so it does not
+    // grow from generation to generation, and children with the same genome share one stored copy.
+    // (The lineage itself is recorded by parent_id.)
+    const std::string& parent_source = parent_agent.source_code_representation;
+    std::string new_source_repr = parent_source.substr(0, parent_source.find(GENOME_MARKER)) +
+                                  GENOME_MARKER + describe(child_genome);
 
     // Log the conceptual modification
-    std::cout << "  Parent source: " << parent_agent.source_code_representation << std::endl;
+    std::cout << "  Parent source: " << parent_source << std::endl;
     std::cout << "  Child source (placeholder): " << new_source_repr << std::endl;
     std::cout << "  (Conceptual LLM call and patching would happen here)" << std::endl;
 
@@ -32,33 +73,35 @@ Agent self_modify(const Agent& parent_agent,
         current_iteration
     );
     // performance_score, evaluation_log, children_count are default initialized by Agent constructor
+    child_agent.genome = child_genome;
 
     return child_agent;
 }
 
-void evaluate(Agent& agent, const std::string& benchmark_placeholder) {
-    std::cout << "DGM Evolution: Evaluating Agent ID: " << agent.agent_id
-              << " on benchmark: " << benchmark_placeholder << std::endl;
-
-    // Placeholder evaluation: Assign a score, possibly based on parent or randomly.
-    // This is highly simplified. A real system needs robust benchmarking.
-    static std::mt19937 rng(std::random_device{}()); // Static to ensure different random numbers each call
-    std::uniform_real_distribution<double> dist(0.0, 1.0); // Performance score between 0 and 1
-
-    // Give a slight bias based on parent if available, plus some randomness
-    // double base_score = ALPHA_NAUGHT_PARAM; // Start around midpoint. ALPHA_NAUGHT_PARAM is in dgm_agent.h
-                                            // Not directly used here for simplicity, direct random assignment.
+std::vector<BenchmarkResult> evaluate(std::vector<Agent>& agents, const BenchmarkHarness& harness,
+                                      const AgentGenome& reference) {
+    std::cout << "DGM Evolution: Evaluating " << agents.size() << " agent(s) on benchmark: "
+              << harness.options().name << std::endl;
 
-    // Simple random score for now to allow for varied population
-    agent.performance_score = dist(rng);
+    std::vector<AgentGenome> genomes;
+    genomes.reserve(agents.size());
+    for (const Agent& agent : agents) genomes.push_back(agent.genome);
+    std::vector<BenchmarkResult> results = harness.run_all(genomes, reference);
+    const BenchmarkResult reference_result = results.back();
+    results.pop_back();
 
-    std::ostringstream eval_log_stream;
-    eval_log_stream << "Evaluation complete for Agent ID " << agent.agent_id << ". "
-                    << "Assigned placeholder performance score: " << agent.performance_score
-                    << ". Benchmark: " << benchmark_placeholder;
-    agent.evaluation_log = eval_log_stream.str();
+    for (size_t i = 0; i < agents.size(); ++i) {
+        Agent& agent = agents[i];
+        agent.performance_score = BenchmarkHarness::score(results[i], reference_result);
 
-    std::cout << "  " << agent.evaluation_log << std::endl;
+        std::ostringstream eval_log_stream;
+        eval_log_stream << "Evaluation complete for Agent ID " << agent.agent_id << ". "
+                        << "Performance score: " << agent.performance_score << ". " << results[i].log
+                        << ". Reference: " << reference_result.tasks_per_second << " tasks/s";
+        agent.evaluation_log = eval_log_stream.str();
+        std::cout << "  " << agent.evaluation_log << std::endl;
+    }
+    return results;
 }
 
 } // namespace DGMEvolution
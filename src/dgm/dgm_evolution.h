@@ -1,21 +1,24 @@
 #pragma once
 
 #include "dgm_agent.h"
+#include "dgm_benchmark.h" // For BenchmarkHarness, BenchmarkResult
 #include <string>
-#include <random> // Required for placeholder evaluation logic (even if only in .cpp, good for consistency)
+#include <vector>
 
 namespace DGM {
 namespace DGMEvolution { // Using a namespace for these free functions
 
-// Placeholder for self-modification logic.
-// In a real DGM, this would involve LLM calls and code patching.
+// Creates a child of 'parent_agent' whose genome differs from the parent's in one setting.
+// In a real DGM, this would also involve LLM calls and code patching.
 Agent self_modify(const Agent& parent_agent,
                   AgentIdType new_agent_id,
                   int current_iteration);
 
-// Placeholder for evaluation logic.
-// In a real DGM, this would involve compiling and benchmarking the agent's code.
-void evaluate(Agent& agent, const std::string& benchmark_placeholder);
+// Benchmarks 'agents' in parallel alongside a run of 'reference' (BenchmarkHarness::run_all) and
+// sets each agent's performance_score (BenchmarkHarness::score) and evaluation_log.
+// Returns the agents' results, in the same order.
+std::vector<BenchmarkResult> evaluate(std::vector<Agent>& agents, const BenchmarkHarness& harness,
+                                      const AgentGenome& reference);
 
 } // namespace DGMEvolution
 } // namespace DGM
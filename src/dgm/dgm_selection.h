@@ -4,8 +4,7 @@
 #include "dgm_archive.h"
 #include <vector>
 #include <string>
-#include <map>
-#include <random> // For std::mt19937, std::discrete_distribution
+#include <random> // For std::mt19937, std::uniform_real_distribution
 
 namespace DGM {
 
@@ -14,24 +13,16 @@ public:
     // Constructor takes a const reference to the AgentArchive
     explicit ParentSelector(const AgentArchive& archive);
 
-    // Selects a specified number of parents based on performance and novelty
+    // Selects a specified number of parents based on performance and novelty (selection_weight()),
+    // sampling with replacement from the archive's incrementally maintained weights: O(k log n).
     std::vector<AgentIdType> select_parents(int num_parents_to_select);
 
+    // p_i: the chance that one draw picks the agent.
+    double selection_probability(AgentIdType agent_id) const;
+
 private:
     const AgentArchive& archive_; // Reference to the agent population
     std::mt19937 random_generator_; // For probabilistic sampling
-
-    // Helper struct to store calculated weights for selection
-    struct AgentSelectionStats {
-        AgentIdType id;
-        double scaled_performance_s_i;
-        double novelty_bonus_h_i;
-        double unnormalized_weight_w_i;
-        double normalized_probability_p_i;
-    };
-
-    // Calculates s_i, h_i, w_i for all agents
-    std::vector<AgentSelectionStats> calculate_agent_weights() const;
 };
 
 } // namespace DGM
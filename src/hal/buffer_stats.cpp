@@ -0,0 +1,310 @@
+#include "hal/buffer_stats.h"
+#include "hal/hal_utils.h"
+#include "hal/cpu_features.h"
+#include "hal/simd_target.h"
+#include "hal/parallel.h"
+#include "hal/dtype.h"
+#include <algorithm> // For std::min, std::max
+#include <cstring>   // For std::memcpy
+#include <limits>
+#include <vector>
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+
+// Running totals for one chunk; merged across chunks.
+struct Partial {
+    uint64_t hamming_weight = 0;
+    uint64_t zero_elements = 0;
+    double min_value = std::numeric_limits<double>::infinity();
+    double max_value = -std::numeric_limits<double>::infinity();
+
+    void merge(const Partial& other) {
+        hamming_weight += other.hamming_weight;
+        zero_elements += other.zero_elements;
+        min_value = std::min(min_value, other.min_value);
+        max_value = std::max(max_value, other.max_value);
+    }
+};
+
+// Scans 'count' whole elements starting at 'p'.
+using StatsKernel = void (*)(const uint8_t* p, size_t count, Partial& out);
+
+template <typename T, typename Bits>
+void stats_scalar(const uint8_t* p, size_t count, Partial& out) {
+    static_assert(sizeof(T) == sizeof(Bits), "bit pattern must match element size");
+    T lo = std::numeric_limits<T>::infinity();
+    T hi = -std::numeric_limits<T>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        T v;
+        Bits bits;
+        std::memcpy(&v, p + i * sizeof(T), sizeof(T));
+        std::memcpy(&bits, p + i * sizeof(T), sizeof(T));
+        out.hamming_weight += popcount_u64(bits);
+        out.zero_elements += (v == T(0)) ? 1 : 0;
+        if (v < lo) lo = v; // Comparisons with NaN are false, so NaNs are skipped
+        if (v > hi) hi = v;
+    }
+    out.min_value = std::min(out.min_value, static_cast<double>(lo));
+    out.max_value = std::max(out.max_value, static_cast<double>(hi));
+}
+
+void stats_bytes(const uint8_t* p, size_t count, Partial& out) {
+    // Popcount and value statistics per L1-sized block, so memory is still read once.
+    constexpr size_t BLOCK = 4096;
+    uint8_t lo = 0xFF, hi = 0x00;
+    for (size_t offset = 0; offset < count; offset += BLOCK) {
+        const size_t length = std::min(BLOCK, count - offset);
+        out.hamming_weight += calculate_data_hamming_weight(p + offset, length);
+        for (size_t i = offset; i < offset + length; ++i) { // Vectorizes: no NaNs to care about
+            out.zero_elements += (p[i] == 0) ? 1 : 0;
+            lo = std::min(lo, p[i]);
+            hi = std::max(hi, p[i]);
+        }
+    }
+    if (count > 0) {
+        out.min_value = std::min(out.min_value, static_cast<double>(lo));
+        out.max_value = std::max(out.max_value, static_cast<double>(hi));
+    }
+}
+
+// Narrow types: every value converts exactly to double.
+template <typename T, typename Bits>
+void stats_narrow(const uint8_t* p, size_t count, Partial& out) {
+    static_assert(sizeof(T) == sizeof(Bits), "bit pattern must match element size");
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        T v;
+        Bits bits;
+        std::memcpy(&v, p + i * sizeof(T), sizeof(T));
+        std::memcpy(&bits, p + i * sizeof(T), sizeof(T));
+        out.hamming_weight += popcount_u64(bits);
+        const double value = to_double(v);
+        out.zero_elements += (value == 0.0) ? 1 : 0;
+        if (value < lo) lo = value; // bf16/f16 NaNs are skipped like float NaNs
+        if (value > hi) hi = value;
+    }
+    out.min_value = std::min(out.min_value, lo);
+    out.max_value = std::max(out.max_value, hi);
+}
+
+#if defined(VPU_HAL_HAS_X86_SIMD)
+// Fused AVX-512 scans: VPOPCNTQ over the raw bits, a compare-to-zero mask, and min/max on the
+// same loaded register. MIN/MAX return their second operand when the first is NaN, so NaNs
+// never reach the accumulators.
+VPU_HAL_TARGET("avx512f,avx512vpopcntdq,popcnt")
+void stats_f32_avx512(const uint8_t* p, size_t count, Partial& out) {
+    const float* f = reinterpret_cast<const float*>(p);
+    __m512i hw = _mm512_setzero_si512();
+    __m512 lo = _mm512_set1_ps(std::numeric_limits<float>::infinity());
+    __m512 hi = _mm512_set1_ps(-std::numeric_limits<float>::infinity());
+    const __m512 zero = _mm512_setzero_ps();
+    uint64_t zeros = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m512 v = _mm512_loadu_ps(f + i);
+        hw = _mm512_add_epi64(hw, _mm512_popcnt_epi64(_mm512_castps_si512(v)));
+        zeros += static_cast<uint64_t>(_mm_popcnt_u32(_mm512_cmp_ps_mask(v, zero, _CMP_EQ_OQ)));
+        lo = _mm512_min_ps(v, lo);
+        hi = _mm512_max_ps(v, hi);
+    }
+    out.hamming_weight += static_cast<uint64_t>(_mm512_reduce_add_epi64(hw));
+    out.zero_elements += zeros;
+    out.min_value = std::min(out.min_value, static_cast<double>(_mm512_reduce_min_ps(lo)));
+    out.max_value = std::max(out.max_value, static_cast<double>(_mm512_reduce_max_ps(hi)));
+    stats_scalar<float, uint32_t>(p + i * sizeof(float), count - i, out);
+}
+
+VPU_HAL_TARGET("avx512f,avx512vpopcntdq,popcnt")
+void stats_f64_avx512(const uint8_t* p, size_t count, Partial& out) {
+    const double* d = reinterpret_cast<const double*>(p);
+    __m512i hw = _mm512_setzero_si512();
+    __m512d lo = _mm512_set1_pd(std::numeric_limits<double>::infinity());
+    __m512d hi = _mm512_set1_pd(-std::numeric_limits<double>::infinity());
+    const __m512d zero = _mm512_setzero_pd();
+    uint64_t zeros = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512d v = _mm512_loadu_pd(d + i);
+        hw = _mm512_add_epi64(hw, _mm512_popcnt_epi64(_mm512_castpd_si512(v)));
+        zeros += static_cast<uint64_t>(_mm_popcnt_u32(_mm512_cmp_pd_mask(v, zero, _CMP_EQ_OQ)));
+        lo = _mm512_min_pd(v, lo);
+        hi = _mm512_max_pd(v, hi);
+    }
+    out.hamming_weight += static_cast<uint64_t>(_mm512_reduce_add_epi64(hw));
+    out.zero_elements += zeros;
+    out.min_value = std::min(out.min_value, _mm512_reduce_min_pd(lo));
+    out.max_value = std::max(out.max_value, _mm512_reduce_max_pd(hi));
+    stats_scalar<double, uint64_t>(p + i * sizeof(double), count - i, out);
+}
+
+// AVX2 has no vector popcount: count nibbles with PSHUFB and sum bytes with PSADBW.
+VPU_HAL_TARGET("avx2,fma,popcnt")
+inline __m256i popcount_epi64_avx2(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+    const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+VPU_HAL_TARGET("avx2,fma,popcnt")
+uint64_t hsum_epi64_avx2(__m256i v) {
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+VPU_HAL_TARGET("avx2,fma,popcnt")
+void stats_f32_avx2(const uint8_t* p, size_t count, Partial& out) {
+    const float* f = reinterpret_cast<const float*>(p);
+    __m256i hw = _mm256_setzero_si256();
+    __m256 lo = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    __m256 hi = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    const __m256 zero = _mm256_setzero_ps();
+    uint64_t zeros = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 v = _mm256_loadu_ps(f + i);
+        hw = _mm256_add_epi64(hw, popcount_epi64_avx2(_mm256_castps_si256(v)));
+        zeros += static_cast<uint64_t>(_mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(v, zero, _CMP_EQ_OQ)))));
+        lo = _mm256_min_ps(v, lo);
+        hi = _mm256_max_ps(v, hi);
+    }
+    alignas(32) float lo_lanes[8], hi_lanes[8];
+    _mm256_store_ps(lo_lanes, lo);
+    _mm256_store_ps(hi_lanes, hi);
+    for (int l = 0; l < 8; ++l) {
+        out.min_value = std::min(out.min_value, static_cast<double>(lo_lanes[l]));
+        out.max_value = std::max(out.max_value, static_cast<double>(hi_lanes[l]));
+    }
+    out.hamming_weight += hsum_epi64_avx2(hw);
+    out.zero_elements += zeros;
+    stats_scalar<float, uint32_t>(p + i * sizeof(float), count - i, out);
+}
+
+VPU_HAL_TARGET("avx2,fma,popcnt")
+void stats_f64_avx2(const uint8_t* p, size_t count, Partial& out) {
+    const double* d = reinterpret_cast<const double*>(p);
+    __m256i hw = _mm256_setzero_si256();
+    __m256d lo = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d hi = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    const __m256d zero = _mm256_setzero_pd();
+    uint64_t zeros = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d v = _mm256_loadu_pd(d + i);
+        hw = _mm256_add_epi64(hw, popcount_epi64_avx2(_mm256_castpd_si256(v)));
+        zeros += static_cast<uint64_t>(_mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(v, zero, _CMP_EQ_OQ)))));
+        lo = _mm256_min_pd(v, lo);
+        hi = _mm256_max_pd(v, hi);
+    }
+    alignas(32) double lo_lanes[4], hi_lanes[4];
+    _mm256_store_pd(lo_lanes, lo);
+    _mm256_store_pd(hi_lanes, hi);
+    for (int l = 0; l < 4; ++l) {
+        out.min_value = std::min(out.min_value, lo_lanes[l]);
+        out.max_value = std::max(out.max_value, hi_lanes[l]);
+    }
+    out.hamming_weight += hsum_epi64_avx2(hw);
+    out.zero_elements += zeros;
+    stats_scalar<double, uint64_t>(p + i * sizeof(double), count - i, out);
+}
+#endif
+
+StatsKernel select_kernel(ElementType type) {
+    if (type == ElementType::BYTES) return &stats_bytes;
+    if (type == ElementType::INT8) return &stats_narrow<int8_t, uint8_t>;
+    if (type == ElementType::BFLOAT16) return &stats_narrow<bfloat16, uint16_t>;
+    if (type == ElementType::FLOAT16) return &stats_narrow<float16, uint16_t>;
+#if defined(VPU_HAL_HAS_X86_SIMD)
+    const CpuFeatures& f = cpu_features();
+    if (f.avx512_vpopcntdq) return type == ElementType::FLOAT32 ? &stats_f32_avx512 : &stats_f64_avx512;
+    if (f.avx2_fma && f.popcnt) return type == ElementType::FLOAT32 ? &stats_f32_avx2 : &stats_f64_avx2;
+#endif
+    return type == ElementType::FLOAT32 ? &stats_scalar<float, uint32_t> : &stats_scalar<double, uint64_t>;
+}
+
+StatsKernel stats_kernel(ElementType type) {
+    static const StatsKernel kernels[6] = {
+        select_kernel(ElementType::BYTES), select_kernel(ElementType::FLOAT32), select_kernel(ElementType::FLOAT64),
+        select_kernel(ElementType::INT8), select_kernel(ElementType::BFLOAT16), select_kernel(ElementType::FLOAT16)
+    };
+    return kernels[static_cast<int>(type)];
+}
+
+} // namespace
+
+BufferStats compute_buffer_stats(const void* data, size_t bytes, ElementType type) {
+    BufferStats stats;
+    stats.data = data;
+    stats.bytes = data ? bytes : 0;
+    stats.type = type;
+    if (!data || bytes == 0) return stats;
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const size_t elem = element_size(type);
+    stats.elements = bytes / elem;
+    const StatsKernel kernel = stats_kernel(type);
+
+    Partial total;
+    if (bytes < PARALLEL_SCAN_THRESHOLD_BYTES) {
+        kernel(p, stats.elements, total);
+    } else {
+        // Chunks are a whole number of elements (the chunk size is a multiple of 8 bytes).
+        const size_t elems_per_chunk = PARALLEL_SCAN_CHUNK_BYTES / elem;
+        const size_t chunks = (stats.elements + elems_per_chunk - 1) / elems_per_chunk;
+        std::vector<Partial> partials(chunks);
+        parallel_for(chunks, parallel_helper_count(), [&](size_t c) {
+            const size_t first = c * elems_per_chunk;
+            kernel(p + first * elem, std::min(elems_per_chunk, stats.elements - first), partials[c]);
+        });
+        for (const Partial& partial : partials) total.merge(partial);
+    }
+    // Bytes past the last whole element still count towards the Hamming weight.
+    const size_t tail_offset = stats.elements * elem;
+    total.hamming_weight += hamming_weight_scalar(p + tail_offset, bytes - tail_offset);
+
+    stats.hamming_weight = total.hamming_weight;
+    stats.zero_elements = total.zero_elements;
+    if (total.min_value <= total.max_value) { // False if there were no non-NaN elements
+        stats.min_value = total.min_value;
+        stats.max_value = total.max_value;
+    }
+    return stats;
+}
+
+uint64_t hamming_weight_reusing(const BufferStats& known, const void* data, size_t bytes) {
+    if (known.describes(data, bytes)) {
+        return known.hamming_weight;
+    }
+    return calculate_data_hamming_weight(data, bytes);
+}
+
+uint64_t hamming_weight_reusing(const void* data, size_t bytes) {
+    return hamming_weight_reusing(KnownBufferStats::current(), data, bytes);
+}
+
+namespace {
+thread_local const KnownBufferStats* t_known_stats = nullptr; // Innermost scope on this thread
+} // namespace
+
+KnownBufferStats::KnownBufferStats(const BufferStats& stats) : stats_(stats), outer_(t_known_stats) {
+    t_known_stats = this;
+}
+
+KnownBufferStats::~KnownBufferStats() {
+    t_known_stats = outer_;
+}
+
+const BufferStats& KnownBufferStats::current() {
+    static const BufferStats none;
+    return t_known_stats ? t_known_stats->stats_ : none;
+}
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace VPU {
+namespace HAL {
+
+// How compute_buffer_stats() interprets a buffer's values (the popcount is type-independent).
+enum class ElementType {
+    BYTES,    // Unsigned bytes
+    FLOAT32,
+    FLOAT64,
+    INT8,     // Signed bytes
+    BFLOAT16, // Upper half of a float32 (see hal/dtype.h)
+    FLOAT16   // IEEE binary16 (see hal/dtype.h)
+};
+
+inline size_t element_size(ElementType type) {
+    switch (type) {
+        case ElementType::FLOAT32: return sizeof(float);
+        case ElementType::FLOAT64: return sizeof(double);
+        case ElementType::BFLOAT16:
+        case ElementType::FLOAT16: return sizeof(uint16_t);
+        case ElementType::INT8:
+        case ElementType::BYTES: break;
+    }
+    return 1;
+}
+
+inline const char* element_type_name(ElementType type) {
+    switch (type) {
+        case ElementType::FLOAT32: return "f32";
+        case ElementType::FLOAT64: return "f64";
+        case ElementType::INT8: return "i8";
+        case ElementType::BFLOAT16: return "bf16";
+        case ElementType::FLOAT16: return "f16";
+        case ElementType::BYTES: break;
+    }
+    return "u8";
+}
+
+// Everything the VPU measures about a buffer, gathered in a single fused read:
+// Hamming weight, exact-zero count and min/max value.
+struct BufferStats {
+    // What was scanned, so a later consumer can check the stats describe its buffer.
+    const void* data = nullptr;
+    size_t bytes = 0;
+    ElementType type = ElementType::BYTES;
+
+    uint64_t hamming_weight = 0; // Set bits over all 'bytes' (including a trailing partial element)
+    uint64_t elements = 0;       // Whole elements of 'type'
+    uint64_t zero_elements = 0;  // Elements equal to zero (+0.0 and -0.0 for floats)
+    double min_value = 0.0;      // NaNs are ignored; 0 if there are no (non-NaN) elements
+    double max_value = 0.0;
+
+    bool describes(const void* buffer, size_t buffer_bytes) const {
+        return data != nullptr && data == buffer && bytes == buffer_bytes;
+    }
+    double zero_ratio() const { return elements ? static_cast<double>(zero_elements) / elements : 1.0; }
+};
+
+// Scans 'bytes' bytes at 'data' once, with AVX-512 (VPOPCNTDQ) or AVX2 when available.
+// Buffers of PARALLEL_SCAN_THRESHOLD_BYTES or more are split into chunks across the HAL pool.
+BufferStats compute_buffer_stats(const void* data, size_t bytes, ElementType type);
+
+// Hamming weight of a buffer, reusing 'known' if it was computed for exactly this buffer
+// (e.g. the Cortex's profile of a task input) instead of scanning it again.
+uint64_t hamming_weight_reusing(const BufferStats& known, const void* data, size_t bytes);
+// As above, with the stats published by the innermost KnownBufferStats on this thread.
+uint64_t hamming_weight_reusing(const void* data, size_t bytes);
+
+// Publishes the stats of a buffer that has already been scanned to the code this thread runs
+// while the scope is alive (the Cerebellum publishes the Cortex's profile of a task's input for
+// one execution, so its kernels need not take it as a parameter). Scopes nest.
+class KnownBufferStats {
+public:
+    explicit KnownBufferStats(const BufferStats& stats);
+    ~KnownBufferStats();
+    KnownBufferStats(const KnownBufferStats&) = delete;
+    KnownBufferStats& operator=(const KnownBufferStats&) = delete;
+
+    // The innermost scope's stats on this thread; empty stats (describing nothing) outside any.
+    static const BufferStats& current();
+
+private:
+    BufferStats stats_;
+    const KnownBufferStats* outer_;
+};
+
+} // namespace HAL
+} // namespace VPU
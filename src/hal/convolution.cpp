@@ -0,0 +1,296 @@
+#include "hal/convolution.h"
+#include "hal/hal.h"            // For fft_spectrum_doubles
+#include "hal/cpu_features.h"
+#include "hal/simd_target.h"
+#include "hal/fft_plan_cache.h" // For cached FFTW plans
+#include "hal/scratch_arena.h"  // For the filter spectrum and inverse staging
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <algorithm> // For std::min, std::max, std::copy, std::fill
+#include <cstring>   // For std::memcpy
+#include <fftw3.h>
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+
+// Outputs [begin, end) summed one at a time; also the edge where fewer than M inputs exist.
+void conv_direct_range(const double* x, const double* h, double* y, size_t M, size_t begin, size_t end) {
+    for (size_t n = begin; n < end; ++n) {
+        const size_t taps = std::min(M, n + 1);
+        double acc = 0.0;
+        for (size_t k = 0; k < taps; ++k) {
+            acc += h[k] * x[n - k];
+        }
+        y[n] = acc;
+    }
+}
+
+bool check_conv_args(const char* name, Span<const double> x, Span<const double> h, Span<double> y) {
+    if (x.empty() || h.empty() || y.size() > x.size()) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] " << name << ": needs a signal, at least one tap, and an output no longer than the signal ("
+                  << x.size() << " samples, " << h.size() << " taps, " << y.size() << " outputs).");
+        return false;
+    }
+    return true;
+}
+
+// Outputs from M - 1 on see every tap, so they are vectorized across n: lane j accumulates
+// h[k] * x[n + j - k]. Two accumulators per step hide the FMA latency.
+#if defined(VPU_HAL_HAS_X86_SIMD)
+VPU_HAL_TARGET("avx2,fma")
+void conv_direct_avx2(const double* x, const double* h, double* y, size_t M, size_t len) {
+    size_t n = std::min(M - 1, len);
+    conv_direct_range(x, h, y, M, 0, n);
+    for (; n + 8 <= len; n += 8) {
+        __m256d acc0 = _mm256_setzero_pd();
+        __m256d acc1 = _mm256_setzero_pd();
+        for (size_t k = 0; k < M; ++k) {
+            const __m256d tap = _mm256_set1_pd(h[k]);
+            acc0 = _mm256_fmadd_pd(tap, _mm256_loadu_pd(x + n - k), acc0);
+            acc1 = _mm256_fmadd_pd(tap, _mm256_loadu_pd(x + n + 4 - k), acc1);
+        }
+        _mm256_storeu_pd(y + n, acc0);
+        _mm256_storeu_pd(y + n + 4, acc1);
+    }
+    conv_direct_range(x, h, y, M, n, len);
+}
+
+VPU_HAL_TARGET("avx512f")
+void conv_direct_avx512(const double* x, const double* h, double* y, size_t M, size_t len) {
+    size_t n = std::min(M - 1, len);
+    conv_direct_range(x, h, y, M, 0, n);
+    for (; n + 16 <= len; n += 16) {
+        __m512d acc0 = _mm512_setzero_pd();
+        __m512d acc1 = _mm512_setzero_pd();
+        for (size_t k = 0; k < M; ++k) {
+            const __m512d tap = _mm512_set1_pd(h[k]);
+            acc0 = _mm512_fmadd_pd(tap, _mm512_loadu_pd(x + n - k), acc0);
+            acc1 = _mm512_fmadd_pd(tap, _mm512_loadu_pd(x + n + 8 - k), acc1);
+        }
+        _mm512_storeu_pd(y + n, acc0);
+        _mm512_storeu_pd(y + n + 8, acc1);
+    }
+    conv_direct_range(x, h, y, M, n, len);
+}
+#endif
+
+#if defined(VPU_HAL_HAS_NEON)
+void conv_direct_neon(const double* x, const double* h, double* y, size_t M, size_t len) {
+    size_t n = std::min(M - 1, len);
+    conv_direct_range(x, h, y, M, 0, n);
+    for (; n + 4 <= len; n += 4) {
+        float64x2_t acc0 = vdupq_n_f64(0.0);
+        float64x2_t acc1 = vdupq_n_f64(0.0);
+        for (size_t k = 0; k < M; ++k) {
+            const float64x2_t tap = vdupq_n_f64(h[k]);
+            acc0 = vfmaq_f64(acc0, tap, vld1q_f64(x + n - k));
+            acc1 = vfmaq_f64(acc1, tap, vld1q_f64(x + n + 2 - k));
+        }
+        vst1q_f64(y + n, acc0);
+        vst1q_f64(y + n + 2, acc1);
+    }
+    conv_direct_range(x, h, y, M, n, len);
+}
+#endif
+
+size_t next_power_of_two(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+fftw_complex* as_fftw_complex(double* p) { return reinterpret_cast<fftw_complex*>(p); }
+
+bool check_layout(const char* name, const OverlapSaveLayout& layout, size_t in_doubles, size_t in_needed,
+                  size_t out_doubles, size_t out_needed) {
+    if (!layout.valid() || in_doubles < in_needed || out_doubles < out_needed) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] " << name << ": buffers do not match the overlap-save layout (need "
+                  << in_needed << " in / " << out_needed << " out doubles, got " << in_doubles << " / " << out_doubles << ").");
+        return false;
+    }
+    return true;
+}
+
+// R2C in place on one block slot holding B real samples (the slot has room for the spectrum).
+bool forward_block_inplace(double* slot, int B) {
+    fftw_plan plan = FFTPlanCache::instance().get_r2c_plan(B, slot, as_fftw_complex(slot));
+    if (!plan) {
+        VPU_LOG_ERROR("FFTW3 Error: in-place R2C plan failed for overlap-save block of " << B << " samples.");
+        return false;
+    }
+    fftw_execute_dft_r2c(plan, slot, as_fftw_complex(slot));
+    return true;
+}
+
+// Copies block b's window of x, x[b * hop - (M - 1) .. + B), zero outside the signal.
+void load_block(const double* x, const OverlapSaveLayout& layout, size_t b, double* slot) {
+    const size_t B = layout.fft_length;
+    const ptrdiff_t start = static_cast<ptrdiff_t>(b * layout.hop) - static_cast<ptrdiff_t>(layout.filter_length - 1);
+    for (size_t i = 0; i < B; ++i) {
+        const ptrdiff_t t = start + static_cast<ptrdiff_t>(i);
+        slot[i] = (t >= 0 && t < static_cast<ptrdiff_t>(layout.signal_length)) ? x[t] : 0.0;
+    }
+}
+
+// FFT(h zero-padded to B) / B, so the inverse transforms need no separate normalization pass.
+bool filter_spectrum(Span<const double> h, const OverlapSaveLayout& layout, double* out) {
+    const size_t B = layout.fft_length;
+    std::copy(h.begin(), h.end(), out);
+    std::fill(out + h.size(), out + layout.spectrum_stride, 0.0);
+    if (!forward_block_inplace(out, static_cast<int>(B))) {
+        return false;
+    }
+    const double scale = 1.0 / static_cast<double>(B);
+    for (size_t i = 0; i < fft_spectrum_doubles(B); ++i) {
+        out[i] *= scale;
+    }
+    return true;
+}
+
+void multiply_spectrum(const double* a, const double* h_spectrum, double* out, size_t complex_values) {
+    for (size_t i = 0; i < complex_values; ++i) {
+        const double re = a[2 * i] * h_spectrum[2 * i] - a[2 * i + 1] * h_spectrum[2 * i + 1];
+        const double im = a[2 * i] * h_spectrum[2 * i + 1] + a[2 * i + 1] * h_spectrum[2 * i];
+        out[2 * i] = re;
+        out[2 * i + 1] = im;
+    }
+}
+
+} // namespace
+
+bool cpu_conv_direct_scalar(Span<const double> x, Span<const double> h, Span<double> y) {
+    if (!check_conv_args("CONV_DIRECT", x, h, y)) return false;
+    conv_direct_range(x.data(), h.data(), y.data(), h.size(), 0, y.size());
+    return true;
+}
+
+bool cpu_conv_direct(Span<const double> x, Span<const double> h, Span<double> y) {
+    if (!check_conv_args("CONV_DIRECT", x, h, y)) return false;
+    const SimdIsa isa = best_simd_isa();
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing direct convolution (" << h.size() << " taps, " << simd_isa_name(isa) << ").");
+#if defined(VPU_HAL_HAS_X86_SIMD)
+    if (isa == SimdIsa::AVX512) {
+        conv_direct_avx512(x.data(), h.data(), y.data(), h.size(), y.size());
+        return true;
+    }
+    if (isa == SimdIsa::AVX2) {
+        conv_direct_avx2(x.data(), h.data(), y.data(), h.size(), y.size());
+        return true;
+    }
+#endif
+#if defined(VPU_HAL_HAS_NEON)
+    if (isa == SimdIsa::NEON) {
+        conv_direct_neon(x.data(), h.data(), y.data(), h.size(), y.size());
+        return true;
+    }
+#endif
+    conv_direct_range(x.data(), h.data(), y.data(), h.size(), 0, y.size());
+    return true;
+}
+
+OverlapSaveLayout plan_overlap_save(size_t signal_length, size_t filter_length) {
+    OverlapSaveLayout layout;
+    if (signal_length == 0 || filter_length == 0) {
+        return layout; // Invalid: blocks == 0
+    }
+    // B ~ 4M keeps the M - 1 discarded samples per block under a quarter of the work;
+    // a signal that fits in one such block is transformed whole.
+    const size_t MIN_FFT_LENGTH = 64;
+    const size_t full_length = signal_length + filter_length - 1;
+    size_t B = next_power_of_two(std::max(4 * filter_length, MIN_FFT_LENGTH));
+    if (B >= full_length) {
+        B = next_power_of_two(std::max<size_t>(full_length, 2));
+    }
+    layout.signal_length = signal_length;
+    layout.filter_length = filter_length;
+    layout.fft_length = B;
+    layout.hop = B - (filter_length - 1);
+    layout.blocks = (signal_length + layout.hop - 1) / layout.hop;
+    const size_t DOUBLES_PER_CACHE_LINE = 8;
+    layout.spectrum_stride = (fft_spectrum_doubles(B) + DOUBLES_PER_CACHE_LINE - 1) / DOUBLES_PER_CACHE_LINE * DOUBLES_PER_CACHE_LINE;
+    return layout;
+}
+
+bool overlap_save_forward(Span<const double> x, const OverlapSaveLayout& layout, Span<double> spectra) {
+    if (!check_layout("FFT_FORWARD (overlap-save)", layout, x.size(), layout.signal_length, spectra.size(), layout.spectra_doubles())) {
+        return false;
+    }
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Overlap-save forward: " << layout.blocks << " block(s) of " << layout.fft_length << " samples.");
+    for (size_t b = 0; b < layout.blocks; ++b) {
+        double* slot = spectra.data() + b * layout.spectrum_stride;
+        load_block(x.data(), layout, b, slot);
+        if (!forward_block_inplace(slot, static_cast<int>(layout.fft_length))) return false;
+    }
+    return true;
+}
+
+bool overlap_save_multiply(Span<const double> spectra, Span<const double> h, const OverlapSaveLayout& layout,
+                           Span<double> products) {
+    if (h.size() != layout.filter_length ||
+        !check_layout("ELEMENT_WISE_MULTIPLY (overlap-save)", layout, spectra.size(), layout.spectra_doubles(),
+                      products.size(), layout.spectra_doubles())) {
+        return false;
+    }
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Overlap-save multiply: " << layout.blocks << " spectra by the filter's.");
+    ScratchScope scratch;
+    double* h_spectrum = scratch.acquire_span<double>(layout.spectrum_stride).data();
+    if (!filter_spectrum(h, layout, h_spectrum)) return false;
+    const size_t complex_values = layout.fft_length / 2 + 1;
+    for (size_t b = 0; b < layout.blocks; ++b) {
+        multiply_spectrum(spectra.data() + b * layout.spectrum_stride, h_spectrum,
+                          products.data() + b * layout.spectrum_stride, complex_values);
+    }
+    return true;
+}
+
+bool overlap_save_forward_multiply(Span<const double> x, Span<const double> h, const OverlapSaveLayout& layout,
+                                   Span<double> products) {
+    if (h.size() != layout.filter_length ||
+        !check_layout("FFT_FORWARD + ELEMENT_WISE_MULTIPLY (overlap-save)", layout, x.size(), layout.signal_length,
+                      products.size(), layout.spectra_doubles())) {
+        return false;
+    }
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Overlap-save forward + multiply (fused): " << layout.blocks << " block(s) of "
+              << layout.fft_length << " samples.");
+    ScratchScope scratch;
+    double* h_spectrum = scratch.acquire_span<double>(layout.spectrum_stride).data();
+    if (!filter_spectrum(h, layout, h_spectrum)) return false;
+    const size_t complex_values = layout.fft_length / 2 + 1;
+    for (size_t b = 0; b < layout.blocks; ++b) {
+        double* slot = products.data() + b * layout.spectrum_stride;
+        load_block(x.data(), layout, b, slot);
+        if (!forward_block_inplace(slot, static_cast<int>(layout.fft_length))) return false;
+        multiply_spectrum(slot, h_spectrum, slot, complex_values);
+    }
+    return true;
+}
+
+bool overlap_save_inverse(Span<const double> products, const OverlapSaveLayout& layout, Span<double> y) {
+    if (!check_layout("FFT_INVERSE (overlap-save)", layout, products.size(), layout.spectra_doubles(), y.size(), layout.signal_length)) {
+        return false;
+    }
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Overlap-save inverse: keeping " << layout.hop << " of " << layout.fft_length
+              << " samples per block.");
+    // C2R destroys its input, so each spectrum is staged (aligned) and transformed in place.
+    ScratchScope scratch;
+    double* staged = scratch.acquire_span<double>(layout.spectrum_stride).data();
+    const int B = static_cast<int>(layout.fft_length);
+    fftw_plan plan = FFTPlanCache::instance().get_c2r_plan(B, as_fftw_complex(staged), staged);
+    if (!plan) {
+        VPU_LOG_ERROR("FFTW3 Error: in-place C2R plan failed for overlap-save block of " << B << " samples.");
+        return false;
+    }
+    const size_t discard = layout.filter_length - 1;
+    for (size_t b = 0; b < layout.blocks; ++b) {
+        std::memcpy(staged, products.data() + b * layout.spectrum_stride, fft_spectrum_doubles(layout.fft_length) * sizeof(double));
+        fftw_execute_dft_c2r(plan, as_fftw_complex(staged), staged);
+        const size_t begin = b * layout.hop;
+        const size_t count = std::min(layout.hop, layout.signal_length - begin);
+        std::copy(staged + discard, staged + discard + count, y.data() + begin);
+    }
+    return true;
+}
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "hal/span.h"
+#include <cstddef>
+
+namespace VPU {
+namespace HAL {
+
+// Causal FIR filtering of a signal x by taps h (both double):
+//     y[n] = sum over k < h.size(), k <= n of h[k] * x[n - k],   for n < y.size()
+// i.e. the first y.size() samples of the linear convolution x * h. y must hold at most
+// x.size() samples (pad x with zeros for the full N + M - 1 tail) and must not alias x or h.
+// Every function here returns false (and logs) on invalid arguments.
+
+// Time domain, O(N * M). Vectorized across outputs with the widest supported ISA.
+bool cpu_conv_direct(Span<const double> x, Span<const double> h, Span<double> y);
+bool cpu_conv_direct_scalar(Span<const double> x, Span<const double> h, Span<double> y); // Reference
+
+// Frequency domain by overlap-save, O(N log M). The signal is cut into blocks of fft_length
+// samples that overlap by M - 1; each block's circular convolution with h is exact past its
+// first M - 1 outputs, so every block contributes 'hop' new samples and nothing is summed.
+struct OverlapSaveLayout {
+    size_t signal_length = 0;   // N
+    size_t filter_length = 0;   // M
+    size_t fft_length = 0;      // B: a power of two, at least 4 * M (one block if the signal fits)
+    size_t hop = 0;             // B - (M - 1) outputs per block
+    size_t blocks = 0;
+    size_t spectrum_stride = 0; // Doubles between block spectra: fft_spectrum_doubles(B), rounded to a cache line
+
+    bool valid() const { return blocks > 0; }
+    size_t spectra_doubles() const { return blocks * spectrum_stride; } // Size of a spectra buffer
+};
+
+OverlapSaveLayout plan_overlap_save(size_t signal_length, size_t filter_length);
+
+// The three stages of the frequency-domain plan: FFT_FORWARD, ELEMENT_WISE_MULTIPLY, FFT_INVERSE.
+// 'spectra' and 'products' hold layout.spectra_doubles() values (one interleaved R2C spectrum
+// per block). Buffers aligned to 64 bytes (e.g. from ScratchArena) get FFTW's aligned plans.
+bool overlap_save_forward(Span<const double> x, const OverlapSaveLayout& layout, Span<double> spectra);
+// products = spectra * FFT(h) / B, block by block. 'products' may be 'spectra' itself.
+bool overlap_save_multiply(Span<const double> spectra, Span<const double> h, const OverlapSaveLayout& layout,
+                           Span<double> products);
+// Keeps the valid 'hop' samples of each block's inverse transform; y holds layout.signal_length samples.
+bool overlap_save_inverse(Span<const double> products, const OverlapSaveLayout& layout, Span<double> y);
+
+// FFT_FORWARD and ELEMENT_WISE_MULTIPLY in one pass: each block is multiplied while its spectrum is still in cache.
+bool overlap_save_forward_multiply(Span<const double> x, Span<const double> h, const OverlapSaveLayout& layout,
+                                   Span<double> products);
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,152 @@
+#include "hal/cpu_features.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h> // For sysconf
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VPU_HAL_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+
+#if defined(VPU_HAL_X86)
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<uint32_t>(r[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+CpuFeatures detect() {
+    CpuFeatures f;
+#if defined(VPU_HAL_X86)
+    uint32_t regs[4] = {0, 0, 0, 0};
+    cpuid(0, 0, regs);
+    const uint32_t max_leaf = regs[0];
+
+    cpuid(1, 0, regs);
+    const uint32_t leaf1_ecx = regs[2];
+    f.popcnt = (leaf1_ecx >> 23) & 1;
+    const bool fma = (leaf1_ecx >> 12) & 1;
+    const bool osxsave = (leaf1_ecx >> 27) & 1;
+
+    // The OS must save XMM/YMM (bits 1-2) for AVX, and also opmask/ZMM (bits 5-7) for AVX-512.
+    const uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+    const bool os_avx = (xcr0 & 0x6) == 0x6;
+    const bool os_avx512 = (xcr0 & 0xE6) == 0xE6;
+
+    if (max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        const uint32_t leaf7_ebx = regs[1];
+        const uint32_t leaf7_ecx = regs[2];
+        f.avx2_fma = os_avx && fma && ((leaf7_ebx >> 5) & 1);
+        f.avx512f = os_avx512 && ((leaf7_ebx >> 16) & 1);
+        f.avx512_vpopcntdq = f.avx512f && ((leaf7_ecx >> 14) & 1);
+    }
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+    f.neon = true; // Advanced SIMD is mandatory on AArch64
+#endif
+    return f;
+}
+
+// "48K", "2048K", "8M" as reported by /sys/devices/system/cpu/cpu0/cache/index*/size.
+uint64_t parse_cache_size(const std::string& text) {
+    size_t digits = 0;
+    uint64_t value = 0;
+    while (digits < text.size() && text[digits] >= '0' && text[digits] <= '9') {
+        value = value * 10 + static_cast<uint64_t>(text[digits++] - '0');
+    }
+    const char unit = digits < text.size() ? text[digits] : '\0';
+    return unit == 'K' ? value * 1024 : unit == 'M' ? value * 1024 * 1024 : unit == 'G' ? value * 1024 * 1024 * 1024 : value;
+}
+
+CacheSizes detect_cache_sizes() {
+    CacheSizes sizes;
+    uint64_t found[4] = {0, 0, 0, 0}; // By level; L1 counts only its data cache
+    for (int index = 0; index < 8; ++index) {
+        const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::ifstream level_file(dir + "level"), type_file(dir + "type"), size_file(dir + "size");
+        int level = 0;
+        std::string type, size;
+        if (!(level_file >> level) || !(type_file >> type) || !(size_file >> size)) break;
+        if (level >= 1 && level <= 3 && type != "Instruction") {
+            found[level] = parse_cache_size(size);
+        }
+    }
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+    const int names[4] = {0, _SC_LEVEL1_DCACHE_SIZE, _SC_LEVEL2_CACHE_SIZE, _SC_LEVEL3_CACHE_SIZE};
+    for (int level = 1; level <= 3; ++level) {
+        if (found[level] == 0) {
+            const long value = sysconf(names[level]);
+            found[level] = value > 0 ? static_cast<uint64_t>(value) : 0;
+        }
+    }
+#endif
+    if (found[1]) sizes.l1d_bytes = found[1];
+    if (found[2]) sizes.l2_bytes = found[2];
+    if (found[3]) sizes.l3_bytes = found[3];
+    return sizes;
+}
+
+} // namespace
+
+const CacheSizes& cpu_cache_sizes() {
+    static const CacheSizes sizes = detect_cache_sizes();
+    return sizes;
+}
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+bool cpu_supports(SimdIsa isa) {
+    const CpuFeatures& f = cpu_features();
+    switch (isa) {
+        case SimdIsa::SCALAR: return true;
+        case SimdIsa::AVX2: return f.avx2_fma;
+        case SimdIsa::AVX512: return f.avx512f;
+        case SimdIsa::NEON: return f.neon;
+    }
+    return false;
+}
+
+const char* simd_isa_name(SimdIsa isa) {
+    switch (isa) {
+        case SimdIsa::SCALAR: return "SCALAR";
+        case SimdIsa::AVX2: return "AVX2";
+        case SimdIsa::AVX512: return "AVX512";
+        case SimdIsa::NEON: return "NEON";
+    }
+    return "UNKNOWN";
+}
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace VPU {
+namespace HAL {
+
+// Instruction-set families the HAL has vectorized kernels for.
+enum class SimdIsa {
+    SCALAR,
+    AVX2,   // x86-64 AVX2 + FMA
+    AVX512, // x86-64 AVX-512F
+    NEON    // AArch64 Advanced SIMD
+};
+
+// What the running CPU (and OS) supports, detected once at first use.
+// x86 checks use CPUID plus XGETBV, so a feature only counts if the OS saves its register state.
+struct CpuFeatures {
+    bool popcnt = false;
+    bool avx2_fma = false;
+    bool avx512f = false;
+    bool avx512_vpopcntdq = false;
+    bool neon = false;
+};
+
+const CpuFeatures& cpu_features();
+
+// True if kernels for 'isa' were compiled in and the running CPU can execute them.
+bool cpu_supports(SimdIsa isa);
+
+const char* simd_isa_name(SimdIsa isa);
+
+// Data cache capacities of the CPU the process started on, detected once at first use (from
+// sysfs, then sysconf). Levels that cannot be detected keep these typical sizes.
+struct CacheSizes {
+    uint64_t l1d_bytes = 32 * 1024;
+    uint64_t l2_bytes = 1024 * 1024;
+    uint64_t l3_bytes = 32 * 1024 * 1024;
+};
+
+const CacheSizes& cpu_cache_sizes();
+
+// The widest supported ISA (AVX512 > AVX2 > NEON > SCALAR); used by the auto-dispatched kernels.
+SimdIsa best_simd_isa();
+
+} // namespace HAL
+} // namespace VPU
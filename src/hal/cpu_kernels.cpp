@@ -1,33 +1,46 @@
 #include "hal/hal.h"
-#include <iostream>
+#include "hal/fft_plan_cache.h" // For cached FFTW plans
+#include "hal/scratch_arena.h"  // For C2R staging
+#include "runtime/trace.h" // For VPU_LOG_*
 #include <vector> // Ensure vector is included for std::vector parameters
+#include <algorithm> // For std::min, std::copy
 #include <fftw3.h> // For FFTW functions
 
 namespace VPU {
 namespace HAL {
 
 // --- SAXPY ---
-void cpu_saxpy(float a, const std::vector<float>& x, std::vector<float>& y) {
+template <typename T>
+void cpu_saxpy_scalar(T a, Span<const T> x, Span<T> y) {
     // FLUX-AWARE OPTIMIZATION:
     // If 'a' is zero, the operation is a no-op.
     // This simple check avoids potentially millions of operations.
-    if (a == 0.0f) {
-        std::cout << "    -> [HAL KERNEL] SAXPY Flux-Optimization triggered (alpha=0). Skipping computation." << std::endl;
+    if (a == T(0)) {
+        VPU_LOG_TRACE("    -> [HAL KERNEL] SAXPY Flux-Optimization triggered (alpha=0). Skipping computation.");
         return;
     }
-    std::cout << "    -> [HAL KERNEL] Executing SAXPY on CPU." << std::endl;
-    for (size_t i = 0; i < x.size(); ++i) {
-        y[i] = a * x[i] + y[i];
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing SAXPY on CPU.");
+    const size_t n = std::min(x.size(), y.size());
+    const T* xp = x.data();
+    T* yp = y.data();
+    for (size_t i = 0; i < n; ++i) {
+        yp[i] = a * xp[i] + yp[i];
     }
 }
+template void cpu_saxpy_scalar<float>(float, Span<const float>, Span<float>);
+template void cpu_saxpy_scalar<double>(double, Span<const double>, Span<double>);
 
-// --- GEMM (Naive) ---
-void cpu_gemm_naive(const std::vector<float>& A, const std::vector<float>& B, std::vector<float>& C, int M, int N, int K) {
-    std::cout << "    -> [HAL KERNEL] Executing Naive GEMM (Matrix-Matrix Multiply)." << std::endl;
+void cpu_saxpy(float a, Span<const float> x, Span<float> y) {
+    cpu_saxpy_scalar<float>(a, x, y);
+}
+
+template <typename T>
+void cpu_gemm_naive_scalar(Span<const T> A, Span<const T> B, Span<T> C, int M, int N, int K) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing Naive GEMM (Matrix-Matrix Multiply).");
     // Standard, highly inefficient triple-loop implementation. Serves as a baseline.
     for (int i = 0; i < M; ++i) {
         for (int j = 0; j < N; ++j) {
-            float sum = 0.0f;
+            T sum = T(0);
             for (int k = 0; k < K; ++k) {
                 sum += A[i * K + k] * B[k * N + j];
             }
@@ -35,10 +48,16 @@ void cpu_gemm_naive(const std::vector<float>& A, const std::vector<float>& B, st
         }
     }
 }
+template void cpu_gemm_naive_scalar<float>(Span<const float>, Span<const float>, Span<float>, int, int, int);
+template void cpu_gemm_naive_scalar<double>(Span<const double>, Span<const double>, Span<double>, int, int, int);
+
+void cpu_gemm_naive(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    cpu_gemm_naive_scalar<float>(A, B, C, M, N, K);
+}
 
 // --- GEMM (Flux-Adaptive) ---
-void cpu_gemm_flux_adaptive(const std::vector<float>& A, const std::vector<float>& B, std::vector<float>& C, int M, int N, int K) {
-    std::cout << "    -> [HAL KERNEL] Executing Flux-Adaptive GEMM (Optimized for Sparsity)." << std::endl;
+void cpu_gemm_flux_adaptive(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing Flux-Adaptive GEMM (Optimized for Sparsity).");
     // This is a conceptual kernel. A real implementation would convert to a sparse
     // format like CSR and only process non-zero elements.
     // We simulate its higher efficiency by just running the same naive code.
@@ -58,124 +77,138 @@ void cpu_gemm_flux_adaptive(const std::vector<float>& A, const std::vector<float
 
 
 // --- FFT Implementations using FFTW3 ---
-void cpu_fft_forward(const std::vector<double>& signal_in, std::vector<double>& complex_out_interleaved) {
-    std::cout << "    -> [HAL KERNEL] Executing Actual FFTW3 Forward Transform (R2C)." << std::endl;
-    if (signal_in.empty()) {
-        complex_out_interleaved.clear();
-        std::cerr << "Warning: cpu_fft_forward called with empty input signal." << std::endl;
-        return;
-    }
-    int N = signal_in.size();
+// Plans come from the process-wide FFTPlanCache and are executed on the caller's arrays.
+// An interleaved double array has the same layout as fftw_complex[], so spectra are written in place.
 
-    double* fftw_in_real;
-    fftw_complex* fftw_out_complex;
-    fftw_plan plan_r2c;
-
-    fftw_in_real = (double*)fftw_malloc(sizeof(double) * N);
-    if (!fftw_in_real) {
-        std::cerr << "FFTW3 Error: fftw_malloc for input failed in cpu_fft_forward." << std::endl;
-        complex_out_interleaved.clear();
-        return;
-    }
-    fftw_out_complex = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * (N / 2 + 1));
-    if (!fftw_out_complex) {
-        std::cerr << "FFTW3 Error: fftw_malloc for output failed in cpu_fft_forward." << std::endl;
-        fftw_free(fftw_in_real);
-        complex_out_interleaved.clear();
-        return;
-    }
+namespace {
+fftw_complex* as_fftw_complex(double* p) { return reinterpret_cast<fftw_complex*>(p); }
 
+void normalize(double* data, int N) {
+    const double scale = 1.0 / N;
     for (int i = 0; i < N; ++i) {
-        fftw_in_real[i] = signal_in[i];
+        data[i] *= scale;
     }
-
-    plan_r2c = fftw_plan_dft_r2c_1d(N, fftw_in_real, fftw_out_complex, FFTW_ESTIMATE);
+}
+} // namespace
+
+bool cpu_fft_forward(Span<const double> in, Span<double> out) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing Actual FFTW3 Forward Transform (R2C).");
+    if (in.empty()) {
+        VPU_LOG_WARN("Warning: cpu_fft_forward called with empty input signal.");
+        return false;
+    }
+    const int N = static_cast<int>(in.size());
+    if (out.size() < fft_spectrum_doubles(in.size())) {
+        VPU_LOG_ERROR("FFTW3 Error: cpu_fft_forward output holds " << out.size() << " doubles, needs "
+                  << fft_spectrum_doubles(in.size()) << " for N=" << N << ".");
+        return false;
+    }
+    // Out-of-place R2C preserves its input, so the caller's const data is never written.
+    double* in_ptr = const_cast<double*>(in.data());
+    fftw_plan plan_r2c = FFTPlanCache::instance().get_r2c_plan(N, in_ptr, as_fftw_complex(out.data()));
     if (!plan_r2c) {
-        std::cerr << "FFTW3 Error: fftw_plan_dft_r2c_1d failed in cpu_fft_forward." << std::endl;
-        fftw_free(fftw_out_complex);
-        fftw_free(fftw_in_real);
-        complex_out_interleaved.clear();
-        return;
+        VPU_LOG_ERROR("FFTW3 Error: fftw_plan_dft_r2c_1d failed in cpu_fft_forward.");
+        return false;
     }
+    fftw_execute_dft_r2c(plan_r2c, in_ptr, as_fftw_complex(out.data()));
+    return true;
+}
 
-    fftw_execute(plan_r2c);
-
-    complex_out_interleaved.resize((N / 2 + 1) * 2);
-    for (int i = 0; i < (N / 2 + 1); ++i) {
-        complex_out_interleaved[2 * i] = fftw_out_complex[i][0];
-        complex_out_interleaved[2 * i + 1] = fftw_out_complex[i][1];
+bool cpu_fft_inverse(Span<const double> in, Span<double> out, int N_original_time_samples) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing Actual FFTW3 Inverse Transform (C2R).");
+    const int N = N_original_time_samples;
+    if (in.empty() || N <= 0) {
+        VPU_LOG_WARN("Warning: cpu_fft_inverse called with empty input or invalid N_original_time_samples.");
+        return false;
+    }
+    const size_t spectrum_doubles = fft_spectrum_doubles(static_cast<size_t>(N));
+    if (in.size() != spectrum_doubles) {
+        VPU_LOG_ERROR("FFTW3 Error: complex_in_interleaved size mismatch in cpu_fft_inverse. Expected "
+                  << spectrum_doubles << " got " << in.size()
+                  << " for N_original_time_samples=" << N);
+        return false;
+    }
+    if (out.size() < static_cast<size_t>(N)) {
+        VPU_LOG_ERROR("FFTW3 Error: cpu_fft_inverse output holds " << out.size() << " doubles, needs " << N << ".");
+        return false;
+    }
+    // C2R destroys its input; stage the spectrum (in aligned scratch) so the caller's copy is preserved.
+    ScratchScope scratch;
+    double* staged = scratch.acquire_span<double>(spectrum_doubles).data();
+    std::copy(in.begin(), in.end(), staged);
+    fftw_plan plan_c2r = FFTPlanCache::instance().get_c2r_plan(N, as_fftw_complex(staged), out.data());
+    if (!plan_c2r) {
+        VPU_LOG_ERROR("FFTW3 Error: fftw_plan_dft_c2r_1d failed in cpu_fft_inverse.");
+        return false;
     }
-
-    fftw_destroy_plan(plan_r2c);
-    fftw_free(fftw_out_complex);
-    fftw_free(fftw_in_real);
+    fftw_execute_dft_c2r(plan_c2r, as_fftw_complex(staged), out.data());
+    normalize(out.data(), N);
+    return true;
 }
 
-// --- Specialized SAXPY Stubs for JIT ---
-// ... (Specialized SAXPY stubs remain unchanged here, they are already correct from previous steps)
-
-void cpu_fft_inverse(const std::vector<double>& complex_in_interleaved, std::vector<double>& signal_out, int N_original_time_samples) {
-    std::cout << "    -> [HAL KERNEL] Executing Actual FFTW3 Inverse Transform (C2R)." << std::endl;
-
-    if (complex_in_interleaved.empty() || N_original_time_samples <= 0) {
-        signal_out.clear();
-        std::cerr << "Warning: cpu_fft_inverse called with empty input or invalid N_original_time_samples." << std::endl;
-        return;
+bool cpu_fft_forward_inplace(Span<double> buffer, int N) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing Actual FFTW3 Forward Transform (R2C, in place).");
+    if (N <= 0 || buffer.size() < fft_spectrum_doubles(static_cast<size_t>(N))) {
+        VPU_LOG_ERROR("FFTW3 Error: cpu_fft_forward_inplace needs " << (N > 0 ? fft_spectrum_doubles(static_cast<size_t>(N)) : 0)
+                  << " doubles for N=" << N << ", got " << buffer.size() << ".");
+        return false;
     }
-
-    int N = N_original_time_samples;
-    int num_complex_inputs = N / 2 + 1;
-
-    if (complex_in_interleaved.size() != (size_t)num_complex_inputs * 2) {
-        std::cerr << "FFTW3 Error: complex_in_interleaved size mismatch in cpu_fft_inverse. Expected "
-                  << num_complex_inputs * 2 << " got " << complex_in_interleaved.size()
-                  << " for N_original_time_samples=" << N << std::endl;
-        signal_out.clear();
-        return;
+    fftw_plan plan_r2c = FFTPlanCache::instance().get_r2c_plan(N, buffer.data(), as_fftw_complex(buffer.data()));
+    if (!plan_r2c) {
+        VPU_LOG_ERROR("FFTW3 Error: in-place R2C plan failed in cpu_fft_forward_inplace.");
+        return false;
     }
+    fftw_execute_dft_r2c(plan_r2c, buffer.data(), as_fftw_complex(buffer.data()));
+    return true;
+}
 
-    fftw_complex* fftw_in_complex;
-    double* fftw_out_real;
-    fftw_plan plan_c2r;
-
-    fftw_in_complex = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * num_complex_inputs);
-    if (!fftw_in_complex) {
-        std::cerr << "FFTW3 Error: fftw_malloc for input failed in cpu_fft_inverse." << std::endl;
-        signal_out.clear();
-        return;
+bool cpu_fft_inverse_inplace(Span<double> buffer, int N) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing Actual FFTW3 Inverse Transform (C2R, in place).");
+    if (N <= 0 || buffer.size() < fft_spectrum_doubles(static_cast<size_t>(N))) {
+        VPU_LOG_ERROR("FFTW3 Error: cpu_fft_inverse_inplace needs " << (N > 0 ? fft_spectrum_doubles(static_cast<size_t>(N)) : 0)
+                  << " doubles for N=" << N << ", got " << buffer.size() << ".");
+        return false;
     }
-    fftw_out_real = (double*)fftw_malloc(sizeof(double) * N);
-    if (!fftw_out_real) {
-        std::cerr << "FFTW3 Error: fftw_malloc for output failed in cpu_fft_inverse." << std::endl;
-        fftw_free(fftw_in_complex);
-        signal_out.clear();
-        return;
+    fftw_plan plan_c2r = FFTPlanCache::instance().get_c2r_plan(N, as_fftw_complex(buffer.data()), buffer.data());
+    if (!plan_c2r) {
+        VPU_LOG_ERROR("FFTW3 Error: in-place C2R plan failed in cpu_fft_inverse_inplace.");
+        return false;
     }
+    fftw_execute_dft_c2r(plan_c2r, as_fftw_complex(buffer.data()), buffer.data());
+    normalize(buffer.data(), N);
+    return true;
+}
 
-    for (int i = 0; i < num_complex_inputs; ++i) {
-        fftw_in_complex[i][0] = complex_in_interleaved[2 * i];
-        fftw_in_complex[i][1] = complex_in_interleaved[2 * i + 1];
+void cpu_fft_forward(const std::vector<double>& signal_in, std::vector<double>& complex_out_interleaved) {
+    complex_out_interleaved.resize(signal_in.empty() ? 0 : fft_spectrum_doubles(signal_in.size()));
+    if (!cpu_fft_forward(Span<const double>(signal_in), Span<double>(complex_out_interleaved))) {
+        complex_out_interleaved.clear();
     }
+}
 
-    plan_c2r = fftw_plan_dft_c2r_1d(N, fftw_in_complex, fftw_out_real, FFTW_ESTIMATE);
-    if (!plan_c2r) {
-        std::cerr << "FFTW3 Error: fftw_plan_dft_c2r_1d failed in cpu_fft_inverse." << std::endl;
-        fftw_free(fftw_out_real);
-        fftw_free(fftw_in_complex);
+void cpu_fft_inverse(const std::vector<double>& complex_in_interleaved, std::vector<double>& signal_out, int N_original_time_samples) {
+    signal_out.resize(N_original_time_samples > 0 ? static_cast<size_t>(N_original_time_samples) : 0);
+    if (!cpu_fft_inverse(Span<const double>(complex_in_interleaved), Span<double>(signal_out), N_original_time_samples)) {
         signal_out.clear();
-        return;
     }
+}
 
-    fftw_execute(plan_c2r);
-
-    signal_out.resize(N);
-    for (int i = 0; i < N; ++i) {
-        signal_out[i] = fftw_out_real[i] / N; // Normalization
+// --- Specialized SAXPY Stubs for JIT ---
+void cpu_saxpy_sparse_specialized(float a, Span<const float> x, Span<float> y) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing SPARSE-specialized SAXPY.");
+    // Only non-zero elements of x contribute to y, so skip the rest.
+    const size_t n = std::min(x.size(), y.size());
+    for (size_t i = 0; i < n; ++i) {
+        if (x[i] != 0.0f) {
+            y[i] = a * x[i] + y[i];
+        }
     }
+}
 
-    fftw_destroy_plan(plan_c2r);
-    fftw_free(fftw_out_real);
-    fftw_free(fftw_in_complex);
+void cpu_saxpy_dense_specialized(float a, Span<const float> x, Span<float> y) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing DENSE-specialized SAXPY.");
+    // Branch-free dense data is the best case for the vector units.
+    cpu_saxpy_best(a, x, y);
 }
 
 
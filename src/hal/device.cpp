@@ -0,0 +1,118 @@
+#include "hal/device.h"
+#include "vpu.h" // For VPU_Task
+#include <algorithm> // For std::max
+#include <atomic>
+#include <stdexcept>
+
+namespace VPU {
+namespace HAL {
+
+std::string device_cost_name(const std::string& op, const std::string& substrate) {
+    return op + "@" + substrate;
+}
+
+std::string device_transfer_name(const std::string& substrate) {
+    return "TRANSFER@" + substrate;
+}
+
+PayloadKind payload_kind(OpId op) {
+    if (op == INVALID_OP_ID) return PayloadKind::NONE;
+    const std::string& name = OperationRegistry::instance().name(op);
+    if (name.compare(0, 5, "GEMM_") == 0) return PayloadKind::GEMM;
+    if (name.compare(0, 6, "SAXPY_") == 0) return PayloadKind::SAXPY;
+    if (name == "FFT_FORWARD") return PayloadKind::FFT_FORWARD;
+    if (name == "FFT_INVERSE") return PayloadKind::FFT_INVERSE;
+    return PayloadKind::NONE;
+}
+
+bool describe_payload(OpId op, const VPU_Task& task, DevicePayload& payload) {
+    payload = DevicePayload{};
+    switch (payload_kind(op)) {
+        case PayloadKind::GEMM: {
+            auto dim = [&task](const char* key) {
+                auto it = task.extended_params.find(key);
+                return it != task.extended_params.end() ? it->second : 0;
+            };
+            const size_t M = static_cast<size_t>(std::max(dim("M"), 0));
+            const size_t N = static_cast<size_t>(std::max(dim("N"), 0));
+            const size_t K = static_cast<size_t>(std::max(dim("K"), 0));
+            if (!task.data_in_a || !task.data_in_b || !task.data_out || M == 0 || N == 0 || K == 0) return false;
+            payload.in_a_bytes = M * K * sizeof(float);
+            payload.in_b_bytes = K * N * sizeof(float);
+            payload.out_bytes = M * N * sizeof(float);
+            return true;
+        }
+        case PayloadKind::SAXPY:
+            if (!task.data_in_a || !task.data_out || task.num_elements == 0) return false;
+            payload.in_a_bytes = task.num_elements * sizeof(float);
+            payload.out_bytes = task.num_elements * sizeof(float);
+            payload.out_is_input = true;
+            return true;
+        case PayloadKind::FFT_FORWARD:
+        case PayloadKind::FFT_INVERSE: {
+            // Overlap-save stages (a CONVOLUTION with filter taps) stay on the host.
+            if (!task.data_in_a || !task.data_out || task.num_elements == 0 || !task.conv_filter.empty()) return false;
+            const size_t samples = task.num_elements * sizeof(double);
+            const size_t spectrum = fft_spectrum_doubles(task.num_elements) * sizeof(double);
+            const bool forward = payload_kind(op) == PayloadKind::FFT_FORWARD;
+            payload.in_a_bytes = forward ? samples : spectrum;
+            payload.out_bytes = forward ? spectrum : samples;
+            return true;
+        }
+        case PayloadKind::NONE:
+            break;
+    }
+    return false;
+}
+
+// --- CpuDevice ---
+CpuDevice::CpuDevice(std::shared_ptr<KernelLibrary> kernels) : Device("CPU_generic", DeviceKind::CPU), kernels_(std::move(kernels)) {}
+
+bool CpuDevice::run(OpId op, VPU_Task& task, KernelFluxReport& report) {
+    const GenericKernel* kernel = kernels_->find(op);
+    if (!kernel) return false;
+    report = (*kernel)(task);
+    return true;
+}
+
+// --- DeviceTable ---
+DeviceTable::DeviceTable(std::shared_ptr<KernelLibrary> host_kernels) {
+    Entry host;
+    host.id = HOST_DEVICE;
+    host.device = std::make_shared<CpuDevice>(std::move(host_kernels));
+    current_ = std::make_shared<const std::vector<Entry>>(1, std::move(host));
+}
+
+DeviceId DeviceTable::add(std::shared_ptr<Device> device, const std::vector<OpId>& ops) {
+    if (!device) {
+        throw std::runtime_error("DeviceTable: cannot add a null device.");
+    }
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    Snapshot previous = snapshot();
+    for (const Entry& entry : *previous) {
+        if (entry.device->substrate() == device->substrate()) {
+            throw std::runtime_error("DeviceTable: a device for substrate '" + device->substrate() + "' is already registered.");
+        }
+    }
+    Entry entry;
+    entry.id = static_cast<DeviceId>(previous->size());
+    entry.transfer_id = intern_op(device_transfer_name(device->substrate()));
+    for (OpId op : ops) {
+        if (op == INVALID_OP_ID || !device->supports(op)) continue;
+        if (entry.cost_ids.size() <= op) entry.cost_ids.resize(op + 1, INVALID_OP_ID);
+        entry.cost_ids[op] = intern_op(device_cost_name(OperationRegistry::instance().name(op), device->substrate()));
+    }
+    entry.device = std::move(device);
+
+    auto next = std::make_shared<std::vector<Entry>>(*previous);
+    next->push_back(std::move(entry));
+    std::atomic_store(&current_, Snapshot(std::move(next)));
+    return static_cast<DeviceId>(previous->size());
+}
+
+DeviceTable::Snapshot DeviceTable::snapshot() const {
+    return std::atomic_load(&current_);
+}
+
+} // namespace HAL
+} // namespace VPU
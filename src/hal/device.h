@@ -0,0 +1,113 @@
+#pragma once
+
+#include "hal/hal.h"         // For KernelFluxReport, KernelLibrary
+#include "hal/op_registry.h" // For OpId
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace VPU {
+struct VPU_Task; // Defined in vpu.h
+namespace HAL {
+
+// Compute substrates. The host CPU is always device 0; accelerators and remote VPUs are
+// added at runtime. Pillar 3 proposes plans targeted at any available device, priced from
+// that device's own beliefs plus the cost of moving the task's buffers there and back.
+enum class DeviceKind { CPU, CUDA, REMOTE, OTHER };
+using DeviceId = uint16_t;
+const DeviceId HOST_DEVICE = 0;
+
+// Belief keys are per (operation, substrate): a device's cost for 'op' is "<op>@<substrate>";
+// the host's is the bare operation name. Transfers are priced per MiB moved to and from the device.
+std::string device_cost_name(const std::string& op, const std::string& substrate);
+std::string device_transfer_name(const std::string& substrate); // "TRANSFER@<substrate>"
+
+// Host buffers one operation reads and writes, for the offloadable kernel families: dense GEMM
+// (A, B -> C from M, N, K), SAXPY (x, y -> y) and the unfiltered FFT_FORWARD/FFT_INVERSE.
+struct DevicePayload {
+    size_t in_a_bytes = 0;
+    size_t in_b_bytes = 0;
+    size_t out_bytes = 0;
+    bool out_is_input = false; // data_out is read as well as written (SAXPY's y)
+    size_t bytes_moved() const { return in_a_bytes + in_b_bytes + out_bytes * (out_is_input ? 2 : 1); }
+};
+enum class PayloadKind { NONE, GEMM, SAXPY, FFT_FORWARD, FFT_INVERSE };
+PayloadKind payload_kind(OpId op);
+// False if 'op' is not offloadable or the task lacks what it needs (pointers, dimensions).
+bool describe_payload(OpId op, const VPU_Task& task, DevicePayload& payload);
+
+// A compute substrate. Devices take host buffers and do their own staging: run() uploads the
+// operands, executes, and downloads the result into task.data_out before returning.
+class Device {
+public:
+    Device(std::string substrate, DeviceKind kind) : substrate_(std::move(substrate)), kind_(kind) {}
+    virtual ~Device() = default;
+
+    const std::string& substrate() const { return substrate_; } // e.g. "CPU_generic", "GPU_generic"
+    DeviceKind kind() const { return kind_; }
+
+    virtual bool available() const = 0;
+    virtual bool supports(OpId op) const = 0;
+    // Fills 'report' (transfers included in cycle_cost) and returns true on success. On false
+    // the task's output is unspecified and the caller runs the step on the host instead.
+    virtual bool run(OpId op, VPU_Task& task, KernelFluxReport& report) = 0;
+
+    // Priors seeded into the beliefs when the device is added; Pillar 5 refines them.
+    virtual double cost_prior_scale(OpId /*op*/) const { return 1.0; } // Relative to the host's cost
+    virtual double transfer_cost_per_mib() const { return 0.0; }
+
+private:
+    std::string substrate_;
+    DeviceKind kind_;
+};
+
+// The host: runs the registered CPU kernels in place, with nothing to transfer.
+class CpuDevice : public Device {
+public:
+    explicit CpuDevice(std::shared_ptr<KernelLibrary> kernels);
+    bool available() const override { return true; }
+    bool supports(OpId op) const override { return kernels_->find(op) != nullptr; }
+    bool run(OpId op, VPU_Task& task, KernelFluxReport& report) override;
+
+private:
+    std::shared_ptr<KernelLibrary> kernels_;
+};
+
+// Remote VPU service over HTTP: POST /v1/kernels/<op>?<dimensions> with the input buffers
+// concatenated as the body; the response body is the output buffer.
+std::shared_ptr<Device> make_remote_device(const std::string& substrate, const std::string& host, int port);
+#if defined(VPU_HAL_WITH_CUDA)
+// cuBLAS/cuFFT backend on GPU 'ordinal'; nullptr if there is no such GPU.
+std::shared_ptr<Device> make_cuda_device(int ordinal);
+#endif
+
+// The devices known to one VPU, published read-copy-update like HardwareProfileStore so
+// planners read a consistent set without locking while devices are being added.
+class DeviceTable {
+public:
+    struct Entry {
+        DeviceId id = HOST_DEVICE;
+        std::shared_ptr<Device> device;
+        std::vector<OpId> cost_ids; // Indexed by OpId: the "<op>@<substrate>" key, INVALID_OP_ID if unsupported
+        OpId transfer_id = INVALID_OP_ID;
+
+        OpId cost_id(OpId op) const { return op < cost_ids.size() ? cost_ids[op] : INVALID_OP_ID; }
+    };
+    using Snapshot = std::shared_ptr<const std::vector<Entry>>;
+
+    explicit DeviceTable(std::shared_ptr<KernelLibrary> host_kernels); // Registers the host as device 0
+
+    // Registers 'device' for the given operations (those it supports get cost keys) and returns its ID.
+    DeviceId add(std::shared_ptr<Device> device, const std::vector<OpId>& ops);
+    Snapshot snapshot() const;
+
+private:
+    Snapshot current_; // Accessed only through std::atomic_load/std::atomic_store
+    std::mutex writer_mutex_;
+};
+
+} // namespace HAL
+} // namespace VPU
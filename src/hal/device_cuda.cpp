@@ -0,0 +1,146 @@
+#include "hal/device.h"
+
+#if defined(VPU_HAL_WITH_CUDA)
+#include "hal/hal_utils.h" // For calculate_data_hamming_weight
+#include "vpu.h"           // For VPU_Task
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <cublas_v2.h>
+#include <cuda_runtime.h>
+#include <cufft.h>
+#include <algorithm> // For std::max
+#include <cmath>     // For std::log2
+#include <map>
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+
+// Device memory for one run; freed when the run ends.
+class CudaBuffer {
+public:
+    explicit CudaBuffer(size_t bytes) {
+        if (bytes > 0 && cudaMalloc(&data_, bytes) != cudaSuccess) data_ = nullptr;
+    }
+    ~CudaBuffer() {
+        if (data_) cudaFree(data_);
+    }
+    CudaBuffer(const CudaBuffer&) = delete;
+    CudaBuffer& operator=(const CudaBuffer&) = delete;
+    void* get() const { return data_; }
+
+private:
+    void* data_ = nullptr;
+};
+
+// cuBLAS (GEMM, SAXPY) and cuFFT (double R2C/C2R) on one GPU. Runs are serialized: the
+// cuBLAS handle and the cached cuFFT plans are bound to the device's default stream.
+class CudaDevice : public Device {
+public:
+    CudaDevice(int ordinal, const std::string& substrate) : Device(substrate, DeviceKind::CUDA), ordinal_(ordinal) {
+        if (cudaSetDevice(ordinal_) == cudaSuccess && cublasCreate(&blas_) != CUBLAS_STATUS_SUCCESS) {
+            blas_ = nullptr;
+        }
+    }
+    ~CudaDevice() override {
+        cudaSetDevice(ordinal_);
+        for (auto& plan : fft_plans_) cufftDestroy(plan.second);
+        if (blas_) cublasDestroy(blas_);
+    }
+
+    bool available() const override { return blas_ != nullptr; }
+    bool supports(OpId op) const override { return payload_kind(op) != PayloadKind::NONE; }
+
+    bool run(OpId op, VPU_Task& task, KernelFluxReport& report) override {
+        DevicePayload payload;
+        if (!available() || !describe_payload(op, task, payload)) return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cudaSetDevice(ordinal_) != cudaSuccess) return false;
+
+        CudaBuffer a(payload.in_a_bytes), b(payload.in_b_bytes), out(payload.out_bytes);
+        if (!a.get() || (payload.in_b_bytes && !b.get()) || !out.get()) {
+            VPU_LOG_WARN("    -> [HAL DEVICE] " << substrate() << ": out of device memory.");
+            return false;
+        }
+        bool ok = cudaMemcpy(a.get(), task.data_in_a, payload.in_a_bytes, cudaMemcpyHostToDevice) == cudaSuccess;
+        if (ok && payload.in_b_bytes) ok = cudaMemcpy(b.get(), task.data_in_b, payload.in_b_bytes, cudaMemcpyHostToDevice) == cudaSuccess;
+        if (ok && payload.out_is_input) ok = cudaMemcpy(out.get(), task.data_out, payload.out_bytes, cudaMemcpyHostToDevice) == cudaSuccess;
+        report.hw_in_cost = calculate_data_hamming_weight(task.data_in_a, payload.in_a_bytes);
+        if (payload.in_b_bytes) report.hw_in_cost += calculate_data_hamming_weight(task.data_in_b, payload.in_b_bytes);
+
+        uint64_t work = 0; // Multiply-adds (GEMM, SAXPY) or butterfly passes (FFT)
+        const PayloadKind kind = payload_kind(op);
+        if (ok && kind == PayloadKind::GEMM) {
+            const int M = task.extended_params.at("M"), N = task.extended_params.at("N"), K = task.extended_params.at("K");
+            const float one = 1.0f, zero = 0.0f;
+            // Row-major C = A * B is column-major C^T = B^T * A^T: swap the operands, no transposes.
+            ok = cublasSgemm(blas_, CUBLAS_OP_N, CUBLAS_OP_N, N, M, K, &one, static_cast<const float*>(b.get()), N,
+                             static_cast<const float*>(a.get()), K, &zero, static_cast<float*>(out.get()), N) == CUBLAS_STATUS_SUCCESS;
+            work = static_cast<uint64_t>(M) * N * K;
+        } else if (ok && kind == PayloadKind::SAXPY) {
+            const int n = static_cast<int>(task.num_elements);
+            ok = cublasSaxpy(blas_, n, &task.alpha, static_cast<const float*>(a.get()), 1, static_cast<float*>(out.get()), 1) == CUBLAS_STATUS_SUCCESS;
+            work = task.num_elements;
+        } else if (ok) {
+            const bool forward = kind == PayloadKind::FFT_FORWARD;
+            const int n = static_cast<int>(task.num_elements);
+            cufftHandle plan;
+            ok = fft_plan(n, forward ? CUFFT_D2Z : CUFFT_Z2D, plan) && (forward ? cufftExecD2Z(plan, static_cast<cufftDoubleReal*>(a.get()), static_cast<cufftDoubleComplex*>(out.get()))
+                                       : cufftExecZ2D(plan, static_cast<cufftDoubleComplex*>(a.get()), static_cast<cufftDoubleReal*>(out.get()))) == CUFFT_SUCCESS;
+            work = static_cast<uint64_t>(task.num_elements * std::log2(std::max<size_t>(task.num_elements, 2)));
+        }
+        ok = ok && cudaMemcpy(task.data_out, out.get(), payload.out_bytes, cudaMemcpyDeviceToHost) == cudaSuccess;
+        if (!ok) {
+            VPU_LOG_WARN("    -> [HAL DEVICE] " << substrate() << " failed to run " << OperationRegistry::instance().name(op) << ".");
+            return false;
+        }
+        if (kind == PayloadKind::FFT_INVERSE) { // cuFFT is unnormalized; match cpu_fft_inverse
+            double* samples = static_cast<double*>(task.data_out);
+            const double scale = 1.0 / static_cast<double>(task.num_elements);
+            for (size_t i = 0; i < task.num_elements; ++i) samples[i] *= scale;
+        }
+        report.hw_out_cost = calculate_data_hamming_weight(task.data_out, payload.out_bytes);
+        // PCIe moves ~16 bytes per host cycle; the GPU retires ~1024 multiply-adds per cycle.
+        report.cycle_cost = payload.bytes_moved() / 16 + (work + 1023) / 1024 * 2;
+        return true;
+    }
+
+    double cost_prior_scale(OpId op) const override { return payload_kind(op) == PayloadKind::GEMM ? 0.2 : 0.5; }
+    double transfer_cost_per_mib() const override { return 40.0; }
+
+private:
+    // Requires mutex_ held.
+    bool fft_plan(int n, cufftType type, cufftHandle& plan) {
+        const int key = type == CUFFT_D2Z ? n : -n;
+        auto it = fft_plans_.find(key);
+        if (it != fft_plans_.end()) {
+            plan = it->second;
+            return true;
+        }
+        if (cufftPlan1d(&plan, n, type, 1) != CUFFT_SUCCESS) return false;
+        fft_plans_[key] = plan;
+        return true;
+    }
+
+    int ordinal_;
+    cublasHandle_t blas_ = nullptr;
+    std::map<int, cufftHandle> fft_plans_; // +n: forward, -n: inverse
+    std::mutex mutex_;
+};
+
+} // namespace
+
+std::shared_ptr<Device> make_cuda_device(int ordinal) {
+    int count = 0;
+    if (cudaGetDeviceCount(&count) != cudaSuccess || ordinal < 0 || ordinal >= count) {
+        return nullptr;
+    }
+    const std::string substrate = ordinal == 0 ? "GPU_generic" : "GPU_generic_" + std::to_string(ordinal);
+    auto device = std::make_shared<CudaDevice>(ordinal, substrate);
+    return device->available() ? device : nullptr;
+}
+
+} // namespace HAL
+} // namespace VPU
+
+#endif // VPU_HAL_WITH_CUDA
@@ -0,0 +1,83 @@
+#include "hal/device.h"
+#include "hal/hal_utils.h" // For calculate_data_hamming_weight
+#include "vpu.h"           // For VPU_Task
+#include "httplib.h"       // cpp-httplib
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <atomic>
+#include <cstring> // For std::memcpy
+#include <sstream>
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+
+// Offloads to a VPU service on another machine. The buffers travel in the request and
+// response bodies, so every run pays the full round trip that transfer_cost_per_mib() prices.
+class RemoteDevice : public Device {
+public:
+    RemoteDevice(const std::string& substrate, const std::string& host, int port)
+        : Device(substrate, DeviceKind::REMOTE), client_(host, port), endpoint_(host + ":" + std::to_string(port)) {
+        client_.set_connection_timeout(2);
+        client_.set_read_timeout(30);
+        httplib::Result health = client_.Get("/v1/health");
+        reachable_ = health && health->status == 200;
+        VPU_LOG_INFO("    -> [HAL DEVICE] Remote device '" << this->substrate() << "' at " << endpoint_
+                  << (reachable_ ? " is reachable." : " is not reachable; it will not be planned for."));
+    }
+
+    bool available() const override { return reachable_.load(std::memory_order_relaxed); }
+    bool supports(OpId op) const override { return payload_kind(op) != PayloadKind::NONE; }
+
+    bool run(OpId op, VPU_Task& task, KernelFluxReport& report) override {
+        DevicePayload payload;
+        if (!available() || !describe_payload(op, task, payload)) return false;
+
+        std::ostringstream path;
+        path << "/v1/kernels/" << OperationRegistry::instance().name(op) << "?n=" << task.num_elements << "&alpha=" << task.alpha;
+        for (const auto& param : task.extended_params) {
+            path << "&" << param.first << "=" << param.second;
+        }
+        std::string body;
+        body.reserve(payload.in_a_bytes + payload.in_b_bytes + (payload.out_is_input ? payload.out_bytes : 0));
+        body.append(static_cast<const char*>(task.data_in_a), payload.in_a_bytes);
+        if (payload.in_b_bytes) body.append(static_cast<const char*>(task.data_in_b), payload.in_b_bytes);
+        if (payload.out_is_input) body.append(static_cast<const char*>(task.data_out), payload.out_bytes);
+
+        report.hw_in_cost = calculate_data_hamming_weight(body.data(), body.size());
+        httplib::Result result;
+        {
+            std::lock_guard<std::mutex> lock(client_mutex_); // One request in flight per connection
+            result = client_.Post(path.str(), body, "application/octet-stream");
+        }
+        if (!result || result->status != 200 || result->body.size() != payload.out_bytes) {
+            VPU_LOG_WARN("    -> [HAL DEVICE] Remote device '" << substrate() << "' failed to run "
+                      << OperationRegistry::instance().name(op) << " (" << (result ? "HTTP " + std::to_string(result->status) : "no response")
+                      << "); marking it unavailable.");
+            reachable_ = false;
+            return false;
+        }
+        std::memcpy(task.data_out, result->body.data(), payload.out_bytes);
+        report.hw_out_cost = calculate_data_hamming_weight(task.data_out, payload.out_bytes);
+        report.cycle_cost = payload.bytes_moved(); // The remote's compute is opaque; the wire is what we pay for
+        return true;
+    }
+
+    double cost_prior_scale(OpId /*op*/) const override { return 0.5; }
+    double transfer_cost_per_mib() const override { return 200.0; }
+
+private:
+    httplib::Client client_;
+    std::mutex client_mutex_;
+    std::string endpoint_;
+    std::atomic<bool> reachable_{false};
+};
+
+} // namespace
+
+std::shared_ptr<Device> make_remote_device(const std::string& substrate, const std::string& host, int port) {
+    return std::make_shared<RemoteDevice>(substrate, host, port);
+}
+
+} // namespace HAL
+} // namespace VPU
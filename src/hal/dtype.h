@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cmath>   // For std::nearbyint
+#include <cstdint>
+#include <cstring> // For std::memcpy
+#include <type_traits>
+#include "hal/buffer_stats.h" // For HAL::ElementType
+
+namespace VPU {
+namespace HAL {
+
+// bfloat16: the upper half of an IEEE float32 (8 exponent bits, 7 mantissa bits). Stored as its
+// raw bits; arithmetic goes through float.
+struct bfloat16 {
+    uint16_t bits = 0;
+};
+
+inline float bf16_to_float(bfloat16 value) {
+    const uint32_t bits = static_cast<uint32_t>(value.bits) << 16;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// Rounds to nearest, ties to even; NaNs stay (quiet) NaNs.
+inline bfloat16 float_to_bf16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7F800000u) == 0x7F800000u && (bits & 0x007FFFFFu) != 0) {
+        return bfloat16{static_cast<uint16_t>((bits >> 16) | 0x0040u)};
+    }
+    bits += 0x7FFFu + ((bits >> 16) & 1u);
+    return bfloat16{static_cast<uint16_t>(bits >> 16)};
+}
+
+// float16: IEEE binary16 (5 exponent bits, 10 mantissa bits, largest finite value 65504),
+// stored as its raw bits like bfloat16.
+struct float16 {
+    uint16_t bits = 0;
+};
+
+inline float f16_to_float(float16 value) {
+    const uint32_t sign = static_cast<uint32_t>(value.bits & 0x8000u) << 16;
+    uint32_t exponent = (value.bits >> 10) & 0x1Fu;
+    uint32_t mantissa = value.bits & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0x1Fu) {
+        bits = sign | 0x7F800000u | (mantissa << 13); // Infinity or NaN
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else { // Subnormal: normalize into a float32 exponent
+        exponent = 113;
+        while ((mantissa & 0x400u) == 0) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+    }
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// Rounds to nearest, ties to even; magnitudes that round past 65504 become infinities and NaNs
+// stay (quiet) NaNs.
+inline float16 float_to_f16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u) {
+        return float16{static_cast<uint16_t>(sign | (magnitude > 0x7F800000u ? 0x7E00u : 0x7C00u))};
+    }
+    if (magnitude >= 0x477FF000u) { // 65520 and up round to infinity
+        return float16{static_cast<uint16_t>(sign | 0x7C00u)};
+    }
+    if (magnitude >= 0x38800000u) { // Normal in binary16 (2^-14 and up)
+        const uint32_t rounded = magnitude + 0xFFFu + ((magnitude >> 13) & 1u);
+        return float16{static_cast<uint16_t>(sign | ((rounded - 0x38000000u) >> 13))};
+    }
+    // Subnormal or zero: the value in units of 2^-24, rounded by the FPU (to nearest even).
+    float absolute;
+    std::memcpy(&absolute, &magnitude, sizeof(absolute));
+    return float16{static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(absolute * 16777216.0f)))};
+}
+
+// The C++ type stored for each ElementType, and back.
+template <ElementType Type> struct element_traits;
+template <> struct element_traits<ElementType::BYTES> { using type = uint8_t; };
+template <> struct element_traits<ElementType::FLOAT32> { using type = float; };
+template <> struct element_traits<ElementType::FLOAT64> { using type = double; };
+template <> struct element_traits<ElementType::INT8> { using type = int8_t; };
+template <> struct element_traits<ElementType::BFLOAT16> { using type = bfloat16; };
+template <> struct element_traits<ElementType::FLOAT16> { using type = float16; };
+
+template <typename T> struct element_type_of;
+template <> struct element_type_of<uint8_t> { static constexpr ElementType value = ElementType::BYTES; };
+template <> struct element_type_of<float> { static constexpr ElementType value = ElementType::FLOAT32; };
+template <> struct element_type_of<double> { static constexpr ElementType value = ElementType::FLOAT64; };
+template <> struct element_type_of<int8_t> { static constexpr ElementType value = ElementType::INT8; };
+template <> struct element_type_of<bfloat16> { static constexpr ElementType value = ElementType::BFLOAT16; };
+template <> struct element_type_of<float16> { static constexpr ElementType value = ElementType::FLOAT16; };
+
+// An element's value as a double, for type-generic code (profiling, statistics).
+template <typename T>
+inline double to_double(T value) {
+    static_assert(std::is_arithmetic<T>::value, "to_double needs an arithmetic element type");
+    return static_cast<double>(value);
+}
+inline double to_double(bfloat16 value) { return static_cast<double>(bf16_to_float(value)); }
+inline double to_double(float16 value) { return static_cast<double>(f16_to_float(value)); }
+
+// Calls visitor(T{}) with the C++ element type of 'type', so type-generic code is written once
+// as a template and instantiated for every dtype: visit_element_type(t, [&](auto tag) {
+// using T = decltype(tag); ... }).
+template <typename Visitor>
+inline decltype(auto) visit_element_type(ElementType type, Visitor&& visitor) {
+    switch (type) {
+        case ElementType::FLOAT32: return visitor(float{});
+        case ElementType::FLOAT64: return visitor(double{});
+        case ElementType::INT8: return visitor(int8_t{});
+        case ElementType::BFLOAT16: return visitor(bfloat16{});
+        case ElementType::FLOAT16: return visitor(float16{});
+        case ElementType::BYTES: break;
+    }
+    return visitor(uint8_t{});
+}
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,161 @@
+#include "hal/fft_plan_cache.h"
+#include "hal/hal_utils.h" // For fftw_planner_mutex
+#include "runtime/trace.h" // For VPU_LOG_*
+
+namespace VPU {
+namespace HAL {
+
+FFTPlanCache& FFTPlanCache::instance() {
+    static FFTPlanCache cache;
+    return cache;
+}
+
+FFTPlanCache::FFTPlanCache() {
+    // The destructor takes the planner mutex; constructing it first guarantees it outlives the cache.
+    fftw_planner_mutex();
+}
+
+FFTPlanCache::~FFTPlanCache() {
+    std::lock_guard<std::mutex> planner_lock(fftw_planner_mutex());
+    for (auto& entry : plans_) {
+        fftw_destroy_plan(entry.second);
+    }
+}
+
+fftw_plan FFTPlanCache::get_r2c_plan(int n, double* in, fftw_complex* out) {
+    PlanKey key{n, FFTDirection::REAL_TO_COMPLEX,
+                fftw_alignment_of(in) == 0 && fftw_alignment_of(reinterpret_cast<double*>(out)) == 0,
+                static_cast<void*>(in) == static_cast<void*>(out)};
+    return get_plan(key);
+}
+
+fftw_plan FFTPlanCache::get_c2r_plan(int n, fftw_complex* in, double* out) {
+    PlanKey key{n, FFTDirection::COMPLEX_TO_REAL,
+                fftw_alignment_of(reinterpret_cast<double*>(in)) == 0 && fftw_alignment_of(out) == 0,
+                static_cast<void*>(in) == static_cast<void*>(out)};
+    return get_plan(key);
+}
+
+fftw_plan FFTPlanCache::get_plan(const PlanKey& key) {
+    if (key.n <= 0) {
+        return nullptr;
+    }
+    {
+        std::shared_lock<std::shared_mutex> read_lock(cache_mutex_);
+        auto it = plans_.find(key);
+        if (it != plans_.end()) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+
+    // Lock order: cache_mutex_ before fftw_planner_mutex(). Lookups of other sizes wait
+    // while a MEASURE/PATIENT plan is being timed, but only on the first use of each key.
+    std::unique_lock<std::shared_mutex> write_lock(cache_mutex_);
+    auto it = plans_.find(key);
+    if (it != plans_.end()) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return it->second;
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    fftw_plan plan = nullptr;
+    {
+        std::lock_guard<std::mutex> planner_lock(fftw_planner_mutex());
+        plan = create_plan(key);
+    }
+    if (!plan) {
+        VPU_LOG_ERROR("FFTW3 Error: plan creation failed for N=" << key.n << " in FFTPlanCache.");
+        return nullptr;
+    }
+    plans_.emplace(key, plan);
+    return plan;
+}
+
+unsigned FFTPlanCache::planner_flags(const PlanKey& key) const {
+    unsigned flags = FFTW_ESTIMATE;
+    if (rigor_ == FFTPlanRigor::MEASURE) {
+        flags = FFTW_MEASURE;
+    } else if (rigor_ == FFTPlanRigor::PATIENT) {
+        flags = FFTW_PATIENT;
+    }
+    if (!key.aligned) {
+        flags |= FFTW_UNALIGNED; // Required to execute on arrays without FFTW's SIMD alignment
+    }
+    return flags;
+}
+
+fftw_plan FFTPlanCache::create_plan(const PlanKey& key) const {
+    // Plan on scratch buffers: MEASURE/PATIENT overwrite the arrays while timing.
+    const size_t num_complex = static_cast<size_t>(key.n) / 2 + 1;
+    const size_t real_doubles = key.in_place ? 2 * num_complex : static_cast<size_t>(key.n);
+    double* real_buf = static_cast<double*>(fftw_malloc(sizeof(double) * real_doubles));
+    fftw_complex* complex_buf = key.in_place ? reinterpret_cast<fftw_complex*>(real_buf)
+                                             : static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * num_complex));
+    if (!real_buf || !complex_buf) {
+        if (real_buf) fftw_free(real_buf);
+        if (complex_buf && !key.in_place) fftw_free(complex_buf);
+        return nullptr;
+    }
+
+    const unsigned flags = planner_flags(key);
+    fftw_plan plan = key.direction == FFTDirection::REAL_TO_COMPLEX
+                         ? fftw_plan_dft_r2c_1d(key.n, real_buf, complex_buf, flags)
+                         : fftw_plan_dft_c2r_1d(key.n, complex_buf, real_buf, flags);
+
+    if (!key.in_place) fftw_free(complex_buf);
+    fftw_free(real_buf);
+    return plan;
+}
+
+void FFTPlanCache::configure(FFTPlanRigor rigor, const std::string& wisdom_file) {
+    std::unique_lock<std::shared_mutex> write_lock(cache_mutex_);
+    rigor_ = rigor;
+    wisdom_file_ = wisdom_file;
+    if (!wisdom_file_.empty()) {
+        std::lock_guard<std::mutex> planner_lock(fftw_planner_mutex());
+        if (fftw_import_wisdom_from_filename(wisdom_file_.c_str())) {
+            VPU_LOG_INFO("[HAL] FFTW wisdom imported from '" << wisdom_file_ << "'.");
+        } else {
+            VPU_LOG_INFO("[HAL] No FFTW wisdom loaded from '" << wisdom_file_ << "' (missing or unreadable); starting fresh.");
+        }
+    }
+}
+
+FFTPlanRigor FFTPlanCache::rigor() const {
+    std::shared_lock<std::shared_mutex> read_lock(cache_mutex_);
+    return rigor_;
+}
+
+bool FFTPlanCache::save_wisdom() const {
+    std::shared_lock<std::shared_mutex> read_lock(cache_mutex_);
+    if (wisdom_file_.empty()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> planner_lock(fftw_planner_mutex());
+    if (!fftw_export_wisdom_to_filename(wisdom_file_.c_str())) {
+        VPU_LOG_WARN("[HAL] Failed to export FFTW wisdom to '" << wisdom_file_ << "'.");
+        return false;
+    }
+    VPU_LOG_INFO("[HAL] FFTW wisdom exported to '" << wisdom_file_ << "'.");
+    return true;
+}
+
+size_t FFTPlanCache::size() const {
+    std::shared_lock<std::shared_mutex> read_lock(cache_mutex_);
+    return plans_.size();
+}
+
+size_t FFTPlanCache::hits() const { return hits_.load(std::memory_order_relaxed); }
+size_t FFTPlanCache::misses() const { return misses_.load(std::memory_order_relaxed); }
+
+void FFTPlanCache::clear() {
+    std::unique_lock<std::shared_mutex> write_lock(cache_mutex_);
+    std::lock_guard<std::mutex> planner_lock(fftw_planner_mutex());
+    for (auto& entry : plans_) {
+        fftw_destroy_plan(entry.second);
+    }
+    plans_.clear();
+}
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <fftw3.h>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+
+namespace VPU {
+namespace HAL {
+
+// How much effort FFTW spends searching for a fast plan when a size is first seen.
+enum class FFTPlanRigor {
+    ESTIMATE, // Heuristic plan, no measurements (the historical VPU behaviour)
+    MEASURE,  // Times candidate algorithms; slower first call, faster transforms
+    PATIENT   // Wider search than MEASURE; best with a persistent wisdom file
+};
+
+enum class FFTDirection {
+    REAL_TO_COMPLEX, // Forward: N reals -> N/2+1 complex
+    COMPLEX_TO_REAL  // Inverse: N/2+1 complex -> N reals (unnormalized)
+};
+
+// Process-wide cache of FFTW plans, keyed by (size, direction, alignment, in-place).
+// Plans are always created on cache-owned scratch buffers, so MEASURE/PATIENT planning
+// never clobbers caller data, and executed on caller arrays via FFTW's new-array
+// execute functions (fftw_execute_dft_r2c/c2r), which are thread-safe.
+class FFTPlanCache {
+public:
+    static FFTPlanCache& instance();
+
+    // Returns a plan (owned by the cache) that may be executed on 'in'/'out',
+    // or nullptr if FFTW could not create one. The arrays are only inspected, never written.
+    fftw_plan get_r2c_plan(int n, double* in, fftw_complex* out);
+    fftw_plan get_c2r_plan(int n, fftw_complex* in, double* out);
+
+    // Sets the planning rigor for plans created from now on. If 'wisdom_file' is not empty,
+    // the wisdom in it is imported immediately and save_wisdom() writes back to it.
+    void configure(FFTPlanRigor rigor, const std::string& wisdom_file = "");
+    FFTPlanRigor rigor() const;
+
+    // Exports accumulated wisdom to the configured file. Returns false if none is configured or on I/O error.
+    bool save_wisdom() const;
+
+    size_t size() const;
+    size_t hits() const;
+    size_t misses() const;
+
+    // Destroys every cached plan. Callers must ensure no plan from this cache is still executing.
+    void clear();
+
+    ~FFTPlanCache();
+
+private:
+    FFTPlanCache();
+    FFTPlanCache(const FFTPlanCache&) = delete;
+    FFTPlanCache& operator=(const FFTPlanCache&) = delete;
+
+    struct PlanKey {
+        int n;
+        FFTDirection direction;
+        bool aligned;  // Both arrays have FFTW's preferred (SIMD) alignment
+        bool in_place;
+        bool operator<(const PlanKey& other) const {
+            return std::tie(n, direction, aligned, in_place) <
+                   std::tie(other.n, other.direction, other.aligned, other.in_place);
+        }
+    };
+
+    fftw_plan get_plan(const PlanKey& key);
+    fftw_plan create_plan(const PlanKey& key) const; // Requires fftw_planner_mutex() held
+    unsigned planner_flags(const PlanKey& key) const;
+
+    mutable std::shared_mutex cache_mutex_;
+    std::map<PlanKey, fftw_plan> plans_; // Guarded by cache_mutex_
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+
+    FFTPlanRigor rigor_ = FFTPlanRigor::ESTIMATE; // Guarded by cache_mutex_
+    std::string wisdom_file_;                     // Guarded by cache_mutex_
+};
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,235 @@
+#include "hal/hal.h"
+#include "hal/cpu_features.h"
+#include "hal/simd_target.h"
+#include "hal/parallel.h"
+#include <algorithm> // For std::min, std::fill
+#include "hal/scratch_arena.h" // For the packing buffers
+#include "runtime/trace.h" // For VPU_LOG_*
+
+// Cache-blocked GEMM in the style of GotoBLAS/BLIS:
+//   for each NC-wide column block of B and C          (MT: MC x NC tiles are the unit of parallel work)
+//     for each KC-deep slice of K                       -> pack B[KC x NC] into NR-wide panels (L2/L3)
+//       for each MC-tall row block of A and C           -> pack A[MC x KC] into MR-tall panels (L2)
+//         MR x NR micro-kernel over the packed panels   -> accumulators stay in registers
+// Packing makes every micro-kernel load unit-stride and aligned, regardless of M, N, K.
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+
+constexpr int MR = 6;    // Micro-tile rows (6 x 16 floats = 12 AVX2 or 6 AVX-512 accumulators)
+constexpr int NR = 16;   // Micro-tile columns
+constexpr int KC = 256;  // Depth of a packed slice: an MR x KC sliver of A stays in L1
+constexpr int MC = 96;   // Rows per packed A block (multiple of MR): MC x KC floats ~ 96 KiB, L2-resident
+constexpr int NC = 512;  // Columns per tile (multiple of NR): KC x NC floats ~ 512 KiB
+
+int round_up(int value, int multiple) { return ((value + multiple - 1) / multiple) * multiple; }
+
+// Packs an mc x kc block of row-major A (leading dimension lda) into MR-row slivers:
+// sliver s holds, for each k, the MR values A[s*MR + 0..MR-1][k]. Rows past mc are zero.
+void pack_a(const float* A, int lda, int mc, int kc, float* dst) {
+    for (int i0 = 0; i0 < mc; i0 += MR) {
+        const int mr = std::min(MR, mc - i0);
+        for (int k = 0; k < kc; ++k) {
+            for (int r = 0; r < MR; ++r) {
+                *dst++ = (r < mr) ? A[static_cast<size_t>(i0 + r) * lda + k] : 0.0f;
+            }
+        }
+    }
+}
+
+// Packs a kc x nc block of row-major B (leading dimension ldb) into NR-column slivers:
+// sliver s holds, for each k, the NR values B[k][s*NR + 0..NR-1]. Columns past nc are zero.
+void pack_b(const float* B, int ldb, int kc, int nc, float* dst) {
+    for (int j0 = 0; j0 < nc; j0 += NR) {
+        const int nr = std::min(NR, nc - j0);
+        for (int k = 0; k < kc; ++k) {
+            const float* row = B + static_cast<size_t>(k) * ldb + j0;
+            if (nr == NR) {
+                std::copy(row, row + NR, dst);
+            } else {
+                std::copy(row, row + nr, dst);
+                std::fill(dst + nr, dst + NR, 0.0f);
+            }
+            dst += NR;
+        }
+    }
+}
+
+// C[mr x nr] += (packed A sliver) * (packed B sliver). 'c' has leading dimension ldc.
+using MicroKernel = void (*)(int kc, const float* a, const float* b, float* c, int ldc, int mr, int nr);
+
+void micro_kernel_generic(int kc, const float* a, const float* b, float* c, int ldc, int mr, int nr) {
+    // Fixed-size accumulator tile: the compiler keeps it in registers and vectorizes the NR loop.
+    float acc[MR][NR] = {};
+    for (int p = 0; p < kc; ++p) {
+        for (int r = 0; r < MR; ++r) {
+            const float a_r = a[r];
+            for (int col = 0; col < NR; ++col) {
+                acc[r][col] += a_r * b[col];
+            }
+        }
+        a += MR;
+        b += NR;
+    }
+    for (int r = 0; r < mr; ++r) {
+        for (int col = 0; col < nr; ++col) {
+            c[static_cast<size_t>(r) * ldc + col] += acc[r][col];
+        }
+    }
+}
+
+#if defined(VPU_HAL_HAS_X86_SIMD)
+VPU_HAL_TARGET("avx2,fma")
+void micro_kernel_avx2(int kc, const float* a, const float* b, float* c, int ldc, int mr, int nr) {
+    __m256 acc_lo[MR], acc_hi[MR];
+    for (int r = 0; r < MR; ++r) {
+        acc_lo[r] = _mm256_setzero_ps();
+        acc_hi[r] = _mm256_setzero_ps();
+    }
+    for (int p = 0; p < kc; ++p) {
+        const __m256 b_lo = _mm256_load_ps(b);
+        const __m256 b_hi = _mm256_load_ps(b + 8);
+        for (int r = 0; r < MR; ++r) {
+            const __m256 a_r = _mm256_broadcast_ss(a + r);
+            acc_lo[r] = _mm256_fmadd_ps(a_r, b_lo, acc_lo[r]);
+            acc_hi[r] = _mm256_fmadd_ps(a_r, b_hi, acc_hi[r]);
+        }
+        a += MR;
+        b += NR;
+    }
+    if (nr == NR) {
+        for (int r = 0; r < mr; ++r) {
+            float* c_row = c + static_cast<size_t>(r) * ldc;
+            _mm256_storeu_ps(c_row, _mm256_add_ps(_mm256_loadu_ps(c_row), acc_lo[r]));
+            _mm256_storeu_ps(c_row + 8, _mm256_add_ps(_mm256_loadu_ps(c_row + 8), acc_hi[r]));
+        }
+        return;
+    }
+    // Edge tile: spill the accumulators and add only the valid columns.
+    alignas(32) float tile[NR];
+    for (int r = 0; r < mr; ++r) {
+        _mm256_store_ps(tile, acc_lo[r]);
+        _mm256_store_ps(tile + 8, acc_hi[r]);
+        float* c_row = c + static_cast<size_t>(r) * ldc;
+        for (int col = 0; col < nr; ++col) c_row[col] += tile[col];
+    }
+}
+
+VPU_HAL_TARGET("avx512f")
+void micro_kernel_avx512(int kc, const float* a, const float* b, float* c, int ldc, int mr, int nr) {
+    __m512 acc[MR];
+    for (int r = 0; r < MR; ++r) acc[r] = _mm512_setzero_ps();
+    for (int p = 0; p < kc; ++p) {
+        const __m512 b_row = _mm512_load_ps(b);
+        for (int r = 0; r < MR; ++r) {
+            acc[r] = _mm512_fmadd_ps(_mm512_set1_ps(a[r]), b_row, acc[r]);
+        }
+        a += MR;
+        b += NR;
+    }
+    const __mmask16 mask = static_cast<__mmask16>((1u << nr) - 1); // nr <= 16
+    for (int r = 0; r < mr; ++r) {
+        float* c_row = c + static_cast<size_t>(r) * ldc;
+        _mm512_mask_storeu_ps(c_row, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, c_row), acc[r]));
+    }
+}
+#endif
+
+MicroKernel select_micro_kernel() {
+#if defined(VPU_HAL_HAS_X86_SIMD)
+    if (cpu_supports(SimdIsa::AVX512)) return &micro_kernel_avx512;
+    if (cpu_supports(SimdIsa::AVX2)) return &micro_kernel_avx2;
+#endif
+    return &micro_kernel_generic;
+}
+
+MicroKernel micro_kernel() {
+    static const MicroKernel kernel = select_micro_kernel();
+    return kernel;
+}
+
+// Computes the tile of C with rows [ir, ir + m) and columns [jc, jc + nc).
+// Tiles write disjoint parts of C, so they can run concurrently.
+void compute_tile(const float* A, const float* B, float* C, int N, int K, int ir, int m, int jc, int nc) {
+    // Cache-line aligned packing buffers from this thread's arena, recycled tile after tile.
+    ScratchScope scratch;
+    float* pa = scratch.acquire_span<float>(static_cast<size_t>(round_up(MC, MR)) * KC).data();
+    float* pb = scratch.acquire_span<float>(static_cast<size_t>(KC) * round_up(NC, NR)).data();
+    const MicroKernel kernel = micro_kernel();
+
+    for (int i = ir; i < ir + m; ++i) {
+        float* c_row = C + static_cast<size_t>(i) * N + jc;
+        std::fill(c_row, c_row + nc, 0.0f);
+    }
+    for (int pc = 0; pc < K; pc += KC) {
+        const int kc = std::min(KC, K - pc);
+        pack_b(B + static_cast<size_t>(pc) * N + jc, N, kc, nc, pb);
+        for (int ic = ir; ic < ir + m; ic += MC) {
+            const int mc = std::min(MC, ir + m - ic);
+            pack_a(A + static_cast<size_t>(ic) * K + pc, K, mc, kc, pa);
+            // Macro-kernel: sweep the packed block with MR x NR micro-tiles.
+            for (int j0 = 0; j0 < nc; j0 += NR) {
+                const int nr = std::min(NR, nc - j0);
+                for (int i0 = 0; i0 < mc; i0 += MR) {
+                    const int mr = std::min(MR, mc - i0);
+                    kernel(kc, pa + static_cast<size_t>(i0) * kc, pb + static_cast<size_t>(j0) * kc,
+                           C + static_cast<size_t>(ic + i0) * N + jc + j0, N, mr, nr);
+                }
+            }
+        }
+    }
+}
+
+bool check_gemm_args(const char* name, Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    if (M < 0 || N < 0 || K < 0 ||
+        A.size() < static_cast<size_t>(M) * K || B.size() < static_cast<size_t>(K) * N || C.size() < static_cast<size_t>(M) * N) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] " << name << ": buffers too small for M=" << M << ", N=" << N << ", K=" << K << ".");
+        return false;
+    }
+    return true;
+}
+
+void gemm_blocked(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K, size_t max_helpers) {
+    if (M == 0 || N == 0) return;
+    const int col_tiles = (N + NC - 1) / NC;
+    if (max_helpers == 0) {
+        // Single-threaded: full-height tiles, so each packed B slice is reused by every row block.
+        for (int t = 0; t < col_tiles; ++t) {
+            const int jc = t * NC;
+            compute_tile(A.data(), B.data(), C.data(), N, K, 0, M, jc, std::min(NC, N - jc));
+        }
+        return;
+    }
+    // Multithreaded: MC x NC tiles over M and N. Each tile repacks its B slice, which costs
+    // 1/MC of the tile's arithmetic, in exchange for enough tiles to keep every thread busy.
+    const int row_tiles = (M + MC - 1) / MC;
+    const size_t tiles = static_cast<size_t>(row_tiles) * col_tiles;
+    parallel_for(tiles, max_helpers, [&](size_t t) {
+        const int ir = static_cast<int>(t / col_tiles) * MC;
+        const int jc = static_cast<int>(t % col_tiles) * NC;
+        compute_tile(A.data(), B.data(), C.data(), N, K, ir, std::min(MC, M - ir), jc, std::min(NC, N - jc));
+    });
+}
+
+} // namespace
+
+size_t gemm_blocked_thread_count() {
+    return parallel_helper_count() + 1; // Helpers plus the calling thread
+}
+
+void cpu_gemm_blocked(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing Blocked GEMM (" << MR << "x" << NR << " micro-kernel).");
+    if (!check_gemm_args("GEMM_BLOCKED", A, B, C, M, N, K)) return;
+    gemm_blocked(A, B, C, M, N, K, 0);
+}
+
+void cpu_gemm_blocked_mt(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing Blocked GEMM on " << gemm_blocked_thread_count() << " threads.");
+    if (!check_gemm_args("GEMM_BLOCKED_MT", A, B, C, M, N, K)) return;
+    gemm_blocked(A, B, C, M, N, K, parallel_helper_count());
+}
+
+} // namespace HAL
+} // namespace VPU
@@ -5,23 +5,79 @@
 #include <functional>
 #include <map>
 #include <iostream>
+#include <cstdint>
+#include "hal/op_registry.h"
+#include "hal/span.h"
 
 namespace VPU {
+
+// Forward declaration from api/vpu.h.
+// This is to avoid circular dependency if vpu.h includes hal.h indirectly.
+struct VPU_Task;
+
 namespace HAL {
 
 // A collection of flux-aware, optimized kernels for various operations.
 // In a real system, these would contain SIMD intrinsics or GPU-specific code.
+//
+// Kernels take non-owning Span views and read/write the caller's buffers directly.
+// The std::vector overloads are thin conveniences that forward to the Span versions.
+
+// SAXPY: y = a*x + y, computed in place in 'y'. A core BLAS level-1 operation.
+// Processes min(x.size(), y.size()) elements.
+void cpu_saxpy(float a, Span<const float> x, Span<float> y);
+inline void cpu_saxpy(float a, const std::vector<float>& x, std::vector<float>& y) { cpu_saxpy(a, Span<const float>(x), Span<float>(y)); }
 
-// SAXPY: y = a*x + y. A core BLAS level-1 operation.
-void cpu_saxpy(float a, const std::vector<float>& x, std::vector<float>& y);
+// GEMM: C = A*B (row-major; A is MxK, B is KxN, C is MxN). A core BLAS level-3 operation.
+// C must hold M*N elements and must not alias A or B.
+void cpu_gemm_naive(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K);
+inline void cpu_gemm_naive(const std::vector<float>& A, const std::vector<float>& B, std::vector<float>& C, int M, int N, int K) {
+    cpu_gemm_naive(Span<const float>(A), Span<const float>(B), Span<float>(C), M, N, K);
+}
 
-// GEMM: C = alpha*A*B. A core BLAS level-3 operation.
-void cpu_gemm_naive(const std::vector<float>& A, const std::vector<float>& B, std::vector<float>& C, int M, int N, int K);
+// Scalar SAXPY and naive GEMM for any arithmetic element type; the VPU instantiates them per
+// task dtype (float and double are compiled in). cpu_saxpy and cpu_gemm_naive are the f32 instances.
+template <typename T>
+void cpu_saxpy_scalar(T a, Span<const T> x, Span<T> y);
+template <typename T>
+void cpu_gemm_naive_scalar(Span<const T> A, Span<const T> B, Span<T> C, int M, int N, int K);
 
 // A conceptual kernel that is more efficient for sparse matrices.
-void cpu_gemm_flux_adaptive(const std::vector<float>& A, const std::vector<float>& B, std::vector<float>& C, int M, int N, int K);
+void cpu_gemm_flux_adaptive(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K);
+inline void cpu_gemm_flux_adaptive(const std::vector<float>& A, const std::vector<float>& B, std::vector<float>& C, int M, int N, int K) {
+    cpu_gemm_flux_adaptive(Span<const float>(A), Span<const float>(B), Span<float>(C), M, N, K);
+}
+
+// Cache-blocked GEMM (gemm_blocked.cpp): packed A/B panels in aligned per-thread scratch,
+// L1/L2 tiling, and a register-blocked micro-kernel (AVX-512/AVX2 when supported).
+// Same contract as cpu_gemm_naive; logs and leaves C untouched if a buffer is too small.
+void cpu_gemm_blocked(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K);
+// As cpu_gemm_blocked, with tiles over M and N spread across a HAL thread pool.
+void cpu_gemm_blocked_mt(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K);
+size_t gemm_blocked_thread_count(); // Threads cpu_gemm_blocked_mt uses, including the caller
+inline void cpu_gemm_blocked(const std::vector<float>& A, const std::vector<float>& B, std::vector<float>& C, int M, int N, int K) {
+    cpu_gemm_blocked(Span<const float>(A), Span<const float>(B), Span<float>(C), M, N, K);
+}
+inline void cpu_gemm_blocked_mt(const std::vector<float>& A, const std::vector<float>& B, std::vector<float>& C, int M, int N, int K) {
+    cpu_gemm_blocked_mt(Span<const float>(A), Span<const float>(B), Span<float>(C), M, N, K);
+}
 
-// Placeholder for a high-performance FFT kernel.
+// Number of doubles in an interleaved (re, im) R2C spectrum of N real samples: 2 * (N/2 + 1).
+inline size_t fft_spectrum_doubles(size_t N) { return 2 * (N / 2 + 1); }
+
+// FFT (FFTW3, R2C/C2R). Out-of-place: the transform is written straight into 'out'.
+// Forward: 'out' must hold fft_spectrum_doubles(in.size()) values. Returns false (and logs) on error.
+bool cpu_fft_forward(Span<const double> in, Span<double> out);
+// Inverse (normalized by N): 'in' holds fft_spectrum_doubles(N) values, 'out' holds N. 'in' is preserved.
+bool cpu_fft_inverse(Span<const double> in, Span<double> out, int N_original_time_samples);
+
+// In-place variants. 'buffer' holds fft_spectrum_doubles(N) values: on input (forward) the first N
+// are the real samples; on output (forward) the whole buffer is the interleaved spectrum. The inverse
+// maps the spectrum back to N normalized samples at the front of the buffer.
+bool cpu_fft_forward_inplace(Span<double> buffer, int N);
+bool cpu_fft_inverse_inplace(Span<double> buffer, int N);
+
+// std::vector conveniences (resize 'out' as needed).
 void cpu_fft_forward(const std::vector<double>& in, std::vector<double>& out);
 void cpu_fft_inverse(const std::vector<double>& in, std::vector<double>& out, int N_original_time_samples);
 
@@ -32,20 +88,68 @@ struct KernelFluxReport {
     uint64_t hw_out_cost = 0; // Hamming weight of output data
 };
 
-// Forward declaration from api/vpu.h, assuming it defines VPU_Task
-// This is to avoid circular dependency if vpu.h includes hal.h indirectly.
-// Proper solution might involve a dedicated types header.
-struct VPU_Task;
-
 // The Kernel Library uses std::function to create a generic, extensible HAL.
 // Kernels now return a flux report and take the VPU_Task by reference to access data.
 // JIT-compiled kernels might be different (see Pillar4_Cerebellum) if they fully capture state.
 using GenericKernel = std::function<KernelFluxReport(VPU_Task& task)>;
-using KernelLibrary = std::map<std::string, GenericKernel>;
 
-// Specialized SAXPY versions for JIT demonstration
-void cpu_saxpy_sparse_specialized(float a, const std::vector<float>& x, std::vector<float>& y);
-void cpu_saxpy_dense_specialized(float a, const std::vector<float>& x, std::vector<float>& y);
+// Kernels indexed by interned OpId, so dispatch is an array lookup instead of a string compare.
+// The name-based overloads intern (on registration) or look up the name first.
+class KernelLibrary {
+public:
+    // Registration. Returns the slot for the kernel (empty if newly created).
+    GenericKernel& operator[](const std::string& name) { return (*this)[intern_op(name)]; }
+    GenericKernel& operator[](OpId id);
+
+    size_t count(const std::string& name) const { return count(OperationRegistry::instance().find(name)); }
+    size_t count(OpId id) const { return find(id) ? 1 : 0; }
+
+    // Throws std::out_of_range if no kernel is registered.
+    const GenericKernel& at(const std::string& name) const { return at(OperationRegistry::instance().find(name)); }
+    const GenericKernel& at(OpId id) const;
+
+    // Dispatch fast path: nullptr if no kernel is registered for 'id'.
+    const GenericKernel* find(OpId id) const {
+        return (id < kernels_.size() && kernels_[id]) ? &kernels_[id] : nullptr;
+    }
+
+    size_t size() const; // Number of registered kernels
+
+    // Visits (id, kernel) for every registered kernel, in ID order.
+    template <typename Visitor>
+    void for_each(Visitor&& visitor) const {
+        for (size_t id = 0; id < kernels_.size(); ++id) {
+            if (kernels_[id]) visitor(static_cast<OpId>(id), kernels_[id]);
+        }
+    }
+
+private:
+    std::vector<GenericKernel> kernels_;
+};
+
+// Specialized SAXPY versions for JIT demonstration (in place in 'y', like cpu_saxpy).
+void cpu_saxpy_sparse_specialized(float a, Span<const float> x, Span<float> y);
+void cpu_saxpy_dense_specialized(float a, Span<const float> x, Span<float> y);
+inline void cpu_saxpy_sparse_specialized(float a, const std::vector<float>& x, std::vector<float>& y) {
+    cpu_saxpy_sparse_specialized(a, Span<const float>(x), Span<float>(y));
+}
+inline void cpu_saxpy_dense_specialized(float a, const std::vector<float>& x, std::vector<float>& y) {
+    cpu_saxpy_dense_specialized(a, Span<const float>(x), Span<float>(y));
+}
+
+// --- SIMD variants (simd_kernels.cpp) ---
+// Each ISA is a distinct kernel so the Orchestrator can weigh it as its own candidate and
+// Pillar 5 can learn its real cost. Only call a variant if cpu_supports() reports its ISA
+// (hal/cpu_features.h); variants not compiled into this build fall back to scalar code.
+void cpu_saxpy_avx2(float a, Span<const float> x, Span<float> y);
+void cpu_saxpy_avx512(float a, Span<const float> x, Span<float> y);
+void cpu_saxpy_neon(float a, Span<const float> x, Span<float> y);
+// Dispatches to the widest supported SAXPY variant.
+void cpu_saxpy_best(float a, Span<const float> x, Span<float> y);
+
+void cpu_gemm_avx2(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K);
+void cpu_gemm_avx512(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K);
+void cpu_gemm_neon(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K);
 
 } // namespace HAL
 } // namespace VPU
@@ -1,33 +1,96 @@
 #include "hal_utils.h"
-
-// Required for MSVC __popcnt if not included elsewhere,
-// and for GCC/Clang __builtin_popcount if not implicitly available.
-#if defined(_MSC_VER)
-#include <intrin.h>
-#endif
+#include "hal/cpu_features.h"
+#include "hal/parallel.h"
+#include <algorithm> // For std::min
+#include <atomic>
+#include <cstring> // For std::memcpy
 
 namespace VPU {
 namespace HAL {
 
-uint64_t calculate_data_hamming_weight(const void* data, size_t bytes) {
+namespace {
+using HammingWeightFn = uint64_t (*)(const void*, size_t);
+
+HammingWeightFn select_hamming_weight() {
+    const CpuFeatures& f = cpu_features();
+    if (f.avx512_vpopcntdq) return &hamming_weight_avx512;
+    if (f.avx2_fma) return &hamming_weight_avx2;
+    if (f.popcnt) return &hamming_weight_popcnt;
+    return &hamming_weight_scalar;
+}
+} // namespace
+
+uint64_t hamming_weight_scalar(const void* data, size_t bytes) {
     if (!data || bytes == 0) return 0;
     const uint8_t* byte_data = static_cast<const uint8_t*>(data);
     uint64_t total_hw = 0;
-    for (size_t i = 0; i < bytes; ++i) {
-#if defined(__GNUC__) || defined(__clang__)
-        total_hw += __builtin_popcount(byte_data[i]);
-#elif defined(_MSC_VER)
-        total_hw += __popcnt(static_cast<unsigned int>(byte_data[i])); // __popcnt needs unsigned int for some versions
-#else
-        // Fallback for other compilers
-        unsigned char current_byte = byte_data[i];
-        for (int bit = 0; bit < 8; ++bit) {
-            if ((current_byte >> bit) & 1) total_hw++;
-        }
-#endif
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, byte_data + i, sizeof(word)); // Unaligned-safe load
+        total_hw += popcount_u64(word);
+    }
+    for (; i < bytes; ++i) {
+        total_hw += popcount_u64(byte_data[i]);
     }
     return total_hw;
 }
 
+uint64_t calculate_data_hamming_weight(const void* data, size_t bytes) {
+    static const HammingWeightFn impl = select_hamming_weight();
+    if (!data || bytes < PARALLEL_SCAN_THRESHOLD_BYTES) {
+        return impl(data, bytes);
+    }
+    // Large buffers: popcount is memory-bound, so independent chunks scale with memory channels.
+    const uint8_t* byte_data = static_cast<const uint8_t*>(data);
+    const size_t chunks = (bytes + PARALLEL_SCAN_CHUNK_BYTES - 1) / PARALLEL_SCAN_CHUNK_BYTES;
+    std::atomic<uint64_t> total_hw{0};
+    parallel_for(chunks, parallel_helper_count(), [&](size_t c) {
+        const size_t offset = c * PARALLEL_SCAN_CHUNK_BYTES;
+        const size_t length = std::min(PARALLEL_SCAN_CHUNK_BYTES, bytes - offset);
+        total_hw.fetch_add(impl(byte_data + offset, length), std::memory_order_relaxed);
+    });
+    return total_hw.load();
+}
+
+namespace {
+uint64_t hash_words(uint64_t seed, const uint8_t* p, size_t bytes) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, p + i, sizeof(word));
+        seed = hash_combine(seed, word);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, p + i, bytes - i);
+    return hash_combine(seed, tail);
+}
+} // namespace
+
+uint64_t fingerprint_buffer(const void* data, size_t bytes) {
+    uint64_t h = hash_combine(0, bytes);
+    if (!data || bytes == 0) {
+        return h;
+    }
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    if (bytes <= FINGERPRINT_FULL_HASH_BYTES) {
+        return hash_words(h, p, bytes);
+    }
+    constexpr size_t EDGE_BYTES = 1024;
+    constexpr size_t SAMPLED_WORDS = 256;
+    h = hash_words(h, p, EDGE_BYTES);
+    h = hash_words(h, p + bytes - EDGE_BYTES, EDGE_BYTES);
+    const size_t stride = (bytes - sizeof(uint64_t)) / SAMPLED_WORDS;
+    for (size_t w = 0; w < SAMPLED_WORDS; ++w) {
+        h = hash_words(h, p + w * stride, sizeof(uint64_t));
+    }
+    return h;
+}
+
+std::mutex& fftw_planner_mutex() {
+    static std::mutex planner_mutex;
+    return planner_mutex;
+}
+
 } // namespace HAL
 } // namespace VPU
@@ -2,13 +2,61 @@
 
 #include <cstddef> // For size_t
 #include <cstdint> // For uint64_t, uint8_t
+#include <mutex>   // For std::mutex
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace VPU {
 namespace HAL {
 
+// Population count of one 64-bit word.
+inline uint64_t popcount_u64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint64_t>(__builtin_popcountll(v));
+#else
+    // SWAR fallback for other compilers (needs no POPCNT instruction)
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (v * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
 // Helper to calculate Hamming weight of a raw data buffer
 // Used by kernel wrappers to report hw_in_cost and hw_out_cost
+// Dispatches once to the fastest popcount the CPU supports (see the variants below).
+// Buffers of PARALLEL_SCAN_THRESHOLD_BYTES or more are split into chunks across the HAL pool.
 uint64_t calculate_data_hamming_weight(const void* data, size_t bytes);
 
+constexpr size_t PARALLEL_SCAN_THRESHOLD_BYTES = size_t(8) << 20; // 8 MiB
+constexpr size_t PARALLEL_SCAN_CHUNK_BYTES = size_t(1) << 20;     // 1 MiB per parallel task
+
+// Popcount variants. All return identical results; callers other than the dispatcher must
+// check cpu_features() first (hal/cpu_features.h). Defined in simd_kernels.cpp except the scalar one.
+uint64_t hamming_weight_scalar(const void* data, size_t bytes);  // Portable, 64-bit words
+uint64_t hamming_weight_popcnt(const void* data, size_t bytes);  // x86 POPCNT
+uint64_t hamming_weight_avx2(const void* data, size_t bytes);    // AVX2 nibble lookup
+uint64_t hamming_weight_avx512(const void* data, size_t bytes);  // AVX-512 VPOPCNTDQ
+
+// Cheap content fingerprint for memoization (not a cryptographic hash). Small buffers are
+// hashed in full; larger ones by their size, first and last KiB and 256 evenly spaced words,
+// so edits elsewhere in a large buffer can go unnoticed.
+uint64_t fingerprint_buffer(const void* data, size_t bytes);
+constexpr size_t FINGERPRINT_FULL_HASH_BYTES = 4096;
+
+// Mixes 'value' into the running hash 'seed' (splitmix64 finalizer).
+inline uint64_t hash_combine(uint64_t seed, uint64_t value) {
+    uint64_t z = seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2));
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// FFTW's planner (plan creation/destruction) is not thread-safe; fftw_execute is.
+// Every fftw_plan_* / fftw_destroy_plan call in the VPU must hold this mutex.
+std::mutex& fftw_planner_mutex();
+
 } // namespace HAL
 } // namespace VPU
@@ -0,0 +1,34 @@
+#include "hal/hal.h"
+#include <stdexcept>
+
+namespace VPU {
+namespace HAL {
+
+GenericKernel& KernelLibrary::operator[](OpId id) {
+    if (id == INVALID_OP_ID) {
+        throw std::invalid_argument("KernelLibrary: cannot register a kernel for an invalid operation ID.");
+    }
+    if (id >= kernels_.size()) {
+        kernels_.resize(static_cast<size_t>(id) + 1);
+    }
+    return kernels_[id];
+}
+
+const GenericKernel& KernelLibrary::at(OpId id) const {
+    const GenericKernel* kernel = find(id);
+    if (!kernel) {
+        throw std::out_of_range("KernelLibrary: no kernel registered for operation ID " + std::to_string(id) + ".");
+    }
+    return *kernel;
+}
+
+size_t KernelLibrary::size() const {
+    size_t registered = 0;
+    for (const auto& kernel : kernels_) {
+        if (kernel) ++registered;
+    }
+    return registered;
+}
+
+} // namespace HAL
+} // namespace VPU
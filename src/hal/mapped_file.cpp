@@ -0,0 +1,117 @@
+#include "hal/mapped_file.h"
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <algorithm>  // For std::min
+#include <cerrno>
+#include <cstring>    // For std::strerror
+#include <fcntl.h>    // For open, posix_fadvise
+#include <sys/mman.h> // For mmap, madvise, msync
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For close, ftruncate, sysconf
+
+namespace VPU {
+namespace HAL {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+size_t MappedFile::page_size() {
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+bool MappedFile::open_read(const std::string& path) {
+    return map(path, false, 0);
+}
+
+bool MappedFile::open_write(const std::string& path, uint64_t bytes) {
+    return map(path, true, bytes);
+}
+
+bool MappedFile::map(const std::string& path, bool writable, uint64_t bytes) {
+    close();
+    fd_ = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (fd_ < 0) {
+        VPU_LOG_WARN("    -> [HAL] Cannot open '" << path << "': " << std::strerror(errno) << ".");
+        return false;
+    }
+    if (writable) {
+        if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+            VPU_LOG_WARN("    -> [HAL] Cannot size '" << path << "' to " << bytes << " bytes: " << std::strerror(errno) << ".");
+            close();
+            return false;
+        }
+        size_ = bytes;
+    } else {
+        struct stat info;
+        if (::fstat(fd_, &info) != 0) {
+            VPU_LOG_WARN("    -> [HAL] Cannot stat '" << path << "': " << std::strerror(errno) << ".");
+            close();
+            return false;
+        }
+        size_ = static_cast<uint64_t>(info.st_size);
+    }
+    writable_ = writable;
+    if (size_ == 0) {
+        return true; // Nothing to map; an empty file is a valid, empty stream
+    }
+    void* mapped = ::mmap(nullptr, size_, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        VPU_LOG_WARN("    -> [HAL] Cannot map '" << path << "' (" << size_ << " bytes): " << std::strerror(errno) << ".");
+        close();
+        return false;
+    }
+    data_ = static_cast<uint8_t*>(mapped);
+    // Windows are walked front to back: let the kernel read ahead aggressively and drop behind.
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+    ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+    writable_ = false;
+}
+
+namespace {
+// The pages of a 'size'-byte mapping that [offset, offset + bytes) touches. With 'whole_only'
+// a last page the range only partly fills is left out (unless it ends the mapping): it is the
+// next window's first page, so consecutive windows release every page exactly once.
+bool page_range(uint64_t size, uint64_t offset, uint64_t bytes, bool whole_only, uint64_t& begin, uint64_t& length) {
+    if (offset >= size || bytes == 0) return false;
+    const uint64_t page = MappedFile::page_size();
+    begin = offset / page * page;
+    uint64_t end = std::min(size, offset + bytes);
+    if (whole_only && end < size) end = end / page * page;
+    if (end <= begin) return false;
+    length = end - begin; // madvise and msync round a partial last page up
+    return true;
+}
+} // namespace
+
+void MappedFile::prefetch(uint64_t offset, uint64_t bytes) const {
+    uint64_t begin, length;
+    if (data_ && page_range(size_, offset, bytes, /*whole_only=*/false, begin, length)) {
+        ::madvise(data_ + begin, length, MADV_WILLNEED);
+    }
+}
+
+void MappedFile::release(uint64_t offset, uint64_t bytes) const {
+    uint64_t begin, length;
+    if (!data_ || !page_range(size_, offset, bytes, /*whole_only=*/true, begin, length)) return;
+    if (writable_) {
+        ::msync(data_ + begin, length, MS_ASYNC);
+    }
+    ::madvise(data_ + begin, length, MADV_DONTNEED);
+}
+
+} // namespace HAL
+} // namespace VPU
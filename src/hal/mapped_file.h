@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace VPU {
+namespace HAL {
+
+// A file mapped into the address space and consumed window by window (POSIX mmap). The whole
+// file is mapped once, so windows are plain pointers into it; what stays resident is managed
+// per window: prefetch() starts reading a window ahead of use and release() drops a finished
+// one, so a sequential pass keeps only the windows in flight in memory however large the file.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile(); // Unmaps (flushing a writable mapping's dirty pages to the file) and closes
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps an existing file read-only. Returns false (and logs) if it cannot be opened or mapped.
+    bool open_read(const std::string& path);
+    // Maps 'path' read-write at exactly 'bytes' bytes, creating it (zero-filled) or resizing it.
+    // Existing contents within 'bytes' are kept.
+    bool open_write(const std::string& path, uint64_t bytes);
+    void close();
+
+    bool is_open() const { return fd_ >= 0; }
+    uint64_t size() const { return size_; }
+    const uint8_t* data() const { return data_; }
+    uint8_t* mutable_data() { return writable_ ? data_ : nullptr; }
+
+    // Asks the kernel to start reading the pages of [offset, offset + bytes) in the background
+    // (MADV_WILLNEED).
+    void prefetch(uint64_t offset, uint64_t bytes) const;
+    // Drops the pages of [offset, offset + bytes) from this process's resident set (MADV_DONTNEED),
+    // after starting write-back of a writable window (MS_ASYNC). The data stays in the file and
+    // the page cache, so a later access faults it back in. A last page the window only partly
+    // fills is kept for the next window, which starts in it.
+    void release(uint64_t offset, uint64_t bytes) const;
+
+    static size_t page_size();
+
+private:
+    bool map(const std::string& path, bool writable, uint64_t bytes);
+
+    int fd_ = -1;
+    uint8_t* data_ = nullptr;
+    uint64_t size_ = 0;
+    bool writable_ = false;
+};
+
+} // namespace HAL
+} // namespace VPU
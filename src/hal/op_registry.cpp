@@ -0,0 +1,95 @@
+#include "hal/op_registry.h"
+#include <mutex>
+#include <stdexcept>
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+const char* const HW_SENSITIVITY_SUFFIX = "_lambda_hw_combined";
+
+uint32_t derive_capabilities(const std::string& name) {
+    uint32_t caps = OP_CAP_NONE;
+    if (name.find("NETWORK_") != std::string::npos || name.find("REMOTE_") != std::string::npos) {
+        caps |= OP_CAP_USES_NETWORK;
+    }
+    if (name.find("DISK_") != std::string::npos || name.find("LOAD_") != std::string::npos) {
+        caps |= OP_CAP_USES_HEAVY_IO;
+    }
+    return caps;
+}
+} // namespace
+
+OperationRegistry& OperationRegistry::instance() {
+    static OperationRegistry registry;
+    return registry;
+}
+
+OperationRegistry::OperationRegistry() : entries_(new Entry[MAX_OPERATIONS]) {}
+
+OpId OperationRegistry::intern(const std::string& name) {
+    {
+        std::shared_lock<std::shared_mutex> read_lock(index_mutex_);
+        auto it = index_.find(name);
+        if (it != index_.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> write_lock(index_mutex_);
+    return intern_locked(name);
+}
+
+OpId OperationRegistry::intern_locked(const std::string& name) {
+    auto it = index_.find(name);
+    if (it != index_.end()) {
+        return it->second;
+    }
+    const size_t next = size_.load(std::memory_order_relaxed);
+    if (next >= MAX_OPERATIONS) {
+        throw std::runtime_error("OperationRegistry: capacity exhausted while interning '" + name + "'.");
+    }
+    const OpId id = static_cast<OpId>(next);
+    Entry& entry = entries_[id];
+    entry.name = name;
+    entry.capabilities = derive_capabilities(name);
+    index_.emplace(name, id);
+    // Publish before deriving keys so the derived entry gets the next ID.
+    size_.store(next + 1, std::memory_order_release);
+
+    // Operations get a precomputed Hamming Weight sensitivity key; belief keys do not.
+    if (name.find("lambda_") == std::string::npos) {
+        entry.hw_sensitivity_id = intern_locked(name + HW_SENSITIVITY_SUFFIX);
+    }
+    return id;
+}
+
+OpId OperationRegistry::find(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> read_lock(index_mutex_);
+    auto it = index_.find(name);
+    return it != index_.end() ? it->second : INVALID_OP_ID;
+}
+
+void OperationRegistry::check_id(OpId id) const {
+    if (id >= size()) {
+        throw std::out_of_range("OperationRegistry: unknown operation ID " + std::to_string(id) + ".");
+    }
+}
+
+const std::string& OperationRegistry::name(OpId id) const {
+    check_id(id);
+    return entries_[id].name;
+}
+
+uint32_t OperationRegistry::capabilities(OpId id) const {
+    check_id(id);
+    return entries_[id].capabilities;
+}
+
+OpId OperationRegistry::hw_sensitivity_id(OpId id) const {
+    check_id(id);
+    // Written before the owning entry's ID was handed out by intern(), so this read is ordered.
+    return entries_[id].hw_sensitivity_id;
+}
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace VPU {
+namespace HAL {
+
+// Compact integer ID for an interned operation or belief key (e.g. "SAXPY_STANDARD", "lambda_Sparsity").
+// IDs are dense (0, 1, 2, ...) so per-operation tables can be plain arrays indexed by ID.
+using OpId = uint32_t;
+const OpId INVALID_OP_ID = UINT32_MAX;
+
+// Capability flags, precomputed from the operation name when it is interned.
+enum OpCapability : uint32_t {
+    OP_CAP_NONE = 0,
+    OP_CAP_USES_NETWORK = 1u << 0,  // "NETWORK_*" / "REMOTE_*" operations
+    OP_CAP_USES_HEAVY_IO = 1u << 1, // "DISK_*" / "LOAD_*" operations
+};
+
+// Process-wide symbol table for operation names.
+// Interning takes a lock and happens at registration time (kernel registration, belief
+// initialization, candidate plan templates). Lookups by ID are lock-free array reads.
+class OperationRegistry {
+public:
+    static OperationRegistry& instance();
+
+    // Returns the ID for 'name', registering it on first use.
+    OpId intern(const std::string& name);
+    // Returns the ID for 'name', or INVALID_OP_ID if it was never interned. Never registers.
+    OpId find(const std::string& name) const;
+
+    // The accessors below require a valid ID (one returned by intern()).
+    const std::string& name(OpId id) const;
+    uint32_t capabilities(OpId id) const;
+    bool has_capability(OpId id, OpCapability capability) const { return (capabilities(id) & capability) != 0; }
+    // ID of the "<name>_lambda_hw_combined" sensitivity key, or INVALID_OP_ID for belief keys themselves.
+    OpId hw_sensitivity_id(OpId id) const;
+
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+    static const size_t MAX_OPERATIONS = 4096;
+
+private:
+    OperationRegistry();
+    OpId intern_locked(const std::string& name); // Requires index_mutex_ held exclusively
+    void check_id(OpId id) const;
+
+    struct Entry {
+        std::string name;
+        uint32_t capabilities = OP_CAP_NONE;
+        OpId hw_sensitivity_id = INVALID_OP_ID;
+    };
+
+    // Fixed capacity: entries never move, so readers can index them without locking.
+    std::unique_ptr<Entry[]> entries_;
+    std::atomic<size_t> size_{0};
+
+    mutable std::shared_mutex index_mutex_;
+    std::unordered_map<std::string, OpId> index_; // Guarded by index_mutex_
+};
+
+// Shorthand for OperationRegistry::instance().intern(name).
+inline OpId intern_op(const std::string& name) { return OperationRegistry::instance().intern(name); }
+
+} // namespace HAL
+} // namespace VPU
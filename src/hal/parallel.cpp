@@ -0,0 +1,74 @@
+#include "hal/parallel.h"
+#include "runtime/worker_pool.h"
+#include <algorithm> // For std::min
+#include <atomic>
+#include <condition_variable>
+#include <exception> // For std::exception_ptr
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+Runtime::WorkerPool& hal_pool() {
+    static Runtime::WorkerPool pool([]() -> size_t {
+        const unsigned hw = std::thread::hardware_concurrency();
+        return hw > 1 ? hw - 1 : 1;
+    }(), 256);
+    return pool;
+}
+} // namespace
+
+size_t parallel_helper_count() {
+    return hal_pool().worker_count();
+}
+
+void parallel_for(size_t count, size_t max_helpers, const std::function<void(size_t)>& body) {
+    if (count == 0) return;
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::atomic<bool> failed{false};
+        std::mutex mutex;
+        std::condition_variable all_done;
+        std::exception_ptr error; // First exception from 'body'; guarded by mutex
+    };
+    auto state = std::make_shared<State>();
+    const std::function<void(size_t)>* body_ptr = &body;
+    // A helper that starts after all indices are claimed exits without touching 'body',
+    // which is why 'body' may safely live on the caller's stack. Every claimed index counts as
+    // done even if 'body' throws, so the caller always waits for the helpers before unwinding.
+    auto drain = [state, count, body_ptr]() {
+        size_t index;
+        while ((index = state->next.fetch_add(1)) < count) {
+            if (!state->failed.load(std::memory_order_relaxed)) { // After a failure, skip the rest
+                try {
+                    (*body_ptr)(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) state->error = std::current_exception();
+                    state->failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            if (state->done.fetch_add(1) + 1 == count) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->all_done.notify_all();
+            }
+        }
+    };
+    const size_t helpers = std::min(max_helpers, count - 1);
+    for (size_t h = 0; h < helpers; ++h) {
+        if (!hal_pool().submit(drain)) break;
+    }
+    drain();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->all_done.wait(lock, [&]() { return state->done.load() == count; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+} // namespace HAL
+} // namespace VPU
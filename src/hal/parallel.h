@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace VPU {
+namespace HAL {
+
+// Data-parallel helper for HAL kernels (blocked GEMM, large-buffer popcount/statistics).
+// Runs body(0) .. body(count - 1) on the calling thread plus up to 'max_helpers' threads from a
+// process-wide HAL pool, and returns once every index has run. The caller always takes part,
+// so this is safe to call from inside any other pool (e.g. the VPU's act stage) or nested.
+// If body throws, indices not yet started are skipped and the first exception is rethrown on
+// the caller once every helper has finished with 'body'.
+void parallel_for(size_t count, size_t max_helpers, const std::function<void(size_t)>& body);
+
+// Number of helper threads in the HAL pool (hardware_concurrency() - 1, at least 1).
+size_t parallel_helper_count();
+
+} // namespace HAL
+} // namespace VPU
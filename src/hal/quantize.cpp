@@ -0,0 +1,200 @@
+#include "hal/quantize.h"
+#include "hal/dtype.h"     // For bfloat16, float16 and their conversions
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <algorithm> // For std::min, std::max, std::fill
+#include <cfloat>    // For FLT_MIN, FLT_MAX
+#include <cmath>     // For std::fabs, std::isfinite, std::nearbyint
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+
+// Largest float32 that bfloat16 rounding keeps finite (the next one up rounds to infinity).
+constexpr double BFLOAT16_MAX = 3.3895313892515355e+38;
+
+// Products accumulate in int32 for at most this many k per flush: 127 * 127 * 2^17 < 2^31.
+constexpr int INT8_ACCUMULATE_K = 1 << 17;
+
+// Columns of B widened to float at a time by the BF16/FP16 GEMM: K * 64 floats stay cache-resident.
+constexpr int GEMM_PANEL_COLUMNS = 64;
+
+inline float widen(bfloat16 value) { return bf16_to_float(value); }
+inline float widen(float16 value) { return f16_to_float(value); }
+
+template <typename T>
+void saxpy_widening(float a, const T* x, float* y, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        y[i] += a * widen(x[i]);
+    }
+}
+
+template <typename T>
+void gemm_widening(const T* A, const T* B, float* C, int M, int N, int K) {
+    std::vector<float> panel(static_cast<size_t>(K) * GEMM_PANEL_COLUMNS);
+    for (int j0 = 0; j0 < N; j0 += GEMM_PANEL_COLUMNS) {
+        const int width = std::min(GEMM_PANEL_COLUMNS, N - j0);
+        for (int k = 0; k < K; ++k) {
+            const T* b_row = B + static_cast<size_t>(k) * N + j0;
+            float* panel_row = panel.data() + static_cast<size_t>(k) * width;
+            for (int j = 0; j < width; ++j) panel_row[j] = widen(b_row[j]);
+        }
+        for (int i = 0; i < M; ++i) {
+            float* c_row = C + static_cast<size_t>(i) * N + j0;
+            std::fill(c_row, c_row + width, 0.0f);
+            const T* a_row = A + static_cast<size_t>(i) * K;
+            for (int k = 0; k < K; ++k) {
+                const float a = widen(a_row[k]);
+                const float* panel_row = panel.data() + static_cast<size_t>(k) * width;
+                for (int j = 0; j < width; ++j) c_row[j] += a * panel_row[j];
+            }
+        }
+    }
+}
+
+void gemm_int8(const int8_t* A, const int8_t* B, float* C, int M, int N, int K, float scale) {
+    std::vector<int32_t> acc(static_cast<size_t>(N));
+    for (int i = 0; i < M; ++i) {
+        float* c_row = C + static_cast<size_t>(i) * N;
+        std::fill(c_row, c_row + N, 0.0f);
+        const int8_t* a_row = A + static_cast<size_t>(i) * K;
+        for (int k0 = 0; k0 < K; k0 += INT8_ACCUMULATE_K) {
+            std::fill(acc.begin(), acc.end(), 0);
+            const int k_end = std::min(K, k0 + INT8_ACCUMULATE_K);
+            for (int k = k0; k < k_end; ++k) {
+                const int32_t a = a_row[k];
+                if (a == 0) continue;
+                const int8_t* b_row = B + static_cast<size_t>(k) * N;
+                for (int j = 0; j < N; ++j) acc[j] += a * static_cast<int32_t>(b_row[j]);
+            }
+            for (int j = 0; j < N; ++j) c_row[j] += static_cast<float>(acc[j]) * scale;
+        }
+    }
+}
+
+} // namespace
+
+double quantization_error(ElementType type) {
+    const double FLOAT32_ROUNDOFF = 5.9604644775390625e-08; // 2^-24, for forming the float result
+    switch (type) {
+        case ElementType::BFLOAT16: return 0.00390625 + FLOAT32_ROUNDOFF;      // 2^-8
+        case ElementType::FLOAT16: return 0.00048828125 + FLOAT32_ROUNDOFF;    // 2^-11
+        case ElementType::INT8: return 1.0 / 254.0 + FLOAT32_ROUNDOFF;
+        default: return 0.0;
+    }
+}
+
+bool quantization_fits(ElementType type, double max_magnitude) {
+    if (!is_quantized_type(type) || !std::isfinite(max_magnitude)) {
+        return false;
+    }
+    if (max_magnitude == 0.0) {
+        return true; // All zeros: exact in every type
+    }
+    switch (type) {
+        case ElementType::BFLOAT16: return max_magnitude >= FLT_MIN && max_magnitude <= BFLOAT16_MAX;
+        case ElementType::FLOAT16: return max_magnitude >= FLOAT16_MIN_NORMAL && max_magnitude <= FLOAT16_MAX;
+        default: return max_magnitude >= 127.0 * FLT_MIN; // INT8: the scale stays a normal float
+    }
+}
+
+bool quantize(Span<const float> values, ElementType type, QuantizedTensor& out) {
+    out = QuantizedTensor();
+    float max_magnitude = 0.0f;
+    bool finite = true;
+    for (float v : values) {
+        const float magnitude = std::fabs(v);
+        finite &= magnitude <= FLT_MAX; // False for infinities and NaNs
+        max_magnitude = std::max(max_magnitude, magnitude);
+    }
+    if (!finite || !quantization_fits(type, max_magnitude)) {
+        return false;
+    }
+
+    out.type = type;
+    out.elements = values.size();
+    out.storage.resize(values.size() * element_size(type));
+    if (type == ElementType::INT8) {
+        out.scale = max_magnitude > 0.0f ? max_magnitude / 127.0f : 1.0f;
+        const float inverse = 1.0f / out.scale;
+        int8_t* q = reinterpret_cast<int8_t*>(out.storage.data());
+        for (size_t i = 0; i < values.size(); ++i) {
+            const float rounded = std::nearbyint(values[i] * inverse);
+            q[i] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, rounded)));
+        }
+    } else if (type == ElementType::BFLOAT16) {
+        bfloat16* q = reinterpret_cast<bfloat16*>(out.storage.data());
+        for (size_t i = 0; i < values.size(); ++i) q[i] = float_to_bf16(values[i]);
+    } else {
+        float16* q = reinterpret_cast<float16*>(out.storage.data());
+        for (size_t i = 0; i < values.size(); ++i) q[i] = float_to_f16(values[i]);
+    }
+    return true;
+}
+
+bool dequantize(const QuantizedTensor& q, Span<float> out) {
+    if (q.empty() || out.size() < q.elements) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] DEQUANTIZE: " << out.size() << " outputs for " << q.elements << " values.");
+        return false;
+    }
+    switch (q.type) {
+        case ElementType::INT8:
+            for (size_t i = 0; i < q.elements; ++i) out[i] = q.scale * static_cast<float>(q.data<int8_t>()[i]);
+            break;
+        case ElementType::BFLOAT16:
+            for (size_t i = 0; i < q.elements; ++i) out[i] = bf16_to_float(q.data<bfloat16>()[i]);
+            break;
+        default:
+            for (size_t i = 0; i < q.elements; ++i) out[i] = f16_to_float(q.data<float16>()[i]);
+            break;
+    }
+    return true;
+}
+
+bool cpu_saxpy_quantized(float a, const QuantizedTensor& x, Span<float> y) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing " << element_type_name(x.type) << " SAXPY.");
+    if (x.empty() || y.size() < x.elements) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] Quantized SAXPY: " << y.size() << " outputs for " << x.elements << " inputs.");
+        return false;
+    }
+    switch (x.type) {
+        case ElementType::INT8: {
+            const float a_scaled = a * x.scale;
+            const int8_t* q = x.data<int8_t>();
+            for (size_t i = 0; i < x.elements; ++i) y[i] += a_scaled * static_cast<float>(q[i]);
+            break;
+        }
+        case ElementType::BFLOAT16:
+            saxpy_widening(a, x.data<bfloat16>(), y.data(), x.elements);
+            break;
+        default:
+            saxpy_widening(a, x.data<float16>(), y.data(), x.elements);
+            break;
+    }
+    return true;
+}
+
+bool cpu_gemm_quantized(const QuantizedTensor& A, const QuantizedTensor& B, Span<float> C, int M, int N, int K) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing " << element_type_name(A.type) << " GEMM.");
+    if (A.empty() || B.empty() || A.type != B.type || M <= 0 || N <= 0 || K <= 0 ||
+        A.elements < static_cast<size_t>(M) * K || B.elements < static_cast<size_t>(K) * N ||
+        C.size() < static_cast<size_t>(M) * N) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] Quantized GEMM: invalid operands for " << M << "x" << K << " * " << K << "x" << N << ".");
+        return false;
+    }
+    switch (A.type) {
+        case ElementType::INT8:
+            gemm_int8(A.data<int8_t>(), B.data<int8_t>(), C.data(), M, N, K, A.scale * B.scale);
+            break;
+        case ElementType::BFLOAT16:
+            gemm_widening(A.data<bfloat16>(), B.data<bfloat16>(), C.data(), M, N, K);
+            break;
+        default:
+            gemm_widening(A.data<float16>(), B.data<float16>(), C.data(), M, N, K);
+            break;
+    }
+    return true;
+}
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "hal/buffer_stats.h" // For ElementType
+#include "hal/span.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VPU {
+namespace HAL {
+
+// A float32 tensor stored in a reduced-precision element type (BFLOAT16, FLOAT16 or INT8).
+// Element i stands for scale * value(i): INT8 is quantized symmetrically per tensor
+// (scale = max|x| / 127); the float types store values directly (scale 1).
+struct QuantizedTensor {
+    ElementType type = ElementType::FLOAT32; // FLOAT32 while empty
+    float scale = 1.0f;
+    size_t elements = 0;
+    std::vector<uint8_t> storage; // elements * element_size(type) bytes
+
+    bool empty() const { return storage.empty(); }
+    size_t size_bytes() const { return storage.size(); }
+    template <typename T> const T* data() const { return reinterpret_cast<const T*>(storage.data()); }
+};
+
+// The reduced-precision types the quantized kernels take.
+inline bool is_quantized_type(ElementType type) {
+    return type == ElementType::BFLOAT16 || type == ElementType::FLOAT16 || type == ElementType::INT8;
+}
+
+// The most rounding one value to 'type' can add, relative to the largest magnitude in its
+// tensor: the unit roundoff of BF16 (2^-8) and FP16 (2^-11), or half an INT8 step (1/254).
+// 0 for types that hold a float32 exactly.
+double quantization_error(ElementType type);
+
+// Smallest and largest magnitudes an FP16 tensor's largest value may have for the bound above
+// to hold: below 2^-14 values go subnormal, above 65504 they overflow.
+constexpr double FLOAT16_MIN_NORMAL = 6.103515625e-05;
+constexpr double FLOAT16_MAX = 65504.0;
+
+// True if a tensor whose largest magnitude is 'max_magnitude' quantizes to 'type' within
+// quantization_error(type). Non-finite magnitudes never do.
+bool quantization_fits(ElementType type, double max_magnitude);
+
+// Quantizes 'values' to 'type' (one pass to find max|x|, one to round to nearest even).
+// Returns false, leaving 'out' empty, unless every value is finite and the tensor fits (see
+// quantization_fits), so callers keep full precision instead of exceeding the bound.
+bool quantize(Span<const float> values, ElementType type, QuantizedTensor& out);
+
+// Widens a quantized tensor back to float32; 'out' must hold q.elements values.
+bool dequantize(const QuantizedTensor& q, Span<float> out);
+
+// y = a * x + y with x quantized. Each x is widened as it is loaded, so the only extra traffic
+// over an f32 SAXPY is reading the narrower x. Returns false (and logs) on bad sizes.
+bool cpu_saxpy_quantized(float a, const QuantizedTensor& x, Span<float> y);
+
+// C = A * B with A (M x K) and B (K x N) quantized to the same type, row-major; C is float32.
+// BF16/FP16 products accumulate in float over B panels widened once per panel; INT8 products
+// accumulate exactly in int32 and are scaled once per output. Returns false (and logs) on bad
+// sizes or mismatched types.
+bool cpu_gemm_quantized(const QuantizedTensor& A, const QuantizedTensor& B, Span<float> C, int M, int N, int K);
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,380 @@
+#include "hal/saxpy_jit.h"
+#include "hal/hal_utils.h"   // For hash_combine
+#include "hal/simd_target.h"
+#include <cmath>       // For std::isfinite
+#include <cstring>     // For std::memcpy
+#include <limits>
+#include <type_traits> // For std::integral_constant
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+
+using Body = CompiledSaxpyKernel::Body;
+constexpr uint32_t MAX_ALIGNMENT = 64;
+
+const char* alpha_kind_name(SaxpyAlphaKind kind) {
+    switch (kind) {
+        case SaxpyAlphaKind::ZERO: return "0";
+        case SaxpyAlphaKind::ONE: return "1";
+        case SaxpyAlphaKind::MINUS_ONE: return "-1";
+        case SaxpyAlphaKind::GENERAL: break;
+    }
+    return "general";
+}
+
+// --- Kernel templates ---
+// One body per (ISA, alpha kind, aligned, tail) combination; the specialization picks one at
+// compile time, so the generated kernel carries no runtime branches on those properties.
+
+template <SaxpyAlphaKind K>
+inline float axpy_scalar(float a, float x, float y) {
+    if constexpr (K == SaxpyAlphaKind::ONE) return y + x;
+    else if constexpr (K == SaxpyAlphaKind::MINUS_ONE) return y - x;
+    else return a * x + y;
+}
+
+template <SaxpyAlphaKind K>
+void saxpy_dense_scalar(float a, const float* x, float* y, size_t n, const uint32_t*) {
+    for (size_t i = 0; i < n; ++i) {
+        y[i] = axpy_scalar<K>(a, x[i], y[i]);
+    }
+}
+
+template <SaxpyAlphaKind K>
+void saxpy_sparse_scalar(float a, const float* x, float* y, size_t count, const uint32_t* indices) {
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t j = indices[i];
+        y[j] = axpy_scalar<K>(a, x[j], y[j]);
+    }
+}
+
+#if defined(VPU_HAL_HAS_X86_SIMD)
+template <SaxpyAlphaKind K>
+VPU_HAL_TARGET("avx512f") inline __m512 axpy_avx512(__m512 va, __m512 vx, __m512 vy) {
+    if constexpr (K == SaxpyAlphaKind::ONE) return _mm512_add_ps(vy, vx);
+    else if constexpr (K == SaxpyAlphaKind::MINUS_ONE) return _mm512_sub_ps(vy, vx);
+    else return _mm512_fmadd_ps(va, vx, vy);
+}
+
+template <SaxpyAlphaKind K, bool ALIGNED, bool TAIL>
+VPU_HAL_TARGET("avx512f")
+void saxpy_dense_avx512(float a, const float* x, float* y, size_t n, const uint32_t*) {
+    const __m512 va = _mm512_set1_ps(a);
+    const size_t body = n & ~size_t(15);
+    for (size_t i = 0; i < body; i += 16) {
+        __m512 vx, vy;
+        if constexpr (ALIGNED) {
+            vx = _mm512_load_ps(x + i);
+            vy = _mm512_load_ps(y + i);
+        } else {
+            vx = _mm512_loadu_ps(x + i);
+            vy = _mm512_loadu_ps(y + i);
+        }
+        vy = axpy_avx512<K>(va, vx, vy);
+        if constexpr (ALIGNED) _mm512_store_ps(y + i, vy);
+        else _mm512_storeu_ps(y + i, vy);
+    }
+    if constexpr (TAIL) { // Masked tail: no scalar epilogue
+        const __mmask16 mask = static_cast<__mmask16>((1u << (n - body)) - 1);
+        __m512 vy = _mm512_maskz_loadu_ps(mask, y + body);
+        vy = axpy_avx512<K>(va, _mm512_maskz_loadu_ps(mask, x + body), vy);
+        _mm512_mask_storeu_ps(y + body, mask, vy);
+    }
+}
+
+// Gathers the non-zeros of x (and matching y) 16 at a time; the indices are unique, so the scatter never conflicts.
+template <SaxpyAlphaKind K>
+VPU_HAL_TARGET("avx512f")
+void saxpy_sparse_avx512(float a, const float* x, float* y, size_t count, const uint32_t* indices) {
+    const __m512 va = _mm512_set1_ps(a);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m512i vi = _mm512_loadu_si512(indices + i);
+        const __m512 vx = _mm512_i32gather_ps(vi, x, 4);
+        const __m512 vy = _mm512_i32gather_ps(vi, y, 4);
+        _mm512_i32scatter_ps(y, vi, axpy_avx512<K>(va, vx, vy), 4);
+    }
+    if (i < count) {
+        const __mmask16 mask = static_cast<__mmask16>((1u << (count - i)) - 1);
+        const __m512i vi = _mm512_maskz_loadu_epi32(mask, indices + i);
+        const __m512 vx = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, vi, x, 4);
+        const __m512 vy = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, vi, y, 4);
+        _mm512_mask_i32scatter_ps(y, mask, vi, axpy_avx512<K>(va, vx, vy), 4);
+    }
+}
+
+template <SaxpyAlphaKind K>
+VPU_HAL_TARGET("avx2,fma") inline __m256 axpy_avx2(__m256 va, __m256 vx, __m256 vy) {
+    if constexpr (K == SaxpyAlphaKind::ONE) return _mm256_add_ps(vy, vx);
+    else if constexpr (K == SaxpyAlphaKind::MINUS_ONE) return _mm256_sub_ps(vy, vx);
+    else return _mm256_fmadd_ps(va, vx, vy);
+}
+
+template <SaxpyAlphaKind K, bool ALIGNED, bool TAIL>
+VPU_HAL_TARGET("avx2,fma")
+void saxpy_dense_avx2(float a, const float* x, float* y, size_t n, const uint32_t*) {
+    const __m256 va = _mm256_set1_ps(a);
+    const size_t body = n & ~size_t(7);
+    for (size_t i = 0; i < body; i += 8) {
+        __m256 vx, vy;
+        if constexpr (ALIGNED) {
+            vx = _mm256_load_ps(x + i);
+            vy = _mm256_load_ps(y + i);
+        } else {
+            vx = _mm256_loadu_ps(x + i);
+            vy = _mm256_loadu_ps(y + i);
+        }
+        vy = axpy_avx2<K>(va, vx, vy);
+        if constexpr (ALIGNED) _mm256_store_ps(y + i, vy);
+        else _mm256_storeu_ps(y + i, vy);
+    }
+    if constexpr (TAIL) {
+        for (size_t i = body; i < n; ++i) {
+            y[i] = axpy_scalar<K>(a, x[i], y[i]);
+        }
+    }
+}
+
+template <SaxpyAlphaKind K>
+Body select_dense_avx512(bool aligned, bool tail) {
+    if (aligned) return tail ? &saxpy_dense_avx512<K, true, true> : &saxpy_dense_avx512<K, true, false>;
+    return tail ? &saxpy_dense_avx512<K, false, true> : &saxpy_dense_avx512<K, false, false>;
+}
+
+template <SaxpyAlphaKind K>
+Body select_dense_avx2(bool aligned, bool tail) {
+    if (aligned) return tail ? &saxpy_dense_avx2<K, true, true> : &saxpy_dense_avx2<K, true, false>;
+    return tail ? &saxpy_dense_avx2<K, false, true> : &saxpy_dense_avx2<K, false, false>;
+}
+#endif
+
+#if defined(VPU_HAL_HAS_NEON)
+template <SaxpyAlphaKind K>
+void saxpy_dense_neon(float a, const float* x, float* y, size_t n, const uint32_t*) {
+    const float32x4_t va = vdupq_n_f32(a);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t vx = vld1q_f32(x + i);
+        const float32x4_t vy = vld1q_f32(y + i);
+        if constexpr (K == SaxpyAlphaKind::ONE) vst1q_f32(y + i, vaddq_f32(vy, vx));
+        else if constexpr (K == SaxpyAlphaKind::MINUS_ONE) vst1q_f32(y + i, vsubq_f32(vy, vx));
+        else vst1q_f32(y + i, vfmaq_f32(vy, va, vx));
+    }
+    for (; i < n; ++i) {
+        y[i] = axpy_scalar<K>(a, x[i], y[i]);
+    }
+}
+#endif
+
+// Calls select(std::integral_constant<SaxpyAlphaKind, K>) for the non-zero alpha kind 'kind'.
+template <typename Select>
+Body for_alpha(SaxpyAlphaKind kind, Select select) {
+    switch (kind) {
+        case SaxpyAlphaKind::ONE: return select(std::integral_constant<SaxpyAlphaKind, SaxpyAlphaKind::ONE>());
+        case SaxpyAlphaKind::MINUS_ONE: return select(std::integral_constant<SaxpyAlphaKind, SaxpyAlphaKind::MINUS_ONE>());
+        case SaxpyAlphaKind::ZERO: // No body is generated for alpha == 0 (see CompiledSaxpyKernel::run)
+        case SaxpyAlphaKind::GENERAL: break;
+    }
+    return select(std::integral_constant<SaxpyAlphaKind, SaxpyAlphaKind::GENERAL>());
+}
+
+uint32_t common_alignment(const float* x, const float* y) {
+    const uintptr_t bits = reinterpret_cast<uintptr_t>(x) | reinterpret_cast<uintptr_t>(y);
+    const uintptr_t lowest = bits & (~bits + 1); // Lowest set bit: the largest power of two dividing both
+    return lowest == 0 || lowest > MAX_ALIGNMENT ? MAX_ALIGNMENT : static_cast<uint32_t>(lowest);
+}
+
+// Hash of a non-zero pattern of an 'n'-element x. Only picks the cache bucket: equality
+// compares the index lists themselves.
+uint64_t nonzero_pattern_hash(const std::vector<uint32_t>& nonzeros, size_t n) {
+    uint64_t h = hash_combine(0, n);
+    for (uint32_t i : nonzeros) {
+        h = hash_combine(h, i);
+    }
+    return h ? h : 1; // 0 is reserved for dense kernels
+}
+
+} // namespace
+
+float SaxpySpecialization::alpha() const {
+    float a;
+    std::memcpy(&a, &alpha_bits, sizeof(a));
+    return a;
+}
+
+bool SaxpySpecialization::operator==(const SaxpySpecialization& other) const {
+    if (!(alpha_bits == other.alpha_bits && alpha_kind == other.alpha_kind && length == other.length &&
+          alignment == other.alignment && sparse == other.sparse && pattern_hash == other.pattern_hash)) {
+        return false;
+    }
+    if (nonzeros == other.nonzeros) {
+        return true; // Same list, or both dense
+    }
+    return nonzeros && other.nonzeros && *nonzeros == *other.nonzeros;
+}
+
+size_t SaxpySpecializationHash::operator()(const SaxpySpecialization& spec) const {
+    uint64_t h = hash_combine(spec.alpha_bits, static_cast<uint64_t>(spec.alpha_kind));
+    h = hash_combine(h, spec.length);
+    h = hash_combine(h, spec.alignment);
+    h = hash_combine(h, spec.sparse ? 1 : 0);
+    h = hash_combine(h, spec.pattern_hash);
+    return static_cast<size_t>(h);
+}
+
+SaxpySpecialization specialize_saxpy(float alpha, const float* x, const float* y, size_t n, bool sparse) {
+    SaxpySpecialization spec;
+    std::memcpy(&spec.alpha_bits, &alpha, sizeof(alpha));
+    spec.length = (x && y) ? n : 0;
+    spec.alignment = common_alignment(x, y);
+
+    if (alpha == 1.0f) {
+        spec.alpha_kind = SaxpyAlphaKind::ONE;
+    } else if (alpha == -1.0f) {
+        spec.alpha_kind = SaxpyAlphaKind::MINUS_ONE;
+    }
+
+    // One pass over x for whatever needs it: finiteness decides whether alpha == 0 is a no-op,
+    // and sparse kernels (which gather with 32-bit indices) need the non-zero positions.
+    const bool check_finite = alpha == 0.0f;
+    const bool want_pattern = sparse && spec.length <= static_cast<size_t>(std::numeric_limits<int32_t>::max());
+    bool all_finite = true;
+    std::vector<uint32_t> nonzeros;
+    if (check_finite || want_pattern) {
+        for (size_t i = 0; i < spec.length; ++i) {
+            if (check_finite && !std::isfinite(x[i])) all_finite = false;
+            if (want_pattern && x[i] != 0.0f) nonzeros.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (check_finite) {
+        spec.alpha_kind = all_finite ? SaxpyAlphaKind::ZERO : SaxpyAlphaKind::GENERAL;
+    }
+    spec.sparse = want_pattern && spec.alpha_kind != SaxpyAlphaKind::ZERO;
+    if (spec.sparse) {
+        spec.pattern_hash = nonzero_pattern_hash(nonzeros, spec.length);
+        spec.nonzeros = std::make_shared<const std::vector<uint32_t>>(std::move(nonzeros));
+    }
+    return spec;
+}
+
+CompiledSaxpyKernel::CompiledSaxpyKernel(const SaxpySpecialization& spec)
+    : spec_(spec), isa_(best_simd_isa()) {
+    std::string traits = std::string("alpha=") + alpha_kind_name(spec_.alpha_kind);
+    if (spec_.alpha_kind == SaxpyAlphaKind::ZERO) {
+        name_ = "saxpy<noop, alpha=0>"; // y is already the result
+        return;
+    }
+
+    if (spec_.sparse) {
+        traits += ", nnz=" + std::to_string(spec_.nonzeros->size());
+#if defined(VPU_HAL_HAS_X86_SIMD)
+        if (isa_ == SimdIsa::AVX512) {
+            body_ = for_alpha(spec_.alpha_kind, [](auto k) { return &saxpy_sparse_avx512<decltype(k)::value>; });
+        }
+#endif
+        if (!body_) { // AVX2 and NEON have no scatter, so other ISAs visit the indices one at a time
+            isa_ = SimdIsa::SCALAR;
+            body_ = for_alpha(spec_.alpha_kind, [](auto k) { return &saxpy_sparse_scalar<decltype(k)::value>; });
+        }
+        name_ = std::string("saxpy_sparse<") + simd_isa_name(isa_) + ", " + traits + ">";
+        return;
+    }
+
+#if defined(VPU_HAL_HAS_X86_SIMD)
+    if (isa_ == SimdIsa::AVX512 || isa_ == SimdIsa::AVX2) {
+        const bool wide = isa_ == SimdIsa::AVX512;
+        const bool aligned = spec_.alignment >= (wide ? 64u : 32u);
+        const bool tail = spec_.length % (wide ? 16 : 8) != 0;
+        body_ = wide ? for_alpha(spec_.alpha_kind, [&](auto k) { return select_dense_avx512<decltype(k)::value>(aligned, tail); })
+                     : for_alpha(spec_.alpha_kind, [&](auto k) { return select_dense_avx2<decltype(k)::value>(aligned, tail); });
+        traits += aligned ? ", aligned" : ", unaligned";
+        if (tail) traits += ", tail";
+    }
+#endif
+#if defined(VPU_HAL_HAS_NEON)
+    if (isa_ == SimdIsa::NEON) {
+        body_ = for_alpha(spec_.alpha_kind, [](auto k) { return &saxpy_dense_neon<decltype(k)::value>; });
+    }
+#endif
+    if (!body_) {
+        isa_ = SimdIsa::SCALAR;
+        body_ = for_alpha(spec_.alpha_kind, [](auto k) { return &saxpy_dense_scalar<decltype(k)::value>; });
+    }
+    name_ = std::string("saxpy<") + simd_isa_name(isa_) + ", " + traits + ">";
+}
+
+void CompiledSaxpyKernel::run(const float* x, float* y) const {
+    if (!body_ || !x || !y) {
+        return; // alpha == 0 (with finite x) leaves y unchanged
+    }
+    if (spec_.sparse) {
+        body_(spec_.alpha(), x, y, spec_.nonzeros->size(), spec_.nonzeros->data());
+    } else {
+        body_(spec_.alpha(), x, y, spec_.length, nullptr);
+    }
+}
+
+// --- SaxpyKernelCache ---
+
+SaxpyKernelCache& SaxpyKernelCache::instance() {
+    static SaxpyKernelCache cache;
+    return cache;
+}
+
+std::shared_ptr<const CompiledSaxpyKernel> SaxpyKernelCache::get_or_compile(const SaxpySpecialization& spec) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(spec);
+    if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        ++stats_.hits;
+        return *it->second;
+    }
+    auto kernel = std::make_shared<const CompiledSaxpyKernel>(spec);
+    ++stats_.compilations;
+    if (capacity_ > 0) {
+        lru_.push_front(kernel);
+        index_[spec] = lru_.begin();
+        evict_to_capacity();
+    }
+    return kernel;
+}
+
+bool SaxpyKernelCache::contains(const SaxpySpecialization& spec) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.count(spec) != 0;
+}
+
+void SaxpyKernelCache::set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evict_to_capacity();
+}
+
+void SaxpyKernelCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+}
+
+SaxpyKernelCache::Stats SaxpyKernelCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+size_t SaxpyKernelCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+void SaxpyKernelCache::evict_to_capacity() {
+    while (lru_.size() > capacity_) {
+        index_.erase(lru_.back()->specialization());
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+} // namespace HAL
+} // namespace VPU
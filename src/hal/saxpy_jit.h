@@ -0,0 +1,118 @@
+#pragma once
+
+#include "hal/cpu_features.h" // For SimdIsa
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace VPU {
+namespace HAL {
+
+// How alpha is folded into a generated SAXPY kernel.
+enum class SaxpyAlphaKind {
+    ZERO,      // y unchanged (only chosen when every x is finite, since 0 * inf is NaN)
+    ONE,       // y + x
+    MINUS_ONE, // y - x
+    GENERAL    // alpha * x + y
+};
+
+// Everything a generated SAXPY kernel is specialized on. Equal specializations share one
+// compiled kernel, so the key must capture every property the generated code relies on.
+struct SaxpySpecialization {
+    uint32_t alpha_bits = 0;               // Bit pattern of alpha (distinguishes -0.0f, NaN payloads)
+    SaxpyAlphaKind alpha_kind = SaxpyAlphaKind::GENERAL;
+    size_t length = 0;                     // Elements of x and y
+    uint32_t alignment = 0;                // Largest power of two <= 64 dividing both x and y addresses
+    bool sparse = false;                   // Only the non-zeros of x are visited (their indices are baked in)
+    uint64_t pattern_hash = 0;             // Hash of 'nonzeros': picks the cache bucket; 0 for dense kernels
+    // Sparse only: positions of x's non-zeros, ascending. Compared in full, so two patterns whose
+    // hashes collide never share a kernel.
+    std::shared_ptr<const std::vector<uint32_t>> nonzeros;
+
+    float alpha() const;
+    bool operator==(const SaxpySpecialization& other) const;
+};
+
+struct SaxpySpecializationHash {
+    size_t operator()(const SaxpySpecialization& spec) const;
+};
+
+// Builds the specialization for y = alpha * x + y over 'n' elements. Dense specializations
+// cost O(1) unless alpha is zero; otherwise one pass over x finds both whether it is finite
+// (alpha == 0) and its non-zero pattern (sparse). Build it once per task and reuse it.
+SaxpySpecialization specialize_saxpy(float alpha, const float* x, const float* y, size_t n, bool sparse);
+
+// A SAXPY kernel generated for one SaxpySpecialization: the alpha kind, alignment and
+// tail handling are template parameters of the selected body, and sparse kernels use the
+// specialization's index list of x's non-zeros. Immutable, so it may run on many threads at once.
+class CompiledSaxpyKernel {
+public:
+    using Body = void (*)(float alpha, const float* x, float* y, size_t count, const uint32_t* indices);
+
+    explicit CompiledSaxpyKernel(const SaxpySpecialization& spec);
+
+    // y = alpha * x + y over specialization().length elements. 'x' and 'y' must match the
+    // specialization: the same alignment, and for sparse kernels the same non-zero pattern.
+    void run(const float* x, float* y) const;
+
+    const SaxpySpecialization& specialization() const { return spec_; }
+    SimdIsa isa() const { return isa_; }
+    const std::string& name() const { return name_; } // e.g. "saxpy<AVX512, alpha=1, aligned, tail>"
+    size_t work_elements() const { return spec_.sparse ? spec_.nonzeros->size() : spec_.length; }
+
+private:
+    SaxpySpecialization spec_;
+    SimdIsa isa_;
+    Body body_ = nullptr;
+    std::string name_;
+};
+
+// Process-wide LRU cache of generated SAXPY kernels, keyed by specialization, so each
+// specialization is compiled once. Kernels are pure functions of their key, which makes
+// sharing them across VPU instances safe. Thread-safe.
+class SaxpyKernelCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64;
+
+    static SaxpyKernelCache& instance();
+
+    // Returns the cached kernel for 'spec', or compiles one.
+    std::shared_ptr<const CompiledSaxpyKernel> get_or_compile(const SaxpySpecialization& spec);
+    // True if a kernel for 'spec' is cached (does not touch the LRU order or the stats).
+    bool contains(const SaxpySpecialization& spec) const;
+
+    // Capacity 0 disables caching (every request compiles). Shrinking evicts least recently used kernels.
+    void set_capacity(size_t capacity);
+    void clear();
+
+    struct Stats {
+        uint64_t compilations = 0;
+        uint64_t hits = 0;
+        uint64_t evictions = 0;
+    };
+    Stats stats() const;
+    size_t size() const;
+
+private:
+    SaxpyKernelCache() = default;
+    SaxpyKernelCache(const SaxpyKernelCache&) = delete;
+    SaxpyKernelCache& operator=(const SaxpyKernelCache&) = delete;
+
+    using Entry = std::shared_ptr<const CompiledSaxpyKernel>;
+
+    void evict_to_capacity(); // Requires mutex_
+
+    mutable std::mutex mutex_;
+    size_t capacity_ = DEFAULT_CAPACITY;
+    std::list<Entry> lru_; // Most recently used first
+    std::unordered_map<SaxpySpecialization, std::list<Entry>::iterator, SaxpySpecializationHash> index_;
+    Stats stats_;
+};
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,80 @@
+#include "hal/scratch_arena.h"
+#include <new> // For aligned operator new
+
+namespace VPU {
+namespace HAL {
+
+ScratchArena::~ScratchArena() {
+    release_all();
+    trim();
+}
+
+ScratchArena& ScratchArena::for_this_thread() {
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+size_t ScratchArena::size_class_for(size_t bytes) {
+    size_t size_class = 0;
+    while (size_class + 1 < NUM_SIZE_CLASSES && class_bytes(size_class) < bytes) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+void ScratchArena::free_block(void* data) {
+    ::operator delete(data, std::align_val_t(ALIGNMENT));
+}
+
+void* ScratchArena::acquire(size_t bytes) {
+    const size_t size_class = size_class_for(bytes);
+    std::vector<void*>& free_list = free_blocks_[size_class];
+    void* data = nullptr;
+    if (!free_list.empty()) {
+        data = free_list.back();
+        free_list.pop_back();
+        stats_.bytes_cached -= class_bytes(size_class);
+        ++stats_.reuses;
+    } else {
+        data = ::operator new(class_bytes(size_class), std::align_val_t(ALIGNMENT));
+        ++stats_.heap_allocations;
+    }
+    in_use_.push_back({data, size_class});
+    stats_.bytes_in_use += class_bytes(size_class);
+    return data;
+}
+
+void ScratchArena::release_to(size_t mark) {
+    while (in_use_.size() > mark) {
+        const Block block = in_use_.back();
+        in_use_.pop_back();
+        const size_t bytes = class_bytes(block.size_class);
+        stats_.bytes_in_use -= bytes;
+        if (stats_.bytes_cached + bytes <= retained_limit_) {
+            free_blocks_[block.size_class].push_back(block.data);
+            stats_.bytes_cached += bytes;
+        } else {
+            free_block(block.data);
+        }
+    }
+}
+
+void ScratchArena::trim() {
+    for (auto& free_list : free_blocks_) {
+        for (void* data : free_list) {
+            free_block(data);
+        }
+        free_list.clear();
+    }
+    stats_.bytes_cached = 0;
+}
+
+void ScratchArena::set_retained_bytes_limit(size_t bytes) {
+    retained_limit_ = bytes;
+    if (stats_.bytes_cached > retained_limit_) {
+        trim();
+    }
+}
+
+} // namespace HAL
+} // namespace VPU
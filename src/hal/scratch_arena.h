@@ -0,0 +1,89 @@
+#pragma once
+
+#include "hal/span.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VPU {
+namespace HAL {
+
+// Per-thread pool of 64-byte aligned scratch blocks in power-of-two size classes.
+// Blocks are cache-line aligned (which also satisfies FFTW's SIMD alignment, so FFT plans
+// on them never need FFTW_UNALIGNED) and are recycled instead of returned to the heap, so
+// steady-state kernels do no allocator traffic. Acquisitions are released in bulk, newest
+// first (see ScratchScope). Not thread-safe: each thread uses its own arena.
+class ScratchArena {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t MIN_BLOCK_BYTES = 256;
+    // Free blocks beyond this many bytes are returned to the heap on release.
+    static constexpr size_t DEFAULT_RETAINED_BYTES = size_t(64) << 20;
+
+    ScratchArena() = default;
+    ~ScratchArena();
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // The calling thread's arena (worker pools, the HAL thread pool and callers each have one).
+    static ScratchArena& for_this_thread();
+
+    // A block of at least 'bytes' bytes, aligned to ALIGNMENT; valid until released.
+    void* acquire(size_t bytes);
+    template <typename T>
+    Span<T> acquire_span(size_t count) { return Span<T>(static_cast<T*>(acquire(count * sizeof(T))), count); }
+
+    // Releases every block acquired after mark() returned 'mark'.
+    size_t mark() const { return in_use_.size(); }
+    void release_to(size_t mark);
+    void release_all() { release_to(0); }
+
+    // Returns all free blocks to the heap.
+    void trim();
+    void set_retained_bytes_limit(size_t bytes);
+
+    struct Stats {
+        uint64_t heap_allocations = 0; // Blocks allocated from the heap
+        uint64_t reuses = 0;           // Acquisitions served from a free block
+        size_t bytes_in_use = 0;
+        size_t bytes_cached = 0;       // Held in free lists
+    };
+    const Stats& stats() const { return stats_; }
+
+private:
+    static constexpr size_t NUM_SIZE_CLASSES = 48; // MIN_BLOCK_BYTES << 47 is beyond any real buffer
+    static size_t size_class_for(size_t bytes);
+    static size_t class_bytes(size_t size_class) { return MIN_BLOCK_BYTES << size_class; }
+    static void free_block(void* data);
+
+    struct Block {
+        void* data;
+        size_t size_class;
+    };
+    std::vector<Block> in_use_; // In acquisition order
+    std::array<std::vector<void*>, NUM_SIZE_CLASSES> free_blocks_;
+    size_t retained_limit_ = DEFAULT_RETAINED_BYTES;
+    Stats stats_;
+};
+
+// Scratch acquired through a scope is released when the scope ends. Scopes nest, so a
+// kernel can open one inside an execution that already holds scratch of its own.
+class ScratchScope {
+public:
+    explicit ScratchScope(ScratchArena& arena = ScratchArena::for_this_thread()) : arena_(arena), mark_(arena.mark()) {}
+    ~ScratchScope() { arena_.release_to(mark_); }
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    void* acquire(size_t bytes) { return arena_.acquire(bytes); }
+    template <typename T>
+    Span<T> acquire_span(size_t count) { return arena_.acquire_span<T>(count); }
+
+private:
+    ScratchArena& arena_;
+    size_t mark_;
+};
+
+} // namespace HAL
+} // namespace VPU
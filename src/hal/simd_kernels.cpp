@@ -0,0 +1,237 @@
+#include "hal/hal.h"
+#include "hal/hal_utils.h"
+#include "hal/cpu_features.h"
+#include "hal/simd_target.h"
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <algorithm> // For std::min, std::fill
+#include <cstring>   // For std::memcpy
+
+// Variants not compiled into this build (see hal/simd_target.h) fall back to the scalar kernel.
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+void saxpy_scalar_loop(float a, const float* x, float* y, size_t begin, size_t n) {
+    for (size_t i = begin; i < n; ++i) {
+        y[i] = a * x[i] + y[i];
+    }
+}
+} // namespace
+
+// --- SAXPY ---
+
+#if defined(VPU_HAL_HAS_X86_SIMD)
+VPU_HAL_TARGET("avx2,fma")
+void cpu_saxpy_avx2(float a, Span<const float> x, Span<float> y) {
+    const size_t n = std::min(x.size(), y.size());
+    const float* xp = x.data();
+    float* yp = y.data();
+    const __m256 va = _mm256_set1_ps(a);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 vy = _mm256_loadu_ps(yp + i);
+        vy = _mm256_fmadd_ps(va, _mm256_loadu_ps(xp + i), vy);
+        _mm256_storeu_ps(yp + i, vy);
+    }
+    saxpy_scalar_loop(a, xp, yp, i, n);
+}
+
+VPU_HAL_TARGET("avx512f")
+void cpu_saxpy_avx512(float a, Span<const float> x, Span<float> y) {
+    const size_t n = std::min(x.size(), y.size());
+    const float* xp = x.data();
+    float* yp = y.data();
+    const __m512 va = _mm512_set1_ps(a);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 vy = _mm512_loadu_ps(yp + i);
+        vy = _mm512_fmadd_ps(va, _mm512_loadu_ps(xp + i), vy);
+        _mm512_storeu_ps(yp + i, vy);
+    }
+    if (i < n) { // Masked tail: no scalar epilogue
+        const __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+        __m512 vy = _mm512_maskz_loadu_ps(mask, yp + i);
+        vy = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, xp + i), vy);
+        _mm512_mask_storeu_ps(yp + i, mask, vy);
+    }
+}
+#else
+void cpu_saxpy_avx2(float a, Span<const float> x, Span<float> y) {
+    saxpy_scalar_loop(a, x.data(), y.data(), 0, std::min(x.size(), y.size()));
+}
+void cpu_saxpy_avx512(float a, Span<const float> x, Span<float> y) {
+    saxpy_scalar_loop(a, x.data(), y.data(), 0, std::min(x.size(), y.size()));
+}
+#endif
+
+void cpu_saxpy_neon(float a, Span<const float> x, Span<float> y) {
+    const size_t n = std::min(x.size(), y.size());
+    const float* xp = x.data();
+    float* yp = y.data();
+    size_t i = 0;
+#if defined(VPU_HAL_HAS_NEON)
+    const float32x4_t va = vdupq_n_f32(a);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(yp + i, vfmaq_f32(vld1q_f32(yp + i), va, vld1q_f32(xp + i)));
+    }
+#endif
+    saxpy_scalar_loop(a, xp, yp, i, n);
+}
+
+void cpu_saxpy_best(float a, Span<const float> x, Span<float> y) {
+    switch (best_simd_isa()) {
+        case SimdIsa::AVX512: cpu_saxpy_avx512(a, x, y); return;
+        case SimdIsa::AVX2: cpu_saxpy_avx2(a, x, y); return;
+        case SimdIsa::NEON: cpu_saxpy_neon(a, x, y); return;
+        case SimdIsa::SCALAR: break;
+    }
+    saxpy_scalar_loop(a, x.data(), y.data(), 0, std::min(x.size(), y.size()));
+}
+
+// --- GEMM ---
+// Row-major i-k-j order: each A[i][k] is broadcast and multiplied into a contiguous row
+// of B, accumulating into a contiguous row of C, so the inner loop is a unit-stride FMA.
+
+namespace {
+void gemm_row_scalar(float a_ik, const float* b_row, float* c_row, int begin, int N) {
+    for (int j = begin; j < N; ++j) {
+        c_row[j] += a_ik * b_row[j];
+    }
+}
+} // namespace
+
+#if defined(VPU_HAL_HAS_X86_SIMD)
+VPU_HAL_TARGET("avx2,fma")
+void cpu_gemm_avx2(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing AVX2 GEMM.");
+    std::fill(C.begin(), C.begin() + static_cast<size_t>(M) * N, 0.0f);
+    for (int i = 0; i < M; ++i) {
+        float* c_row = C.data() + static_cast<size_t>(i) * N;
+        for (int k = 0; k < K; ++k) {
+            const float a_ik = A[static_cast<size_t>(i) * K + k];
+            const float* b_row = B.data() + static_cast<size_t>(k) * N;
+            const __m256 va = _mm256_set1_ps(a_ik);
+            int j = 0;
+            for (; j + 8 <= N; j += 8) {
+                _mm256_storeu_ps(c_row + j, _mm256_fmadd_ps(va, _mm256_loadu_ps(b_row + j), _mm256_loadu_ps(c_row + j)));
+            }
+            gemm_row_scalar(a_ik, b_row, c_row, j, N);
+        }
+    }
+}
+
+VPU_HAL_TARGET("avx512f")
+void cpu_gemm_avx512(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing AVX-512 GEMM.");
+    std::fill(C.begin(), C.begin() + static_cast<size_t>(M) * N, 0.0f);
+    for (int i = 0; i < M; ++i) {
+        float* c_row = C.data() + static_cast<size_t>(i) * N;
+        for (int k = 0; k < K; ++k) {
+            const float a_ik = A[static_cast<size_t>(i) * K + k];
+            const float* b_row = B.data() + static_cast<size_t>(k) * N;
+            const __m512 va = _mm512_set1_ps(a_ik);
+            int j = 0;
+            for (; j + 16 <= N; j += 16) {
+                _mm512_storeu_ps(c_row + j, _mm512_fmadd_ps(va, _mm512_loadu_ps(b_row + j), _mm512_loadu_ps(c_row + j)));
+            }
+            gemm_row_scalar(a_ik, b_row, c_row, j, N);
+        }
+    }
+}
+#else
+void cpu_gemm_avx2(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    cpu_gemm_naive(A, B, C, M, N, K);
+}
+void cpu_gemm_avx512(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    cpu_gemm_naive(A, B, C, M, N, K);
+}
+#endif
+
+void cpu_gemm_neon(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing NEON GEMM.");
+    std::fill(C.begin(), C.begin() + static_cast<size_t>(M) * N, 0.0f);
+    for (int i = 0; i < M; ++i) {
+        float* c_row = C.data() + static_cast<size_t>(i) * N;
+        for (int k = 0; k < K; ++k) {
+            const float a_ik = A[static_cast<size_t>(i) * K + k];
+            const float* b_row = B.data() + static_cast<size_t>(k) * N;
+            int j = 0;
+#if defined(VPU_HAL_HAS_NEON)
+            const float32x4_t va = vdupq_n_f32(a_ik);
+            for (; j + 4 <= N; j += 4) {
+                vst1q_f32(c_row + j, vfmaq_f32(vld1q_f32(c_row + j), va, vld1q_f32(b_row + j)));
+            }
+#endif
+            gemm_row_scalar(a_ik, b_row, c_row, j, N);
+        }
+    }
+}
+
+// --- Hamming weight (popcount) ---
+
+#if defined(VPU_HAL_HAS_X86_SIMD)
+VPU_HAL_TARGET("popcnt")
+uint64_t hamming_weight_popcnt(const void* data, size_t bytes) {
+    if (!data || bytes == 0) return 0;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t total = 0;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, p + i, sizeof(word));
+        total += static_cast<uint64_t>(_mm_popcnt_u64(word));
+    }
+    return total + hamming_weight_scalar(p + i, bytes - i);
+}
+
+// Nibble-lookup popcount (Mula): PSHUFB counts 4-bit halves, PSADBW sums bytes into 64-bit lanes.
+VPU_HAL_TARGET("avx2")
+uint64_t hamming_weight_avx2(const void* data, size_t bytes) {
+    if (!data || bytes == 0) return 0;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+        const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + hamming_weight_scalar(p + i, bytes - i);
+}
+
+VPU_HAL_TARGET("avx512f,avx512vpopcntdq")
+uint64_t hamming_weight_avx512(const void* data, size_t bytes) {
+    if (!data || bytes == 0) return 0;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(p + i)));
+    }
+    return static_cast<uint64_t>(_mm512_reduce_add_epi64(acc)) + hamming_weight_scalar(p + i, bytes - i);
+}
+#else
+uint64_t hamming_weight_popcnt(const void* data, size_t bytes) { return hamming_weight_scalar(data, bytes); }
+uint64_t hamming_weight_avx2(const void* data, size_t bytes) { return hamming_weight_scalar(data, bytes); }
+uint64_t hamming_weight_avx512(const void* data, size_t bytes) { return hamming_weight_scalar(data, bytes); }
+#endif
+
+SimdIsa best_simd_isa() {
+    static const SimdIsa best = []() {
+        if (cpu_supports(SimdIsa::AVX512)) return SimdIsa::AVX512;
+        if (cpu_supports(SimdIsa::AVX2)) return SimdIsa::AVX2;
+        if (cpu_supports(SimdIsa::NEON)) return SimdIsa::NEON;
+        return SimdIsa::SCALAR;
+    }();
+    return best;
+}
+
+} // namespace HAL
+} // namespace VPU
@@ -0,0 +1,19 @@
+#pragma once
+
+// Compile-time switches for the ISA-specific HAL kernels.
+// ISA-specific code is compiled with per-function target attributes (VPU_HAL_TARGET), so the
+// rest of the library keeps the baseline ISA. Callers must check cpu_supports() before running it.
+#if defined(__x86_64__) || defined(_M_X64)
+#define VPU_HAL_HAS_X86_SIMD 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define VPU_HAL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define VPU_HAL_TARGET(isa)
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define VPU_HAL_HAS_NEON 1
+#include <arm_neon.h>
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace VPU {
+namespace HAL {
+
+// A non-owning view of a contiguous buffer (pointer + element count).
+// A minimal stand-in for C++20 std::span: kernels operate directly on the caller's memory
+// instead of staging it through std::vector copies.
+template <typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = typename std::remove_cv<T>::type;
+
+    Span() = default;
+    Span(T* data, size_t size) : data_(data), size_(size) {}
+
+    // Views of vectors (a std::vector<float> converts to Span<float> or Span<const float>).
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+    Span(std::vector<U>& v) : data_(v.data()), size_(v.size()) {}
+    template <typename U, typename = typename std::enable_if<std::is_convertible<const U(*)[], T(*)[]>::value>::type>
+    Span(const std::vector<U>& v) : data_(v.data()), size_(v.size()) {}
+
+    // Span<float> -> Span<const float>
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+    Span(const Span<U>& other) : data_(other.data()), size_(other.size()) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t size_bytes() const { return size_ * sizeof(T); }
+    bool empty() const { return size_ == 0; }
+
+    T& operator[](size_t i) const { return data_[i]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+    Span subspan(size_t offset, size_t count) const { return Span(data_ + offset, count); }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Typed views over the VPU_Task's untyped data pointers.
+template <typename T>
+Span<const T> as_span(const void* data, size_t count) { return Span<const T>(static_cast<const T*>(data), data ? count : 0); }
+template <typename T>
+Span<T> as_mutable_span(void* data, size_t count) { return Span<T>(static_cast<T*>(data), data ? count : 0); }
+
+} // namespace HAL
+} // namespace VPU
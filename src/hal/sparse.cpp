@@ -0,0 +1,210 @@
+#include "hal/sparse.h"
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <algorithm> // For std::fill, std::min
+
+namespace VPU {
+namespace HAL {
+
+namespace {
+// c_row[0..N) += a * b_row[0..N): unit-stride, so the compiler vectorizes it.
+inline void axpy_row(float a, const float* b_row, float* c_row, int N) {
+    for (int j = 0; j < N; ++j) {
+        c_row[j] += a * b_row[j];
+    }
+}
+} // namespace
+
+CsrMatrix dense_to_csr(Span<const float> dense, int rows, int cols) {
+    CsrMatrix csr;
+    if (rows <= 0 || cols <= 0 || dense.size() < static_cast<size_t>(rows) * cols) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] DENSE_TO_CSR: buffer too small for " << rows << "x" << cols << ".");
+        return csr;
+    }
+    csr.rows = rows;
+    csr.cols = cols;
+    csr.row_ptr.reserve(static_cast<size_t>(rows) + 1);
+    csr.row_ptr.push_back(0);
+    for (int r = 0; r < rows; ++r) {
+        const float* row = dense.data() + static_cast<size_t>(r) * cols;
+        for (int c = 0; c < cols; ++c) {
+            if (row[c] != 0.0f) {
+                csr.col_idx.push_back(c);
+                csr.values.push_back(row[c]);
+            }
+        }
+        csr.row_ptr.push_back(static_cast<int32_t>(csr.values.size()));
+    }
+    return csr;
+}
+
+BsrMatrix dense_to_bsr(Span<const float> dense, int rows, int cols, int block_rows, int block_cols) {
+    BsrMatrix bsr;
+    if (rows <= 0 || cols <= 0 || block_rows <= 0 || block_cols <= 0 || dense.size() < static_cast<size_t>(rows) * cols) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] DENSE_TO_BSR: invalid shape " << rows << "x" << cols
+                  << " with blocks " << block_rows << "x" << block_cols << ".");
+        return bsr;
+    }
+    bsr.rows = rows;
+    bsr.cols = cols;
+    bsr.block_rows = block_rows;
+    bsr.block_cols = block_cols;
+    const int num_block_rows = (rows + block_rows - 1) / block_rows;
+    const int num_block_cols = (cols + block_cols - 1) / block_cols;
+    const size_t block_size = static_cast<size_t>(block_rows) * block_cols;
+    bsr.block_row_ptr.reserve(static_cast<size_t>(num_block_rows) + 1);
+    bsr.block_row_ptr.push_back(0);
+
+    for (int br = 0; br < num_block_rows; ++br) {
+        const int r0 = br * block_rows;
+        const int r_end = std::min(rows, r0 + block_rows);
+        for (int bc = 0; bc < num_block_cols; ++bc) {
+            const int c0 = bc * block_cols;
+            const int c_end = std::min(cols, c0 + block_cols);
+            bool any_nonzero = false;
+            for (int r = r0; r < r_end && !any_nonzero; ++r) {
+                for (int c = c0; c < c_end; ++c) {
+                    if (dense[static_cast<size_t>(r) * cols + c] != 0.0f) { any_nonzero = true; break; }
+                }
+            }
+            if (!any_nonzero) continue;
+
+            bsr.block_col_idx.push_back(bc);
+            const size_t offset = bsr.values.size();
+            bsr.values.resize(offset + block_size, 0.0f);
+            for (int r = r0; r < r_end; ++r) {
+                for (int c = c0; c < c_end; ++c) {
+                    bsr.values[offset + static_cast<size_t>(r - r0) * block_cols + (c - c0)] = dense[static_cast<size_t>(r) * cols + c];
+                }
+            }
+        }
+        bsr.block_row_ptr.push_back(static_cast<int32_t>(bsr.block_col_idx.size()));
+    }
+    return bsr;
+}
+
+bool validate_csr(const CsrView& A) {
+    if (A.rows < 0 || A.cols < 0 || !A.row_ptr || A.row_ptr[0] != 0) return false;
+    if (A.nnz() > 0 && (!A.col_idx || !A.values)) return false;
+    for (int r = 0; r < A.rows; ++r) {
+        if (A.row_ptr[r + 1] < A.row_ptr[r]) return false;
+        for (int32_t p = A.row_ptr[r]; p < A.row_ptr[r + 1]; ++p) {
+            if (A.col_idx[p] < 0 || A.col_idx[p] >= A.cols) return false;
+        }
+    }
+    return true;
+}
+
+bool cpu_spmm_csr(const CsrView& A, Span<const float> B, Span<float> C, int N) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing CSR SpMM (" << A.nnz() << " non-zeros).");
+    if (A.empty() || N < 0 || B.size() < static_cast<size_t>(A.cols) * N || C.size() < static_cast<size_t>(A.rows) * N) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] SPMM_CSR: invalid operands for " << A.rows << "x" << A.cols << " * " << A.cols << "x" << N << ".");
+        return false;
+    }
+    for (int r = 0; r < A.rows; ++r) {
+        float* c_row = C.data() + static_cast<size_t>(r) * N;
+        std::fill(c_row, c_row + N, 0.0f);
+        // Each non-zero A[r][k] scales row k of B into row r of C.
+        for (int32_t p = A.row_ptr[r]; p < A.row_ptr[r + 1]; ++p) {
+            axpy_row(A.values[p], B.data() + static_cast<size_t>(A.col_idx[p]) * N, c_row, N);
+        }
+    }
+    return true;
+}
+
+bool cpu_spmm_bsr(const BsrMatrix& A, Span<const float> B, Span<float> C, int N) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing BSR SpMM (" << A.num_blocks() << " " << A.block_rows << "x" << A.block_cols << " blocks).");
+    if (A.block_row_ptr.empty() || N < 0 || B.size() < static_cast<size_t>(A.cols) * N || C.size() < static_cast<size_t>(A.rows) * N) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] SPMM_BSR: invalid operands for " << A.rows << "x" << A.cols << " * " << A.cols << "x" << N << ".");
+        return false;
+    }
+    std::fill(C.begin(), C.begin() + static_cast<size_t>(A.rows) * N, 0.0f);
+    const size_t block_size = static_cast<size_t>(A.block_rows) * A.block_cols;
+    const int num_block_rows = static_cast<int>(A.block_row_ptr.size()) - 1;
+    for (int br = 0; br < num_block_rows; ++br) {
+        const int r0 = br * A.block_rows;
+        const int r_count = std::min(A.block_rows, A.rows - r0);
+        for (int32_t b = A.block_row_ptr[br]; b < A.block_row_ptr[br + 1]; ++b) {
+            const int c0 = A.block_col_idx[b] * A.block_cols;
+            const int c_count = std::min(A.block_cols, A.cols - c0);
+            const float* block = A.values.data() + static_cast<size_t>(b) * block_size;
+            for (int r = 0; r < r_count; ++r) {
+                float* c_row = C.data() + static_cast<size_t>(r0 + r) * N;
+                for (int c = 0; c < c_count; ++c) {
+                    const float a = block[static_cast<size_t>(r) * A.block_cols + c];
+                    if (a != 0.0f) { // Padding and in-block zeros
+                        axpy_row(a, B.data() + static_cast<size_t>(c0 + c) * N, c_row, N);
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+namespace {
+bool fused_gemm_operands_ok(const char* name, Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K) {
+    if (M <= 0 || N < 0 || K <= 0 || A.size() < static_cast<size_t>(M) * K ||
+        B.size() < static_cast<size_t>(K) * N || C.size() < static_cast<size_t>(M) * N) {
+        VPU_LOG_WARN("    -> [HAL KERNEL] " << name << ": invalid operands for " << M << "x" << K << " * " << K << "x" << N << ".");
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+bool cpu_gemm_skip_zeros(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K, uint64_t* stored_values) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing fused DENSE_TO_CSR + SPMM_CSR (single pass over A).");
+    if (!fused_gemm_operands_ok("FUSED_DENSE_TO_CSR_SPMM_CSR", A, B, C, M, N, K)) return false;
+    uint64_t nnz = 0;
+    for (int r = 0; r < M; ++r) {
+        const float* a_row = A.data() + static_cast<size_t>(r) * K;
+        float* c_row = C.data() + static_cast<size_t>(r) * N;
+        std::fill(c_row, c_row + N, 0.0f);
+        for (int k = 0; k < K; ++k) {
+            if (a_row[k] != 0.0f) {
+                axpy_row(a_row[k], B.data() + static_cast<size_t>(k) * N, c_row, N);
+                ++nnz;
+            }
+        }
+    }
+    if (stored_values) *stored_values = nnz;
+    return true;
+}
+
+bool cpu_gemm_skip_zero_blocks(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K,
+                               int block_rows, int block_cols, uint64_t* stored_values) {
+    VPU_LOG_TRACE("    -> [HAL KERNEL] Executing fused DENSE_TO_BSR + SPMM_BSR (single pass over A).");
+    if (block_rows <= 0 || block_cols <= 0 || !fused_gemm_operands_ok("FUSED_DENSE_TO_BSR_SPMM_BSR", A, B, C, M, N, K)) return false;
+    std::fill(C.begin(), C.begin() + static_cast<size_t>(M) * N, 0.0f);
+    uint64_t blocks = 0;
+    // Same traversal as cpu_spmm_bsr (block columns ascending, then rows and columns within
+    // the block), so each C element accumulates in the same order.
+    for (int r0 = 0; r0 < M; r0 += block_rows) {
+        const int r_end = std::min(M, r0 + block_rows);
+        for (int c0 = 0; c0 < K; c0 += block_cols) {
+            const int c_end = std::min(K, c0 + block_cols);
+            bool any_nonzero = false;
+            for (int r = r0; r < r_end && !any_nonzero; ++r) {
+                for (int c = c0; c < c_end; ++c) {
+                    if (A[static_cast<size_t>(r) * K + c] != 0.0f) { any_nonzero = true; break; }
+                }
+            }
+            if (!any_nonzero) continue;
+            ++blocks;
+            for (int r = r0; r < r_end; ++r) {
+                float* c_row = C.data() + static_cast<size_t>(r) * N;
+                for (int c = c0; c < c_end; ++c) {
+                    const float a = A[static_cast<size_t>(r) * K + c];
+                    if (a != 0.0f) {
+                        axpy_row(a, B.data() + static_cast<size_t>(c) * N, c_row, N);
+                    }
+                }
+            }
+        }
+    }
+    if (stored_values) *stored_values = blocks * static_cast<uint64_t>(block_rows) * block_cols;
+    return true;
+}
+
+} // namespace HAL
+} // namespace VPU
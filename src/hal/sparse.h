@@ -0,0 +1,82 @@
+#pragma once
+
+#include "hal/span.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VPU {
+namespace HAL {
+
+// Non-owning view of a CSR (compressed sparse row) matrix. The non-zeros of row r are
+// values[row_ptr[r] .. row_ptr[r+1]) in columns col_idx[row_ptr[r] .. row_ptr[r+1]).
+// row_ptr holds rows + 1 entries. This is the form callers use to hand pre-encoded
+// sparse operands to the VPU (see VPU_Task::sparse_a).
+struct CsrView {
+    int rows = 0;
+    int cols = 0;
+    const int32_t* row_ptr = nullptr;
+    const int32_t* col_idx = nullptr;
+    const float* values = nullptr;
+
+    bool empty() const { return row_ptr == nullptr; }
+    size_t nnz() const { return (row_ptr && rows > 0) ? static_cast<size_t>(row_ptr[rows]) : 0; }
+};
+
+// Owning CSR matrix, as produced by dense_to_csr().
+struct CsrMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<int32_t> row_ptr;
+    std::vector<int32_t> col_idx;
+    std::vector<float> values;
+
+    size_t nnz() const { return values.size(); }
+    CsrView view() const { return CsrView{rows, cols, row_ptr.data(), col_idx.data(), values.data()}; }
+};
+
+// Owning BSR (block sparse row) matrix: CSR over dense block_rows x block_cols blocks.
+// Block b covers rows [br * block_rows, ...) and columns [block_col_idx[b] * block_cols, ...),
+// stored row-major at values[b * block_rows * block_cols]. Edge blocks are zero-padded.
+// Suits pruned weights whose zeros come in structured groups: one index per block instead of per value.
+struct BsrMatrix {
+    int rows = 0;
+    int cols = 0;
+    int block_rows = 1;
+    int block_cols = 1;
+    std::vector<int32_t> block_row_ptr; // (rows / block_rows, rounded up) + 1 entries
+    std::vector<int32_t> block_col_idx;
+    std::vector<float> values;
+
+    size_t num_blocks() const { return block_col_idx.size(); }
+};
+
+// Tile size of the VPU's BSR path: matches common structured-pruning granularity.
+constexpr int BSR_BLOCK_SIZE = 4;
+
+// Dense (row-major, rows x cols) -> sparse. Exact zeros are dropped; a BSR block is kept
+// if any of its values is non-zero. 'dense' must hold rows * cols values.
+CsrMatrix dense_to_csr(Span<const float> dense, int rows, int cols);
+BsrMatrix dense_to_bsr(Span<const float> dense, int rows, int cols, int block_rows, int block_cols);
+
+// Structural check for caller-supplied CSR data: monotonic row_ptr starting at 0 and
+// in-range column indices. O(rows + nnz).
+bool validate_csr(const CsrView& A);
+
+// SpMM: C = A * B with A sparse (M x K), B dense row-major (K x N) and C dense row-major (M x N).
+// Work is proportional to nnz * N rather than M * K * N. Returns false (and logs) on bad sizes.
+bool cpu_spmm_csr(const CsrView& A, Span<const float> B, Span<float> C, int N);
+bool cpu_spmm_bsr(const BsrMatrix& A, Span<const float> B, Span<float> C, int N);
+
+// Fused conversion + SpMM (Pillar 6): C = A * B with A dense (M x K), multiplying each non-zero
+// of A into C as the scan finds it, so no CSR/BSR encoding is ever written or re-read.
+// Results match dense_to_csr + cpu_spmm_csr (and dense_to_bsr + cpu_spmm_bsr) exactly.
+// 'stored_values' receives what the encoding would have held: non-zeros, or values in
+// non-zero blocks. Returns false (and logs) on bad sizes.
+bool cpu_gemm_skip_zeros(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K,
+                         uint64_t* stored_values = nullptr);
+bool cpu_gemm_skip_zero_blocks(Span<const float> A, Span<const float> B, Span<float> C, int M, int N, int K,
+                               int block_rows, int block_cols, uint64_t* stored_values = nullptr);
+
+} // namespace HAL
+} // namespace VPU
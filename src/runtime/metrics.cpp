@@ -0,0 +1,249 @@
+#include "runtime/metrics.h"
+#include "runtime/trace.h" // For VPU_LOG_*
+#include "httplib.h"       // cpp-httplib
+#include <cmath>   // For std::ceil, std::fabs
+#include <iomanip> // For std::setprecision
+#include <sstream>
+
+namespace VPU {
+namespace Runtime {
+
+// --- Histogram ---
+
+size_t Histogram::bucket_of(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value); // Exact below the first split power of two
+    }
+    const int exponent = 63 - __builtin_clzll(value); // >= SUB_BUCKET_BITS
+    const size_t sub_bucket = static_cast<size_t>(value >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+    return static_cast<size_t>(exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub_bucket;
+}
+
+uint64_t Histogram::bucket_upper_bound(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    const int shift = static_cast<int>(bucket / SUB_BUCKETS) - 1; // exponent - SUB_BUCKET_BITS
+    const uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void Histogram::record(uint64_t value) {
+    // The bucket is counted last (release), so a snapshot that sees it also sees the totals.
+    uint64_t seen = min_.load(std::memory_order_relaxed);
+    while (value < seen && !min_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+    seen = max_.load(std::memory_order_relaxed);
+    while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    buckets_[bucket_of(value)].fetch_add(1, std::memory_order_release);
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    // Taken while other threads record: the count is summed from the buckets read, so the
+    // percentiles agree with it; sum, min and max may already include a value recorded meanwhile.
+    HistogramSnapshot snapshot;
+    snapshot.buckets.resize(BUCKET_COUNT);
+    size_t used = 0;
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        snapshot.buckets[bucket] = buckets_[bucket].load(std::memory_order_acquire);
+        if (snapshot.buckets[bucket] != 0) {
+            snapshot.count += snapshot.buckets[bucket];
+            used = bucket + 1;
+        }
+    }
+    snapshot.buckets.resize(used);
+    if (snapshot.count != 0) {
+        snapshot.sum = sum_.load(std::memory_order_relaxed);
+        snapshot.min = min_.load(std::memory_order_relaxed);
+        snapshot.max = max_.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+uint64_t HistogramSnapshot::percentile(double percent) const {
+    if (count == 0) {
+        return 0;
+    }
+    const double clamped = percent < 0.0 ? 0.0 : (percent > 100.0 ? 100.0 : percent);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count)));
+    rank = rank == 0 ? 1 : rank;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            const uint64_t bound = Histogram::bucket_upper_bound(bucket);
+            return max != 0 && bound > max ? max : bound;
+        }
+    }
+    return max;
+}
+
+// --- CycleMetrics ---
+
+const char* cycle_stage_name(CycleStage stage) {
+    switch (stage) {
+        case CycleStage::SYNAPSE: return "synapse";
+        case CycleStage::CORTEX: return "cortex";
+        case CycleStage::ORCHESTRATOR: return "orchestrator";
+        case CycleStage::CEREBELLUM: return "cerebellum";
+        case CycleStage::FEEDBACK: return "feedback";
+        case CycleStage::TASK_GRAPH: return "task_graph";
+        default: return "unknown";
+    }
+}
+
+void CycleMetrics::record_task(const std::string& plan_name, bool explored, bool fused) {
+    tasks_.fetch_add(1, std::memory_order_relaxed);
+    if (explored) explorations_.fetch_add(1, std::memory_order_relaxed);
+    if (fused) fusion_hits_.fetch_add(1, std::memory_order_relaxed);
+    plan_choices_[plan_name].fetch_add(1, std::memory_order_relaxed);
+}
+
+void CycleMetrics::record_jit_lookup(bool hit) {
+    (hit ? jit_cache_hits_ : jit_cache_misses_).fetch_add(1, std::memory_order_relaxed);
+}
+
+void CycleMetrics::record_prediction(const std::string& op_name, double predicted_ns, double observed_ns) {
+    if (!(predicted_ns > 0.0) || !(observed_ns >= 0.0)) {
+        return;
+    }
+    const double error = std::fabs(observed_ns - predicted_ns) / predicted_ns * MetricsSnapshot::PREDICTION_ERROR_SCALE;
+    prediction_error_[op_name].record(error < 1.8e19 ? static_cast<uint64_t>(error + 0.5) : UINT64_MAX);
+}
+
+MetricsSnapshot CycleMetrics::snapshot() const {
+    MetricsSnapshot snapshot;
+    for (size_t stage = 0; stage < stage_latency_ns_.size(); ++stage) {
+        snapshot.stage_latency_ns[stage] = stage_latency_ns_[stage].snapshot();
+    }
+    snapshot.tasks = tasks_.load(std::memory_order_relaxed);
+    snapshot.explorations = explorations_.load(std::memory_order_relaxed);
+    snapshot.jit_cache_hits = jit_cache_hits_.load(std::memory_order_relaxed);
+    snapshot.jit_cache_misses = jit_cache_misses_.load(std::memory_order_relaxed);
+    snapshot.fusion_hits = fusion_hits_.load(std::memory_order_relaxed);
+    plan_choices_.for_each([&](const std::string& plan, const std::atomic<uint64_t>& count) {
+        snapshot.plan_choices[plan] = count.load(std::memory_order_relaxed);
+    });
+    prediction_error_.for_each([&](const std::string& op, const Histogram& errors) {
+        snapshot.prediction_error[op] = errors.snapshot();
+    });
+    return snapshot;
+}
+
+// --- Prometheus text format ---
+
+namespace {
+
+std::string escape_label(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+// One summary series: quantiles, _sum and _count, with values scaled by 1/'divisor'.
+void write_summary(std::ostream& out, const char* name, const std::string& labels, const HistogramSnapshot& histogram,
+                   double divisor) {
+    static const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+    for (double quantile : QUANTILES) {
+        out << name << "{" << labels << ",quantile=\"" << quantile << "\"} "
+            << static_cast<double>(histogram.percentile(quantile * 100.0)) / divisor << "\n";
+    }
+    out << name << "_sum{" << labels << "} " << static_cast<double>(histogram.sum) / divisor << "\n";
+    out << name << "_count{" << labels << "} " << histogram.count << "\n";
+}
+
+void write_counter(std::ostream& out, const char* name, const char* help, uint64_t value) {
+    out << "# HELP " << name << " " << help << "\n# TYPE " << name << " counter\n" << name << " " << value << "\n";
+}
+
+} // namespace
+
+std::string MetricsSnapshot::to_prometheus() const {
+    std::ostringstream out;
+    out << std::setprecision(9);
+
+    out << "# HELP vpu_stage_latency_seconds Wall-clock time of each cognitive cycle stage per task.\n"
+        << "# TYPE vpu_stage_latency_seconds summary\n";
+    for (size_t stage = 0; stage < stage_latency_ns.size(); ++stage) {
+        const std::string labels = std::string("stage=\"") + cycle_stage_name(static_cast<CycleStage>(stage)) + "\"";
+        write_summary(out, "vpu_stage_latency_seconds", labels, stage_latency_ns[stage], 1e9);
+    }
+
+    write_counter(out, "vpu_tasks_total", "Tasks that completed the cognitive cycle.", tasks);
+    write_counter(out, "vpu_explorations_total", "Tasks that ran a plan other than the predicted best.", explorations);
+    write_counter(out, "vpu_jit_cache_hits_total", "JIT SAXPY steps whose kernel was already generated.", jit_cache_hits);
+    write_counter(out, "vpu_jit_cache_misses_total", "JIT SAXPY steps that generated their kernel.", jit_cache_misses);
+    write_counter(out, "vpu_fusion_hits_total", "Tasks whose plan ran a fused step.", fusion_hits);
+
+    out << "# HELP vpu_plan_choices_total Tasks that ran each plan.\n# TYPE vpu_plan_choices_total counter\n";
+    for (const auto& plan : plan_choices) {
+        out << "vpu_plan_choices_total{plan=\"" << escape_label(plan.first) << "\"} " << plan.second << "\n";
+    }
+
+    out << "# HELP vpu_prediction_error_ratio |observed - predicted| / predicted latency per operation.\n"
+        << "# TYPE vpu_prediction_error_ratio summary\n";
+    for (const auto& op : prediction_error) {
+        write_summary(out, "vpu_prediction_error_ratio", "op=\"" + escape_label(op.first) + "\"", op.second,
+                      PREDICTION_ERROR_SCALE);
+    }
+    return out.str();
+}
+
+// --- MetricsEndpoint ---
+
+struct MetricsEndpoint::Server {
+    httplib::Server http;
+};
+
+MetricsEndpoint::MetricsEndpoint() = default;
+
+MetricsEndpoint::~MetricsEndpoint() {
+    stop();
+}
+
+int MetricsEndpoint::start(const std::string& host, int port, Renderer render) {
+    stop();
+    auto server = std::make_unique<Server>();
+    server->http.Get("/metrics", [render](const httplib::Request&, httplib::Response& response) {
+        response.set_content(render(), "text/plain; version=0.0.4");
+    });
+    const int bound = port == 0 ? server->http.bind_to_any_port(host)
+                                : (server->http.bind_to_port(host, port) ? port : -1);
+    if (bound <= 0) {
+        VPU_LOG_WARN("[Metrics] Could not bind the metrics endpoint to " << host << ":" << port << ".");
+        return -1;
+    }
+    server_ = std::move(server);
+    port_ = bound;
+    httplib::Server* http = &server_->http;
+    thread_ = std::thread([http]() { http->listen_after_bind(); });
+    http->wait_until_ready(); // stop() is a no-op until the server is listening
+    VPU_LOG_INFO("[Metrics] Serving Prometheus metrics at http://" << host << ":" << bound << "/metrics.");
+    return bound;
+}
+
+void MetricsEndpoint::stop() {
+    if (server_) {
+        server_->http.stop();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    server_.reset();
+    port_ = -1;
+}
+
+} // namespace Runtime
+} // namespace VPU
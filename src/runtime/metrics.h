@@ -0,0 +1,204 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace VPU {
+namespace Runtime {
+
+// --- Histograms ---
+
+// What Histogram::snapshot() saw: per-bucket counts (trailing empty buckets trimmed) and totals.
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = 0; // 0 while empty
+    uint64_t max = 0;
+    std::vector<uint64_t> buckets; // Indexed like Histogram::bucket_of()
+
+    double mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+    // The value at or below which 'percent' (0-100) of the recorded values fall, to within the
+    // bucket resolution (about 3%). 0 while empty.
+    uint64_t percentile(double percent) const;
+};
+
+// Log-linear (HDR-style) histogram of unsigned integer values over the full 64-bit range:
+// each power of two is split into 32 buckets, so a bucket is at most ~3% wide relative to its
+// values. record() is a handful of atomic operations and never allocates or locks,
+// so any number of threads may record while another takes a snapshot.
+class Histogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static const size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    Histogram() = default;
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    void record(uint64_t value);
+    HistogramSnapshot snapshot() const;
+
+    static size_t bucket_of(uint64_t value);
+    static uint64_t bucket_upper_bound(size_t bucket); // Largest value the bucket holds
+
+private:
+    std::atomic<uint64_t> buckets_[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Metrics keyed by a label value (a plan name, an operation). A label's metric is created on
+// first use and never moves; finding an existing one takes a shared lock only.
+template <typename Metric>
+class LabeledMetrics {
+public:
+    Metric& operator[](const std::string& label) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = metrics_.find(label);
+            if (it != metrics_.end()) {
+                return *it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        std::unique_ptr<Metric>& metric = metrics_[label];
+        if (!metric) {
+            metric.reset(new Metric()); // Value-initialized: counters start at 0
+        }
+        return *metric;
+    }
+
+    // Visits (label, metric) in label order.
+    template <typename Visitor>
+    void for_each(Visitor&& visitor) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (const auto& entry : metrics_) {
+            visitor(entry.first, *entry.second);
+        }
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::map<std::string, std::unique_ptr<Metric>> metrics_;
+};
+
+// --- Cognitive cycle metrics ---
+
+// The stages VPUCore times, in cycle order.
+enum class CycleStage : int {
+    SYNAPSE = 0,  // Pillar 1 intake and validation
+    CORTEX,       // Pillar 2 profiling (or the profile cache lookup)
+    ORCHESTRATOR, // Pillar 3 planning (or the plan cache lookup) and plan choice
+    CEREBELLUM,   // Pillar 4 execution
+    FEEDBACK,     // Pillar 5 learning
+    TASK_GRAPH,   // Pillar 6 plan recording and fusion
+    COUNT
+};
+const char* cycle_stage_name(CycleStage stage); // "synapse", "cortex", ...
+
+// A point-in-time copy of a CycleMetrics (see VPU_Environment::metrics()).
+struct MetricsSnapshot {
+    // Prediction errors are recorded as |observed - predicted| / predicted in these units.
+    static constexpr double PREDICTION_ERROR_SCALE = 1e4; // Basis points
+
+    std::array<HistogramSnapshot, static_cast<size_t>(CycleStage::COUNT)> stage_latency_ns;
+    uint64_t tasks = 0;            // Tasks that completed the cycle (learning included)
+    uint64_t explorations = 0;     // Tasks that ran a plan other than the predicted best
+    uint64_t jit_cache_hits = 0;   // JIT_COMPILE_SAXPY steps whose kernel was already generated
+    uint64_t jit_cache_misses = 0; // JIT_COMPILE_SAXPY steps that generated their kernel
+    uint64_t fusion_hits = 0;      // Tasks whose plan ran a fused step
+    std::map<std::string, uint64_t> plan_choices;               // Executions per plan name
+    std::map<std::string, HistogramSnapshot> prediction_error;  // Per operation, PREDICTION_ERROR_SCALE units
+
+    const HistogramSnapshot& stage(CycleStage stage) const { return stage_latency_ns[static_cast<size_t>(stage)]; }
+
+    // The Prometheus text exposition format (version 0.0.4): stage latencies and prediction
+    // errors as summaries (quantiles 0.5, 0.9, 0.99, 0.999), the rest as counters.
+    std::string to_prometheus() const;
+};
+
+// Per-stage latencies, plan counters and per-operation prediction errors of one VPUCore.
+// Every record_*() is lock-free except the first use of a new plan or operation label.
+class CycleMetrics {
+public:
+    void record_stage(CycleStage stage, uint64_t latency_ns) {
+        stage_latency_ns_[static_cast<size_t>(stage)].record(latency_ns);
+    }
+    // One task's trip through the cycle: the plan it ran and how it was chosen.
+    void record_task(const std::string& plan_name, bool explored, bool fused);
+    void record_jit_lookup(bool hit);
+    // Skipped while the operation has no prediction yet (predicted_ns <= 0).
+    void record_prediction(const std::string& op_name, double predicted_ns, double observed_ns);
+
+    MetricsSnapshot snapshot() const;
+
+private:
+    std::array<Histogram, static_cast<size_t>(CycleStage::COUNT)> stage_latency_ns_;
+    std::atomic<uint64_t> tasks_{0};
+    std::atomic<uint64_t> explorations_{0};
+    std::atomic<uint64_t> jit_cache_hits_{0};
+    std::atomic<uint64_t> jit_cache_misses_{0};
+    std::atomic<uint64_t> fusion_hits_{0};
+    LabeledMetrics<std::atomic<uint64_t>> plan_choices_;
+    LabeledMetrics<Histogram> prediction_error_;
+};
+
+// Records the time from construction to destruction into one stage's histogram.
+class StageTimer {
+public:
+    StageTimer(CycleMetrics& metrics, CycleStage stage)
+        : metrics_(metrics), stage_(stage), begin_(std::chrono::steady_clock::now()) {}
+    ~StageTimer() {
+        const auto elapsed = std::chrono::steady_clock::now() - begin_;
+        metrics_.record_stage(stage_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    CycleMetrics& metrics_;
+    CycleStage stage_;
+    std::chrono::steady_clock::time_point begin_;
+};
+
+// --- Prometheus endpoint ---
+
+// Serves GET /metrics over HTTP (cpp-httplib) on a background thread; each scrape calls
+// 'render' for the response body.
+class MetricsEndpoint {
+public:
+    using Renderer = std::function<std::string()>;
+
+    MetricsEndpoint();
+    ~MetricsEndpoint(); // Stops serving
+
+    MetricsEndpoint(const MetricsEndpoint&) = delete;
+    MetricsEndpoint& operator=(const MetricsEndpoint&) = delete;
+
+    // Binds host:port (port 0 picks a free one) and starts serving, replacing any earlier
+    // binding. Returns the bound port, or -1 if the address could not be bound.
+    int start(const std::string& host, int port, Renderer render);
+    void stop();
+    int port() const { return port_; } // -1 while not serving
+
+private:
+    struct Server; // Keeps httplib out of this header
+    std::unique_ptr<Server> server_;
+    std::thread thread_;
+    int port_ = -1;
+};
+
+} // namespace Runtime
+} // namespace VPU
@@ -0,0 +1,362 @@
+#include "runtime/trace.h"
+#include <algorithm> // For std::sort
+#include <chrono>
+#include <cstdio>
+#include <cstdlib> // For std::getenv, std::atexit
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace VPU {
+namespace Runtime {
+
+namespace detail {
+std::atomic<int> g_log_level{static_cast<int>(LogLevel::INFO)};
+std::atomic<bool> g_tracing{false};
+} // namespace detail
+
+namespace {
+
+// Single-producer (the owning thread), single-consumer (whoever holds the drain mutex) ring.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) : slots_(capacity) {}
+
+    // The slot to fill, or nullptr if the ring is full. Producer only; publish with push().
+    T* producer_slot() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        return head - tail_.load(std::memory_order_acquire) < slots_.size() ? &slots_[head % slots_.size()] : nullptr;
+    }
+    void push() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // The oldest published slot, or nullptr if empty. Consumer only; release with pop().
+    T* consumer_slot() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail != head_.load(std::memory_order_acquire) ? &slots_[tail % slots_.size()] : nullptr;
+    }
+    void pop() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    bool empty() const { return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire); }
+
+private:
+    std::vector<T> slots_;
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+};
+
+struct LogEntry {
+    uint64_t sequence = 0; // Global order across threads
+    LogLevel level = LogLevel::INFO;
+    std::string text;      // Capacity is reused by later messages in the same slot
+};
+
+struct SpanEvent {
+    const char* name = nullptr;
+    uint64_t begin_ns = 0;
+    uint64_t end_ns = 0;
+    uint64_t task_id = 0;
+};
+
+const size_t LOG_RING_CAPACITY = 1024;
+const size_t SPAN_RING_CAPACITY = 1 << 14;
+
+// Per-thread buffers. Owned jointly by the thread and the registry, so messages of a thread
+// that has exited are still written out; the registry forgets them once they are drained.
+struct ThreadBuffers {
+    uint32_t thread_index = 0;
+    SpscRing<LogEntry> logs{LOG_RING_CAPACITY};
+    std::atomic<SpscRing<SpanEvent>*> spans{nullptr}; // Allocated on the thread's first span
+    std::unique_ptr<SpscRing<SpanEvent>> spans_owner;
+    std::atomic<uint64_t> dropped_spans{0};
+    std::atomic<bool> alive{true};
+};
+
+struct Registry {
+    std::mutex mutex; // Guards 'threads' and next_thread_index
+    std::vector<std::shared_ptr<ThreadBuffers>> threads;
+    uint32_t next_thread_index = 1;
+    std::mutex log_drain_mutex;   // The single consumer of every log ring
+    std::mutex span_drain_mutex;  // The single consumer of every span ring
+    std::mutex sink_mutex;
+    LogSink sink;                 // Guarded by sink_mutex; empty: the console
+    std::atomic<uint64_t> next_sequence{0};
+    uint64_t dropped_spans_of_exited_threads = 0; // Guarded by mutex
+
+    std::vector<std::shared_ptr<ThreadBuffers>> snapshot() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return threads;
+    }
+};
+
+// Leaked on purpose: thread-exit and at-exit flushes may run after static destructors.
+Registry& registry() {
+    static Registry* instance = [] {
+        Registry* created = new Registry();
+        std::atexit([] { flush_logs(); });
+        return created;
+    }();
+    return *instance;
+}
+
+struct ThreadHandle {
+    std::shared_ptr<ThreadBuffers> buffers;
+    ThreadHandle() : buffers(std::make_shared<ThreadBuffers>()) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffers->thread_index = reg.next_thread_index++;
+        reg.threads.push_back(buffers);
+    }
+    ~ThreadHandle() { buffers->alive.store(false, std::memory_order_release); }
+};
+
+ThreadBuffers& this_thread_buffers() {
+    thread_local ThreadHandle handle;
+    return *handle.buffers;
+}
+
+const auto g_clock_epoch = std::chrono::steady_clock::now();
+
+// Drops buffers of exited threads once nothing is left in them.
+void forget_exited_threads(Registry& reg) {
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto drained = [&reg](const std::shared_ptr<ThreadBuffers>& buffers) {
+        if (buffers->alive.load(std::memory_order_acquire) || !buffers->logs.empty()) return false;
+        SpscRing<SpanEvent>* spans = buffers->spans.load(std::memory_order_acquire);
+        if (spans && !spans->empty()) return false;
+        reg.dropped_spans_of_exited_threads += buffers->dropped_spans.load(std::memory_order_relaxed);
+        return true;
+    };
+    reg.threads.erase(std::remove_if(reg.threads.begin(), reg.threads.end(), drained), reg.threads.end());
+}
+
+LogLevel parse_log_level(const char* text, LogLevel fallback) {
+    const std::pair<const char*, LogLevel> names[] = {{"trace", LogLevel::TRACE}, {"debug", LogLevel::DEBUG},
+                                                      {"info", LogLevel::INFO},   {"warn", LogLevel::WARN},
+                                                      {"error", LogLevel::ERROR}, {"off", LogLevel::OFF}};
+    for (const auto& name : names) {
+        if (text && std::strcmp(text, name.first) == 0) return name.second;
+    }
+    return fallback;
+}
+
+const bool g_log_level_from_environment = [] {
+    if (const char* level = std::getenv("VPU_LOG_LEVEL")) {
+        set_log_level(parse_log_level(level, log_level()));
+    }
+    return true;
+}();
+
+void append_json_string(std::string& out, const char* text) {
+    out += '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+            out += *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(*c));
+            out += escaped;
+        } else {
+            out += *c;
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+void set_log_level(LogLevel level) {
+    detail::g_log_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel log_level() {
+    return static_cast<LogLevel>(detail::g_log_level.load(std::memory_order_relaxed));
+}
+
+const char* log_level_name(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE: return "TRACE";
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARN: return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::OFF: return "OFF";
+    }
+    return "UNKNOWN";
+}
+
+void set_log_sink(LogSink sink) {
+    flush_logs(); // Buffered messages go to the sink they were logged under
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.sink_mutex);
+    reg.sink = std::move(sink);
+}
+
+void flush_logs() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> drain_lock(reg.log_drain_mutex);
+    std::vector<LogRecord> records;
+    for (const auto& buffers : reg.snapshot()) {
+        while (LogEntry* entry = buffers->logs.consumer_slot()) {
+            records.push_back({entry->sequence, entry->level, buffers->thread_index, entry->text});
+            buffers->logs.pop();
+        }
+    }
+    if (records.empty()) return;
+    std::sort(records.begin(), records.end(),
+              [](const LogRecord& a, const LogRecord& b) { return a.sequence < b.sequence; });
+
+    std::lock_guard<std::mutex> sink_lock(reg.sink_mutex);
+    if (reg.sink) {
+        for (const LogRecord& record : records) reg.sink(record);
+    } else {
+        // One write per run of messages bound for the same stream, one flush per stream.
+        std::string batch;
+        FILE* batch_stream = nullptr;
+        for (const LogRecord& record : records) {
+            FILE* stream = record.level >= LogLevel::WARN ? stderr : stdout;
+            if (stream != batch_stream && !batch.empty()) {
+                std::fwrite(batch.data(), 1, batch.size(), batch_stream);
+                batch.clear();
+            }
+            batch_stream = stream;
+            batch += record.text;
+            batch += '\n';
+        }
+        std::fwrite(batch.data(), 1, batch.size(), batch_stream);
+        std::fflush(stdout);
+        std::fflush(stderr);
+    }
+    forget_exited_threads(reg);
+}
+
+// --- LogLine ---
+namespace {
+struct FormatStream {
+    std::ostringstream stream;
+    bool in_use = false;
+};
+FormatStream& this_thread_format_stream() {
+    thread_local FormatStream format;
+    return format;
+}
+} // namespace
+
+LogLine::LogLine(LogLevel level) : level_(level) {
+    FormatStream& format = this_thread_format_stream();
+    nested_ = format.in_use; // An argument of this message logged something itself
+    if (nested_) {
+        stream_ = new std::ostringstream();
+    } else {
+        format.in_use = true;
+        format.stream.str(std::string());
+        format.stream.clear();
+        // Manipulators (std::fixed, std::setprecision, ...) apply to one message only.
+        format.stream.flags(std::ios_base::dec | std::ios_base::skipws);
+        format.stream.precision(6);
+        format.stream.fill(' ');
+        stream_ = &format.stream;
+    }
+}
+
+LogLine::~LogLine() {
+    ThreadBuffers& buffers = this_thread_buffers();
+    LogEntry* entry = buffers.logs.producer_slot();
+    if (!entry) {
+        flush_logs(); // Ring full: drain every thread's messages, then retry
+        entry = buffers.logs.producer_slot();
+    }
+    if (entry) {
+        entry->sequence = registry().next_sequence.fetch_add(1, std::memory_order_relaxed);
+        entry->level = level_;
+        entry->text = stream_->str();
+        buffers.logs.push();
+    }
+    if (nested_) {
+        delete stream_;
+    } else {
+        this_thread_format_stream().in_use = false;
+    }
+    if (level_ >= LogLevel::INFO) {
+        flush_logs(); // Console-level messages appear in order with the caller's own output
+    }
+}
+
+// --- Tracing ---
+void start_tracing() { detail::g_tracing.store(true, std::memory_order_relaxed); }
+void stop_tracing() { detail::g_tracing.store(false, std::memory_order_relaxed); }
+bool tracing_enabled() { return detail::g_tracing.load(std::memory_order_relaxed); }
+
+namespace detail {
+
+uint64_t trace_clock_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_clock_epoch).count());
+}
+
+void record_span(const char* name, uint64_t begin_ns, uint64_t end_ns, uint64_t task_id) {
+    ThreadBuffers& buffers = this_thread_buffers();
+    SpscRing<SpanEvent>* spans = buffers.spans.load(std::memory_order_relaxed);
+    if (!spans) {
+        buffers.spans_owner.reset(new SpscRing<SpanEvent>(SPAN_RING_CAPACITY));
+        spans = buffers.spans_owner.get();
+        buffers.spans.store(spans, std::memory_order_release);
+    }
+    SpanEvent* event = spans->producer_slot();
+    if (!event) {
+        buffers.dropped_spans.fetch_add(1, std::memory_order_relaxed); // Exported too rarely; keep the oldest
+        return;
+    }
+    *event = {name, begin_ns, end_ns, task_id};
+    spans->push();
+}
+
+} // namespace detail
+
+bool write_chrome_trace(const std::string& path) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> drain_lock(reg.span_drain_mutex);
+    std::string json = "{\"traceEvents\":[";
+    bool first = true;
+    uint64_t dropped = 0;
+    char number[128];
+    for (const auto& buffers : reg.snapshot()) {
+        dropped += buffers->dropped_spans.exchange(0, std::memory_order_relaxed);
+        SpscRing<SpanEvent>* spans = buffers->spans.load(std::memory_order_acquire);
+        if (!spans || spans->empty()) continue;
+        std::snprintf(number, sizeof(number),
+                      "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"vpu-thread-%u\"}}",
+                      first ? "" : ",", buffers->thread_index, buffers->thread_index);
+        json += number;
+        first = false;
+        while (SpanEvent* event = spans->consumer_slot()) {
+            json += ",{\"name\":";
+            append_json_string(json, event->name);
+            // Chrome trace timestamps are microseconds; keep nanosecond resolution as decimals.
+            std::snprintf(number, sizeof(number),
+                          ",\"cat\":\"vpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"task_id\":%llu}}",
+                          buffers->thread_index, event->begin_ns / 1000.0, (event->end_ns - event->begin_ns) / 1000.0,
+                          static_cast<unsigned long long>(event->task_id));
+            json += number;
+            spans->pop();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        dropped += reg.dropped_spans_of_exited_threads;
+        reg.dropped_spans_of_exited_threads = 0;
+    }
+    std::snprintf(number, sizeof(number), "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_spans\":\"%llu\"}}\n",
+                  static_cast<unsigned long long>(dropped));
+    json += number;
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    const bool written = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    return std::fclose(file) == 0 && written;
+}
+
+} // namespace Runtime
+} // namespace VPU
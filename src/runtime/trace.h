@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <string>
+
+namespace VPU {
+namespace Runtime {
+
+// --- Level-gated logging ---
+// Messages below the runtime level cost one relaxed atomic load: their arguments are never
+// evaluated. Enabled messages are formatted on the calling thread into a per-thread ring and
+// written out in batches (one write and flush per batch instead of one per line). INFO and
+// above are written out before the call returns, so console output keeps its order.
+enum class LogLevel : int { TRACE = 0, DEBUG = 1, INFO = 2, WARN = 3, ERROR = 4, OFF = 5 };
+
+// Levels below this are compiled out entirely (e.g. -DVPU_LOG_COMPILE_LEVEL=2 keeps INFO and above).
+#ifndef VPU_LOG_COMPILE_LEVEL
+#define VPU_LOG_COMPILE_LEVEL 0
+#endif
+
+// The runtime level starts at INFO (per-task chatter is DEBUG/TRACE), or at $VPU_LOG_LEVEL
+// ("trace", "debug", "info", "warn", "error", "off") if set.
+void set_log_level(LogLevel level);
+LogLevel log_level();
+const char* log_level_name(LogLevel level);
+
+namespace detail {
+extern std::atomic<int> g_log_level;
+} // namespace detail
+
+inline bool log_enabled(LogLevel level) {
+    return static_cast<int>(level) >= detail::g_log_level.load(std::memory_order_relaxed);
+}
+
+// Writes out every buffered message (all threads). Called automatically when a thread's ring
+// fills, after INFO and above messages and at shutdown.
+void flush_logs();
+
+// A message as written out: 'text' has no trailing newline. 'thread' numbers threads from 1.
+struct LogRecord {
+    uint64_t sequence = 0;
+    LogLevel level = LogLevel::INFO;
+    uint32_t thread = 0;
+    std::string text;
+};
+using LogSink = std::function<void(const LogRecord&)>;
+// Replaces the console (stdout; stderr for WARN and above). An empty sink restores it.
+// Sinks are called in message order, one at a time, and must not log themselves.
+void set_log_sink(LogSink sink);
+
+// One message under construction; committed to the calling thread's ring on destruction.
+class LogLine {
+public:
+    explicit LogLine(LogLevel level);
+    ~LogLine();
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+    std::ostream& stream() { return *stream_; }
+
+private:
+    LogLevel level_;
+    std::ostringstream* stream_; // Thread-local and reused; a nested message gets its own
+    bool nested_;
+};
+
+// --- Stage spans (Chrome trace / Perfetto) ---
+// While tracing is enabled, each TraceSpan records one complete event ("ph":"X") into the
+// calling thread's trace ring; otherwise constructing one costs a relaxed atomic load.
+void start_tracing();
+void stop_tracing();
+bool tracing_enabled();
+
+namespace detail {
+extern std::atomic<bool> g_tracing;
+uint64_t trace_clock_ns();
+void record_span(const char* name, uint64_t begin_ns, uint64_t end_ns, uint64_t task_id);
+} // namespace detail
+
+// 'name' must outlive the trace (use string literals). 'task_id' is attached as an argument.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, uint64_t task_id = 0)
+        : name_(detail::g_tracing.load(std::memory_order_relaxed) ? name : nullptr), task_id_(task_id),
+          begin_ns_(name_ ? detail::trace_clock_ns() : 0) {}
+    ~TraceSpan() {
+        if (name_) detail::record_span(name_, begin_ns_, detail::trace_clock_ns(), task_id_);
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    uint64_t task_id_;
+    uint64_t begin_ns_;
+};
+
+// Drains the recorded spans of all threads into a Chrome trace JSON file (loadable in
+// chrome://tracing and ui.perfetto.dev). Returns false if the file cannot be written.
+// Spans recorded while a thread's ring was full are dropped and counted in the file's metadata.
+bool write_chrome_trace(const std::string& path);
+
+} // namespace Runtime
+} // namespace VPU
+
+// Usage: VPU_LOG_DEBUG("[Pillar 3] Planning for " << task_type);
+#define VPU_LOG(level, message)                                                                        \
+    do {                                                                                               \
+        if (static_cast<int>(level) >= VPU_LOG_COMPILE_LEVEL && ::VPU::Runtime::log_enabled(level)) { \
+            ::VPU::Runtime::LogLine vpu_log_line_(level);                                              \
+            vpu_log_line_.stream() << message;                                                         \
+        }                                                                                              \
+    } while (0)
+#define VPU_LOG_TRACE(message) VPU_LOG(::VPU::Runtime::LogLevel::TRACE, message)
+#define VPU_LOG_DEBUG(message) VPU_LOG(::VPU::Runtime::LogLevel::DEBUG, message)
+#define VPU_LOG_INFO(message) VPU_LOG(::VPU::Runtime::LogLevel::INFO, message)
+#define VPU_LOG_WARN(message) VPU_LOG(::VPU::Runtime::LogLevel::WARN, message)
+#define VPU_LOG_ERROR(message) VPU_LOG(::VPU::Runtime::LogLevel::ERROR, message)
@@ -0,0 +1,119 @@
+#include "runtime/work_stealing_pool.h"
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <exception>
+
+namespace VPU {
+namespace Runtime {
+
+namespace {
+// The pool (and deque) the current thread works for, if any.
+thread_local const WorkStealingPool* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t num_workers) {
+    if (num_workers == 0) {
+        num_workers = std::thread::hardware_concurrency();
+        if (num_workers == 0) num_workers = 2; // hardware_concurrency() may be unknown
+    }
+    queues_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_.emplace_back(&WorkStealingPool::worker_loop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    shutdown();
+}
+
+bool WorkStealingPool::submit(Job job) {
+    const bool from_worker = current_pool == this;
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        if (stopping_ && !from_worker) {
+            return false;
+        }
+        // Counted before the push (so it never underflows); a worker that sees the count
+        // before the job lands just retries.
+        pending_.fetch_add(1, std::memory_order_release);
+    }
+    const size_t target = from_worker ? current_worker
+                                      : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->jobs.push_back(std::move(job));
+    }
+    wake_cv_.notify_one();
+    return true;
+}
+
+void WorkStealingPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+bool WorkStealingPool::try_pop_local(size_t self, Job& out) {
+    WorkerQueue& queue = *queues_[self];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) {
+        return false;
+    }
+    out = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::try_steal(size_t self, Job& out) {
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkerQueue& victim = *queues_[(self + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            out = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::worker_loop(size_t self) {
+    current_pool = this;
+    current_worker = self;
+    Job job;
+    for (;;) {
+        if (try_pop_local(self, job) || try_steal(self, job)) {
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+            try {
+                job();
+            } catch (const std::exception& e) {
+                // Jobs are expected to report their own errors; never let one terminate a worker.
+                VPU_LOG_WARN("[WorkStealingPool] Job threw an unhandled exception: " << e.what());
+            } catch (...) {
+                VPU_LOG_WARN("[WorkStealingPool] Job threw an unhandled non-standard exception.");
+            }
+            job = nullptr; // Release captured state before looking for the next job
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait(lock, [this] { return stopping_ || pending_.load(std::memory_order_acquire) > 0; });
+        if (stopping_ && pending_.load(std::memory_order_acquire) == 0) {
+            return; // Jobs still running may queue successors, but only onto their own worker's deque
+        }
+    }
+}
+
+} // namespace Runtime
+} // namespace VPU
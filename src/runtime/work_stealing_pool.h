@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VPU {
+namespace Runtime {
+
+// A pool of worker threads with one job deque each. A job submitted from one of the pool's
+// own workers goes onto that worker's deque and runs next (LIFO, so a task's successors run
+// while its outputs are still in cache); other submissions are spread round-robin. Idle
+// workers steal the oldest job from the other deques. Unbounded: use it for jobs whose
+// number is already bounded by the caller (e.g. the nodes of a task graph).
+class WorkStealingPool {
+public:
+    using Job = std::function<void()>;
+
+    // num_workers == 0 selects std::thread::hardware_concurrency().
+    explicit WorkStealingPool(size_t num_workers);
+    ~WorkStealingPool(); // Drains already-queued jobs, then joins all workers.
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Returns false if the pool is shutting down (jobs queued by running jobs are still accepted).
+    bool submit(Job job);
+
+    // Stops accepting external jobs, runs everything already queued, and joins the workers.
+    void shutdown();
+
+    size_t worker_count() const { return workers_.size(); }
+    uint64_t steal_count() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs; // Owner pops the back, thieves take the front
+    };
+
+    bool try_pop_local(size_t self, Job& out);
+    bool try_steal(size_t self, Job& out);
+    void worker_loop(size_t self);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<size_t> pending_{0}; // Submitted jobs not yet taken; incremented under wake_mutex_
+    bool stopping_ = false;          // Guarded by wake_mutex_
+
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<uint64_t> steals_{0};
+};
+
+} // namespace Runtime
+} // namespace VPU
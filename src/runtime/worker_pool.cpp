@@ -0,0 +1,53 @@
+#include "runtime/worker_pool.h"
+#include "runtime/trace.h" // For VPU_LOG_*
+#include <exception>
+
+namespace VPU {
+namespace Runtime {
+
+WorkerPool::WorkerPool(size_t num_workers, size_t queue_capacity) : queue_(queue_capacity) {
+    if (num_workers == 0) {
+        num_workers = std::thread::hardware_concurrency();
+        if (num_workers == 0) num_workers = 2; // hardware_concurrency() may be unknown
+    }
+    workers_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_.emplace_back(&WorkerPool::worker_loop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    shutdown();
+}
+
+bool WorkerPool::submit(Job job) {
+    return queue_.push(std::move(job));
+}
+
+void WorkerPool::shutdown() {
+    queue_.close();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void WorkerPool::worker_loop() {
+    Job job;
+    while (queue_.pop(job)) {
+        try {
+            job();
+        } catch (const std::exception& e) {
+            // Jobs are expected to report their own errors (e.g., via std::promise).
+            // Never let an escaped exception terminate a worker thread.
+            VPU_LOG_WARN("[WorkerPool] Job threw an unhandled exception: " << e.what());
+        } catch (...) {
+            VPU_LOG_WARN("[WorkerPool] Job threw an unhandled non-standard exception.");
+        }
+        job = nullptr; // Release captured state before blocking on the next pop
+    }
+}
+
+} // namespace Runtime
+} // namespace VPU
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "runtime/bounded_queue.h"
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace VPU {
+namespace Runtime {
+
+// A fixed-size pool of worker threads draining a shared BoundedQueue of jobs.
+class WorkerPool {
+public:
+    using Job = std::function<void()>;
+
+    // num_workers == 0 selects std::thread::hardware_concurrency().
+    WorkerPool(size_t num_workers, size_t queue_capacity);
+    ~WorkerPool(); // Drains already-queued jobs, then joins all workers.
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Blocks while the queue is full. Returns false if the pool is shutting down.
+    bool submit(Job job);
+
+    // Stops accepting jobs, runs everything already queued, and joins the workers.
+    void shutdown();
+
+    size_t worker_count() const { return workers_.size(); }
+    size_t pending_jobs() const { return queue_.size(); }
+
+private:
+    void worker_loop();
+
+    BoundedQueue<Job> queue_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace Runtime
+} // namespace VPU
@@ -1,42 +1,211 @@
 #include "vpu_core.h"
+#include "hal/hal_utils.h" // For VPU::HAL::calculate_data_hamming_weight
+#include "hal/buffer_stats.h" // For HAL::hamming_weight_reusing
+#include "hal/hal.h"       // For VPU::HAL::cpu_saxpy etc. (already included via vpu_core.h usually)
+#include "hal/fft_plan_cache.h" // For FFT planning configuration
+#include "hal/cpu_features.h"   // For SIMD kernel registration
+#include "hal/scratch_arena.h"  // For kernel staging buffers
+#include "hal/convolution.h"    // For the CONVOLUTION kernels
+#include "core/FusionLibrary.h"  // For learning fused steps
+#include "core/SizeModel.h"      // For problem shapes
+#include "core/TaskDescriptor.h" // For resolved_op, input_element_type
+#include "core/TaskStream.h"     // For streamed tasks
+#include "hal/dtype.h"           // For the dtype-specialized kernels
+#include "runtime/trace.h" // For VPU_LOG_*
 #include <iostream>
 #include <string>
 #include <vector>
 #include <memory>
+#include <cmath> // For std::log2
+#include <stdexcept> // For std::runtime_error
+#include <algorithm> // For std::max
+#include <thread>    // For std::thread::hardware_concurrency
+#include <cstdlib>   // For std::getenv ($VPU_BELIEFS_FILE)
 
 // Ensure Pillar1_Synapse.h is included via vpu_core.h or directly if needed.
 // It should be included by vpu_core.h already.
 
 namespace VPU {
 
+// --- VPU_TaskGraph ---
+namespace {
+// Byte range a task reads or writes through one of its pointers; unsized buffers cover one byte.
+struct BufferRange {
+    uintptr_t begin = 0;
+    uintptr_t end = 0;
+    bool overlaps(const BufferRange& other) const { return begin < other.end && other.begin < end; }
+};
+
+BufferRange buffer_range(const void* data, size_t size_bytes) {
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(data);
+    return {begin, data ? begin + std::max<size_t>(size_bytes, 1) : begin};
+}
+
+// What a task reads and writes. Tasks are added before Pillar 1 fills the legacy pointers in
+// from the operands, so a typed task is described by its operands: every operand but the last
+// is read and the last is written.
+struct TaskBuffers {
+    std::vector<BufferRange> read;
+    BufferRange written;
+
+    bool reads(const BufferRange& range) const {
+        return std::any_of(read.begin(), read.end(), [&](const BufferRange& r) { return r.overlaps(range); });
+    }
+};
+
+TaskBuffers task_buffers(const VPU_Task& task) {
+    TaskBuffers buffers;
+    if (!task.operands.empty()) {
+        for (size_t i = 0; i + 1 < task.operands.size(); ++i) {
+            buffers.read.push_back(buffer_range(task.operands[i].data, task.operands[i].size_bytes()));
+        }
+        buffers.written = buffer_range(task.operands.back().data, task.operands.back().size_bytes());
+    } else {
+        buffers.read.push_back(buffer_range(task.data_in_a, task.data_in_a_size_bytes));
+        buffers.read.push_back(buffer_range(task.data_in_b, task.data_in_b_size_bytes));
+        buffers.written = buffer_range(task.data_out, task.data_out_size_bytes);
+    }
+    if (!task.conv_filter.empty()) {
+        buffers.read.push_back(buffer_range(task.conv_filter.data(), task.conv_filter.size() * sizeof(double)));
+    }
+    return buffers;
+}
+} // namespace
+
+VPU_TaskGraph::NodeId VPU_TaskGraph::add_task(VPU_Task& task) {
+    const NodeId node = tasks_.size();
+    const TaskBuffers buffers = task_buffers(task);
+    std::vector<NodeId> dependencies, data_sources;
+    for (NodeId earlier = 0; earlier < node; ++earlier) {
+        const TaskBuffers other = task_buffers(*tasks_[earlier]);
+        const bool reads_output = buffers.reads(other.written); // Read after write
+        if (reads_output) {
+            data_sources.push_back(earlier);
+        }
+        if (reads_output || buffers.written.overlaps(other.written) || other.reads(buffers.written)) {
+            dependencies.push_back(earlier);
+        }
+    }
+    tasks_.push_back(&task);
+    dependencies_.push_back(std::move(dependencies));
+    data_sources_.push_back(std::move(data_sources));
+    return node;
+}
+
+void VPU_TaskGraph::add_dependency(NodeId before, NodeId after) {
+    if (after >= tasks_.size() || before >= after) {
+        throw std::runtime_error("VPU_TaskGraph: dependency " + std::to_string(before) + " -> " + std::to_string(after) +
+                                 " must point from an earlier task to a later one.");
+    }
+    std::vector<NodeId>& dependencies = dependencies_[after];
+    auto it = std::lower_bound(dependencies.begin(), dependencies.end(), before);
+    if (it == dependencies.end() || *it != before) {
+        dependencies.insert(it, before);
+    }
+}
+
 // VPU_Environment methods (assuming they are defined elsewhere or here)
 // If VPU_Environment methods are in this file, they would typically be:
 VPU_Environment::VPU_Environment() : core(std::make_unique<VPUCore>()) {
-    std::cout << "[VPU_Environment] Created and VPUCore initialized." << std::endl;
+    VPU_LOG_INFO("[VPU_Environment] Created and VPUCore initialized.");
 }
 
 VPU_Environment::~VPU_Environment() {
-    std::cout << "[VPU_Environment] Destroyed." << std::endl;
+    VPU_LOG_INFO("[VPU_Environment] Destroyed.");
+    Runtime::flush_logs();
 }
 
 void VPU_Environment::execute(VPU_Task& task) {
     if (core) {
         core->execute_task(task);
     } else {
-        std::cerr << "[VPU_Environment] Error: VPUCore not initialized." << std::endl;
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
+    }
+}
+
+std::future<ActualPerformanceRecord> VPU_Environment::submit_async(VPU_Task& task) {
+    if (!core) {
+        throw std::runtime_error("VPU_Environment: VPUCore not initialized.");
+    }
+    return core->submit_async(task);
+}
+
+std::vector<ActualPerformanceRecord> VPU_Environment::execute_graph(VPU_TaskGraph& graph) {
+    if (!core) {
+        throw std::runtime_error("VPU_Environment: VPUCore not initialized.");
+    }
+    return core->execute_graph(graph);
+}
+
+std::vector<std::future<ActualPerformanceRecord>> VPU_Environment::submit_batch(VPU_Task* tasks, size_t count) {
+    std::vector<std::future<ActualPerformanceRecord>> futures;
+    if (!tasks || count == 0) {
+        return futures;
+    }
+    futures.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        futures.push_back(submit_async(tasks[i]));
+    }
+    return futures;
+}
+
+std::vector<std::future<ActualPerformanceRecord>> VPU_Environment::submit_batch(std::vector<VPU_Task>& tasks) {
+    return submit_batch(tasks.data(), tasks.size());
+}
+
+void VPU_Environment::set_pipelined_mode(bool enable) {
+    if (core) {
+        core->set_pipelined_mode(enable);
+    } else {
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
+    }
+}
+
+void VPU_Environment::wait_idle() {
+    if (core) {
+        core->wait_idle();
     }
 }
 
-const ActualPerformanceRecord& VPU_Environment::get_last_performance_record() const {
+ActualPerformanceRecord VPU_Environment::get_last_performance_record() const {
     if (core) {
         return core->get_last_performance_record();
     } else {
-        std::cerr << "[VPU_Environment] Error: VPUCore not initialized. Returning default/empty ActualPerformanceRecord." << std::endl;
-        // This is problematic as we must return a reference.
-        // Consider throwing an exception or having a static default instance.
-        // For now, this path indicates a programming error if core is null.
-        static const ActualPerformanceRecord default_record = {}; // Default empty record
-        return default_record;
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized. Returning default/empty ActualPerformanceRecord.");
+        // This path indicates a programming error if core is null.
+        return ActualPerformanceRecord();
+    }
+}
+
+void VPU_Environment::configure_fft_planning(FFTPlanningMode mode, const std::string& wisdom_file) {
+    if (core) {
+        core->configure_fft_planning(mode, wisdom_file);
+    } else {
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
+    }
+}
+
+void VPU_Environment::set_profiling_policy(const ProfilingPolicy& policy) {
+    if (core) {
+        core->set_profiling_policy(policy);
+    } else {
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
+    }
+}
+
+void VPU_Environment::reset_profiling_policy() {
+    if (core) {
+        core->reset_profiling_policy();
+    } else {
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
+    }
+}
+
+void VPU_Environment::set_plan_cache_capacity(size_t capacity) {
+    if (core) {
+        core->set_plan_cache_capacity(capacity);
+    } else {
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
     }
 }
 
@@ -44,7 +213,98 @@ void VPU_Environment::print_beliefs() {
     if (core) {
         core->print_current_beliefs();
     } else {
-        std::cerr << "[VPU_Environment] Error: VPUCore not initialized." << std::endl;
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
+    }
+}
+
+HAL::DeviceId VPU_Environment::add_device(std::shared_ptr<HAL::Device> device) {
+    if (!core) {
+        throw std::runtime_error("VPU_Environment::add_device: VPUCore not initialized.");
+    }
+    return core->add_device(std::move(device));
+}
+
+HAL::DeviceId VPU_Environment::add_remote_device(const std::string& substrate, const std::string& host, int port) {
+    return add_device(HAL::make_remote_device(substrate, host, port));
+}
+
+void VPU_Environment::enable_iot_telemetry(const std::string& host, int port, std::chrono::milliseconds interval,
+                                           std::chrono::milliseconds max_age) {
+    if (core) {
+        core->set_iot_telemetry(make_iot_telemetry_poller(host, port, interval), max_age);
+    } else {
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
+    }
+}
+
+void VPU_Environment::enable_belief_persistence(const std::string& path, std::chrono::milliseconds checkpoint_interval) {
+    if (core) {
+        core->enable_belief_persistence(path, checkpoint_interval);
+    } else {
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
+    }
+}
+
+std::shared_future<CalibrationReport> VPU_Environment::calibrate_cost_model(const CalibrationOptions& options) {
+    if (!core) {
+        throw std::runtime_error("VPU_Environment: VPUCore not initialized.");
+    }
+    return core->start_cost_calibration(options);
+}
+
+bool VPU_Environment::save_beliefs(const std::string& path) const {
+    return core && core->save_beliefs(path);
+}
+
+bool VPU_Environment::load_beliefs(const std::string& path, bool any_host) {
+    return core && core->load_beliefs(path, any_host) == ProfileLoadResult::LOADED;
+}
+
+void VPU_Environment::disable_iot_telemetry() {
+    if (core) {
+        core->set_iot_telemetry(nullptr, std::chrono::milliseconds(0));
+    } else {
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
+    }
+}
+
+void VPU_Environment::set_log_level(Runtime::LogLevel level) {
+    Runtime::set_log_level(level);
+}
+
+void VPU_Environment::start_tracing() {
+    Runtime::start_tracing();
+}
+
+bool VPU_Environment::write_trace(const std::string& path, bool stop) {
+    if (stop) {
+        Runtime::stop_tracing();
+    }
+    const bool written = Runtime::write_chrome_trace(path);
+    if (!written) {
+        VPU_LOG_WARN("[VPU_Environment] Could not write trace to '" << path << "'.");
+    }
+    return written;
+}
+
+Runtime::MetricsSnapshot VPU_Environment::metrics() const {
+    if (!core) {
+        throw std::runtime_error("VPU_Environment: VPUCore not initialized.");
+    }
+    return core->metrics();
+}
+
+int VPU_Environment::serve_metrics(int port, const std::string& host) {
+    if (!core) {
+        VPU_LOG_ERROR("[VPU_Environment] Error: VPUCore not initialized.");
+        return -1;
+    }
+    return core->serve_metrics(host, port);
+}
+
+void VPU_Environment::stop_serving_metrics() {
+    if (core) {
+        core->stop_serving_metrics();
     }
 }
 
@@ -55,72 +315,674 @@ VPUCore* VPU_Environment::get_core_for_testing() {
 
 
 VPUCore::VPUCore() : last_perf_record_() { // Initialize last_perf_record_
-    std::cout << "[VPU System] Core starting up..." << std::endl;
+    VPU_LOG_INFO("[VPU System] Core starting up...");
     initialize_beliefs();
     initialize_hal();
 
     // Instantiate each pillar, providing shared access to necessary resources.
     pillar1_synapse_ = std::make_unique<Pillar1_Synapse>(); // Added
     pillar2_cortex_ = std::make_unique<VPU::Cortex>();
-    pillar3_orchestrator_ = std::make_unique<Orchestrator>(hw_profile_);
-    pillar4_cerebellum_ = std::make_unique<Cerebellum>(kernel_lib_);
+    pillar3_orchestrator_ = std::make_unique<Orchestrator>(hw_profile_, devices_);
+    pillar4_cerebellum_ = std::make_unique<Cerebellum>(kernel_lib_, devices_);
     pillar5_feedback_ = std::make_unique<FeedbackLoop>(hw_profile_);
     // Initialize Pillar 6, ensuring hw_profile_ and kernel_lib_ are already initialized
     pillar6_task_graph_orchestrator_ = std::make_unique<TaskGraphOrchestrator>(kernel_lib_, hw_profile_);
 
+    // Warm start: beliefs learned by earlier processes on this host type.
+    if (const char* beliefs_file = std::getenv("VPU_BELIEFS_FILE")) {
+        if (*beliefs_file) {
+            enable_belief_persistence(beliefs_file, DEFAULT_CHECKPOINT_INTERVAL);
+        }
+    }
+    // Measured costs for this host, replacing the priors (and any warm-started costs) once ready.
+    if (const char* calibrate = std::getenv("VPU_CALIBRATE_COSTS")) {
+        if (*calibrate && std::string(calibrate) != "0") {
+            start_cost_calibration(CalibrationOptions());
+        }
+    }
 
-    std::cout << "[VPU System] All pillars are online. Ready." << std::endl;
+    VPU_LOG_INFO("[VPU System] All pillars are online. Ready.");
 }
 
-void VPUCore::execute_task(VPU_Task& task) {
-    // 0. SUBMIT & VALIDATE: Pass task through Pillar1 for initial intake.
-    std::cout << "[VPUCore] Submitting task ID: " << task.task_id << " to Pillar1_Synapse." << std::endl;
-    if (!pillar1_synapse_->submit_task(task)) {
-        std::cerr << "[VPUCore] Task ID: " << task.task_id << " rejected by Pillar1_Synapse. Aborting execution." << std::endl;
-        return; // Task failed initial validation or processing in Pillar1
+VPUCore::~VPUCore() {
+    metrics_endpoint_.stop(); // No scrapes while shutting down
+    {
+        std::lock_guard<std::mutex> lock(calibrator_mutex_);
+        calibrator_.reset(); // Cancel a calibration still measuring
     }
-    std::cout << "[VPUCore] Task ID: " << task.task_id << " successfully processed by Pillar1_Synapse." << std::endl;
+    // Finish in-flight asynchronous tasks while all pillars are still alive.
+    // Pipeline stages are drained front to back so every job can still reach the next stage.
+    if (async_pool_) async_pool_->shutdown();
+    if (graph_pool_) graph_pool_->shutdown();
+    if (perceive_stage_) perceive_stage_->shutdown();
+    if (decide_stage_) decide_stage_->shutdown();
+    if (act_stage_) act_stage_->shutdown();
+    if (learn_stage_) learn_stage_->shutdown();
 
-    // 1. PERCEIVE: Use the Cortex to analyze the data.
-    EnrichedExecutionContext context = pillar2_cortex_->analyze(task);
+    // Last checkpoint of the beliefs, including any still staged by Pillar 5 and the step
+    // latencies every worker thread has batched.
+    pillar5_feedback_->flush_latency_statistics();
+    pillar5_feedback_->publish_pending_beliefs();
+    {
+        std::lock_guard<std::mutex> lock(checkpointer_mutex_);
+        belief_checkpointer_.reset();
+    }
+
+    // Persist plans found by MEASURE/PATIENT planning (no-op unless a wisdom file was configured).
+    if (fft_wisdom_configured_) {
+        HAL::FFTPlanCache::instance().save_wisdom();
+    }
+}
+
+void VPUCore::configure_fft_planning(FFTPlanningMode mode, const std::string& wisdom_file) {
+    HAL::FFTPlanRigor rigor = HAL::FFTPlanRigor::ESTIMATE;
+    if (mode == FFTPlanningMode::MEASURE) {
+        rigor = HAL::FFTPlanRigor::MEASURE;
+    } else if (mode == FFTPlanningMode::PATIENT) {
+        rigor = HAL::FFTPlanRigor::PATIENT;
+    }
+    HAL::FFTPlanCache::instance().configure(rigor, wisdom_file);
+    fft_wisdom_configured_ = !wisdom_file.empty();
+    VPU_LOG_INFO("[VPUCore] FFT planning mode set to "
+              << (mode == FFTPlanningMode::PATIENT ? "PATIENT" : mode == FFTPlanningMode::MEASURE ? "MEASURE" : "ESTIMATE")
+              << (wisdom_file.empty() ? "." : " with wisdom file '" + wisdom_file + "'."));
+}
+
+ActualPerformanceRecord VPUCore::execute_task(VPU_Task& task) {
+    return run_cognitive_cycle(task, nullptr);
+}
+
+ActualPerformanceRecord VPUCore::run_cognitive_cycle(VPU_Task& task, ExecutionPlan* executed_plan) {
+    if (task.stream.active()) {
+        return run_stream_cycle(task, executed_plan);
+    }
+    Runtime::TraceSpan task_span("task", task.task_id); // Encloses the per-stage spans below
+    // 0. SUBMIT & VALIDATE + 1. PERCEIVE
+    EnrichedExecutionContext context;
+    if (!stage_perceive(task, context)) {
+        return ActualPerformanceRecord{};
+    }
 
     // 2. DECIDE: Use the Orchestrator to get candidate execution plans.
-    std::vector<ExecutionPlan> candidate_plans = pillar3_orchestrator_->determine_optimal_path(context);
+    ExecutionPlan chosen_plan;
+    bool explored = false;
+    if (!stage_decide(context, task, chosen_plan, explored)) {
+        return ActualPerformanceRecord{};
+    }
 
-    if (candidate_plans.empty()) {
-        std::cerr << "[VPUCore] Error: Orchestrator returned no candidate plans for task ID: " << task.task_id << ". Aborting." << std::endl;
-        // Optionally, set task status to error
-        return;
+    // 3. ACT: Use the Cerebellum to execute the chosen plan and record performance.
+    ActualPerformanceRecord record = stage_act(context, chosen_plan, task);
+
+    // 4. LEARN + 5. RECORD & ADAPT
+    {
+        Runtime::TraceSpan learn_span("learn", task.task_id);
+        stage_learn(context, chosen_plan, explored, record, /*publish_beliefs=*/true);
+    }
+    if (executed_plan) {
+        *executed_plan = std::move(chosen_plan);
     }
+    return record;
+}
+
+namespace {
 
-    ExecutionPlan chosen_plan = candidate_plans.front(); // Default to the best plan
+// One chunk's share of a streamed task's record.
+ActualPerformanceRecord average_chunk(const ActualPerformanceRecord& total, size_t chunks) {
+    ActualPerformanceRecord chunk = total;
+    const double n = static_cast<double>(std::max<size_t>(chunks, 1));
+    chunk.observed_latency_ns /= n;
+    chunk.observed_cycle_cost = static_cast<uint64_t>(total.observed_cycle_cost / n);
+    chunk.observed_hw_in_cost = static_cast<uint64_t>(total.observed_hw_in_cost / n);
+    chunk.observed_hw_out_cost = static_cast<uint64_t>(total.observed_hw_out_cost / n);
+    chunk.observed_holistic_flux /= n;
+    for (StepLatency& step : chunk.step_latencies) {
+        step.latency_ns /= n;
+    }
+    return chunk;
+}
+
+} // namespace
+
+ActualPerformanceRecord VPUCore::run_stream_cycle(VPU_Task& task, ExecutionPlan* executed_plan) {
+    Runtime::TraceSpan task_span("task", task.task_id);
+    {
+        Runtime::TraceSpan submit_span("submit", task.task_id);
+        Runtime::StageTimer submit_timer(metrics_, Runtime::CycleStage::SYNAPSE);
+        if (!pillar1_synapse_->submit_task(task)) {
+            VPU_LOG_WARN("[VPUCore] Task ID: " << task.task_id << " rejected by Pillar1_Synapse. Aborting execution.");
+            return ActualPerformanceRecord{};
+        }
+    }
+
+    // Every chunk runs the same plan on a chunk-sized task, so the first chunk is what Pillar 3
+    // plans for. Its profile stands in for the stream's until execution has read the rest.
+    StreamSession stream;
+    const ProfilingPolicy policy = profiling_policy_for(task);
+    VPU_Task head;
+    EnrichedExecutionContext context;
+    {
+        Runtime::TraceSpan analyze_span("analyze", task.task_id);
+        Runtime::StageTimer analyze_timer(metrics_, Runtime::CycleStage::CORTEX);
+        std::string error;
+        if (!stream.open(task, error)) {
+            VPU_LOG_WARN("[VPUCore] Task ID: " << task.task_id << " cannot be streamed: " << error << ".");
+            return ActualPerformanceRecord{};
+        }
+        head = stream.chunk_task(0);
+        context = pillar2_cortex_->analyze(head, policy); // Not cached: the profile covers one chunk
+        context.payload_bytes = context.shape.working_set_bytes;
+        if (context.op == TaskOp::SAXPY && context.profile && context.profile->input_stats.elements > 0) {
+            context.saxpy_specialization = pillar4_cerebellum_->specialize_jit_kernel(head, context.profile->input_stats.zero_ratio());
+            context.jit_kernel_cached = context.saxpy_specialization && pillar4_cerebellum_->has_cached_jit_kernel(*context.saxpy_specialization);
+        }
+    }
+    VPU_LOG_DEBUG("[VPUCore] Streaming task ID: " << task.task_id << " in " << stream.chunks() << " chunks.");
+
+    ExecutionPlan chosen_plan;
     bool explored = false;
+    if (!stage_decide(context, head, chosen_plan, explored)) {
+        return ActualPerformanceRecord{};
+    }
 
-    if (pillar5_feedback_->should_explore()) {
-        if (candidate_plans.size() > 1) {
-            // Simple exploration: choose the second-best plan if available.
-            // More sophisticated strategies could be: random choice from non-optimal,
-            // or a plan with specific characteristics to test.
-            chosen_plan = candidate_plans[1];
-            explored = true;
-            std::cout << "[VPUCore] EXPLORATION: Chose suboptimal plan '" << chosen_plan.chosen_path_name
-                      << "' (Predicted Flux: " << chosen_plan.predicted_holistic_flux
-                      << ") instead of optimal '" << candidate_plans.front().chosen_path_name
-                      << "' (Predicted Flux: " << candidate_plans.front().predicted_holistic_flux
-                      << ")" << std::endl;
-        } else {
-            std::cout << "[VPUCore] EXPLORATION desired, but no alternative paths available for task ID: " << task.task_id << "." << std::endl;
+    // The profile is folded chunk by chunk as execution reads the input.
+    StreamingProfiler profiler(policy, context.element_type);
+    ActualPerformanceRecord record;
+    {
+        Runtime::TraceSpan execute_span("execute", task.task_id);
+        Runtime::StageTimer execute_timer(metrics_, Runtime::CycleStage::CEREBELLUM);
+        std::shared_lock<std::shared_mutex> kernel_lock(kernel_lib_mutex_);
+        record = pillar4_cerebellum_->execute_stream(chosen_plan, stream, [&profiler](HAL::Span<const uint8_t> input) {
+            profiler.update(input.data(), input.size());
+        });
+    }
+
+    {
+        Runtime::TraceSpan learn_span("learn", task.task_id);
+        auto profile = std::make_shared<DataProfile>(profiler.profile());
+        const DataProfile& head_profile = *context.profile; // Sensor readings are the ones planned with
+        profile->power_draw_watts = head_profile.power_draw_watts;
+        profile->temperature_celsius = head_profile.temperature_celsius;
+        profile->network_latency_ms = head_profile.network_latency_ms;
+        profile->network_bandwidth_mbps = head_profile.network_bandwidth_mbps;
+        profile->io_throughput_mbps = head_profile.io_throughput_mbps;
+        profile->data_quality_score = head_profile.data_quality_score;
+        context.profile = profile;
+        stage_learn(context, chosen_plan, explored, average_chunk(record, stream.chunks()), /*publish_beliefs=*/true);
+    }
+    {
+        std::lock_guard<std::mutex> state_lock(cognitive_state_mutex_);
+        last_perf_record_ = record; // Callers see the whole stream, not the chunk Pillar 5 learned from
+    }
+    if (executed_plan) {
+        *executed_plan = std::move(chosen_plan);
+    }
+    return record;
+}
+
+std::vector<ActualPerformanceRecord> VPUCore::execute_graph(VPU_TaskGraph& graph) {
+    const size_t nodes = graph.size();
+    if (nodes == 0) {
+        return {};
+    }
+    auto run = std::make_shared<GraphRun>(nodes);
+    run->graph = &graph;
+    std::vector<VPU_TaskGraph::NodeId> roots;
+    for (VPU_TaskGraph::NodeId node = 0; node < nodes; ++node) {
+        const auto& dependencies = graph.dependencies(node);
+        run->unmet_dependencies[node].store(dependencies.size(), std::memory_order_relaxed);
+        for (VPU_TaskGraph::NodeId dependency : dependencies) {
+            run->successors[dependency].push_back(node);
+        }
+        if (dependencies.empty()) {
+            roots.push_back(node);
+        }
+    }
+    VPU_LOG_DEBUG("[VPUCore] Executing task graph: " << nodes << " task(s), " << roots.size()
+              << " ready at start.");
+
+    Runtime::WorkStealingPool& pool = graph_pool();
+    for (VPU_TaskGraph::NodeId root : roots) {
+        if (!pool.submit([this, run, root]() { run_graph_node(run, root); })) {
+            throw std::runtime_error("VPUCore: task graph pool is shut down; the graph was not run.");
         }
+    }
+    {
+        std::unique_lock<std::mutex> lock(run->done_mutex);
+        run->done_cv.wait(lock, [&run] { return run->unfinished == 0; });
+    }
+
+    // 5. RECORD & ADAPT across tasks: a consumer's plan continues its producer's.
+    {
+        std::lock_guard<std::mutex> state_lock(cognitive_state_mutex_);
+        std::unique_lock<std::shared_mutex> kernel_lock(kernel_lib_mutex_);
+        for (VPU_TaskGraph::NodeId node = 0; node < nodes; ++node) {
+            for (VPU_TaskGraph::NodeId producer : graph.data_sources(node)) {
+                if (!run->plans[producer].steps.empty() && !run->plans[node].steps.empty()) {
+                    pillar6_task_graph_orchestrator_->record_task_graph_edge(run->plans[producer], run->plans[node]);
+                }
+            }
+        }
+    }
+
+    if (run->first_error) {
+        std::rethrow_exception(run->first_error);
+    }
+    return std::move(run->records);
+}
+
+void VPUCore::run_graph_node(std::shared_ptr<GraphRun> run, VPU_TaskGraph::NodeId node) {
+    const bool skip = run->skipped[node].load(std::memory_order_acquire);
+    bool failed = skip;
+    if (skip) {
+        VPU_LOG_WARN("[VPUCore] Skipping task ID: " << run->graph->task(node).task_id
+                  << " because a task it depends on failed.");
     } else {
-         std::cout << "[VPUCore] Chose optimal plan '" << chosen_plan.chosen_path_name << "' with predicted flux " << chosen_plan.predicted_holistic_flux << "." << std::endl;
+        try {
+            run->records[node] = run_cognitive_cycle(run->graph->task(node), &run->plans[node]);
+            // Rejected at intake or left without a plan: nothing ran, so dependents lack their inputs.
+            failed = run->plans[node].steps.empty();
+            if (failed) {
+                VPU_LOG_WARN("[VPUCore] Task ID: " << run->graph->task(node).task_id
+                          << " did not run; skipping the tasks that depend on it.");
+            }
+        } catch (...) {
+            failed = true;
+            run->plans[node] = ExecutionPlan{};
+            std::lock_guard<std::mutex> lock(run->done_mutex);
+            if (!run->first_error) {
+                run->first_error = std::current_exception();
+            }
+        }
     }
 
-    // 3. ACT: Use the Cerebellum to execute the chosen plan and record performance.
-    // Store the performance record
-    last_perf_record_ = pillar4_cerebellum_->execute(chosen_plan, task);
+    // Release the successors; ready ones go onto this worker's deque and run next.
+    for (VPU_TaskGraph::NodeId successor : run->successors[node]) {
+        if (failed) {
+            run->skipped[successor].store(true, std::memory_order_release);
+        }
+        if (run->unmet_dependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+            !graph_pool().submit([this, run, successor]() { run_graph_node(run, successor); })) {
+            // The pool is shutting down: finish the successor here as skipped, so it (and in turn
+            // its own successors) still counts as done and execute_graph returns.
+            {
+                std::lock_guard<std::mutex> lock(run->done_mutex);
+                if (!run->first_error) {
+                    run->first_error = std::make_exception_ptr(std::runtime_error(
+                        "VPUCore: task graph pool is shut down; task " +
+                        std::to_string(run->graph->task(successor).task_id) + " was not run."));
+                }
+            }
+            run->skipped[successor].store(true, std::memory_order_release);
+            run_graph_node(run, successor);
+        }
+    }
 
+    std::lock_guard<std::mutex> lock(run->done_mutex);
+    if (--run->unfinished == 0) {
+        run->done_cv.notify_all();
+    }
+}
+
+void VPUCore::set_profiling_policy(const ProfilingPolicy& policy) {
+    std::lock_guard<std::mutex> lock(profiling_policy_mutex_);
+    profiling_policy_override_ = std::make_unique<ProfilingPolicy>(policy);
+}
+
+void VPUCore::reset_profiling_policy() {
+    std::lock_guard<std::mutex> lock(profiling_policy_mutex_);
+    profiling_policy_override_.reset();
+}
+
+ProfilingPolicy VPUCore::profiling_policy_for(const VPU_Task& task) const {
+    {
+        std::lock_guard<std::mutex> lock(profiling_policy_mutex_);
+        if (profiling_policy_override_) {
+            return *profiling_policy_override_;
+        }
+    }
+    return pillar3_orchestrator_->profiling_policy_for(resolved_op(task));
+}
+
+bool VPUCore::stage_perceive(VPU_Task& task, EnrichedExecutionContext& context) {
+    // 0. SUBMIT & VALIDATE: Pass task through Pillar1 for initial intake.
+    VPU_LOG_DEBUG("[VPUCore] Submitting task ID: " << task.task_id << " to Pillar1_Synapse.");
+    {
+        Runtime::TraceSpan submit_span("submit", task.task_id);
+        Runtime::StageTimer submit_timer(metrics_, Runtime::CycleStage::SYNAPSE);
+        if (!pillar1_synapse_->submit_task(task)) {
+            VPU_LOG_WARN("[VPUCore] Task ID: " << task.task_id << " rejected by Pillar1_Synapse. Aborting execution.");
+            return false; // Task failed initial validation or processing in Pillar1
+        }
+    }
+    VPU_LOG_DEBUG("[VPUCore] Task ID: " << task.task_id << " successfully processed by Pillar1_Synapse.");
+    Runtime::TraceSpan analyze_span("analyze", task.task_id);
+    Runtime::StageTimer analyze_timer(metrics_, Runtime::CycleStage::CORTEX);
+
+    // 1. PERCEIVE: Use the Cortex to analyze the data.
+    // Profiling only reads the task's data, so it runs outside the cognitive state lock.
+    // The Orchestrator decides how much fidelity the profile needs for this task type.
+    const ProfilingPolicy policy = profiling_policy_for(task);
+    uint64_t cache_key = pillar2_cortex_->has_pending_iot_override() ? 0 : ProfilePlanCache::make_key(task, policy);
+    if (cache_key != 0) {
+        if (const uint64_t telemetry = pillar2_cortex_->telemetry_generation()) {
+            cache_key = HAL::hash_combine(cache_key, telemetry); // Profiles carry the sensor readings
+        }
+    }
+    if (std::shared_ptr<const DataProfile> cached = plan_cache_.find_profile(cache_key)) {
+        VPU_LOG_DEBUG("[VPUCore] Reusing cached profile for task ID: " << task.task_id << " (skipping Pillar 2).");
+        context = EnrichedExecutionContext();
+        context.profile = cached;
+        context.task_type = task_label(task);
+        context.sparse_a_pre_encoded = !task.sparse_a.empty();
+        context.shape = problem_shape(task);
+        context.op = resolved_op(task);
+        context.element_type = input_element_type(task);
+        context.accuracy_bound = task.accuracy_bound;
+    } else {
+        context = pillar2_cortex_->analyze(task, policy);
+        if (cache_key != 0) {
+            std::shared_ptr<const DataProfile> to_cache = context.profile;
+            if (task.data_version == 0 && to_cache && to_cache->input_stats.data) {
+                // A fingerprint only samples large buffers, so later kernels must rescan rather than trust these stats.
+                auto stripped = std::make_shared<DataProfile>(*to_cache);
+                stripped->input_stats.data = nullptr;
+                to_cache = stripped;
+            }
+            plan_cache_.store_profile(cache_key, to_cache);
+        }
+    }
+    context.cache_key = cache_key;
+    context.payload_bytes = context.shape.working_set_bytes; // What an offloaded step moves there and back
+    // Pillar 3 prices JIT_COMPILE_SAXPY by whether the kernel for this data is already generated;
+    // the specialization (one scan of x) is kept for stage_act's compile step.
+    if (context.op == TaskOp::SAXPY && context.element_type == HAL::ElementType::FLOAT32 && context.profile &&
+        context.profile->input_stats.elements > 0) {
+        context.saxpy_specialization = pillar4_cerebellum_->specialize_jit_kernel(task, context.profile->input_stats.zero_ratio());
+        context.jit_kernel_cached = context.saxpy_specialization && pillar4_cerebellum_->has_cached_jit_kernel(*context.saxpy_specialization);
+    }
+    return true;
+}
+
+bool VPUCore::stage_decide(const EnrichedExecutionContext& context, const VPU_Task& task, ExecutionPlan& plan, bool& explored) {
+    Runtime::TraceSpan plan_span("plan", task.task_id);
+    Runtime::StageTimer plan_timer(metrics_, Runtime::CycleStage::ORCHESTRATOR);
+    // Planning works on one belief snapshot, so concurrent planners need no lock.
+    // Plans cached for this profile are reused while the beliefs they were priced against are current
+    // (and the JIT kernel cache state, which changes the price of JIT_COMPILE_SAXPY, is unchanged).
+    auto pricing_stamp = [&context](uint64_t belief_version) {
+        return HAL::hash_combine(belief_version, context.jit_kernel_cached ? 1 : 0);
+    };
+    std::vector<ExecutionPlan> candidate_plans;
+    if (plan_cache_.find_plans(context.cache_key, pricing_stamp(hw_profile_->version()), candidate_plans)) {
+        VPU_LOG_DEBUG("[VPUCore] Reusing cached plans for task ID: " << task.task_id << " (skipping Pillar 3).");
+    } else {
+        candidate_plans = pillar3_orchestrator_->determine_optimal_path(context);
+        if (!candidate_plans.empty()) {
+            plan_cache_.store_plans(context.cache_key, pricing_stamp(candidate_plans.front().belief_version), candidate_plans);
+        }
+    }
+
+    if (candidate_plans.empty()) {
+        VPU_LOG_ERROR("[VPUCore] Error: Orchestrator returned no candidate plans for task ID: " << task.task_id << ". Aborting.");
+        // Optionally, set task status to error
+        return false;
+    }
+    std::lock_guard<std::mutex> state_lock(cognitive_state_mutex_); // Exploration RNG lives in Pillar 5
+    plan = select_plan(candidate_plans, context, task, explored);
+    return true;
+}
+
+ActualPerformanceRecord VPUCore::stage_act(const EnrichedExecutionContext& context, const ExecutionPlan& plan, VPU_Task& task) {
+    Runtime::TraceSpan execute_span("execute", task.task_id);
+    Runtime::StageTimer execute_timer(metrics_, Runtime::CycleStage::CEREBELLUM);
+    // Executions of different tasks may overlap; only Pillar 6 fusion needs exclusive KernelLibrary access.
+    std::shared_lock<std::shared_mutex> kernel_lock(kernel_lib_mutex_);
+    // Kernels reuse the profile's scan of the task input instead of reading it again.
+    return pillar4_cerebellum_->execute(plan, task, &context);
+}
+
+void VPUCore::stage_learn(const EnrichedExecutionContext& context, const ExecutionPlan& plan, bool explored,
+                          const ActualPerformanceRecord& record, bool publish_beliefs) {
     // 4. LEARN: Use the Feedback Loop to compare prediction and reality.
     // Crucially, use the chosen_plan's name and its predicted_holistic_flux for learning.
+    LearningContext learning_ctx = build_learning_context(plan, context, explored);
+    record_cycle_metrics(context, plan, explored, record); // Before learning moves the predictions
+    pillar5_feedback_->record_step_latencies(record);       // Per thread; needs no cognitive state
+
+    std::lock_guard<std::mutex> state_lock(cognitive_state_mutex_);
+    {
+        Runtime::StageTimer feedback_timer(metrics_, Runtime::CycleStage::FEEDBACK);
+        last_perf_record_ = record; // Store the performance record
+        // Pass the predicted flux of the *actually executed plan* to learn_from_feedback
+        pillar5_feedback_->learn_from_feedback(learning_ctx, plan.predicted_holistic_flux, record);
+        pillar5_feedback_->record_plan_outcome(context, plan, record);
+        if (publish_beliefs) {
+            pillar5_feedback_->publish_pending_beliefs();
+        }
+    }
+
+    // 5. RECORD & ADAPT (Pillar 6): Record the executed plan for graph analysis and potential fusion.
+    // The analyze_and_fuse_patterns() is called periodically from within record_executed_plan().
+    if (pillar6_task_graph_orchestrator_) {
+        Runtime::StageTimer record_timer(metrics_, Runtime::CycleStage::TASK_GRAPH);
+        std::unique_lock<std::shared_mutex> kernel_lock(kernel_lib_mutex_);
+        pillar6_task_graph_orchestrator_->record_executed_plan(plan);
+    }
+}
+
+void VPUCore::record_cycle_metrics(const EnrichedExecutionContext& context, const ExecutionPlan& plan, bool explored,
+                                   const ActualPerformanceRecord& record) {
+    static const HAL::OpId JIT_COMPILE_SAXPY_ID = HAL::intern_op("JIT_COMPILE_SAXPY");
+    bool fused = false;
+    for (const auto& step : plan.steps) {
+        fused |= find_fusion_rule(step.op_id) != nullptr;
+        if (step.op_id == JIT_COMPILE_SAXPY_ID) {
+            metrics_.record_jit_lookup(context.jit_kernel_cached);
+        }
+    }
+    metrics_.record_task(plan.chosen_path_name, explored, fused);
+
+    // Each step against the latency the current beliefs expect of its operation.
+    const HardwareProfileSnapshot beliefs = hw_profile_->snapshot();
+    const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
+    for (const StepLatency& step : record.step_latencies) {
+        if (step.op == HAL::INVALID_OP_ID) continue;
+        if (const LatencyStats* predicted = beliefs->latency.find(step.op)) {
+            metrics_.record_prediction(registry.name(step.op), predicted->ewma_ns, step.latency_ns);
+        }
+    }
+}
+
+int VPUCore::serve_metrics(const std::string& host, int port) {
+    return metrics_endpoint_.start(host, port, [this]() { return metrics_.snapshot().to_prometheus(); });
+}
+
+std::future<ActualPerformanceRecord> VPUCore::submit_async(VPU_Task& task) {
+    if (pipelined_mode_.load() && !task.stream.active()) { // Streams run their own cycle (run_stream_cycle)
+        auto job = std::make_shared<PipelineJob>();
+        job->task = &task;
+        job->task_type = task_label(task);
+        job->task_id = task.task_id;
+        std::future<ActualPerformanceRecord> result = job->promise.get_future();
+        submit_to_pipeline(std::move(job));
+        return result;
+    }
+
+    // std::function requires a copyable callable, so the packaged_task is shared.
+    auto job = std::make_shared<std::packaged_task<ActualPerformanceRecord()>>(
+        [this, &task]() { return execute_task(task); });
+    std::future<ActualPerformanceRecord> result = job->get_future();
+
+    task_started();
+    if (!async_pool().submit([this, job]() { (*job)(); task_finished(); })) {
+        task_finished();
+        throw std::runtime_error("VPUCore: asynchronous worker pool is shut down; task " +
+                                 std::to_string(task.task_id) + " was not queued.");
+    }
+    return result;
+}
+
+void VPUCore::set_pipelined_mode(bool enable) {
+    pipelined_mode_.store(enable);
+    VPU_LOG_INFO("[VPUCore] Pipelined execution " << (enable ? "enabled." : "disabled."));
+}
+
+void VPUCore::wait_idle() {
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_cv_.wait(lock, [this] { return tasks_in_flight_ == 0; });
+}
+
+void VPUCore::task_started() {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    ++tasks_in_flight_;
+}
+
+void VPUCore::task_finished() {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    if (--tasks_in_flight_ == 0) {
+        idle_cv_.notify_all();
+    }
+}
+
+Runtime::WorkerPool& VPUCore::async_pool() {
+    std::call_once(async_pool_once_, [this]() {
+        // Workers default to one per hardware thread.
+        const size_t ASYNC_QUEUE_CAPACITY = 1024;
+        async_pool_ = std::make_unique<Runtime::WorkerPool>(0, ASYNC_QUEUE_CAPACITY);
+        VPU_LOG_INFO("[VPUCore] Asynchronous worker pool started with " << async_pool_->worker_count()
+                  << " worker(s), queue capacity " << ASYNC_QUEUE_CAPACITY << ".");
+    });
+    return *async_pool_;
+}
+
+Runtime::WorkStealingPool& VPUCore::graph_pool() {
+    std::call_once(graph_pool_once_, [this]() {
+        graph_pool_ = std::make_unique<Runtime::WorkStealingPool>(0);
+        VPU_LOG_INFO("[VPUCore] Task graph pool started with " << graph_pool_->worker_count()
+                  << " work-stealing worker(s).");
+    });
+    return *graph_pool_;
+}
+
+// --- Pipelined cognitive cycle ---
+// Each stage hands the job to the next stage's queue. A full downstream queue blocks the
+// upstream workers, so backpressure propagates all the way back to submit_async().
+
+void VPUCore::start_pipeline() {
+    std::call_once(pipeline_once_, [this]() {
+        const size_t STAGE_QUEUE_CAPACITY = 256;
+        size_t hw_threads = std::thread::hardware_concurrency();
+        if (hw_threads == 0) hw_threads = 2;
+        const size_t perceive_workers = std::max<size_t>(1, hw_threads / 2);
+        const size_t decide_workers = std::max<size_t>(1, hw_threads / 2);
+        const size_t act_workers = hw_threads;
+
+        // Created back to front so a stage never forwards into a missing pool.
+        learn_stage_ = std::make_unique<Runtime::WorkerPool>(1, STAGE_QUEUE_CAPACITY);
+        act_stage_ = std::make_unique<Runtime::WorkerPool>(act_workers, STAGE_QUEUE_CAPACITY);
+        decide_stage_ = std::make_unique<Runtime::WorkerPool>(decide_workers, STAGE_QUEUE_CAPACITY);
+        perceive_stage_ = std::make_unique<Runtime::WorkerPool>(perceive_workers, STAGE_QUEUE_CAPACITY);
+        VPU_LOG_INFO("[VPUCore] Pipeline started. Workers: perceive=" << perceive_workers
+                  << ", decide=" << decide_workers << ", act=" << act_workers << ", learn=1.");
+    });
+}
+
+void VPUCore::submit_to_pipeline(std::shared_ptr<PipelineJob> job) {
+    start_pipeline();
+    task_started();
+    const uint64_t task_id = job->task_id;
+    if (!perceive_stage_->submit([this, job]() { pipeline_perceive(job); })) {
+        task_finished();
+        throw std::runtime_error("VPUCore: pipeline is shut down; task " + std::to_string(task_id) + " was not queued.");
+    }
+}
+
+void VPUCore::pipeline_perceive(std::shared_ptr<PipelineJob> job) {
+    try {
+        if (!stage_perceive(*job->task, job->context)) {
+            job->promise.set_value(ActualPerformanceRecord{});
+            task_finished();
+            return;
+        }
+        if (!decide_stage_->submit([this, job]() { pipeline_decide(job); })) {
+            throw std::runtime_error("VPUCore: decide stage is shut down.");
+        }
+    } catch (...) {
+        pipeline_fail(*job, std::current_exception());
+    }
+}
+
+void VPUCore::pipeline_decide(std::shared_ptr<PipelineJob> job) {
+    try {
+        if (!stage_decide(job->context, *job->task, job->plan, job->explored)) {
+            job->promise.set_value(ActualPerformanceRecord{});
+            task_finished();
+            return;
+        }
+        if (!act_stage_->submit([this, job]() { pipeline_act(job); })) {
+            throw std::runtime_error("VPUCore: act stage is shut down.");
+        }
+    } catch (...) {
+        pipeline_fail(*job, std::current_exception());
+    }
+}
+
+void VPUCore::pipeline_act(std::shared_ptr<PipelineJob> job) {
+    try {
+        job->record = stage_act(job->context, job->plan, *job->task);
+    } catch (...) {
+        pipeline_fail(*job, std::current_exception());
+        return;
+    }
+    // The result is complete once Pillar 4 finishes; learning happens off the critical path.
+    job->task = nullptr; // The caller may release the task as soon as the future is ready
+    job->promise.set_value(job->record);
+    if (!learn_stage_->submit([this, job]() { pipeline_learn(job); })) {
+        VPU_LOG_WARN("[VPUCore] Learn stage is shut down; skipping feedback for a completed task.");
+        task_finished();
+    }
+}
+
+void VPUCore::pipeline_learn(std::shared_ptr<PipelineJob> job) {
+    try {
+        // Belief updates are batched while more feedback is queued and published once the stage drains.
+        const bool publish_beliefs = learn_stage_->pending_jobs() == 0;
+        Runtime::TraceSpan learn_span("learn", job->task_id);
+        stage_learn(job->context, job->plan, job->explored, job->record, publish_beliefs);
+    } catch (const std::exception& e) {
+        // The caller already has its result; a learning failure only loses this feedback sample.
+        VPU_LOG_WARN("[VPUCore] Background learning failed: " << e.what());
+    }
+    task_finished();
+}
+
+void VPUCore::pipeline_fail(PipelineJob& job, std::exception_ptr error) {
+    job.promise.set_exception(error);
+    task_finished();
+}
+
+ExecutionPlan VPUCore::select_plan(const std::vector<ExecutionPlan>& candidate_plans, const EnrichedExecutionContext& context,
+                                   const VPU_Task& task, bool& explored) {
+    // Pillar 5 weighs what it has seen of each candidate in this kind of context; any of them may be tried.
+    const size_t choice = pillar5_feedback_->choose_plan(context, candidate_plans);
+    ExecutionPlan chosen_plan = candidate_plans[choice];
+    explored = choice != 0;
+
+    if (explored) {
+        VPU_LOG_DEBUG("[VPUCore] EXPLORATION (task ID " << task.task_id << "): Chose candidate #" << choice + 1
+                  << " '" << chosen_plan.chosen_path_name
+                  << "' (Predicted Flux: " << chosen_plan.predicted_holistic_flux
+                  << ") instead of optimal '" << candidate_plans.front().chosen_path_name
+                  << "' (Predicted Flux: " << candidate_plans.front().predicted_holistic_flux
+                  << ")");
+    } else {
+         VPU_LOG_DEBUG("[VPUCore] Chose optimal plan '" << chosen_plan.chosen_path_name << "' with predicted flux " << chosen_plan.predicted_holistic_flux << ".");
+    }
+    return chosen_plan;
+}
+
+LearningContext VPUCore::build_learning_context(const ExecutionPlan& chosen_plan, const EnrichedExecutionContext& context,
+                                               bool explored) const {
     LearningContext learning_ctx;
     learning_ctx.path_name = chosen_plan.chosen_path_name;
     if (explored) {
@@ -130,11 +992,21 @@ void VPUCore::execute_task(VPU_Task& task) {
 
     bool is_transform_focused = false;
 
-    // Corrected: Use chosen_plan for LearningContext creation
-    if (chosen_plan.chosen_path_name.find("FFT") != std::string::npos) {
+    // The plan's steps (not its display name) say which transform it went through.
+    static const HAL::OpId FFT_FORWARD_ID = HAL::intern_op("FFT_FORWARD");
+    static const HAL::OpId JIT_COMPILE_SAXPY_ID = HAL::intern_op("JIT_COMPILE_SAXPY");
+    bool uses_fft = false;
+    bool uses_jit = false;
+    for (const auto& step : chosen_plan.steps) {
+        const FusionRule* fused = find_fusion_rule(step.op_id);
+        uses_fft |= (fused ? fused->first_id : step.op_id) == FFT_FORWARD_ID;
+        uses_jit |= step.op_id == JIT_COMPILE_SAXPY_ID;
+    }
+
+    if (uses_fft) {
         learning_ctx.transform_key = "TRANSFORM_TIME_TO_FREQ";
         is_transform_focused = true;
-    } else if (chosen_plan.chosen_path_name.find("JIT Compiled SAXPY") != std::string::npos) {
+    } else if (uses_jit) {
         learning_ctx.transform_key = "TRANSFORM_JIT_COMPILE_SAXPY";
         learning_ctx.main_operation_name = "EXECUTE_JIT_SAXPY";
         learning_ctx.operation_key = "lambda_SAXPY_generic";
@@ -142,39 +1014,88 @@ void VPUCore::execute_task(VPU_Task& task) {
     }
 
     if (!is_transform_focused || !learning_ctx.main_operation_name.empty()) {
-        if (task.task_type == "CONVOLUTION") {
+        if (context.op == TaskOp::CONVOLUTION) {
             if (!is_transform_focused) {
                 learning_ctx.main_operation_name = "CONV_DIRECT";
                 learning_ctx.operation_key = "lambda_Conv_Amp";
             }
-        } else if (task.task_type == "GEMM") {
+        } else if (context.op == TaskOp::GEMM) {
             // Corrected: Use chosen_plan for LearningContext creation
+            learning_ctx.operation_key = "lambda_Sparsity";
             for (const auto& step : chosen_plan.steps) {
-                if (step.operation_name == "GEMM_NAIVE" || step.operation_name == "GEMM_FLUX_ADAPTIVE") {
+                // A fused step (Pillar 6) is learned as itself, with the sensitivities of its final component.
+                const FusionRule* fused = find_fusion_rule(step.op_id);
+                const std::string& kind = fused ? fused->second : step.operation_name;
+                if (kind.compare(0, 5, "GEMM_") == 0) { // GEMM_NAIVE, GEMM_FLUX_ADAPTIVE, GEMM_AVX2, ...
+                    learning_ctx.main_operation_name = step.operation_name;
+                } else if (kind.compare(0, 5, "SPMM_") == 0) { // Sparse path: SPMM_CSR, SPMM_BSR, or fused with its conversion
                     learning_ctx.main_operation_name = step.operation_name;
-                    break;
+                    learning_ctx.operation_key = "lambda_SpMM_density";
+                } else if (kind.compare(0, 9, "DENSE_TO_") == 0 || kind.compare(0, 9, "QUANTIZE_") == 0) {
+                    learning_ctx.transform_key = step.operation_name; // Conversion cost (transform_costs)
                 }
             }
-            learning_ctx.operation_key = "lambda_Sparsity";
-        } else if (task.task_type == "SAXPY") {
+        } else if (context.op == TaskOp::SAXPY) {
             if (!is_transform_focused) {
+                 // Standard, vectorized (SAXPY_AVX2, ...) or reduced-precision (SAXPY_BF16, ...):
+                 // learn about the kernel that actually ran, and the quantization before it.
                  learning_ctx.main_operation_name = "SAXPY_STANDARD";
+                 for (const auto& step : chosen_plan.steps) {
+                     if (step.operation_name.compare(0, 9, "QUANTIZE_") == 0) {
+                         learning_ctx.transform_key = step.operation_name;
+                     } else if (step.operation_name.compare(0, 6, "SAXPY_") == 0) {
+                         learning_ctx.main_operation_name = step.operation_name;
+                         break;
+                     }
+                 }
                  learning_ctx.operation_key = "lambda_SAXPY_generic";
             }
         }
     }
-    // Pass the predicted flux of the *actually executed plan* to learn_from_feedback
-    pillar5_feedback_->learn_from_feedback(learning_ctx, chosen_plan.predicted_holistic_flux, last_perf_record_);
+    // A step that ran on a device is learned under that device's "<op>@<substrate>" beliefs.
+    for (const auto& step : chosen_plan.steps) {
+        if (step.device != HAL::HOST_DEVICE && step.cost_id != HAL::INVALID_OP_ID &&
+            step.operation_name == learning_ctx.main_operation_name) {
+            learning_ctx.main_operation_name = HAL::OperationRegistry::instance().name(step.cost_id);
+        }
+    }
+    const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
+    if (!learning_ctx.main_operation_name.empty()) {
+        learning_ctx.hw_sensitivity_key = learning_ctx.main_operation_name + "_lambda_hw_combined";
+        learning_ctx.main_operation_id = registry.find(learning_ctx.main_operation_name);
+        if (learning_ctx.main_operation_id != HAL::INVALID_OP_ID) {
+            learning_ctx.hw_sensitivity_id = registry.hw_sensitivity_id(learning_ctx.main_operation_id);
+        }
+    }
+    if (!learning_ctx.transform_key.empty()) learning_ctx.transform_id = registry.find(learning_ctx.transform_key);
+    if (!learning_ctx.operation_key.empty()) learning_ctx.operation_id = registry.find(learning_ctx.operation_key);
+    // Every step Pillar 3 priced by size shares the error in proportion to its work.
+    learning_ctx.cache_regime = context.shape.cache_regime;
+    for (const auto& step : chosen_plan.steps) {
+        if (step.work_units > 0.0) {
+            const bool on_device = step.device != HAL::HOST_DEVICE && step.cost_id != HAL::INVALID_OP_ID;
+            learning_ctx.size_terms.push_back({on_device ? step.cost_id : step.op_id, step.work_units});
+        }
+    }
+    return learning_ctx;
+}
 
-    // 5. RECORD & ADAPT (Pillar 6): Record the executed plan for graph analysis and potential fusion.
-    // The analyze_and_fuse_patterns() is called periodically from within record_executed_plan().
-    if (pillar6_task_graph_orchestrator_) {
-        pillar6_task_graph_orchestrator_->record_executed_plan(chosen_plan);
+namespace {
+
+// Doubles per vector register for the ISA cpu_conv_direct dispatches to.
+uint64_t double_simd_lanes(HAL::SimdIsa isa) {
+    switch (isa) {
+        case HAL::SimdIsa::AVX512: return 8;
+        case HAL::SimdIsa::AVX2: return 4;
+        case HAL::SimdIsa::NEON: return 2;
+        default: return 1;
     }
 }
 
+} // namespace
+
 void VPUCore::initialize_beliefs() {
-    hw_profile_ = std::make_shared<HardwareProfile>();
+    HardwareProfile profile;
     // Populate with some baseline beliefs (costs)
     // These would typically be loaded from a config file or calibration routine
 
@@ -185,162 +1106,458 @@ void VPUCore::initialize_beliefs() {
 
     // New way for Pillar 3 & 6 compatibility (flat map for base_operational_costs & transform_costs)
     // These are conceptual base costs for operations if they were run on a generic CPU.
-    hw_profile_->base_operational_costs["CONV_DIRECT"] = 200.0;
-    hw_profile_->base_operational_costs["ELEMENT_WISE_MULTIPLY"] = 50.0;
-    hw_profile_->base_operational_costs["GEMM_NAIVE"] = 500.0;
-    hw_profile_->base_operational_costs["GEMM_FLUX_ADAPTIVE"] = 450.0;
-    hw_profile_->base_operational_costs["SAXPY_STANDARD"] = 100.0;
-    hw_profile_->base_operational_costs["EXECUTE_JIT_SAXPY"] = 70.0; // Cost of executing a JITted kernel
+    profile.base_operational_costs["CONV_DIRECT"] = 200.0;
+    profile.base_operational_costs["ELEMENT_WISE_MULTIPLY"] = 50.0;
+    profile.base_operational_costs["GEMM_NAIVE"] = 500.0;
+    profile.base_operational_costs["GEMM_FLUX_ADAPTIVE"] = 450.0;
+    profile.base_operational_costs["SAXPY_STANDARD"] = 100.0;
+    profile.base_operational_costs["EXECUTE_JIT_SAXPY"] = 70.0; // Cost of executing a JITted kernel
+    // SIMD variants start with optimistic priors scaled by vector width; Pillar 5 corrects them.
+    profile.base_operational_costs["SAXPY_AVX2"] = 40.0;
+    profile.base_operational_costs["SAXPY_AVX512"] = 30.0;
+    profile.base_operational_costs["SAXPY_NEON"] = 45.0;
+    profile.base_operational_costs["GEMM_AVX2"] = 150.0;
+    profile.base_operational_costs["GEMM_AVX512"] = 120.0;
+    profile.base_operational_costs["GEMM_NEON"] = 180.0;
+    profile.base_operational_costs["GEMM_BLOCKED"] = 100.0;   // Packed, cache-tiled, register-blocked
+    profile.base_operational_costs["GEMM_BLOCKED_MT"] = 60.0; // Same, across the HAL thread pool
+    profile.base_operational_costs["SPMM_CSR"] = 20.0; // Plus a density-driven term (lambda_SpMM_density)
+    profile.base_operational_costs["SPMM_BSR"] = 25.0;
+    // Reduced-precision kernels (planned only within a task's accuracy bound) read narrower operands.
+    profile.base_operational_costs["SAXPY_BF16"] = 60.0;
+    profile.base_operational_costs["SAXPY_FP16"] = 70.0; // Widening FP16 costs more than shifting BF16
+    profile.base_operational_costs["SAXPY_INT8"] = 50.0;
+    profile.base_operational_costs["GEMM_BF16"] = 90.0;
+    profile.base_operational_costs["GEMM_FP16"] = 110.0;
+    profile.base_operational_costs["GEMM_INT8"] = 70.0;
 
     // Sensitivities (as used by Pillar 3)
-    hw_profile_->flux_sensitivities["lambda_Conv_Amp"] = 1.0;
-    hw_profile_->flux_sensitivities["lambda_Conv_Freq"] = 0.8;
-    hw_profile_->flux_sensitivities["lambda_Sparsity"] = 150.0; // Higher impact for sparsity
-    hw_profile_->flux_sensitivities["lambda_SAXPY_generic"] = 0.5;
+    profile.flux_sensitivities["lambda_Conv_Amp"] = 1.0;
+    profile.flux_sensitivities["lambda_Conv_Freq"] = 0.8;
+    profile.flux_sensitivities["lambda_Sparsity"] = 150.0; // Higher impact for sparsity
+    profile.flux_sensitivities["lambda_SAXPY_generic"] = 0.5;
+    profile.flux_sensitivities["lambda_SpMM_density"] = 400.0; // SpMM cost grows with the non-zero fraction of A
 
     // Example Beliefs for Transformations (Absolute cost in Flux units)
-    hw_profile_->transform_costs["FFT_FORWARD"] = 300.0;
-    hw_profile_->transform_costs["FFT_INVERSE"] = 280.0;
-    hw_profile_->transform_costs["JIT_COMPILE_SAXPY"] = 1000.0; // Cost of the JIT compilation step itself
+    profile.transform_costs["FFT_FORWARD"] = 300.0;
+    profile.transform_costs["FFT_INVERSE"] = 280.0;
+    profile.transform_costs["JIT_COMPILE_SAXPY"] = 1000.0; // Cost of the JIT compilation step itself
+    profile.transform_costs["JIT_KERNEL_CACHE_HIT"] = 5.0; // JIT_COMPILE_SAXPY when the kernel is already generated
+    profile.transform_costs["DENSE_TO_CSR"] = 60.0; // One pass over A per task (pre-encoded inputs skip it)
+    profile.transform_costs["DENSE_TO_BSR"] = 70.0;
+    profile.transform_costs["QUANTIZE_BF16"] = 20.0; // Per task: f32 operands -> the narrow type
+    profile.transform_costs["QUANTIZE_FP16"] = 25.0;
+    profile.transform_costs["QUANTIZE_INT8"] = 30.0;
 
     // New Hamming Weight sensitivities
-    hw_profile_->flux_sensitivities["SAXPY_STANDARD_lambda_hw_combined"] = 0.1;    // Default sensitivity
-    hw_profile_->flux_sensitivities["EXECUTE_JIT_SAXPY_lambda_hw_combined"] = 0.05; // JIT might be less sensitive to input HW
-    hw_profile_->flux_sensitivities["GEMM_NAIVE_lambda_hw_combined"] = 0.2;
-    hw_profile_->flux_sensitivities["GEMM_FLUX_ADAPTIVE_lambda_hw_combined"] = 0.15;
-    hw_profile_->flux_sensitivities["CONV_DIRECT_lambda_hw_combined"] = 0.25;
+    profile.flux_sensitivities["SAXPY_STANDARD_lambda_hw_combined"] = 0.1;    // Default sensitivity
+    profile.flux_sensitivities["EXECUTE_JIT_SAXPY_lambda_hw_combined"] = 0.05; // JIT might be less sensitive to input HW
+    profile.flux_sensitivities["GEMM_NAIVE_lambda_hw_combined"] = 0.2;
+    profile.flux_sensitivities["GEMM_FLUX_ADAPTIVE_lambda_hw_combined"] = 0.15;
+    profile.flux_sensitivities["CONV_DIRECT_lambda_hw_combined"] = 0.25;
+    profile.flux_sensitivities["SAXPY_AVX2_lambda_hw_combined"] = 0.1;
+    profile.flux_sensitivities["SAXPY_AVX512_lambda_hw_combined"] = 0.1;
+    profile.flux_sensitivities["SAXPY_NEON_lambda_hw_combined"] = 0.1;
+    profile.flux_sensitivities["GEMM_AVX2_lambda_hw_combined"] = 0.2;
+    profile.flux_sensitivities["GEMM_AVX512_lambda_hw_combined"] = 0.2;
+    profile.flux_sensitivities["GEMM_NEON_lambda_hw_combined"] = 0.2;
+    profile.flux_sensitivities["GEMM_BLOCKED_lambda_hw_combined"] = 0.2;
+    profile.flux_sensitivities["GEMM_BLOCKED_MT_lambda_hw_combined"] = 0.2;
+    profile.flux_sensitivities["SPMM_CSR_lambda_hw_combined"] = 0.05; // Only non-zeros are touched
+    profile.flux_sensitivities["SPMM_BSR_lambda_hw_combined"] = 0.08;
+    profile.flux_sensitivities["SAXPY_BF16_lambda_hw_combined"] = 0.05; // Narrow operands carry fewer bits
+    profile.flux_sensitivities["SAXPY_FP16_lambda_hw_combined"] = 0.05;
+    profile.flux_sensitivities["SAXPY_INT8_lambda_hw_combined"] = 0.03;
+    profile.flux_sensitivities["GEMM_BF16_lambda_hw_combined"] = 0.1;
+    profile.flux_sensitivities["GEMM_FP16_lambda_hw_combined"] = 0.1;
+    profile.flux_sensitivities["GEMM_INT8_lambda_hw_combined"] = 0.05;
     // ELEMENT_WISE_MULTIPLY might also have one if it's made data-dependent beyond base cost
-    // hw_profile_->flux_sensitivities["ELEMENT_WISE_MULTIPLY_lambda_hw_combined"] = 0.05;
+    // profile.flux_sensitivities["ELEMENT_WISE_MULTIPLY_lambda_hw_combined"] = 0.05;
 
+    // Size models: flux per unit of work, from the cycle costs the kernels report (see
+    // initialize_hal). Pillar 5 learns each cache regime's coefficient from there.
+    profile.size_models["SAXPY_STANDARD"] = SizeModel::uniform(Complexity::LINEAR, 2.0); // 1 mul + 1 add per element
+    profile.size_models["SAXPY_AVX2"] = SizeModel::uniform(Complexity::LINEAR, 2.0 / 8);
+    profile.size_models["SAXPY_AVX512"] = SizeModel::uniform(Complexity::LINEAR, 2.0 / 16);
+    profile.size_models["SAXPY_NEON"] = SizeModel::uniform(Complexity::LINEAR, 2.0 / 4);
+    profile.size_models["EXECUTE_JIT_SAXPY"] = SizeModel::uniform(Complexity::LINEAR, 2.0);
+    profile.size_models["GEMM_NAIVE"] = SizeModel::uniform(Complexity::MNK, 2.0);
+    profile.size_models["GEMM_FLUX_ADAPTIVE"] = SizeModel::uniform(Complexity::MNK, 2.0);
+    profile.size_models["GEMM_AVX2"] = SizeModel::uniform(Complexity::MNK, 2.0 / 8);
+    profile.size_models["GEMM_AVX512"] = SizeModel::uniform(Complexity::MNK, 2.0 / 16);
+    profile.size_models["GEMM_NEON"] = SizeModel::uniform(Complexity::MNK, 2.0 / 4);
+    profile.size_models["GEMM_BLOCKED"] = SizeModel::uniform(Complexity::MNK, 2.0 / 16);
+    profile.size_models["GEMM_BLOCKED_MT"] = SizeModel::uniform(Complexity::MNK, 2.0 / (16 * HAL::gemm_blocked_thread_count()));
+    profile.size_models["DENSE_TO_CSR"] = SizeModel::uniform(Complexity::LINEAR, 1.0); // One pass over A
+    profile.size_models["DENSE_TO_BSR"] = SizeModel::uniform(Complexity::LINEAR, 1.0);
+    profile.size_models["QUANTIZE_BF16"] = SizeModel::uniform(Complexity::LINEAR, 2.0); // Range pass + rounding pass
+    profile.size_models["QUANTIZE_FP16"] = SizeModel::uniform(Complexity::LINEAR, 2.0);
+    profile.size_models["QUANTIZE_INT8"] = SizeModel::uniform(Complexity::LINEAR, 2.0);
+    profile.size_models["SAXPY_BF16"] = SizeModel::uniform(Complexity::LINEAR, 1.5); // x is read narrow, y stays f32
+    profile.size_models["SAXPY_FP16"] = SizeModel::uniform(Complexity::LINEAR, 1.5);
+    profile.size_models["SAXPY_INT8"] = SizeModel::uniform(Complexity::LINEAR, 1.25);
+    profile.size_models["GEMM_BF16"] = SizeModel::uniform(Complexity::MNK, 2.0 / 8); // Widened panels, vectorized FMA
+    profile.size_models["GEMM_FP16"] = SizeModel::uniform(Complexity::MNK, 2.0 / 8);
+    profile.size_models["GEMM_INT8"] = SizeModel::uniform(Complexity::MNK, 2.0 / 16); // int32 multiply-adds
+    profile.size_models["SPMM_CSR"] = SizeModel::uniform(Complexity::SPARSE_MNK, 2.0); // Per stored value per column
+    profile.size_models["SPMM_BSR"] = SizeModel::uniform(Complexity::SPARSE_MNK, 2.0);
+    profile.size_models["CONV_DIRECT"] = SizeModel::uniform(Complexity::N_TAPS, 2.0 / double_simd_lanes(HAL::best_simd_isa()));
+    profile.size_models["FFT_FORWARD"] = SizeModel::uniform(Complexity::N_LOG_N, 5.0);
+    profile.size_models["FFT_INVERSE"] = SizeModel::uniform(Complexity::N_LOG_N, 5.0);
+    profile.size_models["ELEMENT_WISE_MULTIPLY"] = SizeModel::uniform(Complexity::LINEAR, 6.0); // 6 flops per complex product
 
-    std::cout << "[VPUCore] Initial beliefs populated (with Pillar3/6 compatible costs)." << std::endl;
+
+    hw_profile_ = std::make_shared<HardwareProfileStore>(std::move(profile));
+    VPU_LOG_INFO("[VPUCore] Initial beliefs populated (with Pillar3/6 compatible costs).");
 }
 
-#include "hal/hal_utils.h" // For VPU::HAL::calculate_data_hamming_weight
-#include "hal/hal.h"       // For VPU::HAL::cpu_saxpy etc. (already included via vpu_core.h usually)
+namespace {
 
-void VPUCore::initialize_hal() {
-    kernel_lib_ = std::make_shared<HAL::KernelLibrary>();
+template <typename T> using SaxpyFnOf = void (*)(T, HAL::Span<const T>, HAL::Span<T>);
+template <typename T> using GemmFnOf = void (*)(HAL::Span<const T>, HAL::Span<const T>, HAL::Span<T>, int, int, int);
+using SaxpyFn = SaxpyFnOf<float>;
+using GemmFn = GemmFnOf<float>;
 
-    // SAXPY_STANDARD Kernel
-    (*kernel_lib_)["SAXPY_STANDARD"] = [](VPU_Task& task) -> HAL::KernelFluxReport {
-        HAL::KernelFluxReport report;
-        if (!task.data_in_a || !task.data_out || task.num_elements == 0) {
-            std::cerr << "SAXPY_STANDARD: Invalid data pointers or zero elements." << std::endl;
-            return {0,0,0};
-        }
-        const float* x_ptr = static_cast<const float*>(task.data_in_a);
-        // Assuming task.data_in_b might hold 'y' for SAXPY if 'a' is in task.alpha
-        // Or, more likely, task.data_out is also the input 'y' for SAXPY (in-place like)
-        // For this example, let's assume data_out is y and is modified in place.
-        // And task.data_in_a is x.
-        float* y_ptr = static_cast<float*>(task.data_out);
+template <typename T>
+HAL::KernelFluxReport run_saxpy(SaxpyFnOf<T> fn, uint64_t lanes, VPU_Task& task) {
+    HAL::KernelFluxReport report;
+    // task.data_in_a is x; task.data_out is y, which SAXPY updates in place.
+    HAL::Span<const T> x = HAL::as_span<T>(task.data_in_a, task.num_elements);
+    HAL::Span<T> y = HAL::as_mutable_span<T>(task.data_out, task.num_elements);
 
-        std::vector<float> x_vec(x_ptr, x_ptr + task.num_elements);
-        std::vector<float> y_vec(y_ptr, y_ptr + task.num_elements); // y is input/output
+    report.hw_in_cost = HAL::hamming_weight_reusing(x.data(), x.size_bytes());
+    report.hw_in_cost += HAL::calculate_data_hamming_weight(y.data(), y.size_bytes()); // Initial Y
 
-        report.hw_in_cost = HAL::calculate_data_hamming_weight(x_vec.data(), x_vec.size() * sizeof(float));
-        report.hw_in_cost += HAL::calculate_data_hamming_weight(y_vec.data(), y_vec.size() * sizeof(float)); // Initial Y
+    fn(static_cast<T>(task.alpha), x, y);
 
-        HAL::cpu_saxpy(task.alpha, x_vec, y_vec); // y_vec is updated here
+    report.hw_out_cost = HAL::calculate_data_hamming_weight(y.data(), y.size_bytes());
+    report.cycle_cost = ((task.num_elements + lanes - 1) / lanes) * 2; // 1 mul, 1 add per vector
+    return report;
+}
 
-        // Copy data back from y_vec to task.data_out if necessary (it is, as y_vec is a copy)
-        for(size_t i = 0; i < task.num_elements; ++i) y_ptr[i] = y_vec[i];
+template <typename T>
+HAL::KernelFluxReport run_gemm(GemmFnOf<T> fn, uint64_t lanes, VPU_Task& task, int M, int N, int K) {
+    HAL::KernelFluxReport report;
+    HAL::Span<const T> A = HAL::as_span<T>(task.data_in_a, static_cast<size_t>(M) * K);
+    HAL::Span<const T> B = HAL::as_span<T>(task.data_in_b, static_cast<size_t>(K) * N);
+    HAL::Span<T> C = HAL::as_mutable_span<T>(task.data_out, static_cast<size_t>(M) * N);
 
-        report.hw_out_cost = HAL::calculate_data_hamming_weight(y_vec.data(), y_vec.size() * sizeof(float));
-        report.cycle_cost = task.num_elements * 2; // 1 mul, 1 add
-        return report;
+    report.hw_in_cost = HAL::hamming_weight_reusing(A.data(), A.size_bytes());
+    report.hw_in_cost += HAL::calculate_data_hamming_weight(B.data(), B.size_bytes());
+
+    fn(A, B, C, M, N, K); // Writes C directly
+
+    report.hw_out_cost = HAL::calculate_data_hamming_weight(C.data(), C.size_bytes());
+    const uint64_t mults = static_cast<uint64_t>(M) * N * K;
+    report.cycle_cost = ((mults + lanes - 1) / lanes) * 2; // Roughly M*N*K multiply-adds
+    return report;
+}
+
+// Wraps a SAXPY implementation as a flux-reporting kernel. 'lanes' is the vector width,
+// so the reported cycle cost reflects one fused multiply-add per vector of elements.
+// The kernel runs the instance for the task's element type: 'fn' for f32, 'fn_f64' (if any) for f64.
+HAL::GenericKernel make_saxpy_kernel(const std::string& name, SaxpyFn fn, uint64_t lanes,
+                                     SaxpyFnOf<double> fn_f64 = nullptr) {
+    return [name, fn, lanes, fn_f64](VPU_Task& task) -> HAL::KernelFluxReport {
+        if (!task.data_in_a || !task.data_out || task.num_elements == 0) {
+            VPU_LOG_WARN(name << ": Invalid data pointers or zero elements.");
+            return {0,0,0};
+        }
+        const HAL::ElementType type = input_element_type(task);
+        if (type == HAL::ElementType::FLOAT32) return run_saxpy<float>(fn, lanes, task);
+        if (type == HAL::ElementType::FLOAT64 && fn_f64) return run_saxpy<double>(fn_f64, lanes, task);
+        VPU_LOG_WARN(name << ": No " << HAL::element_type_name(type) << " instance.");
+        return {0,0,0};
     };
+}
 
-    // GEMM_NAIVE Kernel
-    (*kernel_lib_)["GEMM_NAIVE"] = [](VPU_Task& task) -> HAL::KernelFluxReport {
-        HAL::KernelFluxReport report;
-        // Assuming M, N, K are packed into VPU_Task extended_params or similar
-        // For simplicity, let's assume num_elements means M*K for A, and K*N for B, M*N for C
-        // This is a gross simplification. A real system needs proper dimension handling.
+// Wraps a GEMM implementation as a flux-reporting kernel (see make_saxpy_kernel for 'lanes' and 'fn_f64').
+HAL::GenericKernel make_gemm_kernel(const std::string& name, GemmFn fn, uint64_t lanes,
+                                    GemmFnOf<double> fn_f64 = nullptr) {
+    return [name, fn, lanes, fn_f64](VPU_Task& task) -> HAL::KernelFluxReport {
+        // M, N, K are passed in VPU_Task::extended_params; A is MxK, B is KxN, C is MxN (row-major).
         if (!task.data_in_a || !task.data_in_b || !task.data_out ||
             !task.extended_params.count("M") || !task.extended_params.count("N") || !task.extended_params.count("K")) {
-            std::cerr << "GEMM_NAIVE: Invalid data pointers or missing M, N, K dimensions." << std::endl;
+            VPU_LOG_WARN(name << ": Invalid data pointers or missing M, N, K dimensions.");
             return {0,0,0};
         }
         int M = task.extended_params["M"];
         int N = task.extended_params["N"];
         int K = task.extended_params["K"];
+        const HAL::ElementType type = input_element_type(task);
+        if (type == HAL::ElementType::FLOAT32) return run_gemm<float>(fn, lanes, task, M, N, K);
+        if (type == HAL::ElementType::FLOAT64 && fn_f64) return run_gemm<double>(fn_f64, lanes, task, M, N, K);
+        VPU_LOG_WARN(name << ": No " << HAL::element_type_name(type) << " instance.");
+        return {0,0,0};
+    };
+}
 
-        const float* A_ptr = static_cast<const float*>(task.data_in_a);
-        const float* B_ptr = static_cast<const float*>(task.data_in_b);
-        float* C_ptr = static_cast<float*>(task.data_out);
+} // namespace
 
-        std::vector<float> A_vec(A_ptr, A_ptr + (M * K));
-        std::vector<float> B_vec(B_ptr, B_ptr + (K * N));
-        std::vector<float> C_vec(M * N); // Output buffer, HAL::cpu_gemm_naive will fill it
+void VPUCore::initialize_hal() {
+    kernel_lib_ = std::make_shared<HAL::KernelLibrary>();
 
-        report.hw_in_cost = HAL::calculate_data_hamming_weight(A_vec.data(), A_vec.size() * sizeof(float));
-        report.hw_in_cost += HAL::calculate_data_hamming_weight(B_vec.data(), B_vec.size() * sizeof(float));
+    // Kernels operate directly on the task's buffers through HAL::Span views (no staging copies).
 
-        HAL::cpu_gemm_naive(A_vec, B_vec, C_vec, M, N, K);
+    // SAXPY_STANDARD Kernel (scalar baseline)
+    (*kernel_lib_)["SAXPY_STANDARD"] = make_saxpy_kernel("SAXPY_STANDARD", &HAL::cpu_saxpy, 1, &HAL::cpu_saxpy_scalar<double>);
 
-        for(size_t i = 0; i < (size_t)(M*N); ++i) C_ptr[i] = C_vec[i]; // Copy out
+    // GEMM_NAIVE Kernel
+    (*kernel_lib_)["GEMM_NAIVE"] = make_gemm_kernel("GEMM_NAIVE", &HAL::cpu_gemm_naive, 1, &HAL::cpu_gemm_naive_scalar<double>);
+
+    // Cache-blocked GEMM: the micro-kernel retires one 16-wide FMA row per cycle when vectorized.
+    (*kernel_lib_)["GEMM_BLOCKED"] = make_gemm_kernel("GEMM_BLOCKED", &HAL::cpu_gemm_blocked, 16);
+    (*kernel_lib_)["GEMM_BLOCKED_MT"] = make_gemm_kernel("GEMM_BLOCKED_MT", &HAL::cpu_gemm_blocked_mt,
+                                                         16 * HAL::gemm_blocked_thread_count());
+
+    // Vectorized variants are registered only where the CPU can run them, so the Orchestrator
+    // never proposes a plan the Cerebellum cannot dispatch. Each is learned independently.
+    if (HAL::cpu_supports(HAL::SimdIsa::AVX2)) {
+        (*kernel_lib_)["SAXPY_AVX2"] = make_saxpy_kernel("SAXPY_AVX2", &HAL::cpu_saxpy_avx2, 8);
+        (*kernel_lib_)["GEMM_AVX2"] = make_gemm_kernel("GEMM_AVX2", &HAL::cpu_gemm_avx2, 8);
+    }
+    if (HAL::cpu_supports(HAL::SimdIsa::AVX512)) {
+        (*kernel_lib_)["SAXPY_AVX512"] = make_saxpy_kernel("SAXPY_AVX512", &HAL::cpu_saxpy_avx512, 16);
+        (*kernel_lib_)["GEMM_AVX512"] = make_gemm_kernel("GEMM_AVX512", &HAL::cpu_gemm_avx512, 16);
+    }
+    if (HAL::cpu_supports(HAL::SimdIsa::NEON)) {
+        (*kernel_lib_)["SAXPY_NEON"] = make_saxpy_kernel("SAXPY_NEON", &HAL::cpu_saxpy_neon, 4);
+        (*kernel_lib_)["GEMM_NEON"] = make_gemm_kernel("GEMM_NEON", &HAL::cpu_gemm_neon, 4);
+    }
+    VPU_LOG_INFO("[VPUCore] Widest SIMD ISA detected: " << HAL::simd_isa_name(HAL::best_simd_isa()));
 
-        report.hw_out_cost = HAL::calculate_data_hamming_weight(C_vec.data(), C_vec.size() * sizeof(float));
-        report.cycle_cost = M * N * K * 2; // Roughly M*N*K multiply-adds
+    // CONVOLUTION kernels. Both plans produce the first num_elements samples of
+    // data_in_a * conv_filter. In the frequency-domain plan the Cerebellum points each stage at
+    // its buffers: input -> temp_freq (block spectra) -> temp_result -> output.
+    (*kernel_lib_)["CONV_DIRECT"] = [](VPU_Task& task) -> HAL::KernelFluxReport {
+        if (!task.data_in_a || !task.data_out || task.num_elements == 0 || task.conv_filter.empty()) {
+            VPU_LOG_WARN("CONV_DIRECT: Invalid data pointers, zero elements or no filter taps.");
+            return {0,0,0};
+        }
+        HAL::Span<const double> x = HAL::as_span<double>(task.data_in_a, task.num_elements);
+        HAL::Span<double> y = HAL::as_mutable_span<double>(task.data_out, task.num_elements);
+        HAL::KernelFluxReport report;
+        report.hw_in_cost = HAL::hamming_weight_reusing(x.data(), x.size_bytes());
+        report.hw_in_cost += HAL::calculate_data_hamming_weight(task.conv_filter.data(), task.conv_filter.size_bytes());
+        if (!HAL::cpu_conv_direct(x, task.conv_filter, y)) {
+            return {0,0,0};
+        }
+        report.hw_out_cost = HAL::calculate_data_hamming_weight(y.data(), y.size_bytes());
+        const uint64_t lanes = double_simd_lanes(HAL::best_simd_isa());
+        const uint64_t mults = static_cast<uint64_t>(task.num_elements) * task.conv_filter.size();
+        report.cycle_cost = ((mults + lanes - 1) / lanes) * 2; // One multiply-add per tap per output
         return report;
     };
 
-    // FFT_FORWARD Kernel (Double precision)
+    // FFT_FORWARD Kernel (Double precision). With filter taps it transforms the overlap-save
+    // blocks of the signal; otherwise data_out receives the full N/2+1-value spectrum of data_in_a.
     (*kernel_lib_)["FFT_FORWARD"] = [](VPU_Task& task) -> HAL::KernelFluxReport {
         HAL::KernelFluxReport report;
         if (!task.data_in_a || !task.data_out || task.num_elements == 0) {
-            std::cerr << "FFT_FORWARD: Invalid data pointers or zero elements." << std::endl;
+            VPU_LOG_WARN("FFT_FORWARD: Invalid data pointers or zero elements.");
             return {0,0,0};
         }
-        const double* in_ptr = static_cast<const double*>(task.data_in_a);
-        double* out_ptr = static_cast<double*>(task.data_out); // Output buffer for FFT
-
-        std::vector<double> in_vec(in_ptr, in_ptr + task.num_elements);
-        // FFT output size is typically N/2+1 complex, but hal function takes N doubles for out
-        // For simplicity, assume HAL::cpu_fft_forward handles output vector sizing or expects it pre-sized.
-        // Let's assume output is also task.num_elements for this HAL function.
-        std::vector<double> out_vec(task.num_elements);
+        HAL::Span<const double> in = HAL::as_span<double>(task.data_in_a, task.num_elements);
+        report.hw_in_cost = HAL::hamming_weight_reusing(in.data(), in.size_bytes());
 
+        HAL::Span<double> out;
+        if (!task.conv_filter.empty()) {
+            const HAL::OverlapSaveLayout layout = HAL::plan_overlap_save(task.num_elements, task.conv_filter.size());
+            out = HAL::as_mutable_span<double>(task.data_out, layout.spectra_doubles());
+            if (!HAL::overlap_save_forward(in, layout, out)) {
+                return {0,0,0};
+            }
+            report.cycle_cost = static_cast<uint64_t>(layout.blocks * layout.fft_length * std::log2(layout.fft_length) * 5);
+        } else {
+            out = HAL::as_mutable_span<double>(task.data_out, HAL::fft_spectrum_doubles(task.num_elements));
+            if (task.data_out_size_bytes != 0 && task.data_out_size_bytes < out.size_bytes()) {
+                VPU_LOG_WARN("FFT_FORWARD: data_out holds " << task.data_out_size_bytes << " bytes; the spectrum needs "
+                          << out.size_bytes() << ".");
+                return {0,0,0};
+            }
+            if (!HAL::cpu_fft_forward(in, out)) {
+                return {0,0,0};
+            }
+            // Cycle cost for FFT is roughly N log N
+            report.cycle_cost = static_cast<uint64_t>(task.num_elements * std::log2(task.num_elements) * 5); // *5 as a scaling factor
+        }
+        report.hw_out_cost = HAL::calculate_data_hamming_weight(out.data(), out.size_bytes());
+        return report;
+    };
 
-        report.hw_in_cost = HAL::calculate_data_hamming_weight(in_vec.data(), in_vec.size() * sizeof(double));
-
-        HAL::cpu_fft_forward(in_vec, out_vec);
-
-        for(size_t i=0; i<task.num_elements; ++i) out_ptr[i] = out_vec[i];
-
+    // ELEMENT_WISE_MULTIPLY: the block spectra in data_in_a times the filter's, into data_out.
+    (*kernel_lib_)["ELEMENT_WISE_MULTIPLY"] = [](VPU_Task& task) -> HAL::KernelFluxReport {
+        if (!task.data_in_a || !task.data_out || task.num_elements == 0 || task.conv_filter.empty()) {
+            VPU_LOG_WARN("ELEMENT_WISE_MULTIPLY: Invalid data pointers, zero elements or no filter taps.");
+            return {0,0,0};
+        }
+        const HAL::OverlapSaveLayout layout = HAL::plan_overlap_save(task.num_elements, task.conv_filter.size());
+        HAL::Span<const double> spectra = HAL::as_span<double>(task.data_in_a, layout.spectra_doubles());
+        HAL::Span<double> products = HAL::as_mutable_span<double>(task.data_out, layout.spectra_doubles());
+        HAL::KernelFluxReport report;
+        report.hw_in_cost = HAL::calculate_data_hamming_weight(spectra.data(), spectra.size_bytes());
+        if (!HAL::overlap_save_multiply(spectra, task.conv_filter, layout, products)) {
+            return {0,0,0};
+        }
+        report.hw_out_cost = HAL::calculate_data_hamming_weight(products.data(), products.size_bytes());
+        // The filter's transform, plus 4 multiplies and 2 adds per complex value
+        report.cycle_cost = static_cast<uint64_t>(layout.fft_length * std::log2(layout.fft_length) * 5) +
+                            static_cast<uint64_t>(layout.blocks) * (layout.fft_length / 2 + 1) * 6;
+        return report;
+    };
 
-        report.hw_out_cost = HAL::calculate_data_hamming_weight(out_vec.data(), out_vec.size() * sizeof(double));
-        // Cycle cost for FFT is roughly N log N
-        if (task.num_elements > 0) {
-            report.cycle_cost = static_cast<uint64_t>(task.num_elements * std::log2(task.num_elements) * 5); // *5 as a scaling factor
+    // FFT_INVERSE Kernel: the inverse of FFT_FORWARD (normalized; data_out receives num_elements samples).
+    (*kernel_lib_)["FFT_INVERSE"] = [](VPU_Task& task) -> HAL::KernelFluxReport {
+        if (!task.data_in_a || !task.data_out || task.num_elements == 0) {
+            VPU_LOG_WARN("FFT_INVERSE: Invalid data pointers or zero elements.");
+            return {0,0,0};
+        }
+        HAL::Span<double> out = HAL::as_mutable_span<double>(task.data_out, task.num_elements);
+        HAL::KernelFluxReport report;
+        if (!task.conv_filter.empty()) {
+            const HAL::OverlapSaveLayout layout = HAL::plan_overlap_save(task.num_elements, task.conv_filter.size());
+            HAL::Span<const double> products = HAL::as_span<double>(task.data_in_a, layout.spectra_doubles());
+            report.hw_in_cost = HAL::calculate_data_hamming_weight(products.data(), products.size_bytes());
+            if (!HAL::overlap_save_inverse(products, layout, out)) {
+                return {0,0,0};
+            }
+            report.cycle_cost = static_cast<uint64_t>(layout.blocks * layout.fft_length * std::log2(layout.fft_length) * 5);
         } else {
-            report.cycle_cost = 0;
+            HAL::Span<const double> spectrum = HAL::as_span<double>(task.data_in_a, HAL::fft_spectrum_doubles(task.num_elements));
+            report.hw_in_cost = HAL::calculate_data_hamming_weight(spectrum.data(), spectrum.size_bytes());
+            if (!HAL::cpu_fft_inverse(spectrum, out, static_cast<int>(task.num_elements))) {
+                return {0,0,0};
+            }
+            report.cycle_cost = static_cast<uint64_t>(task.num_elements * std::log2(task.num_elements) * 5);
         }
+        report.hw_out_cost = HAL::calculate_data_hamming_weight(out.data(), out.size_bytes());
         return report;
     };
 
-    // TODO: Add other kernels like FFT_INVERSE, GEMM_FLUX_ADAPTIVE, CONV_DIRECT etc.
+    VPU_LOG_INFO("[VPUCore] HAL and Kernel Library initialized with new flux-reporting kernels.");
+
+    devices_ = std::make_shared<HAL::DeviceTable>(kernel_lib_);
+#if defined(VPU_HAL_WITH_CUDA)
+    if (std::shared_ptr<HAL::Device> gpu = HAL::make_cuda_device(0)) {
+        add_device(gpu);
+    }
+#endif
+}
+
+ProfileLoadResult VPUCore::load_beliefs(const std::string& path, bool any_host) {
+    ProfileLoadResult result = ProfileLoadResult::MISSING;
+    // Applied to the staging copy under the writer lock, so concurrent learning is not lost.
+    uint64_t version = hw_profile_->update([&](HardwareProfile& beliefs) { result = load_profile(path, beliefs, any_host); });
+    if (result == ProfileLoadResult::LOADED) {
+        VPU_LOG_INFO("[VPUCore] Loaded beliefs from '" << path << "' (belief version " << version << ").");
+    }
+    return result;
+}
 
-    std::cout << "[VPUCore] HAL and Kernel Library initialized with new flux-reporting kernels." << std::endl;
+bool VPUCore::save_beliefs(const std::string& path) const {
+    return save_profile(path, *hw_profile_->snapshot());
+}
+
+void VPUCore::enable_belief_persistence(const std::string& path, std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(checkpointer_mutex_);
+    belief_checkpointer_.reset(); // Final checkpoint to the previous file, if any
+    if (path.empty()) {
+        return;
+    }
+    if (load_beliefs(path) == ProfileLoadResult::MISSING) {
+        VPU_LOG_INFO("[VPUCore] No saved beliefs at '" << path << "'; starting from the built-in priors.");
+    }
+    belief_checkpointer_ = std::make_unique<ProfileCheckpointer>(hw_profile_, path, interval);
+}
+
+std::shared_future<CalibrationReport> VPUCore::start_cost_calibration(const CalibrationOptions& options) {
+    // The calibrator times its own copies of the kernels, so Pillar 6 can keep registering fused ones.
+    CostCalibrator::KernelSet kernels;
+    {
+        std::shared_lock<std::shared_mutex> kernel_lock(kernel_lib_mutex_);
+        kernel_lib_->for_each([&kernels](HAL::OpId id, const HAL::GenericKernel& kernel) { kernels.emplace_back(id, kernel); });
+    }
+    std::lock_guard<std::mutex> lock(calibrator_mutex_);
+    calibrator_.reset();
+    VPU_LOG_INFO("[VPUCore] Calibrating the cost model for " << kernels.size() << " kernel(s) in the background.");
+    calibrator_ = std::make_unique<CostCalibrator>(hw_profile_, std::move(kernels), options);
+    return calibrator_->result();
+}
+
+void VPUCore::set_iot_telemetry(std::shared_ptr<TelemetryPoller> poller, std::chrono::milliseconds max_age) {
+    pillar2_cortex_->set_telemetry_poller(std::move(poller), max_age);
+}
+
+HAL::DeviceId VPUCore::add_device(std::shared_ptr<HAL::Device> device) {
+    if (!device) {
+        throw std::runtime_error("VPUCore::add_device: device is null.");
+    }
+    // Offer the device every operation the host has a believed cost for.
+    const HAL::OperationRegistry& registry = HAL::OperationRegistry::instance();
+    HardwareProfileSnapshot beliefs = hw_profile_->snapshot();
+    std::vector<HAL::OpId> ops;
+    auto collect = [&](const std::string& name, double) { ops.push_back(registry.find(name)); };
+    beliefs->base_operational_costs.for_each(collect);
+    beliefs->transform_costs.for_each(collect);
+    std::sort(ops.begin(), ops.end());
+    ops.erase(std::unique(ops.begin(), ops.end()), ops.end());
+
+    const HAL::DeviceId id = devices_->add(device, ops);
+    HAL::DeviceTable::Snapshot table = devices_->snapshot();
+    const HAL::DeviceTable::Entry& entry = (*table)[id];
+
+    // Seed the device's beliefs from the host's, without overwriting anything already learned.
+    size_t seeded_ops = 0;
+    hw_profile_->update([&](HardwareProfile& profile) {
+        for (HAL::OpId op : ops) {
+            const HAL::OpId cost_id = entry.cost_id(op);
+            if (cost_id == HAL::INVALID_OP_ID) continue;
+            ++seeded_ops;
+            for (CostTable* table_for_op : {&profile.base_operational_costs, &profile.transform_costs}) {
+                const double* host_cost = table_for_op->find(op);
+                if (host_cost && !table_for_op->find(cost_id)) {
+                    (*table_for_op)[cost_id] = *host_cost * device->cost_prior_scale(op);
+                }
+            }
+            const SizeModel* host_model = profile.size_models.find(op);
+            if (host_model && !profile.size_models.find(cost_id)) {
+                SizeModel device_model = *host_model;
+                for (double& per_unit : device_model.per_unit) per_unit *= device->cost_prior_scale(op);
+                profile.size_models[cost_id] = device_model;
+            }
+            const double* host_sensitivity = profile.flux_sensitivities.find(registry.hw_sensitivity_id(op));
+            const HAL::OpId device_sensitivity = registry.hw_sensitivity_id(cost_id);
+            if (host_sensitivity && !profile.flux_sensitivities.find(device_sensitivity)) {
+                profile.flux_sensitivities[device_sensitivity] = *host_sensitivity;
+            }
+        }
+        if (!profile.transform_costs.find(entry.transfer_id)) {
+            profile.transform_costs[entry.transfer_id] = device->transfer_cost_per_mib();
+        }
+    });
+    VPU_LOG_INFO("[VPUCore] Added device '" << device->substrate() << "' (id " << id << ") for "
+              << seeded_ops << " operation(s).");
+    return id;
 }
 
 void VPUCore::print_current_beliefs() {
+    Runtime::flush_logs(); // Keep buffered messages ahead of the dump
+    HardwareProfileSnapshot beliefs = hw_profile_ ? hw_profile_->snapshot() : nullptr;
     std::cout << "\n===== VPU Current Beliefs (Hardware Profile) =====" << std::endl;
-    if (hw_profile_) {
+    if (beliefs) {
+        std::cout << "Belief Version: " << beliefs->version << std::endl;
         std::cout << "Base Operational Costs:" << std::endl;
-        for (const auto& pair : hw_profile_->base_operational_costs) {
-            std::cout << "  - Op: " << pair.first << ", Cost: " << pair.second << std::endl;
-        }
+        beliefs->base_operational_costs.for_each([](const std::string& name, double value) {
+            std::cout << "  - Op: " << name << ", Cost: " << value << std::endl;
+        });
         std::cout << "Transform Costs:" << std::endl;
-        for (const auto& pair : hw_profile_->transform_costs) {
-            std::cout << "  - Transform: " << pair.first << ", Cost: " << pair.second << std::endl;
-        }
+        beliefs->transform_costs.for_each([](const std::string& name, double value) {
+            std::cout << "  - Transform: " << name << ", Cost: " << value << std::endl;
+        });
         std::cout << "Flux Sensitivities (Lambdas):" << std::endl;
-        for (const auto& pair : hw_profile_->flux_sensitivities) {
-            std::cout << "  - Lambda: " << pair.first << ", Value: " << pair.second << std::endl;
-        }
+        beliefs->flux_sensitivities.for_each([](const std::string& name, double value) {
+            std::cout << "  - Lambda: " << name << ", Value: " << value << std::endl;
+        });
         // This part is for the old structure, can be removed if fully migrated
         // std::cout << "Raw Hardware Profile Data (if any using old structure):" << std::endl;
         // for (const auto& pair : *hw_profile_) { // Assuming hw_profile_ is still the map itself for this part
@@ -360,7 +1577,8 @@ void VPUCore::print_current_beliefs() {
     std::cout << "==============================================\n" << std::endl;
 }
 
-const ActualPerformanceRecord& VPUCore::get_last_performance_record() const {
+ActualPerformanceRecord VPUCore::get_last_performance_record() const {
+    std::lock_guard<std::mutex> state_lock(cognitive_state_mutex_); // Written by every task's LEARN stage
     return last_perf_record_;
 }
 
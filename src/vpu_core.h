@@ -7,34 +7,181 @@
 #include "core/Pillar4_Cerebellum.h"
 #include "core/Pillar5_Feedback.h"
 #include "core/Pillar6_TaskGraphOrchestrator.h" // Added Pillar 6
+#include "core/ProfilePlanCache.h"
+#include "core/ProfilePersistence.h"
+#include "core/CostCalibrator.h"
 #include "hal/hal.h"
+#include "runtime/worker_pool.h"
+#include "runtime/work_stealing_pool.h"
+#include "runtime/metrics.h"
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <future>
+#include <atomic>
+#include <condition_variable>
+#include <string>
 
 namespace VPU {
 
 class VPUCore {
 public:
     VPUCore();
-    void execute_task(VPU_Task& task);
+    ~VPUCore();
+
+    // Runs the full cognitive cycle for one task on the calling thread.
+    // Safe to call concurrently: profiling (Pillar 2), planning (Pillar 3, against a belief
+    // snapshot) and execution (Pillar 4) of different tasks overlap, while learning is serialized.
+    ActualPerformanceRecord execute_task(VPU_Task& task);
+
+    // Queues the task for asynchronous execution (worker pools are created on first use).
+    // In serial mode, one worker runs the whole cognitive cycle per task.
+    // In pipelined mode, each pillar is a stage with its own queue and workers; the future
+    // completes once Pillar 4 finishes, and Pillars 5/6 run in the background.
+    std::future<ActualPerformanceRecord> submit_async(VPU_Task& task);
+
+    // Runs a task graph to completion (see VPU_Environment::execute_graph). Each node runs the
+    // full cognitive cycle on the graph pool; once all are done, Pillar 6 records the
+    // producer -> consumer edges so it can find operation sequences that span tasks.
+    std::vector<ActualPerformanceRecord> execute_graph(VPU_TaskGraph& graph);
+
+    // Switches asynchronous submissions between serial and pipelined execution.
+    void set_pipelined_mode(bool enable);
+    bool is_pipelined_mode() const { return pipelined_mode_.load(); }
+
+    // Blocks until every asynchronously submitted task has left all stages,
+    // including background learning and Pillar 6 recording.
+    void wait_idle();
+
+    // Configures the process-wide FFTW plan cache (see VPU_Environment::configure_fft_planning).
+    void configure_fft_planning(FFTPlanningMode mode, const std::string& wisdom_file);
+
+    // Profiles every task with 'policy' instead of the Orchestrator's per-task-type policy.
+    void set_profiling_policy(const ProfilingPolicy& policy);
+    void reset_profiling_policy(); // Back to Orchestrator::profiling_policy_for
+    ProfilingPolicy profiling_policy_for(const VPU_Task& task) const;
+
+    void set_plan_cache_capacity(size_t capacity) { plan_cache_.set_capacity(capacity); }
+
+    // Attaches (or with nullptr, detaches) the Cortex's IoT telemetry poller.
+    void set_iot_telemetry(std::shared_ptr<TelemetryPoller> poller, std::chrono::milliseconds max_age);
+
+    // Registers a compute device (see VPU_Environment::add_device) and seeds its beliefs.
+    HAL::DeviceId add_device(std::shared_ptr<HAL::Device> device);
+
+    // Belief persistence (see VPU_Environment::enable_belief_persistence). The constructor
+    // enables it for $VPU_BELIEFS_FILE when that is set.
+    ProfileLoadResult load_beliefs(const std::string& path, bool any_host = false);
+    bool save_beliefs(const std::string& path) const; // The published beliefs
+    // Loads 'path' if it holds beliefs from this host type, then checkpoints to it every
+    // 'interval' and at shutdown. An empty path stops checkpointing (after a final one).
+    void enable_belief_persistence(const std::string& path, std::chrono::milliseconds interval);
+
+    static constexpr std::chrono::seconds DEFAULT_CHECKPOINT_INTERVAL{30};
+
+    // Times the registered kernels on a background thread and refits the beliefs from the
+    // measurements (see VPU_Environment::calibrate_cost_model). A calibration still running is
+    // cancelled first. The constructor starts one when $VPU_CALIBRATE_COSTS is set.
+    std::shared_future<CalibrationReport> start_cost_calibration(const CalibrationOptions& options);
+
     void print_current_beliefs();
 
+    // Per-stage latencies, plan counters and prediction errors since construction.
+    Runtime::MetricsSnapshot metrics() const { return metrics_.snapshot(); }
+    // Serves metrics() in the Prometheus text format at http://host:port/metrics (see
+    // VPU_Environment::serve_metrics). Returns the bound port, or -1.
+    int serve_metrics(const std::string& host, int port);
+    void stop_serving_metrics() { metrics_endpoint_.stop(); }
+
 private:
+    // A task in flight through the pipelined cognitive cycle.
+    struct PipelineJob {
+        VPU_Task* task = nullptr;
+        std::string task_type; // Copied: background stages may outlive the caller's task
+        uint64_t task_id = 0;  // Copied for the same reason (trace spans)
+        EnrichedExecutionContext context;
+        ExecutionPlan plan;
+        bool explored = false;
+        ActualPerformanceRecord record;
+        std::promise<ActualPerformanceRecord> promise;
+    };
+
+    // A task graph being executed: per-node dependency counters, results and the executed plans.
+    struct GraphRun {
+        VPU_TaskGraph* graph = nullptr;
+        std::vector<std::vector<VPU_TaskGraph::NodeId>> successors;
+        std::vector<std::atomic<size_t>> unmet_dependencies;
+        std::vector<std::atomic<bool>> skipped; // A dependency failed
+        std::vector<ActualPerformanceRecord> records;
+        std::vector<ExecutionPlan> plans; // Empty for tasks that were rejected, skipped or failed
+        std::mutex done_mutex;
+        std::condition_variable done_cv;
+        size_t unfinished = 0;         // Guarded by done_mutex
+        std::exception_ptr first_error; // Guarded by done_mutex
+
+        explicit GraphRun(size_t nodes) : successors(nodes), unmet_dependencies(nodes), skipped(nodes),
+                                          records(nodes), plans(nodes), unfinished(nodes) {}
+    };
+
     void initialize_beliefs();
     void initialize_hal();
 
+    // The whole cognitive cycle; 'executed_plan' (optional) receives the plan that ran.
+    ActualPerformanceRecord run_cognitive_cycle(VPU_Task& task, ExecutionPlan* executed_plan);
+    // The cycle for a streamed task (VPU_Task::stream), which run_cognitive_cycle hands over to:
+    // planned from its first chunk, executed chunk by chunk, and learned from the average chunk.
+    ActualPerformanceRecord run_stream_cycle(VPU_Task& task, ExecutionPlan* executed_plan);
+
+    // --- Cognitive cycle stages (shared by execute_task and the pipeline) ---
+    // Pillars 1 + 2. Returns false if the task was rejected at intake.
+    bool stage_perceive(VPU_Task& task, EnrichedExecutionContext& context);
+    // Pillar 3 + plan selection. Returns false if there is no plan to execute.
+    bool stage_decide(const EnrichedExecutionContext& context, const VPU_Task& task, ExecutionPlan& plan, bool& explored);
+    // Pillar 4.
+    ActualPerformanceRecord stage_act(const EnrichedExecutionContext& context, const ExecutionPlan& plan, VPU_Task& task);
+    // Pillars 5 + 6. 'publish_beliefs' makes the staged belief updates visible to planners immediately.
+    void stage_learn(const EnrichedExecutionContext& context, const ExecutionPlan& plan, bool explored,
+                     const ActualPerformanceRecord& record, bool publish_beliefs);
+
+    // Picks the plan to execute from the sorted candidates (optimal, or exploratory per Pillar 5's explorer).
+    ExecutionPlan select_plan(const std::vector<ExecutionPlan>& candidate_plans, const EnrichedExecutionContext& context,
+                              const VPU_Task& task, bool& explored);
+    // Counts the task's plan choice, JIT and fusion use, and each step's latency prediction error.
+    void record_cycle_metrics(const EnrichedExecutionContext& context, const ExecutionPlan& plan, bool explored,
+                              const ActualPerformanceRecord& record);
+    // Builds the Pillar 5 learning context for the plan that was executed.
+    LearningContext build_learning_context(const ExecutionPlan& chosen_plan, const EnrichedExecutionContext& context, bool explored) const;
+
+    Runtime::WorkerPool& async_pool();
+    Runtime::WorkStealingPool& graph_pool();
+    void run_graph_node(std::shared_ptr<GraphRun> run, VPU_TaskGraph::NodeId node);
+    void start_pipeline();
+    void submit_to_pipeline(std::shared_ptr<PipelineJob> job);
+    void pipeline_perceive(std::shared_ptr<PipelineJob> job);
+    void pipeline_decide(std::shared_ptr<PipelineJob> job);
+    void pipeline_act(std::shared_ptr<PipelineJob> job);
+    void pipeline_learn(std::shared_ptr<PipelineJob> job);
+    void pipeline_fail(PipelineJob& job, std::exception_ptr error);
+
+    void task_started();
+    void task_finished();
+
 public: // Adding public getters for testing purposes
     Cortex* get_cortex_for_testing() { return pillar2_cortex_.get(); } // Added for Pillar 2
     Orchestrator* get_orchestrator_for_testing() { return pillar3_orchestrator_.get(); }
     Cerebellum* get_cerebellum_for_testing() { return pillar4_cerebellum_.get(); }
     FeedbackLoop* get_feedback_loop_for_testing() { return pillar5_feedback_.get(); }
     TaskGraphOrchestrator* get_task_graph_orchestrator_for_testing() { return pillar6_task_graph_orchestrator_.get(); }
-    HardwareProfile* get_hardware_profile_for_testing() { return hw_profile_.get(); }
+    HardwareProfileStore* get_hardware_profile_for_testing() { return hw_profile_.get(); }
     HAL::KernelLibrary* get_kernel_library_for_testing() { return kernel_lib_.get(); }
-    const ActualPerformanceRecord& get_last_performance_record() const;
+    HAL::DeviceTable* get_device_table_for_testing() { return devices_.get(); }
+    ProfilePlanCache* get_plan_cache_for_testing() { return &plan_cache_; }
+    ActualPerformanceRecord get_last_performance_record() const; // A copy: tasks keep replacing it
 
 private: // Original private members resume here
-    std::shared_ptr<HardwareProfile> hw_profile_;
+    std::shared_ptr<HardwareProfileStore> hw_profile_;
     std::shared_ptr<HAL::KernelLibrary> kernel_lib_;
+    std::shared_ptr<HAL::DeviceTable> devices_; // The host plus any accelerators / remote VPUs
     ActualPerformanceRecord last_perf_record_; // To store the latest performance record
 
     // The five pillars of the VPU cognitive cycle
@@ -44,6 +191,47 @@ private: // Original private members resume here
     std::unique_ptr<Cerebellum> pillar4_cerebellum_;
     std::unique_ptr<FeedbackLoop> pillar5_feedback_;
     std::unique_ptr<TaskGraphOrchestrator> pillar6_task_graph_orchestrator_; // Added Pillar 6
+
+    // Serializes belief writers (Pillars 5/6), the exploration RNG and last_perf_record_.
+    // Planners read beliefs through HardwareProfileStore snapshots and never take this lock.
+    mutable std::mutex cognitive_state_mutex_;
+    // Cerebellum reads the KernelLibrary (shared) while Pillar 6 may register fused kernels (exclusive).
+    std::shared_mutex kernel_lib_mutex_;
+
+    std::atomic<bool> fft_wisdom_configured_{false}; // Save FFTW wisdom on shutdown
+
+    std::mutex checkpointer_mutex_;
+    std::unique_ptr<ProfileCheckpointer> belief_checkpointer_; // Guarded by checkpointer_mutex_
+
+    std::mutex calibrator_mutex_;
+    std::unique_ptr<CostCalibrator> calibrator_; // Guarded by calibrator_mutex_
+
+    ProfilePlanCache plan_cache_; // Memoized Pillar 2/3 results for repeat tasks
+
+    Runtime::CycleMetrics metrics_;
+    Runtime::MetricsEndpoint metrics_endpoint_; // Reads metrics_, so declared after it
+
+    mutable std::mutex profiling_policy_mutex_;
+    std::unique_ptr<ProfilingPolicy> profiling_policy_override_; // Guarded by profiling_policy_mutex_
+
+    // Asynchronous submission. Declared last so it is destroyed (and drained) before the pillars.
+    std::atomic<bool> pipelined_mode_{false};
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    size_t tasks_in_flight_ = 0; // Guarded by idle_mutex_
+
+    std::once_flag async_pool_once_;
+    std::unique_ptr<Runtime::WorkerPool> async_pool_;
+
+    std::once_flag graph_pool_once_;
+    std::unique_ptr<Runtime::WorkStealingPool> graph_pool_; // Task graph nodes (execute_graph)
+
+    // Pipelined mode: one pool (queue + workers) per stage.
+    std::once_flag pipeline_once_;
+    std::unique_ptr<Runtime::WorkerPool> perceive_stage_; // Pillars 1-2, parallel
+    std::unique_ptr<Runtime::WorkerPool> decide_stage_;   // Pillar 3, parallel (planning reads belief snapshots)
+    std::unique_ptr<Runtime::WorkerPool> act_stage_;      // Pillar 4, parallel
+    std::unique_ptr<Runtime::WorkerPool> learn_stage_;    // Pillars 5-6, background single worker
 };
 
 } // namespace VPU
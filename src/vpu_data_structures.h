@@ -4,14 +4,57 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <cstdint>
+#include "hal/op_registry.h" // For HAL::OpId
+#include "hal/buffer_stats.h" // For HAL::BufferStats
+#include "hal/device.h"       // For HAL::DeviceId
+#include "hal/saxpy_jit.h"    // For HAL::SaxpySpecialization
+
+namespace VPU {
+
+// What a task computes. Every pillar dispatches on it (VPU_Task::op, or else the task_type
+// string it is derived from once at intake; see core/TaskDescriptor.h).
+enum class TaskOp : uint8_t {
+    UNKNOWN = 0, // A user-defined task_type: profiled, but no built-in plans
+    SAXPY,
+    GEMM,
+    CONVOLUTION,
+    FFT,
+    COUNT
+};
+const char* task_op_name(TaskOp op);                  // "SAXPY", ...; "" for UNKNOWN
+TaskOp task_op_from_name(const std::string& task_type); // "FFT..." is FFT; unknown names are UNKNOWN
 
 // --- Pillar 2 Data Structures ---
 
+// How much of a task's input the Cortex reads to build its DataProfile.
+enum class ProfileSampling {
+    FULL,      // Every element (exact profile)
+    STRIDED,   // Evenly spaced blocks of elements, within sample_budget
+    RESERVOIR, // Uniformly random blocks (seeded, so repeatable), within sample_budget
+    STREAMING  // Every element, folded into the profile chunk by chunk (bounded working set)
+};
+
+// Profiling fidelity for one task. The Orchestrator states what each task type's cost model
+// needs (Orchestrator::profiling_policy_for); the default is the exact, full-input profile.
+struct ProfilingPolicy {
+    ProfileSampling sampling = ProfileSampling::FULL;
+    size_t sample_budget = 65536;         // Elements read by STRIDED/RESERVOIR sampling
+    size_t exact_below_elements = 65536;  // Inputs up to this size are always profiled in full
+    size_t stream_chunk_elements = 65536; // STREAMING: elements folded in per chunk
+    // Cap on the FFT window, rounded down to a power of two (the spectrum uses the first
+    // samples). 0 means the whole input, or sample_budget when sampling or streaming.
+    size_t fft_window = 0;
+    bool spectral = true; // Compute frequency/entropy flux (skips the FFT when false)
+    uint64_t seed = 0x5EED;
+};
+
 // Quantifies the "Arbitrary Contextual Weight" (ACW) of the data.
 struct DataProfile {
     // For binary data (Weight-Flux Computing)
     uint64_t hamming_weight = 0;
     double sparsity_ratio = 1.0; // 1.0 = all zeros, 0.0 = all ones
+    HAL::BufferStats input_stats; // Fused scan of the profiled input (zeros, min/max, popcount)
 
     // For numerical data (Omnimorphic)
     double amplitude_flux = 0.0;
@@ -25,12 +68,42 @@ struct DataProfile {
     double network_bandwidth_mbps = 0.0;
     double io_throughput_mbps = 0.0;
     double data_quality_score = 1.0; // Default to perfect quality
+
+    // Fidelity: how the profile was built. Estimates from a sample are scaled to the whole input.
+    ProfileSampling sampling = ProfileSampling::FULL;
+    size_t profiled_elements = 0; // Elements read for the omnimorphic metrics
+    size_t spectral_window = 0;   // Samples the spectrum was computed over (0 if skipped)
+};
+
+// The level of the memory hierarchy a task's working set fits in (see HAL::cpu_cache_sizes()).
+// Size models keep one coefficient per regime, so a cost can step up where the data outgrows a cache.
+enum CacheRegime : uint8_t { CACHE_L1 = 0, CACHE_L2, CACHE_L3, CACHE_DRAM, CACHE_REGIME_COUNT };
+
+// The dimensions that set how much work a task is; size models turn them into work units.
+struct ProblemShape {
+    uint64_t elements = 0;          // num_elements (for GEMM, the M * K values of A)
+    uint64_t m = 0, n = 0, k = 0;   // GEMM dimensions; 0 for other task types
+    uint64_t taps = 0;              // CONVOLUTION filter length
+    uint64_t nonzeros = 0;          // Stored values of a pre-encoded sparse A (0: A is dense)
+    uint64_t working_set_bytes = 0; // Input and output buffers together
+    CacheRegime cache_regime = CACHE_L1;
 };
 
 // Contains all information for the Orchestrator to make a decision.
 struct EnrichedExecutionContext {
     std::shared_ptr<const DataProfile> profile;
     std::string task_type;
+    bool sparse_a_pre_encoded = false; // VPU_Task::sparse_a is set, so A needs no dense->CSR conversion
+    uint64_t cache_key = 0; // ProfilePlanCache key of the task (0: not cacheable)
+    bool jit_kernel_cached = false; // A generated kernel for this SAXPY task is cached, so JIT_COMPILE_SAXPY is nearly free
+    // SAXPY: the generated kernel's specialization, built once at perceive (it scans x) and
+    // reused by JIT_COMPILE_SAXPY. Null if the task has no generated kernel.
+    std::shared_ptr<const HAL::SaxpySpecialization> saxpy_specialization;
+    uint64_t payload_bytes = 0; // Task buffers a device-targeted step moves to its device and back
+    ProblemShape shape;
+    TaskOp op = TaskOp::UNKNOWN;
+    HAL::ElementType element_type = HAL::ElementType::FLOAT32; // Of the task's inputs
+    double accuracy_bound = 0.0; // VPU_Task::accuracy_bound: reduced-precision plans may be proposed when > 0
 };
 
 // --- Pillar 3 Data Structures ---
@@ -40,6 +113,10 @@ struct ExecutionStep {
     std::string operation_name;  // e.g., "FFT_FORWARD", "CONV_DIRECT", "JIT_GENERATE_SAXPY"
     std::string input_buffer_id;
     std::string output_buffer_id;
+    HAL::OpId op_id = HAL::INVALID_OP_ID; // Interned operation_name; resolved by Pillar 3 before pricing
+    HAL::DeviceId device = HAL::HOST_DEVICE; // Substrate the step runs on
+    HAL::OpId cost_id = HAL::INVALID_OP_ID;  // Belief key off the host ("<op>@<substrate>"); the host prices op_id
+    double work_units = 0.0; // Work Pillar 3 priced the step's size model with (0: no size model)
 };
 
 // The definitive, step-by-step recipe for execution generated by Pillar 3.
@@ -47,10 +124,21 @@ struct ExecutionPlan {
     std::string chosen_path_name;
     double predicted_holistic_flux = 0.0;
     std::vector<ExecutionStep> steps;
+    uint64_t belief_version = 0; // HardwareProfile version the prediction was made against
+    // Wall-clock prediction from the learned per-operation latencies (HardwareProfile::latency).
+    // 0 until every step's operation has been observed.
+    double predicted_latency_ns = 0.0;
 };
 
 // --- Pillar 5 Data Structures ---
 
+// Wall-clock time of one executed step, under the belief key it was priced with
+// (ExecutionStep::cost_id when it ran on a device, otherwise op_id).
+struct StepLatency {
+    HAL::OpId op = HAL::INVALID_OP_ID;
+    double latency_ns = 0.0;
+};
+
 // The ground-truth record of what happened during execution.
 struct ActualPerformanceRecord {
     double observed_latency_ns = 0.0; // Renamed from observed_holistic_flux
@@ -58,6 +146,13 @@ struct ActualPerformanceRecord {
     uint64_t observed_hw_in_cost = 0;
     uint64_t observed_hw_out_cost = 0;
     double observed_holistic_flux = 0.0; // Will be sum of cycle + hw_in + hw_out costs
+    std::vector<StepLatency> step_latencies; // One per executed step, in plan order
+};
+
+// One plan step's share of the size-dependent cost: its size model and the work it was priced for.
+struct SizeTerm {
+    HAL::OpId op = HAL::INVALID_OP_ID;
+    double work_units = 0.0;
 };
 
 // Key information for the learning algorithm to pinpoint the source of an error.
@@ -66,4 +161,49 @@ struct LearningContext {
     std::string transform_key;
     std::string operation_key; // For sensitivity (lambda) learning
     std::string main_operation_name; // For base_operational_cost learning
+    std::string hw_sensitivity_key; // For Hamming Weight sensitivity learning (e.g., "SAXPY_STANDARD_lambda_hw_combined")
+
+    // Interned forms of the keys above. Pillar 5 looks beliefs up by these; a key whose ID is
+    // INVALID_OP_ID is resolved from its name (hand-built contexts).
+    HAL::OpId transform_id = HAL::INVALID_OP_ID;
+    HAL::OpId operation_id = HAL::INVALID_OP_ID;
+    HAL::OpId main_operation_id = HAL::INVALID_OP_ID;
+    HAL::OpId hw_sensitivity_id = HAL::INVALID_OP_ID;
+
+    // Size model coefficients the prediction used, all in the task's cache regime.
+    std::vector<SizeTerm> size_terms;
+    CacheRegime cache_regime = CACHE_L1;
+};
+
+// --- Cost model calibration ---
+
+// The micro-benchmark grid CostCalibrator times each kernel over.
+struct CalibrationOptions {
+    std::vector<size_t> vector_sizes = {4096, 65536, 1 << 20}; // Elements for SAXPY, convolution and FFT kernels
+    std::vector<size_t> matrix_sizes = {32, 96, 192};          // M = N = K for GEMM kernels
+    std::vector<double> sparsities = {0.0, 0.5, 0.9};          // Fraction of input elements set to zero
+    size_t repetitions = 3; // Timed runs per point, after one warm-up run; the fastest is kept
+    size_t conv_taps = 32;  // Filter length for the convolution kernels
+    uint64_t seed = 0xCA1B;
+};
+
+// One timed point of the grid.
+struct CalibrationSample {
+    HAL::OpId op = HAL::INVALID_OP_ID;
+    size_t size = 0;            // Elements, or M = N = K for GEMM
+    double sparsity = 0.0;
+    uint64_t hamming_weight = 0; // Of the kernel's first input, as Pillar 2 profiles it
+    double latency_ns = 0.0;
+    double observed_flux = 0.0;  // cycle + Hamming weight costs the kernel reported
+    ProblemShape shape;          // As Pillar 2 describes the task, for fitting size models
 };
+
+struct CalibrationReport {
+    bool completed = false; // False if the calibration was cancelled before fitting
+    std::vector<CalibrationSample> samples;
+    double flux_per_ns = 0.0;     // Host-wide scale from measured time to flux units
+    size_t calibrated_beliefs = 0;
+    uint64_t belief_version = 0;  // Version the fitted beliefs were published as
+};
+
+} // namespace VPU
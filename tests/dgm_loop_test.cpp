@@ -1,10 +1,14 @@
 #include "dgm/dgm_controller.h" // Adjust path as needed if src/ is an include dir
 #include "dgm/dgm_agent.h"
 #include "dgm/dgm_archive.h"
+#include "dgm/dgm_benchmark.h"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <stdexcept> // For std::exception for basic error handling in test
+#include <algorithm> // For std::max
+#include <cmath>     // For std::abs
+#include <random>    // For std::mt19937 (archive test)
 
 // Basic test function
 void test_dgm_loop() {
@@ -13,7 +17,9 @@ void test_dgm_loop() {
     const std::string initial_source = "Initial_VPU_Agent_Code_v0";
     const int max_iterations = 5; // Keep low for a simple test
     const int num_children_per_iteration = 2; // Generate 2 children per iteration
-    const std::string benchmark = "benchmark_alpha";
+    DGM::BenchmarkOptions benchmark;
+    benchmark.name = "benchmark_alpha";
+    benchmark.repetitions = 2; // Keep each agent's benchmark short
 
     try {
         DGM::DGMController dgm_controller(initial_source, max_iterations, num_children_per_iteration, benchmark);
@@ -23,7 +29,7 @@ void test_dgm_loop() {
             std::cerr << "TEST FAILED: Initial archive size is not 1." << std::endl;
             return;
         }
-        const DGM::Agent& agent0 = dgm_controller.get_archive().get_agent(0);
+        const DGM::Agent agent0 = dgm_controller.get_archive().get_agent(0);
         if (agent0.source_code_representation != initial_source) {
              std::cerr << "TEST FAILED: Agent 0 source code mismatch." << std::endl;
             return;
@@ -73,12 +79,32 @@ void test_dgm_loop() {
                       << ") is unexpected (expected up to " << max_expected_agents << ", or 1 if issues)." << std::endl;
         }
 
+        // Every archived agent was benchmarked for real: a score in (0, 1) and a log of what was measured.
+        size_t longest_source = 0;
+        for (DGM::AgentIdType id : final_archive.get_all_agent_ids()) {
+            const DGM::Agent agent = final_archive.get_agent(id);
+            longest_source = std::max(longest_source, agent.source_code_representation.size());
+            if (agent.performance_score <= 0.0 || agent.performance_score >= 1.0 ||
+                agent.evaluation_log.find("tasks/s") == std::string::npos) {
+                std::cerr << "TEST FAILED: Agent " << agent.agent_id << " has score " << agent.performance_score
+                          << " and log '" << agent.evaluation_log << "'." << std::endl;
+            }
+        }
+
+        // Child sources do not grow with the generation: root source plus a one-line genome.
+        if (longest_source > initial_source.size() + 128) {
+            std::cerr << "TEST FAILED: Agent sources grew to " << longest_source << " bytes." << std::endl;
+        }
+        if (final_archive.text_store().size() > 2 * final_archive.get_population_size()) {
+            std::cerr << "TEST FAILED: More stored strings than sources and logs." << std::endl;
+        }
+
         // Further checks could involve inspecting properties of agents in the archive
         // For example, check if children_count was updated for parents,
         // or if source_code_representation shows evolution.
         // Example: Check children_count of agent 0 if it was selected as parent
         if (final_archive.has_agent(0)) {
-             const DGM::Agent& agent0_final = final_archive.get_agent(0);
+             const DGM::Agent agent0_final = final_archive.get_agent(0);
              std::cout << "[Test] Agent 0 final children_count: " << agent0_final.children_count << std::endl;
              if (max_iterations > 0 && num_children_per_iteration > 0 && agent0_final.children_count == 0) {
                 std::cout << "TEST INFO: Agent 0 has 0 children. This is possible if it was never selected as a parent or only other agents were." << std::endl;
@@ -94,7 +120,120 @@ void test_dgm_loop() {
     std::cout << "--- DGM Loop Test Finished ---" << std::endl;
 }
 
+// The harness scores real runs against a concurrent reference run and fails late ones.
+void test_benchmark_harness() {
+    std::cout << "\n--- Starting Benchmark Harness Test ---" << std::endl;
+
+    DGM::BenchmarkOptions options;
+    options.repetitions = 2;
+    options.max_parallel = 3;
+    DGM::BenchmarkHarness harness(options);
+
+    DGM::AgentGenome batched;
+    batched.batch_size = 4;
+    batched.pipelined = true;
+    const DGM::AgentGenome baseline;
+    std::vector<DGM::BenchmarkResult> results = harness.run_all({baseline, batched}, baseline);
+    if (results.size() != 3) {
+        std::cerr << "TEST FAILED: Expected 2 results plus the reference, got " << results.size() << "." << std::endl;
+        return;
+    }
+    for (const DGM::BenchmarkResult& result : results) {
+        std::cout << "[Test] " << result.log << std::endl;
+        if (!result.passed || result.tasks_completed != 3 * options.repetitions || result.tasks_per_second <= 0.0 ||
+            result.p95_latency_ns <= 0.0 || result.total_ns <= 0.0) {
+            std::cerr << "TEST FAILED: Benchmark run did not pass: " << result.log << std::endl;
+        }
+    }
+    const double score = DGM::BenchmarkHarness::score(results[1], results.back());
+    if (score <= 0.0 || score >= 1.0) {
+        std::cerr << "TEST FAILED: Score " << score << " is outside (0, 1)." << std::endl;
+    }
+    if (DGM::BenchmarkHarness::score(results.back(), results.back()) != 0.5) {
+        std::cerr << "TEST FAILED: The reference does not score 0.5 against itself." << std::endl;
+    }
+
+    DGM::BenchmarkOptions impatient = options;
+    impatient.timeout = std::chrono::milliseconds(0);
+    const DGM::BenchmarkResult late = DGM::BenchmarkHarness(impatient).run(baseline);
+    if (late.passed || !late.timed_out || late.tasks_completed >= 3 * options.repetitions ||
+        DGM::BenchmarkHarness::score(late, results.back()) != 0.0) {
+        std::cerr << "TEST FAILED: A run past its timeout was not failed: " << late.log << std::endl;
+    } else {
+        std::cout << "TEST PASSED: Late run failed: " << late.log << std::endl;
+    }
+    std::cout << "--- Benchmark Harness Test Finished ---" << std::endl;
+}
+
+// The archive deduplicates and spills text, and samples parents by weight in O(log n).
+void test_agent_archive() {
+    std::cout << "\n--- Starting Agent Archive Test ---" << std::endl;
+    bool passed = true;
+
+    // A 256-byte resident budget forces most of the text out to the spill file.
+    DGM::AgentArchive archive(256);
+    const std::string shared_source(200, 's');
+    for (int id = 0; id < 100; ++id) {
+        DGM::Agent agent(id, id == 0 ? std::nullopt : std::optional<DGM::AgentIdType>(0),
+                         id % 2 == 0 ? shared_source : "source_" + std::to_string(id), 0,
+                         (id % 10) / 10.0, "log of agent " + std::to_string(id));
+        archive.add_agent(agent);
+    }
+    // 50 distinct odd sources + the shared source + 100 logs.
+    if (archive.text_store().size() != 151) {
+        std::cerr << "TEST FAILED: Expected 151 distinct strings, got " << archive.text_store().size() << "." << std::endl;
+        passed = false;
+    }
+    if (archive.text_store().spilled_bytes() == 0 || archive.text_store().resident_bytes() > 256) {
+        std::cerr << "TEST FAILED: Text was not spilled to stay within the resident budget." << std::endl;
+        passed = false;
+    }
+    const DGM::Agent agent42 = archive.get_agent(42);
+    const DGM::Agent agent43 = archive.get_agent(43);
+    if (agent42.source_code_representation != shared_source || agent43.source_code_representation != "source_43" ||
+        agent42.evaluation_log != "log of agent 42" || agent42.parent_id != 0 || agent42.performance_score != 0.2) {
+        std::cerr << "TEST FAILED: Agent read back from the archive differs from the one added." << std::endl;
+        passed = false;
+    }
+
+    // Incremental weights match a recomputation, including after children are recorded.
+    for (int i = 0; i < 500; ++i) archive.record_child(i % 7);
+    double recomputed_total = 0.0;
+    for (DGM::AgentIdType id : archive.get_all_agent_ids()) {
+        const double expected = DGM::selection_weight(archive.performance_score(id), archive.children_count(id));
+        if (std::abs(archive.selection_weight(id) - expected) > 1e-12) {
+            std::cerr << "TEST FAILED: Weight of agent " << id << " is stale." << std::endl;
+            passed = false;
+        }
+        recomputed_total += expected;
+    }
+    if (std::abs(archive.total_selection_weight() - recomputed_total) > 1e-9 || archive.children_count(0) != 72) {
+        std::cerr << "TEST FAILED: Total weight " << archive.total_selection_weight() << " vs " << recomputed_total << "." << std::endl;
+        passed = false;
+    }
+
+    // Sampling frequencies follow the weights.
+    DGM::ParentSelector selector(archive);
+    std::vector<int> draws(100, 0);
+    const int num_draws = 200000;
+    for (int i = 0; i < num_draws / 50; ++i) { // Fewer than the population per call, or all are returned
+        for (DGM::AgentIdType id : selector.select_parents(50)) draws[id]++;
+    }
+    for (DGM::AgentIdType id = 0; id < 100; ++id) {
+        const double expected = selector.selection_probability(id) * num_draws;
+        if (std::abs(draws[id] - expected) > 5.0 * std::sqrt(expected) + 5.0) {
+            std::cerr << "TEST FAILED: Agent " << id << " drawn " << draws[id] << " times, expected about " << expected << "." << std::endl;
+            passed = false;
+        }
+    }
+
+    std::cout << (passed ? "TEST PASSED" : "TEST FAILED") << ": Agent archive." << std::endl;
+    std::cout << "--- Agent Archive Test Finished ---" << std::endl;
+}
+
 int main() {
+    test_agent_archive();
+    test_benchmark_harness();
     test_dgm_loop();
     return 0;
 }
@@ -4,6 +4,34 @@
 #include "core/Pillar3_Orchestrator.h" // For HardwareProfile, ExecutionPlan
 #include "core/Pillar5_Feedback.h"    // For LearningContext (though defined in vpu_data_structures.h)
 #include "vpu_data_structures.h" // For DataProfile, ActualPerformanceRecord etc.
+#include "hal/fft_plan_cache.h" // For FFTPlanCache (Test 8)
+#include "hal/cpu_features.h"   // For SIMD variant detection (Test 9)
+#include "hal/hal_utils.h"      // For Hamming weight variants (Test 9)
+#include "hal/sparse.h"         // For CSR/BSR SpMM (Test 11)
+#include "hal/buffer_stats.h"   // For fused buffer statistics (Test 12)
+#include "hal/parallel.h"       // For parallel_for (Test 12)
+#include "core/ProfilePlanCache.h" // For profile/plan memoization (Test 14)
+#include "core/Pillar4_Cerebellum.h" // For the JIT engine (Test 15)
+#include "hal/saxpy_jit.h"          // For generated SAXPY kernels (Test 15)
+#include "core/FusionLibrary.h"     // For fused kernels (Test 16)
+#include "core/Pillar6_TaskGraphOrchestrator.h" // For bounded sequence mining (Test 17)
+#include "hal/scratch_arena.h"      // For aligned scratch buffers (Test 19)
+#include "hal/convolution.h"        // For direct and overlap-save convolution (Test 20)
+#include "hal/device.h"             // For offload devices (Test 21)
+#include "runtime/trace.h"          // For level-gated logging and stage spans (Test 22)
+#include "core/TelemetryPoller.h"   // For background IoT telemetry (Test 23)
+#include "core/HardwareProfile.h"   // For latency statistics (Test 24)
+#include "core/PlanExplorer.h"      // For bandit plan exploration (Test 25)
+#include "core/ProfilePersistence.h" // For saved beliefs (Test 26)
+#include "core/CostCalibrator.h"     // For cost model calibration (Test 27)
+#include "core/SizeModel.h"          // For size-aware costs (Test 28)
+#include "runtime/metrics.h"         // For cycle metrics (Test 29)
+#include "httplib.h"                 // For scraping the metrics endpoint (Test 29)
+#include "core/TaskDescriptor.h"     // For typed task descriptors (Test 30)
+#include "hal/dtype.h"               // For bfloat16 (Test 30)
+#include "hal/quantize.h"            // For reduced-precision kernels (Test 31)
+#include "hal/mapped_file.h"         // For memory-mapped files (Test 32)
+#include "core/TaskStream.h"         // For streamed tasks (Test 32)
 
 #include <iostream>
 #include <vector>
@@ -13,6 +41,23 @@
 #include <cmath>     // For std::abs, std::log2
 #include <cassert>   // For assert()
 #include <iomanip>   // For std::fixed, std::setprecision
+#include <future>    // For std::future (Test 5)
+#include <cstdio>    // For std::remove (Test 8)
+#include <algorithm> // For std::copy (Test 8)
+#include <cstring>   // For std::memcpy (Test 12)
+#include <stdexcept> // For std::runtime_error (Test 18)
+#include <fstream>   // For reading the exported trace (Test 22)
+#include <sstream>   // For std::stringstream (Test 22)
+#include <atomic>    // For the fake sensor state (Test 23)
+#include <chrono>
+#include <mutex>
+#include <cstdlib>   // For setenv/unsetenv (Test 26)
+#include <thread>    // For std::this_thread::sleep_for (Test 23)
+#include <iterator>  // For std::istreambuf_iterator (Test 32)
+
+// No-op user kernel. The built-in task types are dispatched through the HAL kernel library,
+// but Pillar 1 still requires a FUNCTION_POINTER task to carry a valid pointer.
+void noop_kernel(const void*, const void*, void*, size_t) {}
 
 // Helper function to print a divider
 void print_divider(const std::string& title = "") {
@@ -23,6 +68,32 @@ void print_divider(const std::string& title = "") {
     std::cout << "======================================================================\n" << std::endl;
 }
 
+// An in-process stand-in for an accelerator (Test 21): runs blocked GEMM on the host and
+// counts its runs; it can be taken offline or made to fail.
+class TestAcceleratorDevice : public VPU::HAL::Device {
+public:
+    TestAcceleratorDevice() : Device("TEST_ACCEL", VPU::HAL::DeviceKind::OTHER) {}
+    bool available() const override { return online; }
+    bool supports(VPU::HAL::OpId op) const override { return VPU::HAL::OperationRegistry::instance().name(op) == "GEMM_BLOCKED"; }
+    bool run(VPU::HAL::OpId op, VPU::VPU_Task& task, VPU::HAL::KernelFluxReport& report) override {
+        VPU::HAL::DevicePayload payload;
+        if (fail_runs || !VPU::HAL::describe_payload(op, task, payload)) return false;
+        const int M = task.extended_params.at("M"), N = task.extended_params.at("N"), K = task.extended_params.at("K");
+        VPU::HAL::cpu_gemm_blocked(VPU::HAL::as_span<float>(task.data_in_a, payload.in_a_bytes / sizeof(float)),
+                                   VPU::HAL::as_span<float>(task.data_in_b, payload.in_b_bytes / sizeof(float)),
+                                   VPU::HAL::as_mutable_span<float>(task.data_out, payload.out_bytes / sizeof(float)), M, N, K);
+        report.cycle_cost = payload.bytes_moved() / 64 + 1;
+        ++runs;
+        return true;
+    }
+    double cost_prior_scale(VPU::HAL::OpId) const override { return 0.01; }
+    double transfer_cost_per_mib() const override { return 5.0; }
+
+    bool online = true;
+    bool fail_runs = false;
+    int runs = 0;
+};
+
 int main() {
     print_divider("VPU TEST SUITE STARTING");
 
@@ -37,9 +108,12 @@ int main() {
     VPU::Orchestrator* orchestrator = core->get_orchestrator_for_testing();
     assert(orchestrator != nullptr && "Failed to get Orchestrator for testing.");
 
-    VPU::HardwareProfile* hw_profile_ptr = core->get_hardware_profile_for_testing(); // From VPUCore
+    VPU::HardwareProfileStore* hw_profile_ptr = core->get_hardware_profile_for_testing(); // From VPUCore
     assert(hw_profile_ptr != nullptr && "Failed to get HardwareProfile for testing.");
 
+    // Keep plan selection deterministic for the assertions below.
+    core->get_feedback_loop_for_testing()->force_exploration_rate_for_testing(0.0);
+
 
     // --- Test 1: Pillar 2 Hamming Weight Calculation ---
     print_divider("TEST 1: Pillar 2 Hamming Weight Calculation");
@@ -70,7 +144,8 @@ int main() {
     std::vector<float> vec_a_data = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
     std::vector<float> vec_b_data(vec_a_data.size()); // Output buffer
 
-    actual_task.task_type = "SAXPY_STANDARD"; // Ensure this kernel is in VPUCore::initialize_hal
+    actual_task.task_type = "SAXPY"; // Standard SAXPY path uses the SAXPY_STANDARD kernel from VPUCore::initialize_hal
+    actual_task.kernel.function_pointer = noop_kernel;
     actual_task.data_in_a = vec_a_data.data();
     actual_task.data_in_a_size_bytes = vec_a_data.size() * sizeof(float);
     actual_task.data_out = vec_b_data.data(); // Output buffer
@@ -79,7 +154,7 @@ int main() {
 
     std::cout << "Executing SAXPY_STANDARD task..." << std::endl;
     vpu_env.execute(actual_task);
-    const VPU::ActualPerformanceRecord& perf_record = vpu_env.get_last_performance_record();
+    const VPU::ActualPerformanceRecord perf_record = vpu_env.get_last_performance_record();
 
     std::cout << "Observed Cycle Cost: " << perf_record.observed_cycle_cost << std::endl;
     std::cout << "Observed HW IN Cost: " << perf_record.observed_hw_in_cost << std::endl;
@@ -105,17 +180,19 @@ int main() {
     std::vector<float> dummy_saxpy_out_b(sizeof(data_high_hw));
 
 
-    task_a.task_type = "SAXPY_STANDARD"; // Use an op with "_lambda_hw_combined" sensitivity
+    task_a.task_type = "SAXPY"; // SAXPY_STANDARD has a "_lambda_hw_combined" sensitivity
+    task_a.kernel.function_pointer = noop_kernel;
     task_a.data_in_a = data_low_hw;
     task_a.data_in_a_size_bytes = sizeof(data_low_hw);
-    task_a.num_elements = sizeof(data_low_hw); // Treating as raw bytes for this part of test
+    task_a.num_elements = sizeof(data_low_hw) / sizeof(float); // Raw bytes reinterpreted as floats
     task_a.data_out = dummy_saxpy_out_a.data();
     task_a.alpha = 1.0f;
 
-    task_b.task_type = "SAXPY_STANDARD";
+    task_b.task_type = "SAXPY";
+    task_b.kernel.function_pointer = noop_kernel;
     task_b.data_in_a = data_high_hw;
     task_b.data_in_a_size_bytes = sizeof(data_high_hw);
-    task_b.num_elements = sizeof(data_high_hw);
+    task_b.num_elements = sizeof(data_high_hw) / sizeof(float);
     task_b.data_out = dummy_saxpy_out_b.data();
     task_b.alpha = 1.0f;
 
@@ -148,17 +225,23 @@ int main() {
     // --- Test 4: Pillar 5 Learning (Very Basic Check) ---
     print_divider("TEST 4: Pillar 5 Learning (Basic Check for HW Lambda)");
     std::string saxpy_hw_lambda_key = "SAXPY_STANDARD_lambda_hw_combined";
+    // Learning targets the kernel that actually runs, which may be a SIMD variant (e.g. SAXPY_AVX2).
+    // Lowering its lambda only makes it cheaper, so the same plan is chosen for Task B below.
+    std::string learned_hw_lambda_key = plans_b.front().steps.back().operation_name + "_lambda_hw_combined";
 
-    // Ensure the key exists from initialize_beliefs
-    assert(hw_profile_ptr->flux_sensitivities.count(saxpy_hw_lambda_key) && "SAXPY HW lambda key missing in profile");
+    // Ensure the keys exist from initialize_beliefs
+    assert(hw_profile_ptr->snapshot()->flux_sensitivities.count(saxpy_hw_lambda_key) && "SAXPY HW lambda key missing in profile");
+    assert(hw_profile_ptr->snapshot()->flux_sensitivities.count(learned_hw_lambda_key) && "Top plan HW lambda key missing in profile");
 
-    double initial_lambda = hw_profile_ptr->flux_sensitivities[saxpy_hw_lambda_key];
-    std::cout << "Initial SAXPY HW Lambda (" << saxpy_hw_lambda_key << "): " << initial_lambda << std::endl;
+    double initial_lambda = hw_profile_ptr->snapshot()->flux_sensitivities.at(learned_hw_lambda_key);
+    std::cout << "Initial SAXPY HW Lambda (" << learned_hw_lambda_key << "): " << initial_lambda << std::endl;
 
     // Temporarily set lambda to a very small value to ensure misprediction if observed cost is higher
-    // This requires mutable access to hw_profile_, which hw_profile_ptr provides.
+    // Writes go through the store and are published as a new belief version.
     double forced_lambda_val = 0.0000001;
-    hw_profile_ptr->flux_sensitivities[saxpy_hw_lambda_key] = forced_lambda_val;
+    uint64_t forced_version = hw_profile_ptr->update([&](VPU::HardwareProfile& beliefs) {
+        beliefs.flux_sensitivities[learned_hw_lambda_key] = forced_lambda_val;
+    });
     std::cout << "Forcing SAXPY HW Lambda to: " << forced_lambda_val << " for misprediction." << std::endl;
 
     // Re-use task_b (high HW) as it should generate a significant hw_in_cost.
@@ -166,9 +249,27 @@ int main() {
     // The observed flux from Pillar4 will have a non-trivial hw_in_cost.
     // This should cause a positive deviation, and Pillar5 should increase the lambda.
     std::cout << "Executing Task B (High HW) with forced low lambda..." << std::endl;
+    VPU::HardwareProfileSnapshot forced_snapshot = hw_profile_ptr->snapshot();
     vpu_env.execute(task_b);
 
-    double updated_lambda = hw_profile_ptr->flux_sensitivities[saxpy_hw_lambda_key];
+    // Synchronous execution publishes its feedback before returning.
+    assert(hw_profile_ptr->version() > forced_version);
+    assert(!hw_profile_ptr->has_unpublished_changes());
+    // Snapshots are immutable: the one taken before execution still holds the forced value.
+    assert(forced_snapshot->flux_sensitivities.at(learned_hw_lambda_key) == forced_lambda_val);
+    // Readers reuse their thread's snapshot until a new version is published, across several stores.
+    assert(hw_profile_ptr->snapshot() == hw_profile_ptr->snapshot());
+    assert(hw_profile_ptr->snapshot()->version == hw_profile_ptr->version());
+    std::vector<std::unique_ptr<VPU::HardwareProfileStore>> reader_stores;
+    for (int i = 0; i < 6; ++i) reader_stores.push_back(std::make_unique<VPU::HardwareProfileStore>());
+    for (int round = 0; round < 3; ++round) {
+        for (auto& store : reader_stores) {
+            assert(store->snapshot()->version == store->version());
+            store->update([&](VPU::HardwareProfile& beliefs) { beliefs.base_operational_costs["READER_TEST"] = round; });
+            assert(store->snapshot()->base_operational_costs.at("READER_TEST") == round);
+        }
+    }
+    double updated_lambda = hw_profile_ptr->snapshot()->flux_sensitivities.at(learned_hw_lambda_key);
     std::cout << "Updated SAXPY HW Lambda: " << updated_lambda << std::endl;
 
     // Check that lambda changed, and specifically that it increased due to underestimation.
@@ -176,9 +277,2190 @@ int main() {
     std::cout << "--- Test 4 PASSED ---" << std::endl;
 
     // Restore lambda to original value if necessary for other tests, or re-init VPU_Environment
-    hw_profile_ptr->flux_sensitivities[saxpy_hw_lambda_key] = initial_lambda;
+    hw_profile_ptr->update([&](VPU::HardwareProfile& beliefs) {
+        beliefs.flux_sensitivities[learned_hw_lambda_key] = initial_lambda;
+    });
+
+
+    // --- Test 5: Asynchronous, batched submission ---
+    print_divider("TEST 5: Asynchronous Batched Submission");
+    const size_t num_async_tasks = 16;
+    const size_t async_elements = 64;
+    std::vector<std::vector<float>> async_x(num_async_tasks), async_y(num_async_tasks);
+    std::vector<VPU::VPU_Task> async_tasks(num_async_tasks);
+    for (size_t t = 0; t < num_async_tasks; ++t) {
+        async_x[t].assign(async_elements, static_cast<float>(t + 1));
+        async_y[t].assign(async_elements, 1.0f);
+        VPU::VPU_Task& task = async_tasks[t];
+        task.task_id = 1000 + t;
+        task.task_type = "SAXPY";
+        task.kernel.function_pointer = noop_kernel;
+        task.data_in_a = async_x[t].data();
+        task.data_in_a_size_bytes = async_elements * sizeof(float);
+        task.data_out = async_y[t].data();
+        task.num_elements = async_elements;
+        task.alpha = 2.0f;
+    }
+
+    std::vector<std::future<VPU::ActualPerformanceRecord>> batch_futures = vpu_env.submit_batch(async_tasks);
+    assert(batch_futures.size() == num_async_tasks);
+    for (size_t t = 0; t < num_async_tasks; ++t) {
+        VPU::ActualPerformanceRecord record = batch_futures[t].get();
+        assert(record.observed_cycle_cost > 0);
+        // Each task writes only its own buffer: y = 2 * (t + 1) + 1
+        const float expected = 2.0f * static_cast<float>(t + 1) + 1.0f;
+        for (float y : async_y[t]) {
+            assert(std::abs(y - expected) < 1e-5f);
+        }
+    }
+
+    std::vector<float> single_x(async_elements, 3.0f), single_y(async_elements, 0.0f);
+    VPU::VPU_Task single_task = async_tasks[0];
+    single_task.task_id = 2000;
+    single_task.data_in_a = single_x.data();
+    single_task.data_out = single_y.data();
+    std::future<VPU::ActualPerformanceRecord> single_future = vpu_env.submit_async(single_task);
+    assert(single_future.get().observed_holistic_flux > 0.0);
+    assert(std::abs(single_y[0] - 6.0f) < 1e-5f);
+    std::cout << "--- Test 5 PASSED ---" << std::endl;
+
+
+    // --- Test 6: Pipelined cognitive cycle ---
+    print_divider("TEST 6: Pipelined Cognitive Cycle");
+    vpu_env.set_pipelined_mode(true);
+    for (size_t t = 0; t < num_async_tasks; ++t) {
+        async_y[t].assign(async_elements, 1.0f);
+    }
+    std::vector<std::future<VPU::ActualPerformanceRecord>> pipelined_futures = vpu_env.submit_batch(async_tasks);
+    for (size_t t = 0; t < num_async_tasks; ++t) {
+        VPU::ActualPerformanceRecord record = pipelined_futures[t].get();
+        assert(record.observed_cycle_cost > 0);
+        const float expected = 2.0f * static_cast<float>(t + 1) + 1.0f;
+        assert(std::abs(async_y[t].front() - expected) < 1e-5f);
+        assert(std::abs(async_y[t].back() - expected) < 1e-5f);
+    }
+    // Feedback is applied in the background; once idle, Pillar 5 has seen the results.
+    vpu_env.wait_idle();
+    assert(vpu_env.get_last_performance_record().observed_cycle_cost > 0);
+    vpu_env.set_pipelined_mode(false);
+    std::cout << "--- Test 6 PASSED ---" << std::endl;
+
+
+    // --- Test 7: Interned operation IDs and dense tables ---
+    print_divider("TEST 7: Interned Operation IDs");
+    VPU::HAL::OperationRegistry& registry = VPU::HAL::OperationRegistry::instance();
+    const VPU::HAL::OpId saxpy_id = registry.find("SAXPY_STANDARD");
+    assert(saxpy_id != VPU::HAL::INVALID_OP_ID && "SAXPY_STANDARD should be interned at startup");
+    assert(VPU::HAL::intern_op("SAXPY_STANDARD") == saxpy_id); // Interning is idempotent
+    assert(registry.name(saxpy_id) == "SAXPY_STANDARD");
+    assert(registry.hw_sensitivity_id(saxpy_id) == registry.find(saxpy_hw_lambda_key));
+    assert(registry.find("NEVER_REGISTERED_OP") == VPU::HAL::INVALID_OP_ID);
+    assert(registry.has_capability(VPU::HAL::intern_op("REMOTE_FETCH"), VPU::HAL::OP_CAP_USES_NETWORK));
+    assert(registry.has_capability(VPU::HAL::intern_op("DISK_READ"), VPU::HAL::OP_CAP_USES_HEAVY_IO));
+    assert(registry.capabilities(saxpy_id) == VPU::HAL::OP_CAP_NONE);
+
+    // Lookups by ID and by name address the same dense slots.
+    VPU::HardwareProfileSnapshot beliefs_now = hw_profile_ptr->snapshot();
+    assert(beliefs_now->base_operational_costs.find(saxpy_id) != nullptr);
+    assert(*beliefs_now->base_operational_costs.find(saxpy_id) == beliefs_now->base_operational_costs.at("SAXPY_STANDARD"));
+    VPU::HAL::KernelLibrary* kernel_lib = core->get_kernel_library_for_testing();
+    assert(kernel_lib->find(saxpy_id) != nullptr && kernel_lib->count("SAXPY_STANDARD") == 1);
+    assert(kernel_lib->find(registry.find("NEVER_REGISTERED_OP")) == nullptr);
+    std::cout << "--- Test 7 PASSED ---" << std::endl;
+
+
+    // --- Test 8: FFTW plan cache ---
+    print_divider("TEST 8: FFTW Plan Cache");
+    VPU::HAL::FFTPlanCache& plan_cache = VPU::HAL::FFTPlanCache::instance();
+    const int fft_n = 4096;
+    std::vector<double> fft_signal(fft_n), fft_spectrum, fft_roundtrip;
+    for (int i = 0; i < fft_n; ++i) {
+        fft_signal[i] = std::sin(2.0 * 3.14159265358979 * 8.0 * i / fft_n);
+    }
+    VPU::HAL::cpu_fft_forward(fft_signal, fft_spectrum);
+    const size_t plans_after_first = plan_cache.size();
+    const size_t hits_before = plan_cache.hits();
+    VPU::HAL::cpu_fft_forward(fft_signal, fft_spectrum);
+    VPU::HAL::cpu_fft_inverse(fft_spectrum, fft_roundtrip, fft_n);
+    VPU::HAL::cpu_fft_inverse(fft_spectrum, fft_roundtrip, fft_n);
+    // Same size: the forward plan is reused and the inverse plan is created once.
+    assert(plan_cache.size() == plans_after_first + 1);
+    assert(plan_cache.hits() >= hits_before + 2);
+    for (int i = 0; i < fft_n; i += 512) {
+        assert(std::abs(fft_roundtrip[i] - fft_signal[i]) < 1e-9);
+    }
+
+    // In-place variants over a caller-owned buffer (no staging vectors).
+    std::vector<double> inplace_buffer(VPU::HAL::fft_spectrum_doubles(fft_n), 0.0);
+    std::copy(fft_signal.begin(), fft_signal.end(), inplace_buffer.begin());
+    assert(VPU::HAL::cpu_fft_forward_inplace(VPU::HAL::Span<double>(inplace_buffer), fft_n));
+    assert(std::abs(inplace_buffer[16] - fft_spectrum[16]) < 1e-6); // Same spectrum as out-of-place
+    assert(VPU::HAL::cpu_fft_inverse_inplace(VPU::HAL::Span<double>(inplace_buffer), fft_n));
+    assert(std::abs(inplace_buffer[300] - fft_signal[300]) < 1e-9);
+    // A spectrum buffer that is too small is rejected rather than overrun.
+    std::vector<double> short_spectrum(fft_n);
+    assert(!VPU::HAL::cpu_fft_forward(VPU::HAL::Span<const double>(fft_signal), VPU::HAL::Span<double>(short_spectrum)));
+
+    // MEASURE planning with a wisdom file: plans are still correct, and wisdom can be saved.
+    const std::string wisdom_file = "e2e_fftw_wisdom.dat";
+    vpu_env.configure_fft_planning(VPU::FFTPlanningMode::MEASURE, wisdom_file);
+    std::vector<double> measured_signal(fft_signal.begin(), fft_signal.begin() + 1024), measured_spectrum, measured_roundtrip;
+    VPU::HAL::cpu_fft_forward(measured_signal, measured_spectrum);
+    VPU::HAL::cpu_fft_inverse(measured_spectrum, measured_roundtrip, 1024);
+    assert(std::abs(measured_roundtrip[100] - measured_signal[100]) < 1e-9);
+    assert(plan_cache.save_wisdom());
+    vpu_env.configure_fft_planning(VPU::FFTPlanningMode::ESTIMATE);
+    std::remove(wisdom_file.c_str());
+    std::cout << "--- Test 8 PASSED ---" << std::endl;
+
+
+    // --- Test 9: SIMD kernel variants ---
+    print_divider("TEST 9: SIMD Kernel Variants");
+    std::cout << "Widest SIMD ISA: " << VPU::HAL::simd_isa_name(VPU::HAL::best_simd_isa()) << std::endl;
+    // Odd length so every variant exercises its remainder path.
+    const size_t simd_n = 1003;
+    std::vector<float> simd_x(simd_n), simd_y_ref(simd_n);
+    for (size_t i = 0; i < simd_n; ++i) {
+        simd_x[i] = static_cast<float>(i % 17) * 0.25f - 2.0f;
+        simd_y_ref[i] = static_cast<float>(i % 5);
+    }
+    std::vector<float> simd_y_init = simd_y_ref;
+    VPU::HAL::cpu_saxpy(1.5f, simd_x, simd_y_ref);
+
+    using SaxpyVariant = void (*)(float, VPU::HAL::Span<const float>, VPU::HAL::Span<float>);
+    const struct { VPU::HAL::SimdIsa isa; SaxpyVariant fn; } saxpy_variants[] = {
+        {VPU::HAL::SimdIsa::AVX2, &VPU::HAL::cpu_saxpy_avx2},
+        {VPU::HAL::SimdIsa::AVX512, &VPU::HAL::cpu_saxpy_avx512},
+        {VPU::HAL::SimdIsa::NEON, &VPU::HAL::cpu_saxpy_neon},
+        {VPU::HAL::SimdIsa::SCALAR, &VPU::HAL::cpu_saxpy_best},
+    };
+    for (const auto& variant : saxpy_variants) {
+        if (!VPU::HAL::cpu_supports(variant.isa)) continue;
+        std::vector<float> simd_y = simd_y_init;
+        variant.fn(1.5f, simd_x, simd_y);
+        for (size_t i = 0; i < simd_n; ++i) {
+            assert(std::abs(simd_y[i] - simd_y_ref[i]) < 1e-5f);
+        }
+        if (variant.isa != VPU::HAL::SimdIsa::SCALAR) {
+            // Registered as its own kernel, so the Orchestrator can price it as a candidate.
+            assert(core->get_kernel_library_for_testing()->count(std::string("SAXPY_") + VPU::HAL::simd_isa_name(variant.isa)));
+        }
+    }
+
+    const int gm = 5, gn = 19, gk = 7;
+    std::vector<float> gemm_a(gm * gk), gemm_b(gk * gn), gemm_ref(gm * gn), gemm_out(gm * gn);
+    for (size_t i = 0; i < gemm_a.size(); ++i) gemm_a[i] = static_cast<float>(i % 7) - 3.0f;
+    for (size_t i = 0; i < gemm_b.size(); ++i) gemm_b[i] = static_cast<float>(i % 11) * 0.5f;
+    VPU::HAL::cpu_gemm_naive(gemm_a, gemm_b, gemm_ref, gm, gn, gk);
+    if (VPU::HAL::cpu_supports(VPU::HAL::SimdIsa::AVX2)) {
+        VPU::HAL::cpu_gemm_avx2(gemm_a, gemm_b, gemm_out, gm, gn, gk);
+        for (size_t i = 0; i < gemm_ref.size(); ++i) assert(std::abs(gemm_out[i] - gemm_ref[i]) < 1e-4f);
+    }
+    if (VPU::HAL::cpu_supports(VPU::HAL::SimdIsa::AVX512)) {
+        VPU::HAL::cpu_gemm_avx512(gemm_a, gemm_b, gemm_out, gm, gn, gk);
+        for (size_t i = 0; i < gemm_ref.size(); ++i) assert(std::abs(gemm_out[i] - gemm_ref[i]) < 1e-4f);
+    }
+    if (VPU::HAL::cpu_supports(VPU::HAL::SimdIsa::NEON)) {
+        VPU::HAL::cpu_gemm_neon(gemm_a, gemm_b, gemm_out, gm, gn, gk);
+        for (size_t i = 0; i < gemm_ref.size(); ++i) assert(std::abs(gemm_out[i] - gemm_ref[i]) < 1e-4f);
+    }
+
+    // Every popcount variant agrees with the scalar count, including unaligned starts and tails.
+    std::vector<uint8_t> popcount_bytes(1021);
+    for (size_t i = 0; i < popcount_bytes.size(); ++i) popcount_bytes[i] = static_cast<uint8_t>((i * 37 + 11) & 0xFF);
+    const VPU::HAL::CpuFeatures& features = VPU::HAL::cpu_features();
+    for (size_t offset = 0; offset < 3; ++offset) {
+        const uint8_t* p = popcount_bytes.data() + offset;
+        const size_t len = popcount_bytes.size() - offset;
+        const uint64_t expected_popcount = VPU::HAL::hamming_weight_scalar(p, len);
+        assert(VPU::HAL::calculate_data_hamming_weight(p, len) == expected_popcount);
+        if (features.popcnt) assert(VPU::HAL::hamming_weight_popcnt(p, len) == expected_popcount);
+        if (features.avx2_fma) assert(VPU::HAL::hamming_weight_avx2(p, len) == expected_popcount);
+        if (features.avx512_vpopcntdq) assert(VPU::HAL::hamming_weight_avx512(p, len) == expected_popcount);
+    }
+    std::cout << "--- Test 9 PASSED ---" << std::endl;
+
+
+    // --- Test 10: Cache-blocked GEMM ---
+    print_divider("TEST 10: Cache-Blocked GEMM");
+    // Sizes straddle the micro-tile (6x16) and block (96 rows, 256 deep, 512 wide) edges.
+    const struct { int m, n, k; } blocked_shapes[] = { {1, 1, 1}, {7, 17, 5}, {97, 530, 300}, {200, 33, 513} };
+    for (const auto& shape : blocked_shapes) {
+        std::vector<float> ba(static_cast<size_t>(shape.m) * shape.k), bb(static_cast<size_t>(shape.k) * shape.n);
+        for (size_t i = 0; i < ba.size(); ++i) ba[i] = static_cast<float>(static_cast<int>(i % 13) - 6) * 0.125f;
+        for (size_t i = 0; i < bb.size(); ++i) bb[i] = static_cast<float>(static_cast<int>(i % 9) - 4) * 0.25f;
+        std::vector<float> expected_c(static_cast<size_t>(shape.m) * shape.n);
+        // Stale values must be overwritten, not accumulated into.
+        std::vector<float> blocked_c(expected_c.size(), 42.0f), blocked_mt_c(expected_c.size(), -7.0f);
+        VPU::HAL::cpu_gemm_naive(ba, bb, expected_c, shape.m, shape.n, shape.k);
+        VPU::HAL::cpu_gemm_blocked(ba, bb, blocked_c, shape.m, shape.n, shape.k);
+        VPU::HAL::cpu_gemm_blocked_mt(ba, bb, blocked_mt_c, shape.m, shape.n, shape.k);
+        for (size_t i = 0; i < expected_c.size(); ++i) {
+            const float tolerance = 1e-3f * (1.0f + std::abs(expected_c[i]));
+            assert(std::abs(blocked_c[i] - expected_c[i]) < tolerance);
+            assert(std::abs(blocked_mt_c[i] - expected_c[i]) < tolerance);
+        }
+    }
+    assert(VPU::HAL::gemm_blocked_thread_count() >= 1);
+    assert(core->get_kernel_library_for_testing()->count("GEMM_BLOCKED"));
+    assert(core->get_kernel_library_for_testing()->count("GEMM_BLOCKED_MT"));
+    std::cout << "--- Test 10 PASSED ---" << std::endl;
+
+
+    // --- Test 11: Sparse GEMM (CSR/BSR SpMM) ---
+    print_divider("TEST 11: Sparse GEMM");
+    const int sm = 37, sk = 50, sn = 21;
+    std::vector<float> sparse_dense_a(static_cast<size_t>(sm) * sk, 0.0f), sparse_b(static_cast<size_t>(sk) * sn);
+    for (size_t i = 0; i < sparse_dense_a.size(); i += 11) sparse_dense_a[i] = static_cast<float>(i % 7) + 1.0f; // ~91% zeros
+    for (size_t i = 0; i < sparse_b.size(); ++i) sparse_b[i] = static_cast<float>(static_cast<int>(i % 5) - 2);
+    std::vector<float> sparse_expected(static_cast<size_t>(sm) * sn), sparse_out(sparse_expected.size(), 99.0f);
+    VPU::HAL::cpu_gemm_naive(sparse_dense_a, sparse_b, sparse_expected, sm, sn, sk);
+
+    VPU::HAL::CsrMatrix csr = VPU::HAL::dense_to_csr(sparse_dense_a, sm, sk);
+    assert(csr.nnz() == static_cast<size_t>(std::count_if(sparse_dense_a.begin(), sparse_dense_a.end(), [](float v) { return v != 0.0f; })));
+    assert(VPU::HAL::validate_csr(csr.view()));
+    assert(VPU::HAL::cpu_spmm_csr(csr.view(), VPU::HAL::Span<const float>(sparse_b), VPU::HAL::Span<float>(sparse_out), sn));
+    for (size_t i = 0; i < sparse_expected.size(); ++i) assert(std::abs(sparse_out[i] - sparse_expected[i]) < 1e-4f);
+
+    VPU::HAL::BsrMatrix bsr = VPU::HAL::dense_to_bsr(sparse_dense_a, sm, sk, 4, 4); // 37x50 leaves partial edge blocks
+    std::fill(sparse_out.begin(), sparse_out.end(), -1.0f);
+    assert(VPU::HAL::cpu_spmm_bsr(bsr, VPU::HAL::Span<const float>(sparse_b), VPU::HAL::Span<float>(sparse_out), sn));
+    for (size_t i = 0; i < sparse_expected.size(); ++i) assert(std::abs(sparse_out[i] - sparse_expected[i]) < 1e-4f);
+
+    // Malformed caller-supplied CSR is rejected.
+    std::vector<int32_t> bad_row_ptr = {0, 2, 1};
+    std::vector<int32_t> bad_cols = {0, 1};
+    std::vector<float> bad_vals = {1.0f, 2.0f};
+    assert(!VPU::HAL::validate_csr(VPU::HAL::CsrView{2, 2, bad_row_ptr.data(), bad_cols.data(), bad_vals.data()}));
+
+    // Pre-encoded CSR submitted through the VPU: only SpMM plans are considered, with no conversion step.
+    VPU::VPU_Task sparse_task;
+    sparse_task.task_id = 3000;
+    sparse_task.task_type = "GEMM";
+    sparse_task.kernel.function_pointer = noop_kernel;
+    sparse_task.sparse_a = csr.view();
+    sparse_task.data_in_b = sparse_b.data();
+    sparse_task.data_in_b_size_bytes = sparse_b.size() * sizeof(float);
+    sparse_task.data_out = sparse_out.data();
+    sparse_task.num_elements = sparse_out.size();
+    sparse_task.extended_params["N"] = sn; // M and K come from the CSR shape
+    VPU::EnrichedExecutionContext sparse_context = cortex->analyze(sparse_task);
+    assert(sparse_context.sparse_a_pre_encoded);
+    assert(sparse_context.profile->sparsity_ratio > 0.9);
+    std::vector<VPU::ExecutionPlan> sparse_plans = orchestrator->determine_optimal_path(sparse_context);
+    for (const auto& plan : sparse_plans) {
+        assert(plan.steps.size() == 1 && plan.steps.front().operation_name == "SPMM_CSR");
+    }
+    std::fill(sparse_out.begin(), sparse_out.end(), 0.0f);
+    vpu_env.execute(sparse_task);
+    for (size_t i = 0; i < sparse_expected.size(); ++i) assert(std::abs(sparse_out[i] - sparse_expected[i]) < 1e-4f);
+    assert(vpu_env.get_last_performance_record().observed_cycle_cost == csr.nnz() * sn * 2);
+
+    // SpMM is priced by element density, not by the bit-level sparsity_ratio (high even for dense floats).
+    auto spmm_flux = [&](const VPU::EnrichedExecutionContext& ctx) {
+        return orchestrator->determine_optimal_path(ctx).front().predicted_holistic_flux;
+    };
+    VPU::EnrichedExecutionContext bit_dense_context = sparse_context;
+    auto bit_dense_profile = std::make_shared<VPU::DataProfile>(*sparse_context.profile);
+    bit_dense_profile->sparsity_ratio = 0.0;
+    bit_dense_context.profile = bit_dense_profile;
+    assert(spmm_flux(bit_dense_context) == spmm_flux(sparse_context));
+    std::cout << "--- Test 11 PASSED ---" << std::endl;
+
+
+    // --- Test 12: Fused buffer statistics ---
+    print_divider("TEST 12: Fused Buffer Statistics");
+    // Odd length leaves a tail behind every vector width; three stray bytes follow the last float.
+    std::vector<float> stats_floats(1003);
+    for (size_t i = 0; i < stats_floats.size(); ++i) stats_floats[i] = (i % 7 == 0) ? 0.0f : static_cast<float>(static_cast<int>(i % 23) - 11) * 0.5f;
+    stats_floats[500] = -0.0f;
+    stats_floats[501] = std::nanf("");
+    stats_floats[502] = 123.0f;
+    std::vector<uint8_t> stats_raw(stats_floats.size() * sizeof(float) + 3, 0xA5);
+    std::memcpy(stats_raw.data(), stats_floats.data(), stats_floats.size() * sizeof(float));
+    uint64_t ref_zeros = 0;
+    float ref_min = 1e30f, ref_max = -1e30f;
+    for (float v : stats_floats) {
+        if (v == 0.0f) ref_zeros++;
+        if (v < ref_min) ref_min = v;
+        if (v > ref_max) ref_max = v;
+    }
+    VPU::HAL::BufferStats fstats = VPU::HAL::compute_buffer_stats(stats_raw.data(), stats_raw.size(), VPU::HAL::ElementType::FLOAT32);
+    assert(fstats.hamming_weight == VPU::HAL::hamming_weight_scalar(stats_raw.data(), stats_raw.size()));
+    assert(fstats.elements == stats_floats.size());
+    assert(fstats.zero_elements == ref_zeros);
+    assert(fstats.min_value == ref_min && fstats.max_value == 123.0);
+
+    std::vector<double> stats_doubles = {3.5, 0.0, -2.25, 0.0, 8.0, -0.0, 1.0, 7.75, 4.0, -9.5, 0.5};
+    VPU::HAL::BufferStats dstats = VPU::HAL::compute_buffer_stats(stats_doubles.data(), stats_doubles.size() * sizeof(double), VPU::HAL::ElementType::FLOAT64);
+    assert(dstats.hamming_weight == VPU::HAL::hamming_weight_scalar(stats_doubles.data(), stats_doubles.size() * sizeof(double)));
+    assert(dstats.zero_elements == 3 && dstats.min_value == -9.5 && dstats.max_value == 8.0);
+
+    VPU::HAL::BufferStats bstats = VPU::HAL::compute_buffer_stats(stats_raw.data(), stats_raw.size(), VPU::HAL::ElementType::BYTES);
+    assert(bstats.hamming_weight == fstats.hamming_weight);
+    assert(bstats.elements == stats_raw.size());
+    assert(bstats.zero_elements == static_cast<uint64_t>(std::count(stats_raw.begin(), stats_raw.end(), 0)));
+    assert(bstats.min_value == *std::min_element(stats_raw.begin(), stats_raw.end()));
+    assert(bstats.max_value == *std::max_element(stats_raw.begin(), stats_raw.end()));
+
+    // Large buffers are scanned in parallel chunks; the merged result must match a serial scan.
+    std::vector<float> stats_large(VPU::HAL::PARALLEL_SCAN_THRESHOLD_BYTES / sizeof(float) + 12345);
+    for (size_t i = 0; i < stats_large.size(); ++i) stats_large[i] = (i % 5 == 0) ? 0.0f : static_cast<float>(i % 1000) - 400.0f;
+    VPU::HAL::BufferStats lstats = VPU::HAL::compute_buffer_stats(stats_large.data(), stats_large.size() * sizeof(float), VPU::HAL::ElementType::FLOAT32);
+    assert(lstats.hamming_weight == VPU::HAL::hamming_weight_scalar(stats_large.data(), stats_large.size() * sizeof(float)));
+    assert(lstats.hamming_weight == VPU::HAL::calculate_data_hamming_weight(stats_large.data(), stats_large.size() * sizeof(float)));
+    assert(lstats.zero_elements == static_cast<uint64_t>(std::count(stats_large.begin(), stats_large.end(), 0.0f)));
+    assert(lstats.min_value == -399.0 && lstats.max_value == 599.0); // i % 1000 == 0 falls on a zero
+
+    // A throwing body reaches the caller once, after the helpers are done with it; the pool keeps working.
+    {
+        std::atomic<size_t> ran{0};
+        bool caught = false;
+        try {
+            VPU::HAL::parallel_for(64, VPU::HAL::parallel_helper_count(), [&ran](size_t index) {
+                if (index == 17) throw std::runtime_error("index 17");
+                ++ran;
+            });
+        } catch (const std::runtime_error& e) {
+            caught = std::string(e.what()) == "index 17";
+        }
+        assert(caught && ran.load() < 64);
+        ran = 0;
+        VPU::HAL::parallel_for(64, VPU::HAL::parallel_helper_count(), [&ran](size_t) { ++ran; });
+        assert(ran.load() == 64);
+    }
+
+    // Reuse only applies to the exact buffer the stats were computed for.
+    VPU::HAL::BufferStats forged = fstats;
+    forged.hamming_weight = 7; // Distinguishes a reused value from a rescan
+    assert(VPU::HAL::hamming_weight_reusing(forged, stats_raw.data(), stats_raw.size()) == 7);
+    assert(VPU::HAL::hamming_weight_reusing(forged, stats_raw.data(), stats_raw.size() - 1) ==
+           VPU::HAL::hamming_weight_scalar(stats_raw.data(), stats_raw.size() - 1));
+    assert(VPU::HAL::hamming_weight_reusing(VPU::HAL::BufferStats(), stats_raw.data(), stats_raw.size()) == fstats.hamming_weight);
+    {
+        // Stats published on this thread reach kernels that are handed only the buffer.
+        VPU::HAL::KnownBufferStats published(forged);
+        assert(VPU::HAL::hamming_weight_reusing(stats_raw.data(), stats_raw.size()) == 7);
+    }
+    assert(VPU::HAL::hamming_weight_reusing(stats_raw.data(), stats_raw.size()) == fstats.hamming_weight);
+
+    // The Cortex profile carries the same statistics.
+    VPU::VPU_Task stats_task;
+    stats_task.task_type = "SAXPY";
+    stats_task.data_in_a = stats_floats.data();
+    stats_task.data_in_a_size_bytes = stats_floats.size() * sizeof(float);
+    stats_task.num_elements = stats_floats.size();
+    VPU::EnrichedExecutionContext stats_context = cortex->analyze(stats_task);
+    assert(stats_context.profile->input_stats.describes(stats_floats.data(), stats_floats.size() * sizeof(float)));
+    assert(stats_context.profile->input_stats.zero_elements == ref_zeros);
+    assert(stats_context.profile->hamming_weight == stats_context.profile->input_stats.hamming_weight);
+    std::cout << "--- Test 12 PASSED ---" << std::endl;
+
+
+    // --- Test 13: Sampled and streaming profiling ---
+    print_divider("TEST 13: Sampled / Streaming Profiling");
+    std::vector<double> profile_signal(1 << 20); // 8 MiB of doubles
+    for (size_t i = 0; i < profile_signal.size(); ++i) {
+        profile_signal[i] = std::sin(static_cast<double>(i) * 0.01) + 0.1 * static_cast<double>((i * 7919) % 101) / 101.0;
+    }
+    VPU::VPU_Task profile_task;
+    profile_task.task_type = "CONVOLUTION";
+    profile_task.data_in_a = profile_signal.data();
+    profile_task.data_in_a_size_bytes = profile_signal.size() * sizeof(double);
+    profile_task.num_elements = profile_signal.size();
+
+    VPU::EnrichedExecutionContext exact_ctx = cortex->analyze(profile_task);
+    const VPU::DataProfile& exact = *exact_ctx.profile;
+    assert(exact.sampling == VPU::ProfileSampling::FULL);
+    assert(exact.profiled_elements == profile_signal.size() && exact.spectral_window == profile_signal.size());
+
+    VPU::ProfilingPolicy strided_policy;
+    strided_policy.sampling = VPU::ProfileSampling::STRIDED;
+    VPU::EnrichedExecutionContext strided_ctx = cortex->analyze(profile_task, strided_policy);
+    const VPU::DataProfile& strided = *strided_ctx.profile;
+    assert(strided.sampling == VPU::ProfileSampling::STRIDED);
+    assert(strided.profiled_elements <= strided_policy.sample_budget);
+    assert(strided.spectral_window == strided_policy.sample_budget); // First 64K samples
+    assert(std::abs(strided.amplitude_flux - exact.amplitude_flux) < 0.1 * exact.amplitude_flux);
+    assert(std::abs(static_cast<double>(strided.hamming_weight) - exact.hamming_weight) < 0.05 * exact.hamming_weight);
+    assert(strided.input_stats.data == nullptr); // Estimates are never reused as exact kernel scans
+
+    VPU::ProfilingPolicy reservoir_policy;
+    reservoir_policy.sampling = VPU::ProfileSampling::RESERVOIR;
+    VPU::EnrichedExecutionContext reservoir_a = cortex->analyze(profile_task, reservoir_policy);
+    VPU::EnrichedExecutionContext reservoir_b = cortex->analyze(profile_task, reservoir_policy);
+    assert(reservoir_a.profile->sampling == VPU::ProfileSampling::RESERVOIR);
+    assert(reservoir_a.profile->hamming_weight == reservoir_b.profile->hamming_weight); // Seeded: repeatable
+    assert(std::abs(reservoir_a.profile->amplitude_flux - exact.amplitude_flux) < 0.1 * exact.amplitude_flux);
+
+    // Streaming reads every byte, so everything but the (windowed) spectrum is exact.
+    VPU::ProfilingPolicy streaming_policy;
+    streaming_policy.sampling = VPU::ProfileSampling::STREAMING;
+    VPU::EnrichedExecutionContext streamed_ctx = cortex->analyze(profile_task, streaming_policy);
+    const VPU::DataProfile& streamed = *streamed_ctx.profile;
+    assert(streamed.sampling == VPU::ProfileSampling::STREAMING);
+    assert(streamed.hamming_weight == exact.hamming_weight);
+    assert(streamed.input_stats.zero_elements == exact.input_stats.zero_elements);
+    assert(std::abs(streamed.amplitude_flux - exact.amplitude_flux) < 1e-9 * exact.amplitude_flux);
+    assert(streamed.spectral_window == streaming_policy.sample_budget);
+
+    // Chunks may split values: the fold must match one whole-buffer update.
+    VPU::StreamingProfiler whole(streaming_policy), pieces(streaming_policy);
+    const uint8_t* signal_bytes = reinterpret_cast<const uint8_t*>(profile_signal.data());
+    const size_t signal_prefix = 100003; // Ends mid-double
+    whole.update(signal_bytes, signal_prefix);
+    for (size_t offset = 0, step = 3; offset < signal_prefix; offset += step, step = step * 7 % 997 + 1) {
+        pieces.update(signal_bytes + offset, std::min(step, signal_prefix - offset));
+    }
+    assert(pieces.bytes_seen() == signal_prefix);
+    assert(pieces.profile().hamming_weight == whole.profile().hamming_weight);
+    assert(pieces.profile().hamming_weight == VPU::HAL::hamming_weight_scalar(signal_bytes, signal_prefix));
+    assert(std::abs(pieces.profile().amplitude_flux - whole.profile().amplitude_flux) < 1e-12);
+    assert(pieces.profile().frequency_flux == whole.profile().frequency_flux);
+
+    // A capped FFT window is rounded down to a power of two, even when profiling in full.
+    VPU::ProfilingPolicy windowed_policy;
+    windowed_policy.fft_window = 1000;
+    assert(cortex->analyze(profile_task, windowed_policy).profile->spectral_window == 512);
+
+    // Small inputs are always profiled exactly; the Orchestrator states what each task type needs.
+    VPU::VPU_Task small_task = profile_task;
+    small_task.num_elements = 1000;
+    small_task.data_in_a_size_bytes = 1000 * sizeof(double);
+    assert(cortex->analyze(small_task, strided_policy).profile->sampling == VPU::ProfileSampling::FULL);
+    VPU::ProfilingPolicy saxpy_policy = orchestrator->profiling_policy_for("SAXPY");
+    assert(saxpy_policy.sampling == VPU::ProfileSampling::STRIDED && !saxpy_policy.spectral);
+    assert(orchestrator->profiling_policy_for("CONVOLUTION").spectral);
+    assert(orchestrator->profiling_policy_for("TEST_HW_CALC").sampling == VPU::ProfileSampling::FULL);
+    std::cout << "--- Test 13 PASSED ---" << std::endl;
+
+
+    // --- Test 14: Profile and plan memoization ---
+    print_divider("TEST 14: Profile/Plan Cache");
+    VPU::ProfilePlanCache* memo_cache = core->get_plan_cache_for_testing();
+    memo_cache->clear();
+    std::vector<float> memo_x(4096), memo_y(4096, 0.0f);
+    for (size_t i = 0; i < memo_x.size(); ++i) memo_x[i] = static_cast<float>(i % 17) * 0.25f;
+    VPU::VPU_Task memo_task;
+    memo_task.task_id = 4000;
+    memo_task.task_type = "SAXPY";
+    memo_task.kernel.function_pointer = noop_kernel;
+    memo_task.data_in_a = memo_x.data();
+    memo_task.data_in_a_size_bytes = memo_x.size() * sizeof(float);
+    memo_task.data_out = memo_y.data();
+    memo_task.num_elements = memo_x.size();
+
+    const VPU::ProfilePlanCache::Stats memo_before = memo_cache->stats();
+    vpu_env.execute(memo_task);
+    vpu_env.execute(memo_task); // Same buffer and contents: the profile comes from the cache
+    VPU::ProfilePlanCache::Stats memo_after = memo_cache->stats();
+    assert(memo_after.profile_misses == memo_before.profile_misses + 1);
+    assert(memo_after.profile_hits == memo_before.profile_hits + 1);
+
+    // Changed contents change the fingerprint; a caller-supplied version replaces it.
+    const VPU::ProfilingPolicy memo_policy = core->profiling_policy_for(memo_task);
+    const uint64_t memo_key = VPU::ProfilePlanCache::make_key(memo_task, memo_policy);
+    memo_x[7] += 1.0f;
+    assert(VPU::ProfilePlanCache::make_key(memo_task, memo_policy) != memo_key);
+    memo_task.data_version = 42;
+    const uint64_t versioned_key = VPU::ProfilePlanCache::make_key(memo_task, memo_policy);
+    memo_x[7] -= 1.0f;
+    assert(VPU::ProfilePlanCache::make_key(memo_task, memo_policy) == versioned_key);
+    memo_task.task_type = "GEMM";
+    assert(VPU::ProfilePlanCache::make_key(memo_task, memo_policy) != versioned_key);
+
+    // Plans are only served for the belief version they were priced against; LRU eviction.
+    VPU::ProfilePlanCache small_cache(2);
+    auto memo_profile = std::make_shared<const VPU::DataProfile>();
+    std::vector<VPU::ExecutionPlan> memo_plans(1);
+    memo_plans[0].chosen_path_name = "Cached Path";
+    small_cache.store_profile(11, memo_profile);
+    small_cache.store_plans(11, 5, memo_plans);
+    std::vector<VPU::ExecutionPlan> memo_found;
+    assert(small_cache.find_plans(11, 5, memo_found) && memo_found.front().chosen_path_name == "Cached Path");
+    assert(!small_cache.find_plans(11, 6, memo_found)); // Beliefs moved on
+    small_cache.store_plans(99, 5, memo_plans);          // No profile for this key: ignored
+    assert(!small_cache.find_plans(99, 5, memo_found));
+    small_cache.store_profile(12, memo_profile);
+    assert(small_cache.find_profile(11));                // 11 is now most recently used
+    small_cache.store_profile(13, memo_profile);         // Evicts 12
+    assert(small_cache.size() == 2 && !small_cache.find_profile(12) && small_cache.find_profile(13));
+    assert(small_cache.stats().evictions == 1);
+    small_cache.set_capacity(0);
+    assert(small_cache.size() == 0);
+    std::cout << "--- Test 14 PASSED ---" << std::endl;
 
 
+    // --- Test 15: Generated SAXPY kernels and the JIT kernel cache ---
+    print_divider("TEST 15: JIT Kernel Cache");
+    VPU::HAL::SaxpyKernelCache& jit_cache = VPU::HAL::SaxpyKernelCache::instance();
+    jit_cache.clear();
+    // 64-byte aligned views into padded buffers, so both aligned and unaligned kernels are exercised.
+    std::vector<float> jit_x_storage(1024 + 16), jit_y_storage(1024 + 16), jit_ref_storage(1024 + 16);
+    auto align64 = [](std::vector<float>& v) {
+        const uintptr_t p = reinterpret_cast<uintptr_t>(v.data());
+        return v.data() + ((64 - p % 64) % 64) / sizeof(float);
+    };
+    float* jit_x = align64(jit_x_storage);
+    float* jit_y = align64(jit_y_storage);
+    float* jit_ref = align64(jit_ref_storage);
+    for (size_t i = 0; i < 1024; ++i) jit_x[i] = static_cast<float>(static_cast<int>(i % 23) - 11) * 0.5f;
+
+    auto check_generated = [&](float alpha, size_t offset, size_t n, bool sparse) {
+        for (size_t i = 0; i < 1024; ++i) jit_y[i] = jit_ref[i] = static_cast<float>(i % 7) - 3.0f;
+        const float* x = jit_x + offset;
+        const VPU::HAL::SaxpySpecialization spec = VPU::HAL::specialize_saxpy(alpha, x, jit_y + offset, n, sparse);
+        std::shared_ptr<const VPU::HAL::CompiledSaxpyKernel> generated = jit_cache.get_or_compile(spec);
+        generated->run(x, jit_y + offset);
+        VPU::HAL::cpu_saxpy(alpha, VPU::HAL::Span<const float>(x, n), VPU::HAL::Span<float>(jit_ref + offset, n));
+        for (size_t i = 0; i < 1024; ++i) assert(std::abs(jit_y[i] - jit_ref[i]) < 1e-5f);
+        std::cout << "  -> " << generated->name() << " matches cpu_saxpy (n=" << n << ", offset=" << offset << ")." << std::endl;
+        return generated;
+    };
+    for (float alpha : {1.0f, -1.0f, 0.0f, 2.5f}) {
+        check_generated(alpha, 0, 1024, false); // Aligned, no tail
+        check_generated(alpha, 0, 1000, false); // Aligned, tail
+        check_generated(alpha, 1, 999, false);  // Unaligned, tail
+    }
+    assert(VPU::HAL::specialize_saxpy(1.0f, jit_x, jit_y, 1024, false).alignment == 64);
+    assert(VPU::HAL::specialize_saxpy(1.0f, jit_x + 1, jit_y, 1024, false).alignment == 4);
+    assert(VPU::HAL::specialize_saxpy(0.0f, jit_x, jit_y, 1024, false).alpha_kind == VPU::HAL::SaxpyAlphaKind::ZERO);
+    jit_x[5] = INFINITY; // 0 * inf is NaN, so alpha == 0 is no longer a no-op
+    assert(VPU::HAL::specialize_saxpy(0.0f, jit_x, jit_y, 1024, false).alpha_kind == VPU::HAL::SaxpyAlphaKind::GENERAL);
+    jit_x[5] = -8.5f;
+
+    // Sparse kernels visit only the non-zeros baked in at compile time; the pattern is part of the key.
+    for (size_t i = 0; i < 1024; ++i) jit_x[i] = (i % 10 == 3) ? static_cast<float>(i) * 0.01f : 0.0f;
+    auto sparse_kernel = check_generated(1.5f, 0, 1021, true);
+    assert(sparse_kernel->specialization().sparse && sparse_kernel->work_elements() == 102);
+    const VPU::HAL::SaxpySpecialization sparse_spec = sparse_kernel->specialization();
+    jit_x[13] = 0.0f;
+    assert(!(VPU::HAL::specialize_saxpy(1.5f, jit_x, jit_y, 1021, true) == sparse_spec));
+    jit_x[13] = 0.13f;
+    assert(VPU::HAL::specialize_saxpy(1.5f, jit_x, jit_y, 1021, true) == sparse_spec);
+    // The hash only picks the bucket: a different pattern with the same hash is a different kernel.
+    VPU::HAL::SaxpySpecialization colliding_spec = sparse_spec;
+    auto shifted_nonzeros = std::make_shared<std::vector<uint32_t>>(*sparse_spec.nonzeros);
+    shifted_nonzeros->back() += 1;
+    colliding_spec.nonzeros = shifted_nonzeros;
+    assert(colliding_spec.pattern_hash == sparse_spec.pattern_hash && !(colliding_spec == sparse_spec));
+    assert(jit_cache.contains(sparse_spec) && !jit_cache.contains(colliding_spec));
+
+    // The engine compiles once per specialization; repeat tasks hit the cache.
+    jit_cache.clear();
+    std::vector<float> jit_task_x(5000, 1.25f), jit_task_y(5000, 2.0f);
+    VPU::VPU_Task jit_task;
+    jit_task.task_id = 5000;
+    jit_task.task_type = "SAXPY";
+    jit_task.kernel.function_pointer = noop_kernel;
+    jit_task.alpha = 3.0f;
+    jit_task.data_in_a = jit_task_x.data();
+    jit_task.data_in_a_size_bytes = jit_task_x.size() * sizeof(float);
+    jit_task.data_out = jit_task_y.data();
+    jit_task.num_elements = jit_task_x.size();
+    VPU::Cerebellum* jit_cerebellum = core->get_cerebellum_for_testing();
+    VPU::FluxJITEngine* jit_engine = jit_cerebellum->get_jit_engine_for_testing();
+    assert(!jit_cerebellum->has_cached_jit_kernel(jit_task, 0.0));
+    const VPU::HAL::SaxpyKernelCache::Stats jit_before = jit_cache.stats();
+    VPU::HAL::KernelFluxReport jit_report = jit_engine->compile_saxpy_for_data(jit_task)();
+    jit_engine->compile_saxpy_for_data(jit_task)();
+    const VPU::HAL::SaxpyKernelCache::Stats jit_after = jit_cache.stats();
+    assert(jit_after.compilations == jit_before.compilations + 1);
+    assert(jit_after.hits == jit_before.hits + 1);
+    assert(jit_report.cycle_cost == 5000 * 2);
+    for (float v : jit_task_y) assert(v == 2.0f + 2 * 3.0f * 1.25f);
+    assert(jit_cerebellum->has_cached_jit_kernel(jit_task, 0.0));
+    // A specialization built earlier (as stage_perceive does) is compiled without rescanning x.
+    const auto jit_spec = jit_cerebellum->specialize_jit_kernel(jit_task, 0.0);
+    assert(jit_spec && jit_cerebellum->has_cached_jit_kernel(*jit_spec));
+    jit_engine->compile_saxpy_for_data(jit_task, jit_spec.get())();
+    assert(jit_cache.stats().hits == jit_after.hits + 1 && jit_cache.stats().compilations == jit_after.compilations);
+    for (float v : jit_task_y) assert(v == 2.0f + 3 * 3.0f * 1.25f);
+
+    // Pillar 3 prices the compile step of a cached kernel near zero.
+    VPU::EnrichedExecutionContext jit_context = cortex->analyze(jit_task);
+    auto jit_plan_flux = [&](const VPU::EnrichedExecutionContext& ctx) {
+        for (const auto& plan : orchestrator->determine_optimal_path(ctx)) {
+            if (plan.chosen_path_name == "JIT Compiled SAXPY") return plan.predicted_holistic_flux;
+        }
+        assert(false && "JIT plan missing");
+        return 0.0;
+    };
+    const double uncached_flux = jit_plan_flux(jit_context);
+    jit_context.jit_kernel_cached = true;
+    const double cached_flux = jit_plan_flux(jit_context);
+    std::cout << "  -> JIT plan flux: " << uncached_flux << " (compile) vs " << cached_flux << " (cached kernel)" << std::endl;
+    assert(cached_flux < uncached_flux - 900.0);
+    std::cout << "--- Test 15 PASSED ---" << std::endl;
+
+
+    // --- Test 16: Operator fusion (Pillar 6) ---
+    print_divider("TEST 16: Operator Fusion");
+    // Single-pass conversion + SpMM matches the two-step path exactly (same accumulation order).
+    std::vector<float> csr_reference(sparse_expected.size()), fused_out(sparse_expected.size(), 7.0f);
+    assert(VPU::HAL::cpu_spmm_csr(csr.view(), VPU::HAL::Span<const float>(sparse_b), VPU::HAL::Span<float>(csr_reference), sn));
+    uint64_t fused_stored = 0;
+    assert(VPU::HAL::cpu_gemm_skip_zeros(sparse_dense_a, sparse_b, fused_out, sm, sn, sk, &fused_stored));
+    assert(fused_out == csr_reference && fused_stored == csr.nnz());
+    std::vector<float> bsr_reference(sparse_expected.size());
+    assert(VPU::HAL::cpu_spmm_bsr(bsr, VPU::HAL::Span<const float>(sparse_b), VPU::HAL::Span<float>(bsr_reference), sn));
+    assert(VPU::HAL::cpu_gemm_skip_zero_blocks(sparse_dense_a, sparse_b, fused_out, sm, sn, sk, 4, 4, &fused_stored));
+    assert(fused_out == bsr_reference && fused_stored == bsr.values.size());
+
+    // Pillar 6 only fuses pairs with a single-pass implementation.
+    VPU::TaskGraphOrchestrator* fusion_tgo = core->get_task_graph_orchestrator_for_testing();
+    VPU::HAL::KernelLibrary* fusion_lib = core->get_kernel_library_for_testing();
+    fusion_tgo->set_fusion_candidate_threshold_for_testing(2);
+    fusion_tgo->set_analysis_interval_for_testing(1000);
+    VPU::ExecutionPlan csr_plan{"Sparse CSR GEMM", 0.0, {{"DENSE_TO_CSR", "input", "input_csr"}, {"SPMM_CSR", "input_csr", "output"}}};
+    VPU::ExecutionPlan fft_plan{"Frequency Domain (FFT)", 0.0, {{"FFT_FORWARD", "input", "temp_freq"},
+                                                              {"ELEMENT_WISE_MULTIPLY", "temp_freq", "temp_result"},
+                                                              {"FFT_INVERSE", "temp_result", "output"}}};
+    for (int i = 0; i < 2; ++i) {
+        fusion_tgo->record_executed_plan(csr_plan);
+        fusion_tgo->record_executed_plan(fft_plan);
+    }
+    fusion_tgo->analyze_and_fuse_patterns();
+    fusion_tgo->set_fusion_candidate_threshold_for_testing(10);
+    fusion_tgo->set_analysis_interval_for_testing(5);
+    const std::string fused_csr_name = VPU::fused_operation_name("DENSE_TO_CSR", "SPMM_CSR");
+    assert(fusion_lib->count(fused_csr_name) == 1);
+    assert(fusion_lib->count(VPU::fused_operation_name("FFT_FORWARD", "ELEMENT_WISE_MULTIPLY")) == 1);
+    assert(fusion_lib->count(VPU::fused_operation_name("ELEMENT_WISE_MULTIPLY", "FFT_INVERSE")) == 0); // No rule
+    VPU::HardwareProfileSnapshot fusion_beliefs = core->get_hardware_profile_for_testing()->snapshot();
+    assert(fusion_beliefs->base_operational_costs.count(fused_csr_name));
+
+    // Pillar 3 now proposes the fused variant of the sparse plan, and the fused kernel runs in one step.
+    VPU::VPU_Task fusion_task;
+    fusion_task.task_id = 6000;
+    fusion_task.task_type = "GEMM";
+    fusion_task.kernel.function_pointer = noop_kernel;
+    fusion_task.data_in_a = sparse_dense_a.data();
+    fusion_task.data_in_a_size_bytes = sparse_dense_a.size() * sizeof(float);
+    fusion_task.data_in_b = sparse_b.data();
+    fusion_task.data_in_b_size_bytes = sparse_b.size() * sizeof(float);
+    fusion_task.data_out = fused_out.data();
+    fusion_task.num_elements = fused_out.size();
+    fusion_task.extended_params = {{"M", sm}, {"N", sn}, {"K", sk}};
+    bool found_fused_plan = false;
+    for (const auto& plan : orchestrator->determine_optimal_path(cortex->analyze(fusion_task))) {
+        if (plan.chosen_path_name == "Sparse CSR GEMM (Fused)") {
+            found_fused_plan = plan.steps.size() == 1 && plan.steps.front().operation_name == fused_csr_name;
+        }
+    }
+    assert(found_fused_plan);
+    std::fill(fused_out.begin(), fused_out.end(), 0.0f);
+    VPU::HAL::KernelFluxReport fused_report = fusion_lib->at(fused_csr_name)(fusion_task);
+    assert(fused_out == csr_reference);
+    assert(fused_report.cycle_cost == static_cast<uint64_t>(sm) * sk + csr.nnz() * sn * 2);
+    std::cout << "--- Test 16 PASSED ---" << std::endl;
+
+
+    // --- Test 17: Bounded sequence mining (Pillar 6) ---
+    print_divider("TEST 17: Bounded Sequence Mining");
+    VPU::TaskGraphOrchestrator mining_tgo(std::make_shared<VPU::HAL::KernelLibrary>(),
+                                          std::make_shared<VPU::HardwareProfileStore>(), 1000000);
+    mining_tgo.set_analysis_interval_for_testing(1000000);
+    VPU::ExecutionPlan chain_plan{"Chain", 0.0, {{"DENSE_TO_CSR", "input", "a"}, {"SPMM_CSR", "a", "b"}, {"SAXPY", "b", "output"}}};
+    for (size_t i = 0; i < VPU::TaskGraphOrchestrator::HISTORY_CAPACITY + 44; ++i) {
+        mining_tgo.record_executed_plan(chain_plan);
+    }
+    // The history ring is full but bounded; the counters saw every plan, including the triple.
+    assert(mining_tgo.history_size() == VPU::TaskGraphOrchestrator::HISTORY_CAPACITY);
+    assert(mining_tgo.ngram_count_for_testing({"DENSE_TO_CSR", "SPMM_CSR"}) == 300.0);
+    assert(mining_tgo.ngram_count_for_testing({"SPMM_CSR", "SAXPY"}) == 300.0);
+    assert(mining_tgo.ngram_count_for_testing({"DENSE_TO_CSR", "SPMM_CSR", "SAXPY"}) == 300.0);
+    // Meta-operations and repeated ops break a sequence.
+    mining_tgo.record_executed_plan({"JIT", 0.0, {{"FFT_FORWARD", "input", "f"}, {"JIT_COMPILE_SAXPY", "f", "k"}, {"ELEMENT_WISE_MULTIPLY", "k", "output"}}});
+    mining_tgo.record_executed_plan({"Repeat", 0.0, {{"SAXPY", "input", "t"}, {"SAXPY", "t", "output"}}});
+    assert(mining_tgo.ngram_count_for_testing({"FFT_FORWARD", "JIT_COMPILE_SAXPY"}) == 0.0);
+    assert(mining_tgo.ngram_count_for_testing({"SAXPY", "SAXPY"}) == 0.0);
+    const size_t tracked_before_decay = mining_tgo.tracked_ngram_count();
+    assert(tracked_before_decay == 3);
+    // Each analysis decays the counters; a pattern that stops occurring is eventually pruned.
+    mining_tgo.record_executed_plan({"Once", 0.0, {{"FFT_FORWARD", "input", "f"}, {"ELEMENT_WISE_MULTIPLY", "f", "output"}}});
+    mining_tgo.analyze_and_fuse_patterns();
+    assert(std::abs(mining_tgo.ngram_count_for_testing({"DENSE_TO_CSR", "SPMM_CSR"}) - 270.0) < 1e-9);
+    assert(std::abs(mining_tgo.ngram_count_for_testing({"FFT_FORWARD", "ELEMENT_WISE_MULTIPLY"}) - 0.9) < 1e-9);
+    for (int i = 0; i < 28; ++i) {
+        mining_tgo.analyze_and_fuse_patterns();
+    }
+    assert(mining_tgo.ngram_count_for_testing({"FFT_FORWARD", "ELEMENT_WISE_MULTIPLY"}) == 0.0);
+    assert(mining_tgo.tracked_ngram_count() == tracked_before_decay);
+    // The set of tracked sequences is capped no matter how many distinct ones occur.
+    std::vector<std::string> mining_ops;
+    for (int i = 0; i < 40; ++i) {
+        mining_ops.push_back("TEST17_OP_" + std::to_string(i));
+    }
+    for (const auto& first : mining_ops) {
+        for (const auto& second : mining_ops) {
+            mining_tgo.record_executed_plan({"Pair", 0.0, {{first, "input", "t"}, {second, "t", "output"}}});
+        }
+    }
+    assert(mining_tgo.tracked_ngram_count() == VPU::TaskGraphOrchestrator::MAX_TRACKED_NGRAMS);
+    assert(mining_tgo.history_size() == VPU::TaskGraphOrchestrator::HISTORY_CAPACITY);
+    std::cout << "--- Test 17 PASSED ---" << std::endl;
+
+    // --- Test 18: Task graphs (dependency-aware parallel scheduling) ---
+    print_divider("TEST 18: Task Graph Execution");
+    const size_t graph_elements = 4096;
+    std::vector<float> gx1(graph_elements, 1.0f), gy1(graph_elements, 1.0f);
+    std::vector<float> gx2(graph_elements, 2.0f), gy2(graph_elements, 1.0f);
+    std::vector<float> gx3(graph_elements, 4.0f), gy3(graph_elements, 0.0f);
+    auto make_graph_saxpy = [&](uint64_t id, float alpha, const std::vector<float>& x, std::vector<float>& y) {
+        VPU::VPU_Task task;
+        task.task_id = id;
+        task.task_type = "SAXPY";
+        task.kernel.function_pointer = noop_kernel;
+        task.data_in_a = x.data();
+        task.data_in_a_size_bytes = x.size() * sizeof(float);
+        task.data_out = y.data();
+        task.data_out_size_bytes = y.size() * sizeof(float);
+        task.num_elements = y.size();
+        task.alpha = alpha;
+        return task;
+    };
+    std::vector<VPU::VPU_Task> graph_tasks = {
+        make_graph_saxpy(7000, 2.0f, gx1, gy1), // A: y1 = 2*x1 + y1 = 3
+        make_graph_saxpy(7001, 3.0f, gx2, gy2), // B: y2 = 3*x2 + y2 = 7 (independent of A)
+        make_graph_saxpy(7002, 1.0f, gy2, gy1), // C: y1 = y2 + y1 = 10 (after A and B)
+        make_graph_saxpy(7003, 0.5f, gy1, gy2), // D: y2 = 0.5*y1 + y2 = 12 (after C)
+        make_graph_saxpy(7004, 1.0f, gx3, gy3), // E: y3 = x3 = 4 (independent of everything)
+    };
+    VPU::VPU_TaskGraph graph;
+    for (auto& task : graph_tasks) {
+        graph.add_task(task);
+    }
+    // Dependencies follow the buffers: read-after-write, write-after-write and write-after-read.
+    assert(graph.dependencies(0).empty() && graph.dependencies(1).empty() && graph.dependencies(4).empty());
+    assert((graph.dependencies(2) == std::vector<VPU::VPU_TaskGraph::NodeId>{0, 1}));
+    assert((graph.data_sources(2) == std::vector<VPU::VPU_TaskGraph::NodeId>{1}));
+    assert((graph.dependencies(3) == std::vector<VPU::VPU_TaskGraph::NodeId>{0, 1, 2}));
+    assert((graph.data_sources(3) == std::vector<VPU::VPU_TaskGraph::NodeId>{0, 2}));
+    bool rejected_backward_edge = false;
+    try {
+        graph.add_dependency(3, 1);
+    } catch (const std::runtime_error&) {
+        rejected_backward_edge = true;
+    }
+    assert(rejected_backward_edge);
+    graph.add_dependency(0, 4); // An ordering the buffers do not show
+    assert((graph.dependencies(4) == std::vector<VPU::VPU_TaskGraph::NodeId>{0}));
+
+    std::vector<VPU::ActualPerformanceRecord> graph_records = vpu_env.execute_graph(graph);
+    assert(graph_records.size() == graph_tasks.size());
+    for (const auto& record : graph_records) {
+        assert(record.observed_holistic_flux > 0.0);
+    }
+    for (size_t i = 0; i < graph_elements; ++i) {
+        assert(std::abs(gy1[i] - 10.0f) < 1e-5f);
+        assert(std::abs(gy2[i] - 12.0f) < 1e-5f);
+        assert(std::abs(gy3[i] - 4.0f) < 1e-5f);
+    }
+
+    // A task Pillar 1 rejects fails like one that throws: its consumers are skipped.
+    std::vector<float> rx(graph_elements, 1.0f), ry(graph_elements, 1.0f), rz(graph_elements, 5.0f);
+    std::vector<VPU::VPU_Task> rejected_tasks = {
+        make_graph_saxpy(7010, 2.0f, rx, ry), // Rejected: no kernel pointer
+        make_graph_saxpy(7011, 1.0f, ry, rz), // Reads the rejected task's output
+    };
+    rejected_tasks[0].kernel.function_pointer = nullptr;
+    VPU::VPU_TaskGraph rejected_graph;
+    for (auto& task : rejected_tasks) {
+        rejected_graph.add_task(task);
+    }
+    assert((rejected_graph.dependencies(1) == std::vector<VPU::VPU_TaskGraph::NodeId>{0}));
+    std::vector<VPU::ActualPerformanceRecord> rejected_records = vpu_env.execute_graph(rejected_graph);
+    assert(rejected_records[0].observed_holistic_flux == 0.0 && rejected_records[1].observed_holistic_flux == 0.0);
+    assert(std::all_of(rz.begin(), rz.end(), [](float v) { return v == 5.0f; }));
+
+    // Typed tasks are ordered by their operands (every operand but the last is read, the last
+    // written), before Pillar 1 has filled in their data pointers.
+    std::vector<float> ox(graph_elements, 1.0f), oy(graph_elements, 1.0f), oz(graph_elements, 2.0f);
+    auto make_typed_saxpy = [&](uint64_t id, float alpha, const std::vector<float>& x, std::vector<float>& y) {
+        VPU::VPU_Task task;
+        task.task_id = id;
+        task.op = VPU::TaskOp::SAXPY;
+        task.kernel.function_pointer = noop_kernel;
+        task.alpha = alpha;
+        task.operands = {VPU::TaskOperand::vector(x.data(), VPU::HAL::ElementType::FLOAT32, x.size()),
+                         VPU::TaskOperand::vector(y.data(), VPU::HAL::ElementType::FLOAT32, y.size())};
+        return task;
+    };
+    std::vector<VPU::VPU_Task> typed_tasks = {
+        make_typed_saxpy(7020, 2.0f, ox, oy), // oy = 2*1 + 1 = 3
+        make_typed_saxpy(7021, 1.0f, oy, oz), // oz = 3 + 2 = 5, only after the producer
+    };
+    VPU::VPU_TaskGraph typed_graph;
+    for (auto& task : typed_tasks) {
+        typed_graph.add_task(task);
+    }
+    assert((typed_graph.dependencies(1) == std::vector<VPU::VPU_TaskGraph::NodeId>{0}));
+    assert((typed_graph.data_sources(1) == std::vector<VPU::VPU_TaskGraph::NodeId>{0}));
+    vpu_env.execute_graph(typed_graph);
+    assert(std::all_of(oz.begin(), oz.end(), [](float v) { return std::abs(v - 5.0f) < 1e-5f; }));
+
+    // Convolution taps are read like any other input.
+    std::vector<double> taps(4, 0.0);
+    VPU::VPU_Task write_taps = make_graph_saxpy(7022, 1.0f, ox, oy);
+    write_taps.data_out = taps.data();
+    write_taps.data_out_size_bytes = taps.size() * sizeof(double);
+    VPU::VPU_Task read_taps;
+    read_taps.task_id = 7023;
+    read_taps.task_type = "CONVOLUTION";
+    read_taps.conv_filter = VPU::HAL::Span<const double>(taps);
+    VPU::VPU_TaskGraph taps_graph;
+    taps_graph.add_task(write_taps);
+    taps_graph.add_task(read_taps);
+    assert((taps_graph.data_sources(1) == std::vector<VPU::VPU_TaskGraph::NodeId>{0}));
+
+    // Pillar 6 sees sequences that run from a producer's plan into its consumer's.
+    VPU::TaskGraphOrchestrator edge_tgo(std::make_shared<VPU::HAL::KernelLibrary>(),
+                                        std::make_shared<VPU::HardwareProfileStore>(), 1000000);
+    edge_tgo.record_task_graph_edge(csr_plan, fft_plan);
+    assert(edge_tgo.ngram_count_for_testing({"SPMM_CSR", "FFT_FORWARD"}) == 1.0);
+    assert(edge_tgo.ngram_count_for_testing({"DENSE_TO_CSR", "SPMM_CSR", "FFT_FORWARD"}) == 1.0);
+    assert(edge_tgo.ngram_count_for_testing({"SPMM_CSR", "FFT_FORWARD", "ELEMENT_WISE_MULTIPLY"}) == 1.0);
+    assert(edge_tgo.ngram_count_for_testing({"DENSE_TO_CSR", "SPMM_CSR"}) == 0.0); // Within a task: not an edge sequence
+    assert(edge_tgo.tracked_ngram_count() == 3);
+    assert(edge_tgo.history_size() == 0);
+    std::cout << "--- Test 18 PASSED ---" << std::endl;
+
+    // --- Test 19: Scratch arena ---
+    print_divider("TEST 19: Scratch Arena");
+    {
+        VPU::HAL::ScratchArena arena;
+        void* first_block = nullptr;
+        {
+            VPU::HAL::ScratchScope outer(arena);
+            VPU::HAL::Span<double> spectrum = outer.acquire_span<double>(1026);
+            first_block = spectrum.data();
+            assert(reinterpret_cast<uintptr_t>(spectrum.data()) % VPU::HAL::ScratchArena::ALIGNMENT == 0);
+            {
+                VPU::HAL::ScratchScope inner(arena); // Nested scopes release only their own blocks
+                assert(inner.acquire(100) != first_block);
+                assert(arena.mark() == 2);
+            }
+            assert(arena.mark() == 1 && arena.stats().bytes_in_use == 16384);
+        }
+        assert(arena.mark() == 0 && arena.stats().bytes_in_use == 0);
+        assert(arena.stats().heap_allocations == 2 && arena.stats().bytes_cached == 16384 + 256);
+        // Same size class again: the released block is reused, not reallocated.
+        {
+            VPU::HAL::ScratchScope again(arena);
+            assert(again.acquire(9000) == first_block);
+        }
+        assert(arena.stats().heap_allocations == 2 && arena.stats().reuses == 1);
+        arena.set_retained_bytes_limit(1024); // Larger free blocks go back to the heap
+        assert(arena.stats().bytes_cached == 0);
+        {
+            VPU::HAL::ScratchScope scope(arena);
+            scope.acquire(512);
+            scope.acquire(4096);
+        }
+        assert(arena.stats().bytes_cached == 512);
+    }
+    // Kernel staging (here GEMM packing) comes from the thread's arena: no heap traffic in steady state.
+    {
+        const int gm = 64, gn = 48, gk = 80;
+        std::vector<float> ga(static_cast<size_t>(gm) * gk, 0.5f), gb(static_cast<size_t>(gk) * gn, 2.0f), gc(static_cast<size_t>(gm) * gn);
+        VPU::HAL::ScratchArena& thread_arena = VPU::HAL::ScratchArena::for_this_thread();
+        VPU::HAL::cpu_gemm_blocked(ga, gb, gc, gm, gn, gk);
+        const uint64_t warm_allocations = thread_arena.stats().heap_allocations;
+        for (int i = 0; i < 3; ++i) {
+            VPU::HAL::cpu_gemm_blocked(ga, gb, gc, gm, gn, gk);
+        }
+        assert(thread_arena.stats().heap_allocations == warm_allocations);
+        assert(thread_arena.stats().bytes_in_use == 0);
+        assert(std::abs(gc[0] - gk * 1.0f) < 1e-3f);
+    }
+    std::cout << "--- Test 19 PASSED ---" << std::endl;
+
+    // --- Test 20: FFT convolution (overlap-save) and direct convolution ---
+    print_divider("TEST 20: Convolution Paths");
+    {
+        auto make_signal = [](size_t n, double phase) {
+            std::vector<double> v(n);
+            for (size_t i = 0; i < n; ++i) v[i] = std::sin(static_cast<double>(i) * 0.37 + phase) + 0.25 * static_cast<double>((i * 31) % 7) / 7.0;
+            return v;
+        };
+        auto naive_conv = [](const std::vector<double>& x, const std::vector<double>& h) {
+            std::vector<double> y(x.size(), 0.0);
+            for (size_t n = 0; n < x.size(); ++n)
+                for (size_t k = 0; k < h.size() && k <= n; ++k) y[n] += h[k] * x[n - k];
+            return y;
+        };
+        auto max_error = [](const std::vector<double>& a, const std::vector<double>& b) {
+            double err = 0.0;
+            for (size_t i = 0; i < a.size(); ++i) err = std::max(err, std::abs(a[i] - b[i]));
+            return err;
+        };
+        // Several blocks, exact block multiples, a single block, and a filter longer than the signal.
+        const std::vector<std::pair<size_t, size_t>> shapes = {{1000, 7}, {4096, 33}, {229, 1}, {10, 3}, {50, 80}};
+        for (const auto& shape : shapes) {
+            const std::vector<double> x = make_signal(shape.first, 0.0), h = make_signal(shape.second, 1.3);
+            const std::vector<double> expected = naive_conv(x, h);
+            std::vector<double> direct(x.size()), scalar(x.size());
+            assert(VPU::HAL::cpu_conv_direct(x, h, direct) && VPU::HAL::cpu_conv_direct_scalar(x, h, scalar));
+            assert(max_error(direct, expected) < 1e-9 && max_error(scalar, expected) < 1e-9);
+
+            const VPU::HAL::OverlapSaveLayout layout = VPU::HAL::plan_overlap_save(x.size(), h.size());
+            assert(layout.valid() && layout.hop + h.size() - 1 == layout.fft_length);
+            assert((layout.fft_length & (layout.fft_length - 1)) == 0 && layout.blocks * layout.hop >= x.size());
+            std::vector<double> spectra(layout.spectra_doubles()), fused(layout.spectra_doubles()), staged(x.size()), y(x.size());
+            assert(VPU::HAL::overlap_save_forward(x, layout, spectra));
+            assert(VPU::HAL::overlap_save_multiply(spectra, h, layout, spectra)); // In place
+            assert(VPU::HAL::overlap_save_inverse(spectra, layout, y));
+            assert(max_error(y, expected) < 1e-9);
+            assert(VPU::HAL::overlap_save_forward_multiply(x, h, layout, fused));
+            assert(VPU::HAL::overlap_save_inverse(fused, layout, staged));
+            assert(max_error(staged, expected) < 1e-9);
+        }
+        assert(!VPU::HAL::plan_overlap_save(0, 4).valid());
+        std::vector<double> too_long(11), bad_x(10), bad_h(3);
+        assert(!VPU::HAL::cpu_conv_direct(bad_x, bad_h, too_long)); // Output longer than the signal
+
+        // Every CONVOLUTION plan now executes, including the Pillar 6 fusion from Test 16,
+        // with the intermediates routed through temp_freq / temp_result.
+        const std::vector<double> signal = make_signal(3000, 0.5), taps = make_signal(25, 2.0);
+        const std::vector<double> conv_expected = naive_conv(signal, taps);
+        std::vector<double> conv_out(signal.size());
+        VPU::VPU_Task conv_task;
+        conv_task.task_id = 7000;
+        conv_task.task_type = "CONVOLUTION";
+        conv_task.kernel.function_pointer = noop_kernel;
+        conv_task.data_in_a = signal.data();
+        conv_task.data_in_a_size_bytes = signal.size() * sizeof(double);
+        conv_task.data_out = conv_out.data();
+        conv_task.num_elements = signal.size();
+        conv_task.conv_filter = VPU::HAL::Span<const double>(taps);
+        VPU::Cerebellum* conv_cerebellum = core->get_cerebellum_for_testing();
+        const std::vector<VPU::ExecutionPlan> conv_plans = {
+            {"Direct Convolution", 0.0, {{"CONV_DIRECT", "input", "output"}}},
+            {"Frequency Domain (FFT)", 0.0, {{"FFT_FORWARD", "input", "temp_freq"},
+                                             {"ELEMENT_WISE_MULTIPLY", "temp_freq", "temp_result"},
+                                             {"FFT_INVERSE", "temp_result", "output"}}},
+            {"Frequency Domain (FFT) (Fused)", 0.0, {{VPU::fused_operation_name("FFT_FORWARD", "ELEMENT_WISE_MULTIPLY"), "input", "temp_result"},
+                                                     {"FFT_INVERSE", "temp_result", "output"}}}};
+        for (const auto& plan : conv_plans) {
+            std::fill(conv_out.begin(), conv_out.end(), 0.0);
+            VPU::ActualPerformanceRecord conv_record = conv_cerebellum->execute(plan, conv_task);
+            assert(max_error(conv_out, conv_expected) < 1e-9);
+            assert(conv_record.observed_cycle_cost > 0);
+            assert(conv_task.data_in_a == signal.data() && conv_task.data_out == conv_out.data()); // Bindings restored
+        }
+        std::fill(conv_out.begin(), conv_out.end(), 0.0);
+        vpu_env.execute(conv_task); // Whichever plan Pillar 3 picks
+        assert(max_error(conv_out, conv_expected) < 1e-9);
+
+        // Without filter taps FFT_FORWARD writes the whole N/2+1-value spectrum.
+        std::vector<double> spectrum(VPU::HAL::fft_spectrum_doubles(signal.size()), -1.0), reference_spectrum(spectrum.size());
+        VPU::VPU_Task spectrum_task = conv_task;
+        spectrum_task.conv_filter = VPU::HAL::Span<const double>();
+        spectrum_task.data_out = spectrum.data();
+        assert(fusion_lib->at("FFT_FORWARD")(spectrum_task).cycle_cost > 0);
+        assert(VPU::HAL::cpu_fft_forward(VPU::HAL::Span<const double>(signal), VPU::HAL::Span<double>(reference_spectrum)));
+        assert(max_error(spectrum, reference_spectrum) < 1e-9);
+        spectrum_task.data_out_size_bytes = signal.size() * sizeof(double); // Too small for the spectrum
+        assert(fusion_lib->at("FFT_FORWARD")(spectrum_task).cycle_cost == 0);
+    }
+    std::cout << "--- Test 20 PASSED ---" << std::endl;
+
+    // --- Test 21: Plans targeted at other devices ---
+    print_divider("TEST 21: Device Offload");
+    {
+        auto accel = std::make_shared<TestAcceleratorDevice>();
+        const VPU::HAL::DeviceId accel_id = vpu_env.add_device(accel);
+        assert(accel_id != VPU::HAL::HOST_DEVICE);
+        bool duplicate_rejected = false;
+        try {
+            vpu_env.add_device(std::make_shared<TestAcceleratorDevice>());
+        } catch (const std::runtime_error&) {
+            duplicate_rejected = true;
+        }
+        assert(duplicate_rejected);
+
+        // The device's prior is seeded from the host's belief for the operations it supports only.
+        VPU::HardwareProfileSnapshot device_beliefs = core->get_hardware_profile_for_testing()->snapshot();
+        const double host_cost = device_beliefs->base_operational_costs.at("GEMM_BLOCKED");
+        assert(std::abs(device_beliefs->base_operational_costs.at("GEMM_BLOCKED@TEST_ACCEL") - host_cost * 0.01) < 1e-9);
+        assert(device_beliefs->transform_costs.at("TRANSFER@TEST_ACCEL") == 5.0);
+        assert(device_beliefs->base_operational_costs.count("GEMM_NAIVE@TEST_ACCEL") == 0);
+
+        const int dim = 24;
+        std::vector<float> ga(dim * dim), gb(dim * dim), gc(dim * dim), expected(dim * dim);
+        for (int i = 0; i < dim * dim; ++i) {
+            ga[i] = static_cast<float>((i * 7) % 11) - 5.0f;
+            gb[i] = static_cast<float>((i * 3) % 13) * 0.5f;
+        }
+        VPU::HAL::cpu_gemm_naive(ga, gb, expected, dim, dim, dim);
+        VPU::VPU_Task gemm_task;
+        gemm_task.task_id = 7100;
+        gemm_task.task_type = "GEMM";
+        gemm_task.kernel.function_pointer = noop_kernel;
+        gemm_task.data_in_a = ga.data();
+        gemm_task.data_in_a_size_bytes = ga.size() * sizeof(float);
+        gemm_task.data_in_b = gb.data();
+        gemm_task.data_in_b_size_bytes = gb.size() * sizeof(float);
+        gemm_task.data_out = gc.data();
+        gemm_task.data_out_size_bytes = gc.size() * sizeof(float);
+        gemm_task.num_elements = ga.size();
+        gemm_task.extended_params = {{"M", dim}, {"N", dim}, {"K", dim}};
+
+        // Pillar 3 proposes the blocked GEMM on the device, and moving more data there costs more.
+        VPU::EnrichedExecutionContext gemm_context = core->get_cortex_for_testing()->analyze(gemm_task);
+        auto device_plan_flux = [&](uint64_t payload_bytes, VPU::ExecutionPlan* found) {
+            gemm_context.payload_bytes = payload_bytes;
+            for (const auto& plan : core->get_orchestrator_for_testing()->determine_optimal_path(gemm_context)) {
+                if (plan.chosen_path_name == "Blocked GEMM [TEST_ACCEL]") {
+                    assert(plan.steps.size() == 1 && plan.steps[0].device == accel_id);
+                    if (found) *found = plan;
+                    return plan.predicted_holistic_flux;
+                }
+            }
+            return -1.0;
+        };
+        VPU::ExecutionPlan accel_plan;
+        const double small_payload_flux = device_plan_flux(3 * ga.size() * sizeof(float), &accel_plan);
+        const double large_payload_flux = device_plan_flux(uint64_t(1) << 30, nullptr);
+        assert(small_payload_flux >= 0.0 && large_payload_flux > small_payload_flux + 1000.0);
+
+        // The Cerebellum runs the step on the device, and on the host if the device fails.
+        VPU::Cerebellum* gemm_cerebellum = core->get_cerebellum_for_testing();
+        VPU::ActualPerformanceRecord accel_record = gemm_cerebellum->execute(accel_plan, gemm_task);
+        assert(accel->runs == 1 && accel_record.observed_cycle_cost > 0);
+        for (int i = 0; i < dim * dim; ++i) assert(std::abs(gc[i] - expected[i]) < 1e-3f);
+        accel->fail_runs = true;
+        std::fill(gc.begin(), gc.end(), 0.0f);
+        accel_record = gemm_cerebellum->execute(accel_plan, gemm_task);
+        assert(accel->runs == 1 && accel_record.observed_cycle_cost > 0);
+        for (int i = 0; i < dim * dim; ++i) assert(std::abs(gc[i] - expected[i]) < 1e-3f);
+        accel->fail_runs = false;
+
+        // Offline devices are not planned for; later tests see host-only plans.
+        accel->online = false;
+        assert(device_plan_flux(0, nullptr) < 0.0);
+    }
+    std::cout << "--- Test 21 PASSED ---" << std::endl;
+
+    // --- Test 22: Level-gated logging and Chrome trace export ---
+    print_divider("TEST 22: Logging and Tracing");
+    {
+        std::vector<VPU::Runtime::LogRecord> captured;
+        VPU::Runtime::set_log_sink([&captured](const VPU::Runtime::LogRecord& record) { captured.push_back(record); });
+        int evaluations = 0;
+        auto counted = [&evaluations]() { return ++evaluations; };
+
+        // Below the level, a message's arguments are never evaluated.
+        vpu_env.set_log_level(VPU::Runtime::LogLevel::WARN);
+        VPU_LOG_DEBUG("not formatted " << counted());
+        VPU_LOG_INFO("not formatted " << counted());
+        VPU::Runtime::flush_logs();
+        assert(evaluations == 0 && captured.empty());
+
+        std::vector<float> log_x(64, 1.0f), log_y(64, 2.0f);
+        VPU::VPU_Task log_task;
+        log_task.task_id = 7200;
+        log_task.task_type = "SAXPY";
+        log_task.kernel.function_pointer = noop_kernel;
+        log_task.data_in_a = log_x.data();
+        log_task.data_in_a_size_bytes = log_x.size() * sizeof(float);
+        log_task.data_out = log_y.data();
+        log_task.data_out_size_bytes = log_y.size() * sizeof(float);
+        log_task.num_elements = log_x.size();
+        log_task.alpha = 0.5f;
+        vpu_env.execute(log_task);
+        VPU::Runtime::flush_logs();
+        for (const auto& record : captured) assert(record.level >= VPU::Runtime::LogLevel::WARN);
+
+        // At DEBUG the cognitive cycle is narrated, in order, and manipulators do not leak between messages.
+        captured.clear();
+        vpu_env.set_log_level(VPU::Runtime::LogLevel::DEBUG);
+        VPU_LOG_DEBUG("fixed " << std::fixed << std::setprecision(2) << 1.0);
+        VPU_LOG_DEBUG("default " << 1.5);
+        vpu_env.execute(log_task);
+        VPU_LOG_TRACE("below DEBUG " << counted());
+        VPU::Runtime::flush_logs();
+        assert(evaluations == 0 && captured.size() > 2);
+        assert(captured[0].text == "fixed 1.00" && captured[1].text == "default 1.5");
+        bool saw_planning = false;
+        for (size_t i = 0; i < captured.size(); ++i) {
+            assert(captured[i].level >= VPU::Runtime::LogLevel::DEBUG && captured[i].thread > 0);
+            assert(i == 0 || captured[i].sequence > captured[i - 1].sequence);
+            saw_planning |= captured[i].text.find("[Pillar 3] Orchestrator") != std::string::npos;
+        }
+        assert(saw_planning);
+        vpu_env.set_log_level(VPU::Runtime::LogLevel::INFO);
+        VPU::Runtime::set_log_sink(nullptr);
+
+        // Stage spans of synchronous and pipelined tasks land in one Chrome trace.
+        vpu_env.start_tracing();
+        assert(VPU::Runtime::tracing_enabled());
+        vpu_env.execute(log_task);
+        vpu_env.set_pipelined_mode(true);
+        log_task.task_id = 7201;
+        vpu_env.submit_async(log_task).get();
+        vpu_env.wait_idle();
+        vpu_env.set_pipelined_mode(false);
+        const std::string trace_file = "e2e_trace_test.json";
+        assert(vpu_env.write_trace(trace_file));
+        assert(!VPU::Runtime::tracing_enabled());
+        std::ifstream trace_in(trace_file);
+        std::stringstream trace_text;
+        trace_text << trace_in.rdbuf();
+        const std::string trace = trace_text.str();
+        assert(trace.compare(0, 15, "{\"traceEvents\":") == 0 && trace.find("\"dropped_spans\":\"0\"") != std::string::npos);
+        for (const char* stage : {"task", "submit", "analyze", "plan", "execute", "learn"}) {
+            assert(trace.find("\"name\":\"" + std::string(stage) + "\"") != std::string::npos);
+        }
+        assert(trace.find("\"task_id\":7200") != std::string::npos && trace.find("\"task_id\":7201") != std::string::npos);
+        std::remove(trace_file.c_str());
+        // Drained: a second export has no spans left.
+        assert(VPU::Runtime::write_chrome_trace(trace_file));
+        std::ifstream empty_in(trace_file);
+        std::stringstream empty_text;
+        empty_text << empty_in.rdbuf();
+        assert(empty_text.str().find("\"ph\":\"X\"") == std::string::npos);
+        std::remove(trace_file.c_str());
+    }
+    std::cout << "--- Test 22 PASSED ---" << std::endl;
+
+    // --- Test 23: Background IoT telemetry ---
+    print_divider("TEST 23: IoT Telemetry Poller");
+    {
+        // Fake sensors: one status request per device per round; the thermal sensor can go silent.
+        std::mutex sensor_mutex;
+        std::map<std::string, int> requests;
+        std::atomic<bool> thermal_online{true};
+        std::atomic<double> temperature{91.0};
+        auto fetch = [&](const std::string& device_id) -> nlohmann::json {
+            {
+                std::lock_guard<std::mutex> lock(sensor_mutex);
+                ++requests[device_id];
+            }
+            if (device_id == "power_sensor_001") return {{"current_watts", 120.0}};
+            if (device_id == "thermal_sensor_001") {
+                return thermal_online ? nlohmann::json{{"current_temp_c", temperature.load()}} : nlohmann::json();
+            }
+            if (device_id == "network_monitor_001") return {{"latency_ms", 3.5}, {"bandwidth_mbps", 10000.0}};
+            if (device_id == "data_quality_sensor_001") return {{"score", "not a number"}};
+            return nlohmann::json(); // storage_monitor_001 never answers
+        };
+        auto poller = std::make_shared<VPU::TelemetryPoller>(fetch, std::chrono::milliseconds(5));
+        auto wait_for_polls = [&poller](uint64_t polls) {
+            for (int i = 0; i < 2000 && poller->snapshot()->polls < polls; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            assert(poller->snapshot()->polls >= polls);
+        };
+        wait_for_polls(2);
+        {
+            std::lock_guard<std::mutex> lock(sensor_mutex);
+            assert(requests["network_monitor_001"] == requests["power_sensor_001"]); // Two readings, one request
+        }
+        VPU::VPU_Task telemetry_task;
+        telemetry_task.task_id = 7300;
+        telemetry_task.task_type = "SAXPY";
+        telemetry_task.kernel.function_pointer = noop_kernel;
+        std::vector<float> tx(32, 1.0f), ty(32, 0.0f);
+        telemetry_task.data_in_a = tx.data();
+        telemetry_task.data_in_a_size_bytes = tx.size() * sizeof(float);
+        telemetry_task.data_out = ty.data();
+        telemetry_task.num_elements = tx.size();
+
+        VPU::Cortex* telemetry_cortex = core->get_cortex_for_testing();
+        const uint64_t no_telemetry = telemetry_cortex->telemetry_generation();
+        assert(no_telemetry == 0);
+        core->set_iot_telemetry(poller, std::chrono::milliseconds(200));
+        VPU::EnrichedExecutionContext live = telemetry_cortex->analyze(telemetry_task);
+        assert(live.profile->power_draw_watts == 120.0 && live.profile->temperature_celsius == 91.0);
+        assert(live.profile->network_latency_ms == 3.5 && live.profile->network_bandwidth_mbps == 10000.0);
+        // Silent or malformed sensors read their nominal values.
+        assert(live.profile->io_throughput_mbps == VPU::TelemetryPoller::nominal_value(VPU::TelemetrySnapshot::IO_THROUGHPUT));
+        assert(live.profile->data_quality_score == VPU::TelemetryPoller::nominal_value(VPU::TelemetrySnapshot::DATA_QUALITY));
+
+        // New readings reach later profiles (including repeat tasks that hit the profile cache).
+        temperature = 55.0;
+        wait_for_polls(poller->snapshot()->polls + 2);
+        assert(telemetry_cortex->telemetry_generation() != no_telemetry);
+        vpu_env.execute(telemetry_task);
+        assert(telemetry_cortex->analyze(telemetry_task).profile->temperature_celsius == 55.0);
+
+        // A reading older than max_age is treated as missing.
+        thermal_online = false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        VPU::EnrichedExecutionContext stale = telemetry_cortex->analyze(telemetry_task);
+        assert(stale.profile->temperature_celsius == VPU::TelemetryPoller::nominal_value(VPU::TelemetrySnapshot::TEMPERATURE));
+        assert(stale.profile->power_draw_watts == 120.0);
+        std::shared_ptr<const VPU::TelemetrySnapshot> readings = poller->snapshot();
+        assert(readings->values[VPU::TelemetrySnapshot::TEMPERATURE] == 55.0 && readings->failed_polls == 0);
+
+        // Detaching restores the nominal readings for the remaining tests.
+        core->set_iot_telemetry(nullptr, std::chrono::milliseconds(0));
+        poller.reset(); // Joins the polling thread
+        assert(telemetry_cortex->telemetry_generation() == 0);
+        assert(telemetry_cortex->analyze(telemetry_task).profile->power_draw_watts ==
+               VPU::TelemetryPoller::nominal_value(VPU::TelemetrySnapshot::POWER));
+
+        // An unreachable IoT framework backs off instead of failing tasks.
+        vpu_env.enable_iot_telemetry("127.0.0.1", 1, std::chrono::milliseconds(5));
+        vpu_env.execute(telemetry_task);
+        vpu_env.disable_iot_telemetry();
+    }
+    std::cout << "--- Test 23 PASSED ---" << std::endl;
+
+    print_divider("TEST 24: Batched Per-Operation Latency Learning");
+    {
+        // Merging Welford batches gives the statistics of the combined samples.
+        VPU::LatencyStats whole, first_half, second_half, merged;
+        for (int i = 1; i <= 10; ++i) {
+            whole.add(100.0 * i);
+            (i <= 4 ? first_half : second_half).add(100.0 * i);
+        }
+        merged.merge(first_half, 0.1);
+        assert(merged.ewma_ns == first_half.mean_ns); // No history: starts at the batch mean
+        merged.merge(second_half, 0.1);
+        assert(merged.samples == 10 && std::abs(merged.mean_ns - 550.0) < 1e-9);
+        assert(std::abs(merged.variance_ns2() - whole.variance_ns2()) < 1e-6);
+        assert(merged.ewma_ns > first_half.mean_ns && merged.ewma_ns < second_half.mean_ns);
+
+        // A FeedbackLoop merges a thread's latencies only every latency_batch_size tasks.
+        VPU::HardwareProfile latency_profile;
+        latency_profile.base_operational_costs["SAXPY_STANDARD"] = 100.0;
+        auto latency_store = std::make_shared<VPU::HardwareProfileStore>(latency_profile);
+        VPU::FeedbackLoop learner(latency_store, 0.15, 0.1, 0.05, 0.0);
+        learner.set_latency_batch_size(4);
+        const VPU::HAL::OpId saxpy_id = VPU::HAL::intern_op("SAXPY_STANDARD");
+        VPU::LearningContext by_name; // Hand-built: names only, resolved by Pillar 5
+        by_name.main_operation_name = "SAXPY_STANDARD";
+        VPU::ActualPerformanceRecord observed;
+        observed.observed_holistic_flux = 200.0;
+        observed.observed_latency_ns = 1000.0;
+        observed.step_latencies.push_back({saxpy_id, 1000.0});
+        for (int i = 0; i < 3; ++i) {
+            learner.record_step_latencies(observed);
+            learner.learn_from_feedback(by_name, 100.0, observed);
+        }
+        learner.publish_pending_beliefs();
+        assert(latency_store->snapshot()->latency.find(saxpy_id) == nullptr);
+        assert(latency_store->snapshot()->base_operational_costs.at("SAXPY_STANDARD") > 100.0); // Flux learning is unchanged
+        learner.record_step_latencies(observed); // Fourth task: the batch is merged and published
+        const VPU::LatencyStats* saxpy_latency = latency_store->snapshot()->latency.find("SAXPY_STANDARD");
+        assert(saxpy_latency && saxpy_latency->samples == 4 && saxpy_latency->ewma_ns == 1000.0);
+
+        // Batches are per thread: another thread's samples wait for its batch to fill or a flush,
+        // which also merges the batches of threads that have exited.
+        const uint64_t version_before_flush = latency_store->version();
+        assert(learner.flush_latency_statistics() == version_before_flush); // Nothing pending: no new version
+        std::thread other_learner([&]() {
+            VPU::ActualPerformanceRecord slow = observed;
+            slow.step_latencies[0].latency_ns = 3000.0;
+            learner.record_step_latencies(slow);
+            assert(latency_store->snapshot()->latency.find(saxpy_id)->samples == 4);
+        });
+        other_learner.join();
+        assert(latency_store->snapshot()->latency.find(saxpy_id)->samples == 4);
+        assert(learner.flush_latency_statistics() > version_before_flush);
+        saxpy_latency = latency_store->snapshot()->latency.find(saxpy_id);
+        assert(saxpy_latency->samples == 5 && saxpy_latency->ewma_ns > 1000.0);
+
+        // End to end: the Cerebellum times each step and Pillar 3 predicts in nanoseconds.
+        VPU::VPU_Task latency_task;
+        latency_task.task_id = 7400;
+        latency_task.task_type = "SAXPY";
+        latency_task.kernel.function_pointer = noop_kernel;
+        std::vector<float> lx(256, 1.5f), ly(256, 0.0f);
+        latency_task.data_in_a = lx.data();
+        latency_task.data_in_a_size_bytes = lx.size() * sizeof(float);
+        latency_task.data_out = ly.data();
+        latency_task.num_elements = lx.size();
+        vpu_env.execute(latency_task);
+        const VPU::ActualPerformanceRecord last_record = core->get_last_performance_record();
+        assert(!last_record.step_latencies.empty() && last_record.step_latencies[0].latency_ns > 0.0);
+        double step_total_ns = 0.0;
+        for (const auto& step : last_record.step_latencies) step_total_ns += step.latency_ns;
+        assert(step_total_ns <= last_record.observed_latency_ns);
+
+        core->get_feedback_loop_for_testing()->flush_latency_statistics();
+        VPU::EnrichedExecutionContext latency_context = core->get_cortex_for_testing()->analyze(latency_task);
+        std::vector<VPU::ExecutionPlan> latency_plans = core->get_orchestrator_for_testing()->determine_optimal_path(latency_context);
+        VPU::HardwareProfileSnapshot learned = core->get_hardware_profile_for_testing()->snapshot();
+        bool predicted_any = false;
+        for (const auto& plan : latency_plans) {
+            bool all_observed = true;
+            for (const auto& step : plan.steps) {
+                const bool on_device = step.device != VPU::HAL::HOST_DEVICE && step.cost_id != VPU::HAL::INVALID_OP_ID;
+                all_observed &= learned->latency.find(on_device ? step.cost_id : step.op_id) != nullptr;
+            }
+            assert(all_observed == (plan.predicted_latency_ns > 0.0));
+            predicted_any |= all_observed;
+        }
+        assert(predicted_any);
+    }
+    std::cout << "--- Test 24 PASSED ---" << std::endl;
+
+    print_divider("TEST 25: Thompson-Sampling Plan Exploration");
+    {
+        auto make_plan = [](const std::string& name, double flux) {
+            VPU::ExecutionPlan plan;
+            plan.chosen_path_name = name;
+            plan.predicted_holistic_flux = flux;
+            return plan;
+        };
+        VPU::EnrichedExecutionContext small_context;
+        small_context.task_type = "GEMM";
+        small_context.payload_bytes = 4096;
+        VPU::EnrichedExecutionContext large_context = small_context;
+        large_context.payload_bytes = 1 << 20;
+        const uint64_t small_bucket = VPU::PlanExplorer::bucket_of(small_context);
+        assert(small_bucket != VPU::PlanExplorer::bucket_of(large_context));
+
+        VPU::PlanExplorer::Options unlimited;
+        unlimited.budget = 1.0;
+        unlimited.window = std::chrono::hours(1);
+
+        // Without data, only plans predicted close to the best are tried; a 4x plan never is.
+        std::vector<VPU::ExecutionPlan> candidates = {make_plan("Best", 100.0), make_plan("Close", 110.0), make_plan("Bad", 400.0)};
+        VPU::PlanExplorer explorer(unlimited, 42);
+        std::vector<int> picks(3, 0);
+        for (int i = 0; i < 2000; ++i) ++picks[explorer.choose(small_bucket, candidates)];
+        assert(picks[1] > 0 && picks[2] == 0 && picks[0] > picks[1]);
+        assert(explorer.explorations() == static_cast<uint64_t>(picks[1]));
+
+        // Once "Close" is known to be slow, it stops being tried, and the third candidate gets its turn.
+        for (int i = 0; i < 20; ++i) {
+            explorer.record(small_bucket, candidates[0], 1000.0 + i);
+            explorer.record(small_bucket, candidates[1], 3000.0 + i);
+        }
+        assert(explorer.arm(small_bucket, "Close")->samples == 20);
+        assert(explorer.arm(VPU::PlanExplorer::bucket_of(large_context), "Close") == nullptr); // Per context bucket
+        candidates[2] = make_plan("Third", 105.0);
+        std::fill(picks.begin(), picks.end(), 0);
+        for (int i = 0; i < 2000; ++i) ++picks[explorer.choose(small_bucket, candidates)];
+        assert(picks[1] == 0 && picks[2] > 0);
+
+        // The budget caps explorations per window, and 0 disables them.
+        VPU::PlanExplorer::Options capped = unlimited;
+        capped.budget = 0.1;
+        VPU::PlanExplorer budgeted(capped, 7);
+        std::vector<VPU::ExecutionPlan> tied = {make_plan("A", 100.0), make_plan("B", 100.0)};
+        for (int i = 0; i < 1000; ++i) budgeted.choose(small_bucket, tied);
+        assert(budgeted.explorations() > 0 && budgeted.explorations() <= 101);
+        budgeted.set_budget(0.0);
+        const uint64_t before = budgeted.explorations();
+        for (int i = 0; i < 1000; ++i) assert(budgeted.choose(small_bucket, tied) == 0);
+        assert(budgeted.explorations() == before);
+
+        // The VPU records each executed plan in its task's bucket.
+        VPU::VPU_Task bandit_task;
+        bandit_task.task_id = 7500;
+        bandit_task.task_type = "SAXPY";
+        bandit_task.kernel.function_pointer = noop_kernel;
+        std::vector<float> bx(128, 2.0f), by(128, 0.0f);
+        bandit_task.data_in_a = bx.data();
+        bandit_task.data_in_a_size_bytes = bx.size() * sizeof(float);
+        bandit_task.data_out = by.data();
+        bandit_task.data_out_size_bytes = by.size() * sizeof(float);
+        bandit_task.num_elements = bx.size();
+        VPU::EnrichedExecutionContext bandit_context = core->get_cortex_for_testing()->analyze(bandit_task);
+        bandit_context.payload_bytes = bandit_task.data_in_a_size_bytes + bandit_task.data_out_size_bytes;
+        const uint64_t bandit_bucket = VPU::PlanExplorer::bucket_of(bandit_context);
+        std::vector<VPU::ExecutionPlan> bandit_plans = core->get_orchestrator_for_testing()->determine_optimal_path(bandit_context);
+        VPU::PlanExplorer& vpu_explorer = core->get_feedback_loop_for_testing()->explorer();
+        auto bucket_samples = [&]() {
+            uint64_t samples = 0;
+            for (const auto& plan : bandit_plans) {
+                if (const VPU::LatencyStats* stats = vpu_explorer.arm(bandit_bucket, plan.chosen_path_name)) samples += stats->samples;
+            }
+            return samples;
+        };
+        const uint64_t samples_before = bucket_samples();
+        vpu_env.execute(bandit_task);
+        assert(bucket_samples() == samples_before + 1);
+        assert(vpu_explorer.options().budget == 0.0); // Forced off for these tests, so choices stay deterministic
+    }
+    std::cout << "--- Test 25 PASSED ---" << std::endl;
+
+    print_divider("TEST 26: Persisted Hardware Profile");
+    {
+        const VPU::HostFingerprint& this_host = VPU::HostFingerprint::current();
+        assert(!this_host.cpu_model.empty() && !this_host.isa.empty() && this_host.cores > 0);
+        assert(this_host.profile_path("/tmp/beliefs").compare(0, 30, "/tmp/beliefs/hardware_profile_") == 0);
+
+        VPU::HardwareProfile saved;
+        saved.base_operational_costs["GEMM_NAIVE"] = 321.5;
+        saved.transform_costs["FFT_FORWARD"] = 12.25;
+        saved.flux_sensitivities["lambda_Sparsity"] = 0.75;
+        VPU::LatencyStats& gemm_latency = saved.latency[VPU::HAL::intern_op("GEMM_NAIVE")];
+        gemm_latency.add(1000.0);
+        gemm_latency.add(3000.0);
+        gemm_latency.ewma_ns = 1800.0;
+
+        const std::string binary_path = "/tmp/vpu_test_profile.bin";
+        const std::string json_path = "/tmp/vpu_test_profile.json";
+        for (const std::string& path : {binary_path, json_path}) {
+            assert(VPU::save_profile(path, saved));
+            VPU::HardwareProfile restored;
+            restored.base_operational_costs["SAXPY_STANDARD"] = 100.0; // Not in the file: kept
+            restored.base_operational_costs["GEMM_NAIVE"] = 500.0;
+            assert(VPU::load_profile(path, restored) == VPU::ProfileLoadResult::LOADED);
+            assert(restored.base_operational_costs.at("GEMM_NAIVE") == 321.5);
+            assert(restored.base_operational_costs.at("SAXPY_STANDARD") == 100.0);
+            assert(restored.transform_costs.at("FFT_FORWARD") == 12.25);
+            assert(restored.flux_sensitivities.at("lambda_Sparsity") == 0.75);
+            const VPU::LatencyStats* restored_latency = restored.latency.find("GEMM_NAIVE");
+            assert(restored_latency && restored_latency->samples == 2 && restored_latency->mean_ns == 2000.0);
+            assert(restored_latency->variance_ns2() == gemm_latency.variance_ns2() && restored_latency->ewma_ns == 1800.0);
+        }
+        std::ifstream json_file(json_path);
+        const nlohmann::json parsed = nlohmann::json::parse(json_file);
+        assert(parsed["host"]["isa"] == this_host.isa && parsed["base_operational_costs"]["GEMM_NAIVE"] == 321.5);
+
+        // Beliefs from another host type are refused unless asked for; broken files change nothing.
+        VPU::HostFingerprint other_host = this_host;
+        other_host.cores += 1;
+        assert(VPU::save_profile(binary_path, saved, other_host));
+        VPU::HardwareProfile untouched;
+        untouched.base_operational_costs["GEMM_NAIVE"] = 500.0;
+        assert(VPU::load_profile(binary_path, untouched) == VPU::ProfileLoadResult::OTHER_HOST);
+        assert(untouched.base_operational_costs.at("GEMM_NAIVE") == 500.0);
+        VPU::HardwareProfile any_host_copy;
+        assert(VPU::load_profile(binary_path, any_host_copy, /*any_host=*/true) == VPU::ProfileLoadResult::LOADED);
+        {
+            std::ofstream truncated(binary_path, std::ios::binary | std::ios::trunc);
+            truncated << "VPUHWPF1 and not much else";
+        }
+        assert(VPU::load_profile(binary_path, untouched) == VPU::ProfileLoadResult::INVALID);
+        assert(VPU::load_profile("/tmp/vpu_no_such_profile.bin", untouched) == VPU::ProfileLoadResult::MISSING);
+        assert(untouched.base_operational_costs.at("GEMM_NAIVE") == 500.0 && untouched.base_operational_costs.size() == 1);
+        std::remove(binary_path.c_str());
+        std::remove(json_path.c_str());
+
+        // Checkpoints are written in the background; a new VPU warm-starts from them.
+        const std::string checkpoint_path = "/tmp/vpu_test_checkpoint.bin";
+        std::remove(checkpoint_path.c_str());
+        core->get_hardware_profile_for_testing()->update([](VPU::HardwareProfile& beliefs) {
+            beliefs.transform_costs["TEST_PERSISTED_TRANSFORM"] = 42.0;
+        });
+        vpu_env.enable_belief_persistence(checkpoint_path, std::chrono::milliseconds(5));
+        VPU::HardwareProfile checkpointed;
+        for (int i = 0; i < 2000 && VPU::load_profile(checkpoint_path, checkpointed) != VPU::ProfileLoadResult::LOADED; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        assert(checkpointed.transform_costs.at("TEST_PERSISTED_TRANSFORM") == 42.0);
+        vpu_env.enable_belief_persistence(""); // Final checkpoint, then stop
+
+        setenv("VPU_BELIEFS_FILE", checkpoint_path.c_str(), 1);
+        {
+            VPU::VPU_Environment warm_env;
+            VPU::HardwareProfileSnapshot warm = warm_env.get_core_for_testing()->get_hardware_profile_for_testing()->snapshot();
+            assert(warm->transform_costs.at("TEST_PERSISTED_TRANSFORM") == 42.0);
+        }
+        unsetenv("VPU_BELIEFS_FILE");
+        std::remove(checkpoint_path.c_str());
+    }
+    std::cout << "--- Test 26 PASSED ---" << std::endl;
+
+    print_divider("TEST 27: Cost Model Calibration");
+    {
+        VPU::CalibrationOptions small_grid;
+        small_grid.vector_sizes = {1024, 8192};
+        small_grid.matrix_sizes = {16, 48};
+        small_grid.sparsities = {0.0, 0.75};
+        small_grid.repetitions = 2;
+
+        // Every grid point of a kernel with a workload is timed; kernels without one are skipped.
+        VPU::HAL::KernelLibrary* library = core->get_kernel_library_for_testing();
+        VPU::CostCalibrator::KernelSet kernels = {
+            {VPU::HAL::intern_op("SAXPY_STANDARD"), library->at("SAXPY_STANDARD")},
+            {VPU::HAL::intern_op("FFT_FORWARD"), library->at("FFT_FORWARD")},
+            {VPU::HAL::intern_op("TEST_UNCALIBRATED_OP"), library->at("SAXPY_STANDARD")}};
+        std::vector<VPU::CalibrationSample> samples = VPU::CostCalibrator::measure(kernels, small_grid);
+        assert(samples.size() == 2 * 2 * 2);
+        for (const auto& sample : samples) {
+            assert(sample.latency_ns > 0.0 && sample.observed_flux > 0.0);
+            assert(sample.op != VPU::HAL::intern_op("TEST_UNCALIBRATED_OP"));
+            assert(sample.hamming_weight > 0);
+        }
+
+        // The fit: base + lambda_hw * hamming_weight where the sensitivity exists, the mean for transforms.
+        const VPU::HAL::OpId gemm = VPU::HAL::intern_op("GEMM_NAIVE");
+        const VPU::HAL::OpId fft = VPU::HAL::intern_op("FFT_FORWARD");
+        std::vector<VPU::CalibrationSample> synthetic;
+        for (uint64_t hw : {1000u, 2000u, 4000u}) {
+            synthetic.push_back({gemm, 0, 0.0, hw, 100.0 + 0.5 * hw, 100.0 + 0.5 * hw, {}}); // 1 flux per ns
+            synthetic.push_back({fft, 0, 0.0, hw, 300.0, 300.0, {}});
+        }
+        VPU::HardwareProfile fitted;
+        fitted.base_operational_costs["GEMM_NAIVE"] = 500.0;
+        fitted.flux_sensitivities["GEMM_NAIVE_lambda_hw_combined"] = 0.2;
+        fitted.transform_costs["FFT_FORWARD"] = 1.0;
+        fitted.base_operational_costs["SAXPY_STANDARD"] = 100.0; // Not measured: kept
+        double flux_per_ns = 0.0;
+        assert(VPU::CostCalibrator::fit(synthetic, fitted, &flux_per_ns) == 3);
+        assert(std::abs(flux_per_ns - 1.0) < 1e-12);
+        assert(std::abs(fitted.base_operational_costs.at("GEMM_NAIVE") - 100.0) < 1e-6);
+        assert(std::abs(fitted.flux_sensitivities.at("GEMM_NAIVE_lambda_hw_combined") - 0.5) < 1e-9);
+        assert(std::abs(fitted.transform_costs.at("FFT_FORWARD") - 300.0) < 1e-9);
+        assert(fitted.base_operational_costs.at("SAXPY_STANDARD") == 100.0);
+
+        // In the background, the fitted beliefs are published as one version while tasks keep running.
+        const uint64_t version_before = core->get_hardware_profile_for_testing()->version();
+        std::shared_future<VPU::CalibrationReport> calibration = vpu_env.calibrate_cost_model(small_grid);
+        VPU::VPU_Task during_task;
+        during_task.task_id = 7700;
+        during_task.task_type = "SAXPY";
+        during_task.kernel.function_pointer = noop_kernel;
+        std::vector<float> cx(512, 1.0f), cy(512, 0.0f);
+        during_task.data_in_a = cx.data();
+        during_task.data_in_a_size_bytes = cx.size() * sizeof(float);
+        during_task.data_out = cy.data();
+        during_task.num_elements = cx.size();
+        vpu_env.execute(during_task);
+        const VPU::CalibrationReport& report = calibration.get();
+        assert(report.completed && report.flux_per_ns > 0.0 && report.calibrated_beliefs > 0);
+        assert(report.belief_version > version_before);
+        assert(core->get_hardware_profile_for_testing()->version() >= report.belief_version);
+        bool timed_gemm = false;
+        for (const auto& sample : report.samples) timed_gemm |= sample.op == gemm;
+        assert(timed_gemm);
+
+        // Starting another calibration cancels the one in flight; its future still becomes ready.
+        std::shared_future<VPU::CalibrationReport> first = vpu_env.calibrate_cost_model();
+        std::shared_future<VPU::CalibrationReport> second = vpu_env.calibrate_cost_model(small_grid);
+        assert(first.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        assert(second.get().completed);
+    }
+    std::cout << "--- Test 27 PASSED ---" << std::endl;
+
+    print_divider("TEST 28: Size-Aware Cost Model");
+    {
+        // Shapes: GEMM dimensions and working set, the cache regime it falls in, and work units per complexity.
+        VPU::VPU_Task gemm_shape_task;
+        gemm_shape_task.task_type = "GEMM";
+        gemm_shape_task.extended_params = {{"M", 64}, {"N", 32}, {"K", 16}};
+        const VPU::ProblemShape gemm_shape = VPU::problem_shape(gemm_shape_task);
+        assert(gemm_shape.m == 64 && gemm_shape.n == 32 && gemm_shape.k == 16 && gemm_shape.elements == 64 * 16);
+        assert(gemm_shape.working_set_bytes == (64 * 16 + 16 * 32 + 64 * 32) * sizeof(float));
+        assert(VPU::work_units(VPU::Complexity::MNK, gemm_shape, 1.0) == 64.0 * 32 * 16);
+        assert(VPU::work_units(VPU::Complexity::SPARSE_MNK, gemm_shape, 0.25) == 64.0 * 32 * 16 / 4);
+        assert(VPU::work_units(VPU::Complexity::N_TAPS, gemm_shape, 1.0) == 0.0); // No filter
+        const VPU::HAL::CacheSizes& caches = VPU::HAL::cpu_cache_sizes();
+        assert(caches.l1d_bytes > 0 && caches.l1d_bytes <= caches.l2_bytes && caches.l2_bytes <= caches.l3_bytes);
+        assert(VPU::cache_regime_for(caches.l1d_bytes) == VPU::CACHE_L1);
+        assert(VPU::cache_regime_for(caches.l1d_bytes + 1) == VPU::CACHE_L2);
+        assert(VPU::cache_regime_for(caches.l3_bytes + 1) == VPU::CACHE_DRAM);
+        assert(gemm_shape.cache_regime == VPU::cache_regime_for(gemm_shape.working_set_bytes));
+
+        // Through Pillar 2 and 3: a large SAXPY is predicted to cost more than a small one.
+        std::vector<float> small_x(256, 1.0f), small_y(256, 0.0f), large_x(1 << 20, 1.0f), large_y(1 << 20, 0.0f);
+        auto predicted_saxpy = [&](std::vector<float>& x, std::vector<float>& y) {
+            VPU::VPU_Task task;
+            task.task_type = "SAXPY";
+            task.data_in_a = x.data();
+            task.data_in_a_size_bytes = x.size() * sizeof(float);
+            task.data_out = y.data();
+            task.num_elements = x.size();
+            VPU::EnrichedExecutionContext context = core->get_cortex_for_testing()->analyze(task);
+            assert(context.shape.elements == x.size());
+            for (const auto& plan : core->get_orchestrator_for_testing()->determine_optimal_path(context)) {
+                if (plan.chosen_path_name == "Standard SAXPY") return plan.predicted_holistic_flux;
+            }
+            assert(false && "Standard SAXPY not proposed");
+            return 0.0;
+        };
+        assert(predicted_saxpy(large_x, large_y) > 100.0 * predicted_saxpy(small_x, small_y));
+
+        // Direct convolution wins for short filters, FFT convolution for long ones.
+        VPU::HardwareProfile sized;
+        sized.base_operational_costs["CONV_DIRECT"] = 200.0;
+        sized.base_operational_costs["ELEMENT_WISE_MULTIPLY"] = 50.0;
+        sized.transform_costs["FFT_FORWARD"] = 300.0;
+        sized.transform_costs["FFT_INVERSE"] = 280.0;
+        sized.size_models["CONV_DIRECT"] = VPU::SizeModel::uniform(VPU::Complexity::N_TAPS, 2.0 / 8);
+        sized.size_models["FFT_FORWARD"] = VPU::SizeModel::uniform(VPU::Complexity::N_LOG_N, 5.0);
+        sized.size_models["FFT_INVERSE"] = VPU::SizeModel::uniform(VPU::Complexity::N_LOG_N, 5.0);
+        sized.size_models["ELEMENT_WISE_MULTIPLY"] = VPU::SizeModel::uniform(VPU::Complexity::LINEAR, 6.0);
+        sized.size_models["SAXPY_STANDARD"] = VPU::SizeModel::uniform(VPU::Complexity::LINEAR, 2.0);
+        auto sized_store = std::make_shared<VPU::HardwareProfileStore>(sized);
+        VPU::Orchestrator sized_orchestrator(sized_store);
+        auto cheapest_convolution = [&](uint64_t taps) {
+            VPU::EnrichedExecutionContext context;
+            context.task_type = "CONVOLUTION";
+            context.profile = std::make_shared<VPU::DataProfile>();
+            context.shape.elements = 65536;
+            context.shape.taps = taps;
+            context.shape.working_set_bytes = (2 * 65536 + taps) * sizeof(double);
+            context.shape.cache_regime = VPU::cache_regime_for(context.shape.working_set_bytes);
+            std::vector<VPU::ExecutionPlan> plans = sized_orchestrator.determine_optimal_path(context);
+            assert(plans.size() == 2);
+            return plans.front().chosen_path_name;
+        };
+        assert(cheapest_convolution(4) == "Time Domain (Direct)");
+        assert(cheapest_convolution(2048) == "Frequency Domain (FFT)");
+
+        // Pillar 5 moves the coefficient of the task's cache regime toward what was observed.
+        VPU::FeedbackLoop size_learner(sized_store, 0.15, 0.1, 0.05, 0.0);
+        VPU::LearningContext saxpy_learning;
+        saxpy_learning.path_name = "Standard SAXPY";
+        saxpy_learning.size_terms.push_back({VPU::HAL::intern_op("SAXPY_STANDARD"), 1e6});
+        saxpy_learning.cache_regime = VPU::CACHE_L3;
+        VPU::ActualPerformanceRecord observed;
+        observed.observed_holistic_flux = 3e6; // 3 per element, where the prior believes 2
+        for (int i = 0; i < 50; ++i) {
+            const double rate = sized_store->snapshot()->size_models.find("SAXPY_STANDARD")->per_unit[VPU::CACHE_L3];
+            size_learner.learn_from_feedback(saxpy_learning, rate * 1e6, observed);
+            size_learner.publish_pending_beliefs();
+        }
+        const VPU::SizeModel* learned = sized_store->snapshot()->size_models.find("SAXPY_STANDARD");
+        assert(learned->per_unit[VPU::CACHE_L3] > 2.5 && learned->per_unit[VPU::CACHE_L3] <= 3.0);
+        assert(learned->per_unit[VPU::CACHE_L1] == 2.0 && learned->per_unit[VPU::CACHE_DRAM] == 2.0);
+
+        // Size models are saved with the rest of the beliefs.
+        for (const std::string& path : {std::string("/tmp/vpu_test_sizes.bin"), std::string("/tmp/vpu_test_sizes.json")}) {
+            assert(VPU::save_profile(path, *sized_store->snapshot()));
+            VPU::HardwareProfile restored;
+            assert(VPU::load_profile(path, restored) == VPU::ProfileLoadResult::LOADED);
+            const VPU::SizeModel* restored_model = restored.size_models.find("SAXPY_STANDARD");
+            assert(restored_model && restored_model->complexity == VPU::Complexity::LINEAR);
+            assert(restored_model->per_unit[VPU::CACHE_L3] == learned->per_unit[VPU::CACHE_L3]);
+            assert(restored.size_models.find("FFT_FORWARD")->complexity == VPU::Complexity::N_LOG_N);
+            assert(restored.size_models.size() == sized.size_models.size());
+            std::remove(path.c_str());
+        }
+    }
+    std::cout << "--- Test 28 PASSED ---" << std::endl;
+
+    print_divider("TEST 29: Cycle Metrics and Prometheus Endpoint");
+    {
+        // Histogram buckets: exact below 32, then ~3% wide, covering the full 64-bit range in order.
+        using VPU::Runtime::Histogram;
+        for (uint64_t value = 0; value < Histogram::SUB_BUCKETS; ++value) {
+            assert(Histogram::bucket_of(value) == value && Histogram::bucket_upper_bound(value) == value);
+        }
+        for (uint64_t value : {uint64_t(32), uint64_t(1000), uint64_t(123456789), uint64_t(1) << 40, UINT64_MAX}) {
+            const size_t bucket = Histogram::bucket_of(value);
+            assert(bucket < Histogram::BUCKET_COUNT);
+            assert(Histogram::bucket_upper_bound(bucket) >= value);
+            assert(bucket == 0 || Histogram::bucket_upper_bound(bucket - 1) < value);
+            assert(static_cast<double>(Histogram::bucket_upper_bound(bucket) - value) <= value / 32.0);
+        }
+        Histogram histogram;
+        for (uint64_t value = 1; value <= 1000; ++value) histogram.record(value);
+        const VPU::Runtime::HistogramSnapshot values = histogram.snapshot();
+        assert(values.count == 1000 && values.sum == 500500 && values.min == 1 && values.max == 1000);
+        assert(std::abs(static_cast<double>(values.percentile(50)) - 500.0) <= 500.0 / 32);
+        assert(std::abs(static_cast<double>(values.percentile(99)) - 990.0) <= 990.0 / 32);
+        assert(values.percentile(100) == 1000);
+
+        // A fresh environment counts every task through every stage.
+        VPU::VPU_Environment metrics_env;
+        VPU::VPUCore* metrics_core = metrics_env.get_core_for_testing();
+        metrics_core->get_feedback_loop_for_testing()->set_latency_batch_size(1); // Latency beliefs after each task
+        std::vector<float> x(4096), y(4096, 0.0f);
+        for (size_t i = 0; i < x.size(); ++i) x[i] = static_cast<float>(i % 17) * 0.5f;
+        const uint64_t TASKS = 40;
+        for (uint64_t i = 0; i < TASKS; ++i) {
+            VPU::VPU_Task task;
+            task.task_id = 2900 + i;
+            task.task_type = "SAXPY";
+            task.kernel.function_pointer = noop_kernel;
+            task.alpha = 2.0f;
+            task.data_in_a = x.data();
+            task.data_in_a_size_bytes = x.size() * sizeof(float);
+            task.data_out = y.data();
+            task.num_elements = x.size();
+            metrics_env.execute(task);
+        }
+        const VPU::Runtime::MetricsSnapshot metrics = metrics_env.metrics();
+        assert(metrics.tasks == TASKS);
+        for (int stage = 0; stage < static_cast<int>(VPU::Runtime::CycleStage::COUNT); ++stage) {
+            const VPU::Runtime::HistogramSnapshot& latency = metrics.stage(static_cast<VPU::Runtime::CycleStage>(stage));
+            assert(latency.count == TASKS);
+            assert(latency.percentile(50) <= latency.percentile(99) && latency.percentile(99) <= latency.max);
+        }
+        assert(metrics.stage(VPU::Runtime::CycleStage::CEREBELLUM).max > 0);
+        uint64_t choices = 0;
+        for (const auto& plan : metrics.plan_choices) choices += plan.second;
+        assert(choices == TASKS && metrics.explorations <= TASKS);
+        assert(metrics.jit_cache_hits + metrics.jit_cache_misses <= TASKS && metrics.fusion_hits <= TASKS);
+        assert(!metrics.prediction_error.empty()); // Every step after an operation's first run is predicted
+        for (const auto& op : metrics.prediction_error) {
+            assert(op.second.count > 0);
+            std::cout << "  " << op.first << ": median prediction error "
+                      << op.second.percentile(50) / VPU::Runtime::MetricsSnapshot::PREDICTION_ERROR_SCALE * 100 << "%" << std::endl;
+        }
+        std::cout << "  Cerebellum p50/p99: " << metrics.stage(VPU::Runtime::CycleStage::CEREBELLUM).percentile(50) << " / "
+                  << metrics.stage(VPU::Runtime::CycleStage::CEREBELLUM).percentile(99) << " ns" << std::endl;
+
+        const std::string exposition = metrics.to_prometheus();
+        assert(exposition.find("vpu_tasks_total " + std::to_string(TASKS) + "\n") != std::string::npos);
+        assert(exposition.find("vpu_stage_latency_seconds_count{stage=\"cerebellum\"} " + std::to_string(TASKS)) != std::string::npos);
+        assert(exposition.find("# TYPE vpu_prediction_error_ratio summary") != std::string::npos);
+        assert(exposition.find("vpu_plan_choices_total{plan=\"") != std::string::npos);
+
+        // The endpoint serves the same text; where no socket can be bound, serve_metrics() reports -1.
+        const int port = metrics_env.serve_metrics(0, "127.0.0.1");
+        if (port > 0) {
+            httplib::Client scraper("127.0.0.1", port);
+            httplib::Result scraped = scraper.Get("/metrics");
+            assert(scraped && scraped->status == 200);
+            assert(scraped->body.find("vpu_tasks_total " + std::to_string(TASKS)) != std::string::npos);
+            metrics_env.stop_serving_metrics();
+        } else {
+            std::cout << "  (Metrics endpoint could not bind; skipped the scrape.)" << std::endl;
+        }
+    }
+    std::cout << "--- Test 29 PASSED ---" << std::endl;
+
+    // --- Test 30: Typed task descriptors ---
+    print_divider("TEST 30: Typed Task Descriptors");
+    {
+        // bfloat16 keeps float's exponent: exact for short mantissas, round-to-nearest-even otherwise.
+        using VPU::HAL::bfloat16;
+        assert(VPU::HAL::float_to_bf16(1.0f).bits == 0x3F80);
+        assert(VPU::HAL::bf16_to_float(VPU::HAL::float_to_bf16(-2.5f)) == -2.5f);
+        assert(VPU::HAL::float_to_bf16(1.00390625f).bits == 0x3F80); // Tie: rounds to the even mantissa
+        assert(VPU::HAL::float_to_bf16(1.01171875f).bits == 0x3F82); // Tie: rounds up to even
+        assert(VPU::HAL::element_size(VPU::HAL::ElementType::BFLOAT16) == 2);
+        assert(VPU::HAL::element_size(VPU::HAL::ElementType::INT8) == 1);
+
+        // Buffer statistics read signed bytes and bfloat16 values as what they are.
+        const int8_t bytes[] = {-7, 0, 12, 0, -128, 5};
+        const VPU::HAL::BufferStats i8_stats = VPU::HAL::compute_buffer_stats(bytes, sizeof(bytes), VPU::HAL::ElementType::INT8);
+        assert(i8_stats.elements == 6 && i8_stats.zero_elements == 2);
+        assert(i8_stats.min_value == -128.0 && i8_stats.max_value == 12.0);
+        const bfloat16 halves[] = {VPU::HAL::float_to_bf16(0.5f), VPU::HAL::float_to_bf16(-3.0f), VPU::HAL::float_to_bf16(0.0f)};
+        const VPU::HAL::BufferStats bf16_stats = VPU::HAL::compute_buffer_stats(halves, sizeof(halves), VPU::HAL::ElementType::BFLOAT16);
+        assert(bf16_stats.elements == 3 && bf16_stats.zero_elements == 1);
+        assert(bf16_stats.min_value == -3.0 && bf16_stats.max_value == 0.5);
+
+        // A typed GEMM fills the legacy fields its kernels read; shapes that do not chain are rejected.
+        std::vector<double> A(6, 1.0), B(12, 2.0), C(8, 0.0);
+        VPU::VPU_Task gemm;
+        gemm.op = VPU::TaskOp::GEMM;
+        gemm.operands = {VPU::TaskOperand::matrix(A.data(), VPU::HAL::ElementType::FLOAT64, 2, 3),
+                         VPU::TaskOperand::matrix(B.data(), VPU::HAL::ElementType::FLOAT64, 3, 4),
+                         VPU::TaskOperand::matrix(C.data(), VPU::HAL::ElementType::FLOAT64, 2, 4)};
+        std::string error;
+        assert(VPU::describe_task(gemm, error));
+        assert(gemm.extended_params["M"] == 2 && gemm.extended_params["K"] == 3 && gemm.extended_params["N"] == 4);
+        assert(gemm.data_in_b == B.data() && gemm.data_out == C.data());
+        assert(gemm.data_in_a_size_bytes == 6 * sizeof(double) && gemm.data_out_size_bytes == 8 * sizeof(double));
+        assert(VPU::input_element_type(gemm) == VPU::HAL::ElementType::FLOAT64);
+        VPU::VPU_Task bad_gemm = gemm;
+        bad_gemm.operands[1].shape[0] = 4;
+        assert(!VPU::describe_task(bad_gemm, error));
+        VPU::VPU_Task contradicted = gemm;
+        contradicted.task_type = "SAXPY";
+        assert(!VPU::describe_task(contradicted, error));
+        VPU::VPU_Task strided = gemm;
+        strided.operands[0].strides[0] = 8; // Row pitch of 8 for 3-wide rows
+        assert(!VPU::describe_task(strided, error));
+        // Legacy tasks resolve their op from task_type and keep their default element types.
+        VPU::VPU_Task legacy;
+        legacy.task_type = "CONVOLUTION";
+        assert(VPU::resolved_op(legacy) == VPU::TaskOp::CONVOLUTION && VPU::describe_task(legacy, error));
+        assert(VPU::input_element_type(legacy) == VPU::HAL::ElementType::FLOAT64);
+        assert(VPU::task_op_from_name("FFT_TEST") == VPU::TaskOp::FFT);
+
+        // The Cortex reads a float SAXPY input as floats: a unit ramp has an amplitude flux of exactly 1.
+        std::vector<float> ramp(1000), ramp_out(1000);
+        std::iota(ramp.begin(), ramp.end(), 0.0f);
+        VPU::VPU_Task float_task;
+        float_task.task_type = "SAXPY";
+        float_task.data_in_a = ramp.data();
+        float_task.data_in_a_size_bytes = ramp.size() * sizeof(float);
+        float_task.data_out = ramp_out.data();
+        float_task.num_elements = ramp.size();
+        VPU::EnrichedExecutionContext float_ctx = cortex->analyze(float_task);
+        assert(float_ctx.op == VPU::TaskOp::SAXPY && float_ctx.element_type == VPU::HAL::ElementType::FLOAT32);
+        assert(std::abs(float_ctx.profile->amplitude_flux - 1.0) < 1e-12);
+        assert(float_ctx.profile->profiled_elements == ramp.size()); // Every float, not half as many doubles
+        assert(float_ctx.profile->input_stats.max_value == 999.0);
+        // ... and the streaming profiler agrees, chunk boundaries splitting elements or not.
+        VPU::ProfilingPolicy stream_policy;
+        stream_policy.spectral = false;
+        VPU::StreamingProfiler streamer(stream_policy, VPU::HAL::ElementType::FLOAT32);
+        const uint8_t* ramp_bytes = reinterpret_cast<const uint8_t*>(ramp.data());
+        for (size_t offset = 0; offset < float_task.data_in_a_size_bytes; offset += 333) {
+            streamer.update(ramp_bytes + offset, std::min<size_t>(333, float_task.data_in_a_size_bytes - offset));
+        }
+        assert(std::abs(streamer.profile().amplitude_flux - 1.0) < 1e-12 && streamer.profile().profiled_elements == ramp.size());
+
+        // Typed f64 tasks run through the VPU on the kernels that have an f64 instance.
+        VPU::VPU_Environment typed_env;
+        std::vector<double> x64(512), y64(512, 1.0);
+        for (size_t i = 0; i < x64.size(); ++i) x64[i] = 0.25 * static_cast<double>(i);
+        VPU::VPU_Task saxpy64;
+        saxpy64.task_id = 3000;
+        saxpy64.op = VPU::TaskOp::SAXPY;
+        saxpy64.kernel.function_pointer = noop_kernel;
+        saxpy64.alpha = 2.0f;
+        saxpy64.operands = {VPU::TaskOperand::vector(x64.data(), VPU::HAL::ElementType::FLOAT64, x64.size()),
+                            VPU::TaskOperand::vector(y64.data(), VPU::HAL::ElementType::FLOAT64, y64.size())};
+        typed_env.execute(saxpy64);
+        for (size_t i = 0; i < y64.size(); ++i) assert(y64[i] == 1.0 + 0.5 * static_cast<double>(i));
+
+        gemm.task_id = 3001;
+        gemm.kernel.function_pointer = noop_kernel;
+        typed_env.execute(gemm);
+        for (double c : C) assert(c == 6.0); // Three products of 1 * 2
+
+        const VPU::Runtime::MetricsSnapshot typed_metrics = typed_env.metrics();
+        assert(typed_metrics.tasks == 2);
+        for (const auto& plan : typed_metrics.plan_choices) {
+            std::cout << "  f64 task ran '" << plan.first << "'" << std::endl;
+            assert(plan.first == "Standard SAXPY" || plan.first == "Naive GEMM"); // The only f64 instances
+        }
+
+        // A rejected descriptor never reaches the kernels.
+        std::vector<double> untouched(4, 7.0);
+        VPU::VPU_Task mixed;
+        mixed.task_id = 3002;
+        mixed.op = VPU::TaskOp::SAXPY;
+        mixed.kernel.function_pointer = noop_kernel;
+        mixed.operands = {VPU::TaskOperand::vector(ramp.data(), VPU::HAL::ElementType::FLOAT32, 4),
+                          VPU::TaskOperand::vector(untouched.data(), VPU::HAL::ElementType::FLOAT64, 4)};
+        typed_env.execute(mixed);
+        for (double v : untouched) assert(v == 7.0);
+        assert(typed_env.metrics().tasks == 2);
+    }
+    std::cout << "--- Test 30 PASSED ---" << std::endl;
+
+    print_divider("TEST 31: Reduced-Precision Candidates");
+    {
+        using VPU::HAL::ElementType;
+        using VPU::HAL::Span;
+        // binary16: exact for short mantissas, infinite past 65504, subnormal down to 2^-24.
+        assert(VPU::HAL::float_to_f16(1.0f).bits == 0x3C00);
+        assert(VPU::HAL::float_to_f16(-65504.0f).bits == 0xFBFF);
+        assert(VPU::HAL::float_to_f16(65520.0f).bits == 0x7C00); // Tie: rounds to even, past the largest finite
+        assert(VPU::HAL::float_to_f16(std::ldexp(1.0f, -24)).bits == 0x0001);
+        assert(VPU::HAL::f16_to_float(VPU::HAL::float16{0x0001}) == std::ldexp(1.0f, -24));
+        assert(VPU::HAL::f16_to_float(VPU::HAL::float_to_f16(1.0f + std::ldexp(1.0f, -11))) == 1.0f); // Tie to even
+        assert(std::isnan(VPU::HAL::f16_to_float(VPU::HAL::float_to_f16(std::nanf("")))));
+        assert(VPU::HAL::element_size(ElementType::FLOAT16) == 2);
+
+        // Each type rounds within its bound of the tensor's largest magnitude, and the SAXPY
+        // on the quantized x stays within |a| times that.
+        const size_t n = 4096;
+        std::vector<float> x(n), y0(n);
+        float max_x = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = 3.0f * std::sin(0.37f * static_cast<float>(i));
+            y0[i] = std::cos(0.11f * static_cast<float>(i));
+            max_x = std::max(max_x, std::abs(x[i]));
+        }
+        const ElementType reduced[] = {ElementType::BFLOAT16, ElementType::FLOAT16, ElementType::INT8};
+        for (ElementType type : reduced) {
+            VPU::HAL::QuantizedTensor q;
+            assert(VPU::HAL::quantize(Span<const float>(x), type, q));
+            assert(q.size_bytes() == n * VPU::HAL::element_size(type)); // Half or a quarter of the f32 bytes
+            std::vector<float> back(n);
+            assert(VPU::HAL::dequantize(q, Span<float>(back)));
+            const double bound = VPU::HAL::quantization_error(type) * max_x;
+            double worst = 0.0;
+            for (size_t i = 0; i < n; ++i) worst = std::max(worst, static_cast<double>(std::abs(back[i] - x[i])));
+            assert(worst <= bound);
+            std::vector<float> y = y0;
+            assert(VPU::HAL::cpu_saxpy_quantized(2.0f, q, Span<float>(y)));
+            for (size_t i = 0; i < n; ++i) assert(std::abs(y[i] - (y0[i] + 2.0f * x[i])) <= 2.0 * bound + 1e-5);
+            std::cout << "  " << VPU::HAL::element_type_name(type) << ": worst rounding " << worst << " (bound " << bound << ")" << std::endl;
+        }
+        // Tensors a type cannot hold within its bound are refused, so callers keep full precision.
+        std::vector<float> wide = {1.0f, 70000.0f};
+        VPU::HAL::QuantizedTensor refused;
+        assert(!VPU::HAL::quantize(Span<const float>(wide), ElementType::FLOAT16, refused) && refused.empty());
+        assert(VPU::HAL::quantize(Span<const float>(wide), ElementType::BFLOAT16, refused));
+        wide[0] = std::nanf("");
+        assert(!VPU::HAL::quantize(Span<const float>(wide), ElementType::INT8, refused) && refused.empty());
+
+        // GEMM: each output within K * max|A| * max|B| * (2u + u^2), plus f32 accumulation.
+        const int M = 24, K = 40, N = 36;
+        std::vector<float> ga(M * K), gb(K * N), gc(M * N);
+        std::vector<double> expected(M * N, 0.0);
+        for (int i = 0; i < M * K; ++i) ga[i] = std::sin(0.3f * static_cast<float>(i));
+        for (int i = 0; i < K * N; ++i) gb[i] = 0.5f * std::cos(0.7f * static_cast<float>(i));
+        for (int i = 0; i < M; ++i)
+            for (int k = 0; k < K; ++k)
+                for (int j = 0; j < N; ++j) expected[i * N + j] += static_cast<double>(ga[i * K + k]) * gb[k * N + j];
+        const double product_scale = K * 1.0 * 0.5;
+        for (ElementType type : reduced) {
+            VPU::HAL::QuantizedTensor qa, qb;
+            assert(VPU::HAL::quantize(Span<const float>(ga), type, qa) && VPU::HAL::quantize(Span<const float>(gb), type, qb));
+            assert(VPU::HAL::cpu_gemm_quantized(qa, qb, Span<float>(gc), M, N, K));
+            const double u = VPU::HAL::quantization_error(type);
+            for (int i = 0; i < M * N; ++i) assert(std::abs(gc[i] - expected[i]) <= product_scale * (2.0 * u + u * u + 1e-5));
+        }
+
+        // Pillar 3 proposes reduced precision only within the task's accuracy bound.
+        std::vector<float> y(n);
+        VPU::VPU_Task saxpy_task;
+        saxpy_task.task_type = "SAXPY";
+        saxpy_task.alpha = 2.0f;
+        saxpy_task.data_in_a = x.data();
+        saxpy_task.data_in_a_size_bytes = n * sizeof(float);
+        saxpy_task.data_out = y.data();
+        saxpy_task.num_elements = n;
+        auto reduced_plans = [&](const VPU::VPU_Task& task) {
+            std::vector<std::string> names;
+            for (const auto& plan : orchestrator->determine_optimal_path(cortex->analyze(task))) {
+                if (plan.chosen_path_name.compare(0, 17, "Reduced-Precision") == 0) names.push_back(plan.chosen_path_name);
+            }
+            std::sort(names.begin(), names.end());
+            return names;
+        };
+        assert(reduced_plans(saxpy_task).empty()); // Full precision by default
+        saxpy_task.accuracy_bound = 1e-2;
+        assert((reduced_plans(saxpy_task) == std::vector<std::string>{"Reduced-Precision SAXPY (BF16)", "Reduced-Precision SAXPY (FP16)",
+                                                                        "Reduced-Precision SAXPY (INT8)"}));
+        saxpy_task.accuracy_bound = 1e-3; // Only FP16's 2^-11 fits
+        assert((reduced_plans(saxpy_task) == std::vector<std::string>{"Reduced-Precision SAXPY (FP16)"}));
+        std::vector<float> large(n);
+        for (size_t i = 0; i < n; ++i) large[i] = 1e5f * x[i];
+        VPU::VPU_Task large_task = saxpy_task;
+        large_task.data_in_a = large.data();
+        large_task.accuracy_bound = 1e-2; // FP16 would overflow
+        assert((reduced_plans(large_task) == std::vector<std::string>{"Reduced-Precision SAXPY (BF16)", "Reduced-Precision SAXPY (INT8)"}));
+
+        VPU::VPU_Task gemm_task;
+        gemm_task.task_type = "GEMM";
+        gemm_task.data_in_a = ga.data();
+        gemm_task.data_in_a_size_bytes = ga.size() * sizeof(float);
+        gemm_task.data_in_b = gb.data();
+        gemm_task.data_in_b_size_bytes = gb.size() * sizeof(float);
+        gemm_task.data_out = gc.data();
+        gemm_task.num_elements = ga.size();
+        gemm_task.extended_params = {{"M", M}, {"N", N}, {"K", K}};
+        gemm_task.accuracy_bound = 5e-3; // GEMM rounds A and B: BF16 and INT8 (~2 * 2^-8) exceed it
+        assert((reduced_plans(gemm_task) == std::vector<std::string>{"Reduced-Precision GEMM (FP16)"}));
+
+        // The Cerebellum runs a planned INT8 GEMM within the bound...
+        gemm_task.accuracy_bound = 1e-2;
+        VPU::ExecutionPlan int8_plan;
+        for (const auto& plan : orchestrator->determine_optimal_path(cortex->analyze(gemm_task))) {
+            if (plan.chosen_path_name == "Reduced-Precision GEMM (INT8)") int8_plan = plan;
+        }
+        assert(int8_plan.steps.size() == 2);
+        std::fill(gc.begin(), gc.end(), 0.0f);
+        VPU::Cerebellum* cerebellum = core->get_cerebellum_for_testing();
+        VPU::ActualPerformanceRecord int8_record = cerebellum->execute(int8_plan, gemm_task);
+        assert(int8_record.step_latencies.size() == 2 && int8_record.observed_cycle_cost > 0);
+        const double int8_u = VPU::HAL::quantization_error(ElementType::INT8);
+        for (int i = 0; i < M * N; ++i) assert(std::abs(gc[i] - expected[i]) <= product_scale * (2.0 * int8_u + int8_u * int8_u + 1e-5));
+        // ... and an FP16 plan at full precision when the operands it meets do not fit FP16.
+        VPU::ExecutionPlan fp16_plan = int8_plan;
+        for (auto& step : fp16_plan.steps) {
+            step.operation_name.replace(step.operation_name.size() - 4, 4, "FP16");
+            step.op_id = VPU::HAL::intern_op(step.operation_name);
+        }
+        std::vector<float> wide_a(ga);
+        wide_a[0] = 1e6f;
+        gemm_task.data_in_a = wide_a.data();
+        cerebellum->execute(fp16_plan, gemm_task);
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                const double exact = expected[i * N + j] + (i == 0 ? (1e6 - ga[0]) * gb[j] : 0.0);
+                assert(std::abs(gc[i * N + j] - exact) <= 1e-5 * std::max(1.0, std::abs(exact)));
+            }
+        }
+
+        // Through the VPU, a SAXPY with a tolerance comes back within it whichever plan ran.
+        VPU::VPU_Environment reduced_env;
+        std::vector<float> env_y(y0);
+        VPU::VPU_Task env_task;
+        env_task.task_id = 3100;
+        env_task.task_type = "SAXPY";
+        env_task.kernel.function_pointer = noop_kernel;
+        env_task.alpha = 2.0f;
+        env_task.data_in_a = x.data();
+        env_task.data_in_a_size_bytes = n * sizeof(float);
+        env_task.data_out = env_y.data();
+        env_task.num_elements = n;
+        env_task.accuracy_bound = 1e-2;
+        reduced_env.execute(env_task);
+        for (size_t i = 0; i < n; ++i) {
+            assert(std::abs(env_y[i] - (y0[i] + 2.0f * x[i])) <= env_task.accuracy_bound * 2.0f * max_x);
+        }
+        for (const auto& plan : reduced_env.metrics().plan_choices) {
+            std::cout << "  SAXPY with a 1e-2 tolerance ran '" << plan.first << "'" << std::endl;
+        }
+    }
+    std::cout << "--- Test 31 PASSED ---" << std::endl;
+
+    print_divider("TEST 32: Streamed Out-of-Core Tasks");
+    {
+        const std::string in_path = "/tmp/vpu_test_stream_in.bin", out_path = "/tmp/vpu_test_stream_out.bin";
+        auto write_file = [](const std::string& path, const void* data, size_t bytes) {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        };
+        auto read_file = [](const std::string& path) {
+            std::ifstream in(path, std::ios::binary);
+            return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        };
+        auto stream_task = [&](uint64_t id, const char* type, size_t chunk_bytes) {
+            VPU::VPU_Task task;
+            task.task_id = id;
+            task.task_type = type;
+            task.kernel.function_pointer = noop_kernel;
+            task.stream.input_path = in_path;
+            task.stream.output_path = out_path;
+            task.stream.chunk_bytes = chunk_bytes;
+            return task;
+        };
+
+        // Mapped files: a read mapping sees the file; a write mapping is created zero-filled at its
+        // size; released pages read back unchanged, from the page cache or the file.
+        const size_t n = 50000;
+        std::vector<float> x(n), y0(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = static_cast<float>(std::sin(0.01 * i));
+            y0[i] = static_cast<float>(i % 17) - 8.0f;
+        }
+        write_file(in_path, x.data(), n * sizeof(float));
+        std::remove(out_path.c_str());
+        {
+            VPU::HAL::MappedFile source;
+            assert(source.open_read(in_path) && source.size() == n * sizeof(float));
+            source.prefetch(0, source.size());
+            source.release(0, source.size());
+            assert(std::memcmp(source.data(), x.data(), n * sizeof(float)) == 0);
+            VPU::HAL::MappedFile sink;
+            assert(sink.open_write(out_path, 3 * 4096 + 100) && sink.size() == 3 * 4096 + 100);
+            assert(std::all_of(sink.data(), sink.data() + sink.size(), [](uint8_t b) { return b == 0; }));
+            sink.mutable_data()[5000] = 7;
+            sink.release(4096, 8192);
+            assert(sink.data()[5000] == 7);
+            VPU::HAL::MappedFile missing;
+            assert(!missing.open_read("/tmp/vpu_test_stream_missing.bin") && !missing.is_open());
+        }
+        assert(read_file(out_path).size() == 3 * 4096 + 100 && read_file(out_path)[5000] == 7);
+
+        // SAXPY: x streams from the input; the output file holds y and is updated in place.
+        write_file(out_path, y0.data(), n * sizeof(float));
+        VPU::VPU_Environment stream_env;
+        VPU::VPU_Task saxpy = stream_task(3200, "SAXPY", 16384); // 4096 values per chunk: 13 chunks
+        saxpy.alpha = 1.5f;
+        stream_env.execute(saxpy);
+        std::vector<char> saxpy_out = read_file(out_path);
+        assert(saxpy_out.size() == n * sizeof(float));
+        const float* y = reinterpret_cast<const float*>(saxpy_out.data());
+        for (size_t i = 0; i < n; ++i) {
+            const float expected = y0[i] + 1.5f * x[i];
+            assert(std::abs(y[i] - expected) <= 1e-5f * (1.0f + std::abs(expected)));
+        }
+        const VPU::ActualPerformanceRecord saxpy_record = stream_env.get_last_performance_record();
+        assert(saxpy_record.observed_cycle_cost > 0 && !saxpy_record.step_latencies.empty());
+
+        // num_elements streams a prefix; the output is sized to it.
+        VPU::VPU_Task prefix = stream_task(3201, "SAXPY", 0);
+        prefix.num_elements = 1000;
+        std::remove(out_path.c_str());
+        stream_env.execute(prefix);
+        assert(read_file(out_path).size() == 1000 * sizeof(float));
+
+        // Intake refuses what cannot be streamed; opening refuses inputs that do not fit the task.
+        std::string error;
+        VPU::VPU_Task fft = stream_task(3202, "FFT", 0);
+        assert(!VPU::check_stream(fft, error));
+        VPU::VPU_Task same_file = stream_task(3203, "SAXPY", 0);
+        same_file.stream.output_path = in_path;
+        assert(!VPU::check_stream(same_file, error));
+        VPU::VPU_Task misaligned = stream_task(3204, "SAXPY", 0);
+        misaligned.stream.input_offset = 2;
+        assert(!VPU::check_stream(misaligned, error));
+        VPU::VPU_Task no_b = stream_task(3205, "GEMM", 0);
+        no_b.extended_params["K"] = 4;
+        no_b.extended_params["N"] = 4;
+        assert(!VPU::check_stream(no_b, error));
+        VPU::VPU_Task no_taps = stream_task(3206, "CONVOLUTION", 0);
+        assert(!VPU::check_stream(no_taps, error));
+        VPU::VPU_Task sparse_saxpy = stream_task(3208, "SAXPY", 0);
+        const int32_t sparse_row_ptr[2] = {0, 0};
+        sparse_saxpy.sparse_a.row_ptr = sparse_row_ptr;
+        assert(!VPU::check_stream(sparse_saxpy, error) && error.find("streamed SAXPY") != std::string::npos);
+        VPU::VPU_Task too_long = stream_task(3207, "SAXPY", 0);
+        too_long.num_elements = n + 1;
+        assert(VPU::check_stream(too_long, error));
+        VPU::StreamSession refused;
+        assert(!refused.open(too_long, error) && !error.empty());
+
+        // CONVOLUTION: each chunk re-reads the taps - 1 samples before it, so every plan matches
+        // the in-memory convolution, and the profile folded chunk by chunk covers the whole input.
+        const size_t samples = 20000;
+        std::vector<double> signal(samples), taps(33), conv_expected(samples);
+        for (size_t i = 0; i < samples; ++i) signal[i] = std::sin(0.003 * i) + 0.25 * std::cos(0.05 * i);
+        for (size_t j = 0; j < taps.size(); ++j) taps[j] = 1.0 / (1.0 + j);
+        assert(VPU::HAL::cpu_conv_direct(signal, taps, conv_expected));
+        write_file(in_path, signal.data(), samples * sizeof(double));
+        VPU::VPU_Task conv = stream_task(3210, "CONVOLUTION", 8192); // 1024 samples per chunk
+        conv.conv_filter = VPU::HAL::Span<const double>(taps);
+        auto conv_error = [&]() {
+            std::vector<char> out = read_file(out_path);
+            assert(out.size() == samples * sizeof(double));
+            const double* conv_out = reinterpret_cast<const double*>(out.data());
+            double worst = 0.0;
+            for (size_t i = 0; i < samples; ++i) worst = std::max(worst, std::abs(conv_out[i] - conv_expected[i]));
+            return worst;
+        };
+        const std::vector<VPU::ExecutionPlan> stream_conv_plans = {
+            {"Direct Convolution", 0.0, {{"CONV_DIRECT", "input", "output"}}},
+            {"Frequency Domain (FFT)", 0.0, {{"FFT_FORWARD", "input", "temp_freq"},
+                                             {"ELEMENT_WISE_MULTIPLY", "temp_freq", "temp_result"},
+                                             {"FFT_INVERSE", "temp_result", "output"}}}};
+        for (const auto& plan : stream_conv_plans) {
+            std::remove(out_path.c_str());
+            VPU::StreamSession session;
+            assert(session.open(conv, error) && session.chunks() == 20 && session.rows() == samples);
+            VPU::StreamingProfiler profiler(VPU::ProfilingPolicy(), VPU::HAL::ElementType::FLOAT64);
+            size_t chunks_seen = 0;
+            VPU::ActualPerformanceRecord record = core->get_cerebellum_for_testing()->execute_stream(
+                plan, session, [&](VPU::HAL::Span<const uint8_t> input) {
+                    profiler.update(input.data(), input.size());
+                    ++chunks_seen;
+                });
+            assert(chunks_seen == 20 && profiler.bytes_seen() == samples * sizeof(double));
+            assert(profiler.profile().input_stats.elements == samples);
+            assert(record.step_latencies.size() == plan.steps.size() && record.observed_cycle_cost > 0);
+            assert(conv_error() < 1e-9);
+        }
+        std::remove(out_path.c_str());
+        stream_env.execute(conv); // Whichever plan Pillar 3 picks for a chunk
+        assert(conv_error() < 1e-9);
+
+        // GEMM: A streams in blocks of rows; B stays in memory.
+        const int M = 300, K = 64, N = 48;
+        std::vector<float> A(static_cast<size_t>(M) * K), B(static_cast<size_t>(K) * N);
+        for (size_t i = 0; i < A.size(); ++i) A[i] = static_cast<float>((i * 7) % 13) - 6.0f;
+        for (size_t i = 0; i < B.size(); ++i) B[i] = static_cast<float>((i * 5) % 11) * 0.5f - 2.0f;
+        write_file(in_path, A.data(), A.size() * sizeof(float));
+        std::remove(out_path.c_str());
+        VPU::VPU_Task gemm = stream_task(3220, "GEMM", 16384); // 64 rows of A per chunk: 5 chunks
+        gemm.data_in_b = B.data();
+        gemm.data_in_b_size_bytes = B.size() * sizeof(float);
+        gemm.extended_params["K"] = K;
+        gemm.extended_params["N"] = N;
+        stream_env.execute(gemm);
+        std::vector<char> gemm_out = read_file(out_path);
+        assert(gemm_out.size() == static_cast<size_t>(M) * N * sizeof(float));
+        const float* C = reinterpret_cast<const float*>(gemm_out.data());
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                double expected = 0.0;
+                for (int k = 0; k < K; ++k) expected += static_cast<double>(A[i * K + k]) * B[k * N + j];
+                assert(std::abs(C[i * N + j] - expected) <= 1e-4 * (1.0 + std::abs(expected)));
+            }
+        }
+        VPU::VPU_Task ragged = gemm; // 300 * 64 values are not whole rows of 77
+        ragged.extended_params["K"] = 77;
+        assert(!refused.open(ragged, error));
+
+        std::remove(in_path.c_str());
+        std::remove(out_path.c_str());
+        std::cout << "  Streamed SAXPY, CONVOLUTION and GEMM from files in fixed-size chunks" << std::endl;
+    }
+    std::cout << "--- Test 32 PASSED ---" << std::endl;
+
     // --- End of New Tests ---
     // (Keep other existing tests like IoT, Pillar 5 Exploration, Pillar 6 Fusion if they are still relevant
     //  and adaptable. For this subtask, focus is on the new flux model tests.)